@@ -133,12 +133,16 @@ esp_err_t api_handler_timer_delete(httpd_req_t *req);
 /**
  * GET /api/modbus/slave - Slave config + stats
  * GET /api/modbus/master - Master config + stats
+ * GET /api/modbus/master/poll - Poll groups + achieved rate/lateness (v7.9.8.12)
+ * GET /api/modbus/master/bus - RS485 buses, per-bus stats + slave routes (v7.9.8.14)
  */
 esp_err_t api_handler_modbus_get(httpd_req_t *req);
 
 /**
  * POST /api/modbus/slave - Configure slave
  * POST /api/modbus/master - Configure master
+ * POST /api/modbus/master/poll - Create/update/delete a poll group (v7.9.8.12)
+ * POST /api/modbus/master/bus - Configure an extra bus or a slave route (v7.9.8.14)
  */
 esp_err_t api_handler_modbus_post(httpd_req_t *req);
 
@@ -252,6 +256,9 @@ esp_err_t api_handler_coils_bulk_read(httpd_req_t *req);
 esp_err_t api_handler_coils_bulk_write(httpd_req_t *req);
 esp_err_t api_handler_di_bulk_read(httpd_req_t *req);
 
+/** GET /api/registers/map — Sparse HR/IR pages (v7.9.8.22) */
+esp_err_t api_handler_registers_map(httpd_req_t *req);
+
 /** FEAT-020: ST Logic Debug API */
 esp_err_t api_handler_logic_debug(httpd_req_t *req);
 
@@ -47,6 +47,19 @@ int cli_cmd_set_logic_debug(st_logic_engine_state_t *logic_state, bool debug);
  */
 int cli_cmd_set_logic_interval(st_logic_engine_state_t *logic_state, uint32_t interval_ms);
 
+/**
+ * @brief set logic parallel:on|off (FEAT-153)
+ * Run independent programs on both cores (persisted in module_flags)
+ */
+int cli_cmd_set_logic_parallel(st_logic_engine_state_t *logic_state, bool enabled);
+
+/**
+ * @brief set logic <id> period:<ms> priority:<n> policy:skip|catchup (FEAT-154)
+ * Per-program scan schedule; omitted keys keep their current value
+ */
+int cli_cmd_set_logic_schedule(st_logic_engine_state_t *logic_state, uint8_t program_id,
+                               int argc, char *argv[]);
+
 /**
  * @brief set logic <id> delete
  * Delete a logic program
@@ -17,11 +17,20 @@ void cli_cmd_set_modbus_master_timeout(uint16_t ms);
 void cli_cmd_set_modbus_master_inter_frame_delay(uint16_t ms);
 void cli_cmd_set_modbus_master_max_requests(uint8_t count);
 void cli_cmd_set_modbus_master_cache_ttl(uint16_t ttl_ms);
-void cli_cmd_set_modbus_master_cache_size(uint8_t size);
+void cli_cmd_set_modbus_master_cache_size(uint16_t size);
 void cli_cmd_set_modbus_master_queue_size(uint8_t size);
+void cli_cmd_set_modbus_master_coalesce(bool enabled);
+void cli_cmd_set_modbus_master_coalesce_gap(uint8_t gap);
+void cli_cmd_set_modbus_master_write_combine(bool enabled);   // v7.9.8.19
+void cli_cmd_set_modbus_master_write_always(const char *range, const char *value);
+void cli_cmd_set_modbus_master_poll(uint8_t group_id, int argc, char *argv[]);
+void cli_cmd_set_modbus_master_bus(uint8_t bus, int argc, char *argv[]);
+void cli_cmd_set_modbus_master_route(uint8_t route_id, int argc, char *argv[]);
 
 // SHOW command
 void cli_cmd_show_modbus_master();
+void cli_cmd_show_modbus_master_profile(bool verbose);   // v7.9.8.17
+void cli_cmd_reset_modbus_master_profile();
 
 // REMOTE READ/WRITE commands (mb read / mb write)
 void cli_cmd_mb_read(uint8_t argc, char **argv);
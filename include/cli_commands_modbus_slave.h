@@ -16,7 +16,14 @@ void cli_cmd_set_modbus_slave_parity(const char *parity);
 void cli_cmd_set_modbus_slave_stop_bits(uint8_t bits);
 void cli_cmd_set_modbus_slave_inter_frame_delay(uint16_t ms);
 
+// Modbus TCP server (v7.9.8.0, FEAT-145)
+void cli_cmd_set_modbus_tcp_enabled(bool enabled);
+void cli_cmd_set_modbus_tcp_port(uint16_t port);
+void cli_cmd_set_modbus_tcp_max_clients(uint8_t clients);
+void cli_cmd_set_modbus_tcp_idle_timeout(uint16_t seconds);
+
 // SHOW command
 void cli_cmd_show_modbus_slave();
+void cli_cmd_show_modbus_tcp();
 
 #endif // CLI_COMMANDS_MODBUS_SLAVE_H
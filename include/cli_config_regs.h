@@ -25,4 +25,14 @@ void cli_cmd_set_reg_dynamic(uint8_t argc, char* argv[]);
  */
 void cli_cmd_show_regs(void);
 
+/**
+ * set reg-map hr|ir <start> <count> | set reg-map <1-16> delete (v7.9.8.22)
+ */
+void cli_cmd_set_reg_map(uint8_t argc, char* argv[]);
+
+/**
+ * show reg-map - Declared and mapped sparse register pages
+ */
+void cli_cmd_show_reg_map(void);
+
 #endif // CLI_CONFIG_REGS_H
@@ -18,7 +18,6 @@
 #define SLAVE_ID            1           // Default Modbus slave address
 #define BAUDRATE            115200      // Default Modbus RTU baudrate
 #define MODBUS_FRAME_MAX    256         // Max Modbus frame size
-#define MODBUS_TIMEOUT_MS   3500        // Inter-character timeout (ms)
 
 /* Modbus Function Codes */
 #define FC_READ_COILS           0x01
@@ -29,15 +28,39 @@
 #define FC_WRITE_SINGLE_REG     0x06
 #define FC_WRITE_MULTIPLE_COILS 0x0F
 #define FC_WRITE_MULTIPLE_REGS  0x10
+#define FC_DIAGNOSTICS          0x08    // Serial line diagnostics (v7.9.8.24)
+#define FC_MASK_WRITE_REG       0x16    // FC22 Mask Write Register
+#define FC_READ_WRITE_MULTIPLE_REGS 0x17  // FC23 Read/Write Multiple Registers
+#define FC_ENCAPSULATED_INTERFACE   0x2B  // FC43 MEI transport
+#define MEI_READ_DEVICE_ID      0x0E    // FC43 MEI type 14: Read Device Identification
+
+/* FC08 sub-functions */
+#define DIAG_RETURN_QUERY_DATA      0x0000
+#define DIAG_CLEAR_COUNTERS         0x000A
+#define DIAG_BUS_MESSAGE_COUNT      0x000B
+#define DIAG_BUS_COMM_ERROR_COUNT   0x000C
+#define DIAG_BUS_EXCEPTION_COUNT    0x000D
+#define DIAG_SERVER_MESSAGE_COUNT   0x000E
+#define DIAG_SERVER_NO_RESPONSE_COUNT 0x000F
 
 /* ============================================================================
  * REGISTER/COIL CONFIGURATION
  * ============================================================================ */
 
 #define HOLDING_REGS_SIZE   256         // Number of holding registers (0-255)
-#define INPUT_REGS_SIZE     256         // Number of input registers (0-255)
+#define INPUT_REGS_SIZE     512         // Number of input registers (0-511, BUG-328: ST stats use 252-441)
 #define COILS_SIZE          32          // Coil bits (0-255 packed)
 #define DISCRETE_INPUTS_SIZE 32         // Discrete input bits (0-255 packed)
+#define REG_SEQ_REGION_SHIFT 4          // Snapshot seqlock region = 16 registers (v7.9.8.20)
+#define REG_SEQ_REGION_SIZE  (1 << REG_SEQ_REGION_SHIFT)
+#define REG_SNAPSHOT_MAX_RETRIES 16     // Lock-free attempts before copying under the writer lock
+#define REG_JOURNAL_SIZE    512         // Register change ring entries, power of 2, 4 bytes each (v7.9.8.21)
+#define REG_PAGE_SHIFT      6           // Sparse HR/IR above the flat arrays: 64-word pages (v7.9.8.22)
+#define REG_PAGE_WORDS      (1 << REG_PAGE_SHIFT)
+#define REG_PAGE_COUNT      (0x10000 >> REG_PAGE_SHIFT)  // Page table slots per bank (1 byte each)
+#define REG_PAGE_POOL_MAX   64          // Max pages mapped in total (64 x 128 B = 8 KB heap)
+#define REG_PAGE_DECL_MAX   16          // Page ranges declared in config
+#define REG_HOOK_MAX        8           // Distinct holding register write hooks (v7.9.8.23)
 
 /* ============================================================================
  * ST LOGIC REGISTER MAPPING (Input/Holding Registers 200+)
@@ -64,6 +87,13 @@
 #define ST_LOGIC_TOTAL_CYCLES_REG       290  // Total cycles executed, 32-bit (290-291)
 #define ST_LOGIC_EXEC_INTERVAL_RO_REG   292  // Execution interval ms (read-only copy), 32-bit (292-293)
 
+// SCAN SCHEDULING (FEAT-154) - Input Registers 294-441
+#define ST_LOGIC_SCAN_PERIOD_REG_BASE       294  // Logic1-4 Effective scan period ms (294-297)
+#define ST_LOGIC_SCAN_JITTER_MAX_REG_BASE   298  // Logic1-4 Max start jitter µs, 32-bit (298-305, 2 regs each)
+#define ST_LOGIC_SCAN_SKIPPED_REG_BASE      306  // Logic1-4 Skipped scans, 32-bit (306-313, 2 regs each)
+#define ST_LOGIC_SCAN_JITTER_HIST_REG_BASE  314  // Logic1-4 Start jitter histogram, 8 x 32-bit buckets (314-377, 16 regs each)
+#define ST_LOGIC_SCAN_OVERRUN_HIST_REG_BASE 378  // Logic1-4 Overrun histogram, 8 x 32-bit buckets (378-441, 16 regs each)
+
 // HOLDING REGISTERS (Read/Write control)
 #define ST_LOGIC_CONTROL_REG_BASE       200  // Logic1-4 Control (200-203)
 #define ST_LOGIC_VAR_INPUT_REG_BASE     204  // Logic1-4 Variable Input (204-235)
@@ -100,6 +130,7 @@
 #define MODULE_FLAG_COUNTERS_DISABLED   0x01  // Bit 0: Counters disabled
 #define MODULE_FLAG_TIMERS_DISABLED     0x02  // Bit 1: Timers disabled
 #define MODULE_FLAG_ST_LOGIC_DISABLED   0x04  // Bit 2: ST Logic disabled
+#define MODULE_FLAG_ST_PARALLEL_DISABLED 0x08 // Bit 3: ST Logic parallel execution disabled (FEAT-153)
 
 /* ============================================================================
  * COUNTER CONFIGURATION
@@ -197,7 +228,7 @@ typedef enum {
  * EEPROM / NVS CONFIGURATION
  * ============================================================================ */
 
-#define CONFIG_SCHEMA_VERSION   19      // Current config schema version (v7.9.7.2: cache/queue size)
+#define CONFIG_SCHEMA_VERSION   26      // Current config schema version (v7.9.8.22: sparse register pages)
 
 /* ============================================================================
  * RBAC CONSTANTS (v7.6.2)
@@ -467,6 +498,38 @@ typedef enum {
 #define MODBUS_MASTER_DEFAULT_TIMEOUT      500   // ms
 #define MODBUS_MASTER_DEFAULT_INTER_FRAME  10    // ms
 #define MODBUS_MASTER_DEFAULT_MAX_REQUESTS 10    // per cycle
+#define MODBUS_MASTER_DEFAULT_COALESCE_GAP 4     // Registers bridged when merging reads (v7.9.8.11)
+
+// Protocol limits for one request (255-byte RTU frame)
+#define MODBUS_MASTER_MAX_READ_REGS        125   // FC03/FC04
+#define MODBUS_MASTER_MAX_READ_BITS        2000  // FC01/FC02
+#define MODBUS_MASTER_MAX_WRITE_REGS       123   // FC16 (v7.9.8.16)
+#define MODBUS_MASTER_MAX_WRITE_BITS       1968  // FC15 (v7.9.8.19)
+
+// Poll groups (v7.9.8.12): cyclic block reads into the async cache
+#define MB_POLL_GROUPS_MAX                 16    // Groups stored in PersistConfig
+#define MB_POLL_MAX_COUNT                  125   // Registers/bits per group (one cache entry each)
+#define MB_POLL_MIN_PERIOD_MS              10
+#define MB_POLL_MAX_PERIOD_MS              3600000UL  // 1 hour
+
+// Multi-bus master (v7.9.8.14): one async worker per RS485 bus
+// Bus 0 = master UART above (modbus_master_config_t). Bus 1 = the spare UART,
+// pins from uart<N>_tx/rx/dir_pin (no board default — must be configured).
+#define MB_BUS_MAX                         2
+#define MB_BUS_ROUTES_MAX                  8     // Slave-ID ranges routed away from bus 0
+#if MODBUS_SINGLE_TRANSCEIVER
+  #define MODBUS_MASTER_BUS1_UART          1     // UART2 drives the shared onboard transceiver
+#else
+  #define MODBUS_MASTER_BUS1_UART          2     // UART1 = bus 0 master port
+#endif
+
+// Response wait (v7.9.8.13): block on the UART RX event instead of polling
+#define MODBUS_MASTER_RX_IDLE_SYMBOLS      2     // RX timeout (char times) that raises the data event
+#if MODBUS_SINGLE_TRANSCEIVER
+  #define MODBUS_MASTER_HW_RS485           0     // Shared DIR pin stays under uart_driver/GPIO control
+#else
+  #define MODBUS_MASTER_HW_RS485           1     // UART drives DE from RTS (UART_MODE_RS485_HALF_DUPLEX)
+#endif
 
 // Protocol constants
 #define MODBUS_MASTER_MIN_RESPONSE_TIME    3     // ms (minimum inter-frame delay)
@@ -499,10 +562,169 @@ typedef enum {
  * ============================================================================ */
 
 #define PROJECT_NAME        "Modbus RTU Server (ESP32)"
-#define PROJECT_VERSION     "7.9.7.2"
+#define PROJECT_VERSION     "7.9.8.24"
 // BUILD_DATE and BUILD_NUMBER now in build_version.h (auto-generated)
 
 /* Version history:
+ * v7.9.8.24 (2026-10-16): FEAT-169: Flere Modbus function codes der sparer round trips
+ *                    - FC23 Read/Write Multiple Registers: skrivning + læsning i ét step under register-låsen
+ *                      (erstatter FC16+FC03 read-modify-write sekvenser fra HMI'er uden race mellem de to)
+ *                    - FC22 Mask Write Register: (værdi AND and_mask) OR (or_mask AND NOT and_mask) atomisk
+ *                    - FC43/14 Read Device Identification: basic + regular objekter, individual access
+ *                    - FC08 Diagnostics: echo (0x00), clear (0x0A) og tællere 0x0B-0x0F fra RTU slave RX
+ *                      (bus messages, CRC/frame fejl, exceptions, egne requests, broadcasts uden svar)
+ *                    - 'show modbus-slave' viser FC08 tællerne
+ * v7.9.8.23 (2026-10-16): FEAT-168: Adresse-dispatch tabel for holding register side-effekter
+ *                    - If-kæden i registers_set_holding_register (ST control/interval/var-input) erstattet af
+ *                      en bitmap pr. HR (32 bytes) + handler-indeks (256 bytes) + tabel med max 8 hooks
+ *                    - Almindelige registre: ét bit-opslag efter store; kun registre med hook kalder en handler
+ *                    - FC16/bulk-skrivning kalder hver handler én gang pr. sammenhængende område i stedet for pr. word
+ *                      (execution interval HR 236-237 valideres nu én gang pr. FC16 i stedet for to)
+ *                    - registers_write_hook_install()/remove() som fælles udvidelsespunkt for register-ejere
+ * v7.9.8.22 (2026-10-16): FEAT-167: Sparse, paged register adresserum for HR/IR over de faste arrays
+ *                    - HR >= 256 og IR >= 512 ligger i sider af 64 registre; sidetabel på 1 byte pr. side (2 x 1 KB)
+ *                      giver O(1) opslag, sider allokeres fra en pulje på max 64 (8 KB heap) når de tages i brug
+ *                    - Sider erklæres i config ('set reg-map hr|ir <start> <antal>', max 16 områder, schema 25 -> 26)
+ *                      eller allokeres on demand når register_allocator tildeler en adresse over 256
+ *                    - register_allocator dækker hele 16-bit adresserummet (områdetabel over de faste 180 adresser)
+ *                    - FC03/FC04/FC06/FC16, REST og CLI accepterer mappede adresser; FC03/FC04/FC16 kopierer en side ad gangen
+ *                    - 'show reg-map', GET /api/registers/map og metrics register_pages_mapped/register_pages_max
+ * v7.9.8.21 (2026-10-16): FEAT-166: Register change journal som fælles kilde for SSE og persistens
+ *                    - Alle register/coil setters logger reelle ændringer i én ring (512 x 4 bytes) med sekvensnummer
+ *                    - Sekvens for sidste ændring pr. blok af 16 adresser; læsere der taber ringen markerer blokkene dirty
+ *                    - Pr. læser: cursor + dirty bitmap pr. adresse (164 bytes) i stedet for fuld skyggekopi
+ *                    - SSE: watch_all-kopien (~3 KB pr. klient) og scan af 1280 adresser pr. tick fjernet
+ *                    - ST SAVE(): springer NVS-skrivning over når gruppens registre er uændrede siden sidste SAVE
+ *                    - Nye metrics: register_journal_changes_total, register_journal_overruns_total
+ * v7.9.8.20 (2026-10-16): FEAT-165: Seqlock-baserede multi-register snapshots
+ *                    - Holding/input registre opdelt i regioner af 16 med sekvenstæller (ulige = skrivning i gang)
+ *                    - Multi-word writers (counter værdi/raw/compare, ST exports + status, GPIO ST-mapping, FC16)
+ *                      skriver via registers_set_holding_registers()/registers_set_input_registers()
+ *                    - FC03/FC04, REST bulk reads, /api/metrics og SSE watch_all læser lock-free og prøver igen ved
+ *                      samtidig skrivning; efter 16 forsøg kopieres under writer-låsen
+ *                    - Counter write-lock + 10x10 us spin i FC03 (ISSUE-1/BUG-031) fjernet
+ *                    - Nye metrics: register_snapshot_retries_total, register_snapshot_locked_total
+ * v7.9.8.19 (2026-10-16): FEAT-164: Write combining og last-value-wins for remote writes
+ *                    - Pending-write tabel pr. bus (32): gentagne writes til samme adresse opdaterer kun værdien
+ *                    - Ventende nabo-writes til samme slave sendes som én FC16 / FC15 (ny modbus_master_write_coils)
+ *                    - Uændrede værdier springes over; 'set modbus-master write-always <id|a-b> on' slår det fra pr. slave
+ *                    - Fix: cache viste 1 i stedet for den skrevne værdi efter FC05/FC06, og ST builtins satte en
+ *                      oversprunget write til PENDING, så næste identiske write alligevel blev sendt
+ *                    - 'set modbus-master write-combine on|off' + REST "write_combine"/"write_always"; schema 24 -> 25
+ * v7.9.8.18 (2026-10-16): FEAT-163: Simuleret RS485 slave farm til benchmark af Modbus master
+ *                    - Master byte-I/O gennem udskiftelig transport (mb_transport.h); UART er default
+ *                    - Slave farm kun på host: tests/host/mb_pty_bus + bench_mb_farm (pty, latency/jitter,
+ *                      baudrate-pacing, fejlinjektion); intet simulator-modul i firmwaren
+ * v7.9.8.17 (2026-10-16): FEAT-162: Profiler for Modbus master bus-udnyttelse og transaktions-latency
+ *                    - Ny mb_profile: histogrammer for latency (kø → færdig), turnaround (sendt → første svar-byte) og bytes
+ *                    - Pr. function code (FC01-06, FC15, FC16, andre) og pr. slave (første 8, resten under "other")
+ *                    - Bus-udnyttelse (wire-tid, 11 bit/tegn) og optaget-tid over rullende 10 s vindue pr. bus
+ *                    - /api/metrics: Prometheus histogrammer + utilisation/occupancy gauges (buffer 16 → 24 KB)
+ *                    - SSE: subscribe=modbus (opt-in) med mb_bus / mb_fc / mb_slave events max 1 Hz
+ *                    - CLI: show modbus-master profile [verbose], reset modbus-master profile
+ * v7.9.8.16 (2026-10-16): FEAT-161: Ref-talte payload slots for multi-register reads/writes
+ *                    - Delt g_mb_multi_reg_buf[16] + 4-slot write ring erstattet af 12 x 125 registre med reference-tæller
+ *                    - FC16: requesten ejer sin slot indtil workeren har sendt den (ingen overskrivning ved fuld ring)
+ *                    - FC03: resultatet gemmes pr. (slave, adresse, count) — 8 blokke LRU; ST pinner slot under kopiering
+ *                    - modbus_master_read_holdings/write_holdings: 16-register grænse hævet til 125/123 (protokol max)
+ *                    - Nye metrics: payload_slots_in_use/total, payload_alloc_failures_total
+ * v7.9.8.15 (2026-10-16): FEAT-160: Lock-free prioritetsringe i async Modbus master
+ *                    - pq_mutex + O(n) scan erstattet af én bounded MPSC ring pr. prioritet (WRITE / READ_FRESH / READ_REFRESH)
+ *                    - Producers indsætter med CAS på ring head; bus workeren popper O(1) fra højeste ikke-tomme klasse
+ *                    - Fuld kø: højere klasse fortrænger ældste request i laveste klasse (cache PENDING rulles tilbage)
+ *                    - Dedup: PENDING test-and-set i én critical section — samme read i kø/under udførelse køes ikke igen
+ *                    - Coalescing markerer flettede slots som taget i stedet for at flytte køen om
+ *                    - Nye metrics: queue contention, dedup, class depth og drops pr. bus
+ * v7.9.8.14 (2026-10-16): FEAT-159: Multi-bus Modbus master (én async worker pr. RS485 bus)
+ *                    - mb_async pr. bus: egen prioritetskø, cache shard, backoff tabel og FreeRTOS task
+ *                    - Bus 0 = eksisterende master port; bus 1 = ekstra UART (uart<N>_tx/rx/dir_pin skal sættes)
+ *                    - Routing tabel: op til 8 slave-ID intervaller -> bus; øvrige slaves på bus 0
+ *                    - modbus_master_send_request vælger UART/DE/RX event ud fra slave-ID — ST builtins og REST uændret
+ *                    - En død slave på én bus forsinker ikke de andre; poll groups kører på deres slaves bus
+ *                    - 'set modbus-master bus|route ...' + GET/POST /api/modbus/master/bus + metrics pr. bus; schema 23 -> 24
+ * v7.9.8.13 (2026-10-16): FEAT-158: Event-drevet response wait i Modbus master
+ *                    - modbus_master_send_request blokerer på UART RX event (semaphore) i stedet for millis()/available() spin
+ *                    - RX timeout på 2 tegn vækker tasken ved frame-slut; to-fase timeout (første byte / inter-char) uændret
+ *                    - Dedikeret master port: UART_MODE_RS485_HALF_DUPLEX styrer DE via RTS (ingen delayMicroseconds turnaround)
+ *                    - Fallback til GPIO DE + BUG-316 delay hvis UART ikke kan RS485 mode (og altid på ES32D26)
+ *                    - Nye metrics: rx wait/busy tid, rx events, hw_rs485 og Core 0 load (idle task run-time counter)
+ * v7.9.8.12 (2026-10-16): FEAT-157: Poll groups for Modbus master (uafhængig af ST scan rate)
+ *                    - Op til 16 groups (slave, FC01-04, start, count <= 125, period, priority) i PersistConfig
+ *                    - mb_async kører groups som block reads på et deadline-grid; højest prioritet først, så tidligste deadline
+ *                    - Resultat direkte i cachen; ST MB_READ_* af pollede adresser køer intet og tæller ikke mod max-requests
+ *                    - Pr. group statistik: polls/errors/missed, opnået rate og lateness (sidste/avg/max)
+ *                    - 'set modbus-master poll <id> ...' + GET/POST /api/modbus/master/poll + metrics; schema 22 -> 23
+ * v7.9.8.11 (2026-10-16): FEAT-156: Read coalescing i async Modbus master
+ *                    - Køede single-reads til samme slave/FC samles til én FC03/04 eller FC01/02 block read
+ *                    - Vindue vokser mod nærmeste nabo; huller op til coalesce-gap (0-32) brobygges
+ *                    - Respekterer protokol-grænser (125 registre / 2000 bits); exception -> enkelt-reads fallback
+ *                    - 'set modbus-master coalesce on|off / coalesce-gap N' + REST "coalesce"/"coalesce_gap"
+ *                    - Metrics: coalesced blocks/reads/fallbacks + estimeret sparet bus-tid; schema 21 -> 22
+ * v7.9.8.10 (2026-10-16): FEAT-155: Hash-indekseret Modbus master cache
+ *                    - mb_cache_find/get_or_create: open-addressing hash på (slave, addr, fc) i stedet for lineær scan
+ *                    - Intrusiv LRU liste (lru_prev/next) → O(1) eviction af mindst brugte ikke-PENDING entry
+ *                    - Entries heap-allokeret (PSRAM hvis tilgængelig), indeks i intern RAM
+ *                    - cache-size 1-1024 med PSRAM, 1-256 uden; CLI + POST /api/modbus/master "cache_max_entries"
+ *                    - cache_max_entries uint8 -> uint16 (schema 20 -> 21); modbus_master_cache_evictions_total metric
+ *                    - Entries tilgås kun under mb_cache_spinlock (find/get_or_create giver kopi) → resize frigiver straks
+ * v7.9.8.9 (2026-10-16): FEAT-154: Deterministisk scan scheduler med jitter statistik
+ *                    - Hvert program kører på fast esp_timer µs grid (next_due += periode), ikke millis() throttle
+ *                    - Pr. program: period_ms (0 = global interval), priority (højest først), policy skip/catchup
+ *                    - One-shot esp_timer vækker loop task ved næste due tid (st_logic_scan_wait erstatter delay(1))
+ *                    - Start-jitter og overrun histogrammer (8 buckets) → IR 294-441, /api/metrics og /api/logic/{id}/stats
+ *                    - 'set logic <id> period:/priority:/policy:' + POST /api/logic/{id}/schedule; gemmes i /logic_N.dat trailer
+ *                    - BUG-328: INPUT_REGS_SIZE 256 -> 512 (ST performance registre IR 256-293 blev stille droppet)
+ * v7.9.8.8 (2026-10-16): FEAT-153: Parallel ST eksekvering på begge kerner
+ *                    - Afhængighedsanalyse pr. program: VariableMapping registre + IR export område (st_logic_parallel)
+ *                    - Programmer der deler registre samles i grupper (union-find) og kører serielt i id-orden
+ *                    - MB_* / CNT_* / SAVE / LOAD og aktiv debugger → låst til loop task (Core 1)
+ *                    - Øvrige grupper fordeles på loop task + st_worker task (Core 0) efter last_execution_us
+ *                    - Barriere før gpio_mapping_write_after_st_logic(); 'set logic parallel:on|off' + REST "parallel"
+ *                    - Gemmes i module_flags (MODULE_FLAG_ST_PARALLEL_DISABLED, ingen schema ændring)
+ * v7.9.8.7 (2026-10-16): FEAT-152: Superinstruktioner for IEC funktioner
+ *                    - CALL_TON/TOF/TP, CALL_CTU/CTD, CALL_R_TRIG/F_TRIG kalder kernel direkte (ingen builtin dispatch)
+ *                    - LIMIT_INT/DINT/REAL og SCALE_REAL når argumenttyper kendes statisk (CVT_* indsættes)
+ *                    - ST_MAX_TIMER_INSTANCES 8 -> 32 (timer-stiger); bytecode cache format v6
+ *                    - -DST_COMPILER_SUPERINSTRUCTIONS=0 til A/B måling
+ *                    - BUG-326: SCALE resultat blev mærket INT på type-stack (forkert værdi i REAL variabel)
+ *                    - BUG-327: CTU/CTD via CALL_BUILTIN talte aldrig (fanget af 3-arg grenen)
+ * v7.9.8.6 (2026-10-16): FEAT-151: Bytecode optimizer (peephole + konstant-foldning)
+ *                    - st_optimizer_run() efter kompilering, før SPIFFS cache (build flag ST_OPTIMIZER_ENABLED)
+ *                    - Konstant-foldning, døde stores, jump threading, fjernelse af uopnåelig kode
+ *                    - Ny opcode INC_VAR: LOAD_VAR/PUSH_INT/ADD/STORE_VAR fusioneret (INT/DINT)
+ *                    - 'show logic' viser instruktioner før/efter; bytecode cache format v5
+ * v7.9.8.5 (2026-10-16): FEAT-150: Persistent VM pr. logic slot
+ *                    - Én heap-allokeret st_vm_t pr. program genbruges hver scan (frigives ved delete)
+ *                    - st_vm_begin_cycle(): nulstiller kun pc/sp/flags/call stack - ingen memset af hele VM (~2 KB)
+ *                    - Variabler kopieres ind under st_var_spinlock (var_count værdier), som ud-kopieringen
+ * v7.9.8.4 (2026-10-16): FEAT-149: Statisk typede opcodes i ST compiler/VM
+ *                    - Compiler udleder typer (INT/DINT/REAL) og emitter ADD_INT, LT_REAL, ... + CVT_* konverteringer
+ *                    - Typede opcodes læser ikke type-stack og har ingen type-forgreninger; ukendte typer bruger generiske ops
+ *                    - FOR-loop exit-test bruger typet LT (slutværdi konverteres én gang før loop)
+ *                    - ST_BYTECODE_VERSION 4 (gamle caches rekompileres); -DST_COMPILER_TYPED_OPS=0 til A/B måling
+ *                    - tests/test_st_vm_bench.py: cycles/instr og us/cyklus kolonner
+ *                    - BUG-325: LT med DINT/INT operander læste INT-operand som dint_val
+ * v7.9.8.3 (2026-10-16): FEAT-148: Threaded dispatch i ST VM
+ *                    - st_vm_run_fast(): computed-goto dispatch, PC i register, ingen switch pr. instruktion
+ *                    - Logic engine bruger fast path når ingen debugger er aktiv; step-loop kun ved ST_DEBUG_*
+ *                    - last_instructions i /api/logic/{id}/stats og "show logic N stats" (Minstr/s)
+ *                    - tests/test_st_vm_bench.py: instruktioner/s for fast path vs. debug-loop
+ * v7.9.8.2 (2026-10-16): FEAT-147: Event-drevet Modbus RTU slave task
+ *                    - Slave kører i egen task (Core 1, prio 5) i stedet for loop()
+ *                    - Frame-slut (t3.5) detekteres af UART RX timeout, ikke millis() polling
+ *                    - Latency histogram modbus_slave_response_latency_seconds i /api/metrics
+ *                    - Slave statistik (requests/success/CRC/exceptions) tælles nu faktisk
+ * v7.9.8.1 (2026-10-16): FEAT-146: Zero-copy RTU frame path
+ *                    - ModbusFrame er én sammenhængende wire-buffer (ID + FC + data + CRC)
+ *                    - RX skriver UART bytes direkte i frame, CRC beregnes in-place (ingen 254B stack-kopi)
+ *                    - TX sender frame direkte; FC03/04 pakker registre direkte i svar-frame
+ *                    - FC0F/FC10 parser peger ind i request-frame i stedet for at kopiere værdier
+ *                    - BUG-324: crc16_table var forkert efter index 15 — regenereret (0xA001)
+ * v7.9.8.0 (2026-10-16): FEAT-145: Modbus TCP slave server (port 502)
+ *                    - MBAP framing ind i samme FC-dispatcher som RTU (fælles register-map)
+ *                    - Op til 4 klienter via select(), pipelinede requests besvares i én send()
+ *                    - set/show modbus-tcp, backup/restore, Prometheus modbus_tcp_* metrics
+ *                    - Schema 19→20 migration med defaults (enabled, port 502, 4 klienter, 60s idle)
  * v7.9.7.2 (2026-04-14): FEAT: Konfigurerbar cache/kø-størrelse via CLI + NVS
  *                    - set modbus-master cache-size <1-32> og queue-size <4-32>
  *                    - Runtime limits med compile-time max som øvre grænse
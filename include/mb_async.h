@@ -18,6 +18,7 @@
 #include <freertos/task.h>
 #include "st_types.h"
 #include "constants.h"
+#include "types.h"
 
 /* ============================================================================
  * CONFIGURATION
@@ -25,16 +26,24 @@
 
 #define MB_CACHE_MAX_ENTRIES_DEFAULT  32   // Default max unique (slave, addr, fc) combinations
 #define MB_ASYNC_QUEUE_SIZE_DEFAULT  16   // Default max pending requests in queue
-#define MB_CACHE_MAX_ENTRIES    32   // Compile-time max (array size)
-#define MB_ASYNC_QUEUE_SIZE    32   // Compile-time max (array size for priority queue)
+#define MB_CACHE_MAX_ENTRIES  1024   // Max cache size with PSRAM (uint16 index)
+#define MB_CACHE_MAX_ENTRIES_DRAM 256   // Max cache size without PSRAM (internal heap)
+#define MB_CACHE_NIL       0xFFFF   // Empty hash slot / end of LRU list
+#define MB_ASYNC_QUEUE_SIZE    32   // Compile-time max (slots per priority ring, power of two)
 #define MB_ASYNC_TASK_STACK  4096   // Background task stack (bytes)
 #define MB_ASYNC_TASK_PRIO      3   // Task priority (below WiFi, above idle)
 #define MB_ASYNC_TASK_CORE      0   // Run on Core 0 (main loop = Core 1)
-#define MB_MULTI_REG_POOL_SIZE  4   // Ring-buffer slots for FC16 write values
+#define MB_PAYLOAD_REGS       125   // Registers per payload slot (FC03 max; FC16 max is 123)
+#define MB_PAYLOAD_SLOTS       12   // Ref-counted slots for multi-register writes + read results
+#define MB_PAYLOAD_NONE      0xFF   // No payload slot
+#define MB_BLOCK_RESULTS_MAX    8   // Completed multi-register reads kept for ST (LRU)
 #define MB_SLAVE_BACKOFF_MAX    8   // Max tracked slaves for adaptive backoff
 #define MB_BACKOFF_INITIAL_MS  50   // Initial extra delay after first timeout
 #define MB_BACKOFF_MAX_MS    2000   // Max backoff delay (2 seconds)
 #define MB_BACKOFF_DECAY_MS   100   // Reduce backoff by this much on each success
+#define MB_COALESCE_MAX_GAP    32   // Max configurable coalesce gap (registers)
+#define MB_COALESCE_MAX_MEMBERS (MB_ASYNC_QUEUE_SIZE + 1)  // Queue + dequeued seed
+#define MB_WRITE_PENDING_MAX   MB_ASYNC_QUEUE_SIZE  // Combined single writes waiting per bus (v7.9.8.19)
 
 /* ============================================================================
  * TYPES
@@ -58,6 +67,8 @@ typedef enum {
   MB_PRIO_READ_REFRESH = 2    // Cache refresh — client already has a value
 } mb_request_priority_t;
 
+#define MB_PRIO_COUNT           3   // Priority classes = request rings per bus
+
 typedef enum {
   MB_CACHE_EMPTY = 0,         // Never requested
   MB_CACHE_PENDING,           // Request queued, waiting for response
@@ -78,7 +89,9 @@ typedef struct {
   int32_t             last_error;     // mb_error_code_t
   uint32_t            last_update_ms; // millis() at last update
   uint8_t             last_fc;        // Actual FC of last completed op (1-6)
-} mb_cache_entry_t;                   // ~21 bytes
+  uint16_t            lru_prev;       // Toward most recently used (MB_CACHE_NIL = head)
+  uint16_t            lru_next;       // Toward least recently used (MB_CACHE_NIL = tail)
+} mb_cache_entry_t;                   // ~25 bytes
 
 typedef struct {
   mb_request_type_t type;             // 1 byte
@@ -86,26 +99,94 @@ typedef struct {
   uint16_t          address;          // 2 bytes
   st_value_t        write_value;      // 4 bytes (only for single writes)
   uint8_t           count;            // register count for multi-register ops (v7.9.2)
-  uint8_t           multi_pool_slot;  // index into g_mb_multi_write_pool (v7.9.3: was multi_regs[16])
+  uint8_t           payload;          // FC16 values: payload slot, one reference owned by the request (v7.9.8.16)
   uint8_t           priority;         // mb_request_priority_t (v7.9.7: priority queue)
-  uint16_t          insert_seq;       // insertion order for FIFO within same priority
-} mb_async_request_t;                 // 13 bytes
-
+  uint8_t           combined;         // FC05/FC06: value lives in the bus's pending-write table (v7.9.8.19)
+  uint32_t          queued_us;        // micros() when queued (v7.9.8.17: profiler latency)
+} mb_async_request_t;                 // 16 bytes
+
+/* Bounded lock-free MPSC ring, one per priority class (v7.9.8.15)
+ * Producers (any task) claim a slot with a CAS on head and publish it by
+ * storing seq = pos + 1. Only the bus worker task pops, so tail and taken[]
+ * need no atomics. FIFO order within the class replaces insert_seq. */
+typedef struct {
+  volatile uint32_t  head;                          // Next claim position (producers, CAS)
+  uint32_t           tail;                          // Next pop position (worker only)
+  volatile uint32_t  count;                         // Published and not yet popped/taken
+  volatile uint32_t  seq[MB_ASYNC_QUEUE_SIZE];      // Slot sequence (pos + 1 = published)
+  uint8_t            taken[MB_ASYNC_QUEUE_SIZE];    // Merged into a coalesced block (worker only)
+  mb_async_request_t slot[MB_ASYNC_QUEUE_SIZE];
+} mb_pq_ring_t;
+
+/* One coalesced block read (v7.9.8.11) */
+typedef struct {
+  uint8_t  req_type;                  // MB_REQ_READ_COIL .. MB_REQ_READ_INPUT_REG
+  uint8_t  slave_id;
+  uint16_t start;                     // First register/bit on the wire
+  uint16_t count;                     // Registers (<= 125) or bits (<= 2000)
+  uint8_t  member_count;              // Single reads merged (incl. the dequeued one)
+  uint32_t queued_us;                 // Queue time of the dequeued read (profiler latency)
+  uint16_t members[MB_COALESCE_MAX_MEMBERS];  // Requested addresses, sorted
+} mb_coalesce_block_t;
+
+/* One single write waiting for the bus (v7.9.8.19)
+ * Repeated writes to the same address only replace value (last value wins);
+ * the ring holds one request per entry that carries the key, not the value. */
 typedef struct {
-  // Cache
-  mb_cache_entry_t entries[MB_CACHE_MAX_ENTRIES];
-  uint8_t          entry_count;
+  uint8_t    slave_id;                // 0 = free
+  uint8_t    req_type;                // MB_REQ_WRITE_COIL / MB_REQ_WRITE_HOLDING
+  uint16_t   address;
+  st_value_t value;                   // Latest value written
+} mb_write_pending_t;
 
-  // Priority queue (replaces FreeRTOS FIFO queue — v7.9.7)
-  mb_async_request_t pq_buf[MB_ASYNC_QUEUE_SIZE]; // Ring buffer for requests
-  volatile uint8_t   pq_count;                     // Current items in queue
-  uint16_t           pq_seq;                        // Monotonic insert counter
+/* Pending writes taken out of the table for one transaction (v7.9.8.19) */
+typedef struct {
+  uint8_t  req_type;                  // MB_REQ_WRITE_COIL (FC05/FC15) / MB_REQ_WRITE_HOLDING (FC06/FC16)
+  uint8_t  slave_id;
+  uint16_t start;
+  uint16_t count;                     // 1 = single write, > 1 = block write
+  uint32_t queued_us;                 // Queue time of the dequeued request (profiler latency)
+  uint16_t values[MB_WRITE_PENDING_MAX];  // Register values or 0/1 coil states
+} mb_write_block_t;
+
+/* Runtime state of one poll group (v7.9.8.12) */
+typedef struct {
+  ModbusPollGroup cfg;                // Copy of g_persist_config.mb_poll_groups[i]
+  uint32_t next_due_ms;               // millis() deadline of the next poll
+  uint32_t last_poll_ms;              // millis() at the start of the last poll (0 = never)
+  uint32_t polls;                     // Transactions executed
+  uint32_t errors;                    // Transactions that failed (timeout/CRC/exception)
+  uint32_t missed;                    // Periods dropped (> 1 period late, or slave in backoff)
+  uint32_t late_last_ms;              // Start time - deadline of the last poll
+  uint32_t late_max_ms;
+  uint32_t late_sum_ms;               // For the average (late_sum_ms / polls)
+  float    interval_avg_ms;           // Smoothed time between polls (achieved rate = 1000 / x)
+} mb_poll_state_t;
+
+/* State of one RS485 bus (v7.9.8.14: one instance + worker task per bus) */
+typedef struct {
+  uint8_t bus;                        // Index in g_mb_async[]
+
+  // Cache shard (v7.9.8.10: heap/PSRAM array + open-addressing hash index + LRU list)
+  mb_cache_entry_t *entries;          // cache_capacity entries, [0, entry_count) in use
+  uint16_t         *cache_index;      // Hash slots → entry index (MB_CACHE_NIL = free)
+  uint16_t          cache_capacity;   // Allocated entries (= cache_max_entries)
+  uint16_t          index_mask;       // Hash slots - 1 (power of two, >= 2x capacity)
+  uint16_t          entry_count;
+  uint16_t          lru_head;         // Most recently used entry
+  uint16_t          lru_tail;         // Least recently used entry (eviction candidate)
+  bool              cache_in_psram;
+
+  // Priority queue (v7.9.7; v7.9.8.15: one lock-free ring per priority class)
+  mb_pq_ring_t       pq_ring[MB_PRIO_COUNT];
+  volatile uint32_t  pq_count;       // Admitted requests, all classes (runtime limit)
+  volatile uint32_t  pq_evict;       // Lower-class requests the worker must drop
 
   // FreeRTOS synchronization
-  SemaphoreHandle_t  pq_mutex;       // Mutex for queue access
-  SemaphoreHandle_t  pq_semaphore;   // Counting semaphore (signals new items)
+  SemaphoreHandle_t  pq_semaphore;   // Counting semaphore (signals new items, NULL = stopped)
   TaskHandle_t       task_handle;
   volatile bool      task_running;
+  volatile bool      task_exited;    // Set by the worker as its last access to this state
 
   // Per-slave adaptive backoff (v7.9.5: non-blocking skip instead of vTaskDelay)
   struct {
@@ -119,13 +200,33 @@ typedef struct {
   // Statistics
   uint32_t cache_hits;
   uint32_t cache_misses;
+  uint32_t cache_evictions;       // LRU evictions (v7.9.8.10)
   uint32_t queue_full_count;
   uint32_t priority_drops;        // Requests dropped by priority eviction (v7.9.7)
   uint8_t  queue_high_watermark;  // Max queue depth seen (v7.9.7)
+  uint32_t queue_contention;      // Lost CAS races on a ring head (v7.9.8.15)
+  uint32_t queue_dedup;           // Reads skipped because one was already in flight (v7.9.8.15)
   uint32_t total_requests;
   uint32_t total_errors;
   uint32_t total_timeouts;
   uint32_t stats_since_ms;        // millis() at last stats reset (v7.9.3.2)
+
+  // Read coalescing (v7.9.8.11)
+  uint32_t coalesced_blocks;      // Block reads that replaced >= 2 single reads
+  uint32_t coalesced_reads;       // Single reads served by those blocks
+  uint32_t coalesce_fallbacks;    // Blocks rejected by the slave → re-read one by one
+  uint64_t coalesce_saved_us;     // Estimated bus time saved (wire time + inter-frame gaps)
+
+  // Write combining (v7.9.8.19) — table guarded by mb_cache_spinlock
+  mb_write_pending_t write_pending[MB_WRITE_PENDING_MAX];
+  uint32_t write_combined;        // Writes absorbed by a pending write to the same address
+  uint32_t write_skipped;         // Writes dropped: value equals the last confirmed value
+  uint32_t write_blocks;          // FC15/FC16 block writes that replaced >= 2 single writes
+  uint32_t write_block_members;   // Single writes served by those blocks
+  uint32_t write_fallbacks;       // Blocks rejected by the slave → written one by one
+
+  // Poll groups (v7.9.8.12) — guarded by mb_cache_spinlock
+  mb_poll_state_t poll[MB_POLL_GROUPS_MAX];
 } mb_async_state_t;
 
 /* ============================================================================
@@ -133,36 +234,91 @@ typedef struct {
  * ============================================================================ */
 
 /**
- * @brief Initialize async Modbus master — create queue + start background task
+ * @brief Initialize async Modbus master — bus 0 plus every enabled extra bus
  */
 void mb_async_init();
 
 /**
- * @brief Stop background task and cleanup
+ * @brief Stop all background tasks and cleanup
  */
 void mb_async_deinit();
 
 /**
- * @brief Suspend background task (for UART reconfiguration)
+ * @brief Suspend background tasks (for UART reconfiguration)
  */
 void mb_async_suspend();
 
 /**
- * @brief Resume background task after reconfiguration
+ * @brief Resume background tasks after reconfiguration
  */
 void mb_async_resume();
 
 /**
- * @brief Find cache entry by key
- * @return Pointer to entry or NULL
+ * @brief Start or stop an extra bus (1..MB_BUS_MAX-1) to match g_persist_config.mb_buses
+ *
+ * Restarts the UART with the current serial settings when the bus stays enabled.
+ * @return false if the bus is enabled but its UART could not be started
+ */
+bool mb_async_bus_apply(uint8_t bus);
+
+/**
+ * @brief Validate extra bus serial settings (standard baudrate, stop 1-2, timeout 100-5000 ms, delay 0-1000 ms)
+ */
+bool mb_bus_config_valid(const ModbusBusConfig *bus);
+
+/**
+ * @brief Validate a slave→bus route (slaves 1-247, first <= last, bus < MB_BUS_MAX)
+ */
+bool mb_bus_route_valid(const ModbusBusRoute *route);
+
+/**
+ * @brief Load the slave→bus routing table (call after changing g_persist_config.mb_bus_routes)
+ *
+ * Slaves not covered by a route use bus 0. Later routes win on overlap.
+ * Cache shards are cleared, since entries now belong to another bus.
+ */
+void mb_async_route_load(const ModbusBusRoute *routes);
+
+/**
+ * @brief Bus a slave is routed to (0 if not routed)
+ */
+uint8_t mb_async_bus_of(uint8_t slave_id);
+
+/**
+ * @brief (Re)allocate every running bus's cache shard — existing entries are dropped
+ *
+ * The old arrays are freed right after the swap: entries are only reached
+ * under mb_cache_spinlock, and callers outside mb_async get copies.
+ * @param max_entries Entries per shard, 1..MB_CACHE_MAX_ENTRIES (clamped to MB_CACHE_MAX_ENTRIES_DRAM without PSRAM)
+ * @return true if allocated
+ */
+bool mb_async_cache_resize(uint16_t max_entries);
+
+/**
+ * @brief Largest cache size this board can allocate (PSRAM or internal heap)
+ */
+uint16_t mb_async_cache_limit();
+
+/**
+ * @brief Find cache entry by key — O(1) hash lookup
+ * @param out Copy of the entry, taken under the cache lock (may be NULL)
+ * @return true if the key is cached
  */
-mb_cache_entry_t *mb_cache_find(uint8_t slave_id, uint16_t address, uint8_t req_type);
+bool mb_cache_find(uint8_t slave_id, uint16_t address, uint8_t req_type, mb_cache_entry_t *out);
 
 /**
- * @brief Find or create cache entry
- * @return Pointer to entry or NULL (cache full)
+ * @brief Find or create cache entry (marks it most recently used)
+ * When full, the least recently used non-PENDING entry is evicted.
+ * @param out Copy of the entry, taken under the cache lock (may be NULL)
+ * @return false if the cache is not allocated
  */
-mb_cache_entry_t *mb_cache_get_or_create(uint8_t slave_id, uint16_t address, uint8_t req_type);
+bool mb_cache_get_or_create(uint8_t slave_id, uint16_t address, uint8_t req_type, mb_cache_entry_t *out);
+
+/**
+ * @brief Copy of the entry in a shard slot, for listings
+ * @return false if the slot is not in use
+ */
+bool mb_cache_entry_at(const mb_async_state_t *b, uint16_t slot, mb_cache_entry_t *out);
 
 /**
  * @brief Queue a read request (non-blocking, deduplicates)
@@ -171,42 +327,176 @@ mb_cache_entry_t *mb_cache_get_or_create(uint8_t slave_id, uint16_t address, uin
 bool mb_async_queue_read(mb_request_type_t type, uint8_t slave_id, uint16_t address);
 
 /**
- * @brief Queue a write request (non-blocking, always queued)
- * @return true if queued successfully
+ * @brief Queue a single write (FC05/FC06, non-blocking)
+ *
+ * With write combining on, a write to an address that is already waiting only
+ * replaces its value (last value wins), and waiting writes to neighbouring
+ * addresses of the same slave go out as one FC15/FC16 block. A value equal to
+ * the last confirmed one is skipped unless the slave is marked write-always.
+ * @return true if queued, combined or skipped as unchanged
  */
 bool mb_async_queue_write(mb_request_type_t type, uint8_t slave_id, uint16_t address, st_value_t value);
 
 /**
- * @brief Queue a multi-register read (FC03 with count > 1)
- * Updates individual cache entries for each address in range.
+ * @brief Are writes to this slave sent even when the value is unchanged? (v7.9.8.19)
+ */
+bool mb_async_write_always(uint8_t slave_id);
+
+/**
+ * @brief Mark slaves first..last as write-always (on) or deduplicated (off) in g_persist_config
+ */
+void mb_async_write_always_set(uint8_t first, uint8_t last, bool on);
+
+/**
+ * @brief Queue a multi-register read (FC03, 1-MB_PAYLOAD_REGS registers)
+ * Updates individual cache entries for each address in range and publishes
+ * the block as a result slot (mb_async_block_result_pin).
  * @return true if queued successfully
  */
 bool mb_async_queue_read_multi(uint8_t slave_id, uint16_t address, uint8_t count);
 
 /**
- * @brief Queue a multi-register write (FC16)
- * Writes values from provided buffer via FC16.
+ * @brief Queue a multi-register write (FC16, 1-MODBUS_MASTER_MAX_WRITE_REGS registers)
+ * Copies values into a payload slot owned by the request.
  * @param values Array of uint16_t values to write (count entries)
- * @return true if queued successfully
+ * @return true if queued successfully (false also if no payload slot is free)
  */
 bool mb_async_queue_write_multi(uint8_t slave_id, uint16_t address, uint8_t count, const uint16_t *values);
 
 /**
- * @brief Check if any requests are pending in queue
+ * @brief Queue a multi-register write from a filled payload slot
+ * Takes over the caller's reference — also when it returns false.
+ */
+bool mb_async_queue_write_payload(uint8_t slave_id, uint16_t address, uint8_t count, uint8_t payload);
+
+/* ============================================================================
+ * PAYLOAD SLOTS (v7.9.8.16)
+ *
+ * Fixed pool of MB_PAYLOAD_SLOTS x MB_PAYLOAD_REGS registers shared by all
+ * buses. A slot is free when its reference count is 0; alloc/retain/release
+ * are lock-free and may be called from any task.
+ * ============================================================================ */
+
+/**
+ * @brief Allocate a payload slot (reference count 1)
+ * @return Slot index or MB_PAYLOAD_NONE if the pool is exhausted
+ */
+uint8_t mb_payload_alloc();
+
+void mb_payload_retain(uint8_t slot);
+void mb_payload_release(uint8_t slot);
+
+/**
+ * @brief Register data of a slot (caller must hold a reference)
+ */
+uint16_t *mb_payload_data(uint8_t slot);
+
+/**
+ * @brief Slots currently referenced / allocations that failed since boot
+ */
+uint8_t mb_payload_in_use();
+uint32_t mb_payload_alloc_failures();
+
+/**
+ * @brief Pin the last successful MB_READ_HOLDINGS result for (slave, address, count)
+ * The caller reads mb_payload_data(slot) and must call mb_payload_release(slot).
+ * @return Slot index or MB_PAYLOAD_NONE if no completed read is stored
+ */
+uint8_t mb_async_block_result_pin(uint8_t slave_id, uint16_t address, uint8_t count);
+
+/**
+ * @brief Pick the block window around a seed address (pure — no queue access)
+ *
+ * Grows [seed, seed] toward the nearest queued neighbour while the unused
+ * gap to it is <= max_gap and the block stays <= max_span wide.
+ *
+ * @param addrs Sorted candidate addresses (must contain seed)
+ * @param n Number of candidates
+ * @param seed Address of the dequeued request
+ * @param max_span 125 (registers) or 2000 (bits)
+ * @param max_gap Max unused addresses between two members
+ * @param start Output: first address of the block
+ * @return Block width (count)
+ */
+uint16_t mb_coalesce_select(const uint16_t *addrs, uint8_t n, uint16_t seed,
+                            uint16_t max_span, uint16_t max_gap, uint16_t *start);
+
+/**
+ * @brief Estimated bus time of one read transaction (request + response + inter-frame gap)
+ * @param bus Bus whose baudrate / inter-frame delay applies
+ * @param resp_bytes Response frame length in bytes
+ */
+uint32_t mb_coalesce_frame_us(uint8_t bus, uint16_t resp_bytes);
+
+/**
+ * @brief Validate a poll group definition (slave 1-247, FC 1-4, count, period, no address wrap)
+ */
+bool mb_poll_group_valid(const ModbusPollGroup *group);
+
+/**
+ * @brief Load poll groups into the scheduler (call after changing g_persist_config.mb_poll_groups)
+ *
+ * Groups whose definition is unchanged keep their deadline and statistics;
+ * new or changed groups are due immediately.
+ */
+void mb_async_poll_load(const ModbusPollGroup *groups);
+
+/**
+ * @brief Runtime state of a poll group, taken from the bus its slave is routed to
+ */
+const mb_poll_state_t *mb_async_poll_state(uint8_t idx);
+
+/**
+ * @brief Is this address refreshed by an enabled poll group?
+ * ST reads of polled addresses are served from cache without queueing a request.
+ */
+bool mb_async_poll_covers(uint8_t slave_id, uint8_t req_type, uint16_t address);
+
+/**
+ * @brief Pick the next poll group to run (pure — no locking, used by the task and host tests)
+ *
+ * Among the groups that are due, the highest priority wins; equal priorities
+ * run in deadline order.
+ *
+ * @param groups Poll group states
+ * @param n Number of groups
+ * @param now_ms Current millis()
+ * @param wait_ms In/out: capped to the time until the next deadline when nothing is due
+ * @return Group index, or -1 if no group is due
+ */
+int8_t mb_poll_pick(const mb_poll_state_t *groups, uint8_t n, uint32_t now_ms, uint32_t *wait_ms);
+
+/**
+ * @brief Advance a group's deadline after a poll started at now_ms (drops periods it can't catch up)
+ */
+void mb_poll_advance(mb_poll_state_t *g, uint32_t now_ms);
+
+/**
+ * @brief Achieved poll rate of a group in Hz (0 until two polls have run)
+ */
+float mb_poll_rate_hz(const mb_poll_state_t *g);
+
+/**
+ * @brief Check if any requests are pending in any bus queue
  * @return true if queue has pending items
  */
 bool mb_async_is_busy();
 
 /**
- * @brief Get current queue depth
+ * @brief Get current queue depth (summed over all buses)
  */
 uint8_t mb_async_queue_depth();
 
 /**
- * @brief Get async state for diagnostics (show modbus cache)
+ * @brief Get async state of bus 0 for diagnostics (show modbus cache)
  */
 const mb_async_state_t *mb_async_get_state();
 
+/**
+ * @brief Get async state of one bus (NULL if bus >= MB_BUS_MAX)
+ */
+const mb_async_state_t *mb_async_get_bus_state(uint8_t bus);
+
 /**
  * @brief Reset cache — clear all entries
  */
@@ -217,15 +507,10 @@ void mb_async_reset_cache();
  */
 void mb_async_reset_stats();
 
-/* Global async state */
-extern mb_async_state_t g_mb_async;
+/* Global async state, one per bus */
+extern mb_async_state_t g_mb_async[MB_BUS_MAX];
 
 /* Spinlock for thread-safe cache access between Core 0 and Core 1 */
 extern portMUX_TYPE mb_cache_spinlock;
 
-/* Ring-buffer pool for FC16 multi-register write values (v7.9.3)
- * 4 slots × 16 regs × 2 bytes = 128 bytes (was 32 bytes × 16 queue items = 512 bytes inline) */
-extern uint16_t g_mb_multi_write_pool[MB_MULTI_REG_POOL_SIZE][16];
-extern volatile uint8_t g_mb_multi_write_next;  // Next free slot (0-3, wraps)
-
 #endif // MB_ASYNC_H
@@ -0,0 +1,121 @@
+/**
+ * @file mb_profile.h
+ * @brief Modbus master bus utilisation + transaction latency profiler (FEAT-162)
+ *
+ * Every transaction that reaches the bus is recorded twice:
+ *
+ *   modbus_master_send_request() — turnaround (request sent → first response
+ *                                  byte), bytes on the wire, bus hold time
+ *   mb_async worker              — request latency (queued → completed)
+ *
+ * Histograms are kept per function code (FC01-06, FC15, FC16, other) and per
+ * slave (first MB_PROFILE_SLAVES slaves seen, the rest share one "other"
+ * entry). Bus utilisation is the wire time of the frames (11 bits per
+ * character at the bus baudrate) over a rolling window of whole seconds;
+ * occupancy is the time the bus was held by transactions (incl. slave
+ * turnaround and timeouts) over the same window.
+ *
+ * Runtime only, not persisted. Reset with "reset modbus-master profile".
+ */
+
+#ifndef MB_PROFILE_H
+#define MB_PROFILE_H
+
+#include <stdint.h>
+#include "constants.h"
+
+#define MB_PROFILE_BUCKETS              10
+#define MB_PROFILE_LATENCY_BOUNDS_US    { 2000, 5000, 10000, 20000, 50000, 100000, 200000, 500000, 1000000 }
+#define MB_PROFILE_TURNAROUND_BOUNDS_US { 250, 500, 1000, 2000, 5000, 10000, 20000, 50000, 100000 }
+#define MB_PROFILE_BYTES_BOUNDS         { 8, 12, 16, 24, 32, 64, 128, 256, 384 }
+
+#define MB_PROFILE_SLAVES       8       // Tracked slave IDs (+1 shared "other" entry)
+#define MB_PROFILE_FCS          9       // FC01-06, FC15, FC16, other
+#define MB_PROFILE_WINDOW_S     10      // Rolling utilisation window (whole seconds)
+#define MB_PROFILE_BITS_PER_CHAR 11     // RTU character: start + 8 data + parity/stop + stop
+
+/* Histogram kinds (index into mb_profile_stats_t.hist) */
+typedef enum {
+  MB_PROFILE_LATENCY = 0,     // us, queued → completed (async requests)
+  MB_PROFILE_TURNAROUND,      // us, request sent → first response byte
+  MB_PROFILE_WIRE_BYTES,      // request + response bytes
+  MB_PROFILE_HIST_COUNT
+} mb_profile_hist_kind_t;
+
+typedef struct {
+  uint32_t bucket[MB_PROFILE_BUCKETS];  // Non-cumulative counts (last = +Inf)
+  uint32_t count;
+  uint64_t sum;
+  uint32_t max;
+} mb_profile_hist_t;
+
+typedef struct {
+  mb_profile_hist_t hist[MB_PROFILE_HIST_COUNT];
+  uint32_t transactions;      // Frames sent
+  uint32_t errors;            // Timeout / CRC / exception
+} mb_profile_stats_t;
+
+typedef struct {
+  uint8_t slave_id;           // 0 = unused (the "other" entry keeps 0)
+  uint8_t bus;
+  mb_profile_stats_t stats;
+} mb_profile_slave_t;
+
+/* Rolling per-bus window: one slot per second, +1 for the current second */
+typedef struct {
+  uint32_t sec[MB_PROFILE_WINDOW_S + 1];      // millis() / 1000 the slot belongs to
+  uint32_t wire_us[MB_PROFILE_WINDOW_S + 1];  // Frame time on the wire
+  uint32_t held_us[MB_PROFILE_WINDOW_S + 1];  // Transaction time (bus not free)
+  uint64_t wire_us_total;
+  uint64_t held_us_total;
+  uint64_t bytes_total;
+  uint32_t transactions;
+} mb_profile_bus_t;
+
+/**
+ * @brief Record one bus transaction (modbus_master_send_request)
+ * @param turnaround_us Request sent → first response byte (ignored if rx_bytes == 0)
+ * @param held_us Whole transaction incl. timeout
+ * @param ok false on timeout/CRC/exception
+ */
+void mb_profile_record_transaction(uint8_t bus, uint8_t slave_id, uint8_t fc, uint32_t baudrate,
+                                   uint16_t tx_bytes, uint16_t rx_bytes,
+                                   uint32_t turnaround_us, uint32_t held_us, bool ok);
+
+/**
+ * @brief Record the queue-to-completion latency of one async request
+ */
+void mb_profile_record_latency(uint8_t slave_id, uint8_t fc, uint32_t latency_us);
+
+/**
+ * @brief Wire time of n characters at baudrate (MB_PROFILE_BITS_PER_CHAR per character)
+ */
+uint32_t mb_profile_wire_us(uint16_t chars, uint32_t baudrate);
+
+/**
+ * @brief Utilisation / occupancy in percent over the last MB_PROFILE_WINDOW_S whole seconds
+ */
+float mb_profile_bus_utilisation(uint8_t bus);
+float mb_profile_bus_occupancy(uint8_t bus);
+
+const mb_profile_bus_t *mb_profile_get_bus(uint8_t bus);
+
+/**
+ * @brief Per-FC stats (index 0..MB_PROFILE_FCS-1, see mb_profile_fc_of_index)
+ */
+const mb_profile_stats_t *mb_profile_get_fc(uint8_t index);
+uint8_t mb_profile_fc_of_index(uint8_t index);  // 0 = other
+
+/**
+ * @brief Per-slave stats (index 0..MB_PROFILE_SLAVES; last = other)
+ */
+const mb_profile_slave_t *mb_profile_get_slave(uint8_t index);
+
+/**
+ * @brief Upper bounds of a histogram kind (MB_PROFILE_BUCKETS - 1 entries)
+ */
+const uint32_t *mb_profile_bounds(uint8_t kind);
+
+void mb_profile_reset();
+
+#endif // MB_PROFILE_H
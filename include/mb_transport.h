@@ -0,0 +1,36 @@
+/**
+ * @file mb_transport.h
+ * @brief Byte transport under the Modbus master (v7.9.8.18)
+ *
+ * modbus_master_transact() only talks to a bus through these calls. The
+ * default transport is the bus UART (HardwareSerial or the shared uart1_*
+ * driver on ES32D26, incl. DE/RE control); the host benchmarks plug in a
+ * pseudo terminal with a slave farm (tests/host/mb_pty_bus.h). A transport signals received data the same way the
+ * UART driver does: by calling the on_rx_event callback handed to attach()
+ * when a frame has arrived (RX line idle).
+ */
+
+#ifndef MB_TRANSPORT_H
+#define MB_TRANSPORT_H
+
+#include <stdint.h>
+
+typedef struct {
+  const char *name;
+
+  // Bus is switched to this transport (optional). on_rx_event wakes the waiting transaction.
+  void (*attach)(void *ctx, uint8_t bus, void (*on_rx_event)(void));
+  // Drop anything received so far
+  void (*flush_rx)(void *ctx);
+  // Transceiver to TX + queue the request frame
+  void (*write)(void *ctx, const uint8_t *data, uint8_t len);
+  // Block until the last stop bit of the request has left the wire
+  void (*flush_tx)(void *ctx);
+  // Transceiver back to RX (optional)
+  void (*rx_mode)(void *ctx, uint32_t baudrate);
+  // Received bytes ready to read / next byte (-1 if none)
+  int (*available)(void *ctx);
+  int (*read)(void *ctx);
+} mb_transport_t;
+
+#endif // MB_TRANSPORT_H
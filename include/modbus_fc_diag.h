@@ -0,0 +1,63 @@
+/**
+ * @file modbus_fc_diag.h
+ * @brief Modbus diagnostics and device identification handlers (LAYER 2)
+ *
+ * LAYER 2: Function Code Handlers - Diagnostics (v7.9.8.24)
+ * Responsibility: Implement FC08 (diagnostics) and FC2B/0E (read device identification)
+ *
+ * This file handles:
+ * - FC08: Diagnostics (0x08) - sub-functions 0x00, 0x0A, 0x0B-0x0F
+ * - FC2B: Encapsulated Interface Transport (0x2B = FC43), MEI 0x0E only
+ * - Diagnostic counters fed by the RTU slave (modbus_server.cpp); Modbus TCP
+ *   rejects the counter sub-functions (modbus_tcp_server.cpp)
+ *
+ * Does NOT handle:
+ * - Register read/write operations (→ modbus_fc_read.h, modbus_fc_write.h)
+ * - Frame parsing (→ modbus_parser.h)
+ * - Response serialization (→ modbus_serializer.h)
+ */
+
+#ifndef modbus_fc_diag_H
+#define modbus_fc_diag_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "modbus_frame.h"
+#include "types.h"
+
+/* ============================================================================
+ * DIAGNOSTIC COUNTERS (FC08 0x0B-0x0F)
+ * ============================================================================ */
+
+/**
+ * @brief Get diagnostic counters (mutable - RTU slave increments them directly)
+ * @return Pointer to counters (never NULL)
+ */
+ModbusDiagCounters* modbus_diag_counters(void);
+
+/**
+ * @brief Clear all diagnostic counters (FC08 0x0A)
+ */
+void modbus_diag_clear(void);
+
+/* ============================================================================
+ * DIAGNOSTIC FUNCTION CODE HANDLERS
+ * ============================================================================ */
+
+/**
+ * @brief Handle FC08: Diagnostics
+ * @param request_frame Input request frame
+ * @param response_frame Output response frame
+ * @return true if handled successfully, false otherwise
+ */
+bool modbus_fc08_diagnostics(const ModbusFrame* request_frame, ModbusFrame* response_frame);
+
+/**
+ * @brief Handle FC2B (FC43) MEI 0x0E: Read Device Identification
+ * @param request_frame Input request frame
+ * @param response_frame Output response frame
+ * @return true if handled successfully, false otherwise
+ */
+bool modbus_fc2b_read_device_identification(const ModbusFrame* request_frame, ModbusFrame* response_frame);
+
+#endif // modbus_fc_diag_H
@@ -7,11 +7,12 @@
  *
  * This file handles:
  * - Dispatching FC01-04 to read handlers
- * - Dispatching FC05-06, 0F-10 to write handlers
+ * - Dispatching FC05-06, 0F-10, 16-17 to write handlers
+ * - Dispatching FC08, 2B to diagnostics handlers
  * - Returning error for unsupported function codes
  *
  * Does NOT handle:
- * - Implementing function codes (→ modbus_fc_read.h, modbus_fc_write.h)
+ * - Implementing function codes (→ modbus_fc_read.h, modbus_fc_write.h, modbus_fc_diag.h)
  * - Frame parsing (→ modbus_parser.h)
  * - Response serialization (→ modbus_serializer.h)
  */
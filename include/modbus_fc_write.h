@@ -4,12 +4,15 @@
  *
  * LAYER 2: Function Code Handlers - Write Operations
  * Responsibility: Implement FC05-06, FC0F-10 (write single/multiple coils/registers)
+ *                 and FC16-17 (read-modify-write of holding registers)
  *
  * This file handles:
  * - FC05: Write Single Coil (0x05)
  * - FC06: Write Single Register (0x06)
  * - FC0F: Write Multiple Coils (0x0F)
  * - FC10: Write Multiple Registers (0x10)
+ * - FC16: Mask Write Register (0x16 = FC22, v7.9.8.24)
+ * - FC17: Read/Write Multiple Registers (0x17 = FC23, v7.9.8.24)
  *
  * Does NOT handle:
  * - Read operations (→ modbus_fc_read.h)
@@ -60,4 +63,24 @@ bool modbus_fc0f_write_multiple_coils(const ModbusFrame* request_frame, ModbusFr
  */
 bool modbus_fc10_write_multiple_registers(const ModbusFrame* request_frame, ModbusFrame* response_frame);
 
+/* ============================================================================
+ * READ-MODIFY-WRITE FUNCTION CODE HANDLERS (FC16-17, v7.9.8.24)
+ * ============================================================================ */
+
+/**
+ * @brief Handle FC16 (FC22): Mask Write Register, atomic against the register store
+ * @param request_frame Input request frame
+ * @param response_frame Output response frame
+ * @return true if handled successfully, false otherwise
+ */
+bool modbus_fc16_mask_write_register(const ModbusFrame* request_frame, ModbusFrame* response_frame);
+
+/**
+ * @brief Handle FC17 (FC23): Read/Write Multiple Registers (write first, then read, one step)
+ * @param request_frame Input request frame
+ * @param response_frame Output response frame
+ * @return true if handled successfully, false otherwise
+ */
+bool modbus_fc17_read_write_multiple_registers(const ModbusFrame* request_frame, ModbusFrame* response_frame);
+
 #endif // modbus_fc_write_H
@@ -21,23 +21,45 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 /* ============================================================================
  * MODBUS FRAME STRUCTURE
  * ============================================================================ */
 
+#define MODBUS_FRAME_DATA_MAX  252   // Max data bytes (256 - ID - FC - CRC)
+
 /**
  * @brief Modbus RTU Frame (max 256 bytes)
  * Structure: [SLAVE_ID] [FC] [DATA...] [CRC_LO] [CRC_HI]
+ *
+ * v7.9.8.1: slave_id, function_code and data[] are laid out as one contiguous
+ * wire buffer (see modbus_frame_raw()). data[] has 2 extra bytes so the CRC of
+ * a max-length frame fits behind the payload. RX writes UART bytes straight
+ * into it, CRC is computed in place and TX sends it without copying.
  */
 typedef struct {
   uint8_t slave_id;
   uint8_t function_code;
-  uint8_t data[252];      // Max 252 bytes of data (256 - ID - FC - CRC)
+  uint8_t data[MODBUS_FRAME_DATA_MAX + 2];  // Payload + on-wire CRC bytes
   uint16_t crc16;
   uint16_t length;        // Total frame length (ID + FC + data + CRC)
 } ModbusFrame;
 
+static_assert(offsetof(ModbusFrame, function_code) == 1 && offsetof(ModbusFrame, data) == 2,
+              "ModbusFrame wire bytes must be contiguous");
+
+/**
+ * @brief Raw wire bytes of frame: [ID][FC][data...][CRC_LO][CRC_HI]
+ */
+static inline uint8_t* modbus_frame_raw(ModbusFrame* frame) {
+  return &frame->slave_id;
+}
+
+static inline const uint8_t* modbus_frame_raw_const(const ModbusFrame* frame) {
+  return &frame->slave_id;
+}
+
 /* ============================================================================
  * CRC16-MODBUS (CRC16-CCITT-FALSE)
  * ============================================================================ */
@@ -51,7 +73,7 @@ typedef struct {
 uint16_t modbus_crc16(const uint8_t* data, uint16_t length);
 
 /**
- * @brief Verify CRC16 in frame
+ * @brief Verify CRC16 in frame (computed in place over the wire bytes)
  * @param frame Frame with CRC to verify
  * @return true if CRC is valid, false otherwise
  */
@@ -59,6 +81,8 @@ bool modbus_frame_verify_crc(const ModbusFrame* frame);
 
 /**
  * @brief Set CRC16 in frame
+ * Updates frame->crc16 and writes CRC_LO/CRC_HI behind the payload so the
+ * raw buffer is ready for modbus_tx_send_frame().
  * @param frame Frame to update with CRC
  */
 void modbus_frame_set_crc(ModbusFrame* frame);
@@ -12,6 +12,7 @@
 #include <Arduino.h>
 #include "types.h"
 #include "constants.h"
+#include "mb_transport.h"
 
 /* ============================================================================
  * GLOBAL CONFIGURATION
@@ -19,6 +20,15 @@
 
 extern modbus_master_config_t g_modbus_master_config;
 
+/* Response wait accounting (v7.9.8.13) — runtime only, not persisted */
+typedef struct {
+  uint32_t transactions;        // modbus_master_send_request() calls that reached the bus
+  uint32_t rx_events;           // UART RX events that woke the waiting task
+  uint64_t wait_us;             // Blocked on TX drain / RX event (CPU free for other tasks)
+  uint64_t busy_us;             // Executing (TX setup, byte drain, GPIO DE turnaround)
+  bool hw_rs485;                // UART drives DE itself (UART_MODE_RS485_HALF_DUPLEX)
+} ModbusMasterWaitStats;
+
 /* ============================================================================
  * INITIALIZATION & CONTROL
  * ============================================================================ */
@@ -59,6 +69,71 @@ void modbus_master_activate_uart();
  */
 void modbus_master_reset_stats();
 
+/**
+ * @brief Response wait accounting (busy vs. blocked time per transaction)
+ * @param bus Bus index (0 = master UART)
+ */
+const ModbusMasterWaitStats* modbus_master_get_wait_stats(uint8_t bus);
+
+/* ============================================================================
+ * EXTRA BUSES (v7.9.8.14)
+ * ============================================================================ */
+
+/**
+ * @brief Start the UART of an extra bus (1..MB_BUS_MAX-1) from g_persist_config.mb_buses
+ *
+ * Requires uart<N>_tx/rx/dir_pin for MODBUS_MASTER_BUS1_UART, and the UART
+ * must not be used by the Modbus slave.
+ * @return true if started
+ */
+bool modbus_master_bus_start(uint8_t bus);
+
+/**
+ * @brief Stop the UART of an extra bus (waits for a running transaction)
+ */
+void modbus_master_bus_stop(uint8_t bus);
+
+/**
+ * @brief Can requests be sent on this bus?
+ */
+bool modbus_master_bus_active(uint8_t bus);
+
+/**
+ * @brief Swap the byte transport of a bus (v7.9.8.18)
+ * @param transport NULL = back to the bus UART
+ * @param ctx Passed to every transport call
+ *
+ * Waits for a running transaction. An extra bus with a non-UART transport
+ * starts without pins (modbus_master_bus_start); call mb_async_bus_apply()
+ * afterwards to (re)start it.
+ */
+bool modbus_master_set_transport(uint8_t bus, const mb_transport_t *transport, void *ctx);
+const char *modbus_master_transport_name(uint8_t bus);
+
+/**
+ * @brief Baudrate of a bus
+ */
+uint32_t modbus_master_bus_baudrate(uint8_t bus);
+
+/**
+ * @brief Effective inter-frame delay of a bus in ms (0 = auto resolved to t3.5)
+ */
+uint16_t modbus_master_bus_inter_frame(uint8_t bus);
+
+/**
+ * @brief Sample Core 0 load from the idle task run-time counter
+ *
+ * Must be called from a task pinned to Core 0 (mb_async task loop).
+ * Rate-limited internally to one sample per second.
+ */
+void modbus_master_sample_core_load(void);
+
+/**
+ * @brief Core 0 load over the last sample window
+ * @return 0-100 percent, or -1 if FreeRTOS run-time stats are not compiled in
+ */
+int modbus_master_get_core_load(void);
+
 /* ============================================================================
  * MODBUS PROTOCOL FUNCTIONS (FC01-FC06)
  * ============================================================================ */
@@ -132,7 +207,7 @@ mb_error_code_t modbus_master_write_holding(uint8_t slave_id, uint16_t address,
  *
  * @param slave_id Slave address (1-247)
  * @param address Start register address (0-65535)
- * @param count Number of registers to read (1-16)
+ * @param count Number of registers to read (1-MODBUS_MASTER_MAX_READ_REGS)
  * @param results Array to store results (must hold count uint16_t's)
  * @return mb_error_code_t Error code (MB_OK on success)
  */
@@ -143,12 +218,51 @@ mb_error_code_t modbus_master_read_holdings(uint8_t slave_id, uint16_t address,
  *
  * @param slave_id Slave address (1-247)
  * @param address Start register address (0-65535)
- * @param count Number of registers to write (1-16)
+ * @param count Number of registers to write (1-MODBUS_MASTER_MAX_WRITE_REGS)
  * @param values Array of values to write (count uint16_t's)
  * @return mb_error_code_t Error code (MB_OK on success)
  */
 mb_error_code_t modbus_master_write_holdings(uint8_t slave_id, uint16_t address, uint8_t count, const uint16_t *values);
 
+/**
+ * @brief Write Multiple Coils (FC15, v7.9.8.19 — used by mb_async write combining)
+ *
+ * @param slave_id Slave address (1-247)
+ * @param address Start coil address (0-65535)
+ * @param count Number of coils to write (1-MODBUS_MASTER_MAX_WRITE_BITS)
+ * @param bits Packed coil states, LSB first as on the wire ((count+7)/8 bytes)
+ * @return mb_error_code_t Error code (MB_OK on success)
+ */
+mb_error_code_t modbus_master_write_coils(uint8_t slave_id, uint16_t address, uint16_t count, const uint8_t *bits);
+
+/* ============================================================================
+ * BLOCK READ FUNCTIONS (v7.9.8.11 — read coalescing)
+ * ============================================================================ */
+
+/**
+ * @brief Read a block of holding or input registers (FC03/FC04)
+ *
+ * @param slave_id Slave address (1-247)
+ * @param fc 0x03 or 0x04
+ * @param address Start register address
+ * @param count Number of registers (1-MODBUS_MASTER_MAX_READ_REGS)
+ * @param results Array to store results (must hold count uint16_t's)
+ * @return mb_error_code_t Error code (MB_OK on success)
+ */
+mb_error_code_t modbus_master_read_registers(uint8_t slave_id, uint8_t fc, uint16_t address, uint16_t count, uint16_t *results);
+
+/**
+ * @brief Read a block of coils or discrete inputs (FC01/FC02)
+ *
+ * @param slave_id Slave address (1-247)
+ * @param fc 0x01 or 0x02
+ * @param address Start coil/input address
+ * @param count Number of bits (1-MODBUS_MASTER_MAX_READ_BITS)
+ * @param bits Packed result, LSB first as on the wire (must hold (count+7)/8 bytes)
+ * @return mb_error_code_t Error code (MB_OK on success)
+ */
+mb_error_code_t modbus_master_read_bits(uint8_t slave_id, uint8_t fc, uint16_t address, uint16_t count, uint8_t *bits);
+
 /* ============================================================================
  * INTERNAL FUNCTIONS
  * ============================================================================ */
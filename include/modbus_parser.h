@@ -9,6 +9,8 @@
  * - Parsing FC01-04 (read requests)
  * - Parsing FC05-06 (write single)
  * - Parsing FC0F-10 (write multiple)
+ * - Parsing FC16-17 (mask write, read/write multiple)
+ * - Parsing FC08 (diagnostics) and FC2B/0E (device identification)
  * - Extracting addresses, quantities, values
  * - Input validation
  *
@@ -77,4 +79,44 @@ bool modbus_parse_write_multiple_coils(const ModbusFrame* frame, ModbusWriteMult
  */
 bool modbus_parse_write_multiple_registers(const ModbusFrame* frame, ModbusWriteMultipleRegistersRequest* req);
 
+/* ============================================================================
+ * READ-MODIFY-WRITE PARSING (FC16-17, v7.9.8.24)
+ * ============================================================================ */
+
+/**
+ * @brief Parse mask write register request (FC16 / FC22)
+ * @param frame Input Modbus frame
+ * @param req Output request structure
+ * @return true if parsed successfully, false otherwise
+ */
+bool modbus_parse_mask_write_register(const ModbusFrame* frame, ModbusMaskWriteRegisterRequest* req);
+
+/**
+ * @brief Parse read/write multiple registers request (FC17 / FC23)
+ * @param frame Input Modbus frame
+ * @param req Output request structure
+ * @return true if parsed successfully, false otherwise
+ */
+bool modbus_parse_read_write_multiple(const ModbusFrame* frame, ModbusReadWriteMultipleRequest* req);
+
+/* ============================================================================
+ * DIAGNOSTICS / IDENTIFICATION PARSING (FC08, FC2B, v7.9.8.24)
+ * ============================================================================ */
+
+/**
+ * @brief Parse diagnostics request (FC08)
+ * @param frame Input Modbus frame
+ * @param req Output request structure
+ * @return true if parsed successfully, false otherwise
+ */
+bool modbus_parse_diagnostics(const ModbusFrame* frame, ModbusDiagnosticsRequest* req);
+
+/**
+ * @brief Parse read device identification request (FC2B / FC43, MEI type 0x0E)
+ * @param frame Input Modbus frame
+ * @param req Output request structure
+ * @return true if parsed successfully, false otherwise (incl. other MEI types)
+ */
+bool modbus_parse_device_id(const ModbusFrame* frame, ModbusDeviceIdRequest* req);
+
 #endif // modbus_parser_H
@@ -3,14 +3,15 @@
  * @brief Modbus RX handler - Serial reception with timeout (LAYER 3)
  *
  * LAYER 3: Modbus Server Runtime - RX Handling
- * Responsibility: Receive Modbus frames via UART with timeout detection
+ * Responsibility: Read a completed Modbus frame from UART
  *
  * This file handles:
- * - Non-blocking serial RX
- * - Inter-character timeout detection (3.5 char time)
+ * - Draining the frame after the UART RX-idle (t3.5) event
  * - Frame assembly
  * - CRC validation
  *
+ * Frame-end detection lives in the UART driver (uart1_set_rx_frame_callback)
+ *
  * Does NOT handle:
  * - TX operations (→ modbus_tx.h)
  * - Frame processing (→ modbus_fc_dispatch.h)
@@ -31,7 +32,8 @@ typedef enum {
   MODBUS_RX_IDLE,       // Waiting for first byte
   MODBUS_RX_RECEIVING,  // Receiving frame bytes
   MODBUS_RX_COMPLETE,   // Frame complete (timeout detected)
-  MODBUS_RX_ERROR       // Frame error (CRC mismatch, etc.)
+  MODBUS_RX_ERROR,      // Frame error (too short/long)
+  MODBUS_RX_CRC_ERROR   // CRC mismatch
 } modbus_rx_state_t;
 
 /* ============================================================================
@@ -44,11 +46,12 @@ typedef enum {
 void modbus_rx_init(void);
 
 /**
- * @brief Process Modbus RX (call in main loop)
- * @param frame Output frame (populated if complete)
- * @return Current RX state
+ * @brief Read and validate one frame (call on UART RX-idle event)
+ * @param frame Output frame - bytes are received directly into it
+ * @return MODBUS_RX_COMPLETE, MODBUS_RX_ERROR, MODBUS_RX_CRC_ERROR,
+ *         or MODBUS_RX_IDLE if no bytes were pending
  */
-modbus_rx_state_t modbus_rx_process(ModbusFrame* frame);
+modbus_rx_state_t modbus_rx_read_frame(ModbusFrame* frame);
 
 /**
  * @brief Reset RX state to idle
@@ -9,6 +9,7 @@
  * - Building FC01-04 responses (read data)
  * - Building FC05-06 responses (write acknowledgment)
  * - Building FC0F-10 responses (write multiple acknowledgment)
+ * - Building FC16 (mask write), FC08 (diagnostics), FC2B/0E (device ID) responses
  * - Building error responses (exceptions)
  * - Setting CRC16 in response frame
  *
@@ -30,6 +31,7 @@
 #define MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS   0x02
 #define MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE     0x03
 #define MODBUS_EXCEPTION_SLAVE_DEVICE_FAILURE   0x04
+#define MODBUS_EXCEPTION_GATEWAY_TARGET_FAILED  0x0B  // Modbus TCP: unit ID not served
 
 /* ============================================================================
  * READ RESPONSE SERIALIZATION (FC01-04)
@@ -59,6 +61,19 @@ bool modbus_serialize_read_bits_response(ModbusFrame* frame, uint8_t slave_id, u
 bool modbus_serialize_read_registers_response(ModbusFrame* frame, uint8_t slave_id, uint8_t function_code,
                                                 const uint16_t* data, uint16_t register_count);
 
+/**
+ * @brief Finish read registers response whose values are already packed in place
+ * The FC handler writes big-endian register values directly to frame->data[1..]
+ * (zero-copy, v7.9.8.1); this fills in header, length and CRC.
+ * @param frame Output Modbus frame (register values already at data[1..])
+ * @param slave_id Slave ID
+ * @param function_code Function code (0x03 or 0x04)
+ * @param register_count Number of registers packed
+ * @return true if serialized successfully, false otherwise
+ */
+bool modbus_serialize_read_registers_in_place(ModbusFrame* frame, uint8_t slave_id, uint8_t function_code,
+                                               uint16_t register_count);
+
 /* ============================================================================
  * WRITE RESPONSE SERIALIZATION (FC05-06)
  * ============================================================================ */
@@ -111,6 +126,54 @@ bool modbus_serialize_write_multiple_coils_response(ModbusFrame* frame, uint8_t
 bool modbus_serialize_write_multiple_registers_response(ModbusFrame* frame, uint8_t slave_id,
                                                           uint16_t starting_address, uint16_t quantity_of_registers);
 
+/* ============================================================================
+ * READ-MODIFY-WRITE / DIAGNOSTICS RESPONSE SERIALIZATION (v7.9.8.24)
+ *
+ * FC17 (Read/Write Multiple) answers like FC03: the handler packs the read
+ * values in place and calls modbus_serialize_read_registers_in_place().
+ * ============================================================================ */
+
+/**
+ * @brief Serialize mask write register response (FC16 / FC22, echo of the request)
+ * @param frame Output Modbus frame
+ * @param slave_id Slave ID
+ * @param reference_address Register address
+ * @param and_mask AND mask
+ * @param or_mask OR mask
+ * @return true if serialized successfully, false otherwise
+ */
+bool modbus_serialize_mask_write_register_response(ModbusFrame* frame, uint8_t slave_id,
+                                                     uint16_t reference_address, uint16_t and_mask, uint16_t or_mask);
+
+/**
+ * @brief Serialize diagnostics response (FC08)
+ * @param frame Output Modbus frame
+ * @param slave_id Slave ID
+ * @param sub_function Sub-function code
+ * @param data Response data (big-endian bytes)
+ * @param data_length Number of data bytes
+ * @return true if serialized successfully, false otherwise
+ */
+bool modbus_serialize_diagnostics_response(ModbusFrame* frame, uint8_t slave_id, uint16_t sub_function,
+                                            const uint8_t* data, uint8_t data_length);
+
+/**
+ * @brief Serialize read device identification response (FC2B / FC43, MEI 0x0E)
+ * Packs objects[first..count-1] while they fit in one frame; the rest is
+ * announced with More Follows = 0xFF and Next Object Id.
+ * @param frame Output Modbus frame
+ * @param slave_id Slave ID
+ * @param read_device_id_code Echoed read device ID code
+ * @param conformity_level Conformity level of the device
+ * @param objects Object list (ascending id)
+ * @param count Number of objects in list
+ * @param first Index of the first object to send
+ * @return true if serialized successfully, false otherwise
+ */
+bool modbus_serialize_device_id_response(ModbusFrame* frame, uint8_t slave_id, uint8_t read_device_id_code,
+                                          uint8_t conformity_level, const ModbusDeviceIdObject* objects,
+                                          uint8_t count, uint8_t first);
+
 /* ============================================================================
  * ERROR RESPONSE SERIALIZATION
  * ============================================================================ */
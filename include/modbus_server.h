@@ -6,9 +6,11 @@
  * Responsibility: Orchestrate RX → Process → TX cycle
  *
  * This file handles:
+ * - Dedicated FreeRTOS task (v7.9.8.2), woken by UART RX-idle (t3.5) events
+ *   so response latency is independent of loop() load
  * - Main Modbus state machine (Idle → RX → Process → TX → Idle)
  * - Slave ID filtering
- * - Timeout handling
+ * - Request-to-response latency histogram
  * - Integration of RX, TX, and FC dispatch
  *
  * Does NOT handle:
@@ -23,6 +25,19 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+/* ============================================================================
+ * CONFIGURATION
+ * ============================================================================ */
+
+#define MODBUS_SERVER_TASK_STACK    4096
+#define MODBUS_SERVER_TASK_PRIO     5      // Above loopTask (1) and mb_async (3)
+#define MODBUS_SERVER_TASK_CORE     1      // Same core as registers/engines (loop)
+#define MODBUS_SERVER_IDLE_WAKE_MS  1000   // Safety wake if an RX event is missed
+
+/* Latency histogram upper bounds (us), last bucket = +Inf */
+#define MODBUS_SERVER_LATENCY_BUCKETS   10
+#define MODBUS_SERVER_LATENCY_BOUNDS_US { 100, 250, 500, 1000, 2000, 5000, 10000, 20000, 50000 }
+
 /* ============================================================================
  * MODBUS SERVER STATE
  * ============================================================================ */
@@ -35,20 +50,42 @@ typedef enum {
   MODBUS_STATE_ERROR      // Error occurred
 } modbus_server_state_t;
 
+/**
+ * @brief Request-to-response latency, measured from UART frame-end event
+ * to first response byte handed to TX
+ */
+typedef struct {
+  uint32_t bucket[MODBUS_SERVER_LATENCY_BUCKETS];  // Non-cumulative counts
+  uint32_t count;
+  uint64_t sum_us;
+  uint32_t max_us;
+} ModbusServerLatencyStats;
+
 /* ============================================================================
  * MODBUS SERVER FUNCTIONS
  * ============================================================================ */
 
 /**
- * @brief Initialize Modbus server
+ * @brief Initialize Modbus server and start slave task
  * @param slave_id Modbus slave ID (1-247)
  */
 void modbus_server_init(uint8_t slave_id);
 
 /**
- * @brief Process Modbus server (call in main loop)
+ * @brief Recompute the frame-end silence (t3.5) from the slave baudrate and
+ * inter-frame delay and re-arm the UART RX timeout. Call after changing either.
+ */
+void modbus_server_apply_line_config(void);
+
+/**
+ * @brief Get latency histogram
+ */
+const ModbusServerLatencyStats* modbus_server_get_latency_stats(void);
+
+/**
+ * @brief Reset latency histogram
  */
-void modbus_server_loop(void);
+void modbus_server_reset_latency_stats(void);
 
 /**
  * @brief Get current server state
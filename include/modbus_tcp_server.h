@@ -0,0 +1,112 @@
+/**
+ * @file modbus_tcp_server.h
+ * @brief Modbus TCP slave server (MBAP) sharing the RTU FC dispatcher (FEAT-145, v7.9.8.0)
+ *
+ * LAYER 3: Modbus Server Runtime - TCP transport
+ * Responsibility: MBAP framing over TCP, feeding PDUs into modbus_dispatch_function_code()
+ *
+ * This file handles:
+ * - Listening on port 502 (configurable via PersistConfig.modbus_tcp)
+ * - Multiple concurrent clients (select() based, one FreeRTOS task)
+ * - Pipelined requests: every complete ADU in the RX buffer is processed in
+ *   order and the responses are sent back in one batch with echoed transaction IDs
+ * - Unit ID filtering (0, 0xFF or configured slave ID)
+ *
+ * Does NOT handle:
+ * - Function code implementation (→ modbus_fc_*.h, same handlers as RTU)
+ * - RTU framing / CRC (→ modbus_rx.h, modbus_tx.h)
+ */
+
+#ifndef MODBUS_TCP_SERVER_H
+#define MODBUS_TCP_SERVER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "types.h"
+
+/* ============================================================================
+ * CONFIGURATION
+ * ============================================================================ */
+
+#define MODBUS_TCP_DEFAULT_PORT       502     // IANA Modbus TCP port
+#define MODBUS_TCP_MAX_CLIENTS        4       // Compile-time max simultaneous clients
+#define MODBUS_TCP_DEFAULT_CLIENTS    4       // Default runtime client limit
+#define MODBUS_TCP_IDLE_TIMEOUT_S     60      // Default idle timeout (0 = never)
+#define MODBUS_TCP_MBAP_HEADER_LEN    7       // TID(2) + PID(2) + LEN(2) + UID(1)
+#define MODBUS_TCP_ADU_MAX            260     // MBAP header + max PDU (253)
+#define MODBUS_TCP_RX_BUF_SIZE        (MODBUS_TCP_ADU_MAX * 2)  // Room for pipelined ADUs
+#define MODBUS_TCP_TX_BUF_SIZE        (MODBUS_TCP_ADU_MAX * 4)  // Batched responses per poll
+#define MODBUS_TCP_TASK_STACK         4096
+#define MODBUS_TCP_TASK_PRIO          4       // Same level as SSE acceptor
+#define MODBUS_TCP_TASK_CORE          0       // Network core (main loop = Core 1)
+#define MODBUS_TCP_SELECT_TIMEOUT_MS  100
+
+/* ============================================================================
+ * STATISTICS
+ * ============================================================================ */
+
+typedef struct {
+  uint32_t connections_total;     // Accepted connections since boot
+  uint32_t connections_rejected;  // Rejected (client limit reached)
+  uint32_t requests;              // ADUs received and dispatched
+  uint32_t exceptions;            // Exception responses sent
+  uint32_t protocol_errors;       // Bad MBAP header (client dropped)
+  uint32_t unit_mismatch;         // Requests for a foreign unit ID
+  uint32_t bytes_rx;
+  uint32_t bytes_tx;
+  uint8_t  active_clients;
+  uint8_t  max_pipeline_depth;    // Most ADUs handled from a single recv()
+} ModbusTcpStats;
+
+typedef struct {
+  bool     active;
+  uint32_t ip_addr;               // IPv4 in network byte order
+  uint16_t port;
+  uint32_t connected_ms;
+  uint32_t requests;
+} ModbusTcpClientInfo;
+
+/* ============================================================================
+ * PUBLIC API
+ * ============================================================================ */
+
+/**
+ * @brief Start Modbus TCP server task
+ * @param config Modbus TCP configuration (port 0 = MODBUS_TCP_DEFAULT_PORT)
+ * @return 0 on success, -1 on error
+ */
+int modbus_tcp_server_start(const ModbusTcpConfig *config);
+
+/**
+ * @brief Stop server, disconnect all clients
+ */
+void modbus_tcp_server_stop(void);
+
+/**
+ * @brief Check if server is listening
+ */
+bool modbus_tcp_server_is_running(void);
+
+/**
+ * @brief Get listening port (0 if not running)
+ */
+uint16_t modbus_tcp_server_get_port(void);
+
+/**
+ * @brief Get server statistics
+ */
+const ModbusTcpStats *modbus_tcp_server_get_stats(void);
+
+/**
+ * @brief Reset statistics counters (active_clients is kept)
+ */
+void modbus_tcp_server_reset_stats(void);
+
+/**
+ * @brief Snapshot client table
+ * @param out Array of MODBUS_TCP_MAX_CLIENTS entries
+ * @return number of active clients
+ */
+int modbus_tcp_server_get_clients(ModbusTcpClientInfo *out);
+
+#endif // MODBUS_TCP_SERVER_H
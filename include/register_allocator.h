@@ -29,6 +29,11 @@
 // BUG-028 FIX (v4.2.3): Expanded from 160 to 180 for 64-bit counter support (HR100-170)
 #define ALLOCATOR_SIZE 180
 
+// Addresses >= ALLOCATOR_SIZE (up to 0xFFFF) are tracked as owner ranges
+// instead of per-register entries; allocating above the flat HR array maps
+// the sparse register page on demand (v7.9.8.22)
+#define ALLOCATOR_RANGE_MAX 32
+
 /* ============================================================================
  * TYPES
  * ============================================================================ */
@@ -57,6 +62,15 @@ typedef struct {
   // Removed timestamp (not used in production)
 } RegisterOwner;
 
+/**
+ * @brief Contiguous allocation above ALLOCATOR_SIZE (one owner per range)
+ */
+typedef struct {
+  uint16_t start;         // First register address
+  uint16_t count;         // Number of registers (0 = unused slot)
+  RegisterOwner owner;
+} RegisterRange;
+
 /* ============================================================================
  * PUBLIC API
  * ============================================================================ */
@@ -84,7 +98,7 @@ bool register_allocator_check(uint16_t reg_addr, RegisterOwner* owner);
 
 /**
  * @brief Allocate register to subsystem
- * @param reg_addr Register address to allocate
+ * @param reg_addr Register address to allocate (0-65535, sparse page mapped on demand)
  * @param type Subsystem owner type
  * @param subsystem_id Counter/Timer/Logic ID (1-4) or 0 for global
  * @param description Human-readable description
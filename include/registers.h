@@ -6,8 +6,8 @@
  * Responsibility: Arrays of registers and coils, access functions
  *
  * This file provides:
- * - Holding registers (0-159): Read/write via Modbus FC03/FC06/FC10
- * - Input registers (0-159): Read-only via Modbus FC04
+ * - Holding registers (0-255 + mapped pages): Read/write via Modbus FC03/FC06/FC10
+ * - Input registers (0-511 + mapped pages): Read-only via Modbus FC04
  * - Coils (0-255): Read/write via Modbus FC01/FC05/FC0F
  * - Discrete inputs (0-255): Read-only via Modbus FC02
  */
@@ -16,6 +16,7 @@
 #define REGISTERS_H
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "constants.h"
 
 /* ============================================================================
@@ -24,14 +25,14 @@
 
 /**
  * @brief Get holding register value
- * @param addr Register address (0-159)
+ * @param addr Register address (flat array or mapped page)
  * @return Register value (16-bit)
  */
 uint16_t registers_get_holding_register(uint16_t addr);
 
 /**
  * @brief Set holding register value
- * @param addr Register address (0-159)
+ * @param addr Register address (flat array or mapped page)
  * @param value Value to set (16-bit)
  */
 void registers_set_holding_register(uint16_t addr, uint16_t value);
@@ -48,14 +49,14 @@ uint16_t* registers_get_holding_regs(void);
 
 /**
  * @brief Get input register value
- * @param addr Register address (0-159)
+ * @param addr Register address (flat array or mapped page)
  * @return Register value (16-bit)
  */
 uint16_t registers_get_input_register(uint16_t addr);
 
 /**
  * @brief Set input register value (from drivers)
- * @param addr Register address (0-159)
+ * @param addr Register address (flat array or mapped page)
  * @param value Value to set (16-bit)
  */
 void registers_set_input_register(uint16_t addr, uint16_t value);
@@ -114,6 +115,249 @@ void registers_set_discrete_input(uint16_t idx, uint8_t value);
  */
 uint8_t* registers_get_discrete_inputs(void);
 
+/* ============================================================================
+ * MULTI-WORD WRITES + CONSISTENT SNAPSHOTS (v7.9.8.20)
+ *
+ * Holding and input registers are split into regions of REG_SEQ_REGION_SIZE
+ * registers, each with a sequence counter (seqlock). Block writers make the
+ * counters of the regions they touch odd while storing and even afterwards.
+ * Snapshot readers copy without locking and retry if a counter was odd or
+ * moved, so a 32/64-bit value is never returned half old, half new.
+ * Single-word setters are atomic on their own and do not touch the counters.
+ * ============================================================================ */
+
+/**
+ * @brief Write consecutive holding registers as one torn-free update
+ * Write side effects (ST Logic control etc.) run per word after the store.
+ * Words beyond HOLDING_REGS_SIZE are dropped.
+ * @param addr First register address
+ * @param values Words to store (LSW first for 32/64-bit values)
+ * @param count Number of words
+ */
+void registers_set_holding_registers(uint16_t addr, const uint16_t *values, uint16_t count);
+
+/**
+ * @brief Write consecutive input registers as one torn-free update
+ * @param addr First register address
+ * @param values Words to store
+ * @param count Number of words (words beyond INPUT_REGS_SIZE are dropped)
+ */
+void registers_set_input_registers(uint16_t addr, const uint16_t *values, uint16_t count);
+
+/**
+ * @brief Copy holding registers without tearing any block write
+ * Addresses beyond HOLDING_REGS_SIZE read as 0.
+ * @param addr First register address
+ * @param count Number of registers
+ * @param dst Destination (count words)
+ */
+void registers_snapshot_holding(uint16_t addr, uint16_t count, uint16_t *dst);
+
+/**
+ * @brief Copy input registers without tearing any block write
+ * @param addr First register address
+ * @param count Number of registers
+ * @param dst Destination (count words)
+ */
+void registers_snapshot_input(uint16_t addr, uint16_t count, uint16_t *dst);
+
+/**
+ * @brief Snapshot holding registers big-endian, straight into a Modbus PDU
+ * @param addr First register address
+ * @param count Number of registers
+ * @param dst Destination (count * 2 bytes)
+ */
+void registers_snapshot_holding_be(uint16_t addr, uint16_t count, uint8_t *dst);
+
+/**
+ * @brief Snapshot input registers big-endian, straight into a Modbus PDU
+ * @param addr First register address
+ * @param count Number of registers
+ * @param dst Destination (count * 2 bytes)
+ */
+void registers_snapshot_input_be(uint16_t addr, uint16_t count, uint8_t *dst);
+
+/**
+ * @brief Snapshot statistics since boot
+ * @param retries Lock-free attempts repeated because a writer was active
+ * @param locked Snapshots that gave up after REG_SNAPSHOT_MAX_RETRIES and copied under the writer lock
+ */
+void registers_snapshot_stats(uint32_t *retries, uint32_t *locked);
+
+/**
+ * @brief Write holding registers, then read a range back as one step (Modbus FC23, v7.9.8.24)
+ * Store and copy happen under the block writer lock, so no other block write,
+ * FC22 or FC23 lands in between; write hooks run after the lock is released.
+ * @param wr_addr First register to write
+ * @param values Values to write (native order)
+ * @param wr_count Number of registers to write
+ * @param rd_addr First register to read
+ * @param rd_count Number of registers to read
+ * @param dst_be Read values in Modbus byte order (rd_count * 2 bytes)
+ */
+void registers_exchange_holding_be(uint16_t wr_addr, const uint16_t *values, uint16_t wr_count,
+                                   uint16_t rd_addr, uint16_t rd_count, uint8_t *dst_be);
+
+/**
+ * @brief Atomic read-modify-write of one holding register (Modbus FC22, v7.9.8.24)
+ * New value = (current AND and_mask) OR (or_mask AND NOT and_mask)
+ * @return The new value (0 if addr is an unmapped sparse address)
+ */
+uint16_t registers_mask_holding_register(uint16_t addr, uint16_t and_mask, uint16_t or_mask);
+
+/* ============================================================================
+ * REGISTER CHANGE JOURNAL (v7.9.8.21)
+ *
+ * Every setter that actually changes a holding/input register, coil or
+ * discrete input appends (bank, address, value) to a REG_JOURNAL_SIZE ring.
+ * The ring is numbered by a running sequence. Each block of
+ * REG_SEQ_REGION_SIZE addresses also remembers the sequence of its last change.
+ *
+ * A consumer (SSE client, persistence, replication) keeps a
+ * reg_journal_reader_t: its cursor plus one dirty bit per address. collect()
+ * folds new changes into the bitmap; a reader that fell more than a ring
+ * behind marks every block changed since its cursor instead, so no change
+ * is ever missed, only widened.
+ * ============================================================================ */
+
+typedef enum {
+  REG_BANK_HR = 0,    // Holding registers
+  REG_BANK_IR = 1,    // Input registers
+  REG_BANK_COIL = 2,  // Coils
+  REG_BANK_DI = 3     // Discrete inputs
+} reg_bank_t;
+
+#define REG_JOURNAL_WORDS   (HOLDING_REGS_SIZE + INPUT_REGS_SIZE + COILS_SIZE * 8 + DISCRETE_INPUTS_SIZE * 8)
+#define REG_JOURNAL_BLOCKS  (REG_JOURNAL_WORDS >> REG_SEQ_REGION_SHIFT)
+
+typedef struct {
+  uint32_t cursor;                          // Sequence of the next change to consume
+  uint32_t overruns;                        // Times this reader fell more than a ring behind
+  uint32_t dirty[REG_JOURNAL_WORDS / 32];   // One bit per address, all banks back to back
+} reg_journal_reader_t;
+
+/**
+ * @brief Sequence number the next change will get
+ */
+uint32_t registers_journal_head(void);
+
+/**
+ * @brief Start a reader at the current head with nothing dirty
+ */
+void registers_journal_reader_init(reg_journal_reader_t *r);
+
+/**
+ * @brief Fold all changes since the reader's cursor into its dirty bitmap
+ * @return Number of journal entries consumed (0 = nothing changed)
+ */
+uint32_t registers_journal_collect(reg_journal_reader_t *r);
+
+/**
+ * @brief Take the next dirty address (bank order, then ascending) and clear its bit
+ * @return false when the bitmap is empty
+ */
+bool registers_journal_next_dirty(reg_journal_reader_t *r, reg_bank_t *bank, uint16_t *addr);
+
+/**
+ * @brief Has the block holding this address changed since seq?
+ * Block granularity: may report a neighbour's change, never misses one.
+ */
+bool registers_journal_changed_since(reg_bank_t bank, uint16_t addr, uint32_t seq);
+
+/**
+ * @brief Current value of any bank/address (coils and inputs as 0/1)
+ */
+uint16_t registers_journal_value(reg_bank_t bank, uint16_t addr);
+
+/**
+ * @brief Journal statistics since boot
+ * @param changes Changes recorded
+ * @param overruns Reader collects that had to fall back to block dirty marks
+ */
+void registers_journal_stats(uint32_t *changes, uint32_t *overruns);
+
+/* ============================================================================
+ * SPARSE REGISTER PAGES (v7.9.8.22)
+ *
+ * Holding registers from HOLDING_REGS_SIZE and input registers from
+ * INPUT_REGS_SIZE up to 65535 live in REG_PAGE_WORDS-word pages. A one-byte
+ * page table per bank translates an address in O(1); pages come from a pool
+ * of REG_PAGE_POOL_MAX and stay mapped until reboot.
+ *
+ * The get/set/set_*_registers/snapshot functions above accept these addresses
+ * transparently. Unmapped addresses read as 0 and ignore writes, so protocol
+ * front ends check registers_*_span() first. Sparse registers are not in the
+ * change journal and have no write hooks.
+ * ============================================================================ */
+
+/**
+ * @brief Map (zero-filled) the pages covering addr..addr+count-1 of HR or IR
+ * Addresses inside the flat array are always present and need no page.
+ * @return false if the pool or heap ran out (pages mapped so far stay)
+ */
+bool registers_page_map(reg_bank_t bank, uint16_t addr, uint16_t count);
+
+/**
+ * @brief Number of consecutive present holding registers from addr, max count
+ * Present = flat array or mapped page; span == count means the range is valid.
+ */
+uint16_t registers_holding_span(uint16_t addr, uint16_t count);
+
+/**
+ * @brief Number of consecutive present input registers from addr, max count
+ */
+uint16_t registers_input_span(uint16_t addr, uint16_t count);
+
+/**
+ * @brief List mapped pages of a bank as first addresses, ascending
+ * @return Number of pages written to first_addrs (max entries)
+ */
+uint16_t registers_page_list(reg_bank_t bank, uint16_t *first_addrs, uint16_t max);
+
+/**
+ * @brief Map every range declared in g_persist_config.reg_pages
+ * @return Number of declarations that could not be mapped completely
+ */
+uint8_t registers_page_apply_config(void);
+
+/**
+ * @brief Pages in use / pool size
+ */
+void registers_page_stats(uint16_t *mapped, uint16_t *max);
+
+/* ============================================================================
+ * HOLDING REGISTER WRITE HOOKS (v7.9.8.23)
+ *
+ * Side effects of writing a flat holding register are dispatched through a
+ * bitmap (one bit per HR) and a handler index, so plain registers cost one
+ * bit test per write. A bulk write calls each hook once per contiguous run
+ * of hooked addresses, after all values are stored.
+ *
+ * Install/remove from init or config context, not concurrently with writes.
+ * ============================================================================ */
+
+/**
+ * @brief Write hook: addr..addr+count-1 were just written with values[]
+ */
+typedef void (*reg_write_hook_t)(uint16_t addr, const uint16_t *values, uint16_t count);
+
+/**
+ * @brief Install the built-in hooks (ST Logic control, interval, var input)
+ * Call once at boot before subsystems write holding registers
+ */
+void registers_write_hooks_init(void);
+
+/**
+ * @brief Route writes of HR addr..addr+count-1 to hook (replaces existing hooks)
+ * @return false if the range leaves the flat array or REG_HOOK_MAX hooks are in use
+ */
+bool registers_write_hook_install(uint16_t addr, uint16_t count, reg_write_hook_t hook);
+
+/**
+ * @brief Remove hooks from HR addr..addr+count-1
+ */
+void registers_write_hook_remove(uint16_t addr, uint16_t count);
+
 /* ============================================================================
  * UTILITY / INITIALIZATION
  * ============================================================================ */
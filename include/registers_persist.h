@@ -111,6 +111,18 @@ bool registers_persist_group_save(const char* group_name);
  */
 bool registers_persist_group_save_by_id(uint8_t group_id);
 
+/**
+ * @brief Check if a group may need saving again (v7.9.8.21)
+ * @param group_id Group ID (1-8), or 0 for all groups
+ * @param since_seq registers_journal_head() taken just before the last save
+ * @return true if the change journal shows a write to one of the group's
+ *         registers since since_seq, or the stored snapshot differs from the
+ *         live values (group edited, restored or loaded from NVS meanwhile)
+ *
+ * Used by ST Logic SAVE(id) to skip NVS writes that would store the same values.
+ */
+bool registers_persist_group_changed_since(uint8_t group_id, uint32_t since_seq);
+
 /**
  * @brief Save all groups (snapshot current register values)
  * @return true if successful
@@ -9,6 +9,7 @@
  * blocking the main API server. Port is configurable via HttpConfig.sse_port.
  *
  * Endpoint: GET /api/events?subscribe=counters,timers,registers,system&hr=0-15&ir=0-3&coils=0-7&di=0-3
+ *           GET /api/events?subscribe=modbus  (Modbus master profile, v7.9.8.17 — not part of "all")
  */
 
 #ifndef SSE_EVENTS_H
@@ -26,6 +27,7 @@
 #define SSE_HEARTBEAT_MS        15000   // SSE keepalive comment interval
 #define SSE_DEFAULT_PORT        81      // Default SSE port (main port + 1)
 #define SSE_MAX_WATCH_PER_TYPE  32      // Max watched addresses per register type
+#define SSE_MODBUS_INTERVAL_MS  1000    // Modbus master profile events (max 1 Hz per bus/FC/slave)
 
 /* ============================================================================
  * TOPIC SUBSCRIPTION BITMASK
@@ -36,6 +38,7 @@
 #define SSE_TOPIC_REGISTERS     0x04
 #define SSE_TOPIC_SYSTEM        0x08
 #define SSE_TOPIC_ALL           0x0F
+#define SSE_TOPIC_MODBUS        0x10    // Opt-in: subscribe=modbus (v7.9.8.17)
 
 /* ============================================================================
  * PUBLIC API
@@ -78,7 +78,11 @@ st_value_t st_builtin_mb_write_holding(st_value_t slave_id, st_value_t address,
  *   MB_READ_HOLDINGS(1, 100, 4, regs);
  *   (* regs[0] = reg100, regs[1] = reg101, ... *)
  *
- * Returns TRUE if queued successfully. count: 1-16 registers.
+ * The array is filled from the last completed read of the same block
+ * (mb_async_block_result_pin), so each call site sees its own result.
+ *
+ * Returns TRUE if queued successfully. count: 1-MB_PAYLOAD_REGS registers
+ * (ST arrays are bounded by the 32 program variables).
  */
 st_value_t st_builtin_mb_read_holdings(st_value_t slave_id, st_value_t address, st_value_t count);
 
@@ -94,9 +98,13 @@ st_value_t st_builtin_mb_read_holdings(st_value_t slave_id, st_value_t address,
  *   regs[1] := 5678;
  *   MB_WRITE_HOLDINGS(1, 200, 2, regs);
  *
- * Returns TRUE if queued successfully. count: 1-16 registers.
+ * The VM copies the array into a payload slot (mb_payload_alloc) and hands
+ * its reference to the request — also when queuing fails.
+ *
+ * Returns TRUE if queued successfully. count: 1-MODBUS_MASTER_MAX_WRITE_REGS registers.
  */
-st_value_t st_builtin_mb_write_holdings(st_value_t slave_id, st_value_t address, st_value_t count);
+st_value_t st_builtin_mb_write_holdings(st_value_t slave_id, st_value_t address, st_value_t count,
+                                        uint8_t payload);
 
 /* ============================================================================
  * ASYNC STATUS FUNCTIONS (v7.7.0 — 0-arg builtins)
@@ -139,8 +147,4 @@ extern bool g_mb_success;         // TRUE if last operation succeeded
 extern uint8_t g_mb_request_count; // Current request count in this execution
 extern bool g_mb_cache_enabled;   // TRUE = cache dedup active (default), FALSE = always refresh
 
-// Multi-register buffer for MB_SET_REG/MB_GET_REG (v7.9.2)
-#define MB_MULTI_REG_MAX 16
-extern uint16_t g_mb_multi_reg_buf[MB_MULTI_REG_MAX];
-
 #endif // ST_BUILTIN_MODBUS_H
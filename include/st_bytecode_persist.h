@@ -6,7 +6,7 @@
  * At boot, loads cached bytecode instead of recompiling from source.
  * Uses CRC32 of source code as invalidation key.
  *
- * Format: 16-byte header + 32-byte name + variable table + instructions + optional function registry
+ * Format: 18-byte header + 32-byte name + variable table + instructions + optional function registry
  */
 
 #ifndef ST_BYTECODE_PERSIST_H
@@ -18,9 +18,9 @@
 
 /* Magic number "STBC" */
 #define ST_BYTECODE_MAGIC   0x53544243
-#define ST_BYTECODE_VERSION 3  // v3: var_names reduced from 32 to 16 bytes
+#define ST_BYTECODE_VERSION 6  // v6: FEAT-152 superinstructions (v5: FEAT-151 optimizer, v4: FEAT-149 typed opcodes)
 
-/* Bytecode file header (16 bytes) */
+/* Bytecode file header (18 bytes) */
 typedef struct __attribute__((packed)) {
   uint32_t magic;             // 0x53544243 ("STBC")
   uint16_t version;           // Format version
@@ -30,6 +30,7 @@ typedef struct __attribute__((packed)) {
   uint8_t  has_func_registry; // 1 if function registry follows instructions
   uint8_t  reserved;          // Padding
   uint32_t source_crc32;      // CRC32 of source code (invalidation key)
+  uint16_t unopt_instr_count; // v5: Instruction count before optimizer (0 = not optimized)
 } st_bc_header_t;
 
 /**
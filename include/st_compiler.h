@@ -19,6 +19,32 @@
 
 #include "st_types.h"
 
+/**
+ * FEAT-149: Statically typed opcodes
+ *
+ * When both operand types of an arithmetic/comparison operator are known at
+ * compile time (INT, DINT or REAL), the compiler emits a type-specialised
+ * opcode (ADD_INT, LT_REAL, ...) with explicit CVT_* conversions instead of
+ * the generic opcode that inspects the VM type stack. Build with
+ * -DST_COMPILER_TYPED_OPS=0 to emit generic opcodes only (A/B benchmark).
+ */
+#ifndef ST_COMPILER_TYPED_OPS
+#define ST_COMPILER_TYPED_OPS 1
+#endif
+
+/**
+ * FEAT-152: IEC function superinstructions
+ *
+ * TON/TOF/TP, CTU/CTD and R_TRIG/F_TRIG calls compile to dedicated opcodes
+ * (CALL_TON, ...) that call the timer/counter/edge kernel directly, and
+ * LIMIT/SCALE with statically known numeric arguments compile to
+ * LIMIT_INT/DINT/REAL and SCALE_REAL. Build with
+ * -DST_COMPILER_SUPERINSTRUCTIONS=0 to emit CALL_BUILTIN for all builtins.
+ */
+#ifndef ST_COMPILER_SUPERINSTRUCTIONS
+#define ST_COMPILER_SUPERINSTRUCTIONS 1
+#endif
+
 /* Symbol table entry (variable name → index mapping) */
 typedef struct {
   char name[64];
@@ -29,6 +29,36 @@
 
 #define ST_LOGIC_POOL_SIZE 8000  // Global pool size (8KB total, shared)
 
+/* ============================================================================
+ * SCAN SCHEDULING (FEAT-154)
+ *
+ * Each program has its own period (0 = global execution_interval_ms) and
+ * priority. Due times are esp_timer µs timestamps on a fixed grid
+ * (next_due += period), so a late scan does not shift later ones.
+ * ============================================================================ */
+
+#define ST_LOGIC_SCAN_SKIP          0   // Late by >= 1 period: drop missed scans, stay on grid
+#define ST_LOGIC_SCAN_CATCH_UP      1   // Late by >= 1 period: run missed scans back-to-back
+
+#define ST_LOGIC_SCAN_MAX_CATCHUP   4   // Catch-up limit; older missed scans are dropped
+#define ST_LOGIC_SCAN_MIN_PERIOD_MS 1
+#define ST_LOGIC_SCAN_MAX_PERIOD_MS 60000
+
+/* Histogram upper bounds (us), last bucket = +Inf */
+#define ST_LOGIC_SCAN_BUCKETS       8
+#define ST_LOGIC_SCAN_BOUNDS_US     { 50, 100, 250, 500, 1000, 2500, 5000 }
+
+typedef struct {
+  uint32_t jitter_bucket[ST_LOGIC_SCAN_BUCKETS];   // Start - due time (non-cumulative)
+  uint32_t overrun_bucket[ST_LOGIC_SCAN_BUCKETS];  // End - period end, late scans only
+  uint32_t jitter_count;
+  uint64_t jitter_sum_us;
+  uint32_t jitter_max_us;
+  uint32_t overrun_count;
+  uint64_t overrun_sum_us;
+  uint32_t skipped;           // Scans dropped (skip policy or catch-up limit)
+} st_logic_scan_stats_t;
+
 typedef struct {
   // Program identification
   char name[32];              // "Logic1", "Logic2", etc.
@@ -57,11 +87,20 @@ typedef struct {
   uint32_t max_execution_us;  // Maximum execution time (microseconds)
   uint32_t total_execution_us;// Total execution time for average calculation (microseconds)
   uint32_t overrun_count;     // Number of times execution > target interval
+  uint32_t last_instructions; // VM instructions executed in last cycle (v7.9.8.3)
 
   // IR Pool allocation (v5.1.0 - dynamic export to IR 220-251)
   uint16_t ir_pool_offset;    // Start offset in IR 220-251 (65535 if not allocated)
   uint8_t ir_pool_size;       // Number of registers allocated (0-32)
 
+  // Scan scheduling (FEAT-154, persisted in /logic_N.dat)
+  uint16_t period_ms;         // Scan period (0 = global execution_interval_ms)
+  uint8_t priority;           // Higher runs first when several programs are due
+  uint8_t scan_policy;        // ST_LOGIC_SCAN_SKIP / ST_LOGIC_SCAN_CATCH_UP
+  int64_t next_due_us;        // esp_timer time of next scan (0 = start on next call)
+  int64_t deadline_us;        // End of the running period (overrun check, 0 = none)
+  st_logic_scan_stats_t scan; // Start jitter / overrun histograms
+
 } st_logic_program_config_t;
 
 /* ============================================================================
@@ -79,7 +118,7 @@ typedef struct {
   uint8_t enabled;            // Logic mode enabled/disabled globally
   uint8_t debug;              // Debug output enabled (bytecode, execution trace, etc.)
   uint32_t execution_interval_ms; // How often to run programs (10ms default)
-  uint32_t last_run_time;     // Timestamp of last execution
+  uint32_t last_run_time;     // Timestamp of last execution (millis)
 
   // Global cycle statistics (v4.1.0)
   uint32_t cycle_min_ms;      // Minimum total cycle time (all programs)
@@ -87,6 +126,12 @@ typedef struct {
   uint32_t cycle_overrun_count; // Number of cycles where time > interval
   uint32_t total_cycles;      // Total number of cycles executed
 
+  // FEAT-153: Parallel execution (independent programs on the Core 0 worker)
+  uint8_t parallel;           // Split independent programs over loop task + worker
+  uint8_t lane[ST_LOGIC_MAX_PROGRAMS];  // Lane in last cycle (0=loop, 1=worker, 0xFF=not run)
+  uint8_t group_count;        // Independent program groups in last cycle
+  uint32_t parallel_cycles;   // Cycles where the worker lane executed programs
+
   // FEAT-008: Per-program debugger state
   st_debug_state_t debugger[ST_LOGIC_MAX_PROGRAMS];  // Debugger state for each program
 
@@ -223,6 +268,24 @@ void st_logic_update_binding_counts(st_logic_engine_state_t *state);
  */
 void st_logic_reset_stats(st_logic_engine_state_t *state, uint8_t program_id);
 
+/**
+ * @brief Effective scan period of a program (FEAT-154)
+ * @return period_ms, or the global execution interval if 0
+ */
+uint32_t st_logic_get_period_ms(const st_logic_engine_state_t *state, uint8_t program_id);
+
+/**
+ * @brief Set scan period/priority/policy of a program (FEAT-154)
+ * @param state Logic engine state
+ * @param program_id Program ID (0-3)
+ * @param period_ms Scan period in ms (0 = global interval, else 1-60000)
+ * @param priority Higher runs first when several programs are due (0-255)
+ * @param policy ST_LOGIC_SCAN_SKIP or ST_LOGIC_SCAN_CATCH_UP
+ * @return true if valid
+ */
+bool st_logic_set_schedule(st_logic_engine_state_t *state, uint8_t program_id,
+                           uint16_t period_ms, uint8_t priority, uint8_t policy);
+
 /**
  * @brief Reset global cycle statistics (v4.1.0)
  * @param state Logic engine state
@@ -15,6 +15,16 @@
 #include "st_logic_config.h"
 #include "registers.h"
 
+/* ============================================================================
+ * FEAT-153: PARALLEL EXECUTION WORKER
+ * Independent programs (see st_logic_parallel.h) run on this task while the
+ * loop task executes the rest; st_logic_engine_loop() waits for both.
+ * ============================================================================ */
+
+#define ST_LOGIC_WORKER_TASK_STACK  6144   // VM + builtins + debug_printf buffer
+#define ST_LOGIC_WORKER_TASK_PRIO   2      // Above loopTask (1), below mb_async (3)
+#define ST_LOGIC_WORKER_TASK_CORE   0      // Other core than the loop task (Core 1)
+
 /* ============================================================================
  * MAIN LOGIC ENGINE INTERFACE
  * ============================================================================ */
@@ -27,6 +37,13 @@
  *   2. Execute compiled bytecode
  *   3. Write VAR_OUTPUT to Modbus holding registers
  *
+ * FEAT-153: With state->parallel set, independent programs run on the
+ * Core 0 worker concurrently with the rest; returns when both lanes are done.
+ *
+ * FEAT-154: Only programs whose period has elapsed run (fixed esp_timer grid,
+ * highest priority first). Arms a one-shot timer for the next due time that
+ * wakes the calling task from st_logic_scan_wait().
+ *
  * @param state Logic engine state
  * @param holding_regs Modbus holding registers array
  * @param input_regs Modbus input registers array
@@ -35,6 +52,21 @@
 bool st_logic_engine_loop(st_logic_engine_state_t *state,
                            uint16_t *holding_regs, uint16_t *input_regs);
 
+/**
+ * @brief Enable/disable parallel execution across both cores (FEAT-153)
+ * Starts the worker task on first enable. Takes effect from the next cycle.
+ * @param state Logic engine state
+ * @param enabled true = split independent programs over loop task + worker
+ */
+void st_logic_set_parallel(st_logic_engine_state_t *state, bool enabled);
+
+/**
+ * @brief Sleep until the next ST scan is due or max_ms has passed (FEAT-154)
+ * Replaces delay() at the end of loop(); woken by the scan timer.
+ * @param max_ms Upper bound on the wait
+ */
+void st_logic_scan_wait(uint32_t max_ms);
+
 /**
  * @brief Read VAR_INPUT values from Modbus registers
  * @param state Logic engine state
@@ -63,6 +95,14 @@ bool st_logic_write_outputs(st_logic_engine_state_t *state, uint8_t program_id,
  */
 bool st_logic_execute_program(st_logic_engine_state_t *state, uint8_t program_id);
 
+/**
+ * @brief Free the long-lived VM of a program slot (v7.9.8.5)
+ * Deferred: the VM is freed at the start of the next st_logic_engine_loop()
+ * cycle, never under a running scan. Reallocated on the next execution.
+ * @param program_id Program ID (0-3)
+ */
+void st_logic_release_vm(uint8_t program_id);
+
 /**
  * @brief Print logic engine status
  * @param state Logic engine state
@@ -0,0 +1,115 @@
+/**
+ * @file st_logic_parallel.h
+ * @brief Dependency analysis + lane partitioning for parallel ST execution (FEAT-153)
+ *
+ * st_logic_engine_loop() can split the enabled programs over two lanes:
+ *
+ *   lane 0 — the calling task (Arduino loop, Core 1)
+ *   lane 1 — the ST worker task (Core 0)
+ *
+ * Each program gets a dependency set:
+ *   - register ranges from its VariableMappings (HR/coil/DI, input and output)
+ *   - its EXPORT range in IR 220-251
+ *   - a "global" flag if it touches engine-wide state during execution
+ *     (MB_* / CNT_* / SAVE / LOAD builtins, or an attached debugger)
+ *
+ * Programs that share a register, or are both global, are merged into one
+ * group (union-find). A group always runs on one lane in priority /
+ * program-id order, so the serial semantics within a group are unchanged. Global groups are
+ * pinned to lane 0; the rest are balanced on last_execution_us.
+ *
+ * The analysis and partitioning are pure (no FreeRTOS), so the scheduler can
+ * be exercised on the host.
+ */
+
+#ifndef ST_LOGIC_PARALLEL_H
+#define ST_LOGIC_PARALLEL_H
+
+#include <stdint.h>
+#include "st_logic_config.h"
+
+#define ST_LOGIC_LANES          2       // Loop task + one worker
+#define ST_LOGIC_LANE_NONE      0xFF    // Program not scheduled (disabled/not compiled)
+#define ST_LOGIC_DEP_MAX_RANGES 34      // 32 var_maps + IR export + spare
+
+/* Register spaces used for conflict detection */
+typedef enum {
+  ST_LOGIC_RES_HR = 0,
+  ST_LOGIC_RES_IR,
+  ST_LOGIC_RES_COIL,
+  ST_LOGIC_RES_DI
+} st_logic_res_space_t;
+
+typedef struct {
+  uint8_t space;              // st_logic_res_space_t
+  uint16_t start;             // First register
+  uint16_t count;             // Number of registers (>= 1)
+} st_logic_res_range_t;
+
+/* Dependency set of one program slot */
+typedef struct {
+  uint8_t active;             // Enabled + compiled (will execute this cycle)
+  uint8_t global;             // Touches engine-wide state → lane 0 only
+  uint8_t range_count;
+  uint32_t cost_us;           // Expected execution time (last_execution_us)
+  st_logic_res_range_t ranges[ST_LOGIC_DEP_MAX_RANGES];
+} st_logic_deps_t;
+
+/* Result of one partitioning run */
+typedef struct {
+  uint8_t lane[ST_LOGIC_MAX_PROGRAMS];     // Lane per program (ST_LOGIC_LANE_NONE if inactive)
+  uint8_t group[ST_LOGIC_MAX_PROGRAMS];    // Group id = lowest program id in the group
+  uint8_t group_count;                     // Number of independent groups
+  uint8_t lane_programs[ST_LOGIC_LANES];   // Programs per lane
+  uint32_t lane_cost_us[ST_LOGIC_LANES];   // Summed cost per lane
+} st_logic_schedule_t;
+
+/**
+ * @brief Does a builtin touch engine-wide state (Modbus master, counters, NVS)?
+ * @param func_id st_builtin_func_t value
+ * @return true if programs calling it must stay on the loop task
+ */
+bool st_logic_builtin_is_global(uint16_t func_id);
+
+/**
+ * @brief Scan bytecode for builtins with global side effects
+ * @param bytecode Compiled program
+ * @return true if any CALL_BUILTIN targets a global builtin
+ */
+bool st_logic_bytecode_is_global(const st_bytecode_program_t *bytecode);
+
+/**
+ * @brief Add a register range to a dependency set (merged if adjacent/overlapping)
+ * @return false if the range table is full (caller should mark the set global)
+ */
+bool st_logic_deps_add_range(st_logic_deps_t *deps, uint8_t space, uint16_t start, uint16_t count);
+
+/**
+ * @brief Build the dependency set of one program
+ * @param state Logic engine state
+ * @param program_id Program ID (0-3)
+ * @param maps Variable mappings (g_persist_config.var_maps)
+ * @param map_count Number of mappings
+ * @param bytecode_global Cached st_logic_bytecode_is_global() result
+ * @param deps Output
+ */
+void st_logic_deps_collect(const st_logic_engine_state_t *state, uint8_t program_id,
+                           const VariableMapping *maps, uint8_t map_count,
+                           bool bytecode_global, st_logic_deps_t *deps);
+
+/**
+ * @brief Do two dependency sets share a register or both need lane 0?
+ */
+bool st_logic_deps_conflict(const st_logic_deps_t *a, const st_logic_deps_t *b);
+
+/**
+ * @brief Partition programs into independent groups and assign lanes
+ * @param deps Dependency set per program slot
+ * @param count Number of slots (<= ST_LOGIC_MAX_PROGRAMS)
+ * @param lanes Usable lanes (1 = everything on lane 0)
+ * @param out Output schedule
+ */
+void st_logic_schedule_build(const st_logic_deps_t *deps, uint8_t count, uint8_t lanes,
+                             st_logic_schedule_t *out);
+
+#endif // ST_LOGIC_PARALLEL_H
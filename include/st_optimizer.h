@@ -0,0 +1,58 @@
+/**
+ * @file st_optimizer.h
+ * @brief Bytecode peephole optimizer for compiled ST programs (FEAT-151)
+ *
+ * Runs on the finished bytecode after compilation and before it is cached
+ * in SPIFFS. All passes preserve the VM result of every cycle:
+ *
+ *   - Constant folding:    PUSH_INT 2, PUSH_INT 3, MUL → PUSH_INT 6
+ *   - Constant branches:   PUSH_BOOL, JMP_IF_FALSE → JMP or nothing
+ *   - Dead stores:         LOAD_VAR x, STORE_VAR x and overwritten STORE_VARs
+ *   - INC_VAR fusion:      LOAD_VAR x, PUSH_INT k, ADD, STORE_VAR x → INC_VAR x,k
+ *   - Jump threading:      jumps to JMP go straight to the final target
+ *   - Unreachable code:    instructions no path from PC 0 / a function reaches
+ *
+ * Removed instructions are compacted out; jump targets, function registry
+ * addresses and the source line map are relocated to the new addresses.
+ *
+ * Usage:
+ *   st_optimizer_stats_t stats;
+ *   st_optimizer_run(&prog->bytecode, &g_line_map, &stats);
+ */
+
+#ifndef ST_OPTIMIZER_H
+#define ST_OPTIMIZER_H
+
+#include "st_types.h"
+#include "st_compiler.h"
+
+/**
+ * Build with -DST_OPTIMIZER_ENABLED=0 to load the compiler output unchanged
+ * (A/B benchmark, or to rule out the optimizer when debugging bytecode).
+ */
+#ifndef ST_OPTIMIZER_ENABLED
+#define ST_OPTIMIZER_ENABLED 1
+#endif
+
+/* Result of one optimizer run (instruction counts) */
+typedef struct {
+  uint16_t instr_before;    // Compiler output
+  uint16_t instr_after;     // After all passes
+  uint16_t folded;          // Constant expressions/branches folded
+  uint16_t fused;           // LOAD/ADD/STORE sequences fused to INC_VAR
+  uint16_t dead_stores;     // Stores removed
+  uint16_t jumps_threaded;  // Jumps retargeted or removed
+  uint16_t unreachable;     // Unreachable instructions removed
+} st_optimizer_stats_t;
+
+/**
+ * @brief Optimize compiled bytecode in place
+ * @param bytecode Compiled program (instructions are shrunk with realloc)
+ * @param line_map Line map to relocate (NULL if not valid for this program)
+ * @param stats Output: pass statistics (may be NULL)
+ * @return true if the instruction count was reduced
+ */
+bool st_optimizer_run(st_bytecode_program_t *bytecode, st_line_map_t *line_map,
+                      st_optimizer_stats_t *stats);
+
+#endif // ST_OPTIMIZER_H
@@ -28,7 +28,7 @@
  * CONFIGURATION CONSTANTS
  * ============================================================================ */
 
-#define ST_MAX_TIMER_INSTANCES   8    // Max TON/TOF/TP instances per program
+#define ST_MAX_TIMER_INSTANCES   32   // Max TON/TOF/TP instances per program (FEAT-152: was 8)
 #define ST_MAX_EDGE_INSTANCES    8    // Max R_TRIG/F_TRIG instances per program
 #define ST_MAX_COUNTER_INSTANCES 8    // Max CTU/CTD/CTUD instances per program
 #define ST_MAX_LATCH_INSTANCES   8    // Max SR/RS latch instances per program
@@ -210,15 +210,15 @@ typedef struct {
  * Holds all stateful instances (timers, edges, counters, latches, signal) for a single
  * ST Logic program. Allocated per-program and persists across cycles.
  *
- * Memory: ~540 bytes per program (v4.8+ with signal processing)
- * - Timers: 8 × ~24 bytes = 192 bytes
+ * Memory: ~1.1 KB per program (v7.9.8.7: 32 timers for timer ladders)
+ * - Timers: 32 × ~24 bytes = 768 bytes
  * - Edges: 8 × 8 bytes = 64 bytes
  * - Counters: 8 × ~20 bytes = 160 bytes
  * - Latches: 8 × 4 bytes = 32 bytes (v4.7.3)
  * - Hysteresis: 8 × 1 byte = 8 bytes (v4.8)
  * - Blink: 8 × 6 bytes = 48 bytes (v4.8)
  * - Filter: 8 × 4 bytes = 32 bytes (v4.8)
- * - Total: ~540 bytes
+ * - Total: ~1.1 KB
  */
 typedef struct {
   // Timer instances (TON/TOF/TP)
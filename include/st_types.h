@@ -549,6 +549,59 @@ typedef enum {
   // Misc
   ST_OP_NOP,                // No operation
   ST_OP_HALT,               // Stop execution
+
+  // FEAT-149: Statically typed arithmetic/compare (operand types resolved by compiler)
+  ST_OP_ADD_INT,            // Pop 2 INT, push INT sum (16-bit wrap)
+  ST_OP_ADD_DINT,           // Pop 2 DINT, push DINT sum
+  ST_OP_ADD_REAL,           // Pop 2 REAL, push REAL sum
+  ST_OP_SUB_INT,            // Pop 2 INT, push INT difference
+  ST_OP_SUB_DINT,           // Pop 2 DINT, push DINT difference
+  ST_OP_SUB_REAL,           // Pop 2 REAL, push REAL difference
+  ST_OP_MUL_INT,            // Pop 2 INT, push INT product
+  ST_OP_MUL_DINT,           // Pop 2 DINT, push DINT product
+  ST_OP_MUL_REAL,           // Pop 2 REAL, push REAL product
+  ST_OP_DIV_REAL,           // Pop 2 REAL, push REAL quotient
+  ST_OP_EQ_INT,             // Pop 2 INT, push (a == b)
+  ST_OP_EQ_DINT,            // Pop 2 DINT, push (a == b)
+  ST_OP_EQ_REAL,            // Pop 2 REAL, push (a == b)
+  ST_OP_NE_INT,             // Pop 2 INT, push (a != b)
+  ST_OP_NE_DINT,            // Pop 2 DINT, push (a != b)
+  ST_OP_NE_REAL,            // Pop 2 REAL, push (a != b)
+  ST_OP_LT_INT,             // Pop 2 INT, push (a < b)
+  ST_OP_LT_DINT,            // Pop 2 DINT, push (a < b)
+  ST_OP_LT_REAL,            // Pop 2 REAL, push (a < b)
+  ST_OP_GT_INT,             // Pop 2 INT, push (a > b)
+  ST_OP_GT_DINT,            // Pop 2 DINT, push (a > b)
+  ST_OP_GT_REAL,            // Pop 2 REAL, push (a > b)
+  ST_OP_LE_INT,             // Pop 2 INT, push (a <= b)
+  ST_OP_LE_DINT,            // Pop 2 DINT, push (a <= b)
+  ST_OP_LE_REAL,            // Pop 2 REAL, push (a <= b)
+  ST_OP_GE_INT,             // Pop 2 INT, push (a >= b)
+  ST_OP_GE_DINT,            // Pop 2 DINT, push (a >= b)
+  ST_OP_GE_REAL,            // Pop 2 REAL, push (a >= b)
+
+  // FEAT-149: Explicit numeric conversions (top of stack)
+  ST_OP_CVT_INT_DINT,       // INT → DINT (sign-extend)
+  ST_OP_CVT_INT_REAL,       // INT → REAL
+  ST_OP_CVT_DINT_REAL,      // DINT → REAL
+
+  // FEAT-151: Optimizer-fused operations (emitted by st_optimizer, not the compiler)
+  ST_OP_INC_VAR,            // var_inc.var_index += var_inc.delta (INT/DINT, no stack use)
+
+  // FEAT-152: IEC function superinstructions (fixed arity, no builtin dispatch)
+  ST_OP_CALL_TON,           // Pop PT, IN; push Q (builtin_call.instance_id = timer)
+  ST_OP_CALL_TOF,           // Pop PT, IN; push Q (builtin_call.instance_id = timer)
+  ST_OP_CALL_TP,            // Pop PT, IN; push Q (builtin_call.instance_id = timer)
+  ST_OP_CALL_CTU,           // Pop PV, RESET, CU; push Q (instance_id = counter)
+  ST_OP_CALL_CTD,           // Pop PV, LOAD, CD; push Q (instance_id = counter)
+  ST_OP_CALL_R_TRIG,        // Pop CLK; push rising edge (instance_id = edge)
+  ST_OP_CALL_F_TRIG,        // Pop CLK; push falling edge (instance_id = edge)
+  ST_OP_LIMIT_INT,          // Pop 3 INT (MN, IN, MX), push INT clamp
+  ST_OP_LIMIT_DINT,         // Pop 3 DINT, push DINT clamp
+  ST_OP_LIMIT_REAL,         // Pop 3 REAL, push REAL clamp
+  ST_OP_SCALE_REAL,         // Pop 5 REAL (IN, IN_MIN, IN_MAX, OUT_MIN, OUT_MAX), push REAL
+
+  ST_OP_COUNT               // Number of opcodes (not an instruction)
 } st_opcode_t;
 
 /* Bytecode instruction (8 bytes, optimized for DRAM) */
@@ -560,9 +613,9 @@ typedef struct {
     uint32_t dword_arg;     // For PUSH_DWORD
     bool bool_arg;          // For PUSH_BOOL
     uint16_t var_index;     // For LOAD_VAR, STORE_VAR
-    struct {                // For CALL_BUILTIN with stateful functions
+    struct {                // For CALL_BUILTIN / FEAT-152 CALL_* with stateful functions
       uint8_t func_id_low;  // Lower byte of function ID
-      uint8_t instance_id;  // Instance storage index (0-7)
+      uint8_t instance_id;  // Instance storage index
       uint16_t padding;     // Padding to 4 bytes
     } builtin_call;
     struct {                // FEAT-003: For CALL_USER with instance tracking
@@ -578,10 +631,15 @@ typedef struct {
     } array_op;
     struct {                // FEAT-122: FB field access (timer/counter instance fields)
       uint8_t fb_type;      // 0=timer, 1=counter
-      uint8_t instance_id;  // Instance index (0-7)
+      uint8_t instance_id;  // Instance index
       uint8_t field_id;     // Field: timer(0=Q,1=ET), counter(0=Q/QU,1=QD,2=CV)
       uint8_t padding;
     } fb_field;
+    struct {                // FEAT-151: INC_VAR (fused LOAD_VAR/PUSH_INT/ADD/STORE_VAR)
+      uint8_t var_index;    // Variable slot
+      uint8_t padding;
+      int16_t delta;        // Signed increment (SUB folded to negative delta)
+    } var_inc;
   } arg;
 } st_bytecode_instr_t;
 
@@ -593,6 +651,7 @@ typedef struct {
   st_bytecode_instr_t *instructions;      // Dynamically allocated (exact instr_count size)
   uint16_t instr_count;
   uint16_t instr_capacity;                // Allocated size (== instr_count after compile)
+  uint16_t unoptimized_count;             // FEAT-151: instr_count before optimizer (0 = not optimized)
 
   // Variable memory
   st_value_t variables[32];        // Max 32 variables (runtime values)
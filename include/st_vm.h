@@ -16,6 +16,9 @@
  *   // Or execute all at once
  *   st_vm_run(&vm, MAX_STEPS);
  *
+ *   // Or execute all at once with threaded dispatch (no debugger attached)
+ *   st_vm_run_fast(&vm, MAX_STEPS);
+ *
  *   // Access results
  *   int result = vm.variables[0].int_val;
  */
@@ -65,6 +68,18 @@ typedef struct {
  */
 void st_vm_init(st_vm_t *vm, const st_bytecode_program_t *program);
 
+/**
+ * @brief Prepare a long-lived VM for the next scan cycle
+ *
+ * Resets execution state (pc, sp, flags, call stack, statistics) without
+ * clearing the whole struct. Variables are NOT loaded - the caller copies
+ * the program's variables into vm->variables (under its own lock).
+ *
+ * @param vm VM state (previously initialized with st_vm_init)
+ * @param program Compiled bytecode program
+ */
+void st_vm_begin_cycle(st_vm_t *vm, const st_bytecode_program_t *program);
+
 /**
  * @brief Execute one instruction and advance PC
  * @param vm VM state
@@ -80,6 +95,20 @@ bool st_vm_step(st_vm_t *vm);
  */
 bool st_vm_run(st_vm_t *vm, uint32_t max_steps);
 
+/**
+ * @brief Execute until halt or error using direct-threaded dispatch
+ *
+ * Same semantics as st_vm_run() (same errors, same max_steps limit) but
+ * dispatches through a computed-goto table with PC kept in a register
+ * instead of calling st_vm_step() per instruction.
+ * Used by the logic engine when no debugger is attached to the program.
+ *
+ * @param vm VM state
+ * @param max_steps Maximum steps to execute (0 = unlimited)
+ * @return true if completed successfully, false if error
+ */
+bool st_vm_run_fast(st_vm_t *vm, uint32_t max_steps);
+
 /**
  * @brief Reset VM to initial state (keeps program reference)
  * @param vm VM state
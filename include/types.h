@@ -37,16 +37,58 @@ typedef struct {
   uint16_t starting_address;
   uint16_t quantity_of_outputs;
   uint8_t byte_count;
-  uint8_t output_values[MODBUS_FRAME_MAX];
+  const uint8_t* output_values;     // Points into request frame (zero-copy, v7.9.8.1)
 } ModbusWriteMultipleCoilsRequest;
 
 typedef struct {
   uint16_t starting_address;
   uint16_t quantity_of_registers;
   uint8_t byte_count;
-  uint16_t register_values[MODBUS_FRAME_MAX / 2];
+  const uint8_t* register_bytes;    // Big-endian values, points into request frame (zero-copy, v7.9.8.1)
 } ModbusWriteMultipleRegistersRequest;
 
+typedef struct {
+  uint16_t reference_address;
+  uint16_t and_mask;
+  uint16_t or_mask;
+} ModbusMaskWriteRegisterRequest;
+
+typedef struct {
+  uint16_t read_starting_address;
+  uint16_t quantity_to_read;
+  uint16_t write_starting_address;
+  uint16_t quantity_to_write;
+  uint8_t write_byte_count;
+  const uint8_t* write_bytes;       // Big-endian values, points into request frame
+} ModbusReadWriteMultipleRequest;
+
+typedef struct {
+  uint16_t sub_function;
+  uint8_t data_length;              // Bytes after the sub-function (even, >= 2)
+  const uint8_t* data;              // Points into request frame
+} ModbusDiagnosticsRequest;
+
+typedef struct {
+  uint8_t read_device_id_code;      // 1=basic, 2=regular, 3=extended, 4=individual
+  uint8_t object_id;                // First object (stream) or the object (individual)
+} ModbusDeviceIdRequest;
+
+typedef struct {
+  uint8_t id;
+  const char* value;
+} ModbusDeviceIdObject;
+
+/**
+ * @brief FC08 serial line counters (RTU slave, RAM only, v7.9.8.24)
+ */
+typedef struct {
+  uint32_t bus_messages;            // Frames with valid CRC seen on the bus (any slave ID)
+  uint32_t bus_comm_errors;         // CRC mismatches and malformed frames
+  uint32_t bus_exceptions;          // Exception responses from this slave
+  uint32_t server_messages;         // Frames addressed to this slave (incl. broadcast)
+  uint32_t server_no_response;      // Frames addressed here without a reply (broadcast)
+} ModbusDiagCounters;
+
 /* ============================================================================
  * COUNTER CONFIGURATION
  * ============================================================================ */
@@ -399,8 +441,11 @@ typedef struct {
   uint16_t inter_frame_delay;   // 0=auto (t3.5 from baudrate), >0=manual ms
   uint8_t max_requests_per_cycle; // Max requests per ST execution (default: 10)
   uint16_t cache_ttl_ms;         // Cache TTL in ms (0=never expire, default: 0)
-  uint8_t cache_max_entries;     // Runtime cache size limit (1-32, default: 32)
+  uint16_t cache_max_entries;    // Cache size (1-1024 PSRAM / 1-256, default: 32)
   uint8_t queue_max_size;        // Runtime queue size limit (4-32, default: 16)
+  uint8_t coalesce_enabled;      // Merge queued reads into block reads (v7.9.8.11, default: 1)
+  uint8_t coalesce_gap;          // Max unused registers bridged in a block (0 = contiguous only)
+  uint8_t write_combine;         // Pending-write table: last value wins + FC15/FC16 merge (v7.9.8.19, default: 1)
 
   // Runtime statistics
   uint32_t total_requests;      // Total requests sent
@@ -470,6 +515,58 @@ typedef struct __attribute__((packed)) {
   uint16_t sync_interval_min;            // Re-sync interval in minutes (default: 60)
 } NtpConfig;                             // 100 bytes
 
+/* ============================================================================
+ * MODBUS TCP SLAVE CONFIGURATION (v7.9.8.0, FEAT-145)
+ * ============================================================================ */
+
+typedef struct __attribute__((packed)) {
+  uint8_t  enabled;                      // Modbus TCP server enabled (1) or disabled (0)
+  uint16_t port;                         // TCP port (0 = default 502)
+  uint8_t  max_clients;                  // Simultaneous clients (1-MODBUS_TCP_MAX_CLIENTS)
+  uint16_t idle_timeout_s;               // Drop idle clients after N seconds (0 = never)
+  uint8_t  reserved[2];                  // Future use
+} ModbusTcpConfig;                       // 8 bytes
+
+/* ============================================================================
+ * MODBUS MASTER POLL GROUPS (v7.9.8.12)
+ * ============================================================================ */
+
+typedef struct __attribute__((packed)) {
+  uint8_t  enabled;                      // Group is polled (1) or parked (0)
+  uint8_t  slave_id;                     // 1-247 (0 = unused slot)
+  uint8_t  fc;                           // 1-4 (FC01 coils .. FC04 input registers)
+  uint8_t  priority;                     // Higher runs first when several groups are due
+  uint16_t start;                        // First register/bit
+  uint16_t count;                        // 1-MB_POLL_MAX_COUNT
+  uint32_t period_ms;                    // MB_POLL_MIN_PERIOD_MS-MB_POLL_MAX_PERIOD_MS
+} ModbusPollGroup;                       // 12 bytes
+
+/* ============================================================================
+ * MODBUS MASTER EXTRA BUSES (v7.9.8.14)
+ * Bus 0 is configured by modbus_master_config_t; these describe bus 1..N-1.
+ * ============================================================================ */
+
+typedef struct __attribute__((packed)) {
+  uint8_t  enabled;                      // Worker task + UART started at boot / on enable
+  uint8_t  parity;                       // 0=none, 1=even, 2=odd
+  uint8_t  stop_bits;                    // 1 or 2
+  uint32_t baudrate;
+  uint16_t timeout_ms;                   // Response timeout
+  uint16_t inter_frame_delay;            // 0=auto (t3.5 from baudrate), >0=manual ms
+} ModbusBusConfig;                       // 11 bytes
+
+typedef struct __attribute__((packed)) {
+  uint8_t first_slave;                   // 1-247 (0 = unused slot)
+  uint8_t last_slave;                    // >= first_slave
+  uint8_t bus;                           // 0..MB_BUS_MAX-1
+} ModbusBusRoute;                        // 3 bytes
+
+typedef struct __attribute__((packed)) {
+  uint8_t bank;                          // 0 = holding, 1 = input (reg_bank_t)
+  uint16_t start;                        // First address (rounded down to a page)
+  uint16_t count;                        // Registers (0 = unused slot)
+} RegPageDecl;                           // 5 bytes
+
 /* ============================================================================
  * PERSISTENT CONFIGURATION (EEPROM/NVS)
  * ============================================================================ */
@@ -563,6 +660,22 @@ typedef struct __attribute__((packed)) {
   char dashboard_card_tabs[256];   // "id:tab,id:tab,..." e.g. "system:overview,counters:app"
   char dashboard_card_hidden[80];  // "id,id,..." hidden card IDs
 
+  // Modbus TCP slave server (v7.9.8.0, schema 20)
+  ModbusTcpConfig modbus_tcp;
+
+  // Modbus master poll groups (v7.9.8.12, schema 23)
+  ModbusPollGroup mb_poll_groups[MB_POLL_GROUPS_MAX];
+
+  // Modbus master extra buses + slave routing (v7.9.8.14, schema 24)
+  ModbusBusConfig mb_buses[MB_BUS_MAX - 1];
+  ModbusBusRoute mb_bus_routes[MB_BUS_ROUTES_MAX];
+
+  // Modbus master write dedup opt-out (v7.9.8.19, schema 25)
+  uint8_t mb_write_always[32];     // Slave-ID bitmap: writes are sent even when the value is unchanged
+
+  // Sparse HR/IR pages mapped at boot (v7.9.8.22, schema 26)
+  RegPageDecl reg_pages[REG_PAGE_DECL_MAX];
+
   // CRC checksum (last)
   uint16_t crc16;
 } PersistConfig;
@@ -152,4 +152,28 @@ void uart1_flush_rx(void);
  */
 void uart1_flush_tx(void);
 
+/**
+ * @brief Read up to max_len pending bytes from UART1 in one call
+ * @param dst Destination buffer
+ * @param max_len Buffer size
+ * @return Number of bytes read
+ */
+uint16_t uart1_read_buffer(uint8_t* dst, uint16_t max_len);
+
+/* ============================================================================
+ * UART1 RX FRAME EVENT (v7.9.8.2)
+ * ============================================================================ */
+
+typedef void (*uart_rx_frame_cb_t)(void);
+
+/**
+ * @brief Register callback fired when the RX line has been idle for idle_symbols
+ * character times (hardware RX timeout = Modbus RTU t3.5 frame end).
+ * Runs in the UART driver event task, not ISR. Re-applied by uart1_init*()
+ * so it survives deferred init and baudrate changes.
+ * @param cb Callback (NULL = disable)
+ * @param idle_symbols RX idle timeout in character times (1-100)
+ */
+void uart1_set_rx_frame_callback(uart_rx_frame_cb_t cb, uint8_t idle_symbols);
+
 #endif // uart_driver_H
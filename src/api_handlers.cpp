@@ -29,6 +29,7 @@
 #include "timer_engine.h"
 #include "timer_config.h"
 #include "st_logic_config.h"
+#include "st_logic_engine.h"
 #include "wifi_driver.h"
 #include "ethernet_driver.h"
 #include "build_version.h"
@@ -49,7 +50,10 @@
 #include "cli_shell.h"
 #include "rbac.h"
 #include "mb_async.h"
+#include "mb_profile.h"
 #include "ntp_driver.h"
+#include "modbus_tcp_server.h"
+#include "modbus_server.h"
 #include <esp_heap_caps.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
@@ -75,6 +79,7 @@ esp_err_t api_handler_logic_enable(httpd_req_t *req);
 esp_err_t api_handler_logic_disable(httpd_req_t *req);
 esp_err_t api_handler_logic_reinit(httpd_req_t *req);
 esp_err_t api_handler_logic_stats(httpd_req_t *req);
+esp_err_t api_handler_logic_schedule_post(httpd_req_t *req);
 esp_err_t api_handler_counter_reset(httpd_req_t *req);
 esp_err_t api_handler_counter_start(httpd_req_t *req);
 esp_err_t api_handler_counter_stop(httpd_req_t *req);
@@ -499,6 +504,7 @@ esp_err_t api_handler_endpoints(httpd_req_t *req)
     "{\"method\":\"GET\",\"path\":\"/api/registers/coils/{addr}\",\"desc\":\"Read coil\"},"
     "{\"method\":\"POST\",\"path\":\"/api/registers/coils/{addr}\",\"desc\":\"Write coil\"},"
     "{\"method\":\"GET\",\"path\":\"/api/registers/di/{addr}\",\"desc\":\"Read DI\"},"
+    "{\"method\":\"GET\",\"path\":\"/api/registers/map\",\"desc\":\"Sparse HR/IR pages\"},"
     "{\"method\":\"GET\",\"path\":\"/api/gpio\",\"desc\":\"All GPIO mappings\"},"
     "{\"method\":\"GET\",\"path\":\"/api/gpio/{pin}\",\"desc\":\"Single GPIO\"},"
     "{\"method\":\"POST\",\"path\":\"/api/gpio/{pin}\",\"desc\":\"Write GPIO\"},"
@@ -512,11 +518,16 @@ esp_err_t api_handler_endpoints(httpd_req_t *req)
     "{\"method\":\"POST\",\"path\":\"/api/logic/{1-4}/reinit\",\"desc\":\"Cold restart (reset variables)\"},"
     "{\"method\":\"DELETE\",\"path\":\"/api/logic/{1-4}\",\"desc\":\"Delete program\"},"
     "{\"method\":\"GET\",\"path\":\"/api/logic/{1-4}/stats\",\"desc\":\"Program stats\"},"
+    "{\"method\":\"POST\",\"path\":\"/api/logic/{1-4}/schedule\",\"desc\":\"Scan period/priority/policy\"},"
     "{\"method\":\"POST\",\"path\":\"/api/logic/settings\",\"desc\":\"Logic engine settings\"},"
     "{\"method\":\"GET\",\"path\":\"/api/modbus/slave\",\"desc\":\"Slave config+stats\"},"
     "{\"method\":\"POST\",\"path\":\"/api/modbus/slave\",\"desc\":\"Configure slave\"},"
     "{\"method\":\"GET\",\"path\":\"/api/modbus/master\",\"desc\":\"Master config+stats\"},"
     "{\"method\":\"POST\",\"path\":\"/api/modbus/master\",\"desc\":\"Configure master\"},"
+    "{\"method\":\"GET\",\"path\":\"/api/modbus/master/poll\",\"desc\":\"Poll groups + rate/lateness\"},"
+    "{\"method\":\"POST\",\"path\":\"/api/modbus/master/poll\",\"desc\":\"Create/update/delete poll group\"},"
+    "{\"method\":\"GET\",\"path\":\"/api/modbus/master/bus\",\"desc\":\"RS485 buses + slave routes\"},"
+    "{\"method\":\"POST\",\"path\":\"/api/modbus/master/bus\",\"desc\":\"Configure bus or slave route\"},"
     "{\"method\":\"GET\",\"path\":\"/api/wifi\",\"desc\":\"WiFi config+status\"},"
     "{\"method\":\"POST\",\"path\":\"/api/wifi\",\"desc\":\"Configure WiFi\"},"
     "{\"method\":\"POST\",\"path\":\"/api/wifi/connect\",\"desc\":\"Connect WiFi\"},"
@@ -857,7 +868,7 @@ esp_err_t api_handler_hr_read(httpd_req_t *req)
   CHECK_AUTH(req);
 
   int addr = api_extract_id_from_uri(req, "/api/registers/hr/");
-  if (addr < 0 || addr >= HOLDING_REGS_SIZE) {
+  if (addr < 0 || addr > 0xFFFF || registers_holding_span(addr, 1) != 1) {
     return api_send_error(req, 400, "Invalid register address");
   }
 
@@ -884,7 +895,7 @@ esp_err_t api_handler_hr_write(httpd_req_t *req)
   CHECK_AUTH_WRITE(req);
 
   int addr = api_extract_id_from_uri(req, "/api/registers/hr/");
-  if (addr < 0 || addr >= HOLDING_REGS_SIZE) {
+  if (addr < 0 || addr > 0xFFFF || registers_holding_span(addr, 1) != 1) {
     return api_send_error(req, 400, "Invalid register address");
   }
 
@@ -935,7 +946,7 @@ esp_err_t api_handler_hr_write(httpd_req_t *req)
   }
   else if (strcmp(type_str, "dint") == 0) {
     // 32-bit signed (2 registers)
-    if (addr + 1 >= HOLDING_REGS_SIZE) {
+    if (registers_holding_span(addr, 2) != 2) {
       return api_send_error(req, 400, "DINT requires 2 registers, address out of range");
     }
     int32_t value = doc["value"].as<int32_t>();
@@ -948,7 +959,7 @@ esp_err_t api_handler_hr_write(httpd_req_t *req)
   }
   else if (strcmp(type_str, "dword") == 0) {
     // 32-bit unsigned (2 registers)
-    if (addr + 1 >= HOLDING_REGS_SIZE) {
+    if (registers_holding_span(addr, 2) != 2) {
       return api_send_error(req, 400, "DWORD requires 2 registers, address out of range");
     }
     uint32_t value = doc["value"].as<uint32_t>();
@@ -960,7 +971,7 @@ esp_err_t api_handler_hr_write(httpd_req_t *req)
   }
   else if (strcmp(type_str, "real") == 0) {
     // 32-bit float (2 registers, IEEE 754)
-    if (addr + 1 >= HOLDING_REGS_SIZE) {
+    if (registers_holding_span(addr, 2) != 2) {
       return api_send_error(req, 400, "REAL requires 2 registers, address out of range");
     }
     float value = doc["value"].as<float>();
@@ -992,7 +1003,7 @@ esp_err_t api_handler_ir_read(httpd_req_t *req)
   CHECK_AUTH(req);
 
   int addr = api_extract_id_from_uri(req, "/api/registers/ir/");
-  if (addr < 0 || addr >= INPUT_REGS_SIZE) {
+  if (addr < 0 || addr > 0xFFFF || registers_input_span(addr, 1) != 1) {
     return api_send_error(req, 400, "Invalid register address");
   }
 
@@ -1134,6 +1145,9 @@ esp_err_t api_handler_logic(httpd_req_t *req)
   doc["enabled"] = state->enabled ? true : false;
   doc["execution_interval_ms"] = state->execution_interval_ms;
   doc["total_cycles"] = state->total_cycles;
+  doc["parallel"] = state->parallel ? true : false;    // FEAT-153
+  doc["parallel_cycles"] = state->parallel_cycles;
+  doc["groups"] = state->group_count;
 
   // Compiler resource info (realtime heap + pool stats)
   JsonObject res = doc["resources"].to<JsonObject>();
@@ -1163,6 +1177,9 @@ esp_err_t api_handler_logic(httpd_req_t *req)
     p["source_size"] = prog->source_size;
     p["execution_count"] = prog->execution_count;
     p["error_count"] = prog->error_count;
+    if (state->lane[i] != 0xFF) {
+      p["lane"] = state->lane[i];  // FEAT-153: 0 = loop (Core 1), 1 = worker (Core 0)
+    }
 
     if (prog->last_error[0] != '\0') {
       p["last_error"] = prog->last_error;
@@ -1220,6 +1237,10 @@ esp_err_t api_handler_logic_single(httpd_req_t *req)
     if (uri_len >= 5 && strcmp(uri + uri_len - 5, "/bind") == 0) {
       return api_handler_logic_bind_post(req);
     }
+    // FEAT-154: Scan scheduling
+    if (uri_len >= 9 && strcmp(uri + uri_len - 9, "/schedule") == 0) {
+      return api_handler_logic_schedule_post(req);
+    }
   }
 
   // Normal logic/{id} handling
@@ -1250,6 +1271,7 @@ esp_err_t api_handler_logic_single(httpd_req_t *req)
   doc["min_execution_us"] = prog->min_execution_us;
   doc["max_execution_us"] = prog->max_execution_us;
   doc["overrun_count"] = prog->overrun_count;
+  doc["last_instructions"] = prog->last_instructions;
 
   if (prog->last_error[0] != '\0') {
     doc["last_error"] = prog->last_error;
@@ -1460,11 +1482,12 @@ esp_err_t api_handler_logic_source_post(httpd_req_t *req)
   char buf[256];
   snprintf(buf, sizeof(buf),
     "{\"status\":200,\"id\":%d,\"name\":\"%s\",\"compiled\":%s,"
-    "\"source_size\":%lu,\"instr_count\":%u%s%s%s}",
+    "\"source_size\":%lu,\"instr_count\":%u,\"instr_unoptimized\":%u%s%s%s}",
     id, prog->name,
     prog->compiled ? "true" : "false",
     (unsigned long)source_len,
     (unsigned)prog->bytecode.instr_count,
+    (unsigned)prog->bytecode.unoptimized_count,
     (!prog->compiled && prog->last_error[0]) ? ",\"compile_error\":\"" : "",
     (!prog->compiled && prog->last_error[0]) ? prog->last_error : "",
     (!prog->compiled && prog->last_error[0]) ? "\"" : "");
@@ -1991,6 +2014,7 @@ esp_err_t api_handler_logic_stats(httpd_req_t *req)
   doc["min_execution_us"] = prog->min_execution_us;
   doc["max_execution_us"] = prog->max_execution_us;
   doc["overrun_count"] = prog->overrun_count;
+  doc["last_instructions"] = prog->last_instructions;
 
   // Calculate average if we have executions
   if (prog->execution_count > 0) {
@@ -1999,17 +2023,122 @@ esp_err_t api_handler_logic_stats(httpd_req_t *req)
     doc["avg_execution_us"] = 0;
   }
 
-  char *buf = (char *)malloc(HTTP_JSON_DOC_SIZE);
+  // FEAT-154: Scan scheduling + jitter/overrun histograms (non-cumulative buckets)
+  static const uint32_t scan_bounds_us[ST_LOGIC_SCAN_BUCKETS - 1] = ST_LOGIC_SCAN_BOUNDS_US;
+  const st_logic_scan_stats_t *ss = &prog->scan;
+  JsonObject scan = doc["scan"].to<JsonObject>();
+  scan["period_ms"] = prog->period_ms;
+  scan["effective_period_ms"] = st_logic_get_period_ms(state, id - 1);
+  scan["priority"] = prog->priority;
+  scan["policy"] = (prog->scan_policy == ST_LOGIC_SCAN_CATCH_UP) ? "catchup" : "skip";
+  scan["scans"] = ss->jitter_count;
+  scan["skipped"] = ss->skipped;
+  scan["jitter_max_us"] = ss->jitter_max_us;
+  scan["jitter_avg_us"] = ss->jitter_count ? (uint32_t)(ss->jitter_sum_us / ss->jitter_count) : 0;
+  scan["overrun_count"] = ss->overrun_count;
+  scan["overrun_avg_us"] = ss->overrun_count ? (uint32_t)(ss->overrun_sum_us / ss->overrun_count) : 0;
+  JsonArray bounds = scan["bounds_us"].to<JsonArray>();
+  for (int b = 0; b < ST_LOGIC_SCAN_BUCKETS - 1; b++) bounds.add(scan_bounds_us[b]);
+  JsonArray jitter_hist = scan["jitter_hist"].to<JsonArray>();
+  JsonArray overrun_hist = scan["overrun_hist"].to<JsonArray>();
+  for (int b = 0; b < ST_LOGIC_SCAN_BUCKETS; b++) {
+    jitter_hist.add(ss->jitter_bucket[b]);
+    overrun_hist.add(ss->overrun_bucket[b]);
+  }
+
+  // FEAT-154: scan histograms push the document past HTTP_JSON_DOC_SIZE
+  const size_t BUF_SIZE = 2048;
+  char *buf = (char *)malloc(BUF_SIZE);
   if (!buf) {
     return api_send_error(req, 500, "Out of memory");
   }
-  serializeJson(doc, buf, HTTP_JSON_DOC_SIZE);
+  serializeJson(doc, buf, BUF_SIZE);
 
   esp_err_t ret = api_send_json(req, buf);
   free(buf);
   return ret;
 }
 
+/* ============================================================================
+ * POST /api/logic/{id}/schedule - Scan period/priority/policy (FEAT-154)
+ * ============================================================================ */
+
+esp_err_t api_handler_logic_schedule_post(httpd_req_t *req)
+{
+  http_server_stat_request();
+  CHECK_AUTH_WRITE(req);
+
+  int id = api_extract_id_from_uri(req, "/api/logic/");
+  if (id < 1 || id > ST_LOGIC_MAX_PROGRAMS) {
+    return api_send_error(req, 400, "Invalid logic ID (must be 1-4)");
+  }
+
+  st_logic_engine_state_t *state = st_logic_get_state();
+  if (!state) {
+    return api_send_error(req, 500, "ST Logic not initialized");
+  }
+
+  char content[256];
+  int ret = httpd_req_recv(req, content, sizeof(content) - 1);
+  if (ret <= 0) {
+    return api_send_error(req, 400, "Failed to read request body");
+  }
+  content[ret] = '\0';
+
+  JsonDocument doc;
+  DeserializationError error = deserializeJson(doc, content);
+  if (error) {
+    return api_send_error(req, 400, "Invalid JSON");
+  }
+
+  // Omitted fields keep their current value
+  st_logic_program_config_t *prog = &state->programs[id - 1];
+  uint32_t period_ms = prog->period_ms;
+  uint32_t priority = prog->priority;
+  uint8_t policy = prog->scan_policy;
+
+  if (doc.containsKey("period_ms")) {
+    period_ms = doc["period_ms"].as<uint32_t>();
+    if (period_ms != 0 && (period_ms < ST_LOGIC_SCAN_MIN_PERIOD_MS || period_ms > ST_LOGIC_SCAN_MAX_PERIOD_MS)) {
+      return api_send_error(req, 400, "period_ms must be 0 (global interval) or 1-60000");
+    }
+  }
+  if (doc.containsKey("priority")) {
+    priority = doc["priority"].as<uint32_t>();
+    if (priority > 255) {
+      return api_send_error(req, 400, "priority must be 0-255");
+    }
+  }
+  if (doc.containsKey("policy")) {
+    const char *p = doc["policy"] | "";
+    if (strcmp(p, "skip") == 0) {
+      policy = ST_LOGIC_SCAN_SKIP;
+    } else if (strcmp(p, "catchup") == 0) {
+      policy = ST_LOGIC_SCAN_CATCH_UP;
+    } else {
+      return api_send_error(req, 400, "policy must be \"skip\" or \"catchup\"");
+    }
+  }
+
+  if (!st_logic_set_schedule(state, id - 1, (uint16_t)period_ms, (uint8_t)priority, policy)) {
+    return api_send_error(req, 400, "Invalid schedule");
+  }
+
+  JsonDocument resp;
+  resp["status"] = 200;
+  resp["program"] = id;
+  resp["period_ms"] = prog->period_ms;
+  resp["effective_period_ms"] = st_logic_get_period_ms(state, id - 1);
+  resp["priority"] = prog->priority;
+  resp["policy"] = (prog->scan_policy == ST_LOGIC_SCAN_CATCH_UP) ? "catchup" : "skip";
+  resp["message"] = "Schedule updated (use save to persist)";
+
+  char buf[256];
+  serializeJson(resp, buf, sizeof(buf));
+
+  return api_send_json(req, buf);
+}
+
 /* ============================================================================
  * CONFIG & DEBUG ENDPOINTS (v6.0.4+)
  * ============================================================================ */
@@ -2331,6 +2460,267 @@ esp_err_t api_handler_debug_set(httpd_req_t *req)
  * GET /api/modbus/* - Modbus slave/master config + stats (GAP-4, GAP-5, GAP-18)
  * ============================================================================ */
 
+/* ============================================================================
+ * GET/POST /api/modbus/master/poll - Poll groups (v7.9.8.12)
+ * ============================================================================ */
+
+static esp_err_t api_modbus_poll_get(httpd_req_t *req)
+{
+  JsonDocument doc;
+  JsonArray groups = doc["groups"].to<JsonArray>();
+  uint32_t polled = 0;
+
+  for (uint8_t i = 0; i < MB_POLL_GROUPS_MAX; i++) {
+    const ModbusPollGroup *pg = &g_persist_config.mb_poll_groups[i];
+    if (pg->slave_id == 0) continue;
+    JsonObject g = groups.add<JsonObject>();
+    g["id"] = i + 1;
+    g["enabled"] = pg->enabled ? true : false;
+    g["slave"] = pg->slave_id;
+    g["fc"] = pg->fc;
+    g["start"] = pg->start;
+    g["count"] = pg->count;
+    g["period_ms"] = pg->period_ms;
+    g["priority"] = pg->priority;
+    if (pg->enabled) polled += pg->count;
+
+    const mb_poll_state_t *ps = mb_async_poll_state(i);
+    JsonObject st = g["stats"].to<JsonObject>();
+    st["polls"] = ps->polls;
+    st["errors"] = ps->errors;
+    st["missed"] = ps->missed;
+    st["rate_hz"] = mb_poll_rate_hz(ps);
+    st["target_hz"] = 1000.0f / pg->period_ms;
+    st["late_last_ms"] = ps->late_last_ms;
+    st["late_avg_ms"] = ps->polls ? ps->late_sum_ms / ps->polls : 0;
+    st["late_max_ms"] = ps->late_max_ms;
+  }
+  doc["max_groups"] = MB_POLL_GROUPS_MAX;
+  doc["polled_addresses"] = polled;
+  doc["cache_max_entries"] = g_modbus_master_config.cache_max_entries;
+
+  // 16 groups with stats do not fit HTTP_JSON_DOC_SIZE
+  const size_t BUF_SIZE = 4096;
+  char *buf = (char *)malloc(BUF_SIZE);
+  if (!buf) {
+    return api_send_error(req, 500, "Out of memory");
+  }
+  serializeJson(doc, buf, BUF_SIZE);
+
+  esp_err_t ret = api_send_json(req, buf);
+  free(buf);
+  return ret;
+}
+
+// Body: {"id":1-16, "slave", "fc", "start", "count", "period_ms", "priority", "enabled"} or {"id":N, "delete":true}
+static esp_err_t api_modbus_poll_post(httpd_req_t *req)
+{
+  char body[256];
+  int blen = httpd_req_recv(req, body, sizeof(body) - 1);
+  if (blen <= 0) return api_send_error(req, 400, "Empty body");
+  body[blen] = '\0';
+
+  JsonDocument doc;
+  if (deserializeJson(doc, body)) return api_send_error(req, 400, "Invalid JSON");
+
+  int id = doc["id"] | 0;
+  if (id < 1 || id > MB_POLL_GROUPS_MAX) return api_send_error(req, 400, "id must be 1-16");
+  ModbusPollGroup *slot = &g_persist_config.mb_poll_groups[id - 1];
+
+  if (doc["delete"] | false) {
+    memset(slot, 0, sizeof(*slot));
+    mb_async_poll_load(g_persist_config.mb_poll_groups);
+    return api_send_json(req, "{\"status\":\"ok\",\"message\":\"Poll group deleted\"}");
+  }
+
+  // Unspecified fields keep their current value (defaults for a new group)
+  ModbusPollGroup pg = *slot;
+  if (pg.slave_id == 0) {
+    memset(&pg, 0, sizeof(pg));
+    pg.enabled = 1;
+    pg.fc = MB_REQ_READ_HOLDING;
+    pg.count = 1;
+    pg.period_ms = 1000;
+  }
+  if (doc.containsKey("enabled")) pg.enabled = doc["enabled"].as<bool>() ? 1 : 0;
+  if (doc.containsKey("slave")) pg.slave_id = (uint8_t)constrain(doc["slave"].as<int>(), 0, 255);
+  if (doc.containsKey("fc")) pg.fc = (uint8_t)constrain(doc["fc"].as<int>(), 0, 255);
+  if (doc.containsKey("start")) pg.start = (uint16_t)constrain(doc["start"].as<long>(), 0L, 65535L);
+  if (doc.containsKey("count")) pg.count = (uint16_t)constrain(doc["count"].as<long>(), 0L, 65535L);
+  if (doc.containsKey("period_ms")) pg.period_ms = doc["period_ms"].as<uint32_t>();
+  if (doc.containsKey("priority")) pg.priority = (uint8_t)constrain(doc["priority"].as<int>(), 0, 255);
+
+  if (!mb_poll_group_valid(&pg)) {
+    return api_send_error(req, 400, "Invalid poll group (slave 1-247, fc 1-4, count 1-125, period_ms 10-3600000)");
+  }
+  *slot = pg;
+  mb_async_poll_load(g_persist_config.mb_poll_groups);
+
+  char resp[192];
+  snprintf(resp, sizeof(resp),
+           "{\"status\":\"ok\",\"id\":%d,\"enabled\":%s,\"slave\":%u,\"fc\":%u,\"start\":%u,\"count\":%u,\"period_ms\":%lu,\"priority\":%u}",
+           id, pg.enabled ? "true" : "false", pg.slave_id, pg.fc, pg.start, pg.count,
+           (unsigned long)pg.period_ms, pg.priority);
+  return api_send_json(req, resp);
+}
+
+/* ============================================================================
+ * GET/POST /api/modbus/master/bus - Extra RS485 buses + slave routes (v7.9.8.14)
+ * ============================================================================ */
+
+static const char *api_parity_str(uint8_t parity)
+{
+  return parity == 1 ? "even" : parity == 2 ? "odd" : "none";
+}
+
+static esp_err_t api_modbus_bus_get(httpd_req_t *req)
+{
+  JsonDocument doc;
+  JsonArray buses = doc["buses"].to<JsonArray>();
+
+  for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+    const mb_async_state_t *bs = mb_async_get_bus_state(bus);
+    JsonObject b = buses.add<JsonObject>();
+    b["bus"] = bus;
+    if (bus == 0) {
+      b["uart"] = g_persist_config.modbus_master_uart;
+      b["enabled"] = g_modbus_master_config.enabled ? true : false;
+      b["parity"] = api_parity_str(g_modbus_master_config.parity);
+      b["stop_bits"] = g_modbus_master_config.stop_bits;
+      b["timeout_ms"] = g_modbus_master_config.timeout_ms;
+      b["inter_frame_delay_ms"] = g_modbus_master_config.inter_frame_delay;
+    } else {
+      const ModbusBusConfig *bc = &g_persist_config.mb_buses[bus - 1];
+      b["uart"] = MODBUS_MASTER_BUS1_UART;
+      b["enabled"] = bc->enabled ? true : false;
+      b["parity"] = api_parity_str(bc->parity);
+      b["stop_bits"] = bc->stop_bits;
+      b["timeout_ms"] = bc->timeout_ms;
+      b["inter_frame_delay_ms"] = bc->inter_frame_delay;
+    }
+    b["baudrate"] = modbus_master_bus_baudrate(bus);
+    b["running"] = bs->task_running ? true : false;
+    b["transport"] = modbus_master_transport_name(bus);
+
+    JsonObject st = b["stats"].to<JsonObject>();
+    st["queue_depth"] = bs->pq_count;
+    st["queue_drops"] = bs->queue_full_count + bs->priority_drops;
+    st["queue_contention"] = bs->queue_contention;
+    st["queue_dedup"] = bs->queue_dedup;
+    st["requests"] = bs->total_requests;
+    st["errors"] = bs->total_errors;
+    st["timeouts"] = bs->total_timeouts;
+    st["cache_entries"] = bs->entry_count;
+    st["cache_capacity"] = bs->cache_capacity;
+    st["rx_events"] = modbus_master_get_wait_stats(bus)->rx_events;
+  }
+
+  JsonArray routes = doc["routes"].to<JsonArray>();
+  for (uint8_t i = 0; i < MB_BUS_ROUTES_MAX; i++) {
+    const ModbusBusRoute *r = &g_persist_config.mb_bus_routes[i];
+    if (r->first_slave == 0) continue;
+    JsonObject o = routes.add<JsonObject>();
+    o["id"] = i + 1;
+    o["first_slave"] = r->first_slave;
+    o["last_slave"] = r->last_slave;
+    o["bus"] = r->bus;
+  }
+  doc["max_buses"] = MB_BUS_MAX;
+  doc["max_routes"] = MB_BUS_ROUTES_MAX;
+
+  const size_t BUF_SIZE = 2048;
+  char *buf = (char *)malloc(BUF_SIZE);
+  if (!buf) {
+    return api_send_error(req, 500, "Out of memory");
+  }
+  serializeJson(doc, buf, BUF_SIZE);
+
+  esp_err_t ret = api_send_json(req, buf);
+  free(buf);
+  return ret;
+}
+
+// Body: {"bus":1, "enabled", "baudrate", "parity", "stop_bits", "timeout_ms", "inter_frame_delay_ms"}
+//    or {"route":1-8, "first_slave", "last_slave", "bus"} / {"route":N, "delete":true}
+static esp_err_t api_modbus_bus_post(httpd_req_t *req)
+{
+  char body[256];
+  int blen = httpd_req_recv(req, body, sizeof(body) - 1);
+  if (blen <= 0) return api_send_error(req, 400, "Empty body");
+  body[blen] = '\0';
+
+  JsonDocument doc;
+  if (deserializeJson(doc, body)) return api_send_error(req, 400, "Invalid JSON");
+
+  char resp[192];
+
+  if (doc.containsKey("route")) {
+    int id = doc["route"] | 0;
+    if (id < 1 || id > MB_BUS_ROUTES_MAX) return api_send_error(req, 400, "route must be 1-8");
+    ModbusBusRoute *slot = &g_persist_config.mb_bus_routes[id - 1];
+
+    if (doc["delete"] | false) {
+      memset(slot, 0, sizeof(*slot));
+      mb_async_route_load(g_persist_config.mb_bus_routes);
+      return api_send_json(req, "{\"status\":\"ok\",\"message\":\"Route deleted\"}");
+    }
+
+    ModbusBusRoute r = *slot;
+    if (doc.containsKey("first_slave")) r.first_slave = (uint8_t)constrain(doc["first_slave"].as<int>(), 0, 255);
+    if (doc.containsKey("last_slave")) r.last_slave = (uint8_t)constrain(doc["last_slave"].as<int>(), 0, 255);
+    else if (doc.containsKey("first_slave") && r.last_slave < r.first_slave) r.last_slave = r.first_slave;
+    if (doc.containsKey("bus")) r.bus = (uint8_t)constrain(doc["bus"].as<int>(), 0, 255);
+
+    if (!mb_bus_route_valid(&r)) {
+      return api_send_error(req, 400, "Invalid route (first_slave 1-247, last_slave >= first_slave, bus 0-1)");
+    }
+    *slot = r;
+    mb_async_route_load(g_persist_config.mb_bus_routes);
+
+    snprintf(resp, sizeof(resp),
+             "{\"status\":\"ok\",\"route\":%d,\"first_slave\":%u,\"last_slave\":%u,\"bus\":%u,\"bus_running\":%s}",
+             id, r.first_slave, r.last_slave, r.bus,
+             mb_async_get_bus_state(r.bus)->task_running ? "true" : "false");
+    return api_send_json(req, resp);
+  }
+
+  int bus = doc["bus"] | 0;
+  if (bus < 1 || bus >= MB_BUS_MAX) {
+    return api_send_error(req, 400, "bus must be 1 (bus 0 = POST /api/modbus/master)");
+  }
+
+  ModbusBusConfig bc = g_persist_config.mb_buses[bus - 1];
+  if (doc.containsKey("enabled")) bc.enabled = doc["enabled"].as<bool>() ? 1 : 0;
+  if (doc.containsKey("baudrate")) bc.baudrate = doc["baudrate"].as<uint32_t>();
+  if (doc.containsKey("parity")) {
+    const char *par = doc["parity"] | "none";
+    if (strcasecmp(par, "none") == 0) bc.parity = 0;
+    else if (strcasecmp(par, "even") == 0) bc.parity = 1;
+    else if (strcasecmp(par, "odd") == 0) bc.parity = 2;
+    else return api_send_error(req, 400, "parity must be none, even or odd");
+  }
+  if (doc.containsKey("stop_bits")) bc.stop_bits = (uint8_t)constrain(doc["stop_bits"].as<int>(), 0, 255);
+  if (doc.containsKey("timeout_ms")) bc.timeout_ms = (uint16_t)constrain(doc["timeout_ms"].as<long>(), 0L, 65535L);
+  if (doc.containsKey("inter_frame_delay_ms")) {
+    bc.inter_frame_delay = (uint16_t)constrain(doc["inter_frame_delay_ms"].as<long>(), 0L, 65535L);
+  }
+
+  if (!mb_bus_config_valid(&bc)) {
+    return api_send_error(req, 400, "Invalid bus config (baudrate 2400-115200, stop_bits 1-2, timeout_ms 100-5000, inter_frame_delay_ms 0-1000)");
+  }
+  g_persist_config.mb_buses[bus - 1] = bc;
+  if (!mb_async_bus_apply((uint8_t)bus)) {
+    return api_send_error(req, 409, "Bus UART could not be started (pins not configured or used by the slave)");
+  }
+
+  snprintf(resp, sizeof(resp),
+           "{\"status\":\"ok\",\"bus\":%d,\"enabled\":%s,\"running\":%s,\"baudrate\":%lu,\"parity\":\"%s\",\"stop_bits\":%u}",
+           bus, bc.enabled ? "true" : "false",
+           mb_async_get_bus_state((uint8_t)bus)->task_running ? "true" : "false",
+           (unsigned long)bc.baudrate, api_parity_str(bc.parity), bc.stop_bits);
+  return api_send_json(req, resp);
+}
+
 esp_err_t api_handler_modbus_get(httpd_req_t *req)
 {
   http_server_stat_request();
@@ -2338,6 +2728,16 @@ esp_err_t api_handler_modbus_get(httpd_req_t *req)
 
   const char *uri = req->uri;
 
+  // GET /api/modbus/master/poll — poll groups + schedule statistics (v7.9.8.12)
+  if (strstr(uri, "/master/poll") != NULL) {
+    return api_modbus_poll_get(req);
+  }
+
+  // GET /api/modbus/master/bus — buses + slave routes (v7.9.8.14)
+  if (strstr(uri, "/master/bus") != NULL) {
+    return api_modbus_bus_get(req);
+  }
+
   // Route based on suffix: /api/modbus/slave or /api/modbus/master
   bool is_slave = (strstr(uri, "/slave") != NULL);
   bool is_master = (strstr(uri, "/master") != NULL);
@@ -2378,6 +2778,15 @@ esp_err_t api_handler_modbus_get(httpd_req_t *req)
     cfg["inter_frame_delay_ms"] = g_modbus_master_config.inter_frame_delay;
     cfg["max_requests_per_cycle"] = g_modbus_master_config.max_requests_per_cycle;
     cfg["cache_ttl_ms"] = g_modbus_master_config.cache_ttl_ms;
+    cfg["cache_max_entries"] = g_modbus_master_config.cache_max_entries;
+    cfg["cache_limit"] = mb_async_cache_limit();
+    cfg["coalesce"] = g_modbus_master_config.coalesce_enabled ? true : false;
+    cfg["coalesce_gap"] = g_modbus_master_config.coalesce_gap;
+    cfg["write_combine"] = g_modbus_master_config.write_combine ? true : false;
+    JsonArray always = cfg["write_always"].to<JsonArray>();
+    for (uint16_t id = 1; id <= 247; id++) {
+      if (mb_async_write_always((uint8_t)id)) always.add(id);
+    }
 
     JsonObject stats = doc["stats"].to<JsonObject>();
     stats["total_requests"] = g_modbus_master_config.total_requests;
@@ -2385,6 +2794,28 @@ esp_err_t api_handler_modbus_get(httpd_req_t *req)
     stats["timeout_errors"] = g_modbus_master_config.timeout_errors;
     stats["crc_errors"] = g_modbus_master_config.crc_errors;
     stats["exception_errors"] = g_modbus_master_config.exception_errors;
+
+    const mb_async_state_t *mb_async = mb_async_get_state();
+    JsonObject co = stats["coalesce"].to<JsonObject>();
+    co["blocks"] = mb_async->coalesced_blocks;
+    co["reads"] = mb_async->coalesced_reads;
+    co["fallbacks"] = mb_async->coalesce_fallbacks;
+    co["bus_time_saved_ms"] = (uint32_t)(mb_async->coalesce_saved_us / 1000);
+    JsonObject wr = stats["writes"].to<JsonObject>();
+    wr["combined"] = mb_async->write_combined;
+    wr["skipped_unchanged"] = mb_async->write_skipped;
+    wr["blocks"] = mb_async->write_blocks;
+    wr["block_writes"] = mb_async->write_block_members;
+    wr["fallbacks"] = mb_async->write_fallbacks;
+
+    const ModbusMasterWaitStats *ws = modbus_master_get_wait_stats(0);
+    JsonObject rx = stats["rx_wait"].to<JsonObject>();
+    rx["hw_rs485"] = ws->hw_rs485;
+    rx["events"] = ws->rx_events;
+    rx["wait_ms"] = (uint32_t)(ws->wait_us / 1000);
+    rx["busy_ms"] = (uint32_t)(ws->busy_us / 1000);
+    int load = modbus_master_get_core_load();
+    if (load >= 0) rx["core0_load_pct"] = load;
   }
 
   char buf[HTTP_JSON_DOC_SIZE];
@@ -2412,6 +2843,16 @@ esp_err_t api_handler_modbus_post(httpd_req_t *req)
     return api_send_json(req, "{\"status\":\"ok\",\"message\":\"Master statistics reset\"}");
   }
 
+  // POST /api/modbus/master/poll — create/update/delete a poll group (v7.9.8.12)
+  if (strstr(uri, "/master/poll") != NULL) {
+    return api_modbus_poll_post(req);
+  }
+
+  // POST /api/modbus/master/bus — configure a bus or a slave route (v7.9.8.14)
+  if (strstr(uri, "/master/bus") != NULL) {
+    return api_modbus_bus_post(req);
+  }
+
   // POST /api/modbus/master/rw — async read/write via cache+queue (v7.9.6.6)
   if (strstr(uri, "/master/rw") != NULL) {
     char body[256];
@@ -2441,17 +2882,18 @@ esp_err_t api_handler_modbus_post(httpd_req_t *req)
     if (strcasecmp(op, "read") == 0) {
       // Check cache first
       uint8_t cache_type = (uint8_t)rtype;
-      mb_cache_entry_t *entry = mb_cache_find(slave_id, addr, cache_type);
+      mb_cache_entry_t entry;
+      bool cached = mb_cache_find(slave_id, addr, cache_type, &entry);
 
-      if (entry && entry->status == MB_CACHE_VALID) {
-        uint32_t age_ms = (uint32_t)(millis() - entry->last_update_ms);
+      if (cached && entry.status == MB_CACHE_VALID) {
+        uint32_t age_ms = (uint32_t)(millis() - entry.last_update_ms);
         snprintf(resp, sizeof(resp),
           "{\"status\":\"ok\",\"value\":%d,\"hex\":\"0x%04X\",\"signed\":%d,\"age_ms\":%u,\"source\":\"cache\"}",
-          (uint16_t)entry->value.int_val, (uint16_t)entry->value.int_val,
-          (int16_t)entry->value.int_val, age_ms);
-      } else if (entry && entry->status == MB_CACHE_PENDING) {
+          (uint16_t)entry.value.int_val, (uint16_t)entry.value.int_val,
+          (int16_t)entry.value.int_val, age_ms);
+      } else if (cached && entry.status == MB_CACHE_PENDING) {
         snprintf(resp, sizeof(resp), "{\"status\":\"pending\",\"message\":\"Request queued\"}");
-      } else if (entry && entry->status == MB_CACHE_ERROR) {
+      } else if (cached && entry.status == MB_CACHE_ERROR) {
         // Stale error — enqueue fresh read
         mb_async_queue_read(rtype, slave_id, addr);
         snprintf(resp, sizeof(resp), "{\"status\":\"pending\",\"message\":\"Re-queued (last: error)\"}");
@@ -2519,6 +2961,7 @@ esp_err_t api_handler_modbus_post(httpd_req_t *req)
     if (doc.containsKey("inter_frame_delay_ms")) {
       g_persist_config.modbus_slave.inter_frame_delay = doc["inter_frame_delay_ms"].as<uint16_t>();
     }
+    modbus_server_apply_line_config();  // Frame-end silence follows baudrate/inter-frame
   } else {
     if (doc.containsKey("enabled")) {
       g_modbus_master_config.enabled = doc["enabled"].as<bool>();
@@ -2564,6 +3007,46 @@ esp_err_t api_handler_modbus_post(httpd_req_t *req)
       g_modbus_master_config.cache_ttl_ms = ttl;
       g_persist_config.modbus_master.cache_ttl_ms = ttl;
     }
+    if (doc.containsKey("cache_max_entries")) {
+      uint16_t n = doc["cache_max_entries"].as<uint16_t>();
+      uint16_t limit = mb_async_cache_limit();
+      if (n < 1 || n > limit) {
+        char msg[64];
+        snprintf(msg, sizeof(msg), "cache_max_entries must be 1-%u", limit);
+        return api_send_error(req, 400, msg);
+      }
+      if (mb_async_get_state()->entries && !mb_async_cache_resize(n)) {
+        return api_send_error(req, 500, "Cache allocation failed");
+      }
+      g_modbus_master_config.cache_max_entries = n;
+      g_persist_config.modbus_master.cache_max_entries = n;
+    }
+    if (doc.containsKey("coalesce")) {
+      uint8_t on = doc["coalesce"].as<bool>() ? 1 : 0;
+      g_modbus_master_config.coalesce_enabled = on;
+      g_persist_config.modbus_master.coalesce_enabled = on;
+    }
+    if (doc.containsKey("coalesce_gap")) {
+      uint16_t gap = doc["coalesce_gap"].as<uint16_t>();
+      if (gap > MB_COALESCE_MAX_GAP) return api_send_error(req, 400, "coalesce_gap must be 0-32");
+      g_modbus_master_config.coalesce_gap = (uint8_t)gap;
+      g_persist_config.modbus_master.coalesce_gap = (uint8_t)gap;
+    }
+    if (doc.containsKey("write_combine")) {
+      uint8_t on = doc["write_combine"].as<bool>() ? 1 : 0;
+      g_modbus_master_config.write_combine = on;
+      g_persist_config.modbus_master.write_combine = on;
+    }
+    if (doc.containsKey("write_always")) {
+      // Full list of slave IDs whose writes are sent even when unchanged
+      JsonArray ids = doc["write_always"].as<JsonArray>();
+      for (JsonVariant v : ids) {
+        int id = v.as<int>();
+        if (id < 1 || id > 247) return api_send_error(req, 400, "write_always: slave IDs must be 1-247");
+      }
+      memset(g_persist_config.mb_write_always, 0, sizeof(g_persist_config.mb_write_always));
+      for (JsonVariant v : ids) mb_async_write_always_set((uint8_t)v.as<int>(), (uint8_t)v.as<int>(), true);
+    }
     // Reconfigure if master is enabled
     if (g_modbus_master_config.enabled) {
       modbus_master_reconfigure();
@@ -3956,9 +4439,21 @@ esp_err_t api_handler_logic_settings_post(httpd_req_t *req)
     }
   }
 
+  // FEAT-153: Parallel execution across both cores
+  if (doc.containsKey("parallel")) {
+    bool enabled = doc["parallel"].as<bool>();
+    if (enabled) {
+      g_persist_config.module_flags &= ~MODULE_FLAG_ST_PARALLEL_DISABLED;
+    } else {
+      g_persist_config.module_flags |= MODULE_FLAG_ST_PARALLEL_DISABLED;
+    }
+    st_logic_set_parallel(st_logic_get_state(), enabled);
+  }
+
   JsonDocument resp;
   resp["status"] = 200;
   resp["interval_ms"] = g_persist_config.st_logic_interval_ms;
+  resp["parallel"] = (g_persist_config.module_flags & MODULE_FLAG_ST_PARALLEL_DISABLED) ? false : true;
   resp["message"] = "Logic settings updated";
 
   char buf2[256];
@@ -4088,6 +4583,50 @@ esp_err_t api_handler_system_backup(httpd_req_t *req)
   master["inter_frame_delay"] = g_persist_config.modbus_master.inter_frame_delay;
   master["max_requests_per_cycle"] = g_persist_config.modbus_master.max_requests_per_cycle;
   master["cache_ttl_ms"] = g_persist_config.modbus_master.cache_ttl_ms;
+  master["cache_max_entries"] = g_persist_config.modbus_master.cache_max_entries;
+  master["coalesce"] = g_persist_config.modbus_master.coalesce_enabled ? true : false;
+  master["coalesce_gap"] = g_persist_config.modbus_master.coalesce_gap;
+  master["write_combine"] = g_persist_config.modbus_master.write_combine ? true : false;
+  JsonArray always = master["write_always"].to<JsonArray>();
+  for (uint16_t id = 1; id <= 247; id++) {
+    if (mb_async_write_always((uint8_t)id)) always.add(id);
+  }
+  JsonArray poll = master["poll_groups"].to<JsonArray>();
+  for (uint8_t i = 0; i < MB_POLL_GROUPS_MAX; i++) {
+    const ModbusPollGroup *pg = &g_persist_config.mb_poll_groups[i];
+    if (pg->slave_id == 0) continue;
+    JsonObject g = poll.add<JsonObject>();
+    g["id"] = i + 1;
+    g["enabled"] = pg->enabled ? true : false;
+    g["slave"] = pg->slave_id;
+    g["fc"] = pg->fc;
+    g["start"] = pg->start;
+    g["count"] = pg->count;
+    g["period_ms"] = pg->period_ms;
+    g["priority"] = pg->priority;
+  }
+  JsonArray buses = master["buses"].to<JsonArray>();
+  for (uint8_t i = 0; i < MB_BUS_MAX - 1; i++) {
+    const ModbusBusConfig *bc = &g_persist_config.mb_buses[i];
+    JsonObject b = buses.add<JsonObject>();
+    b["bus"] = i + 1;
+    b["enabled"] = bc->enabled ? true : false;
+    b["baudrate"] = bc->baudrate;
+    b["parity"] = bc->parity;
+    b["stop_bits"] = bc->stop_bits;
+    b["timeout_ms"] = bc->timeout_ms;
+    b["inter_frame_delay"] = bc->inter_frame_delay;
+  }
+  JsonArray routes = master["routes"].to<JsonArray>();
+  for (uint8_t i = 0; i < MB_BUS_ROUTES_MAX; i++) {
+    const ModbusBusRoute *r = &g_persist_config.mb_bus_routes[i];
+    if (r->first_slave == 0) continue;
+    JsonObject o = routes.add<JsonObject>();
+    o["id"] = i + 1;
+    o["first_slave"] = r->first_slave;
+    o["last_slave"] = r->last_slave;
+    o["bus"] = r->bus;
+  }
 
   // ── ANALOG OUTPUTS ──
   doc["ao1_mode"] = g_persist_config.ao1_mode;
@@ -4167,6 +4706,13 @@ esp_err_t api_handler_system_backup(httpd_req_t *req)
   ntp["timezone"] = g_persist_config.ntp.timezone;
   ntp["sync_interval_min"] = g_persist_config.ntp.sync_interval_min;
 
+  // ── MODBUS TCP ──
+  JsonObject mbtcp = doc["modbus_tcp"].to<JsonObject>();
+  mbtcp["enabled"] = g_persist_config.modbus_tcp.enabled ? true : false;
+  mbtcp["port"] = g_persist_config.modbus_tcp.port;
+  mbtcp["max_clients"] = g_persist_config.modbus_tcp.max_clients;
+  mbtcp["idle_timeout_s"] = g_persist_config.modbus_tcp.idle_timeout_s;
+
   // ── MISC ──
   doc["remote_echo"] = g_persist_config.remote_echo ? true : false;
   doc["gpio2_user_mode"] = g_persist_config.gpio2_user_mode ? true : false;
@@ -4481,6 +5027,7 @@ esp_err_t api_handler_system_restore(httpd_req_t *req)
     if (s.containsKey("parity")) g_persist_config.modbus_slave.parity = s["parity"];
     if (s.containsKey("stop_bits")) g_persist_config.modbus_slave.stop_bits = s["stop_bits"];
     if (s.containsKey("inter_frame_delay")) g_persist_config.modbus_slave.inter_frame_delay = s["inter_frame_delay"];
+    modbus_server_apply_line_config();
   }
 
   // ── RESTORE MODBUS MASTER ──
@@ -4494,6 +5041,72 @@ esp_err_t api_handler_system_restore(httpd_req_t *req)
     if (m.containsKey("inter_frame_delay")) g_persist_config.modbus_master.inter_frame_delay = m["inter_frame_delay"];
     if (m.containsKey("max_requests_per_cycle")) g_persist_config.modbus_master.max_requests_per_cycle = m["max_requests_per_cycle"];
     if (m.containsKey("cache_ttl_ms")) g_persist_config.modbus_master.cache_ttl_ms = m["cache_ttl_ms"];
+    if (m.containsKey("cache_max_entries")) {
+      uint16_t n = m["cache_max_entries"];
+      if (n >= 1 && n <= MB_CACHE_MAX_ENTRIES) g_persist_config.modbus_master.cache_max_entries = n;
+    }
+    if (m.containsKey("coalesce")) g_persist_config.modbus_master.coalesce_enabled = m["coalesce"].as<bool>() ? 1 : 0;
+    if (m.containsKey("coalesce_gap")) {
+      uint8_t gap = m["coalesce_gap"];
+      if (gap <= MB_COALESCE_MAX_GAP) g_persist_config.modbus_master.coalesce_gap = gap;
+    }
+    if (m.containsKey("write_combine")) g_persist_config.modbus_master.write_combine = m["write_combine"].as<bool>() ? 1 : 0;
+    if (m.containsKey("write_always")) {
+      memset(g_persist_config.mb_write_always, 0, sizeof(g_persist_config.mb_write_always));
+      for (JsonVariant v : m["write_always"].as<JsonArray>()) {
+        int id = v.as<int>();
+        if (id >= 1 && id <= 247) mb_async_write_always_set((uint8_t)id, (uint8_t)id, true);
+      }
+    }
+    if (m.containsKey("poll_groups")) {
+      memset(g_persist_config.mb_poll_groups, 0, sizeof(g_persist_config.mb_poll_groups));
+      JsonArray poll = m["poll_groups"].as<JsonArray>();
+      for (JsonObject g : poll) {
+        int id = g["id"] | 0;
+        if (id < 1 || id > MB_POLL_GROUPS_MAX) continue;
+        ModbusPollGroup pg;
+        memset(&pg, 0, sizeof(pg));
+        pg.enabled = (g["enabled"] | true) ? 1 : 0;
+        pg.slave_id = g["slave"] | 0;
+        pg.fc = g["fc"] | 0;
+        pg.start = g["start"] | 0;
+        pg.count = g["count"] | 0;
+        pg.period_ms = g["period_ms"] | 0;
+        pg.priority = g["priority"] | 0;
+        if (mb_poll_group_valid(&pg)) g_persist_config.mb_poll_groups[id - 1] = pg;
+      }
+      mb_async_poll_load(g_persist_config.mb_poll_groups);
+    }
+    if (m.containsKey("buses")) {
+      // Persisted only — the bus UART starts after save + reboot (pins are restored below)
+      JsonArray buses = m["buses"].as<JsonArray>();
+      for (JsonObject b : buses) {
+        int bus = b["bus"] | 0;
+        if (bus < 1 || bus >= MB_BUS_MAX) continue;
+        ModbusBusConfig bc;
+        bc.enabled = (b["enabled"] | false) ? 1 : 0;
+        bc.baudrate = b["baudrate"] | (uint32_t)MODBUS_MASTER_DEFAULT_BAUDRATE;
+        bc.parity = b["parity"] | 0;
+        bc.stop_bits = b["stop_bits"] | 1;
+        bc.timeout_ms = b["timeout_ms"] | MODBUS_MASTER_DEFAULT_TIMEOUT;
+        bc.inter_frame_delay = b["inter_frame_delay"] | 0;
+        if (mb_bus_config_valid(&bc)) g_persist_config.mb_buses[bus - 1] = bc;
+      }
+    }
+    if (m.containsKey("routes")) {
+      memset(g_persist_config.mb_bus_routes, 0, sizeof(g_persist_config.mb_bus_routes));
+      JsonArray routes = m["routes"].as<JsonArray>();
+      for (JsonObject o : routes) {
+        int id = o["id"] | 0;
+        if (id < 1 || id > MB_BUS_ROUTES_MAX) continue;
+        ModbusBusRoute r;
+        r.first_slave = o["first_slave"] | 0;
+        r.last_slave = o["last_slave"] | 0;
+        r.bus = o["bus"] | 0;
+        if (mb_bus_route_valid(&r)) g_persist_config.mb_bus_routes[id - 1] = r;
+      }
+      mb_async_route_load(g_persist_config.mb_bus_routes);
+    }
   }
 
   // ── RESTORE HOSTNAME ──
@@ -4584,6 +5197,18 @@ esp_err_t api_handler_system_restore(httpd_req_t *req)
     }
   }
 
+  // ── RESTORE MODBUS TCP ──
+  if (doc.containsKey("modbus_tcp")) {
+    JsonObject t = doc["modbus_tcp"];
+    if (t.containsKey("enabled"))        g_persist_config.modbus_tcp.enabled = t["enabled"].as<bool>() ? 1 : 0;
+    if (t.containsKey("port"))           g_persist_config.modbus_tcp.port = t["port"];
+    if (t.containsKey("max_clients")) {
+      uint8_t mc = t["max_clients"].as<uint8_t>();
+      if (mc >= 1 && mc <= MODBUS_TCP_MAX_CLIENTS) g_persist_config.modbus_tcp.max_clients = mc;
+    }
+    if (t.containsKey("idle_timeout_s")) g_persist_config.modbus_tcp.idle_timeout_s = t["idle_timeout_s"];
+  }
+
   // ── RESTORE MISC ──
   if (doc.containsKey("remote_echo")) g_persist_config.remote_echo = doc["remote_echo"];
   if (doc.containsKey("gpio2_user_mode")) g_persist_config.gpio2_user_mode = doc["gpio2_user_mode"];
@@ -5212,14 +5837,15 @@ esp_err_t api_handler_hr_bulk_read(httpd_req_t *req)
   int start = api_parse_query_int(req, "start", 0);
   int count = api_parse_query_int(req, "count", 10);
 
-  if (start < 0 || start >= HOLDING_REGS_SIZE) {
-    return api_send_error(req, 400, "Invalid start address");
-  }
   if (count < 1 || count > 200) {
     return api_send_error(req, 400, "Count must be 1-200");
   }
-  if (start + count > HOLDING_REGS_SIZE) {
-    count = HOLDING_REGS_SIZE - start;
+  // Clip to the registers present from start: flat array or mapped pages (v7.9.8.22)
+  if (start >= 0 && start <= 0xFFFF) {
+    count = registers_holding_span(start, count);
+  }
+  if (start < 0 || start > 0xFFFF || count == 0) {
+    return api_send_error(req, 400, "Invalid start address");
   }
 
   // Allocate on heap: ~25 bytes per register entry in JSON
@@ -5229,9 +5855,13 @@ esp_err_t api_handler_hr_bulk_read(httpd_req_t *req)
     return api_send_error(req, 500, "Out of memory");
   }
 
+  // One seqlocked snapshot: 32/64-bit values in the range are never torn (v7.9.8.20)
+  uint16_t vals[200];
+  registers_snapshot_holding(start, count, vals);
+
   int pos = snprintf(buf, buf_size, "{\"start\":%d,\"count\":%d,\"registers\":[", start, count);
   for (int i = 0; i < count && pos < (int)buf_size - 32; i++) {
-    uint16_t val = registers_get_holding_register(start + i);
+    uint16_t val = vals[i];
     if (i > 0) buf[pos++] = ',';
     pos += snprintf(buf + pos, buf_size - pos, "{\"addr\":%d,\"value\":%u}", start + i, val);
   }
@@ -5278,7 +5908,7 @@ esp_err_t api_handler_hr_bulk_write(httpd_req_t *req)
   int written = 0;
   for (JsonObject w : writes) {
     int addr = w["addr"] | -1;
-    if (addr < 0 || addr >= HOLDING_REGS_SIZE) continue;
+    if (addr < 0 || addr > 0xFFFF || registers_holding_span(addr, 1) != 1) continue;
     uint16_t val = w["value"] | 0;
     registers_set_holding_register(addr, val);
     written++;
@@ -5301,14 +5931,15 @@ esp_err_t api_handler_ir_bulk_read(httpd_req_t *req)
   int start = api_parse_query_int(req, "start", 0);
   int count = api_parse_query_int(req, "count", 10);
 
-  if (start < 0 || start >= INPUT_REGS_SIZE) {
-    return api_send_error(req, 400, "Invalid start address");
-  }
   if (count < 1 || count > 200) {
     return api_send_error(req, 400, "Count must be 1-200");
   }
-  if (start + count > INPUT_REGS_SIZE) {
-    count = INPUT_REGS_SIZE - start;
+  // Clip to the registers present from start: flat array or mapped pages (v7.9.8.22)
+  if (start >= 0 && start <= 0xFFFF) {
+    count = registers_input_span(start, count);
+  }
+  if (start < 0 || start > 0xFFFF || count == 0) {
+    return api_send_error(req, 400, "Invalid start address");
   }
 
   size_t buf_size = (size_t)count * 30 + 128;
@@ -5317,9 +5948,13 @@ esp_err_t api_handler_ir_bulk_read(httpd_req_t *req)
     return api_send_error(req, 500, "Out of memory");
   }
 
+  // One seqlocked snapshot: 32/64-bit values in the range are never torn (v7.9.8.20)
+  uint16_t vals[200];
+  registers_snapshot_input(start, count, vals);
+
   int pos = snprintf(buf, buf_size, "{\"start\":%d,\"count\":%d,\"registers\":[", start, count);
   for (int i = 0; i < count && pos < (int)buf_size - 32; i++) {
-    uint16_t val = registers_get_input_register(start + i);
+    uint16_t val = vals[i];
     if (i > 0) buf[pos++] = ',';
     pos += snprintf(buf + pos, buf_size - pos, "{\"addr\":%d,\"value\":%u}", start + i, val);
   }
@@ -5330,6 +5965,55 @@ esp_err_t api_handler_ir_bulk_read(httpd_req_t *req)
   return ret;
 }
 
+/* ============================================================================
+ * GET /api/registers/map — Sparse HR/IR pages (v7.9.8.22)
+ * ============================================================================ */
+
+esp_err_t api_handler_registers_map(httpd_req_t *req)
+{
+  http_server_stat_request();
+  CHECK_AUTH(req);
+
+  uint16_t mapped = 0, max_pages = 0;
+  registers_page_stats(&mapped, &max_pages);
+
+  JsonDocument doc;
+  doc["page_words"] = REG_PAGE_WORDS;
+  doc["pages_mapped"] = mapped;
+  doc["pages_max"] = max_pages;
+  doc["flat_hr"] = HOLDING_REGS_SIZE;
+  doc["flat_ir"] = INPUT_REGS_SIZE;
+
+  JsonArray declared = doc["declared"].to<JsonArray>();
+  for (uint8_t i = 0; i < REG_PAGE_DECL_MAX; i++) {
+    const RegPageDecl *decl = &g_persist_config.reg_pages[i];
+    if (decl->count == 0) continue;
+    JsonObject d = declared.add<JsonObject>();
+    d["bank"] = (decl->bank == REG_BANK_IR) ? "ir" : "hr";
+    d["start"] = decl->start;
+    d["count"] = decl->count;
+  }
+
+  uint16_t pages[REG_PAGE_POOL_MAX];
+  const reg_bank_t banks[2] = { REG_BANK_HR, REG_BANK_IR };
+  for (uint8_t b = 0; b < 2; b++) {
+    JsonArray list = doc[b == 0 ? "pages_hr" : "pages_ir"].to<JsonArray>();
+    uint16_t n = registers_page_list(banks[b], pages, REG_PAGE_POOL_MAX);
+    for (uint16_t i = 0; i < n; i++) list.add(pages[i]);
+  }
+
+  const size_t BUF_SIZE = 2048;  // 64 pages + 16 declarations fit with room to spare
+  char *buf = (char *)malloc(BUF_SIZE);
+  if (!buf) {
+    return api_send_error(req, 500, "Out of memory");
+  }
+  serializeJson(doc, buf, BUF_SIZE);
+
+  esp_err_t ret = api_send_json(req, buf);
+  free(buf);
+  return ret;
+}
+
 /* ============================================================================
  * FEAT-021: Bulk coils read — GET /api/registers/coils (with ?start=&count=)
  * ============================================================================ */
@@ -5725,13 +6409,13 @@ esp_err_t api_handler_metrics(httpd_req_t *req)
     return api_send_error(req, 429, "Too many requests");
   }
 
-  // Buffer for Prometheus text format (12KB for expanded metrics incl. tasks/cache)
-  char *buf = (char *)malloc(12288);
+  // Buffer for Prometheus text format (24KB: tasks/cache/ST scan + Modbus master profile histograms)
+  char *buf = (char *)malloc(24576);
   if (!buf) {
     return api_send_error(req, 500, "Out of memory");
   }
   int pos = 0;
-  int remaining = 12288;
+  int remaining = 24576;
 
   #define PROM_APPEND(...) do { \
     int n = snprintf(buf + pos, remaining, __VA_ARGS__); \
@@ -5820,6 +6504,27 @@ esp_err_t api_handler_metrics(httpd_req_t *req)
   PROM_APPEND("# TYPE modbus_slave_exceptions_total counter\n");
   PROM_APPEND("modbus_slave_exceptions_total %lu\n", g_persist_config.modbus_slave.exception_errors);
 
+  // --- Modbus Slave response latency histogram (v7.9.8.2) ---
+  {
+    static const uint32_t bounds_us[MODBUS_SERVER_LATENCY_BUCKETS - 1] = MODBUS_SERVER_LATENCY_BOUNDS_US;
+    const ModbusServerLatencyStats *lat = modbus_server_get_latency_stats();
+    PROM_APPEND("# HELP modbus_slave_response_latency_seconds Frame end to response TX start\n");
+    PROM_APPEND("# TYPE modbus_slave_response_latency_seconds histogram\n");
+    uint32_t cumulative = 0;
+    for (int b = 0; b < MODBUS_SERVER_LATENCY_BUCKETS - 1; b++) {
+      cumulative += lat->bucket[b];
+      PROM_APPEND("modbus_slave_response_latency_seconds_bucket{le=\"%.4f\"} %lu\n",
+                  bounds_us[b] / 1000000.0, (unsigned long)cumulative);
+    }
+    PROM_APPEND("modbus_slave_response_latency_seconds_bucket{le=\"+Inf\"} %lu\n", (unsigned long)lat->count);
+    PROM_APPEND("modbus_slave_response_latency_seconds_sum %.6f\n", lat->sum_us / 1000000.0);
+    PROM_APPEND("modbus_slave_response_latency_seconds_count %lu\n", (unsigned long)lat->count);
+
+    PROM_APPEND("# HELP modbus_slave_response_latency_max_us Worst-case response latency\n");
+    PROM_APPEND("# TYPE modbus_slave_response_latency_max_us gauge\n");
+    PROM_APPEND("modbus_slave_response_latency_max_us %lu\n", (unsigned long)lat->max_us);
+  }
+
   // --- Heap detailed metrics ---
   PROM_APPEND("# HELP esp32_heap_largest_free_block Largest contiguous free heap block\n");
   PROM_APPEND("# TYPE esp32_heap_largest_free_block gauge\n");
@@ -5865,6 +6570,29 @@ esp_err_t api_handler_metrics(httpd_req_t *req)
   PROM_APPEND("# TYPE modbus_master_exception_errors_total counter\n");
   PROM_APPEND("modbus_master_exception_errors_total %lu\n", g_modbus_master_config.exception_errors);
 
+  // --- Modbus Master response wait (v7.9.8.13) ---
+  {
+    const ModbusMasterWaitStats *ws = modbus_master_get_wait_stats(0);
+    PROM_APPEND("# HELP modbus_master_hw_rs485 DE driven by the UART in RS485 half-duplex mode (1=yes, 0=GPIO)\n");
+    PROM_APPEND("# TYPE modbus_master_hw_rs485 gauge\n");
+    PROM_APPEND("modbus_master_hw_rs485 %d\n", ws->hw_rs485 ? 1 : 0);
+    PROM_APPEND("# HELP modbus_master_rx_events_total UART RX events that woke a waiting transaction\n");
+    PROM_APPEND("# TYPE modbus_master_rx_events_total counter\n");
+    PROM_APPEND("modbus_master_rx_events_total %lu\n", (unsigned long)ws->rx_events);
+    PROM_APPEND("# HELP modbus_master_wait_ms_total Time transactions spent blocked on TX drain / RX events\n");
+    PROM_APPEND("# TYPE modbus_master_wait_ms_total counter\n");
+    PROM_APPEND("modbus_master_wait_ms_total %lu\n", (unsigned long)(ws->wait_us / 1000));
+    PROM_APPEND("# HELP modbus_master_busy_ms_total Time transactions spent executing on the CPU\n");
+    PROM_APPEND("# TYPE modbus_master_busy_ms_total counter\n");
+    PROM_APPEND("modbus_master_busy_ms_total %lu\n", (unsigned long)(ws->busy_us / 1000));
+    int load = modbus_master_get_core_load();
+    if (load >= 0) {
+      PROM_APPEND("# HELP esp32_core0_load_percent Core 0 load from the idle task run-time counter (1 s window)\n");
+      PROM_APPEND("# TYPE esp32_core0_load_percent gauge\n");
+      PROM_APPEND("esp32_core0_load_percent %d\n", load);
+    }
+  }
+
   // --- Modbus Master Async Cache metrics ---
   const mb_async_state_t *mb_async = mb_async_get_state();
   if (mb_async && mb_async->task_running) {
@@ -5876,7 +6604,13 @@ esp_err_t api_handler_metrics(httpd_req_t *req)
     PROM_APPEND("modbus_master_cache_misses %lu\n", (unsigned long)mb_async->cache_misses);
     PROM_APPEND("# HELP modbus_master_cache_entries Active cache entries\n");
     PROM_APPEND("# TYPE modbus_master_cache_entries gauge\n");
-    PROM_APPEND("modbus_master_cache_entries %d\n", mb_async->entry_count);
+    PROM_APPEND("modbus_master_cache_entries %u\n", (unsigned)mb_async->entry_count);
+    PROM_APPEND("# HELP modbus_master_cache_capacity Allocated cache entries\n");
+    PROM_APPEND("# TYPE modbus_master_cache_capacity gauge\n");
+    PROM_APPEND("modbus_master_cache_capacity %u\n", (unsigned)mb_async->cache_capacity);
+    PROM_APPEND("# HELP modbus_master_cache_evictions_total Cache LRU evictions\n");
+    PROM_APPEND("# TYPE modbus_master_cache_evictions_total counter\n");
+    PROM_APPEND("modbus_master_cache_evictions_total %lu\n", (unsigned long)mb_async->cache_evictions);
     PROM_APPEND("# HELP modbus_master_queue_full_count Queue full rejections\n");
     PROM_APPEND("# TYPE modbus_master_queue_full_count counter\n");
     PROM_APPEND("modbus_master_queue_full_count %lu\n", (unsigned long)mb_async->queue_full_count);
@@ -5889,6 +6623,54 @@ esp_err_t api_handler_metrics(httpd_req_t *req)
     PROM_APPEND("# HELP modbus_master_priority_drops Requests dropped by priority eviction\n");
     PROM_APPEND("# TYPE modbus_master_priority_drops counter\n");
     PROM_APPEND("modbus_master_priority_drops %lu\n", (unsigned long)mb_async->priority_drops);
+    PROM_APPEND("# HELP modbus_master_queue_contention_total Lost CAS races between queue producers\n");
+    PROM_APPEND("# TYPE modbus_master_queue_contention_total counter\n");
+    PROM_APPEND("modbus_master_queue_contention_total %lu\n", (unsigned long)mb_async->queue_contention);
+    PROM_APPEND("# HELP modbus_master_queue_dedup_total Reads skipped because the same read was already in flight\n");
+    PROM_APPEND("# TYPE modbus_master_queue_dedup_total counter\n");
+    PROM_APPEND("modbus_master_queue_dedup_total %lu\n", (unsigned long)mb_async->queue_dedup);
+    PROM_APPEND("# HELP modbus_master_queue_class_depth Queued requests per priority class\n");
+    PROM_APPEND("# TYPE modbus_master_queue_class_depth gauge\n");
+    {
+      static const char *const prio_names[MB_PRIO_COUNT] = {"write", "read_fresh", "read_refresh"};
+      for (uint8_t c = 0; c < MB_PRIO_COUNT; c++) {
+        PROM_APPEND("modbus_master_queue_class_depth{class=\"%s\"} %u\n", prio_names[c],
+                    (unsigned)mb_async->pq_ring[c].count);
+      }
+    }
+    PROM_APPEND("# HELP modbus_master_payload_slots_in_use Referenced multi-register payload slots\n");
+    PROM_APPEND("# TYPE modbus_master_payload_slots_in_use gauge\n");
+    PROM_APPEND("modbus_master_payload_slots_in_use %u\n", (unsigned)mb_payload_in_use());
+    PROM_APPEND("# HELP modbus_master_payload_slots_total Size of the multi-register payload pool\n");
+    PROM_APPEND("# TYPE modbus_master_payload_slots_total gauge\n");
+    PROM_APPEND("modbus_master_payload_slots_total %u\n", (unsigned)MB_PAYLOAD_SLOTS);
+    PROM_APPEND("# HELP modbus_master_payload_alloc_failures_total Multi-register operations rejected because the payload pool was full\n");
+    PROM_APPEND("# TYPE modbus_master_payload_alloc_failures_total counter\n");
+    PROM_APPEND("modbus_master_payload_alloc_failures_total %lu\n", (unsigned long)mb_payload_alloc_failures());
+    PROM_APPEND("# HELP modbus_master_coalesced_blocks_total Block reads that replaced several single reads\n");
+    PROM_APPEND("# TYPE modbus_master_coalesced_blocks_total counter\n");
+    PROM_APPEND("modbus_master_coalesced_blocks_total %lu\n", (unsigned long)mb_async->coalesced_blocks);
+    PROM_APPEND("# HELP modbus_master_coalesced_reads_total Single reads served by block reads\n");
+    PROM_APPEND("# TYPE modbus_master_coalesced_reads_total counter\n");
+    PROM_APPEND("modbus_master_coalesced_reads_total %lu\n", (unsigned long)mb_async->coalesced_reads);
+    PROM_APPEND("# HELP modbus_master_coalesce_fallbacks_total Block reads rejected by the slave and re-read singly\n");
+    PROM_APPEND("# TYPE modbus_master_coalesce_fallbacks_total counter\n");
+    PROM_APPEND("modbus_master_coalesce_fallbacks_total %lu\n", (unsigned long)mb_async->coalesce_fallbacks);
+    PROM_APPEND("# HELP modbus_master_bus_time_saved_seconds_total Estimated RTU bus time saved by read coalescing\n");
+    PROM_APPEND("# TYPE modbus_master_bus_time_saved_seconds_total counter\n");
+    PROM_APPEND("modbus_master_bus_time_saved_seconds_total %.6f\n", mb_async->coalesce_saved_us / 1e6);
+    PROM_APPEND("# HELP modbus_master_writes_combined_total Writes absorbed by a pending write to the same address\n");
+    PROM_APPEND("# TYPE modbus_master_writes_combined_total counter\n");
+    PROM_APPEND("modbus_master_writes_combined_total %lu\n", (unsigned long)mb_async->write_combined);
+    PROM_APPEND("# HELP modbus_master_writes_skipped_total Writes skipped because the value was already confirmed\n");
+    PROM_APPEND("# TYPE modbus_master_writes_skipped_total counter\n");
+    PROM_APPEND("modbus_master_writes_skipped_total %lu\n", (unsigned long)mb_async->write_skipped);
+    PROM_APPEND("# HELP modbus_master_write_blocks_total FC15/FC16 block writes that replaced several single writes\n");
+    PROM_APPEND("# TYPE modbus_master_write_blocks_total counter\n");
+    PROM_APPEND("modbus_master_write_blocks_total %lu\n", (unsigned long)mb_async->write_blocks);
+    PROM_APPEND("# HELP modbus_master_write_block_members_total Single writes served by block writes\n");
+    PROM_APPEND("# TYPE modbus_master_write_block_members_total counter\n");
+    PROM_APPEND("modbus_master_write_block_members_total %lu\n", (unsigned long)mb_async->write_block_members);
     PROM_APPEND("# HELP modbus_master_cache_hit_rate Cache hit rate percent\n");
     PROM_APPEND("# TYPE modbus_master_cache_hit_rate gauge\n");
     {
@@ -5899,7 +6681,7 @@ esp_err_t api_handler_metrics(httpd_req_t *req)
     PROM_APPEND("# HELP modbus_master_cache_utilization Cache slot utilization percent\n");
     PROM_APPEND("# TYPE modbus_master_cache_utilization gauge\n");
     PROM_APPEND("modbus_master_cache_utilization %u\n",
-                (unsigned)(mb_async->entry_count * 100 / MB_CACHE_MAX_ENTRIES));
+                mb_async->cache_capacity > 0 ? (unsigned)(mb_async->entry_count * 100u / mb_async->cache_capacity) : 0u);
     PROM_APPEND("# HELP modbus_master_cache_ttl_ms Cache entry TTL in ms (0=never expire)\n");
     PROM_APPEND("# TYPE modbus_master_cache_ttl_ms gauge\n");
     PROM_APPEND("modbus_master_cache_ttl_ms %u\n", (unsigned)g_modbus_master_config.cache_ttl_ms);
@@ -5907,8 +6689,9 @@ esp_err_t api_handler_metrics(httpd_req_t *req)
     // Per-slave cache entries with status
     PROM_APPEND("# HELP modbus_master_slave_status Per-slave cache entry status\n");
     PROM_APPEND("# TYPE modbus_master_slave_status gauge\n");
-    for (int i = 0; i < mb_async->entry_count && i < MB_CACHE_MAX_ENTRIES; i++) {
-      const mb_cache_entry_t *e = &mb_async->entries[i];
+    mb_cache_entry_t entry;
+    for (uint16_t i = 0; mb_cache_entry_at(mb_async, i, &entry); i++) {
+      const mb_cache_entry_t *e = &entry;
       if (e->status != MB_CACHE_EMPTY) {
         const char *st = (e->status == MB_CACHE_VALID) ? "valid" :
                          (e->status == MB_CACHE_PENDING) ? "pending" :
@@ -5920,6 +6703,43 @@ esp_err_t api_handler_metrics(httpd_req_t *req)
                      (e->status == MB_CACHE_VALID) ? 1 : (e->status == MB_CACHE_ERROR) ? -1 : 0);
       }
     }
+    // Poll groups (v7.9.8.12)
+    PROM_APPEND("# HELP modbus_master_poll_total Poll group transactions\n");
+    PROM_APPEND("# TYPE modbus_master_poll_total counter\n");
+    for (int i = 0; i < MB_POLL_GROUPS_MAX; i++) {
+      const mb_poll_state_t *ps = mb_async_poll_state(i);
+      if (!ps->cfg.enabled) continue;
+      PROM_APPEND("modbus_master_poll_total{group=\"%d\",slave=\"%d\",fc=\"%d\"} %lu\n", i + 1,
+                  ps->cfg.slave_id, ps->cfg.fc, (unsigned long)ps->polls);
+    }
+    PROM_APPEND("# HELP modbus_master_poll_errors_total Poll group transactions that failed\n");
+    PROM_APPEND("# TYPE modbus_master_poll_errors_total counter\n");
+    for (int i = 0; i < MB_POLL_GROUPS_MAX; i++) {
+      const mb_poll_state_t *ps = mb_async_poll_state(i);
+      if (!ps->cfg.enabled) continue;
+      PROM_APPEND("modbus_master_poll_errors_total{group=\"%d\"} %lu\n", i + 1, (unsigned long)ps->errors);
+    }
+    PROM_APPEND("# HELP modbus_master_poll_missed_total Poll periods dropped (overload or slave backoff)\n");
+    PROM_APPEND("# TYPE modbus_master_poll_missed_total counter\n");
+    for (int i = 0; i < MB_POLL_GROUPS_MAX; i++) {
+      const mb_poll_state_t *ps = mb_async_poll_state(i);
+      if (!ps->cfg.enabled) continue;
+      PROM_APPEND("modbus_master_poll_missed_total{group=\"%d\"} %lu\n", i + 1, (unsigned long)ps->missed);
+    }
+    PROM_APPEND("# HELP modbus_master_poll_rate_hz Achieved poll rate per group\n");
+    PROM_APPEND("# TYPE modbus_master_poll_rate_hz gauge\n");
+    for (int i = 0; i < MB_POLL_GROUPS_MAX; i++) {
+      const mb_poll_state_t *ps = mb_async_poll_state(i);
+      if (!ps->cfg.enabled) continue;
+      PROM_APPEND("modbus_master_poll_rate_hz{group=\"%d\"} %.3f\n", i + 1, mb_poll_rate_hz(ps));
+    }
+    PROM_APPEND("# HELP modbus_master_poll_lateness_max_ms Worst start delay after the deadline per group\n");
+    PROM_APPEND("# TYPE modbus_master_poll_lateness_max_ms gauge\n");
+    for (int i = 0; i < MB_POLL_GROUPS_MAX; i++) {
+      const mb_poll_state_t *ps = mb_async_poll_state(i);
+      if (!ps->cfg.enabled) continue;
+      PROM_APPEND("modbus_master_poll_lateness_max_ms{group=\"%d\"} %lu\n", i + 1, (unsigned long)ps->late_max_ms);
+    }
     // Per-slave adaptive backoff status
     PROM_APPEND("# HELP modbus_master_slave_backoff Per-slave adaptive backoff delay in ms\n");
     PROM_APPEND("# TYPE modbus_master_slave_backoff gauge\n");
@@ -5932,6 +6752,55 @@ esp_err_t api_handler_metrics(httpd_req_t *req)
                      mb_async->slave_backoff[i].backoff_ms);
       }
     }
+
+    // Per-bus metrics (v7.9.8.14) — the unlabeled totals above are bus 0
+    PROM_APPEND("# HELP modbus_master_bus_up Bus worker task running\n");
+    PROM_APPEND("# TYPE modbus_master_bus_up gauge\n");
+    for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+      PROM_APPEND("modbus_master_bus_up{bus=\"%u\"} %d\n", bus, mb_async_get_bus_state(bus)->task_running ? 1 : 0);
+    }
+    PROM_APPEND("# HELP modbus_master_bus_queue_depth Current queue depth per bus\n");
+    PROM_APPEND("# TYPE modbus_master_bus_queue_depth gauge\n");
+    for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+      PROM_APPEND("modbus_master_bus_queue_depth{bus=\"%u\"} %u\n", bus, (unsigned)mb_async_get_bus_state(bus)->pq_count);
+    }
+    PROM_APPEND("# HELP modbus_master_bus_queue_drops_total Requests dropped (queue full + priority eviction) per bus\n");
+    PROM_APPEND("# TYPE modbus_master_bus_queue_drops_total counter\n");
+    for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+      const mb_async_state_t *bs = mb_async_get_bus_state(bus);
+      PROM_APPEND("modbus_master_bus_queue_drops_total{bus=\"%u\"} %lu\n", bus,
+                  (unsigned long)(bs->queue_full_count + bs->priority_drops));
+    }
+    PROM_APPEND("# HELP modbus_master_bus_queue_contention_total Lost CAS races between queue producers per bus\n");
+    PROM_APPEND("# TYPE modbus_master_bus_queue_contention_total counter\n");
+    for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+      PROM_APPEND("modbus_master_bus_queue_contention_total{bus=\"%u\"} %lu\n", bus,
+                  (unsigned long)mb_async_get_bus_state(bus)->queue_contention);
+    }
+    PROM_APPEND("# HELP modbus_master_bus_requests_total Async requests per bus\n");
+    PROM_APPEND("# TYPE modbus_master_bus_requests_total counter\n");
+    for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+      PROM_APPEND("modbus_master_bus_requests_total{bus=\"%u\"} %lu\n", bus,
+                  (unsigned long)mb_async_get_bus_state(bus)->total_requests);
+    }
+    PROM_APPEND("# HELP modbus_master_bus_errors_total Failed async requests per bus\n");
+    PROM_APPEND("# TYPE modbus_master_bus_errors_total counter\n");
+    for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+      PROM_APPEND("modbus_master_bus_errors_total{bus=\"%u\"} %lu\n", bus,
+                  (unsigned long)mb_async_get_bus_state(bus)->total_errors);
+    }
+    PROM_APPEND("# HELP modbus_master_bus_timeouts_total Timed out async requests per bus\n");
+    PROM_APPEND("# TYPE modbus_master_bus_timeouts_total counter\n");
+    for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+      PROM_APPEND("modbus_master_bus_timeouts_total{bus=\"%u\"} %lu\n", bus,
+                  (unsigned long)mb_async_get_bus_state(bus)->total_timeouts);
+    }
+    PROM_APPEND("# HELP modbus_master_bus_cache_entries Active cache entries per bus shard\n");
+    PROM_APPEND("# TYPE modbus_master_bus_cache_entries gauge\n");
+    for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+      PROM_APPEND("modbus_master_bus_cache_entries{bus=\"%u\"} %u\n", bus,
+                  (unsigned)mb_async_get_bus_state(bus)->entry_count);
+    }
   }
 
   // --- SSE metrics ---
@@ -6061,6 +6930,61 @@ esp_err_t api_handler_metrics(httpd_req_t *req)
                      i + 1, prog->name, (unsigned long)prog->overrun_count);
       }
     }
+
+    // --- ST scan scheduling: start jitter + overrun histograms (v7.9.8.9) ---
+    static const uint32_t scan_bounds_us[ST_LOGIC_SCAN_BUCKETS - 1] = ST_LOGIC_SCAN_BOUNDS_US;
+    static const char *const scan_hist_name[2] = { "st_logic_scan_jitter_seconds", "st_logic_scan_overrun_seconds" };
+    static const char *const scan_hist_help[2] = {
+      "Scan start minus scheduled due time",
+      "Scan end minus end of its period (late scans only)"
+    };
+
+    for (int h = 0; h < 2; h++) {
+      PROM_APPEND("# HELP %s %s\n", scan_hist_name[h], scan_hist_help[h]);
+      PROM_APPEND("# TYPE %s histogram\n", scan_hist_name[h]);
+      for (int i = 0; i < ST_LOGIC_MAX_PROGRAMS; i++) {
+        st_logic_program_config_t *prog = st_logic_get_program(logic_state, i);
+        if (!prog || !prog->enabled) continue;
+        const st_logic_scan_stats_t *scan = &prog->scan;
+        const uint32_t *bucket = (h == 0) ? scan->jitter_bucket : scan->overrun_bucket;
+        uint32_t count = (h == 0) ? scan->jitter_count : scan->overrun_count;
+        uint64_t sum_us = (h == 0) ? scan->jitter_sum_us : scan->overrun_sum_us;
+
+        uint32_t cumulative = 0;
+        for (int b = 0; b < ST_LOGIC_SCAN_BUCKETS - 1; b++) {
+          cumulative += bucket[b];
+          PROM_APPEND("%s_bucket{slot=\"%d\",name=\"%s\",le=\"%.4f\"} %lu\n",
+                      scan_hist_name[h], i + 1, prog->name, scan_bounds_us[b] / 1000000.0,
+                      (unsigned long)cumulative);
+        }
+        PROM_APPEND("%s_bucket{slot=\"%d\",name=\"%s\",le=\"+Inf\"} %lu\n",
+                    scan_hist_name[h], i + 1, prog->name, (unsigned long)count);
+        PROM_APPEND("%s_sum{slot=\"%d\",name=\"%s\"} %.6f\n",
+                    scan_hist_name[h], i + 1, prog->name, sum_us / 1000000.0);
+        PROM_APPEND("%s_count{slot=\"%d\",name=\"%s\"} %lu\n",
+                    scan_hist_name[h], i + 1, prog->name, (unsigned long)count);
+      }
+    }
+
+    PROM_APPEND("# HELP st_logic_scan_jitter_max_us Worst-case scan start jitter\n");
+    PROM_APPEND("# TYPE st_logic_scan_jitter_max_us gauge\n");
+    for (int i = 0; i < ST_LOGIC_MAX_PROGRAMS; i++) {
+      st_logic_program_config_t *prog = st_logic_get_program(logic_state, i);
+      if (prog && prog->enabled) {
+        PROM_APPEND("st_logic_scan_jitter_max_us{slot=\"%d\",name=\"%s\"} %lu\n",
+                    i + 1, prog->name, (unsigned long)prog->scan.jitter_max_us);
+      }
+    }
+
+    PROM_APPEND("# HELP st_logic_scan_skipped_total Scans dropped by the skip policy or catch-up limit\n");
+    PROM_APPEND("# TYPE st_logic_scan_skipped_total counter\n");
+    for (int i = 0; i < ST_LOGIC_MAX_PROGRAMS; i++) {
+      st_logic_program_config_t *prog = st_logic_get_program(logic_state, i);
+      if (prog && prog->enabled) {
+        PROM_APPEND("st_logic_scan_skipped_total{slot=\"%d\",name=\"%s\"} %lu\n",
+                    i + 1, prog->name, (unsigned long)prog->scan.skipped);
+      }
+    }
   }
 
 #ifdef SHIFT_REGISTER_ENABLED
@@ -6082,23 +7006,57 @@ esp_err_t api_handler_metrics(httpd_req_t *req)
 #endif
 
   // --- Modbus Register metrics (non-zero holding & input registers) ---
-  PROM_APPEND("# HELP modbus_holding_register Modbus holding register value\n");
-  PROM_APPEND("# TYPE modbus_holding_register gauge\n");
-  for (int addr = 0; addr < HOLDING_REGS_SIZE; addr++) {
-    uint16_t val = registers_get_holding_register(addr);
-    if (val != 0) {
-      PROM_APPEND("modbus_holding_register{addr=\"%d\"} %u\n", addr, (unsigned)val);
+  // Seqlocked snapshots so a scrape never pairs half of an old and new 32-bit value (v7.9.8.20)
+  uint16_t *prom_regs = (uint16_t *)malloc(INPUT_REGS_SIZE * sizeof(uint16_t));  // INPUT >= HOLDING
+  if (prom_regs) {
+    registers_snapshot_holding(0, HOLDING_REGS_SIZE, prom_regs);
+    PROM_APPEND("# HELP modbus_holding_register Modbus holding register value\n");
+    PROM_APPEND("# TYPE modbus_holding_register gauge\n");
+    for (int addr = 0; addr < HOLDING_REGS_SIZE; addr++) {
+      uint16_t val = prom_regs[addr];
+      if (val != 0) {
+        PROM_APPEND("modbus_holding_register{addr=\"%d\"} %u\n", addr, (unsigned)val);
+      }
     }
-  }
 
-  PROM_APPEND("# HELP modbus_input_register Modbus input register value\n");
-  PROM_APPEND("# TYPE modbus_input_register gauge\n");
-  for (int addr = 0; addr < INPUT_REGS_SIZE; addr++) {
-    uint16_t val = registers_get_input_register(addr);
-    if (val != 0) {
-      PROM_APPEND("modbus_input_register{addr=\"%d\"} %u\n", addr, (unsigned)val);
+    registers_snapshot_input(0, INPUT_REGS_SIZE, prom_regs);
+    PROM_APPEND("# HELP modbus_input_register Modbus input register value\n");
+    PROM_APPEND("# TYPE modbus_input_register gauge\n");
+    for (int addr = 0; addr < INPUT_REGS_SIZE; addr++) {
+      uint16_t val = prom_regs[addr];
+      if (val != 0) {
+        PROM_APPEND("modbus_input_register{addr=\"%d\"} %u\n", addr, (unsigned)val);
+      }
     }
-  }
+    free(prom_regs);
+  }
+
+  uint32_t snap_retries = 0, snap_locked = 0;
+  registers_snapshot_stats(&snap_retries, &snap_locked);
+  PROM_APPEND("# HELP register_snapshot_retries_total Register snapshots repeated because a multi-word write was in progress\n");
+  PROM_APPEND("# TYPE register_snapshot_retries_total counter\n");
+  PROM_APPEND("register_snapshot_retries_total %lu\n", (unsigned long)snap_retries);
+  PROM_APPEND("# HELP register_snapshot_locked_total Register snapshots copied under the writer lock after %d retries\n", REG_SNAPSHOT_MAX_RETRIES);
+  PROM_APPEND("# TYPE register_snapshot_locked_total counter\n");
+  PROM_APPEND("register_snapshot_locked_total %lu\n", (unsigned long)snap_locked);
+
+  uint32_t journal_changes = 0, journal_overruns = 0;
+  registers_journal_stats(&journal_changes, &journal_overruns);
+  PROM_APPEND("# HELP register_journal_changes_total Register/coil changes recorded in the change journal\n");
+  PROM_APPEND("# TYPE register_journal_changes_total counter\n");
+  PROM_APPEND("register_journal_changes_total %lu\n", (unsigned long)journal_changes);
+  PROM_APPEND("# HELP register_journal_overruns_total Journal readers that fell a full ring behind and resynced by block\n");
+  PROM_APPEND("# TYPE register_journal_overruns_total counter\n");
+  PROM_APPEND("register_journal_overruns_total %lu\n", (unsigned long)journal_overruns);
+
+  uint16_t pages_mapped = 0, pages_max = 0;
+  registers_page_stats(&pages_mapped, &pages_max);
+  PROM_APPEND("# HELP register_pages_mapped Sparse HR/IR pages of %d registers in use\n", REG_PAGE_WORDS);
+  PROM_APPEND("# TYPE register_pages_mapped gauge\n");
+  PROM_APPEND("register_pages_mapped %u\n", (unsigned)pages_mapped);
+  PROM_APPEND("# HELP register_pages_max Sparse page pool size\n");
+  PROM_APPEND("# TYPE register_pages_max gauge\n");
+  PROM_APPEND("register_pages_max %u\n", (unsigned)pages_max);
 
   // --- Persistence Group metrics ---
   PersistentRegisterData *pr = &g_persist_config.persist_regs;
@@ -6191,6 +7149,42 @@ esp_err_t api_handler_metrics(httpd_req_t *req)
     PROM_APPEND("ntp_last_sync_age_ms %lu\n", (unsigned long)ntp_driver_get_last_sync_age_ms());
   }
 
+  // --- Modbus TCP server metrics (FEAT-145) ---
+  {
+    const ModbusTcpStats *tcp = modbus_tcp_server_get_stats();
+    PROM_APPEND("# HELP modbus_tcp_running Modbus TCP server listening (1=yes, 0=no)\n");
+    PROM_APPEND("# TYPE modbus_tcp_running gauge\n");
+    PROM_APPEND("modbus_tcp_running %d\n", modbus_tcp_server_is_running() ? 1 : 0);
+
+    PROM_APPEND("# HELP modbus_tcp_active_clients Connected Modbus TCP clients\n");
+    PROM_APPEND("# TYPE modbus_tcp_active_clients gauge\n");
+    PROM_APPEND("modbus_tcp_active_clients %u\n", tcp->active_clients);
+
+    PROM_APPEND("# HELP modbus_tcp_connections_total Modbus TCP connections\n");
+    PROM_APPEND("# TYPE modbus_tcp_connections_total counter\n");
+    PROM_APPEND("modbus_tcp_connections_total{result=\"accepted\"} %lu\n", (unsigned long)tcp->connections_total);
+    PROM_APPEND("modbus_tcp_connections_total{result=\"rejected\"} %lu\n", (unsigned long)tcp->connections_rejected);
+
+    PROM_APPEND("# HELP modbus_tcp_requests_total Modbus TCP requests dispatched\n");
+    PROM_APPEND("# TYPE modbus_tcp_requests_total counter\n");
+    PROM_APPEND("modbus_tcp_requests_total %lu\n", (unsigned long)tcp->requests);
+
+    PROM_APPEND("# HELP modbus_tcp_errors_total Modbus TCP errors by type\n");
+    PROM_APPEND("# TYPE modbus_tcp_errors_total counter\n");
+    PROM_APPEND("modbus_tcp_errors_total{type=\"exception\"} %lu\n", (unsigned long)tcp->exceptions);
+    PROM_APPEND("modbus_tcp_errors_total{type=\"protocol\"} %lu\n", (unsigned long)tcp->protocol_errors);
+    PROM_APPEND("modbus_tcp_errors_total{type=\"unit_id\"} %lu\n", (unsigned long)tcp->unit_mismatch);
+
+    PROM_APPEND("# HELP modbus_tcp_bytes_total Modbus TCP bytes transferred\n");
+    PROM_APPEND("# TYPE modbus_tcp_bytes_total counter\n");
+    PROM_APPEND("modbus_tcp_bytes_total{dir=\"rx\"} %lu\n", (unsigned long)tcp->bytes_rx);
+    PROM_APPEND("modbus_tcp_bytes_total{dir=\"tx\"} %lu\n", (unsigned long)tcp->bytes_tx);
+
+    PROM_APPEND("# HELP modbus_tcp_max_pipeline_depth Most requests handled from one receive\n");
+    PROM_APPEND("# TYPE modbus_tcp_max_pipeline_depth gauge\n");
+    PROM_APPEND("modbus_tcp_max_pipeline_depth %u\n", tcp->max_pipeline_depth);
+  }
+
   // --- Alarm log metrics ---
   alarm_check_thresholds();
   PROM_APPEND("# HELP alarm_log_count Total alarm entries in log\n");
@@ -6206,6 +7200,76 @@ esp_err_t api_handler_metrics(httpd_req_t *req)
   PROM_APPEND("# TYPE alarm_unacknowledged_count gauge\n");
   PROM_APPEND("alarm_unacknowledged_count %d\n", unack);
 
+  // --- Modbus master profile (v7.9.8.17) — last, so a full buffer only trims histograms ---
+  {
+    PROM_APPEND("# HELP modbus_master_bus_utilisation_percent Frame wire time over the last %d s\n", MB_PROFILE_WINDOW_S);
+    PROM_APPEND("# TYPE modbus_master_bus_utilisation_percent gauge\n");
+    for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+      PROM_APPEND("modbus_master_bus_utilisation_percent{bus=\"%u\"} %.2f\n", bus, mb_profile_bus_utilisation(bus));
+    }
+    PROM_APPEND("# HELP modbus_master_bus_occupancy_percent Transaction time (incl. turnaround/timeouts) over the last %d s\n", MB_PROFILE_WINDOW_S);
+    PROM_APPEND("# TYPE modbus_master_bus_occupancy_percent gauge\n");
+    for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+      PROM_APPEND("modbus_master_bus_occupancy_percent{bus=\"%u\"} %.2f\n", bus, mb_profile_bus_occupancy(bus));
+    }
+    PROM_APPEND("# HELP modbus_master_bus_wire_seconds_total Frame wire time at the bus baudrate\n");
+    PROM_APPEND("# TYPE modbus_master_bus_wire_seconds_total counter\n");
+    for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+      PROM_APPEND("modbus_master_bus_wire_seconds_total{bus=\"%u\"} %.6f\n", bus,
+                  mb_profile_get_bus(bus)->wire_us_total / 1e6);
+    }
+    PROM_APPEND("# HELP modbus_master_bus_bytes_total Request + response bytes on the wire\n");
+    PROM_APPEND("# TYPE modbus_master_bus_bytes_total counter\n");
+    for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+      PROM_APPEND("modbus_master_bus_bytes_total{bus=\"%u\"} %llu\n", bus,
+                  (unsigned long long)mb_profile_get_bus(bus)->bytes_total);
+    }
+
+    // Histograms per FC and per slave — only label sets that have seen traffic
+    static const char *const prof_kind[MB_PROFILE_HIST_COUNT] = { "latency_seconds", "turnaround_seconds", "wire_bytes" };
+    static const char *const prof_help[MB_PROFILE_HIST_COUNT] = {
+      "Async request queued to completed",
+      "Request sent to first response byte",
+      "Request + response bytes per transaction"
+    };
+    for (uint8_t by_slave = 0; by_slave < 2; by_slave++) {
+      const char *scope = by_slave ? "slave" : "fc";
+      for (uint8_t k = 0; k < MB_PROFILE_HIST_COUNT; k++) {
+        const uint32_t *bounds = mb_profile_bounds(k);
+        double scale = (k == MB_PROFILE_WIRE_BYTES) ? 1.0 : 1000000.0;
+        PROM_APPEND("# HELP modbus_master_%s_%s %s\n", scope, prof_kind[k], prof_help[k]);
+        PROM_APPEND("# TYPE modbus_master_%s_%s histogram\n", scope, prof_kind[k]);
+        uint8_t n = by_slave ? MB_PROFILE_SLAVES + 1 : MB_PROFILE_FCS;
+        for (uint8_t i = 0; i < n; i++) {
+          char label[24];
+          const mb_profile_hist_t *h;
+          if (by_slave) {
+            const mb_profile_slave_t *sl = mb_profile_get_slave(i);
+            h = &sl->stats.hist[k];
+            if (sl->slave_id) snprintf(label, sizeof(label), "slave=\"%u\"", sl->slave_id);
+            else snprintf(label, sizeof(label), "slave=\"other\"");
+          } else {
+            h = &mb_profile_get_fc(i)->hist[k];
+            uint8_t fc = mb_profile_fc_of_index(i);
+            if (fc) snprintf(label, sizeof(label), "fc=\"%u\"", fc);
+            else snprintf(label, sizeof(label), "fc=\"other\"");
+          }
+          if (h->count == 0) continue;
+          uint32_t cumulative = 0;
+          for (int b = 0; b < MB_PROFILE_BUCKETS - 1; b++) {
+            cumulative += h->bucket[b];
+            PROM_APPEND("modbus_master_%s_%s_bucket{%s,le=\"%g\"} %lu\n", scope, prof_kind[k], label,
+                        bounds[b] / scale, (unsigned long)cumulative);
+          }
+          PROM_APPEND("modbus_master_%s_%s_bucket{%s,le=\"+Inf\"} %lu\n", scope, prof_kind[k], label,
+                      (unsigned long)h->count);
+          PROM_APPEND("modbus_master_%s_%s_sum{%s} %.6f\n", scope, prof_kind[k], label, h->sum / scale);
+          PROM_APPEND("modbus_master_%s_%s_count{%s} %lu\n", scope, prof_kind[k], label, (unsigned long)h->count);
+        }
+      }
+    }
+  }
+
   #undef PROM_APPEND
 
   // Send as text/plain (Prometheus format)
@@ -6832,6 +7896,7 @@ static const V1Route v1_routes[] = {
   {"/api/registers/ir",     true,  HTTP_GET,    api_handler_ir_bulk_read},
   {"/api/registers/coils",  true,  HTTP_GET,    api_handler_coils_bulk_read},
   {"/api/registers/di",     true,  HTTP_GET,    api_handler_di_bulk_read},
+  {"/api/registers/map",    true,  HTTP_GET,    api_handler_registers_map},
   {"/api/registers/hr/bulk", true,  HTTP_POST,  api_handler_hr_bulk_write},
   {"/api/registers/coils/bulk", true, HTTP_POST, api_handler_coils_bulk_write},
 
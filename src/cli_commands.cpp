@@ -35,6 +35,7 @@
 #include "wifi_driver.h"
 #include "ethernet_driver.h"
 #include "sse_events.h"
+#include "modbus_server.h"
 #include "register_allocator.h"  // BUG-025: Register overlap checking
 #include <Arduino.h>
 #include <esp_system.h>
@@ -715,6 +716,7 @@ void cli_cmd_set_baud(uint32_t baud) {
     return;
   }
   g_persist_config.modbus_slave.baudrate = baud;
+  modbus_server_apply_line_config();
   debug_print("Baud rate set to: ");
   debug_print_uint(baud);
   debug_println("");
@@ -734,10 +736,10 @@ void cli_cmd_set_id(uint8_t id) {
 }
 
 void cli_cmd_set_reg(uint16_t addr, uint16_t value) {
-  if (addr >= HOLDING_REGS_SIZE) {
-    debug_print("SET REG: address out of range (max ");
+  if (registers_holding_span(addr, 1) != 1) {
+    debug_print("SET REG: address out of range (0-");
     debug_print_uint(HOLDING_REGS_SIZE - 1);
-    debug_println(")");
+    debug_println(" or 'set reg-map')");
     return;
   }
 
@@ -1545,6 +1547,7 @@ void cli_cmd_defaults(void) {
   g_persist_config.modbus_slave.parity = 0;  // None
   g_persist_config.modbus_slave.stop_bits = 1;
   g_persist_config.modbus_slave.inter_frame_delay = 0;  // 0=auto (t3.5 from baudrate)
+  modbus_server_apply_line_config();
 
   // Initialize all GPIO mappings as unused
   for (uint8_t i = 0; i < 8; i++) {
@@ -1689,12 +1692,10 @@ void cli_cmd_write_reg(uint8_t argc, char* argv[]) {
     float real_val = atof(value_str);
 
     // Validate address (need 2 consecutive registers)
-    if (addr + 1 >= HOLDING_REGS_SIZE) {
+    if (registers_holding_span(addr, 2) != 2) {
       debug_print("WRITE REG: REAL kr\u00e6ver 2 registers, adresse ");
       debug_print_uint(addr);
-      debug_print(" udenfor omr\u00e5de (max ");
-      debug_print_uint(HOLDING_REGS_SIZE - 2);
-      debug_println(")");
+      debug_println(" udenfor omr\u00e5de (flat 0-254 eller 'set reg-map')");
       return;
     }
 
@@ -1727,12 +1728,10 @@ void cli_cmd_write_reg(uint8_t argc, char* argv[]) {
     int32_t dint_val = atol(value_str);
 
     // Validate address (need 2 consecutive registers)
-    if (addr + 1 >= HOLDING_REGS_SIZE) {
+    if (registers_holding_span(addr, 2) != 2) {
       debug_print("WRITE REG: DINT kr\u00e6ver 2 registers, adresse ");
       debug_print_uint(addr);
-      debug_print(" udenfor omr\u00e5de (max ");
-      debug_print_uint(HOLDING_REGS_SIZE - 2);
-      debug_println(")");
+      debug_println(" udenfor omr\u00e5de (flat 0-254 eller 'set reg-map')");
       return;
     }
 
@@ -1763,12 +1762,10 @@ void cli_cmd_write_reg(uint8_t argc, char* argv[]) {
     uint32_t dword_val = strtoul(value_str, NULL, 10);
 
     // Validate address (need 2 consecutive registers)
-    if (addr + 1 >= HOLDING_REGS_SIZE) {
+    if (registers_holding_span(addr, 2) != 2) {
       debug_print("WRITE REG: DWORD kr\u00e6ver 2 registers, adresse ");
       debug_print_uint(addr);
-      debug_print(" udenfor omr\u00e5de (max ");
-      debug_print_uint(HOLDING_REGS_SIZE - 2);
-      debug_println(")");
+      debug_println(" udenfor omr\u00e5de (flat 0-254 eller 'set reg-map')");
       return;
     }
 
@@ -1800,11 +1797,11 @@ void cli_cmd_write_reg(uint8_t argc, char* argv[]) {
     return;
   }
 
-  // Validate address
-  if (addr >= HOLDING_REGS_SIZE) {
-    debug_print("WRITE REG: adresse udenfor omr\u00e5de (max ");
+  // Validate address: flat array or mapped sparse page (v7.9.8.22)
+  if (registers_holding_span(addr, 1) != 1) {
+    debug_print("WRITE REG: adresse udenfor omr\u00e5de (0-");
     debug_print_uint(HOLDING_REGS_SIZE - 1);
-    debug_println(")");
+    debug_println(" eller 'set reg-map')");
     return;
   }
 
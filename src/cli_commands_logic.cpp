@@ -120,6 +120,12 @@ int cli_cmd_set_logic_upload(st_logic_engine_state_t *logic_state, uint8_t progr
   debug_printf("  Program: Logic%d\n", program_id + 1);
   debug_printf("  Source: %d bytes\n", (int)source_len);
   debug_printf("  Bytecode: %d instructions\n", prog->bytecode.instr_count);
+  if (prog->bytecode.unoptimized_count > prog->bytecode.instr_count) {
+    debug_printf("  Optimizer: %d -> %d instructions (-%d%%)\n",
+                 prog->bytecode.unoptimized_count, prog->bytecode.instr_count,
+                 (int)((prog->bytecode.unoptimized_count - prog->bytecode.instr_count) * 100 /
+                       prog->bytecode.unoptimized_count));
+  }
   debug_printf("  Variables: %d\n", prog->bytecode.var_count);
   debug_printf("  Pool: %d/%d bytes used (%d%% full, %d bytes free)\n",
                (int)pool_used, ST_LOGIC_POOL_SIZE, (int)pool_usage_pct, (int)pool_free);
@@ -264,6 +270,108 @@ int cli_cmd_set_logic_interval(st_logic_engine_state_t *logic_state, uint32_t in
   return 0;
 }
 
+/**
+ * @brief set logic parallel:on|off
+ *
+ * FEAT-153: Split independent programs over the loop task (Core 1) and the
+ * ST worker task (Core 0). Programs sharing registers, or using Modbus
+ * master / counter / SAVE / LOAD builtins, stay on the loop task.
+ *
+ * Example:
+ *   set logic parallel:on
+ *   set logic parallel:off    # classic serial execution
+ */
+int cli_cmd_set_logic_parallel(st_logic_engine_state_t *logic_state, bool enabled) {
+  if (!logic_state) {
+    debug_println("ERROR: Logic state not initialized");
+    return -1;
+  }
+
+  st_logic_set_parallel(logic_state, enabled);
+
+  extern PersistConfig g_persist_config;
+  if (enabled) {
+    g_persist_config.module_flags &= ~MODULE_FLAG_ST_PARALLEL_DISABLED;
+  } else {
+    g_persist_config.module_flags |= MODULE_FLAG_ST_PARALLEL_DISABLED;
+  }
+
+  if (enabled && !logic_state->parallel) {
+    debug_println("ERROR: ST worker task could not be started (running serial)");
+    return -1;
+  }
+
+  debug_printf("[OK] ST Logic parallel execution %s\n", enabled ? "ENABLED" : "DISABLED");
+  debug_println("Note: Use 'save' command to persist to NVS");
+  return 0;
+}
+
+/**
+ * @brief set logic <id> period:<ms> priority:<n> policy:skip|catchup
+ *
+ * FEAT-154: Per-program scan schedule. Programs run on a fixed grid of
+ * period_ms (0 = global interval); when several are due, the highest
+ * priority runs first. A scan that starts a whole period late either drops
+ * the missed scans (skip) or runs them back-to-back (catchup, max 4).
+ *
+ * Example:
+ *   set logic 1 period:5 priority:10
+ *   set logic 2 period:100 policy:catchup
+ *   set logic 2 period:0      # back to the global interval
+ */
+int cli_cmd_set_logic_schedule(st_logic_engine_state_t *logic_state, uint8_t program_id,
+                               int argc, char *argv[]) {
+  if (!logic_state || program_id >= ST_LOGIC_MAX_PROGRAMS) {
+    debug_println("ERROR: Invalid program ID");
+    return -1;
+  }
+
+  st_logic_program_config_t *prog = &logic_state->programs[program_id];
+  uint32_t period_ms = prog->period_ms;
+  uint32_t priority = prog->priority;
+  uint8_t policy = prog->scan_policy;
+
+  for (int i = 0; i < argc; i++) {
+    const char *arg = argv[i];
+    if (strncmp(arg, "period:", 7) == 0) {
+      period_ms = atoi(arg + 7);
+      if (period_ms != 0 && (period_ms < ST_LOGIC_SCAN_MIN_PERIOD_MS || period_ms > ST_LOGIC_SCAN_MAX_PERIOD_MS)) {
+        debug_printf("ERROR: Invalid period %ums (0 = global interval, or %u-%u)\n",
+                     (unsigned int)period_ms, ST_LOGIC_SCAN_MIN_PERIOD_MS, ST_LOGIC_SCAN_MAX_PERIOD_MS);
+        return -1;
+      }
+    } else if (strncmp(arg, "priority:", 9) == 0) {
+      priority = atoi(arg + 9);
+      if (priority > 255) {
+        debug_println("ERROR: Invalid priority (0-255)");
+        return -1;
+      }
+    } else if (strncmp(arg, "policy:", 7) == 0) {
+      if (strcmp(arg + 7, "skip") == 0) {
+        policy = ST_LOGIC_SCAN_SKIP;
+      } else if (strcmp(arg + 7, "catchup") == 0) {
+        policy = ST_LOGIC_SCAN_CATCH_UP;
+      } else {
+        debug_println("ERROR: Invalid policy (skip|catchup)");
+        return -1;
+      }
+    } else {
+      debug_printf("ERROR: Unknown schedule option '%s'\n", arg);
+      debug_println("  Usage: set logic <id> period:<ms> priority:<n> policy:skip|catchup");
+      return -1;
+    }
+  }
+
+  st_logic_set_schedule(logic_state, program_id, (uint16_t)period_ms, (uint8_t)priority, policy);
+
+  debug_printf("[OK] Logic%d scan: period %ums%s, priority %u, policy %s\n", program_id + 1,
+               (unsigned int)st_logic_get_period_ms(logic_state, program_id),
+               prog->period_ms ? "" : " (global)", prog->priority,
+               prog->scan_policy == ST_LOGIC_SCAN_CATCH_UP ? "catchup" : "skip");
+  debug_println("Note: Use 'save' command to persist to NVS");
+  return 0;
+}
+
 /**
  * @brief set logic <id> delete
  *
@@ -908,7 +1016,11 @@ int cli_cmd_show_logic_bytecode(st_logic_engine_state_t *logic_state, uint8_t pr
 
   debug_printf("Program: %s\n", prog->name);
   debug_printf("Status:  %s\n", prog->enabled ? "ENABLED" : "DISABLED");
-  debug_printf("Instructions: %u\n", prog->bytecode.instr_count);
+  debug_printf("Instructions: %u", prog->bytecode.instr_count);
+  if (prog->bytecode.unoptimized_count > 0) {
+    debug_printf(" (optimizer: %u -> %u)", prog->bytecode.unoptimized_count, prog->bytecode.instr_count);
+  }
+  debug_printf("\n");
   debug_printf("Variables: %u\n\n", prog->bytecode.var_count);
 
   // Show variable table
@@ -1072,8 +1184,30 @@ int cli_cmd_show_logic_bytecode(st_logic_engine_state_t *logic_state, uint8_t pr
       case ST_OP_HALT:
         debug_printf("HALT");
         break;
+      case ST_OP_INC_VAR:
+        debug_printf("INC_VAR [%d] %+d", instr->arg.var_inc.var_index, instr->arg.var_inc.delta);
+        if (instr->arg.var_inc.var_index < prog->bytecode.var_count) {
+          debug_printf(" ; %s", prog->bytecode.var_names[instr->arg.var_inc.var_index]);
+        }
+        break;
+      // FEAT-152: Stateful superinstructions carry their instance
+      case ST_OP_CALL_TON:
+      case ST_OP_CALL_TOF:
+      case ST_OP_CALL_TP:
+      case ST_OP_CALL_CTU:
+      case ST_OP_CALL_CTD:
+      case ST_OP_CALL_R_TRIG:
+      case ST_OP_CALL_F_TRIG:
+        debug_printf("%s inst=%d", st_opcode_to_string(instr->opcode),
+                     instr->arg.builtin_call.instance_id);
+        break;
       default:
-        debug_printf("UNKNOWN_OP(%d)", instr->opcode);
+        // FEAT-149: Typed opcodes carry no argument
+        if (instr->opcode > ST_OP_HALT && instr->opcode < ST_OP_COUNT) {
+          debug_printf("%s", st_opcode_to_string(instr->opcode));
+        } else {
+          debug_printf("UNKNOWN_OP(%d)", instr->opcode);
+        }
         break;
     }
     debug_printf("\n");
@@ -1083,6 +1217,17 @@ int cli_cmd_show_logic_bytecode(st_logic_engine_state_t *logic_state, uint8_t pr
   return 0;
 }
 
+// FEAT-154: One line per histogram, "<=50us:12 ... >5000us:0"
+static void cli_print_scan_histogram(const char *label, const uint32_t *buckets) {
+  static const uint32_t bounds_us[ST_LOGIC_SCAN_BUCKETS - 1] = ST_LOGIC_SCAN_BOUNDS_US;
+  debug_printf("%s", label);
+  for (uint8_t b = 0; b < ST_LOGIC_SCAN_BUCKETS - 1; b++) {
+    debug_printf(" <=%u:%u", (unsigned int)bounds_us[b], (unsigned int)buckets[b]);
+  }
+  debug_printf(" >%u:%u (us)\n", (unsigned int)bounds_us[ST_LOGIC_SCAN_BUCKETS - 2],
+               (unsigned int)buckets[ST_LOGIC_SCAN_BUCKETS - 1]);
+}
+
 /**
  * @brief show logic stats - Display performance statistics for all programs (v4.1.0)
  */
@@ -1104,6 +1249,17 @@ int cli_cmd_show_logic_stats(st_logic_engine_state_t *logic_state) {
                  (float)logic_state->cycle_overrun_count * 100.0 / logic_state->total_cycles);
   }
 
+  // FEAT-153: Lane assignment of the last cycle
+  debug_printf("  Parallel:        %s (%u groups, %u cycles on both cores)\n",
+               logic_state->parallel ? "ON" : "OFF",
+               (unsigned int)logic_state->group_count,
+               (unsigned int)logic_state->parallel_cycles);
+  for (uint8_t i = 0; i < ST_LOGIC_MAX_PROGRAMS; i++) {
+    if (logic_state->lane[i] == 0xFF) continue;
+    debug_printf("    Logic%d -> %s\n", i + 1,
+                 logic_state->lane[i] == 0 ? "loop (Core 1)" : "worker (Core 0)");
+  }
+
   debug_printf("\n");
 
   // Pool memory statistics
@@ -1174,6 +1330,26 @@ int cli_cmd_show_logic_stats(st_logic_engine_state_t *logic_state) {
       }
     }
 
+    // FEAT-154: Scan schedule + start jitter / overrun
+    const st_logic_scan_stats_t *scan = &prog->scan;
+    debug_printf("  Scan:          every %ums%s, priority %u, policy %s\n",
+                 (unsigned int)st_logic_get_period_ms(logic_state, i),
+                 prog->period_ms ? "" : " (global)", prog->priority,
+                 prog->scan_policy == ST_LOGIC_SCAN_CATCH_UP ? "catchup" : "skip");
+    if (scan->jitter_count > 0) {
+      debug_printf("  Start jitter:  avg %uus, max %uus (%u scans, %u skipped)\n",
+                   (unsigned int)(scan->jitter_sum_us / scan->jitter_count),
+                   (unsigned int)scan->jitter_max_us,
+                   (unsigned int)scan->jitter_count, (unsigned int)scan->skipped);
+      cli_print_scan_histogram("  Jitter hist:  ", scan->jitter_bucket);
+      if (scan->overrun_count > 0) {
+        debug_printf("  Late end:      %u scans, avg %uus ⚠️\n",
+                     (unsigned int)scan->overrun_count,
+                     (unsigned int)(scan->overrun_sum_us / scan->overrun_count));
+        cli_print_scan_histogram("  Overrun hist: ", scan->overrun_bucket);
+      }
+    }
+
     debug_printf("\n");
   }
 
@@ -1242,6 +1418,11 @@ int cli_cmd_show_logic_timing(st_logic_engine_state_t *logic_state, uint8_t prog
                  (unsigned int)(prog->last_execution_us / 1000),
                  (unsigned int)(prog->last_execution_us % 1000),
                  (unsigned int)prog->last_execution_us);
+    debug_printf("  Last instructions: %u", (unsigned int)prog->last_instructions);
+    if (prog->last_execution_us > 0) {
+      debug_printf(" (%.2f Minstr/s)", (float)prog->last_instructions / (float)prog->last_execution_us);
+    }
+    debug_printf("\n");
     debug_printf("\n");
 
     // Performance analysis
@@ -6,6 +6,7 @@
 #include <Arduino.h>
 #include "modbus_master.h"
 #include "mb_async.h"
+#include "mb_profile.h"
 #include "config_struct.h"
 #include "debug.h"
 
@@ -164,13 +165,21 @@ void cli_cmd_set_modbus_master_cache_ttl(uint16_t ttl_ms) {
   debug_println("NOTE: Use 'save' to persist to NVS");
 }
 
-void cli_cmd_set_modbus_master_cache_size(uint8_t size) {
+void cli_cmd_set_modbus_master_cache_size(uint16_t size) {
+  uint16_t limit = mb_async_cache_limit();
   if (size < 1) size = 1;
-  if (size > MB_CACHE_MAX_ENTRIES) size = MB_CACHE_MAX_ENTRIES;
+  if (size > limit) size = limit;
   g_modbus_master_config.cache_max_entries = size;
   g_persist_config.modbus_master.cache_max_entries = size;
-  debug_printf("[OK] Modbus Master cache max entries: %u (compile-max: %d)\n", size, MB_CACHE_MAX_ENTRIES);
-  debug_println("NOTE: Use 'save' to persist. Eksisterende entries over grænsen evictes ved næste insert.");
+  debug_printf("[OK] Modbus Master cache max entries: %u (board max: %u%s)\n",
+               size, limit, psramFound() ? ", PSRAM" : "");
+
+  // Reallocate now if the async task owns a cache, otherwise mb_async_init() allocates it
+  if (mb_async_get_state()->entries && !mb_async_cache_resize(size)) {
+    debug_println("ERROR: Kunne ikke allokere cache — beholder den gamle");
+    return;
+  }
+  debug_println("NOTE: Use 'save' to persist. Cachen er tømt og fyldes ved næste poll.");
 }
 
 void cli_cmd_set_modbus_master_queue_size(uint8_t size) {
@@ -182,6 +191,242 @@ void cli_cmd_set_modbus_master_queue_size(uint8_t size) {
   debug_println("NOTE: Use 'save' to persist.");
 }
 
+void cli_cmd_set_modbus_master_coalesce(bool enabled) {
+  g_modbus_master_config.coalesce_enabled = enabled ? 1 : 0;
+  g_persist_config.modbus_master.coalesce_enabled = enabled ? 1 : 0;
+  debug_printf("[OK] Modbus Master read coalescing: %s\n", enabled ? "ON" : "OFF");
+  debug_println("NOTE: Use 'save' to persist.");
+}
+
+void cli_cmd_set_modbus_master_coalesce_gap(uint8_t gap) {
+  if (gap > MB_COALESCE_MAX_GAP) gap = MB_COALESCE_MAX_GAP;
+  g_modbus_master_config.coalesce_gap = gap;
+  g_persist_config.modbus_master.coalesce_gap = gap;
+  debug_printf("[OK] Modbus Master coalesce gap: %u registre (%u coils)\n", gap, gap * 16);
+  debug_println("NOTE: Use 'save' to persist.");
+}
+
+void cli_cmd_set_modbus_master_write_combine(bool enabled) {
+  g_modbus_master_config.write_combine = enabled ? 1 : 0;
+  g_persist_config.modbus_master.write_combine = enabled ? 1 : 0;
+  debug_printf("[OK] Modbus Master write combining: %s\n", enabled ? "ON" : "OFF");
+  debug_println("NOTE: Use 'save' to persist.");
+}
+
+// set modbus-master write-always <id>|<first>-<last> on|off
+void cli_cmd_set_modbus_master_write_always(const char *range, const char *value) {
+  const char *dash = strchr(range, '-');
+  int first = atoi(range);
+  int last = dash ? atoi(dash + 1) : first;
+  if (first < 1 || last > 247 || first > last) {
+    debug_println("ERROR: Slave skal være 1-247 eller <first>-<last>");
+    return;
+  }
+  bool on = !strcasecmp(value, "on") || !strcmp(value, "1") || !strcasecmp(value, "true");
+  mb_async_write_always_set((uint8_t)first, (uint8_t)last, on);
+  if (first == last) {
+    debug_printf("[OK] Slave %d: skrivninger sendes %s\n", first, on ? "altid (også uændrede)" : "kun ved ændring");
+  } else {
+    debug_printf("[OK] Slaves %d-%d: skrivninger sendes %s\n", first, last, on ? "altid (også uændrede)" : "kun ved ændring");
+  }
+  debug_println("NOTE: Use 'save' to persist.");
+}
+
+// "1-3,7" — slave IDs whose writes are never deduplicated ("-" if none)
+static void cli_format_write_always(char *buf, size_t len) {
+  size_t pos = 0;
+  buf[0] = '\0';
+  for (uint16_t id = 1; id <= 247 && pos + 9 < len; id++) {
+    if (!mb_async_write_always((uint8_t)id)) continue;
+    uint16_t last = id;
+    while (last < 247 && mb_async_write_always((uint8_t)(last + 1))) last++;
+    if (last > id) pos += snprintf(buf + pos, len - pos, "%s%u-%u", pos ? "," : "", id, last);
+    else pos += snprintf(buf + pos, len - pos, "%s%u", pos ? "," : "", id);
+    id = last;
+  }
+  if (pos == 0) snprintf(buf, len, "-");
+}
+
+// set modbus-master poll <1-16> slave:<id> fc:<1-4> start:<addr> count:<n> period:<ms> priority:<n>
+// set modbus-master poll <1-16> enable|disable|delete
+void cli_cmd_set_modbus_master_poll(uint8_t group_id, int argc, char *argv[]) {
+  if (group_id < 1 || group_id > MB_POLL_GROUPS_MAX) {
+    debug_printf("ERROR: Poll group skal være 1-%d\n", MB_POLL_GROUPS_MAX);
+    return;
+  }
+  ModbusPollGroup *slot = &g_persist_config.mb_poll_groups[group_id - 1];
+  ModbusPollGroup pg = *slot;
+  bool is_new = (pg.slave_id == 0);
+  if (is_new) {
+    memset(&pg, 0, sizeof(pg));
+    pg.enabled = 1;
+    pg.fc = MB_REQ_READ_HOLDING;
+    pg.count = 1;
+    pg.period_ms = 1000;
+  }
+
+  for (int i = 0; i < argc; i++) {
+    const char *arg = argv[i];
+    if (!strcasecmp(arg, "enable") || !strcasecmp(arg, "enabled")) {
+      pg.enabled = 1;
+    } else if (!strcasecmp(arg, "disable") || !strcasecmp(arg, "disabled")) {
+      pg.enabled = 0;
+    } else if (!strcasecmp(arg, "delete")) {
+      memset(slot, 0, sizeof(*slot));
+      mb_async_poll_load(g_persist_config.mb_poll_groups);
+      debug_printf("[OK] Poll group %u slettet\n", group_id);
+      debug_println("NOTE: Use 'save' to persist.");
+      return;
+    } else if (!strncmp(arg, "slave:", 6)) {
+      pg.slave_id = (uint8_t)constrain(atoi(arg + 6), 0, 255);
+    } else if (!strncmp(arg, "fc:", 3)) {
+      pg.fc = (uint8_t)constrain(atoi(arg + 3), 0, 255);
+    } else if (!strncmp(arg, "start:", 6)) {
+      pg.start = (uint16_t)constrain(atol(arg + 6), 0, 65535);
+    } else if (!strncmp(arg, "count:", 6)) {
+      pg.count = (uint16_t)constrain(atoi(arg + 6), 0, 65535);
+    } else if (!strncmp(arg, "period:", 7)) {
+      pg.period_ms = (uint32_t)strtoul(arg + 7, NULL, 10);
+    } else if (!strncmp(arg, "priority:", 9)) {
+      pg.priority = (uint8_t)constrain(atoi(arg + 9), 0, 255);
+    } else {
+      debug_printf("ERROR: Ukendt poll option '%s'\n", arg);
+      debug_println("  Usage: set modbus-master poll <id> slave:<id> fc:<1-4> start:<addr> count:<n> period:<ms> priority:<n>");
+      debug_println("         set modbus-master poll <id> enable|disable|delete");
+      return;
+    }
+  }
+
+  if (!mb_poll_group_valid(&pg)) {
+    debug_printf("ERROR: Ugyldig poll group (slave 1-247, fc 1-4, count 1-%d, period %d-%lu ms)\n",
+                 MB_POLL_MAX_COUNT, MB_POLL_MIN_PERIOD_MS, (unsigned long)MB_POLL_MAX_PERIOD_MS);
+    return;
+  }
+
+  *slot = pg;
+  mb_async_poll_load(g_persist_config.mb_poll_groups);
+  debug_printf("[OK] Poll group %u: slave %u FC%02u %u+%u every %lu ms, priority %u (%s)\n",
+               group_id, pg.slave_id, pg.fc, pg.start, pg.count,
+               (unsigned long)pg.period_ms, pg.priority, pg.enabled ? "enabled" : "disabled");
+
+  // Every polled address occupies a cache entry — warn before the groups start evicting each other
+  uint32_t polled = 0;
+  for (uint8_t i = 0; i < MB_POLL_GROUPS_MAX; i++) {
+    const ModbusPollGroup *g = &g_persist_config.mb_poll_groups[i];
+    if (g->slave_id != 0 && g->enabled) polled += g->count;
+  }
+  if (polled > g_modbus_master_config.cache_max_entries) {
+    debug_printf("WARN: Poll groups dækker %lu adresser, men cachen har kun %u entries (set modbus-master cache-size)\n",
+                 (unsigned long)polled, g_modbus_master_config.cache_max_entries);
+  }
+  debug_println("NOTE: Use 'save' to persist.");
+}
+
+// set modbus-master bus <1> enabled:on|off baud:<rate> parity:<p> stop:<1|2> timeout:<ms> delay:<ms>
+void cli_cmd_set_modbus_master_bus(uint8_t bus, int argc, char *argv[]) {
+  if (bus < 1 || bus >= MB_BUS_MAX) {
+    debug_printf("ERROR: Bus skal være 1-%d (bus 0 = 'set modbus-master baudrate/parity/...')\n", MB_BUS_MAX - 1);
+    return;
+  }
+  ModbusBusConfig bc = g_persist_config.mb_buses[bus - 1];
+
+  for (int i = 0; i < argc; i++) {
+    const char *arg = argv[i];
+    if (!strncmp(arg, "enabled:", 8)) {
+      const char *v = arg + 8;
+      bc.enabled = (!strcasecmp(v, "on") || !strcmp(v, "1") || !strcasecmp(v, "true")) ? 1 : 0;
+    } else if (!strncmp(arg, "baud:", 5)) {
+      bc.baudrate = (uint32_t)strtoul(arg + 5, NULL, 10);
+    } else if (!strncmp(arg, "parity:", 7)) {
+      const char *v = arg + 7;
+      if (!strcasecmp(v, "none")) bc.parity = 0;
+      else if (!strcasecmp(v, "even")) bc.parity = 1;
+      else if (!strcasecmp(v, "odd")) bc.parity = 2;
+      else {
+        debug_println("ERROR: Parity skal være none, even eller odd");
+        return;
+      }
+    } else if (!strncmp(arg, "stop:", 5)) {
+      bc.stop_bits = (uint8_t)constrain(atoi(arg + 5), 0, 255);
+    } else if (!strncmp(arg, "timeout:", 8)) {
+      bc.timeout_ms = (uint16_t)constrain(atol(arg + 8), 0, 65535);
+    } else if (!strncmp(arg, "delay:", 6)) {
+      bc.inter_frame_delay = (uint16_t)constrain(atol(arg + 6), 0, 65535);
+    } else {
+      debug_printf("ERROR: Ukendt bus option '%s'\n", arg);
+      debug_println("  Usage: set modbus-master bus <1> enabled:on|off baud:<rate> parity:<none|even|odd> stop:<1|2> timeout:<ms> delay:<ms>");
+      return;
+    }
+  }
+
+  if (!mb_bus_config_valid(&bc)) {
+    debug_println("ERROR: Ugyldig bus config (baud 2400-115200, stop 1-2, timeout 100-5000 ms, delay 0-1000 ms)");
+    return;
+  }
+
+  g_persist_config.mb_buses[bus - 1] = bc;
+  bool ok = mb_async_bus_apply(bus);
+  debug_printf("[%s] Bus %u: %s, %lu baud, parity %s, %u stop, timeout %u ms, delay %u ms\n",
+               ok ? "OK" : "FEJL", bus, bc.enabled ? "enabled" : "disabled", (unsigned long)bc.baudrate,
+               bc.parity == 1 ? "even" : bc.parity == 2 ? "odd" : "none", bc.stop_bits,
+               bc.timeout_ms, bc.inter_frame_delay);
+  if (!ok) {
+    debug_printf("  UART%u kunne ikke startes — konfigurer TX/RX/DIR pins og tjek at slaven ikke bruger den\n",
+                 MODBUS_MASTER_BUS1_UART);
+  } else if (bc.enabled && !g_modbus_master_config.enabled) {
+    debug_println("NOTE: Bussen starter først når modbus-master er enabled");
+  }
+  debug_println("NOTE: Use 'save' to persist.");
+}
+
+// set modbus-master route <1-8> slaves:<first>-<last> bus:<n>
+// set modbus-master route <1-8> delete
+void cli_cmd_set_modbus_master_route(uint8_t route_id, int argc, char *argv[]) {
+  if (route_id < 1 || route_id > MB_BUS_ROUTES_MAX) {
+    debug_printf("ERROR: Route skal være 1-%d\n", MB_BUS_ROUTES_MAX);
+    return;
+  }
+  ModbusBusRoute *slot = &g_persist_config.mb_bus_routes[route_id - 1];
+  ModbusBusRoute r = *slot;
+
+  for (int i = 0; i < argc; i++) {
+    const char *arg = argv[i];
+    if (!strcasecmp(arg, "delete")) {
+      memset(slot, 0, sizeof(*slot));
+      mb_async_route_load(g_persist_config.mb_bus_routes);
+      debug_printf("[OK] Route %u slettet\n", route_id);
+      debug_println("NOTE: Use 'save' to persist.");
+      return;
+    } else if (!strncmp(arg, "slaves:", 7)) {
+      const char *range = arg + 7;
+      const char *dash = strchr(range, '-');
+      r.first_slave = (uint8_t)constrain(atoi(range), 0, 255);
+      r.last_slave = dash ? (uint8_t)constrain(atoi(dash + 1), 0, 255) : r.first_slave;
+    } else if (!strncmp(arg, "bus:", 4)) {
+      r.bus = (uint8_t)constrain(atoi(arg + 4), 0, 255);
+    } else {
+      debug_printf("ERROR: Ukendt route option '%s'\n", arg);
+      debug_println("  Usage: set modbus-master route <1-8> slaves:<first>-<last> bus:<n>");
+      debug_println("         set modbus-master route <1-8> delete");
+      return;
+    }
+  }
+
+  if (!mb_bus_route_valid(&r)) {
+    debug_printf("ERROR: Ugyldig route (slaves 1-247, første <= sidste, bus 0-%d)\n", MB_BUS_MAX - 1);
+    return;
+  }
+
+  *slot = r;
+  mb_async_route_load(g_persist_config.mb_bus_routes);
+  debug_printf("[OK] Route %u: slaves %u-%u → bus %u\n", route_id, r.first_slave, r.last_slave, r.bus);
+  if (r.bus > 0 && !mb_async_get_bus_state(r.bus)->task_running) {
+    debug_printf("WARN: Bus %u kører ikke — requests til disse slaves fejler (set modbus-master bus %u enabled:on)\n",
+                 r.bus, r.bus);
+  }
+  debug_println("NOTE: Use 'save' to persist.");
+}
+
 /* ============================================================================
  * SHOW COMMAND
  * ============================================================================ */
@@ -248,7 +493,7 @@ void cli_cmd_mb_read(uint8_t argc, char **argv) {
     debug_println("  type: coil (FC01), input (FC02), holding (FC03), input-reg (FC04)");
     debug_println("  slave_id: 1-247");
     debug_println("  address: 0-65535");
-    debug_println("  count: 1-16 (kun for holding, default 1)");
+    debug_println("  count: 1-125 (kun for holding, default 1)");
     debug_println("  baudrate: 2400-115200 (valgfri, midlertidig override)");
     debug_println("Eksempel: mb read holding 90 0");
     debug_println("          mb read holding 100 254 4");
@@ -286,8 +531,8 @@ void cli_cmd_mb_read(uint8_t argc, char **argv) {
     } else if (argc >= 4) {
       // One extra arg: could be count OR baud
       uint32_t val = atol(argv[3]);
-      if (mb_is_valid_baudrate(val) && val > 16) {
-        temp_baud = val;  // It's a baudrate (all valid bauds are > 16)
+      if (mb_is_valid_baudrate(val) && val > MODBUS_MASTER_MAX_READ_REGS) {
+        temp_baud = val;  // It's a baudrate (all valid bauds are > 125)
       } else {
         count = atoi(argv[3]);
       }
@@ -324,7 +569,7 @@ void cli_cmd_mb_read(uint8_t argc, char **argv) {
       debug_printf("  FEJL: %s\n", mb_error_str(err));
     }
   } else if (strcasecmp(type, "holding") == 0 || strcasecmp(type, "h-reg") == 0 || strcasecmp(type, "hreg") == 0) {
-    if (count > 16) { debug_println("FEJL: max 16 registre"); return; }
+    if (count > MODBUS_MASTER_MAX_READ_REGS) { debug_printf("FEJL: max %d registre\n", MODBUS_MASTER_MAX_READ_REGS); return; }
     if (count == 1) {
       uint16_t val = 0;
       mb_error_code_t err = modbus_master_read_holding(slave_id, address, &val);
@@ -336,7 +581,7 @@ void cli_cmd_mb_read(uint8_t argc, char **argv) {
         debug_printf("  FEJL: %s\n", mb_error_str(err));
       }
     } else {
-      uint16_t vals[16];
+      uint16_t vals[MODBUS_MASTER_MAX_READ_REGS];
       mb_error_code_t err = modbus_master_read_holdings(slave_id, address, count, vals);
       g_modbus_master_config.total_requests++;
       if (err == MB_OK) {
@@ -429,11 +674,12 @@ void cli_cmd_mb_reset_backoff(uint8_t argc, char **argv) {
     uint8_t slave_id = atoi(argv[0]);
     if (slave_id > 0) {
       // Reset specific slave
+      mb_async_state_t *bus_state = &g_mb_async[mb_async_bus_of(slave_id)];
       for (uint8_t i = 0; i < MB_SLAVE_BACKOFF_MAX; i++) {
-        if (g_mb_async.slave_backoff[i].slave_id == slave_id) {
-          g_mb_async.slave_backoff[i].backoff_ms = 0;
-          g_mb_async.slave_backoff[i].timeout_count = 0;
-          g_mb_async.slave_backoff[i].success_count = 0;
+        if (bus_state->slave_backoff[i].slave_id == slave_id) {
+          bus_state->slave_backoff[i].backoff_ms = 0;
+          bus_state->slave_backoff[i].timeout_count = 0;
+          bus_state->slave_backoff[i].success_count = 0;
           debug_printf("[OK] Backoff nulstillet for slave %d\n", slave_id);
           return;
         }
@@ -443,7 +689,9 @@ void cli_cmd_mb_reset_backoff(uint8_t argc, char **argv) {
     }
   }
   // Reset all
-  memset(g_mb_async.slave_backoff, 0, sizeof(g_mb_async.slave_backoff));
+  for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+    memset(g_mb_async[bus].slave_backoff, 0, sizeof(g_mb_async[bus].slave_backoff));
+  }
   debug_println("[OK] Backoff nulstillet for alle slaves");
 }
 
@@ -517,10 +765,18 @@ void cli_cmd_show_modbus_master() {
   } else {
     debug_printf("  Cache TTL: %u ms\n", g_modbus_master_config.cache_ttl_ms);
   }
-  debug_printf("  Cache size: %u / %d (max)\n",
-               g_modbus_master_config.cache_max_entries, MB_CACHE_MAX_ENTRIES);
+  debug_printf("  Cache size: %u / %u (max)\n",
+               g_modbus_master_config.cache_max_entries, mb_async_cache_limit());
   debug_printf("  Queue size: %u / %d (max)\n",
                g_modbus_master_config.queue_max_size, MB_ASYNC_QUEUE_SIZE);
+  debug_printf("  Read coalescing: %s (gap %u)\n",
+               g_modbus_master_config.coalesce_enabled ? "ON" : "OFF", g_modbus_master_config.coalesce_gap);
+  {
+    char always[64];
+    cli_format_write_always(always, sizeof(always));
+    debug_printf("  Write combining: %s (write-always slaves: %s)\n",
+                 g_modbus_master_config.write_combine ? "ON" : "OFF", always);
+  }
   debug_printf("\n");
 
   debug_printf("Statistics:\n");
@@ -537,25 +793,117 @@ void cli_cmd_show_modbus_master() {
                   : 0.0);
   debug_printf("  CRC errors: %u\n", g_modbus_master_config.crc_errors);
   debug_printf("  Exceptions: %u\n", g_modbus_master_config.exception_errors);
+
+  // Response wait (v7.9.8.13)
+  const ModbusMasterWaitStats *wait_stats = modbus_master_get_wait_stats(0);
+  int core_load = modbus_master_get_core_load();
+  debug_printf("  DE control: %s\n", wait_stats->hw_rs485 ? "UART (RS485 half-duplex)" : "GPIO");
+  debug_printf("  RX wait: %lu events, blocked %.1f s, busy %.1f s\n",
+               (unsigned long)wait_stats->rx_events, wait_stats->wait_us / 1e6, wait_stats->busy_us / 1e6);
+  if (core_load >= 0) {
+    debug_printf("  Core 0 load: %d%%\n", core_load);
+  } else {
+    debug_printf("  Core 0 load: n/a (FreeRTOS run-time stats disabled)\n");
+  }
   debug_printf("\n");
 
   // Async cache statistics (v7.7.0)
   const mb_async_state_t *async_state = mb_async_get_state();
   debug_printf("Async Cache (v7.7.0):\n");
   debug_printf("  Task: %s\n", async_state->task_running ? "RUNNING" : "STOPPED");
-  debug_printf("  Cache entries: %u / %d\n", async_state->entry_count, MB_CACHE_MAX_ENTRIES);
+  debug_printf("  Cache entries: %u / %u (%s)\n", async_state->entry_count,
+               async_state->cache_capacity, async_state->cache_in_psram ? "PSRAM" : "DRAM");
   debug_printf("  Queue pending: %u / %d (hwm: %u)\n",
-               async_state->pq_count, MB_ASYNC_QUEUE_SIZE,
+               (unsigned)async_state->pq_count, MB_ASYNC_QUEUE_SIZE,
                async_state->queue_high_watermark);
   debug_printf("  Cache hits: %u\n", async_state->cache_hits);
   debug_printf("  Cache misses: %u\n", async_state->cache_misses);
+  debug_printf("  Cache evictions: %u\n", async_state->cache_evictions);
   debug_printf("  Queue full drops: %u\n", async_state->queue_full_count);
   debug_printf("  Priority drops: %u\n", async_state->priority_drops);
+  debug_printf("  Queue classes: write %u, fresh %u, refresh %u (contention: %u, dedup: %u)\n",
+               (unsigned)async_state->pq_ring[MB_PRIO_WRITE].count,
+               (unsigned)async_state->pq_ring[MB_PRIO_READ_FRESH].count,
+               (unsigned)async_state->pq_ring[MB_PRIO_READ_REFRESH].count,
+               (unsigned)async_state->queue_contention, (unsigned)async_state->queue_dedup);
+  debug_printf("  Payload slots: %u/%u i brug (alloc fejl: %u)\n",
+               (unsigned)mb_payload_in_use(), (unsigned)MB_PAYLOAD_SLOTS,
+               (unsigned)mb_payload_alloc_failures());
   debug_printf("  Async requests: %u\n", async_state->total_requests);
   debug_printf("  Async errors: %u\n", async_state->total_errors);
   debug_printf("  Async timeouts: %u\n", async_state->total_timeouts);
+  debug_printf("  Coalesced: %u reads in %u blocks (%u fallbacks), bus tid sparet: %.1f s\n",
+               async_state->coalesced_reads, async_state->coalesced_blocks,
+               async_state->coalesce_fallbacks, async_state->coalesce_saved_us / 1e6);
+  debug_printf("  Writes: %u kombineret, %u uændrede sprunget over, %u i %u blokke (%u fallbacks)\n",
+               async_state->write_combined, async_state->write_skipped,
+               async_state->write_block_members, async_state->write_blocks, async_state->write_fallbacks);
+  debug_printf("\n");
+
+  // Buses (v7.9.8.14)
+  debug_printf("Buses:\n");
+  debug_printf("  %-3s %-6s %-8s %-8s %-6s %-5s %-9s %-8s %-8s %s\n",
+               "Bus", "UART", "State", "Baud", "Serial", "Queue", "Cache", "Requests", "Errors", "Timeouts");
+  for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+    const mb_async_state_t *bs = mb_async_get_bus_state(bus);
+    char uart[8], serial[8], cache[12];
+    uint8_t parity = g_modbus_master_config.parity;
+    uint8_t stop_bits = g_modbus_master_config.stop_bits;
+    if (bus > 0) {
+      parity = g_persist_config.mb_buses[bus - 1].parity;
+      stop_bits = g_persist_config.mb_buses[bus - 1].stop_bits;
+    }
+    snprintf(uart, sizeof(uart), "UART%u", bus == 0 ? g_persist_config.modbus_master_uart : MODBUS_MASTER_BUS1_UART);
+    if (strcmp(modbus_master_transport_name(bus), "uart") != 0) {
+      snprintf(uart, sizeof(uart), "%s", modbus_master_transport_name(bus));  // v7.9.8.18: non-UART transport
+    }
+    snprintf(serial, sizeof(serial), "8%c%u", parity == 1 ? 'E' : parity == 2 ? 'O' : 'N', stop_bits);
+    snprintf(cache, sizeof(cache), "%u/%u", bs->entry_count, bs->cache_capacity);
+    const char *state = bs->task_running ? "RUNNING"
+                      : (bus > 0 && g_persist_config.mb_buses[bus - 1].enabled) ? "FEJL" : "OFF";
+    debug_printf("  %-3u %-6s %-8s %-8lu %-6s %-5u %-9s %-8lu %-8lu %lu\n",
+                 bus, uart, state, (unsigned long)modbus_master_bus_baudrate(bus), serial,
+                 (unsigned)bs->pq_count, cache, (unsigned long)bs->total_requests,
+                 (unsigned long)bs->total_errors, (unsigned long)bs->total_timeouts);
+  }
+  bool has_route = false;
+  for (uint8_t i = 0; i < MB_BUS_ROUTES_MAX; i++) {
+    const ModbusBusRoute *r = &g_persist_config.mb_bus_routes[i];
+    if (r->first_slave == 0) continue;
+    if (!has_route) debug_printf("Routes (øvrige slaves → bus 0):\n");
+    has_route = true;
+    debug_printf("  %u: slaves %u-%u → bus %u\n", i + 1, r->first_slave, r->last_slave, r->bus);
+  }
   debug_printf("\n");
 
+  // Poll groups (v7.9.8.12)
+  bool has_poll = false;
+  for (uint8_t i = 0; i < MB_POLL_GROUPS_MAX; i++) {
+    if (mb_async_poll_state(i)->cfg.slave_id != 0) {
+      has_poll = true;
+      break;
+    }
+  }
+  if (has_poll) {
+    debug_printf("Poll Groups:\n");
+    debug_printf("  %-3s %-5s %-4s %-11s %-8s %-4s %-8s %-8s %-7s %-7s %s\n",
+                 "ID", "Slave", "FC", "Range", "Period", "Prio", "Rate", "Polls", "Errors", "Missed", "Late avg/max");
+    for (uint8_t i = 0; i < MB_POLL_GROUPS_MAX; i++) {
+      const mb_poll_state_t *g = mb_async_poll_state(i);
+      if (g->cfg.slave_id == 0) continue;
+      char range[16], period[12], rate[12];
+      snprintf(range, sizeof(range), "%u+%u", g->cfg.start, g->cfg.count);
+      snprintf(period, sizeof(period), "%lums", (unsigned long)g->cfg.period_ms);
+      snprintf(rate, sizeof(rate), "%.2fHz", mb_poll_rate_hz(g));
+      debug_printf("  %-3u %-5u FC%02u %-11s %-8s %-4u %-8s %-8lu %-7lu %-7lu %lu/%lu ms%s\n",
+                   i + 1, g->cfg.slave_id, g->cfg.fc, range, period, g->cfg.priority, rate,
+                   (unsigned long)g->polls, (unsigned long)g->errors, (unsigned long)g->missed,
+                   (unsigned long)(g->polls ? g->late_sum_ms / g->polls : 0),
+                   (unsigned long)g->late_max_ms, g->cfg.enabled ? "" : " (disabled)");
+    }
+    debug_printf("\n");
+  }
+
   // Adaptive backoff per slave (v7.9.3)
   bool has_backoff = false;
   for (uint8_t i = 0; i < MB_SLAVE_BACKOFF_MAX; i++) {
@@ -582,8 +930,9 @@ void cli_cmd_show_modbus_master() {
     debug_printf("Cache Entries:\n");
     debug_printf("  %-4s %-5s %-7s %-5s %-7s %-6s %s\n",
                  "Slot", "Slave", "Addr", "FC", "Value", "Status", "Age");
-    for (uint8_t i = 0; i < async_state->entry_count; i++) {
-      const mb_cache_entry_t *e = &async_state->entries[i];
+    mb_cache_entry_t entry;
+    for (uint16_t i = 0; mb_cache_entry_at(async_state, i, &entry); i++) {
+      const mb_cache_entry_t *e = &entry;
       const char *status_str = "EMPTY";
       if (e->status == MB_CACHE_PENDING) status_str = "PEND";
       else if (e->status == MB_CACHE_VALID) status_str = "VALID";
@@ -629,8 +978,103 @@ void cli_cmd_show_modbus_master() {
   debug_printf("  set modbus-master inter-frame-delay <ms>\n");
   debug_printf("  set modbus-master max-requests <count>\n");
   debug_printf("  set modbus-master cache-ttl <ms>   (0=never expire)\n");
-  debug_printf("  set modbus-master cache-size <1-32> (default: 32)\n");
+  debug_printf("  set modbus-master cache-size <1-1024> (default: 32)\n");
   debug_printf("  set modbus-master queue-size <4-32> (default: 16)\n");
+  debug_printf("  set modbus-master coalesce <on|off> (default: on)\n");
+  debug_printf("  set modbus-master coalesce-gap <0-32> (default: 4)\n");
+  debug_printf("  set modbus-master write-combine <on|off> (default: on)\n");
+  debug_printf("  set modbus-master write-always <id>|<first>-<last> <on|off> (default: off)\n");
+  debug_printf("  set modbus-master bus <1> enabled:on baud:19200 parity:none stop:1\n");
+  debug_printf("  set modbus-master route <1-%d> slaves:10-20 bus:1\n", MB_BUS_ROUTES_MAX);
   debug_printf("  Brug 'set modbus-master ?' for detaljeret hjælp\n");
+  debug_printf("  Brug 'show modbus-master profile' for latency/bus-udnyttelse\n");
   debug_printf("\n");
 }
+
+/* ============================================================================
+ * PROFILE (v7.9.8.17)
+ * ============================================================================ */
+
+// One line per histogram, "<=250:12 ... >100000:0"
+static void cli_print_profile_histogram(const char *label, uint8_t kind, const mb_profile_hist_t *h) {
+  const uint32_t *bounds = mb_profile_bounds(kind);
+  debug_printf("%s", label);
+  for (uint8_t b = 0; b < MB_PROFILE_BUCKETS - 1; b++) {
+    debug_printf(" <=%lu:%lu", (unsigned long)bounds[b], (unsigned long)h->bucket[b]);
+  }
+  debug_printf(" >%lu:%lu (%s)\n", (unsigned long)bounds[MB_PROFILE_BUCKETS - 2],
+               (unsigned long)h->bucket[MB_PROFILE_BUCKETS - 1],
+               kind == MB_PROFILE_WIRE_BYTES ? "bytes" : "us");
+}
+
+static void cli_print_profile_row(const char *id, const mb_profile_stats_t *st) {
+  const mb_profile_hist_t *lat = &st->hist[MB_PROFILE_LATENCY];
+  const mb_profile_hist_t *ta = &st->hist[MB_PROFILE_TURNAROUND];
+  const mb_profile_hist_t *wb = &st->hist[MB_PROFILE_WIRE_BYTES];
+  debug_printf("  %-6s %-8lu %-7lu %7.1f/%-7.1f %7.1f/%-8.1f %lu\n", id,
+               (unsigned long)st->transactions, (unsigned long)st->errors,
+               lat->count ? (float)lat->sum / lat->count / 1000.0f : 0.0f, lat->max / 1000.0f,
+               ta->count ? (float)ta->sum / ta->count / 1000.0f : 0.0f, ta->max / 1000.0f,
+               (unsigned long)(wb->count ? wb->sum / wb->count : 0));
+}
+
+static void cli_print_profile_detail(const mb_profile_stats_t *st) {
+  cli_print_profile_histogram("         Latency:   ", MB_PROFILE_LATENCY, &st->hist[MB_PROFILE_LATENCY]);
+  cli_print_profile_histogram("         Turnaround:", MB_PROFILE_TURNAROUND, &st->hist[MB_PROFILE_TURNAROUND]);
+  cli_print_profile_histogram("         Bytes:     ", MB_PROFILE_WIRE_BYTES, &st->hist[MB_PROFILE_WIRE_BYTES]);
+}
+
+void cli_cmd_show_modbus_master_profile(bool verbose) {
+  debug_printf("\n=== MODBUS MASTER PROFILE ===\n");
+  debug_printf("Bus-udnyttelse over de seneste %u s (%u bit/tegn):\n",
+               MB_PROFILE_WINDOW_S, MB_PROFILE_BITS_PER_CHAR);
+  debug_printf("  %-3s %-8s %-9s %-10s %-12s %s\n",
+               "Bus", "Baud", "Udnyttet", "Optaget", "Transakt.", "Bytes (wire tid)");
+  for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+    const mb_profile_bus_t *pb = mb_profile_get_bus(bus);
+    char util[12], occ[12];
+    snprintf(util, sizeof(util), "%.1f%%", mb_profile_bus_utilisation(bus));
+    snprintf(occ, sizeof(occ), "%.1f%%", mb_profile_bus_occupancy(bus));
+    debug_printf("  %-3u %-8lu %-9s %-10s %-12lu %llu (%.1f s)\n",
+                 bus, (unsigned long)modbus_master_bus_baudrate(bus), util, occ,
+                 (unsigned long)pb->transactions, (unsigned long long)pb->bytes_total,
+                 pb->wire_us_total / 1e6);
+  }
+  debug_printf("\n");
+
+  debug_printf("Per function code (latency = kø → færdig, turnaround = sendt → første svar-byte):\n");
+  debug_printf("  %-6s %-8s %-7s %-15s %-16s %s\n",
+               "FC", "Antal", "Fejl", "Lat. ms avg/max", "Turn. ms avg/max", "Bytes avg");
+  for (uint8_t i = 0; i < MB_PROFILE_FCS; i++) {
+    const mb_profile_stats_t *st = mb_profile_get_fc(i);
+    if (st->transactions == 0 && st->hist[MB_PROFILE_LATENCY].count == 0) continue;
+    char id[8];
+    uint8_t fc = mb_profile_fc_of_index(i);
+    if (fc) snprintf(id, sizeof(id), "FC%02u", fc);
+    else snprintf(id, sizeof(id), "andre");
+    cli_print_profile_row(id, st);
+    if (verbose) cli_print_profile_detail(st);
+  }
+  debug_printf("\n");
+
+  debug_printf("Per slave (første %u slaves, resten under 'andre'):\n", MB_PROFILE_SLAVES);
+  debug_printf("  %-6s %-8s %-7s %-15s %-16s %s\n",
+               "Slave", "Antal", "Fejl", "Lat. ms avg/max", "Turn. ms avg/max", "Bytes avg");
+  for (uint8_t i = 0; i <= MB_PROFILE_SLAVES; i++) {
+    const mb_profile_slave_t *sl = mb_profile_get_slave(i);
+    if (sl->stats.transactions == 0 && sl->stats.hist[MB_PROFILE_LATENCY].count == 0) continue;
+    char id[8];
+    if (sl->slave_id) snprintf(id, sizeof(id), "%u", sl->slave_id);
+    else snprintf(id, sizeof(id), "andre");
+    cli_print_profile_row(id, &sl->stats);
+    if (verbose) cli_print_profile_detail(&sl->stats);
+  }
+  debug_printf("\n");
+  if (!verbose) debug_printf("  Brug 'show modbus-master profile verbose' for histogrammer\n");
+  debug_printf("  Nulstil med 'reset modbus-master profile'\n\n");
+}
+
+void cli_cmd_reset_modbus_master_profile() {
+  mb_profile_reset();
+  debug_println("Modbus master profil nulstillet");
+}
@@ -6,6 +6,9 @@
 #include <Arduino.h>
 #include "cli_commands_modbus_slave.h"
 #include "config_struct.h"
+#include "modbus_tcp_server.h"
+#include "modbus_server.h"
+#include "modbus_fc_diag.h"
 #include "constants.h"
 #include "debug.h"
 
@@ -53,6 +56,7 @@ void cli_cmd_set_modbus_slave_baudrate(uint32_t baudrate) {
   }
 
   g_persist_config.modbus_slave.baudrate = baudrate;
+  modbus_server_apply_line_config();
 
   uint16_t eff = modbus_effective_inter_frame(g_persist_config.modbus_slave.inter_frame_delay, baudrate);
   bool is_auto = (g_persist_config.modbus_slave.inter_frame_delay == 0);
@@ -98,6 +102,7 @@ void cli_cmd_set_modbus_slave_inter_frame_delay(uint16_t ms) {
   }
 
   g_persist_config.modbus_slave.inter_frame_delay = ms;
+  modbus_server_apply_line_config();
 
   if (ms == 0) {
     uint16_t t35 = modbus_calc_t35_ms(g_persist_config.modbus_slave.baudrate);
@@ -109,6 +114,48 @@ void cli_cmd_set_modbus_slave_inter_frame_delay(uint16_t ms) {
   debug_println("NOTE: Use 'save' to persist to NVS");
 }
 
+/* ============================================================================
+ * MODBUS TCP SET COMMANDS (v7.9.8.0, FEAT-145)
+ * ============================================================================ */
+
+void cli_cmd_set_modbus_tcp_enabled(bool enabled) {
+  g_persist_config.modbus_tcp.enabled = enabled ? 1 : 0;
+  debug_printf("[OK] Modbus TCP %s (takes effect on reboot)\n", enabled ? "ENABLED" : "DISABLED");
+  debug_println("NOTE: Use 'save' to persist to NVS");
+}
+
+void cli_cmd_set_modbus_tcp_port(uint16_t port) {
+  if (port == 0) {
+    debug_println("ERROR: Invalid port (must be 1-65535)");
+    return;
+  }
+
+  g_persist_config.modbus_tcp.port = port;
+  debug_printf("[OK] Modbus TCP port: %u (takes effect on reboot)\n", port);
+  debug_println("NOTE: Use 'save' to persist to NVS");
+}
+
+void cli_cmd_set_modbus_tcp_max_clients(uint8_t clients) {
+  if (clients < 1 || clients > MODBUS_TCP_MAX_CLIENTS) {
+    debug_printf("ERROR: Invalid max-clients (must be 1-%d)\n", MODBUS_TCP_MAX_CLIENTS);
+    return;
+  }
+
+  g_persist_config.modbus_tcp.max_clients = clients;
+  debug_printf("[OK] Modbus TCP max clients: %u (takes effect on reboot)\n", clients);
+  debug_println("NOTE: Use 'save' to persist to NVS");
+}
+
+void cli_cmd_set_modbus_tcp_idle_timeout(uint16_t seconds) {
+  g_persist_config.modbus_tcp.idle_timeout_s = seconds;
+  if (seconds == 0) {
+    debug_println("[OK] Modbus TCP idle timeout: disabled (takes effect on reboot)");
+  } else {
+    debug_printf("[OK] Modbus TCP idle timeout: %u s (takes effect on reboot)\n", seconds);
+  }
+  debug_println("NOTE: Use 'save' to persist to NVS");
+}
+
 /* ============================================================================
  * SHOW COMMAND
  * ============================================================================ */
@@ -149,4 +196,69 @@ void cli_cmd_show_modbus_slave() {
   debug_printf("  CRC errors: %u\n", g_persist_config.modbus_slave.crc_errors);
   debug_printf("  Exceptions: %u\n", g_persist_config.modbus_slave.exception_errors);
   debug_printf("\n");
+
+  const ModbusDiagCounters *diag = modbus_diag_counters();
+  debug_printf("Diagnostics (FC08, since boot/clear):\n");
+  debug_printf("  Bus messages: %lu\n", (unsigned long)diag->bus_messages);
+  debug_printf("  Bus comm errors: %lu\n", (unsigned long)diag->bus_comm_errors);
+  debug_printf("  Bus exceptions: %lu\n", (unsigned long)diag->bus_exceptions);
+  debug_printf("  Server messages: %lu\n", (unsigned long)diag->server_messages);
+  debug_printf("  Server no response: %lu\n", (unsigned long)diag->server_no_response);
+  debug_printf("\n");
+
+  const ModbusServerLatencyStats *lat = modbus_server_get_latency_stats();
+  debug_printf("Response latency (frame end -> TX):\n");
+  if (lat->count > 0) {
+    debug_printf("  Avg: %lu us, Max: %lu us (%lu responses)\n",
+                 (unsigned long)(lat->sum_us / lat->count), (unsigned long)lat->max_us,
+                 (unsigned long)lat->count);
+  } else {
+    debug_printf("  (ingen svar endnu)\n");
+  }
+  debug_printf("\n");
+}
+
+void cli_cmd_show_modbus_tcp() {
+  const ModbusTcpConfig *cfg = &g_persist_config.modbus_tcp;
+  const ModbusTcpStats *st = modbus_tcp_server_get_stats();
+
+  debug_printf("\n=== MODBUS TCP SERVER ===\n");
+  debug_printf("Config: %s\n", cfg->enabled ? "ENABLED" : "DISABLED");
+  debug_printf("Status: %s\n", modbus_tcp_server_is_running() ? "RUNNING" : "STOPPED");
+  debug_printf("  Port: %u\n", cfg->port);
+  debug_printf("  Max clients: %u\n", cfg->max_clients);
+  if (cfg->idle_timeout_s == 0) {
+    debug_printf("  Idle timeout: disabled\n");
+  } else {
+    debug_printf("  Idle timeout: %u s\n", cfg->idle_timeout_s);
+  }
+  debug_printf("  Unit ID: 0, 255 or %u (slave-id)\n", g_persist_config.modbus_slave.slave_id);
+  debug_printf("\n");
+
+  ModbusTcpClientInfo clients[MODBUS_TCP_MAX_CLIENTS];
+  int active = modbus_tcp_server_get_clients(clients);
+  debug_printf("Clients: %d active\n", active);
+  uint32_t now = millis();
+  for (int i = 0; i < MODBUS_TCP_MAX_CLIENTS; i++) {
+    if (!clients[i].active) continue;
+    uint32_t ip = clients[i].ip_addr;
+    debug_printf("  [%d] %u.%u.%u.%u:%u  up %lu s  requests %lu\n", i,
+                 (unsigned)(ip & 0xFF), (unsigned)((ip >> 8) & 0xFF),
+                 (unsigned)((ip >> 16) & 0xFF), (unsigned)((ip >> 24) & 0xFF),
+                 clients[i].port,
+                 (unsigned long)((now - clients[i].connected_ms) / 1000),
+                 (unsigned long)clients[i].requests);
+  }
+  debug_printf("\n");
+
+  debug_printf("Statistics:\n");
+  debug_printf("  Connections: %lu (rejected %lu)\n",
+               (unsigned long)st->connections_total, (unsigned long)st->connections_rejected);
+  debug_printf("  Requests: %lu\n", (unsigned long)st->requests);
+  debug_printf("  Exceptions: %lu\n", (unsigned long)st->exceptions);
+  debug_printf("  Protocol errors: %lu\n", (unsigned long)st->protocol_errors);
+  debug_printf("  Unit ID mismatch: %lu\n", (unsigned long)st->unit_mismatch);
+  debug_printf("  Bytes RX/TX: %lu / %lu\n", (unsigned long)st->bytes_rx, (unsigned long)st->bytes_tx);
+  debug_printf("  Max pipeline depth: %u\n", st->max_pipeline_depth);
+  debug_printf("\n");
 }
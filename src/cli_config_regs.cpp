@@ -46,10 +46,10 @@ void cli_cmd_set_reg_static(uint8_t argc, char* argv[]) {
 
   // Parse address
   uint16_t address = atoi(argv[0]);
-  if (address >= HOLDING_REGS_SIZE) {
-    debug_print("SET HOLDING-REG STATIC: address out of range (max ");
+  if (registers_holding_span(address, 1) != 1) {
+    debug_print("SET HOLDING-REG STATIC: address out of range (0-");
     debug_print_uint(HOLDING_REGS_SIZE - 1);
-    debug_println(")");
+    debug_println(" or a page mapped with 'set reg-map')");
     return;
   }
 
@@ -103,16 +103,14 @@ void cli_cmd_set_reg_static(uint8_t argc, char* argv[]) {
 
   // Validate address range for multi-register types
   if ((value_type == MODBUS_TYPE_DINT || value_type == MODBUS_TYPE_DWORD || value_type == MODBUS_TYPE_REAL)) {
-    if (address + 1 >= HOLDING_REGS_SIZE) {
+    if (registers_holding_span(address, 2) != 2) {
       debug_print("SET HOLDING-REG STATIC: type ");
       if (value_type == MODBUS_TYPE_DINT) debug_print("dint");
       else if (value_type == MODBUS_TYPE_DWORD) debug_print("dword");
       else debug_print("real");
       debug_print(" requires 2 registers, address ");
       debug_print_uint(address);
-      debug_print(" out of range (max ");
-      debug_print_uint(HOLDING_REGS_SIZE - 2);
-      debug_println(")");
+      debug_println(" out of range");
       return;
     }
 
@@ -256,10 +254,10 @@ void cli_cmd_set_reg_dynamic(uint8_t argc, char* argv[]) {
 
   // Parse address
   uint16_t address = atoi(argv[0]);
-  if (address >= HOLDING_REGS_SIZE) {
-    debug_print("SET HOLDING-REG DYNAMIC: address out of range (max ");
+  if (registers_holding_span(address, 1) != 1) {
+    debug_print("SET HOLDING-REG DYNAMIC: address out of range (0-");
     debug_print_uint(HOLDING_REGS_SIZE - 1);
-    debug_println(")");
+    debug_println(" or a page mapped with 'set reg-map')");
     return;
   }
 
@@ -465,7 +463,171 @@ void cli_cmd_show_regs(void) {
     }
   }
 
-  if (g_persist_config.static_reg_count == 0 && g_persist_config.dynamic_reg_count == 0) {
+  // Show sparse register pages (v7.9.8.22)
+  uint8_t page_decls = 0;
+  for (uint8_t i = 0; i < REG_PAGE_DECL_MAX; i++) {
+    const RegPageDecl* decl = &g_persist_config.reg_pages[i];
+    if (decl->count == 0) continue;
+    if (page_decls++ == 0) debug_println("# Sparse register pages");
+    debug_print("set reg-map ");
+    debug_print(decl->bank == REG_BANK_IR ? "ir " : "hr ");
+    debug_print_uint(decl->start);
+    debug_print(" ");
+    debug_print_uint(decl->count);
+    debug_println("");
+  }
+
+  if (g_persist_config.static_reg_count == 0 && g_persist_config.dynamic_reg_count == 0 && page_decls == 0) {
     debug_println("# No registers configured");
   }
 }
+
+/* ============================================================================
+ * SPARSE REGISTER PAGES (v7.9.8.22)
+ * ============================================================================ */
+
+static void print_reg_map_usage(void) {
+  debug_println("  Usage: set reg-map hr|ir <start> <count>   - Map pages (64 registers each) above the flat array");
+  debug_println("         set reg-map <1-16> delete           - Remove declaration (pages stay until reboot)");
+  debug_println("  Example: set reg-map hr 1000 200           - HR 1000-1199 (Modbus 41001-41200)");
+}
+
+void cli_cmd_set_reg_map(uint8_t argc, char* argv[]) {
+  if (argc < 2) {
+    debug_println("SET REG-MAP: missing arguments");
+    print_reg_map_usage();
+    return;
+  }
+
+  // set reg-map <slot> delete
+  if (!strcasecmp(argv[1], "delete")) {
+    uint8_t slot = atoi(argv[0]);
+    if (slot < 1 || slot > REG_PAGE_DECL_MAX || g_persist_config.reg_pages[slot - 1].count == 0) {
+      debug_println("SET REG-MAP: no declaration with that number (see 'show reg-map')");
+      return;
+    }
+    memset(&g_persist_config.reg_pages[slot - 1], 0, sizeof(RegPageDecl));
+    debug_print("Reg-map #");
+    debug_print_uint(slot);
+    debug_println(" deleted (mapped pages are released at next reboot after 'save')");
+    return;
+  }
+
+  if (argc < 3) {
+    debug_println("SET REG-MAP: missing arguments");
+    print_reg_map_usage();
+    return;
+  }
+
+  reg_bank_t bank;
+  if (!strcasecmp(argv[0], "hr")) bank = REG_BANK_HR;
+  else if (!strcasecmp(argv[0], "ir")) bank = REG_BANK_IR;
+  else {
+    debug_println("SET REG-MAP: bank must be hr or ir");
+    return;
+  }
+
+  long start = atol(argv[1]);
+  long count = atol(argv[2]);
+  uint16_t flat = (bank == REG_BANK_HR) ? HOLDING_REGS_SIZE : INPUT_REGS_SIZE;
+  if (start < 0 || count < 1 || start + count > 0x10000) {
+    debug_println("SET REG-MAP: range must lie within 0-65535");
+    return;
+  }
+  if (start + count <= flat) {
+    debug_print("SET REG-MAP: range lies in the flat array (0-");
+    debug_print_uint(flat - 1);
+    debug_println("), nothing to map");
+    return;
+  }
+
+  int8_t free_slot = -1;
+  for (uint8_t i = 0; i < REG_PAGE_DECL_MAX; i++) {
+    const RegPageDecl* decl = &g_persist_config.reg_pages[i];
+    if (decl->count == 0) {
+      if (free_slot < 0) free_slot = i;
+    } else if (decl->bank == bank && decl->start == start && decl->count == count) {
+      debug_println("SET REG-MAP: already declared");
+      return;
+    }
+  }
+  if (free_slot < 0) {
+    debug_print("SET REG-MAP: all ");
+    debug_print_uint(REG_PAGE_DECL_MAX);
+    debug_println(" declarations in use");
+    return;
+  }
+
+  RegPageDecl* decl = &g_persist_config.reg_pages[free_slot];
+  decl->bank = bank;
+  decl->start = (uint16_t)start;
+  decl->count = (uint16_t)count;
+
+  bool mapped = registers_page_map(bank, decl->start, decl->count);
+  uint16_t used = 0, max_pages = 0;
+  registers_page_stats(&used, &max_pages);
+
+  debug_print("Reg-map #");
+  debug_print_uint(free_slot + 1);
+  debug_print(": ");
+  debug_print(bank == REG_BANK_HR ? "HR " : "IR ");
+  debug_print_uint(decl->start);
+  debug_print("-");
+  debug_print_uint(decl->start + decl->count - 1);
+  debug_print(mapped ? " mapped" : " PARTLY mapped (page pool full)");
+  debug_print(", pages in use ");
+  debug_print_uint(used);
+  debug_print("/");
+  debug_print_uint(max_pages);
+  debug_println("");
+}
+
+void cli_cmd_show_reg_map(void) {
+  uint16_t used = 0, max_pages = 0;
+  registers_page_stats(&used, &max_pages);
+
+  debug_println("\n=== SPARSE REGISTER PAGES ===");
+  debug_print("Flat arrays: HR 0-");
+  debug_print_uint(HOLDING_REGS_SIZE - 1);
+  debug_print(", IR 0-");
+  debug_print_uint(INPUT_REGS_SIZE - 1);
+  debug_println("");
+  debug_print("Pages in use: ");
+  debug_print_uint(used);
+  debug_print("/");
+  debug_print_uint(max_pages);
+  debug_print(" (");
+  debug_print_uint(REG_PAGE_WORDS);
+  debug_print(" registers, ");
+  debug_print_uint(used * REG_PAGE_WORDS * 2);
+  debug_println(" bytes heap)");
+
+  debug_println("\nDeclared (config):");
+  bool any = false;
+  for (uint8_t i = 0; i < REG_PAGE_DECL_MAX; i++) {
+    const RegPageDecl* decl = &g_persist_config.reg_pages[i];
+    if (decl->count == 0) continue;
+    any = true;
+    debug_print("  #");
+    debug_print_uint(i + 1);
+    debug_print(decl->bank == REG_BANK_IR ? "  IR " : "  HR ");
+    debug_print_uint(decl->start);
+    debug_print("-");
+    debug_print_uint(decl->start + decl->count - 1);
+    debug_println("");
+  }
+  if (!any) debug_println("  (none)");
+
+  uint16_t pages[REG_PAGE_POOL_MAX];
+  const reg_bank_t banks[2] = { REG_BANK_HR, REG_BANK_IR };
+  for (uint8_t b = 0; b < 2; b++) {
+    uint16_t n = registers_page_list(banks[b], pages, REG_PAGE_POOL_MAX);
+    debug_print(b == 0 ? "\nMapped HR pages:" : "\nMapped IR pages:");
+    if (n == 0) debug_print(" (none)");
+    for (uint16_t i = 0; i < n; i++) {
+      debug_print(" ");
+      debug_print_uint(pages[i]);
+    }
+    debug_println("");
+  }
+}
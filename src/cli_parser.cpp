@@ -178,6 +178,7 @@ static const char* normalize_alias(const char* s) {
   // Modbus Master/Slave/Mode commands
   if (str_eq_i(s, "MODBUS-MASTER") || str_eq_i(s, "MB-MASTER")) return "MODBUS-MASTER";
   if (str_eq_i(s, "MODBUS-SLAVE") || str_eq_i(s, "MB-SLAVE")) return "MODBUS-SLAVE";
+  if (str_eq_i(s, "MODBUS-TCP") || str_eq_i(s, "MB-TCP")) return "MODBUS-TCP";
   if (str_eq_i(s, "MODBUS")) return "MODBUS";
   if (str_eq_i(s, "MB")) return "MB";
   if (str_eq_i(s, "MODE")) return "MODE";
@@ -212,6 +213,14 @@ static const char* normalize_alias(const char* s) {
   if (str_eq_i(s, "CACHE-TTL") || str_eq_i(s, "CACHETTL") || str_eq_i(s, "CACHE_TTL") || str_eq_i(s, "TTL")) return "CACHE-TTL";
   if (str_eq_i(s, "CACHE-SIZE") || str_eq_i(s, "CACHESIZE") || str_eq_i(s, "CACHE_SIZE")) return "CACHE-SIZE";
   if (str_eq_i(s, "QUEUE-SIZE") || str_eq_i(s, "QUEUESIZE") || str_eq_i(s, "QUEUE_SIZE")) return "QUEUE-SIZE";
+  if (str_eq_i(s, "COALESCE-GAP") || str_eq_i(s, "COALESCEGAP") || str_eq_i(s, "COALESCE_GAP")) return "COALESCE-GAP";
+  if (str_eq_i(s, "COALESCE")) return "COALESCE";
+  if (str_eq_i(s, "WRITE-COMBINE") || str_eq_i(s, "WRITECOMBINE") || str_eq_i(s, "WRITE_COMBINE")) return "WRITE-COMBINE";
+  if (str_eq_i(s, "WRITE-ALWAYS") || str_eq_i(s, "WRITEALWAYS") || str_eq_i(s, "WRITE_ALWAYS")) return "WRITE-ALWAYS";
+  if (str_eq_i(s, "POLL") || str_eq_i(s, "POLL-GROUP")) return "POLL";
+  if (str_eq_i(s, "PORT")) return "PORT";
+  if (str_eq_i(s, "MAX-CLIENTS") || str_eq_i(s, "MAXCLIENTS") || str_eq_i(s, "CLIENTS")) return "MAX-CLIENTS";
+  if (str_eq_i(s, "IDLE-TIMEOUT") || str_eq_i(s, "IDLETIMEOUT") || str_eq_i(s, "IDLE")) return "IDLE-TIMEOUT";
 
   // Logic subcommands
   if (str_eq_i(s, "PROGRAM") || str_eq_i(s, "PROGRAMS")) return "PROGRAM";
@@ -224,6 +233,7 @@ static const char* normalize_alias(const char* s) {
   if (str_eq_i(s, "ST")) return "ST";
 
   // System commands (for SET context)
+  if (str_eq_i(s, "REG-MAP") || str_eq_i(s, "REGMAP") || str_eq_i(s, "REG-PAGES")) return "REG-MAP";
   if (str_eq_i(s, "REG") || str_eq_i(s, "HOLDING-REG") || str_eq_i(s, "HOLDING_REG") ||
       str_eq_i(s, "H-REG") || str_eq_i(s, "HREG")) return "H-REG";
   if (str_eq_i(s, "COIL")) return "COIL";
@@ -294,8 +304,11 @@ static void print_show_help(void) {
   debug_println("");
   debug_println("  Modbus:");
   debug_println("    show modbus-slave      - Modbus Slave config");
+  debug_println("    show modbus-tcp        - Modbus TCP server (port 502)");
   debug_println("    show modbus-master     - Modbus Master config");
+  debug_println("    show modbus-master profile [verbose] - Latency + bus-udnyttelse");
   debug_println("    show registers         - Holding registers");
+  debug_println("    show reg-map           - Sparse HR/IR sider over 256/512");
   debug_println("    show inputs            - Input registers");
   debug_println("    show coils             - Coil states");
   debug_println("");
@@ -340,6 +353,7 @@ static void print_set_help(void) {
   debug_println("  Modbus:");
   debug_println("    set modbus mode <slave|master|off> - Transceiver mode");
   debug_println("    set modbus-slave ?        - Slave config (id, baud, parity, ...)");
+  debug_println("    set modbus-tcp ?          - Modbus TCP server (port, clients, ...)");
   debug_println("    set modbus-master ?       - Master config (baud, timeout, ...)");
   debug_println("    set reg <addr> <value>    - Skriv holding register");
   debug_println("    set coil <idx> <0|1>      - Skriv coil");
@@ -450,11 +464,26 @@ static void print_modbus_master_help(void) {
   debug_println("                                             (gælder samlet for alle 4 ST programmer)");
   debug_println("  set modbus-master cache-ttl <ms>          - Cache entry TTL (0=aldrig expire, default: 0)");
   debug_println("                                             Expired entries tvinger ny UART-transaktion");
-  debug_println("  set modbus-master cache-size <1-32>       - Max cache entries (default: 32)");
+  debug_println("  set modbus-master cache-size <1-1024>     - Max cache entries (default: 32, max 256 uden PSRAM)");
   debug_println("  set modbus-master queue-size <4-32>       - Max queue entries (default: 16)");
+  debug_println("  set modbus-master coalesce <on|off>       - Saml nabo-reads til én blok-read (default: on)");
+  debug_println("  set modbus-master coalesce-gap <0-32>     - Max ubrugte registre mellem reads i en blok (default: 4)");
+  debug_println("  set modbus-master write-combine <on|off>  - Sidste værdi vinder + nabo-writes som FC15/FC16 (default: on)");
+  debug_println("  set modbus-master write-always <id>|<a>-<b> <on|off>");
+  debug_println("                                             Send også uændrede writes til disse slaves (default: off)");
+  debug_println("  set modbus-master poll <1-16> slave:<id> fc:<1-4> start:<addr> count:<1-125> period:<ms> [priority:<n>]");
+  debug_println("                                             Poll group: cyklisk block read direkte i cachen");
+  debug_println("                                             (ST reads af adresserne bliver rene cache hits)");
+  debug_println("  set modbus-master poll <1-16> enable|disable|delete");
+  debug_println("  set modbus-master bus 1 enabled:on|off baud:<rate> parity:<none|even|odd> stop:<1|2> timeout:<ms> delay:<ms>");
+  debug_println("                                             Ekstra RS485 bus med egen queue, cache og task");
+  debug_println("  set modbus-master route <1-8> slaves:<first>-<last> bus:<0-1>");
+  debug_println("                                             Slave-ID interval → bus (øvrige slaves: bus 0)");
+  debug_println("  set modbus-master route <1-8> delete");
   debug_println("");
   debug_println("Hardware:");
   debug_println("  UART1: TX=GPIO25, RX=GPIO26, DE/RE=GPIO27");
+  debug_println("  Bus 1: spare UART, pins via 'set uart<n> tx/rx/dir' (skal konfigureres)");
   debug_println("");
   debug_println("ST Logic Functions:");
   debug_println("  MB_READ_COIL(slave_id, address) → BOOL     (async, cached)");
@@ -495,6 +524,21 @@ static void print_modbus_slave_help(void) {
   debug_println("");
 }
 
+static void print_modbus_tcp_help(void) {
+  debug_println("");
+  debug_println("Available 'set modbus-tcp' commands:");
+  debug_println("  set modbus-tcp enabled <on|off>          - Aktivér/deaktivér Modbus TCP server");
+  debug_println("  set modbus-tcp port <1-65535>            - Sæt TCP port (default: 502)");
+  debug_println("  set modbus-tcp max-clients <1-4>         - Maks samtidige klienter (default: 4)");
+  debug_println("  set modbus-tcp idle-timeout <s>          - Luk inaktive klienter (0=aldrig, default: 60)");
+  debug_println("");
+  debug_println("Unit ID: 0, 255 eller modbus-slave slave-id accepteres");
+  debug_println("Samme register-map og function codes som RTU slave");
+  debug_println("");
+  debug_println("NOTE: All changes require 'save' + 'reboot' to take effect");
+  debug_println("");
+}
+
 static void print_counter_help(void) {
   debug_println("");
   debug_println("Available 'set counter' commands:");
@@ -822,15 +866,26 @@ bool cli_parser_execute(char* line) {
       cli_cmd_show_watchdog();
       return true;
     } else if (!strcmp(what, "MODBUS-MASTER") || !strcmp(what, "MB-MASTER")) {
-      cli_cmd_show_modbus_master();
+      if (argc >= 3 && str_eq_i(argv[2], "PROFILE")) {
+        cli_cmd_show_modbus_master_profile(argc >= 4 && str_eq_i(argv[3], "VERBOSE"));
+      } else {
+        cli_cmd_show_modbus_master();
+      }
       return true;
     } else if (!strcmp(what, "MODBUS-SLAVE") || !strcmp(what, "MB-SLAVE")) {
       cli_cmd_show_modbus_slave();
       return true;
+    } else if (!strcmp(what, "MODBUS-TCP")) {
+      cli_cmd_show_modbus_tcp();
+      return true;
     } else if (!strcmp(what, "H-REG")) {
       // show h-reg - Display register configuration
       cli_cmd_show_regs();
       return true;
+    } else if (!strcmp(what, "REG-MAP")) {
+      // show reg-map - Sparse register pages (v7.9.8.22)
+      cli_cmd_show_reg_map();
+      return true;
     } else if (!strcmp(what, "COIL")) {
       // show coil - Display coil configuration
       cli_cmd_show_coils();
@@ -972,6 +1027,10 @@ bool cli_parser_execute(char* line) {
       // show modbus-slave - Display Modbus Slave configuration
       cli_cmd_show_modbus_slave();
       return true;
+    } else if (!strcmp(what, "MODBUS-TCP")) {
+      // show modbus-tcp - Display Modbus TCP server config + clients
+      cli_cmd_show_modbus_tcp();
+      return true;
     } else if (!strcmp(what, "USER")) {
       // show user - Display current session info
       debug_println("");
@@ -1147,6 +1206,10 @@ bool cli_parser_execute(char* line) {
       }
       return true;
 
+    } else if (!strcmp(what, "REG-MAP")) {
+      // set reg-map hr|ir <start> <count> | set reg-map <1-16> delete (v7.9.8.22)
+      cli_cmd_set_reg_map(argc - 2, argv + 2);
+      return true;
     } else if (!strcmp(what, "COIL")) {
       if (argc < 3) {
         debug_println("SET COIL: missing parameters");
@@ -1341,6 +1404,14 @@ bool cli_parser_execute(char* line) {
           return true;
         }
 
+        // set logic parallel:on|off  (FEAT-153: both cores)
+        if (strstr(arg, "parallel:")) {
+          const char* val = strchr(arg, ':') + 1;
+          bool enabled = (!strcasecmp(val, "on") || !strcasecmp(val, "true") || !strcmp(val, "1"));
+          cli_cmd_set_logic_parallel(st_logic_get_state(), enabled);
+          return true;
+        }
+
         // set logic interval:X  (global execution interval - v4.1.0)
         if (strstr(arg, "interval:")) {
           const char* interval_str = strchr(arg, ':') + 1;
@@ -1373,11 +1444,13 @@ bool cli_parser_execute(char* line) {
         debug_println("");
         debug_println("  Also:");
         debug_println("         set logic <id> enabled:true|false");
+        debug_println("         set logic <id> period:<ms> priority:<n> policy:skip|catchup");
         debug_println("         set logic <id> reinit   (cold restart: reset vars)");
         debug_println("         set logic <id> delete");
         debug_println("         set logic <id> bind <var_name> reg:100|coil:10|input:5");
         debug_println("         set logic debug:true|false");
         debug_println("         set logic interval:X  (X = 10,20,25,50,75,100 ms)");
+        debug_println("         set logic parallel:on|off");
         return false;
       }
 
@@ -1398,6 +1471,12 @@ bool cli_parser_execute(char* line) {
         return true;
       }
 
+      // FEAT-154: set logic <id> period:<ms> priority:<n> policy:skip|catchup (any subset)
+      if (strstr(subcommand, "period:") || strstr(subcommand, "priority:") || strstr(subcommand, "policy:")) {
+        cli_cmd_set_logic_schedule(st_logic_get_state(), prog_idx, argc - 3, argv + 3);
+        return true;
+      }
+
       // Now normalize for other commands
       const char* cmd_normalized = normalize_alias(subcommand);
 
@@ -1852,13 +1931,62 @@ bool cli_parser_execute(char* line) {
         cli_cmd_set_modbus_master_cache_ttl(ttl);
         return true;
       } else if (!strcmp(param, "CACHE-SIZE")) {
-        uint8_t sz = atoi(value);
+        uint16_t sz = (uint16_t)constrain(atoi(value), 0, 65535);
         cli_cmd_set_modbus_master_cache_size(sz);
         return true;
       } else if (!strcmp(param, "QUEUE-SIZE")) {
         uint8_t sz = atoi(value);
         cli_cmd_set_modbus_master_queue_size(sz);
         return true;
+      } else if (!strcmp(param, "COALESCE")) {
+        bool on = (!strcmp(value, "on") || !strcmp(value, "ON") || !strcmp(value, "1") || !strcmp(value, "true"));
+        cli_cmd_set_modbus_master_coalesce(on);
+        return true;
+      } else if (!strcmp(param, "COALESCE-GAP")) {
+        uint8_t gap = (uint8_t)constrain(atoi(value), 0, 255);
+        cli_cmd_set_modbus_master_coalesce_gap(gap);
+        return true;
+      } else if (!strcmp(param, "WRITE-COMBINE")) {
+        bool on = (!strcmp(value, "on") || !strcmp(value, "ON") || !strcmp(value, "1") || !strcmp(value, "true"));
+        cli_cmd_set_modbus_master_write_combine(on);
+        return true;
+      } else if (!strcmp(param, "WRITE-ALWAYS")) {
+        // set modbus-master write-always <id>|<first>-<last> on|off
+        if (argc < 5) {
+          debug_println("  Usage: set modbus-master write-always <id>|<first>-<last> on|off");
+          return true;
+        }
+        cli_cmd_set_modbus_master_write_always(value, argv[4]);
+        return true;
+      } else if (!strcmp(param, "POLL")) {
+        // set modbus-master poll <id> slave:<id> fc:<n> start:<addr> count:<n> period:<ms> priority:<n>
+        if (argc < 5) {
+          debug_println("SET MODBUS-MASTER POLL: missing parameters");
+          debug_println("  Usage: set modbus-master poll <1-16> slave:<id> fc:<1-4> start:<addr> count:<n> period:<ms> priority:<n>");
+          debug_println("         set modbus-master poll <1-16> enable|disable|delete");
+          return false;
+        }
+        cli_cmd_set_modbus_master_poll((uint8_t)constrain(atoi(value), 0, 255), argc - 4, argv + 4);
+        return true;
+      } else if (!strcmp(param, "BUS")) {
+        // set modbus-master bus <n> enabled:on baud:<rate> parity:<p> stop:<n> timeout:<ms> delay:<ms>
+        if (argc < 5) {
+          debug_println("SET MODBUS-MASTER BUS: missing parameters");
+          debug_println("  Usage: set modbus-master bus <1> enabled:on|off baud:<rate> parity:<none|even|odd> stop:<1|2> timeout:<ms> delay:<ms>");
+          return false;
+        }
+        cli_cmd_set_modbus_master_bus((uint8_t)constrain(atoi(value), 0, 255), argc - 4, argv + 4);
+        return true;
+      } else if (!strcmp(param, "ROUTE")) {
+        // set modbus-master route <id> slaves:<first>-<last> bus:<n>
+        if (argc < 5) {
+          debug_println("SET MODBUS-MASTER ROUTE: missing parameters");
+          debug_println("  Usage: set modbus-master route <1-8> slaves:<first>-<last> bus:<n>");
+          debug_println("         set modbus-master route <1-8> delete");
+          return false;
+        }
+        cli_cmd_set_modbus_master_route((uint8_t)constrain(atoi(value), 0, 255), argc - 4, argv + 4);
+        return true;
       } else {
         debug_println("SET MODBUS-MASTER: unknown parameter");
         return false;
@@ -1912,6 +2040,47 @@ bool cli_parser_execute(char* line) {
         debug_println("SET MODBUS-SLAVE: unknown parameter");
         return false;
       }
+    } else if (!strcmp(what, "MODBUS-TCP")) {
+      if (argc >= 3) {
+        const char* subwhat = normalize_alias(argv[2]);
+        if (!strcmp(subwhat, "HELP") || !strcmp(subwhat, "?")) {
+          print_modbus_tcp_help();
+          return true;
+        }
+      }
+
+      // set modbus-tcp <param> <value>
+      if (argc < 4) {
+        debug_println("SET MODBUS-TCP: missing parameters");
+        debug_println("  Usage: set modbus-tcp <param> <value>");
+        debug_println("  Params: enabled, port, max-clients, idle-timeout");
+        debug_println("  Brug 'set modbus-tcp ?' for detaljeret hjælp");
+        return false;
+      }
+
+      const char* param = normalize_alias(argv[2]);
+      const char* value = argv[3];
+
+      if (!strcmp(param, "ENABLED")) {
+        bool enabled = (!strcmp(value, "on") || !strcmp(value, "ON") || !strcmp(value, "1") || !strcmp(value, "true"));
+        cli_cmd_set_modbus_tcp_enabled(enabled);
+        return true;
+      } else if (!strcmp(param, "PORT")) {
+        long port = atol(value);
+        cli_cmd_set_modbus_tcp_port((port > 0 && port <= 65535) ? (uint16_t)port : 0);
+        return true;
+      } else if (!strcmp(param, "MAX-CLIENTS")) {
+        uint8_t clients = atoi(value);
+        cli_cmd_set_modbus_tcp_max_clients(clients);
+        return true;
+      } else if (!strcmp(param, "IDLE-TIMEOUT")) {
+        uint16_t secs = atoi(value);
+        cli_cmd_set_modbus_tcp_idle_timeout(secs);
+        return true;
+      } else {
+        debug_println("SET MODBUS-TCP: unknown parameter");
+        return false;
+      }
     } else if (!strcmp(what, "RBAC")) {
       // set rbac enable|disable|on|off|1|0
       if (argc < 3) {
@@ -2085,6 +2254,14 @@ bool cli_parser_execute(char* line) {
         debug_println("RESET LOGIC: unknown subcommand (expected 'stats')");
         return false;
       }
+    } else if (!strcmp(what, "MODBUS-MASTER")) {
+      // reset modbus-master profile (v7.9.8.17)
+      if (argc >= 3 && str_eq_i(argv[2], "PROFILE")) {
+        cli_cmd_reset_modbus_master_profile();
+        return true;
+      }
+      debug_println("RESET MODBUS-MASTER: unknown subcommand (expected 'profile')");
+      return false;
     } else {
       debug_println("RESET: unknown argument");
       return false;
@@ -2232,6 +2409,7 @@ bool cli_parser_execute(char* line) {
     debug_println("  show persist            - Persistence groups");
     debug_println("  show modbus-master, mb-master - Modbus master config");
     debug_println("  show modbus-slave, mb-slave   - Modbus slave config");
+    debug_println("  show modbus-tcp, mb-tcp       - Modbus TCP server");
     debug_println("  show backup             - Backup/restore URL\n");
 
     debug_println("Set/Configure:");
@@ -2245,6 +2423,7 @@ bool cli_parser_execute(char* line) {
     debug_println("  set modbus mode <mode>  - Transceiver mode (slave/master/off)");
     debug_println("  set modbus-master ?     - Modbus master help");
     debug_println("  set modbus-slave ?      - Modbus slave help");
+    debug_println("  set modbus-tcp ?        - Modbus TCP server help");
     debug_println("  set ao1|ao2 mode <mode> - AO output (voltage/current)");
     debug_println("  set hostname <name>     - Set hostname");
     debug_println("  set echo on|off         - Remote echo\n");
@@ -2275,6 +2454,7 @@ bool cli_parser_execute(char* line) {
     debug_println("Reset/Clear (rst, clr):");
     debug_println("  reset counter <id>      - Reset counter value");
     debug_println("  reset logic stats [id]  - Reset logic stats (all or specific)");
+    debug_println("  reset modbus-master profile - Reset latency/bus profile");
     debug_println("  clear counters          - Reset all counters\n");
 
     debug_println("Delete:");
@@ -2524,6 +2704,7 @@ void cli_parser_print_help(void) {
   debug_println("  show gpio           - Display GPIO mappings");
   debug_println("  show echo           - Display remote echo status");
   debug_println("  show reg            - Display register mappings");
+  debug_println("  show reg-map        - Display sparse register pages (HR/IR above the flat arrays)");
   debug_println("  show coil           - Display coil mappings");
   debug_println("");
   debug_println("Modbus Read/Write Commands:");
@@ -2566,6 +2747,9 @@ void cli_parser_print_help(void) {
   debug_println("    Counter functions: index, raw, freq, overflow, ctrl");
   debug_println("    Timer functions: output");
   debug_println("");
+  debug_println("  set reg-map hr|ir <start> <count>  - Map 64-register pages above HR 255 / IR 511");
+  debug_println("  set reg-map <1-16> delete          - Remove page declaration");
+  debug_println("");
   debug_println("  set coil STATIC <address> Value <ON|OFF>");
   debug_println("  set coil DYNAMIC <address> counter<id>:<func> or timer<id>:<func>");
   debug_println("    Counter functions: overflow");
@@ -39,6 +39,7 @@
 #include "wifi_driver.h"
 #include "gpio_driver.h"
 #include "modbus_master.h"
+#include "mb_async.h"
 #include <Arduino.h>
 #include <stdio.h>
 #include <string.h>
@@ -378,6 +379,38 @@ void cli_cmd_show_config(const char *section) {
     debug_print("  Queue Size: ");
     debug_print_uint(g_persist_config.modbus_master.queue_max_size);
     debug_println("");
+    debug_print("  Read Coalescing: ");
+    debug_print(g_persist_config.modbus_master.coalesce_enabled ? "on (gap " : "off (gap ");
+    debug_print_uint(g_persist_config.modbus_master.coalesce_gap);
+    debug_println(")");
+    debug_print("  Write Combining: ");
+    debug_println(g_persist_config.modbus_master.write_combine ? "on" : "off");
+    for (uint16_t id = 1; id <= 247; id++) {
+      if (!mb_async_write_always((uint8_t)id)) continue;
+      uint16_t last = id;
+      while (last < 247 && mb_async_write_always((uint8_t)(last + 1))) last++;
+      debug_printf("  Write Always: slaves %u-%u\n", id, last);
+      id = last;
+    }
+    for (uint8_t i = 0; i < MB_POLL_GROUPS_MAX; i++) {
+      const ModbusPollGroup *pg = &g_persist_config.mb_poll_groups[i];
+      if (pg->slave_id == 0) continue;
+      debug_printf("  Poll Group %u: slave %u FC%02u %u+%u every %lu ms, priority %u%s\n",
+                   i + 1, pg->slave_id, pg->fc, pg->start, pg->count,
+                   (unsigned long)pg->period_ms, pg->priority, pg->enabled ? "" : " (disabled)");
+    }
+    for (uint8_t i = 0; i < MB_BUS_MAX - 1; i++) {
+      const ModbusBusConfig *bc = &g_persist_config.mb_buses[i];
+      debug_printf("  Bus %u: %s, %lu baud, parity %s, %u stop, timeout %u ms, delay %u ms\n",
+                   i + 1, bc->enabled ? "enabled" : "disabled", (unsigned long)bc->baudrate,
+                   bc->parity == 1 ? "even" : bc->parity == 2 ? "odd" : "none", bc->stop_bits,
+                   bc->timeout_ms, bc->inter_frame_delay);
+    }
+    for (uint8_t i = 0; i < MB_BUS_ROUTES_MAX; i++) {
+      const ModbusBusRoute *r = &g_persist_config.mb_bus_routes[i];
+      if (r->first_slave == 0) continue;
+      debug_printf("  Route %u: slaves %u-%u -> bus %u\n", i + 1, r->first_slave, r->last_slave, r->bus);
+    }
   }
   debug_println("");
   } // end show_modbus
@@ -1420,6 +1453,45 @@ void cli_cmd_show_config(const char *section) {
     debug_print("set modbus-master queue-size ");
     debug_print_uint(g_persist_config.modbus_master.queue_max_size);
     debug_println("");
+    debug_print("set modbus-master coalesce ");
+    debug_println(g_persist_config.modbus_master.coalesce_enabled ? "on" : "off");
+    debug_print("set modbus-master coalesce-gap ");
+    debug_print_uint(g_persist_config.modbus_master.coalesce_gap);
+    debug_println("");
+    debug_print("set modbus-master write-combine ");
+    debug_println(g_persist_config.modbus_master.write_combine ? "on" : "off");
+    for (uint16_t id = 1; id <= 247; id++) {
+      if (!mb_async_write_always((uint8_t)id)) continue;
+      uint16_t last = id;
+      while (last < 247 && mb_async_write_always((uint8_t)(last + 1))) last++;
+      debug_printf("set modbus-master write-always %u-%u on\n", id, last);
+      id = last;
+    }
+    for (uint8_t i = 0; i < MB_POLL_GROUPS_MAX; i++) {
+      const ModbusPollGroup *pg = &g_persist_config.mb_poll_groups[i];
+      if (pg->slave_id == 0) continue;
+      debug_printf("set modbus-master poll %u slave:%u fc:%u start:%u count:%u period:%lu priority:%u\n",
+                   i + 1, pg->slave_id, pg->fc, pg->start, pg->count,
+                   (unsigned long)pg->period_ms, pg->priority);
+      if (!pg->enabled) debug_printf("set modbus-master poll %u disable\n", i + 1);
+    }
+    for (uint8_t i = 0; i < MB_BUS_MAX - 1; i++) {
+      const ModbusBusConfig *bc = &g_persist_config.mb_buses[i];
+      debug_printf("set modbus-master bus %u enabled:%s baud:%lu parity:%s stop:%u timeout:%u delay:%u\n",
+                   i + 1, bc->enabled ? "on" : "off", (unsigned long)bc->baudrate,
+                   bc->parity == 1 ? "even" : bc->parity == 2 ? "odd" : "none", bc->stop_bits,
+                   bc->timeout_ms, bc->inter_frame_delay);
+    }
+    for (uint8_t i = 0; i < MB_BUS_ROUTES_MAX; i++) {
+      const ModbusBusRoute *r = &g_persist_config.mb_bus_routes[i];
+      if (r->first_slave == 0) continue;
+      debug_printf("set modbus-master route %u slaves:%u-%u bus:%u\n", i + 1, r->first_slave, r->last_slave, r->bus);
+    }
+  }
+  for (uint8_t i = 0; i < REG_PAGE_DECL_MAX; i++) {
+    const RegPageDecl *d = &g_persist_config.reg_pages[i];
+    if (d->count == 0) continue;
+    debug_printf("set reg-map %s %u %u\n", d->bank == REG_BANK_IR ? "ir" : "hr", d->start, d->count);
   }
   } // end show_modbus
 
@@ -1644,6 +1716,8 @@ void cli_cmd_show_config(const char *section) {
   debug_print("set logic interval ");
   debug_print_uint(g_persist_config.st_logic_interval_ms);
   debug_println("");
+  debug_println((g_persist_config.module_flags & MODULE_FLAG_ST_PARALLEL_DISABLED) ?
+                "set logic parallel:off" : "set logic parallel:on");
 
   // ST Logic enable/disable for each program
   extern st_logic_engine_state_t* st_logic_get_state(void);
@@ -1656,6 +1730,12 @@ void cli_cmd_show_config(const char *section) {
         debug_print("set logic ");
         debug_print_uint(i + 1);
         debug_println(prog->enabled ? " enabled" : " disabled");
+        // FEAT-154: Non-default scan schedule
+        if (prog->period_ms != 0 || prog->priority != 0 || prog->scan_policy != ST_LOGIC_SCAN_SKIP) {
+          debug_printf("set logic %u period:%u priority:%u policy:%s\n", i + 1,
+                       (unsigned int)prog->period_ms, (unsigned int)prog->priority,
+                       prog->scan_policy == ST_LOGIC_SCAN_CATCH_UP ? "catchup" : "skip");
+        }
       }
     }
   }
@@ -3631,14 +3711,15 @@ void cli_cmd_show_sse(void) {
         // Format topics string
         char topics_str[32] = "";
         uint8_t t = clients[i].topics;
-        if (t == SSE_TOPIC_ALL) {
-          strcpy(topics_str, "all");
+        if ((t & SSE_TOPIC_ALL) == SSE_TOPIC_ALL) {
+          strcpy(topics_str, (t & SSE_TOPIC_MODBUS) ? "all,mb" : "all");
         } else {
           bool first = true;
           if (t & SSE_TOPIC_COUNTERS)  { strcat(topics_str, "cnt"); first = false; }
           if (t & SSE_TOPIC_TIMERS)    { if (!first) strcat(topics_str, ","); strcat(topics_str, "tmr"); first = false; }
           if (t & SSE_TOPIC_REGISTERS) { if (!first) strcat(topics_str, ","); strcat(topics_str, "reg"); first = false; }
-          if (t & SSE_TOPIC_SYSTEM)    { if (!first) strcat(topics_str, ","); strcat(topics_str, "sys"); }
+          if (t & SSE_TOPIC_SYSTEM)    { if (!first) strcat(topics_str, ","); strcat(topics_str, "sys"); first = false; }
+          if (t & SSE_TOPIC_MODBUS)    { if (!first) strcat(topics_str, ","); strcat(topics_str, "mb"); }
           if (topics_str[0] == '\0') strcpy(topics_str, "none");
         }
 
@@ -3757,11 +3838,11 @@ void cli_cmd_read_reg(uint8_t argc, char* argv[]) {
     }
   }
 
-  // Validate parameters
-  if (start_addr >= HOLDING_REGS_SIZE) {
-    debug_print("READ HOLDING-REG: startadresse udenfor omr\u00e5de (max ");
+  // Validate parameters: flat array (0-255) or mapped sparse page (v7.9.8.22)
+  if (registers_holding_span(start_addr, 1) != 1) {
+    debug_print("READ HOLDING-REG: startadresse udenfor omr\u00e5de (0-");
     debug_print_uint(HOLDING_REGS_SIZE - 1);
-    debug_println(")");
+    debug_println(" eller 'set reg-map')");
     return;
   }
 
@@ -3771,8 +3852,8 @@ void cli_cmd_read_reg(uint8_t argc, char* argv[]) {
   }
 
   // Adjust count if it exceeds available registers
-  if (start_addr + count > HOLDING_REGS_SIZE) {
-    count = HOLDING_REGS_SIZE - start_addr;
+  if (registers_holding_span(start_addr, count) != count) {
+    count = registers_holding_span(start_addr, count);
     debug_print("READ HOLDING-REG: justeret antal til ");
     debug_print_uint(count);
     debug_println(" registre");
@@ -3782,7 +3863,7 @@ void cli_cmd_read_reg(uint8_t argc, char* argv[]) {
   // BUG-137 FIX: Support count parameter for REAL array reading
   if (display_as_real) {
     // Validate that we have enough registers available (count REAL values = count * 2 registers)
-    if (start_addr + (count * 2) > HOLDING_REGS_SIZE) {
+    if (registers_holding_span(start_addr, count * 2) != count * 2) {
       debug_print("READ HOLDING-REG: REAL kr\u00e6ver ");
       debug_print_uint(count * 2);
       debug_println(" registre, adresse udenfor omr\u00e5de");
@@ -3835,7 +3916,7 @@ void cli_cmd_read_reg(uint8_t argc, char* argv[]) {
   // BUG-137 FIX: Support count parameter for DINT array reading
   if (display_as_dint) {
     // Validate that we have enough registers available (count DINT values = count * 2 registers)
-    if (start_addr + (count * 2) > HOLDING_REGS_SIZE) {
+    if (registers_holding_span(start_addr, count * 2) != count * 2) {
       debug_print("READ HOLDING-REG: DINT kr\u00e6ver ");
       debug_print_uint(count * 2);
       debug_println(" registre, adresse udenfor omr\u00e5de");
@@ -3887,7 +3968,7 @@ void cli_cmd_read_reg(uint8_t argc, char* argv[]) {
   // BUG-137 FIX: Support count parameter for DWORD array reading
   if (display_as_dword) {
     // Validate that we have enough registers available (count DWORD values = count * 2 registers)
-    if (start_addr + (count * 2) > HOLDING_REGS_SIZE) {
+    if (registers_holding_span(start_addr, count * 2) != count * 2) {
       debug_print("READ HOLDING-REG: DWORD kr\u00e6ver ");
       debug_print_uint(count * 2);
       debug_println(" registre, adresse udenfor omr\u00e5de");
@@ -4051,11 +4132,11 @@ void cli_cmd_read_input_reg(uint8_t argc, char* argv[]) {
     }
   }
 
-  uint16_t *input_regs = registers_get_input_regs();
-
-  // Validate parameters (input registers can be larger than holding regs)
-  if (start_addr >= 1024) {  // Modbus limit
-    debug_println("READ INPUT-REG: startadresse udenfor område (max 1023)");
+  // Validate parameters: flat array (0-511) or mapped sparse page (v7.9.8.22)
+  if (registers_input_span(start_addr, 1) != 1) {
+    debug_print("READ INPUT-REG: startadresse udenfor område (0-");
+    debug_print_uint(INPUT_REGS_SIZE - 1);
+    debug_println(" eller 'set reg-map')");
     return;
   }
 
@@ -4065,8 +4146,8 @@ void cli_cmd_read_input_reg(uint8_t argc, char* argv[]) {
   }
 
   // Adjust count if it exceeds available input registers
-  if (start_addr + count > 1024) {
-    count = 1024 - start_addr;
+  if (registers_input_span(start_addr, count) != count) {
+    count = registers_input_span(start_addr, count);
     debug_print("READ INPUT-REG: justeret antal til ");
     debug_print_uint(count);
     debug_println(" registre");
@@ -4075,7 +4156,7 @@ void cli_cmd_read_input_reg(uint8_t argc, char* argv[]) {
   // BUG-179 FIX: REAL type requires 2 consecutive registers
   if (display_as_real) {
     // Validate that we have enough registers available (count REAL values = count * 2 registers)
-    if (start_addr + (count * 2) > 1024) {
+    if (registers_input_span(start_addr, count * 2) != count * 2) {
       debug_print("READ INPUT-REG: REAL kræver ");
       debug_print_uint(count * 2);
       debug_println(" registre, adresse udenfor område");
@@ -4094,8 +4175,8 @@ void cli_cmd_read_input_reg(uint8_t argc, char* argv[]) {
       uint16_t addr = start_addr + (i * 2);
 
       // BUG-125 FIX: ST Logic writes LSW first, MSW second (little-endian register order)
-      uint16_t low_word = input_regs[addr];          // LSW at base address
-      uint16_t high_word = input_regs[addr + 1];     // MSW at base+1
+      uint16_t low_word = registers_get_input_register(addr);          // LSW at base address
+      uint16_t high_word = registers_get_input_register(addr + 1);     // MSW at base+1
       uint32_t bits = ((uint32_t)high_word << 16) | low_word;
       float real_value;
       memcpy(&real_value, &bits, sizeof(float));
@@ -4123,7 +4204,7 @@ void cli_cmd_read_input_reg(uint8_t argc, char* argv[]) {
   // DINT type (32-bit signed integer, 2 consecutive registers)
   if (display_as_dint) {
     // Validate that we have enough registers available (count DINT values = count * 2 registers)
-    if (start_addr + (count * 2) > 1024) {
+    if (registers_input_span(start_addr, count * 2) != count * 2) {
       debug_print("READ INPUT-REG: DINT kræver ");
       debug_print_uint(count * 2);
       debug_println(" registre, adresse udenfor område");
@@ -4142,8 +4223,8 @@ void cli_cmd_read_input_reg(uint8_t argc, char* argv[]) {
       uint16_t addr = start_addr + (i * 2);
 
       // BUG-125 FIX: ST Logic writes LSW first, MSW second (little-endian register order)
-      uint16_t low_word = input_regs[addr];          // LSW at base address
-      uint16_t high_word = input_regs[addr + 1];     // MSW at base+1
+      uint16_t low_word = registers_get_input_register(addr);          // LSW at base address
+      uint16_t high_word = registers_get_input_register(addr + 1);     // MSW at base+1
       uint32_t unsigned_val = ((uint32_t)high_word << 16) | low_word;
       int32_t dint_value = (int32_t)unsigned_val;
 
@@ -4170,7 +4251,7 @@ void cli_cmd_read_input_reg(uint8_t argc, char* argv[]) {
   // DWORD type (32-bit unsigned integer, 2 consecutive registers)
   if (display_as_dword) {
     // Validate that we have enough registers available (count DWORD values = count * 2 registers)
-    if (start_addr + (count * 2) > 1024) {
+    if (registers_input_span(start_addr, count * 2) != count * 2) {
       debug_print("READ INPUT-REG: DWORD kræver ");
       debug_print_uint(count * 2);
       debug_println(" registre, adresse udenfor område");
@@ -4189,8 +4270,8 @@ void cli_cmd_read_input_reg(uint8_t argc, char* argv[]) {
       uint16_t addr = start_addr + (i * 2);
 
       // BUG-125 FIX: ST Logic writes LSW first, MSW second (little-endian register order)
-      uint16_t low_word = input_regs[addr];          // LSW at base address
-      uint16_t high_word = input_regs[addr + 1];     // MSW at base+1
+      uint16_t low_word = registers_get_input_register(addr);          // LSW at base address
+      uint16_t high_word = registers_get_input_register(addr + 1);     // MSW at base+1
       uint32_t dword_value = ((uint32_t)high_word << 16) | low_word;
 
       debug_print("IR[");
@@ -4228,7 +4309,7 @@ void cli_cmd_read_input_reg(uint8_t argc, char* argv[]) {
 
   for (uint16_t i = 0; i < count; i++) {
     uint16_t addr = start_addr + i;
-    uint16_t value = input_regs[addr];
+    uint16_t value = registers_get_input_register(addr);
 
     debug_print("IR[");
     debug_print_uint(addr);
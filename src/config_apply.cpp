@@ -16,6 +16,7 @@
 #include "heartbeat.h"
 #include "cli_shell.h"
 #include "st_logic_config.h"
+#include "st_logic_engine.h"
 #include "debug.h"
 #include <esp_wifi.h>
 #include <cstddef>
@@ -112,6 +113,23 @@ bool config_apply(const PersistConfig* cfg) {
     }
   }
 
+  // Map sparse register pages before STATIC values may be written into them
+  {
+    uint8_t failed = registers_page_apply_config();
+    uint16_t mapped = 0, max = 0;
+    registers_page_stats(&mapped, &max);
+    debug_print("  Register pages: ");
+    debug_print_uint(mapped);
+    debug_print("/");
+    debug_print_uint(max);
+    if (failed) {
+      debug_print(" [WARNING: ");
+      debug_print_uint(failed);
+      debug_print(" reg-map declaration(s) not mapped - pool full]");
+    }
+    debug_println("");
+  }
+
   // Apply STATIC register mappings (initialize holding register values)
   debug_print("  STATIC registers: ");
   debug_print_uint(cfg->static_reg_count);
@@ -255,6 +273,10 @@ bool config_apply(const PersistConfig* cfg) {
     }
   }
 
+  // FEAT-153: Parallel ST execution across both cores (default on)
+  st_logic_set_parallel(st_logic_get_state(),
+                        (cfg->module_flags & MODULE_FLAG_ST_PARALLEL_DISABLED) == 0);
+
   // Apply persistent register groups (v4.0+)
   if (cfg->persist_regs.enabled && cfg->persist_regs.group_count > 0) {
     debug_print("  Persistent registers: ");
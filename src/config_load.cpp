@@ -10,6 +10,7 @@
 #include "config_save.h"
 #include "constants.h"
 #include "mb_async.h"
+#include "modbus_tcp_server.h"
 #include "rbac.h"
 #include "debug.h"
 #include "debug_flags.h"
@@ -23,6 +24,28 @@
 #define NVS_CONFIG_KEY "modbus_cfg"
 #define NVS_NAMESPACE  "modbus"
 
+/**
+ * @brief Extra master bus disabled with master serial defaults (v7.9.8.14)
+ */
+static void config_defaults_mb_bus(ModbusBusConfig* bus) {
+  bus->enabled = 0;
+  bus->baudrate = MODBUS_MASTER_DEFAULT_BAUDRATE;
+  bus->parity = MODBUS_MASTER_DEFAULT_PARITY;
+  bus->stop_bits = MODBUS_MASTER_DEFAULT_STOP_BITS;
+  bus->timeout_ms = MODBUS_MASTER_DEFAULT_TIMEOUT;
+  bus->inter_frame_delay = MODBUS_MASTER_DEFAULT_INTER_FRAME;
+}
+
+/**
+ * @brief All extra master buses at defaults, no routes (all slaves on bus 0)
+ */
+static void config_defaults_mb_buses(PersistConfig* cfg) {
+  for (uint8_t i = 0; i < MB_BUS_MAX - 1; i++) {
+    config_defaults_mb_bus(&cfg->mb_buses[i]);
+  }
+  memset(cfg->mb_bus_routes, 0, sizeof(cfg->mb_bus_routes));
+}
+
 /**
  * @brief Initialize configuration with factory defaults
  */
@@ -61,6 +84,9 @@ static void config_init_defaults(PersistConfig* cfg) {
   cfg->modbus_master.cache_ttl_ms = 0;  // 0 = never expire (default)
   cfg->modbus_master.cache_max_entries = MB_CACHE_MAX_ENTRIES_DEFAULT;  // 32
   cfg->modbus_master.queue_max_size = MB_ASYNC_QUEUE_SIZE_DEFAULT;     // 16
+  cfg->modbus_master.coalesce_enabled = 1;
+  cfg->modbus_master.coalesce_gap = MODBUS_MASTER_DEFAULT_COALESCE_GAP;  // 4
+  cfg->modbus_master.write_combine = 1;
   cfg->modbus_master.total_requests = 0;
   cfg->modbus_master.successful_requests = 0;
   cfg->modbus_master.timeout_errors = 0;
@@ -107,6 +133,24 @@ static void config_init_defaults(PersistConfig* cfg) {
   memset(cfg->dashboard_card_tabs, 0, sizeof(cfg->dashboard_card_tabs));
   memset(cfg->dashboard_card_hidden, 0, sizeof(cfg->dashboard_card_hidden));
 
+  // Modbus TCP slave defaults (v7.9.8.0)
+  cfg->modbus_tcp.enabled = 1;
+  cfg->modbus_tcp.port = MODBUS_TCP_DEFAULT_PORT;
+  cfg->modbus_tcp.max_clients = MODBUS_TCP_DEFAULT_CLIENTS;
+  cfg->modbus_tcp.idle_timeout_s = MODBUS_TCP_IDLE_TIMEOUT_S;
+
+  // Modbus master poll groups (v7.9.8.12) - all slots unused
+  memset(cfg->mb_poll_groups, 0, sizeof(cfg->mb_poll_groups));
+
+  // Modbus master extra buses (v7.9.8.14) - disabled, no routes (all slaves on bus 0)
+  config_defaults_mb_buses(cfg);
+
+  // Modbus master write dedup (v7.9.8.19) - unchanged writes skipped for every slave
+  memset(cfg->mb_write_always, 0, sizeof(cfg->mb_write_always));
+
+  // Sparse register pages (v7.9.8.22) - none declared, only the flat HR/IR arrays
+  memset(cfg->reg_pages, 0, sizeof(cfg->reg_pages));
+
   // Initialize network config with defaults (v3.0+)
   network_config_init_defaults(&cfg->network);
 
@@ -418,6 +462,82 @@ bool config_load_from_nvs(PersistConfig* out) {
       out->schema_version = 19;
 
       debug_println("CONFIG LOAD: Migration 18→19 complete");
+    }
+
+    if (out->schema_version == 19) {
+      debug_println("CONFIG LOAD: Migrating schema 19 → 20 (Modbus TCP)");
+
+      out->modbus_tcp.enabled = 1;
+      out->modbus_tcp.port = MODBUS_TCP_DEFAULT_PORT;
+      out->modbus_tcp.max_clients = MODBUS_TCP_DEFAULT_CLIENTS;
+      out->modbus_tcp.idle_timeout_s = MODBUS_TCP_IDLE_TIMEOUT_S;
+      memset(out->modbus_tcp.reserved, 0, sizeof(out->modbus_tcp.reserved));
+
+      out->schema_version = 20;
+
+      debug_println("CONFIG LOAD: Migration 19→20 complete");
+    }
+
+    if (out->schema_version == 20) {
+      debug_println("CONFIG LOAD: Migrating schema 20 → 21 (16-bit cache size)");
+
+      out->modbus_master.cache_max_entries = MB_CACHE_MAX_ENTRIES_DEFAULT;
+
+      out->schema_version = 21;
+
+      debug_println("CONFIG LOAD: Migration 20→21 complete");
+    }
+
+    if (out->schema_version == 21) {
+      debug_println("CONFIG LOAD: Migrating schema 21 → 22 (read coalescing)");
+
+      out->modbus_master.coalesce_enabled = 1;
+      out->modbus_master.coalesce_gap = MODBUS_MASTER_DEFAULT_COALESCE_GAP;
+
+      out->schema_version = 22;
+
+      debug_println("CONFIG LOAD: Migration 21→22 complete");
+    }
+
+    if (out->schema_version == 22) {
+      debug_println("CONFIG LOAD: Migrating schema 22 → 23 (poll groups)");
+
+      memset(out->mb_poll_groups, 0, sizeof(out->mb_poll_groups));
+
+      out->schema_version = 23;
+
+      debug_println("CONFIG LOAD: Migration 22→23 complete");
+    }
+
+    if (out->schema_version == 23) {
+      debug_println("CONFIG LOAD: Migrating schema 23 → 24 (master buses)");
+
+      config_defaults_mb_buses(out);
+
+      out->schema_version = 24;
+
+      debug_println("CONFIG LOAD: Migration 23→24 complete");
+    }
+
+    if (out->schema_version == 24) {
+      debug_println("CONFIG LOAD: Migrating schema 24 → 25 (write combining)");
+
+      out->modbus_master.write_combine = 1;
+      memset(out->mb_write_always, 0, sizeof(out->mb_write_always));
+
+      out->schema_version = 25;
+
+      debug_println("CONFIG LOAD: Migration 24→25 complete");
+    }
+
+    if (out->schema_version == 25) {
+      debug_println("CONFIG LOAD: Migrating schema 25 → 26 (sparse register pages)");
+
+      memset(out->reg_pages, 0, sizeof(out->reg_pages));
+
+      out->schema_version = 26;
+
+      debug_println("CONFIG LOAD: Migration 25→26 complete");
     } else if (out->schema_version != CONFIG_SCHEMA_VERSION) {
       debug_print("ERROR: Unsupported schema version (stored=");
       debug_print_uint(out->schema_version);
@@ -485,6 +605,47 @@ bool config_load_from_nvs(PersistConfig* out) {
     sanitized = true;
   }
 
+  if (out->modbus_master.cache_max_entries == 0 ||
+      out->modbus_master.cache_max_entries > MB_CACHE_MAX_ENTRIES) {
+    debug_print("WARN: modbus_master cache_max_entries=");
+    debug_print_uint(out->modbus_master.cache_max_entries);
+    debug_println(" out of range, using default");
+    out->modbus_master.cache_max_entries = MB_CACHE_MAX_ENTRIES_DEFAULT;
+    sanitized = true;
+  }
+
+  for (uint8_t i = 0; i < MB_POLL_GROUPS_MAX; i++) {
+    ModbusPollGroup *pg = &out->mb_poll_groups[i];
+    if (pg->slave_id != 0 && !mb_poll_group_valid(pg)) {
+      debug_print("WARN: poll group ");
+      debug_print_uint(i + 1);
+      debug_println(" invalid, cleared");
+      memset(pg, 0, sizeof(*pg));
+      sanitized = true;
+    }
+  }
+
+  for (uint8_t i = 0; i < MB_BUS_MAX - 1; i++) {
+    if (!mb_bus_config_valid(&out->mb_buses[i])) {
+      debug_print("WARN: master bus ");
+      debug_print_uint(i + 1);
+      debug_println(" config invalid, reset to defaults");
+      config_defaults_mb_bus(&out->mb_buses[i]);
+      sanitized = true;
+    }
+  }
+
+  for (uint8_t i = 0; i < MB_BUS_ROUTES_MAX; i++) {
+    ModbusBusRoute *r = &out->mb_bus_routes[i];
+    if (r->first_slave != 0 && !mb_bus_route_valid(r)) {
+      debug_print("WARN: master bus route ");
+      debug_print_uint(i + 1);
+      debug_println(" invalid, cleared");
+      memset(r, 0, sizeof(*r));
+      sanitized = true;
+    }
+  }
+
   // Print summary
   debug_print("CONFIG LOADED: schema=");
   debug_print_uint(out->schema_version);
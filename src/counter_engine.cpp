@@ -48,14 +48,18 @@ typedef struct {
 
 static CounterCompareRuntime counter_compare_state[COUNTER_COUNT];
 
-// ISSUE-1 FIX: Atomic multi-word write protection
-// Prevents Modbus master from reading mid-update on 32/64-bit counter values
-// Simple spinlock: write lock bit during multi-word register updates
-static volatile uint8_t counter_write_lock[COUNTER_COUNT] = {0, 0, 0, 0};
-
 // Forward declaration for compare check function
 static void counter_engine_check_compare(uint8_t id, uint64_t counter_value);
 
+// Store a 16/32/64-bit value LSW first as one torn-free register update (v7.9.8.20)
+static void counter_engine_store_words(uint16_t reg, uint64_t value, uint8_t words) {
+  uint16_t buf[4];
+  for (uint8_t w = 0; w < words; w++) {
+    buf[w] = (uint16_t)((value >> (16 * w)) & 0xFFFF);
+  }
+  registers_set_holding_registers(reg, buf, words);  // Clips at HOLDING_REGS_SIZE
+}
+
 /* ============================================================================
  * INITIALIZATION
  * ============================================================================ */
@@ -430,32 +434,20 @@ void counter_engine_store_value_to_registers(uint8_t id) {
   scaled_value &= max_val;
   raw_value &= max_val;
 
-  // ISSUE-1 FIX: Atomic protection for multi-word writes
-  // Set write lock to prevent Modbus master from reading mid-update
-  uint8_t lock_id = id - 1;  // Array is 0-indexed
-  counter_write_lock[lock_id] = 1;
+  // Multi-word values go out as one seqlocked update each, so FC03/REST/SSE
+  // snapshots never see half a 32/64-bit value (v7.9.8.20, replaces ISSUE-1 write lock)
+  uint8_t words = (bw <= 16) ? 1 : (bw == 32) ? 2 : 4;
 
   // Write scaled value to value register (multi-word if 32/64 bit)
   if (cfg.value_reg < HOLDING_REGS_SIZE) {
-    uint8_t words = (bw <= 16) ? 1 : (bw == 32) ? 2 : 4;
-    for (uint8_t w = 0; w < words && cfg.value_reg + w < HOLDING_REGS_SIZE; w++) {
-      uint16_t word = (uint16_t)((scaled_value >> (16 * w)) & 0xFFFF);
-      registers_set_holding_register(cfg.value_reg + w, word);
-    }
+    counter_engine_store_words(cfg.value_reg, scaled_value, words);
   }
 
   // Write raw (prescaled) value to raw register
   if (cfg.raw_reg < HOLDING_REGS_SIZE) {
-    uint8_t words = (bw <= 16) ? 1 : (bw == 32) ? 2 : 4;
-    for (uint8_t w = 0; w < words && cfg.raw_reg + w < HOLDING_REGS_SIZE; w++) {
-      uint16_t word = (uint16_t)((raw_value >> (16 * w)) & 0xFFFF);
-      registers_set_holding_register(cfg.raw_reg + w, word);
-    }
+    counter_engine_store_words(cfg.raw_reg, raw_value, words);
   }
 
-  // Release write lock
-  counter_write_lock[lock_id] = 0;
-
   // Write frequency to freq register (no prescaler compensation)
   if (cfg.freq_reg < HOLDING_REGS_SIZE) {
     uint16_t freq_hz = counter_frequency_get(id);
@@ -492,11 +484,7 @@ void counter_engine_store_value_to_registers(uint8_t id) {
 
   // BUG-030: Write compare_value to register (for Modbus read/write)
   if (cfg.compare_enabled && cfg.compare_value_reg < HOLDING_REGS_SIZE) {
-    uint8_t words = (bw <= 16) ? 1 : (bw == 32) ? 2 : 4;
-    for (uint8_t w = 0; w < words && cfg.compare_value_reg + w < HOLDING_REGS_SIZE; w++) {
-      uint16_t word = (uint16_t)((cfg.compare_value >> (16 * w)) & 0xFFFF);
-      registers_set_holding_register(cfg.compare_value_reg + w, word);
-    }
+    counter_engine_store_words(cfg.compare_value_reg, cfg.compare_value, words);
   }
 
   // COMPARE CHECK (v2.3+)
@@ -667,15 +655,6 @@ void counter_engine_set_value(uint8_t id, uint64_t value) {
   counter_frequency_reset(id);
 }
 
-/* ============================================================================
- * ATOMIC WRITE LOCK ACCESS (ISSUE-1 FIX)
- * ============================================================================ */
-
-uint8_t counter_engine_is_write_locked(uint8_t id) {
-  if (id < 1 || id > 4) return 0;
-  return counter_write_lock[id - 1];
-}
-
 /* ============================================================================
  * INTERNAL HELPERS (for mode-specific overflow access)
  * ============================================================================ */
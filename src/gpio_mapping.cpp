@@ -196,7 +196,7 @@ static void gpio_mapping_write_outputs(void) {
             registers_set_coil(map->coil_reg, coil_value);
           }
           else {
-            // Output to HOLDING REGISTER (multi-register aware)
+            // Output to HOLDING REGISTER (multi-register aware, 32-bit as one torn-free update)
             if (var_type == ST_TYPE_BOOL) {
               // BOOL: 1 register
               uint16_t reg_value = prog->bytecode.variables[map->st_var_index].bool_val ? 1 : 0;
@@ -210,28 +210,25 @@ static void gpio_mapping_write_outputs(void) {
             else if (var_type == ST_TYPE_DINT) {
               // BUG-125 FIX: DINT: 32-bit signed, 2 registers (LSW first, MSW second)
               int32_t dint_value = prog->bytecode.variables[map->st_var_index].dint_val;
-              uint16_t low_word = (uint16_t)(dint_value & 0xFFFF);
-              uint16_t high_word = (uint16_t)((dint_value >> 16) & 0xFFFF);
-              registers_set_holding_register(map->coil_reg, low_word);      // LSW at base
-              registers_set_holding_register(map->coil_reg + 1, high_word); // MSW at base+1
+              uint16_t words[2] = { (uint16_t)(dint_value & 0xFFFF),           // LSW at base
+                                    (uint16_t)((dint_value >> 16) & 0xFFFF) }; // MSW at base+1
+              registers_set_holding_registers(map->coil_reg, words, 2);
             }
             else if (var_type == ST_TYPE_DWORD) {
               // BUG-125 FIX: DWORD: 32-bit unsigned, 2 registers (LSW first, MSW second)
               uint32_t dword_value = prog->bytecode.variables[map->st_var_index].dword_val;
-              uint16_t low_word = (uint16_t)(dword_value & 0xFFFF);
-              uint16_t high_word = (uint16_t)((dword_value >> 16) & 0xFFFF);
-              registers_set_holding_register(map->coil_reg, low_word);      // LSW at base
-              registers_set_holding_register(map->coil_reg + 1, high_word); // MSW at base+1
+              uint16_t words[2] = { (uint16_t)(dword_value & 0xFFFF),           // LSW at base
+                                    (uint16_t)((dword_value >> 16) & 0xFFFF) }; // MSW at base+1
+              registers_set_holding_registers(map->coil_reg, words, 2);
             }
             else if (var_type == ST_TYPE_REAL) {
               // BUG-125 FIX: REAL: 32-bit float, 2 registers (IEEE 754, LSW first, MSW second)
               float real_value = prog->bytecode.variables[map->st_var_index].real_val;
               uint32_t bits;
               memcpy(&bits, &real_value, sizeof(float));  // Reinterpret float as bits
-              uint16_t low_word = (uint16_t)(bits & 0xFFFF);
-              uint16_t high_word = (uint16_t)((bits >> 16) & 0xFFFF);
-              registers_set_holding_register(map->coil_reg, low_word);      // LSW at base
-              registers_set_holding_register(map->coil_reg + 1, high_word); // MSW at base+1
+              uint16_t words[2] = { (uint16_t)(bits & 0xFFFF),           // LSW at base
+                                    (uint16_t)((bits >> 16) & 0xFFFF) }; // MSW at base+1
+              registers_set_holding_registers(map->coil_reg, words, 2);
             }
           }
         }
@@ -110,6 +110,7 @@ extern esp_err_t api_handler_ir_bulk_read(httpd_req_t *req);
 extern esp_err_t api_handler_coils_bulk_read(httpd_req_t *req);
 extern esp_err_t api_handler_coils_bulk_write(httpd_req_t *req);
 extern esp_err_t api_handler_di_bulk_read(httpd_req_t *req);
+extern esp_err_t api_handler_registers_map(httpd_req_t *req);
 extern esp_err_t api_handler_logic_debug(httpd_req_t *req);
 extern esp_err_t api_handler_heartbeat(httpd_req_t *req);
 extern esp_err_t api_handler_cors_preflight(httpd_req_t *req);
@@ -567,6 +568,13 @@ static const httpd_uri_t uri_di_bulk_read = {
   .handler  = api_handler_di_bulk_read,
   .user_ctx = NULL
 };
+// v7.9.8.22: Sparse register pages
+static const httpd_uri_t uri_registers_map = {
+  .uri      = "/api/registers/map",
+  .method   = HTTP_GET,
+  .handler  = api_handler_registers_map,
+  .user_ctx = NULL
+};
 
 // FEAT-020: ST Logic Debug — routed via suffix in logic_single handler, no extra URIs needed
 
@@ -915,6 +923,7 @@ int http_server_start(const HttpConfig *config)
   httpd_register_uri_handler(http_state.server, &uri_coils_bulk_read);
   httpd_register_uri_handler(http_state.server, &uri_coils_bulk_write);
   httpd_register_uri_handler(http_state.server, &uri_di_bulk_read);
+  httpd_register_uri_handler(http_state.server, &uri_registers_map);
   // Registers (single, wildcard)
   httpd_register_uri_handler(http_state.server, &uri_hr_read);
   httpd_register_uri_handler(http_state.server, &uri_hr_write);
@@ -174,6 +174,7 @@ void ir_pool_write_exports(st_logic_program_config_t *prog) {
 
   // Get registers.h functions (extern)
   extern void registers_set_input_register(uint16_t addr, uint16_t value);
+  extern void registers_set_input_registers(uint16_t addr, const uint16_t *values, uint16_t count);
 
   uint16_t export_slot = 0;  // Slot offset within IR pool
   for (uint8_t var_idx = 0; var_idx < prog->bytecode.var_count; var_idx++) {
@@ -203,10 +204,8 @@ void ir_pool_write_exports(st_logic_program_config_t *prog) {
       case ST_TYPE_DWORD: {
         // DINT/DWORD: Two 16-bit registers (low word, high word)
         uint32_t dint_val = (uint32_t)var_value.dint_val;
-        uint16_t low_word = (uint16_t)(dint_val & 0xFFFF);
-        uint16_t high_word = (uint16_t)((dint_val >> 16) & 0xFFFF);
-        registers_set_input_register(base_reg, low_word);
-        registers_set_input_register(base_reg + 1, high_word);
+        uint16_t words[2] = { (uint16_t)(dint_val & 0xFFFF), (uint16_t)((dint_val >> 16) & 0xFFFF) };
+        registers_set_input_registers(base_reg, words, 2);  // One torn-free update (v7.9.8.20)
         export_slot += 2;
         break;
       }
@@ -218,10 +217,9 @@ void ir_pool_write_exports(st_logic_program_config_t *prog) {
           uint32_t u32;
         } real_converter;
         real_converter.f = var_value.real_val;
-        uint16_t low_word = (uint16_t)(real_converter.u32 & 0xFFFF);
-        uint16_t high_word = (uint16_t)((real_converter.u32 >> 16) & 0xFFFF);
-        registers_set_input_register(base_reg, low_word);
-        registers_set_input_register(base_reg + 1, high_word);
+        uint16_t words[2] = { (uint16_t)(real_converter.u32 & 0xFFFF),
+                              (uint16_t)((real_converter.u32 >> 16) & 0xFFFF) };
+        registers_set_input_registers(base_reg, words, 2);
         export_slot += 2;
         break;
       }
@@ -97,6 +97,8 @@ void setup() {
   // Initialize subsystems (with default configs)
   // Granular boot diagnostics: each letter = one subsystem initialized
   Serial.print("Subsystems: "); Serial.flush();
+  Serial.print("R"); Serial.flush();   // Register write hooks
+  registers_write_hooks_init();  // HR side-effect dispatch (ST Logic control/interval/var input)
   Serial.print("C"); Serial.flush();   // Counter
   counter_engine_init();    // Counter feature (SW/SW-ISR/HW modes)
   Serial.print("T"); Serial.flush();   // Timer
@@ -286,15 +288,7 @@ void loop() {
   network_manager_loop();
   cli_remote_loop();
 
-  // Modbus server (primary function - handles FC01-10)
-  // On single-transceiver boards: only run if mode == SLAVE
-#if MODBUS_SINGLE_TRANSCEIVER
-  if (g_persist_config.modbus_mode == MODBUS_MODE_SLAVE) {
-    modbus_server_loop();
-  }
-#else
-  modbus_server_loop();
-#endif
+  // Modbus server runs in its own task (v7.9.8.2, see modbus_server.cpp)
 
   // CLI interface (responsive while Modbus runs)
   if (g_serial_console) {
@@ -337,6 +331,6 @@ void loop() {
   // CRITICAL: Feed watchdog (must be called < 30s interval)
   watchdog_feed();
 
-  // Small delay to prevent tight loop
-  delay(1);
+  // Small delay to prevent tight loop (FEAT-154: returns early when an ST scan is due)
+  st_logic_scan_wait(1);
 }
@@ -11,200 +11,669 @@
 #include "mb_async.h"
 #include "modbus_master.h"
 #include "st_builtin_modbus.h"
+#include "config_struct.h"
+#include "mb_profile.h"
+#include <esp_heap_caps.h>
 
 /* ============================================================================
  * GLOBALS
  * ============================================================================ */
 
-mb_async_state_t g_mb_async = {0};
+mb_async_state_t g_mb_async[MB_BUS_MAX] = {};
 portMUX_TYPE mb_cache_spinlock = portMUX_INITIALIZER_UNLOCKED;
 
-// Ring-buffer pool for FC16 multi-register write values
-uint16_t g_mb_multi_write_pool[MB_MULTI_REG_POOL_SIZE][16] = {0};
-volatile uint8_t g_mb_multi_write_next = 0;
+// Payload slots for multi-register requests (v7.9.8.16, was a 4 x 16 write ring)
+static uint16_t g_mb_payload[MB_PAYLOAD_SLOTS][MB_PAYLOAD_REGS];
+static volatile uint32_t g_mb_payload_refs[MB_PAYLOAD_SLOTS] = {0};
+static volatile uint32_t g_mb_payload_failures = 0;
+
+// Completed MB_READ_HOLDINGS blocks, guarded by mb_cache_spinlock
+typedef struct {
+  uint8_t  slave_id;                  // 0 = unused
+  uint8_t  count;
+  uint16_t address;
+  uint8_t  payload;                   // One reference owned by the table
+  uint32_t last_update_ms;            // LRU: oldest is replaced first
+} mb_block_result_t;
+static mb_block_result_t g_mb_block_results[MB_BLOCK_RESULTS_MAX];
 
 /* ============================================================================
- * CACHE FUNCTIONS
+ * BUS ROUTING (v7.9.8.14)
+ *
+ * One async state (queue, cache shard, backoff table, poll groups) and one
+ * worker task per RS485 bus. Slaves map to a bus through a flat table built
+ * from g_persist_config.mb_bus_routes, so routing is a single byte lookup on
+ * every queue/cache call. A slow or dead slave only stalls its own bus.
  * ============================================================================ */
 
-mb_cache_entry_t *mb_cache_find(uint8_t slave_id, uint16_t address, uint8_t req_type) {
-  for (uint8_t i = 0; i < g_mb_async.entry_count; i++) {
-    mb_cache_entry_t *e = &g_mb_async.entries[i];
-    if (e->key.slave_id == slave_id &&
-        e->key.address == address &&
-        e->key.req_type == req_type) {
-      return e;
+static uint8_t g_mb_route[256] = {0};
+
+static inline mb_async_state_t *mb_bus_state(uint8_t slave_id) {
+  return &g_mb_async[g_mb_route[slave_id]];
+}
+
+bool mb_bus_config_valid(const ModbusBusConfig *bus) {
+  switch (bus->baudrate) {
+    case 2400: case 4800: case 9600: case 19200: case 38400: case 57600: case 115200:
+      break;
+    default:
+      return false;
+  }
+  return bus->parity <= 2 && (bus->stop_bits == 1 || bus->stop_bits == 2) &&
+         bus->timeout_ms >= 100 && bus->timeout_ms <= 5000 && bus->inter_frame_delay <= 1000;
+}
+
+bool mb_bus_route_valid(const ModbusBusRoute *route) {
+  return route->first_slave >= 1 && route->first_slave <= 247 &&
+         route->last_slave >= route->first_slave && route->last_slave <= 247 &&
+         route->bus < MB_BUS_MAX;
+}
+
+void mb_async_route_load(const ModbusBusRoute *routes) {
+  uint8_t table[256] = {0};
+  for (uint8_t i = 0; i < MB_BUS_ROUTES_MAX; i++) {
+    const ModbusBusRoute *r = &routes[i];
+    if (!mb_bus_route_valid(r)) continue;
+    memset(&table[r->first_slave], r->bus, r->last_slave - r->first_slave + 1);
+  }
+
+  bool changed = memcmp(table, g_mb_route, sizeof(table)) != 0;
+  memcpy(g_mb_route, table, sizeof(table));
+  if (changed) {
+    // Entries (and poll groups) now belong to another bus shard
+    mb_async_reset_cache();
+    mb_async_poll_load(g_persist_config.mb_poll_groups);
+  }
+}
+
+uint8_t mb_async_bus_of(uint8_t slave_id) {
+  return g_mb_route[slave_id];
+}
+
+/* ============================================================================
+ * CACHE FUNCTIONS (v7.9.8.10)
+ *
+ * entries[]     — dense array, [0, entry_count) in use (PSRAM when available)
+ * cache_index[] — open addressing, linear probing, >= 2x capacity slots so
+ *                 probe chains stay short; backward-shift delete (no tombstones)
+ * lru_prev/next — intrusive doubly linked list, head = most recently used
+ *
+ * Lookup, insert and eviction are O(1). All index/list updates run under
+ * mb_cache_spinlock, since ST builtins (Core 1), the async task (Core 0)
+ * and the web server all use the cache.
+ *
+ * A resize frees the old arrays right after the swap, so no entry pointer
+ * may outlive the lock it was looked up under: inside this file updates go
+ * by key (mb_cache_update), outside it callers get a copy.
+ * ============================================================================ */
+
+static inline uint16_t mb_cache_hash(const mb_async_state_t *b, uint8_t slave_id, uint16_t address, uint8_t req_type) {
+  uint32_t h = ((uint32_t)slave_id << 24) | ((uint32_t)req_type << 16) | address;
+  h *= 0x9E3779B1u;  // Fibonacci hashing — spreads consecutive addresses
+  return (uint16_t)((h >> 16) & b->index_mask);
+}
+
+static inline bool mb_cache_key_eq(const mb_cache_entry_t *e, uint8_t slave_id, uint16_t address, uint8_t req_type) {
+  return e->key.address == address && e->key.slave_id == slave_id && e->key.req_type == req_type;
+}
+
+// Returns entry index or MB_CACHE_NIL. Caller holds mb_cache_spinlock.
+static uint16_t mb_cache_lookup(const mb_async_state_t *b, uint8_t slave_id, uint16_t address, uint8_t req_type) {
+  if (!b->cache_index) return MB_CACHE_NIL;
+  uint16_t slot = mb_cache_hash(b, slave_id, address, req_type);
+  for (;;) {
+    uint16_t idx = b->cache_index[slot];
+    if (idx == MB_CACHE_NIL) return MB_CACHE_NIL;
+    if (mb_cache_key_eq(&b->entries[idx], slave_id, address, req_type)) return idx;
+    slot = (slot + 1) & b->index_mask;
+  }
+}
+
+static void mb_cache_index_insert(mb_async_state_t *b, uint16_t idx) {
+  const mb_cache_key_t *k = &b->entries[idx].key;
+  uint16_t slot = mb_cache_hash(b, k->slave_id, k->address, k->req_type);
+  while (b->cache_index[slot] != MB_CACHE_NIL) {
+    slot = (slot + 1) & b->index_mask;
+  }
+  b->cache_index[slot] = idx;
+}
+
+static void mb_cache_index_remove(mb_async_state_t *b, uint16_t idx) {
+  const uint16_t mask = b->index_mask;
+  const mb_cache_key_t *k = &b->entries[idx].key;
+  uint16_t hole = mb_cache_hash(b, k->slave_id, k->address, k->req_type);
+  while (b->cache_index[hole] != idx) {
+    if (b->cache_index[hole] == MB_CACHE_NIL) return;  // Not indexed
+    hole = (hole + 1) & mask;
+  }
+
+  // Backward shift: pull later chain members into the hole if their home
+  // slot is not cyclically between the hole and their current slot
+  uint16_t slot = (hole + 1) & mask;
+  while (b->cache_index[slot] != MB_CACHE_NIL) {
+    const mb_cache_key_t *m = &b->entries[b->cache_index[slot]].key;
+    uint16_t home = mb_cache_hash(b, m->slave_id, m->address, m->req_type);
+    if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+      b->cache_index[hole] = b->cache_index[slot];
+      hole = slot;
     }
+    slot = (slot + 1) & mask;
   }
-  return NULL;
+  b->cache_index[hole] = MB_CACHE_NIL;
+}
+
+static void mb_cache_lru_unlink(mb_async_state_t *b, uint16_t idx) {
+  mb_cache_entry_t *e = &b->entries[idx];
+  if (e->lru_prev != MB_CACHE_NIL) b->entries[e->lru_prev].lru_next = e->lru_next;
+  else b->lru_head = e->lru_next;
+  if (e->lru_next != MB_CACHE_NIL) b->entries[e->lru_next].lru_prev = e->lru_prev;
+  else b->lru_tail = e->lru_prev;
+  e->lru_prev = e->lru_next = MB_CACHE_NIL;
+}
+
+static void mb_cache_lru_push_front(mb_async_state_t *b, uint16_t idx) {
+  mb_cache_entry_t *e = &b->entries[idx];
+  e->lru_prev = MB_CACHE_NIL;
+  e->lru_next = b->lru_head;
+  if (b->lru_head != MB_CACHE_NIL) b->entries[b->lru_head].lru_prev = idx;
+  b->lru_head = idx;
+  if (b->lru_tail == MB_CACHE_NIL) b->lru_tail = idx;
+}
+
+// Caller holds mb_cache_spinlock; the pointer is only valid until it is released
+static mb_cache_entry_t *mb_cache_find_locked(uint8_t slave_id, uint16_t address, uint8_t req_type) {
+  mb_async_state_t *b = mb_bus_state(slave_id);
+  uint16_t idx = mb_cache_lookup(b, slave_id, address, req_type);
+  return (idx != MB_CACHE_NIL) ? &b->entries[idx] : NULL;
 }
 
-mb_cache_entry_t *mb_cache_get_or_create(uint8_t slave_id, uint16_t address, uint8_t req_type) {
+// Caller holds mb_cache_spinlock; the pointer is only valid until it is released
+static mb_cache_entry_t *mb_cache_get_or_create_locked(uint8_t slave_id, uint16_t address, uint8_t req_type) {
+  mb_async_state_t *b = mb_bus_state(slave_id);
+  if (b->cache_capacity == 0) return NULL;
+
   // Try find existing
-  mb_cache_entry_t *e = mb_cache_find(slave_id, address, req_type);
-  if (e) {
-    g_mb_async.cache_hits++;
-    return e;
+  uint16_t idx = mb_cache_lookup(b, slave_id, address, req_type);
+  if (idx != MB_CACHE_NIL) {
+    b->cache_hits++;
+    if (b->lru_head != idx) {
+      mb_cache_lru_unlink(b, idx);
+      mb_cache_lru_push_front(b, idx);
+    }
+    return &b->entries[idx];
   }
 
-  g_mb_async.cache_misses++;
+  b->cache_misses++;
 
-  // Create new if space available (use runtime limit, clamped to compile-time max)
-  uint8_t cache_limit = g_modbus_master_config.cache_max_entries;
-  if (cache_limit == 0 || cache_limit > MB_CACHE_MAX_ENTRIES) cache_limit = MB_CACHE_MAX_ENTRIES;
-  if (g_mb_async.entry_count < cache_limit) {
-    e = &g_mb_async.entries[g_mb_async.entry_count++];
+  if (b->entry_count < b->cache_capacity) {
+    idx = b->entry_count++;
   } else {
-    // LRU eviction: find oldest entry (lowest last_update_ms)
-    uint32_t oldest_ms = UINT32_MAX;
-    uint8_t oldest_idx = 0;
-    for (uint8_t i = 0; i < cache_limit; i++) {
-      // Skip PENDING entries (active request in flight)
-      if (g_mb_async.entries[i].status == MB_CACHE_PENDING) continue;
-      if (g_mb_async.entries[i].last_update_ms < oldest_ms) {
-        oldest_ms = g_mb_async.entries[i].last_update_ms;
-        oldest_idx = i;
-      }
+    // LRU eviction from the tail — skip PENDING entries (active request in flight)
+    idx = b->lru_tail;
+    while (idx != MB_CACHE_NIL && b->entries[idx].status == MB_CACHE_PENDING) {
+      idx = b->entries[idx].lru_prev;
     }
-    e = &g_mb_async.entries[oldest_idx];
+    if (idx == MB_CACHE_NIL) idx = b->lru_tail;  // Everything pending
+    mb_cache_index_remove(b, idx);
+    mb_cache_lru_unlink(b, idx);
+    b->cache_evictions++;
   }
 
+  mb_cache_entry_t *e = &b->entries[idx];
   memset(e, 0, sizeof(mb_cache_entry_t));
   e->key.slave_id = slave_id;
   e->key.address = address;
   e->key.req_type = req_type;
   e->last_fc = req_type;  // Default to keyed type until a real op completes
   e->status = MB_CACHE_EMPTY;
+  mb_cache_index_insert(b, idx);
+  mb_cache_lru_push_front(b, idx);
   return e;
 }
 
+bool mb_cache_find(uint8_t slave_id, uint16_t address, uint8_t req_type, mb_cache_entry_t *out) {
+  portENTER_CRITICAL(&mb_cache_spinlock);
+  mb_cache_entry_t *e = mb_cache_find_locked(slave_id, address, req_type);
+  if (e && out) *out = *e;
+  portEXIT_CRITICAL(&mb_cache_spinlock);
+  return e != NULL;
+}
+
+bool mb_cache_get_or_create(uint8_t slave_id, uint16_t address, uint8_t req_type, mb_cache_entry_t *out) {
+  portENTER_CRITICAL(&mb_cache_spinlock);
+  mb_cache_entry_t *e = mb_cache_get_or_create_locked(slave_id, address, req_type);
+  if (e && out) *out = *e;
+  portEXIT_CRITICAL(&mb_cache_spinlock);
+  return e != NULL;
+}
+
+bool mb_cache_entry_at(const mb_async_state_t *b, uint16_t slot, mb_cache_entry_t *out) {
+  portENTER_CRITICAL(&mb_cache_spinlock);
+  bool ok = b->entries && slot < b->entry_count;
+  if (ok) *out = b->entries[slot];
+  portEXIT_CRITICAL(&mb_cache_spinlock);
+  return ok;
+}
+
+// Store an operation result for a key: VALID with the value, or ERROR keeping the old one
+static void mb_cache_update(uint8_t slave_id, uint16_t address, uint8_t req_type, bool create,
+                            mb_error_code_t err, st_value_t value, uint8_t fc) {
+  portENTER_CRITICAL(&mb_cache_spinlock);
+  mb_cache_entry_t *ce = create ? mb_cache_get_or_create_locked(slave_id, address, req_type)
+                                : mb_cache_find_locked(slave_id, address, req_type);
+  if (ce) {
+    if (err == MB_OK) {
+      ce->value = value;
+      ce->status = MB_CACHE_VALID;
+    } else {
+      ce->status = MB_CACHE_ERROR;
+    }
+    ce->last_error = err;
+    ce->last_update_ms = millis();
+    ce->last_fc = fc;
+  }
+  portEXIT_CRITICAL(&mb_cache_spinlock);
+}
+
+uint16_t mb_async_cache_limit() {
+  return psramFound() ? MB_CACHE_MAX_ENTRIES : MB_CACHE_MAX_ENTRIES_DRAM;
+}
+
+static bool mb_cache_resize_bus(mb_async_state_t *b, uint16_t max_entries) {
+
+  uint32_t slots = 2;
+  while (slots < 2u * max_entries) slots <<= 1;
+
+  // Entries in PSRAM when present; the index is small and probed on every lookup → internal RAM
+  bool psram = psramFound();
+  mb_cache_entry_t *entries = (mb_cache_entry_t *)heap_caps_calloc(
+      max_entries, sizeof(mb_cache_entry_t), psram ? MALLOC_CAP_SPIRAM : MALLOC_CAP_8BIT);
+  uint16_t *index = (uint16_t *)heap_caps_malloc(slots * sizeof(uint16_t), MALLOC_CAP_8BIT);
+  if (!entries || !index) {
+    heap_caps_free(entries);
+    heap_caps_free(index);
+    Serial.printf("[MB_ASYNC] FEJL: Kunne ikke allokere cache for bus %u (%u entries)\n", b->bus, max_entries);
+    return false;
+  }
+  memset(index, 0xFF, slots * sizeof(uint16_t));  // MB_CACHE_NIL
+
+  portENTER_CRITICAL(&mb_cache_spinlock);
+  mb_cache_entry_t *old_entries = b->entries;
+  uint16_t *old_index = b->cache_index;
+  b->entries = entries;
+  b->cache_index = index;
+  b->cache_capacity = max_entries;
+  b->index_mask = (uint16_t)(slots - 1);
+  b->entry_count = 0;
+  b->lru_head = MB_CACHE_NIL;
+  b->lru_tail = MB_CACHE_NIL;
+  b->cache_in_psram = psram;
+  portEXIT_CRITICAL(&mb_cache_spinlock);
+
+  // Nobody holds an entry pointer outside the lock, so the old arrays can go now
+  heap_caps_free(old_entries);
+  heap_caps_free(old_index);
+  return true;
+}
+
+bool mb_async_cache_resize(uint16_t max_entries) {
+  uint16_t limit = mb_async_cache_limit();
+  if (max_entries < 1) max_entries = 1;
+  if (max_entries > limit) max_entries = limit;
+
+  // Bus 0 always has a shard (the web/ST paths use it before the task runs);
+  // extra buses only while their worker is up
+  bool ok = mb_cache_resize_bus(&g_mb_async[0], max_entries);
+  for (uint8_t bus = 1; bus < MB_BUS_MAX; bus++) {
+    if (g_mb_async[bus].task_running) ok &= mb_cache_resize_bus(&g_mb_async[bus], max_entries);
+  }
+  return ok;
+}
+
 /* ============================================================================
- * PRIORITY QUEUE (v7.9.7)
+ * PAYLOAD SLOTS (v7.9.8.16)
  *
- * Replaces FreeRTOS FIFO queue with 3-level priority:
- *   WRITE (0) > READ_FRESH (1) > READ_REFRESH (2)
- *
- * Insert: O(1) — append to end, update watermark
- * Dequeue: O(n) — scan for highest prio, oldest seq
- * Evict on full: drop newest entry with lowest priority
+ * FC16 values and FC03 block results live in ref-counted slots instead of the
+ * shared 16-register buffers: a queued write owns one reference until the
+ * worker has sent it, a stored read result owns one until it is replaced, and
+ * ST pins a result while copying it into its array.
  * ============================================================================ */
 
-static bool mb_pq_insert(mb_async_request_t *req) {
-  if (xSemaphoreTake(g_mb_async.pq_mutex, pdMS_TO_TICKS(10)) != pdTRUE) {
-    return false;
+uint8_t mb_payload_alloc() {
+  for (uint8_t i = 0; i < MB_PAYLOAD_SLOTS; i++) {
+    uint32_t expected = 0;
+    if (__atomic_compare_exchange_n(&g_mb_payload_refs[i], &expected, 1, false,
+                                    __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+      return i;
+    }
   }
+  __atomic_add_fetch(&g_mb_payload_failures, 1, __ATOMIC_RELAXED);
+  return MB_PAYLOAD_NONE;
+}
 
-  req->insert_seq = g_mb_async.pq_seq++;
+void mb_payload_retain(uint8_t slot) {
+  if (slot >= MB_PAYLOAD_SLOTS) return;
+  __atomic_add_fetch(&g_mb_payload_refs[slot], 1, __ATOMIC_RELAXED);
+}
 
-  // Use runtime queue limit (clamped to compile-time max)
-  uint8_t q_limit = g_modbus_master_config.queue_max_size;
-  if (q_limit == 0 || q_limit > MB_ASYNC_QUEUE_SIZE) q_limit = MB_ASYNC_QUEUE_SIZE;
+void mb_payload_release(uint8_t slot) {
+  if (slot >= MB_PAYLOAD_SLOTS) return;
+  __atomic_sub_fetch(&g_mb_payload_refs[slot], 1, __ATOMIC_RELEASE);
+}
 
-  if (g_mb_async.pq_count < q_limit) {
-    // Space available — just append
-    g_mb_async.pq_buf[g_mb_async.pq_count] = *req;
-    g_mb_async.pq_count++;
-  } else {
-    // Queue full — evict newest entry with lowest priority
-    // Find victim: highest priority value (lowest importance), highest insert_seq (newest)
-    int victim = -1;
-    uint8_t worst_prio = 0;
-    uint16_t newest_seq = 0;
-    for (uint8_t i = 0; i < g_mb_async.pq_count; i++) {
-      uint8_t p = g_mb_async.pq_buf[i].priority;
-      uint16_t s = g_mb_async.pq_buf[i].insert_seq;
-      if (p > worst_prio || (p == worst_prio && (victim == -1 || s > newest_seq))) {
-        worst_prio = p;
-        newest_seq = s;
-        victim = i;
-      }
+uint16_t *mb_payload_data(uint8_t slot) {
+  return (slot < MB_PAYLOAD_SLOTS) ? g_mb_payload[slot] : NULL;
+}
+
+uint8_t mb_payload_in_use() {
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < MB_PAYLOAD_SLOTS; i++) {
+    if (__atomic_load_n(&g_mb_payload_refs[i], __ATOMIC_RELAXED) > 0) n++;
+  }
+  return n;
+}
+
+uint32_t mb_payload_alloc_failures() {
+  return g_mb_payload_failures;
+}
+
+uint8_t mb_async_block_result_pin(uint8_t slave_id, uint16_t address, uint8_t count) {
+  uint8_t slot = MB_PAYLOAD_NONE;
+  portENTER_CRITICAL(&mb_cache_spinlock);
+  for (uint8_t i = 0; i < MB_BLOCK_RESULTS_MAX; i++) {
+    const mb_block_result_t *r = &g_mb_block_results[i];
+    if (r->slave_id == slave_id && r->address == address && r->count == count) {
+      slot = r->payload;
+      mb_payload_retain(slot);
+      break;
     }
+  }
+  portEXIT_CRITICAL(&mb_cache_spinlock);
+  return slot;
+}
 
-    // Only evict if victim has lower priority (higher number) than new request
-    if (victim >= 0 && worst_prio > req->priority) {
-      g_mb_async.pq_buf[victim] = *req;
-      g_mb_async.priority_drops++;
-    } else if (victim >= 0 && worst_prio == req->priority) {
-      // Same priority — drop the new request (it's newest)
-      g_mb_async.queue_full_count++;
-      xSemaphoreGive(g_mb_async.pq_mutex);
-      return false;
+// Drop the least recently updated result (frees its slot unless ST has it pinned)
+static bool mb_block_result_evict_oldest() {
+  uint8_t slot = MB_PAYLOAD_NONE;
+  portENTER_CRITICAL(&mb_cache_spinlock);
+  int8_t oldest = -1;
+  for (uint8_t i = 0; i < MB_BLOCK_RESULTS_MAX; i++) {
+    const mb_block_result_t *r = &g_mb_block_results[i];
+    if (r->slave_id == 0) continue;
+    if (oldest < 0 || (int32_t)(r->last_update_ms - g_mb_block_results[oldest].last_update_ms) < 0) oldest = i;
+  }
+  if (oldest >= 0) {
+    slot = g_mb_block_results[oldest].payload;
+    memset(&g_mb_block_results[oldest], 0, sizeof(mb_block_result_t));
+  }
+  portEXIT_CRITICAL(&mb_cache_spinlock);
+  mb_payload_release(slot);
+  return oldest >= 0;
+}
+
+// Worker: store a successful block read, replacing an older result for the same block
+static void mb_block_result_publish(uint8_t slave_id, uint16_t address, uint8_t count, const uint16_t *regs) {
+  uint8_t slot = mb_payload_alloc();
+  if (slot == MB_PAYLOAD_NONE && mb_block_result_evict_oldest()) slot = mb_payload_alloc();
+  if (slot == MB_PAYLOAD_NONE) return;  // Pool held by queued writes — cache entries still updated
+  memcpy(g_mb_payload[slot], regs, count * sizeof(uint16_t));
+
+  uint8_t old = MB_PAYLOAD_NONE;
+  portENTER_CRITICAL(&mb_cache_spinlock);
+  // Same block > free entry > least recently updated
+  uint8_t target = 0;
+  uint8_t rank = 0;  // 3 = same block, 2 = free, 1 = used
+  for (uint8_t i = 0; i < MB_BLOCK_RESULTS_MAX && rank < 3; i++) {
+    const mb_block_result_t *c = &g_mb_block_results[i];
+    uint8_t cr = (c->slave_id == slave_id && c->address == address && c->count == count) ? 3
+               : (c->slave_id == 0) ? 2 : 1;
+    if (cr > rank || (cr == 1 && rank == 1 &&
+        (int32_t)(c->last_update_ms - g_mb_block_results[target].last_update_ms) < 0)) {
+      target = i;
+      rank = cr;
+    }
+  }
+  mb_block_result_t *r = &g_mb_block_results[target];
+  if (r->slave_id != 0) old = r->payload;
+  r->slave_id = slave_id;
+  r->address = address;
+  r->count = count;
+  r->payload = slot;
+  r->last_update_ms = millis();
+  portEXIT_CRITICAL(&mb_cache_spinlock);
+  mb_payload_release(old);
+}
+
+static void mb_block_results_clear() {
+  for (uint8_t i = 0; i < MB_BLOCK_RESULTS_MAX; i++) {
+    uint8_t slot = MB_PAYLOAD_NONE;
+    portENTER_CRITICAL(&mb_cache_spinlock);
+    if (g_mb_block_results[i].slave_id != 0) slot = g_mb_block_results[i].payload;
+    memset(&g_mb_block_results[i], 0, sizeof(mb_block_result_t));
+    portEXIT_CRITICAL(&mb_cache_spinlock);
+    mb_payload_release(slot);
+  }
+}
+
+/* ============================================================================
+ * PRIORITY QUEUE (v7.9.7, lock-free rings v7.9.8.15)
+ *
+ * One bounded MPSC ring per priority class:
+ *   WRITE (0) > READ_FRESH (1) > READ_REFRESH (2)
+ *
+ * Insert: lock-free — reserve budget in pq_count, CAS-claim a ring slot, publish
+ * Dequeue: O(1) — pop the head of the highest non-empty class (worker task only)
+ * Evict on full: a higher class may overshoot the runtime limit by one; the
+ *   worker then drops the oldest request of the lowest non-empty lower class
+ *
+ * A producer preempted between claiming and publishing a slot hides the slots
+ * behind it; the worker retries on its next wakeup (max 100 ms).
+ * ============================================================================ */
+
+#define MB_PQ_MASK (MB_ASYNC_QUEUE_SIZE - 1)
+static_assert((MB_ASYNC_QUEUE_SIZE & MB_PQ_MASK) == 0, "MB_ASYNC_QUEUE_SIZE must be a power of two");
+
+static void mb_pq_ring_init(mb_pq_ring_t *r) {
+  r->head = 0;
+  r->tail = 0;
+  r->count = 0;
+  for (uint32_t i = 0; i < MB_ASYNC_QUEUE_SIZE; i++) {
+    r->seq[i] = i;
+    r->taken[i] = 0;
+  }
+}
+
+static bool mb_pq_ring_push(mb_async_state_t *b, mb_pq_ring_t *r, const mb_async_request_t *req) {
+  uint32_t pos = __atomic_load_n(&r->head, __ATOMIC_RELAXED);
+  for (;;) {
+    uint32_t idx = pos & MB_PQ_MASK;
+    uint32_t seq = __atomic_load_n(&r->seq[idx], __ATOMIC_ACQUIRE);
+    int32_t diff = (int32_t)(seq - pos);
+    if (diff == 0) {
+      if (__atomic_compare_exchange_n(&r->head, &pos, pos + 1, true,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        r->slot[idx] = *req;
+        __atomic_store_n(&r->seq[idx], pos + 1, __ATOMIC_RELEASE);
+        __atomic_add_fetch(&r->count, 1, __ATOMIC_RELAXED);
+        return true;
+      }
+      // Lost the race — pos now holds the current head
+      __atomic_add_fetch(&b->queue_contention, 1, __ATOMIC_RELAXED);
+    } else if (diff < 0) {
+      return false;  // Ring full (slot not yet released by the worker)
     } else {
-      // New request is lower priority than everything in queue — drop it
-      g_mb_async.queue_full_count++;
-      xSemaphoreGive(g_mb_async.pq_mutex);
-      return false;
+      __atomic_add_fetch(&b->queue_contention, 1, __ATOMIC_RELAXED);
+      pos = __atomic_load_n(&r->head, __ATOMIC_RELAXED);
     }
   }
+}
 
-  // Update watermark
-  if (g_mb_async.pq_count > g_mb_async.queue_high_watermark) {
-    g_mb_async.queue_high_watermark = g_mb_async.pq_count;
+// Worker only: pop the oldest published request, skipping slots taken by coalescing
+static bool mb_pq_ring_pop(mb_pq_ring_t *r, mb_async_request_t *out) {
+  for (;;) {
+    uint32_t pos = r->tail;
+    uint32_t idx = pos & MB_PQ_MASK;
+    if (__atomic_load_n(&r->seq[idx], __ATOMIC_ACQUIRE) != pos + 1) return false;
+
+    bool skip = r->taken[idx] != 0;
+    r->taken[idx] = 0;
+    if (!skip) *out = r->slot[idx];
+    __atomic_store_n(&r->seq[idx], pos + MB_ASYNC_QUEUE_SIZE, __ATOMIC_RELEASE);
+    r->tail = pos + 1;
+    if (!skip) {
+      __atomic_sub_fetch(&r->count, 1, __ATOMIC_RELAXED);
+      return true;
+    }
   }
+}
 
-  xSemaphoreGive(g_mb_async.pq_mutex);
-  xSemaphoreGive(g_mb_async.pq_semaphore);  // Signal consumer
-  return true;
+// Worker only: mark a published slot as consumed by a coalesced block
+static void mb_pq_ring_take(mb_async_state_t *b, mb_pq_ring_t *r, uint32_t pos) {
+  r->taken[pos & MB_PQ_MASK] = 1;
+  __atomic_sub_fetch(&r->count, 1, __ATOMIC_RELAXED);
+  __atomic_sub_fetch(&b->pq_count, 1, __ATOMIC_RELAXED);
 }
 
-static bool mb_pq_dequeue(mb_async_request_t *out) {
-  if (xSemaphoreTake(g_mb_async.pq_mutex, pdMS_TO_TICKS(10)) != pdTRUE) {
-    return false;
+// Reserve one eviction of a request below class prio (false = nothing to evict)
+static bool mb_pq_reserve_eviction(mb_async_state_t *b, uint8_t prio) {
+  uint32_t lower = 0;
+  for (uint8_t c = prio + 1; c < MB_PRIO_COUNT; c++) {
+    lower += __atomic_load_n(&b->pq_ring[c].count, __ATOMIC_RELAXED);
   }
+  uint32_t e = __atomic_load_n(&b->pq_evict, __ATOMIC_RELAXED);
+  do {
+    if (e >= lower) return false;
+  } while (!__atomic_compare_exchange_n(&b->pq_evict, &e, e + 1, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+  return true;
+}
 
-  if (g_mb_async.pq_count == 0) {
-    xSemaphoreGive(g_mb_async.pq_mutex);
-    return false;
+// Consume one reserved eviction (false if the counter is already 0). Producers
+// cancel and the worker claims concurrently, so never decrement past zero.
+static bool mb_pq_eviction_claim(mb_async_state_t *b) {
+  uint32_t e = __atomic_load_n(&b->pq_evict, __ATOMIC_RELAXED);
+  do {
+    if (e == 0) return false;
+  } while (!__atomic_compare_exchange_n(&b->pq_evict, &e, e - 1, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+  return true;
+}
+
+// Undo the PENDING mark of a read that will never execute
+static void mb_pq_revert_pending(mb_async_state_t *b, const mb_async_request_t *req) {
+  uint8_t n = 1;
+  uint8_t type = req->type;
+  if (type == MB_REQ_READ_HOLDINGS) {
+    n = req->count;
+    type = MB_REQ_READ_HOLDING;
+  } else if (type > MB_REQ_READ_INPUT_REG) {
+    return;  // Writes keep their pending value
   }
+  portENTER_CRITICAL(&mb_cache_spinlock);
+  for (uint8_t i = 0; i < n; i++) {
+    uint16_t idx = mb_cache_lookup(b, req->slave_id, req->address + i, type);
+    if (idx == MB_CACHE_NIL) continue;
+    mb_cache_entry_t *entry = &b->entries[idx];
+    if (entry->status == MB_CACHE_PENDING) {
+      entry->status = (entry->last_update_ms > 0) ? MB_CACHE_VALID : MB_CACHE_EMPTY;
+    }
+  }
+  portEXIT_CRITICAL(&mb_cache_spinlock);
+}
 
-  // Find highest priority (lowest value), oldest (lowest insert_seq)
-  int best = 0;
-  for (uint8_t i = 1; i < g_mb_async.pq_count; i++) {
-    uint8_t bp = g_mb_async.pq_buf[best].priority;
-    uint8_t ip = g_mb_async.pq_buf[i].priority;
-    if (ip < bp || (ip == bp && g_mb_async.pq_buf[i].insert_seq < g_mb_async.pq_buf[best].insert_seq)) {
-      best = i;
+static bool mb_pq_insert(mb_async_state_t *b, mb_async_request_t *req) {
+  if (!b->pq_semaphore) return false;  // Bus not running
+  req->queued_us = micros();
+
+  uint8_t prio = req->priority;
+  if (prio >= MB_PRIO_COUNT) prio = MB_PRIO_READ_REFRESH;
+
+  // Use runtime queue limit (clamped to compile-time max)
+  uint8_t q_limit = g_modbus_master_config.queue_max_size;
+  if (q_limit == 0 || q_limit > MB_ASYNC_QUEUE_SIZE) q_limit = MB_ASYNC_QUEUE_SIZE;
+
+  bool evict = false;
+  uint32_t depth = __atomic_add_fetch(&b->pq_count, 1, __ATOMIC_RELAXED);
+  if (depth > q_limit) {
+    // Queue full — only displace a request of lower priority (same priority: drop the new one)
+    evict = mb_pq_reserve_eviction(b, prio);
+    if (!evict) {
+      __atomic_sub_fetch(&b->pq_count, 1, __ATOMIC_RELAXED);
+      __atomic_add_fetch(&b->queue_full_count, 1, __ATOMIC_RELAXED);
+      return false;
     }
   }
 
-  *out = g_mb_async.pq_buf[best];
+  if (!mb_pq_ring_push(b, &b->pq_ring[prio], req)) {
+    __atomic_sub_fetch(&b->pq_count, 1, __ATOMIC_RELAXED);
+    if (evict) mb_pq_eviction_claim(b);
+    __atomic_add_fetch(&b->queue_full_count, 1, __ATOMIC_RELAXED);
+    return false;
+  }
 
-  // Remove by swapping with last
-  g_mb_async.pq_count--;
-  if ((uint8_t)best < g_mb_async.pq_count) {
-    g_mb_async.pq_buf[best] = g_mb_async.pq_buf[g_mb_async.pq_count];
+  // Update watermark (statistic — a lost update between producers is harmless).
+  // depth may include reservations of producers that are about to be rejected.
+  if (depth > q_limit) depth = q_limit;
+  if (depth > b->queue_high_watermark) {
+    b->queue_high_watermark = (uint8_t)depth;
   }
 
-  xSemaphoreGive(g_mb_async.pq_mutex);
+  xSemaphoreGive(b->pq_semaphore);  // Signal consumer
   return true;
 }
 
+static bool mb_pq_pop_class(mb_async_state_t *b, uint8_t prio, mb_async_request_t *out) {
+  if (!mb_pq_ring_pop(&b->pq_ring[prio], out)) return false;
+  __atomic_sub_fetch(&b->pq_count, 1, __ATOMIC_RELAXED);
+  return true;
+}
+
+static bool mb_pq_dequeue(mb_async_state_t *b, mb_async_request_t *out) {
+  // Priority eviction: drop the oldest request of the lowest non-empty class
+  while (mb_pq_eviction_claim(b)) {
+    mb_async_request_t victim;
+    for (uint8_t c = MB_PRIO_COUNT - 1; c > MB_PRIO_WRITE; c--) {
+      if (mb_pq_pop_class(b, c, &victim)) {
+        mb_pq_revert_pending(b, &victim);
+        b->priority_drops++;
+        break;
+      }
+    }
+  }
+
+  for (uint8_t c = 0; c < MB_PRIO_COUNT; c++) {
+    if (mb_pq_pop_class(b, c, out)) return true;
+  }
+  return false;
+}
+
 /* ============================================================================
  * QUEUE FUNCTIONS
  * ============================================================================ */
 
 bool mb_async_queue_read(mb_request_type_t type, uint8_t slave_id, uint16_t address) {
-  // Check cache — if already PENDING and cache enabled, skip (deduplication)
   extern bool g_mb_cache_enabled;
-  mb_cache_entry_t *entry = mb_cache_find(slave_id, address, (uint8_t)type);
-  if (g_mb_cache_enabled && entry && entry->status == MB_CACHE_PENDING) {
-    return true;  // Already queued
-  }
+  mb_async_state_t *b = mb_bus_state(slave_id);
 
-  // Determine priority: fresh (no cache) vs refresh (has cached value)
+  // Test-and-set PENDING in one critical section, so concurrent callers for the
+  // same key queue one request (v7.9.8.15: was a separate find + set)
   uint8_t prio = MB_PRIO_READ_FRESH;
-  if (entry && entry->status == MB_CACHE_VALID) {
-    prio = MB_PRIO_READ_REFRESH;
-  }
-
-  // Mark as pending
-  if (!entry) {
-    entry = mb_cache_get_or_create(slave_id, address, (uint8_t)type);
-  }
-  if (entry) {
-    portENTER_CRITICAL(&mb_cache_spinlock);
+  bool in_flight = false;
+  portENTER_CRITICAL(&mb_cache_spinlock);
+  mb_cache_entry_t *entry = mb_cache_find_locked(slave_id, address, (uint8_t)type);
+  if (!entry) entry = mb_cache_get_or_create_locked(slave_id, address, (uint8_t)type);
+  bool cached = entry != NULL;
+  if (entry && g_mb_cache_enabled && entry->status == MB_CACHE_PENDING) {
+    in_flight = true;
+  } else if (entry) {
+    // Fresh (no cached value) vs refresh (client already has a value)
+    if (entry->status == MB_CACHE_VALID) prio = MB_PRIO_READ_REFRESH;
     entry->status = MB_CACHE_PENDING;
-    portEXIT_CRITICAL(&mb_cache_spinlock);
+  }
+  portEXIT_CRITICAL(&mb_cache_spinlock);
+  if (in_flight) {
+    __atomic_add_fetch(&b->queue_dedup, 1, __ATOMIC_RELAXED);
+    return true;  // Already queued or executing
   }
 
   // Build request
@@ -215,11 +684,12 @@ bool mb_async_queue_read(mb_request_type_t type, uint8_t slave_id, uint16_t addr
   req.address = address;
   req.priority = prio;
 
-  if (!mb_pq_insert(&req)) {
-    // Revert status on queue-full
-    if (entry) {
+  if (!mb_pq_insert(b, &req)) {
+    // Revert status on queue-full (looked up again — the entry may have moved)
+    if (cached) {
       portENTER_CRITICAL(&mb_cache_spinlock);
-      entry->status = (entry->last_update_ms > 0) ? MB_CACHE_VALID : MB_CACHE_EMPTY;
+      mb_cache_entry_t *e = mb_cache_find_locked(slave_id, address, (uint8_t)type);
+      if (e) e->status = (e->last_update_ms > 0) ? MB_CACHE_VALID : MB_CACHE_EMPTY;
       portEXIT_CRITICAL(&mb_cache_spinlock);
     }
     return false;
@@ -228,55 +698,124 @@ bool mb_async_queue_read(mb_request_type_t type, uint8_t slave_id, uint16_t addr
   return true;
 }
 
+// Pending write of (slave, type, address) or NULL. Caller holds mb_cache_spinlock.
+static mb_write_pending_t *mb_write_pending_find(mb_async_state_t *b, uint8_t slave_id, uint8_t type, uint16_t address) {
+  for (uint8_t i = 0; i < MB_WRITE_PENDING_MAX; i++) {
+    mb_write_pending_t *p = &b->write_pending[i];
+    if (p->slave_id == slave_id && p->address == address && p->req_type == type) return p;
+  }
+  return NULL;
+}
+
+bool mb_async_write_always(uint8_t slave_id) {
+  return (g_persist_config.mb_write_always[slave_id >> 3] >> (slave_id & 7)) & 0x01;
+}
+
+void mb_async_write_always_set(uint8_t first, uint8_t last, bool on) {
+  for (uint16_t id = first; id <= last; id++) {
+    uint8_t mask = (uint8_t)(1 << (id & 7));
+    if (on) g_persist_config.mb_write_always[id >> 3] |= mask;
+    else g_persist_config.mb_write_always[id >> 3] &= (uint8_t)~mask;
+  }
+}
+
 bool mb_async_queue_write(mb_request_type_t type, uint8_t slave_id, uint16_t address, st_value_t value) {
-  // Write deduplication: skip if cache shows same value already written successfully
   extern bool g_mb_cache_enabled;
-  if (g_mb_cache_enabled) {
-    uint8_t read_type = (type == MB_REQ_WRITE_COIL) ? (uint8_t)MB_REQ_READ_COIL : (uint8_t)MB_REQ_READ_HOLDING;
-    mb_cache_entry_t *cached = mb_cache_find(slave_id, address, read_type);
-    if (cached && cached->status == MB_CACHE_VALID &&
-        cached->value.int_val == value.int_val) {
-      return true;  // Same value already confirmed written — skip
-    }
+  mb_async_state_t *b = mb_bus_state(slave_id);
+  uint8_t cache_type = (type == MB_REQ_WRITE_COIL) ? (uint8_t)MB_REQ_READ_COIL : (uint8_t)MB_REQ_READ_HOLDING;
+  bool combine = g_modbus_master_config.write_combine != 0 && slave_id != 0;  // 0 = free entry
+  bool dedup = g_mb_cache_enabled && !mb_async_write_always(slave_id);
+  if (type == MB_REQ_WRITE_COIL) {
+    // Normalise so cached coil values compare equal however the caller built the bool
+    bool on = value.bool_val;
+    value.int_val = 0;
+    value.bool_val = on;
   }
 
-  mb_async_request_t req;
-  memset(&req, 0, sizeof(req));
-  req.type = type;
-  req.slave_id = slave_id;
-  req.address = address;
-  req.write_value = value;
-  req.priority = MB_PRIO_WRITE;
-
-  if (!mb_pq_insert(&req)) {
-    return false;
+  // One critical section: a concurrent write to the same key either finds
+  // this entry or runs before it (v7.9.8.19)
+  enum { WR_QUEUE, WR_COMBINED, WR_SKIPPED, WR_CLAIMED } outcome = WR_QUEUE;
+  mb_write_pending_t *pending = NULL;
+  portENTER_CRITICAL(&mb_cache_spinlock);
+  if (combine) pending = mb_write_pending_find(b, slave_id, (uint8_t)type, address);
+  if (pending) {
+    // Last value wins — the waiting request sends whatever is here when it runs
+    pending->value = value;
+    b->write_combined++;
+    outcome = WR_COMBINED;
+  } else {
+    // Write deduplication: skip if cache shows same value already confirmed
+    uint16_t idx = dedup ? mb_cache_lookup(b, slave_id, address, cache_type) : MB_CACHE_NIL;
+    if (idx != MB_CACHE_NIL && b->entries[idx].status == MB_CACHE_VALID &&
+        (uint16_t)b->entries[idx].value.int_val == (uint16_t)value.int_val) {
+      b->write_skipped++;
+      outcome = WR_SKIPPED;
+    } else if (combine) {
+      // Claim a free entry (table full: queue a plain write)
+      for (uint8_t i = 0; i < MB_WRITE_PENDING_MAX && !pending; i++) {
+        if (b->write_pending[i].slave_id == 0) pending = &b->write_pending[i];
+      }
+      if (pending) {
+        pending->slave_id = slave_id;
+        pending->req_type = (uint8_t)type;
+        pending->address = address;
+        pending->value = value;
+        outcome = WR_CLAIMED;
+      }
+    }
+  }
+  portEXIT_CRITICAL(&mb_cache_spinlock);
+  if (outcome == WR_SKIPPED) return true;
+
+  if (outcome != WR_COMBINED) {
+    mb_async_request_t req;
+    memset(&req, 0, sizeof(req));
+    req.type = type;
+    req.slave_id = slave_id;
+    req.address = address;
+    req.write_value = value;
+    req.priority = MB_PRIO_WRITE;
+    req.combined = (outcome == WR_CLAIMED) ? 1 : 0;
+
+    if (!mb_pq_insert(b, &req)) {
+      if (outcome == WR_CLAIMED) {
+        // Give the entry back unless a block write already took it
+        portENTER_CRITICAL(&mb_cache_spinlock);
+        if (pending->slave_id == slave_id && pending->address == address && pending->req_type == (uint8_t)type) {
+          pending->slave_id = 0;
+        }
+        portEXIT_CRITICAL(&mb_cache_spinlock);
+      }
+      return false;
+    }
   }
 
   // Update cache to reflect the pending write value
-  uint8_t cache_type = (type == MB_REQ_WRITE_COIL) ? (uint8_t)MB_REQ_READ_COIL : (uint8_t)MB_REQ_READ_HOLDING;
-  mb_cache_entry_t *entry = mb_cache_get_or_create(slave_id, address, cache_type);
+  portENTER_CRITICAL(&mb_cache_spinlock);
+  mb_cache_entry_t *entry = mb_cache_get_or_create_locked(slave_id, address, cache_type);
   if (entry) {
-    portENTER_CRITICAL(&mb_cache_spinlock);
     entry->value = value;
     entry->status = MB_CACHE_PENDING;
-    portEXIT_CRITICAL(&mb_cache_spinlock);
   }
+  portEXIT_CRITICAL(&mb_cache_spinlock);
 
   return true;
 }
 
 bool mb_async_queue_read_multi(uint8_t slave_id, uint16_t address, uint8_t count) {
-  if (count == 0 || count > 16) return false;
+  if (count == 0 || count > MB_PAYLOAD_REGS) return false;
 
   // Check if any of the addresses already have cached values → refresh priority
   uint8_t prio = MB_PRIO_READ_FRESH;
+  portENTER_CRITICAL(&mb_cache_spinlock);
   for (uint8_t i = 0; i < count; i++) {
-    mb_cache_entry_t *e = mb_cache_find(slave_id, address + i, (uint8_t)MB_REQ_READ_HOLDING);
+    mb_cache_entry_t *e = mb_cache_find_locked(slave_id, address + i, (uint8_t)MB_REQ_READ_HOLDING);
     if (e && e->status == MB_CACHE_VALID) {
       prio = MB_PRIO_READ_REFRESH;
       break;
     }
   }
+  portEXIT_CRITICAL(&mb_cache_spinlock);
 
   mb_async_request_t req;
   memset(&req, 0, sizeof(req));
@@ -287,29 +826,36 @@ bool mb_async_queue_read_multi(uint8_t slave_id, uint16_t address, uint8_t count
   req.priority = prio;
 
   // Mark all individual cache entries as pending
+  portENTER_CRITICAL(&mb_cache_spinlock);
   for (uint8_t i = 0; i < count; i++) {
-    mb_cache_entry_t *entry = mb_cache_get_or_create(slave_id, address + i, (uint8_t)MB_REQ_READ_HOLDING);
-    if (entry) {
-      portENTER_CRITICAL(&mb_cache_spinlock);
-      entry->status = MB_CACHE_PENDING;
-      portEXIT_CRITICAL(&mb_cache_spinlock);
-    }
+    mb_cache_entry_t *entry = mb_cache_get_or_create_locked(slave_id, address + i, (uint8_t)MB_REQ_READ_HOLDING);
+    if (entry) entry->status = MB_CACHE_PENDING;
   }
+  portEXIT_CRITICAL(&mb_cache_spinlock);
 
-  if (!mb_pq_insert(&req)) {
-    g_mb_async.queue_full_count++;
+  mb_async_state_t *b = mb_bus_state(slave_id);
+  if (!mb_pq_insert(b, &req)) {
+    mb_pq_revert_pending(b, &req);
     return false;
   }
   return true;
 }
 
 bool mb_async_queue_write_multi(uint8_t slave_id, uint16_t address, uint8_t count, const uint16_t *values) {
-  if (count == 0 || count > 16) return false;
+  if (count == 0 || count > MODBUS_MASTER_MAX_WRITE_REGS) return false;
 
-  // Allocate a pool slot for multi-reg values (ring-buffer, wraps at 4)
-  uint8_t slot = g_mb_multi_write_next;
-  g_mb_multi_write_next = (g_mb_multi_write_next + 1) % MB_MULTI_REG_POOL_SIZE;
-  memcpy(g_mb_multi_write_pool[slot], values, count * sizeof(uint16_t));
+  uint8_t slot = mb_payload_alloc();
+  if (slot == MB_PAYLOAD_NONE) return false;
+  memcpy(mb_payload_data(slot), values, count * sizeof(uint16_t));
+  return mb_async_queue_write_payload(slave_id, address, count, slot);
+}
+
+bool mb_async_queue_write_payload(uint8_t slave_id, uint16_t address, uint8_t count, uint8_t payload) {
+  if (payload >= MB_PAYLOAD_SLOTS) return false;
+  if (count == 0 || count > MODBUS_MASTER_MAX_WRITE_REGS) {
+    mb_payload_release(payload);
+    return false;
+  }
 
   mb_async_request_t req;
   memset(&req, 0, sizeof(req));
@@ -317,22 +863,27 @@ bool mb_async_queue_write_multi(uint8_t slave_id, uint16_t address, uint8_t coun
   req.slave_id = slave_id;
   req.address = address;
   req.count = count;
-  req.multi_pool_slot = slot;
+  req.payload = payload;
   req.priority = MB_PRIO_WRITE;
 
-  if (!mb_pq_insert(&req)) {
-    g_mb_async.queue_full_count++;
+  if (!mb_pq_insert(mb_bus_state(slave_id), &req)) {
+    mb_payload_release(payload);
     return false;
   }
   return true;
 }
 
 bool mb_async_is_busy() {
-  return g_mb_async.pq_count > 0;
+  for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+    if (g_mb_async[bus].pq_count > 0) return true;
+  }
+  return false;
 }
 
 uint8_t mb_async_queue_depth() {
-  return g_mb_async.pq_count;
+  uint8_t depth = 0;
+  for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) depth += g_mb_async[bus].pq_count;
+  return depth;
 }
 
 /* ============================================================================
@@ -347,15 +898,15 @@ uint8_t mb_async_queue_depth() {
  * but subsequent requests wait 2s between attempts instead of flooding the bus.
  * ============================================================================ */
 
-static uint8_t mb_backoff_find_or_create(uint8_t slave_id) {
+static uint8_t mb_backoff_find_or_create(mb_async_state_t *b, uint8_t slave_id) {
   // Find existing slot
   for (uint8_t i = 0; i < MB_SLAVE_BACKOFF_MAX; i++) {
-    if (g_mb_async.slave_backoff[i].slave_id == slave_id) return i;
+    if (b->slave_backoff[i].slave_id == slave_id) return i;
   }
   // Find empty slot
   for (uint8_t i = 0; i < MB_SLAVE_BACKOFF_MAX; i++) {
-    if (g_mb_async.slave_backoff[i].slave_id == 0) {
-      g_mb_async.slave_backoff[i].slave_id = slave_id;
+    if (b->slave_backoff[i].slave_id == 0) {
+      b->slave_backoff[i].slave_id = slave_id;
       return i;
     }
   }
@@ -363,19 +914,19 @@ static uint8_t mb_backoff_find_or_create(uint8_t slave_id) {
   uint8_t min_idx = 0;
   uint16_t min_bo = UINT16_MAX;
   for (uint8_t i = 0; i < MB_SLAVE_BACKOFF_MAX; i++) {
-    if (g_mb_async.slave_backoff[i].backoff_ms < min_bo) {
-      min_bo = g_mb_async.slave_backoff[i].backoff_ms;
+    if (b->slave_backoff[i].backoff_ms < min_bo) {
+      min_bo = b->slave_backoff[i].backoff_ms;
       min_idx = i;
     }
   }
-  memset(&g_mb_async.slave_backoff[min_idx], 0, sizeof(g_mb_async.slave_backoff[0]));
-  g_mb_async.slave_backoff[min_idx].slave_id = slave_id;
+  memset(&b->slave_backoff[min_idx], 0, sizeof(b->slave_backoff[0]));
+  b->slave_backoff[min_idx].slave_id = slave_id;
   return min_idx;
 }
 
-static void mb_backoff_on_timeout(uint8_t slave_id) {
-  uint8_t idx = mb_backoff_find_or_create(slave_id);
-  auto &s = g_mb_async.slave_backoff[idx];
+static void mb_backoff_on_timeout(mb_async_state_t *b, uint8_t slave_id) {
+  uint8_t idx = mb_backoff_find_or_create(b, slave_id);
+  auto &s = b->slave_backoff[idx];
   s.timeout_count++;
   s.success_count = 0;
   if (s.backoff_ms == 0) {
@@ -385,9 +936,9 @@ static void mb_backoff_on_timeout(uint8_t slave_id) {
   }
 }
 
-static void mb_backoff_on_success(uint8_t slave_id) {
-  uint8_t idx = mb_backoff_find_or_create(slave_id);
-  auto &s = g_mb_async.slave_backoff[idx];
+static void mb_backoff_on_success(mb_async_state_t *b, uint8_t slave_id) {
+  uint8_t idx = mb_backoff_find_or_create(b, slave_id);
+  auto &s = b->slave_backoff[idx];
   s.timeout_count = 0;
   s.success_count++;
   if (s.backoff_ms > 0) {
@@ -395,55 +946,636 @@ static void mb_backoff_on_success(uint8_t slave_id) {
   }
 }
 
+// True if the slave is still cooling down (caller skips the transaction).
+// Otherwise the attempt time is stamped for the next check.
+static bool mb_backoff_cooling(mb_async_state_t *b, uint8_t slave_id) {
+  for (uint8_t i = 0; i < MB_SLAVE_BACKOFF_MAX; i++) {
+    auto &s = b->slave_backoff[i];
+    if (s.slave_id != slave_id) continue;
+    if (s.backoff_ms == 0) return false;
+    if (millis() - s.last_attempt_ms < s.backoff_ms) return true;
+    s.last_attempt_ms = millis();
+    return false;
+  }
+  return false;
+}
+
+/* ============================================================================
+ * READ COALESCING (v7.9.8.11)
+ *
+ * After a single read (FC01-FC04) is dequeued, the queue is searched for
+ * other single reads to the same slave and FC. Those within the block
+ * window are removed from the queue and served by ONE block read:
+ *
+ *   MB_READ_HOLDING(1, 100..107) → 8 × FC03 qty 1  →  1 × FC03 qty 8
+ *
+ * Gaps of up to coalesce_gap unused registers (×16 for bits, same bytes
+ * on the wire) are bridged. Results are scattered into the cache entries
+ * of every address in the block that is cached. If the slave rejects the
+ * block (exception, e.g. a bridged address does not exist), the members
+ * are re-read one by one.
+ * ============================================================================ */
+
+static uint16_t g_mb_coalesce_regs[MB_BUS_MAX][MODBUS_MASTER_MAX_READ_REGS];
+static uint8_t g_mb_coalesce_bits[MB_BUS_MAX][(MODBUS_MASTER_MAX_READ_BITS + 7) / 8];
+
+// Function code on the wire (FC01-FC06 share their enum value)
+static inline uint8_t mb_async_request_fc(uint8_t type) {
+  if (type == MB_REQ_READ_HOLDINGS) return 0x03;
+  if (type == MB_REQ_WRITE_HOLDINGS) return 0x10;
+  return type;
+}
+
+static inline bool mb_coalesce_is_bit_type(uint8_t type) {
+  return type == MB_REQ_READ_COIL || type == MB_REQ_READ_INPUT;
+}
+
+static void mb_coalesce_sort(uint16_t *a, uint8_t n) {
+  for (uint8_t i = 1; i < n; i++) {
+    uint16_t v = a[i];
+    uint8_t j = i;
+    while (j > 0 && a[j - 1] > v) {
+      a[j] = a[j - 1];
+      j--;
+    }
+    a[j] = v;
+  }
+}
+
+uint16_t mb_coalesce_select(const uint16_t *addrs, uint8_t n, uint16_t seed,
+                            uint16_t max_span, uint16_t max_gap, uint16_t *start) {
+  uint8_t lo = 0;
+  while (lo < n && addrs[lo] != seed) lo++;
+  if (lo == n) {
+    *start = seed;
+    return 1;
+  }
+  uint8_t hi = lo;
+
+  for (;;) {
+    // Candidate neighbours (skip duplicates of the current edges)
+    uint8_t l = lo, h = hi;
+    while (l > 0 && addrs[l - 1] == addrs[lo]) l--;
+    while (h + 1 < n && addrs[h + 1] == addrs[hi]) h++;
+    lo = l;
+    hi = h;
+
+    uint32_t gap_lo = (lo > 0) ? (uint32_t)(addrs[lo] - addrs[lo - 1] - 1) : UINT32_MAX;
+    uint32_t gap_hi = (hi + 1 < n) ? (uint32_t)(addrs[hi + 1] - addrs[hi] - 1) : UINT32_MAX;
+    bool ok_lo = gap_lo <= max_gap && (uint32_t)(addrs[hi] - addrs[lo - 1]) + 1 <= max_span;
+    bool ok_hi = gap_hi <= max_gap && (uint32_t)(addrs[hi + 1] - addrs[lo]) + 1 <= max_span;
+
+    // Grow toward the closer neighbour first
+    if (ok_lo && (!ok_hi || gap_lo <= gap_hi)) lo--;
+    else if (ok_hi) hi++;
+    else break;
+  }
+
+  *start = addrs[lo];
+  return (uint16_t)(addrs[hi] - addrs[lo] + 1);
+}
+
+uint32_t mb_coalesce_frame_us(uint8_t bus, uint16_t resp_bytes) {
+  uint32_t baud = modbus_master_bus_baudrate(bus);
+  if (baud == 0) baud = 9600;
+  uint32_t char_us = 11000000UL / baud;  // 11 bits/char worst case
+  uint16_t gap_ms = modbus_master_bus_inter_frame(bus);
+  return (8 + resp_bytes) * char_us + gap_ms * 1000UL;
+}
+
+// Move queued reads that fit a block around *seed into blk. Returns false if
+// there is nothing to merge (the seed is then executed as a single read).
+// Worker only: scans the published part of the read rings and marks merged
+// slots as taken; mb_pq_ring_pop() releases them later.
+static bool mb_coalesce_take(mb_async_state_t *b, const mb_async_request_t *seed, mb_coalesce_block_t *blk) {
+  if (!g_modbus_master_config.coalesce_enabled) return false;
+  if (seed->type < MB_REQ_READ_COIL || seed->type > MB_REQ_READ_INPUT_REG) return false;
+
+  uint16_t addrs[MB_COALESCE_MAX_MEMBERS];
+  uint8_t n = 0;
+  addrs[n++] = seed->address;
+  for (uint8_t c = MB_PRIO_READ_FRESH; c < MB_PRIO_COUNT; c++) {
+    mb_pq_ring_t *r = &b->pq_ring[c];
+    for (uint32_t pos = r->tail; n < MB_COALESCE_MAX_MEMBERS; pos++) {
+      uint32_t idx = pos & MB_PQ_MASK;
+      if (__atomic_load_n(&r->seq[idx], __ATOMIC_ACQUIRE) != pos + 1) break;
+      const mb_async_request_t *q = &r->slot[idx];
+      if (!r->taken[idx] && q->type == seed->type && q->slave_id == seed->slave_id) addrs[n++] = q->address;
+    }
+  }
+  if (n == 1) return false;
+
+  bool bits = mb_coalesce_is_bit_type(seed->type);
+  uint16_t gap = g_modbus_master_config.coalesce_gap;
+  if (gap > MB_COALESCE_MAX_GAP) gap = MB_COALESCE_MAX_GAP;
+  mb_coalesce_sort(addrs, n);
+  uint16_t start = seed->address;
+  uint16_t count = mb_coalesce_select(addrs, n, seed->address,
+                                      bits ? MODBUS_MASTER_MAX_READ_BITS : MODBUS_MASTER_MAX_READ_REGS,
+                                      bits ? gap * 16 : gap, &start);
+
+  blk->req_type = seed->type;
+  blk->slave_id = seed->slave_id;
+  blk->start = start;
+  blk->count = count;
+  blk->member_count = 0;
+  blk->queued_us = seed->queued_us;
+  blk->members[blk->member_count++] = seed->address;
+
+  // Take the merged requests out of the rings (same published range as above)
+  for (uint8_t c = MB_PRIO_READ_FRESH; c < MB_PRIO_COUNT; c++) {
+    mb_pq_ring_t *r = &b->pq_ring[c];
+    for (uint32_t pos = r->tail; blk->member_count < MB_COALESCE_MAX_MEMBERS; pos++) {
+      uint32_t idx = pos & MB_PQ_MASK;
+      if (__atomic_load_n(&r->seq[idx], __ATOMIC_ACQUIRE) != pos + 1) break;
+      const mb_async_request_t *q = &r->slot[idx];
+      if (r->taken[idx] || q->type != seed->type || q->slave_id != seed->slave_id) continue;
+      if (q->address < start || (uint32_t)q->address >= (uint32_t)start + count) continue;
+      blk->members[blk->member_count++] = q->address;
+      mb_pq_ring_take(b, r, pos);
+    }
+  }
+  // The semaphore still counts the taken items — the task just finds an empty queue
+
+  mb_coalesce_sort(blk->members, blk->member_count);
+  return blk->member_count > 1;
+}
+
+static mb_error_code_t mb_coalesce_read_single(uint8_t type, uint8_t slave_id, uint16_t address, st_value_t *out) {
+  mb_error_code_t err = MB_OK;
+  out->int_val = 0;
+  if (type == MB_REQ_READ_COIL || type == MB_REQ_READ_INPUT) {
+    bool b = false;
+    err = (type == MB_REQ_READ_COIL) ? modbus_master_read_coil(slave_id, address, &b)
+                                     : modbus_master_read_input(slave_id, address, &b);
+    out->bool_val = b;
+  } else {
+    uint16_t v = 0;
+    err = (type == MB_REQ_READ_HOLDING) ? modbus_master_read_holding(slave_id, address, &v)
+                                        : modbus_master_read_input_register(slave_id, address, &v);
+    out->int_val = (int32_t)v;
+  }
+  return err;
+}
+
+static mb_error_code_t mb_coalesce_exec(mb_async_state_t *b, const mb_coalesce_block_t *blk) {
+  bool bits = mb_coalesce_is_bit_type(blk->req_type);
+  uint8_t fc = blk->req_type;  // MB_REQ_READ_COIL..READ_INPUT_REG == FC01..FC04
+  mb_error_code_t err = bits
+    ? modbus_master_read_bits(blk->slave_id, fc, blk->start, blk->count, g_mb_coalesce_bits[b->bus])
+    : modbus_master_read_registers(blk->slave_id, fc, blk->start, blk->count, g_mb_coalesce_regs[b->bus]);
+  mb_profile_record_latency(blk->slave_id, fc, micros() - blk->queued_us);
+
+  uint16_t eff_delay = modbus_master_bus_inter_frame(b->bus);
+  if (eff_delay > 0) vTaskDelay(pdMS_TO_TICKS(eff_delay));
+
+  b->total_requests += blk->member_count - 1;  // Seed already counted
+
+  if (err == MB_EXCEPTION) {
+    // Slave rejected the block — fall back to one transaction per member
+    b->coalesce_fallbacks++;
+    for (uint8_t i = 0; i < blk->member_count; i++) {
+      if (i > 0 && blk->members[i] == blk->members[i - 1]) continue;
+      st_value_t v;
+      mb_error_code_t e = mb_coalesce_read_single(blk->req_type, blk->slave_id, blk->members[i], &v);
+      mb_cache_update(blk->slave_id, blk->members[i], blk->req_type, true, e, v, fc);
+      if (e != MB_OK) {
+        b->total_errors++;
+        if (e == MB_TIMEOUT) b->total_timeouts++;
+      }
+      if (eff_delay > 0) vTaskDelay(pdMS_TO_TICKS(eff_delay));
+    }
+    return err;
+  }
+
+  // Scatter into every cached address of the block (members are always cached)
+  uint8_t m = 0;
+  for (uint16_t i = 0; i < blk->count; i++) {
+    uint16_t addr = blk->start + i;
+    bool member = false;
+    while (m < blk->member_count && blk->members[m] <= addr) {
+      if (blk->members[m] == addr) member = true;
+      m++;
+    }
+    st_value_t v;
+    v.int_val = 0;
+    if (bits) v.bool_val = (g_mb_coalesce_bits[b->bus][i >> 3] >> (i & 7)) & 0x01;
+    else v.int_val = (int32_t)g_mb_coalesce_regs[b->bus][i];
+    mb_cache_update(blk->slave_id, addr, blk->req_type, member, err, v, fc);
+  }
+
+  if (err == MB_TIMEOUT) {
+    mb_backoff_on_timeout(b, blk->slave_id);
+  } else if (err == MB_OK) {
+    mb_backoff_on_success(b, blk->slave_id);
+  }
+  if (err != MB_OK) {
+    b->total_errors++;
+    if (err == MB_TIMEOUT) b->total_timeouts++;
+    return err;
+  }
+
+  // Bus time: N single transactions vs. one block (slave turnaround not included)
+  uint16_t single_resp = bits ? 6 : 7;
+  uint16_t block_resp = bits ? (uint16_t)(5 + (blk->count + 7) / 8) : (uint16_t)(5 + blk->count * 2);
+  uint32_t singles_us = blk->member_count * mb_coalesce_frame_us(b->bus, single_resp);
+  uint32_t block_us = mb_coalesce_frame_us(b->bus, block_resp);
+  b->coalesced_blocks++;
+  b->coalesced_reads += blk->member_count;
+  if (singles_us > block_us) b->coalesce_saved_us += singles_us - block_us;
+  return err;
+}
+
+/* ============================================================================
+ * WRITE COMBINING (v7.9.8.19)
+ *
+ * Single writes (FC05/FC06) park their value in the bus's pending-write table
+ * and queue a request that only carries the key. Until the worker takes the
+ * entry, further writes to the same address just replace the value, so an ST
+ * program writing every scan costs one transaction per bus turn, not one per
+ * scan. When the worker takes an entry it also takes every pending write of
+ * the same slave and type that extends it to a contiguous run, and sends the
+ * run as one FC15/FC16 block. Requests whose entry went out with such a block
+ * are dropped when dequeued. Writes never bridge gaps — that would overwrite
+ * registers nobody asked to write.
+ * ============================================================================ */
+
+// Worker only: take the pending write of *seed (plus its contiguous neighbours)
+// into blk. Returns false if the entry is gone — a block write already sent it.
+static bool mb_write_take(mb_async_state_t *b, const mb_async_request_t *seed, mb_write_block_t *blk) {
+  uint16_t addrs[MB_WRITE_PENDING_MAX];
+  uint8_t n = 0;
+  bool found = false;
+
+  portENTER_CRITICAL(&mb_cache_spinlock);
+  for (uint8_t i = 0; i < MB_WRITE_PENDING_MAX; i++) {
+    const mb_write_pending_t *p = &b->write_pending[i];
+    if (p->slave_id != seed->slave_id || p->req_type != (uint8_t)seed->type) continue;
+    addrs[n++] = p->address;
+    if (p->address == seed->address) found = true;
+  }
+  if (!found) {
+    portEXIT_CRITICAL(&mb_cache_spinlock);
+    return false;
+  }
+
+  uint16_t start = seed->address;
+  uint16_t count = 1;
+  if (n > 1 && g_modbus_master_config.write_combine) {
+    mb_coalesce_sort(addrs, n);
+    count = mb_coalesce_select(addrs, n, seed->address, MB_WRITE_PENDING_MAX, 0, &start);
+  }
+
+  blk->req_type = (uint8_t)seed->type;
+  blk->slave_id = seed->slave_id;
+  blk->start = start;
+  blk->count = count;
+  blk->queued_us = seed->queued_us;
+  for (uint8_t i = 0; i < MB_WRITE_PENDING_MAX; i++) {
+    mb_write_pending_t *p = &b->write_pending[i];
+    if (p->slave_id != seed->slave_id || p->req_type != (uint8_t)seed->type) continue;
+    if (p->address < start || (uint32_t)p->address >= (uint32_t)start + count) continue;
+    blk->values[p->address - start] = (seed->type == MB_REQ_WRITE_COIL) ? (p->value.bool_val ? 1 : 0)
+                                                                        : (uint16_t)p->value.int_val;
+    p->slave_id = 0;
+  }
+  portEXIT_CRITICAL(&mb_cache_spinlock);
+  return true;
+}
+
+// Written values into the read cache (entries are created so the UI can show them)
+static void mb_write_block_cache(const mb_write_block_t *blk, uint16_t first, uint16_t n,
+                                 mb_error_code_t err, uint8_t last_fc) {
+  bool coils = blk->req_type == MB_REQ_WRITE_COIL;
+  uint8_t cache_type = coils ? (uint8_t)MB_REQ_READ_COIL : (uint8_t)MB_REQ_READ_HOLDING;
+  for (uint16_t i = first; i < first + n; i++) {
+    st_value_t v;
+    v.int_val = 0;
+    if (coils) v.bool_val = blk->values[i] != 0;
+    else v.int_val = (int32_t)blk->values[i];
+    mb_cache_update(blk->slave_id, blk->start + i, cache_type, true, err, v, last_fc);
+  }
+}
+
+static mb_error_code_t mb_write_exec(mb_async_state_t *b, const mb_write_block_t *blk) {
+  bool coils = blk->req_type == MB_REQ_WRITE_COIL;
+  uint8_t fc = coils ? 0x0F : 0x10;
+  mb_error_code_t err;
+  if (coils) {
+    uint8_t bits[(MB_WRITE_PENDING_MAX + 7) / 8] = {0};
+    for (uint16_t i = 0; i < blk->count; i++) {
+      if (blk->values[i]) bits[i >> 3] |= (uint8_t)(1 << (i & 7));
+    }
+    err = modbus_master_write_coils(blk->slave_id, blk->start, blk->count, bits);
+  } else {
+    err = modbus_master_write_holdings(blk->slave_id, blk->start, (uint8_t)blk->count, blk->values);
+  }
+  mb_profile_record_latency(blk->slave_id, fc, micros() - blk->queued_us);
+
+  uint16_t eff_delay = modbus_master_bus_inter_frame(b->bus);
+  if (eff_delay > 0) vTaskDelay(pdMS_TO_TICKS(eff_delay));
+
+  b->total_requests += blk->count - 1;  // Seed already counted
+
+  if (err == MB_EXCEPTION) {
+    // Slave rejected the block (no FC15/FC16, or one address is read-only) — write one by one
+    b->write_fallbacks++;
+    for (uint16_t i = 0; i < blk->count; i++) {
+      uint16_t addr = blk->start + i;
+      mb_error_code_t e = coils ? modbus_master_write_coil(blk->slave_id, addr, blk->values[i] != 0)
+                                : modbus_master_write_holding(blk->slave_id, addr, blk->values[i]);
+      mb_write_block_cache(blk, i, 1, e, blk->req_type);
+      if (e != MB_OK) {
+        b->total_errors++;
+        if (e == MB_TIMEOUT) b->total_timeouts++;
+      }
+      if (eff_delay > 0) vTaskDelay(pdMS_TO_TICKS(eff_delay));
+    }
+    return err;
+  }
+
+  // last_fc holds the request type, like the FC16 path (no type exists for FC15)
+  mb_write_block_cache(blk, 0, blk->count, err, coils ? (uint8_t)MB_REQ_WRITE_COIL : (uint8_t)MB_REQ_WRITE_HOLDINGS);
+
+  if (err == MB_TIMEOUT) {
+    mb_backoff_on_timeout(b, blk->slave_id);
+  } else if (err == MB_OK) {
+    mb_backoff_on_success(b, blk->slave_id);
+  }
+  if (err != MB_OK) {
+    b->total_errors++;
+    if (err == MB_TIMEOUT) b->total_timeouts++;
+    return err;
+  }
+  b->write_blocks++;
+  b->write_block_members += blk->count;
+  return err;
+}
+
+/* ============================================================================
+ * POLL GROUPS (v7.9.8.12)
+ *
+ * Declarative cyclic reads: each group (slave, FC, start, count) is read as
+ * one block every period_ms and scattered straight into the cache. ST reads
+ * of a polled address are cache hits that queue nothing, so bus load no
+ * longer follows the ST scan rate or max_requests_per_cycle.
+ *
+ * Scheduling: deadlines advance on a fixed grid (next_due += period). When
+ * several groups are due, the highest priority runs first, then the earliest
+ * deadline. A group more than one period behind drops the missed periods.
+ * The task runs at most one group between two queued requests, so writes
+ * and ad-hoc reads wait for one block read at most.
+ * ============================================================================ */
+
+bool mb_poll_group_valid(const ModbusPollGroup *group) {
+  if (group->slave_id < 1 || group->slave_id > 247) return false;
+  if (group->fc < MB_REQ_READ_COIL || group->fc > MB_REQ_READ_INPUT_REG) return false;
+  if (group->count < 1 || group->count > MB_POLL_MAX_COUNT) return false;
+  if ((uint32_t)group->start + group->count > 65536UL) return false;
+  return group->period_ms >= MB_POLL_MIN_PERIOD_MS && group->period_ms <= MB_POLL_MAX_PERIOD_MS;
+}
+
+void mb_async_poll_load(const ModbusPollGroup *groups) {
+  uint32_t now = millis();
+  portENTER_CRITICAL(&mb_cache_spinlock);
+  for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+    // Every bus keeps all slots; a group is only enabled on its slave's bus
+    for (uint8_t i = 0; i < MB_POLL_GROUPS_MAX; i++) {
+      mb_poll_state_t *g = &g_mb_async[bus].poll[i];
+      const ModbusPollGroup *c = &groups[i];
+      bool same = g->cfg.slave_id == c->slave_id && g->cfg.fc == c->fc && g->cfg.start == c->start &&
+                  g->cfg.count == c->count && g->cfg.period_ms == c->period_ms;
+      bool here = g_mb_route[c->slave_id] == bus;
+      if (!same) {
+        memset(g, 0, sizeof(*g));
+        g->next_due_ms = now;
+      } else if (c->enabled && here && !g->cfg.enabled) {
+        g->next_due_ms = now;  // Re-enabled: due now, keep statistics
+      }
+      g->cfg = *c;
+      if (!here || !mb_poll_group_valid(&g->cfg)) g->cfg.enabled = 0;
+    }
+  }
+  portEXIT_CRITICAL(&mb_cache_spinlock);
+}
+
+const mb_poll_state_t *mb_async_poll_state(uint8_t idx) {
+  if (idx >= MB_POLL_GROUPS_MAX) return NULL;
+  return &g_mb_async[g_mb_route[g_mb_async[0].poll[idx].cfg.slave_id]].poll[idx];
+}
+
+bool mb_async_poll_covers(uint8_t slave_id, uint8_t req_type, uint16_t address) {
+  bool covered = false;
+  const mb_async_state_t *b = mb_bus_state(slave_id);
+  portENTER_CRITICAL(&mb_cache_spinlock);
+  for (uint8_t i = 0; i < MB_POLL_GROUPS_MAX; i++) {
+    const ModbusPollGroup *c = &b->poll[i].cfg;
+    if (c->enabled && c->slave_id == slave_id && c->fc == req_type &&
+        address >= c->start && (uint32_t)address < (uint32_t)c->start + c->count) {
+      covered = true;
+      break;
+    }
+  }
+  portEXIT_CRITICAL(&mb_cache_spinlock);
+  return covered;
+}
+
+int8_t mb_poll_pick(const mb_poll_state_t *groups, uint8_t n, uint32_t now_ms, uint32_t *wait_ms) {
+  int8_t best = -1;
+  for (uint8_t i = 0; i < n; i++) {
+    const mb_poll_state_t *g = &groups[i];
+    if (!g->cfg.enabled) continue;
+    int32_t until = (int32_t)(g->next_due_ms - now_ms);
+    if (until > 0) {
+      if ((uint32_t)until < *wait_ms) *wait_ms = (uint32_t)until;
+      continue;
+    }
+    if (best < 0) {
+      best = (int8_t)i;
+      continue;
+    }
+    const mb_poll_state_t *b = &groups[best];
+    if (g->cfg.priority > b->cfg.priority ||
+        (g->cfg.priority == b->cfg.priority && (int32_t)(g->next_due_ms - b->next_due_ms) < 0)) {
+      best = (int8_t)i;
+    }
+  }
+  return best;
+}
+
+void mb_poll_advance(mb_poll_state_t *g, uint32_t now_ms) {
+  uint32_t period = g->cfg.period_ms;
+  if (period < MB_POLL_MIN_PERIOD_MS) period = MB_POLL_MIN_PERIOD_MS;
+  g->next_due_ms += period;
+  if ((int32_t)(g->next_due_ms - now_ms) <= 0) {
+    // More than one period behind — skip ahead instead of bursting to catch up
+    uint32_t skip = (now_ms - g->next_due_ms) / period + 1;
+    g->missed += skip;
+    g->next_due_ms += skip * period;
+  }
+}
+
+float mb_poll_rate_hz(const mb_poll_state_t *g) {
+  return (g->interval_avg_ms > 0.0f) ? 1000.0f / g->interval_avg_ms : 0.0f;
+}
+
+static void mb_poll_run(mb_async_state_t *b, uint8_t idx) {
+  mb_poll_state_t *g = &b->poll[idx];
+  uint32_t now = millis();
+
+  portENTER_CRITICAL(&mb_cache_spinlock);
+  ModbusPollGroup pg = g->cfg;
+  portEXIT_CRITICAL(&mb_cache_spinlock);
+
+  if (mb_backoff_cooling(b, pg.slave_id)) {
+    portENTER_CRITICAL(&mb_cache_spinlock);
+    g->missed++;
+    mb_poll_advance(g, now);
+    portEXIT_CRITICAL(&mb_cache_spinlock);
+    return;
+  }
+
+  portENTER_CRITICAL(&mb_cache_spinlock);
+  uint32_t late = now - g->next_due_ms;
+  g->late_last_ms = late;
+  if (late > g->late_max_ms) g->late_max_ms = late;
+  g->late_sum_ms += late;
+  if (g->last_poll_ms != 0) {
+    float interval = (float)(now - g->last_poll_ms);
+    g->interval_avg_ms = (g->interval_avg_ms > 0.0f)
+      ? g->interval_avg_ms + (interval - g->interval_avg_ms) / 8.0f
+      : interval;
+  }
+  g->last_poll_ms = now ? now : 1;
+  g->polls++;
+  mb_poll_advance(g, now);
+  portEXIT_CRITICAL(&mb_cache_spinlock);
+
+  // Block read into the coalescing buffers (same task, never used concurrently)
+  bool bits = mb_coalesce_is_bit_type(pg.fc);
+  mb_error_code_t err = bits
+    ? modbus_master_read_bits(pg.slave_id, pg.fc, pg.start, pg.count, g_mb_coalesce_bits[b->bus])
+    : modbus_master_read_registers(pg.slave_id, pg.fc, pg.start, pg.count, g_mb_coalesce_regs[b->bus]);
+  b->total_requests++;
+
+  uint16_t eff_delay = modbus_master_bus_inter_frame(b->bus);
+  if (eff_delay > 0) vTaskDelay(pdMS_TO_TICKS(eff_delay));
+
+  for (uint16_t i = 0; i < pg.count; i++) {
+    st_value_t v;
+    v.int_val = 0;
+    if (bits) v.bool_val = (g_mb_coalesce_bits[b->bus][i >> 3] >> (i & 7)) & 0x01;
+    else v.int_val = (int32_t)g_mb_coalesce_regs[b->bus][i];
+    mb_cache_update(pg.slave_id, pg.start + i, pg.fc, true, err, v, pg.fc);
+  }
+
+  if (err == MB_TIMEOUT) {
+    mb_backoff_on_timeout(b, pg.slave_id);
+  } else if (err == MB_OK) {
+    mb_backoff_on_success(b, pg.slave_id);
+  }
+  if (err != MB_OK) {
+    g->errors++;
+    b->total_errors++;
+    if (err == MB_TIMEOUT) b->total_timeouts++;
+  }
+}
+
 /* ============================================================================
  * BACKGROUND TASK
  * ============================================================================ */
 
 static void mb_async_task_func(void *pvParameters) {
+  mb_async_state_t *b = (mb_async_state_t *)pvParameters;
   mb_async_request_t req;
 
-  while (g_mb_async.task_running) {
-    // Block max 100ms waiting for semaphore signal (allows clean shutdown)
-    if (xSemaphoreTake(g_mb_async.pq_semaphore, pdMS_TO_TICKS(100)) != pdTRUE) {
+  bool poll_yield = false;
+
+  while (b->task_running) {
+    // Core 0 load for the master metrics (v7.9.8.13, rate-limited to 1 Hz)
+    if (b->bus == 0) modbus_master_sample_core_load();
+
+    // Poll groups (v7.9.8.12): run one due group, then let a queued request through
+    uint32_t wait_ms = 100;
+    if (!poll_yield || b->pq_count == 0) {
+      portENTER_CRITICAL(&mb_cache_spinlock);
+      int8_t due = mb_poll_pick(b->poll, MB_POLL_GROUPS_MAX, millis(), &wait_ms);
+      portEXIT_CRITICAL(&mb_cache_spinlock);
+      if (due >= 0) {
+        mb_poll_run(b, (uint8_t)due);
+        poll_yield = true;
+        continue;
+      }
+    }
+    poll_yield = false;
+
+    // Block until a request arrives or the next poll group is due
+    // (max 100ms, allows clean shutdown)
+    TickType_t ticks = pdMS_TO_TICKS(wait_ms);
+    if (ticks == 0) ticks = 1;
+    // A timeout still checks the rings: a slot published late (producer
+    // preempted mid-insert) has no semaphore count of its own
+    if (xSemaphoreTake(b->pq_semaphore, ticks) != pdTRUE && b->pq_count == 0) {
       continue;
     }
-    if (!mb_pq_dequeue(&req)) {
+    if (!mb_pq_dequeue(b, &req)) {
       continue;
     }
 
-    g_mb_async.total_requests++;
+    // Combined write (v7.9.8.19): take the latest value, plus contiguous neighbours
+    static mb_write_block_t wblk[MB_BUS_MAX];
+    if (req.combined && !mb_write_take(b, &req, &wblk[b->bus])) {
+      continue;  // Already sent with a block write
+    }
+
+    b->total_requests++;
 
     // Per-slave backoff: SKIP request if slave is in backoff cooldown
     // Instead of blocking the entire queue with vTaskDelay, we check elapsed
     // time since last attempt and skip if not enough time has passed.
+    if (mb_backoff_cooling(b, req.slave_id)) {
+      // Not enough time passed — skip this request, update cache to ERROR
+      if (req.combined) {
+        mb_write_block_cache(&wblk[b->bus], 0, wblk[b->bus].count, MB_TIMEOUT, (uint8_t)req.type);
+        b->total_errors++;
+        b->total_timeouts++;
+        continue;
+      }
+      uint8_t cache_type = (uint8_t)req.type;
+      if (req.type == MB_REQ_WRITE_COIL) cache_type = (uint8_t)MB_REQ_READ_COIL;
+      if (req.type == MB_REQ_WRITE_HOLDING) cache_type = (uint8_t)MB_REQ_READ_HOLDING;
+      portENTER_CRITICAL(&mb_cache_spinlock);
+      mb_cache_entry_t *entry = mb_cache_find_locked(req.slave_id, req.address, cache_type);
+      if (entry) {
+        entry->status = MB_CACHE_ERROR;
+        entry->last_error = MB_TIMEOUT;
+      }
+      portEXIT_CRITICAL(&mb_cache_spinlock);
+      if (req.type == MB_REQ_WRITE_HOLDINGS) mb_payload_release(req.payload);
+      b->total_errors++;
+      b->total_timeouts++;
+      continue;  // Skip to next request — no bus delay
+    }
+
+    // Read coalescing: merge queued reads for the same slave/FC into one block read
     {
-      uint8_t bo_idx = 255;
-      for (uint8_t i = 0; i < MB_SLAVE_BACKOFF_MAX; i++) {
-        if (g_mb_async.slave_backoff[i].slave_id == req.slave_id) {
-          bo_idx = i;
-          break;
-        }
+      static mb_coalesce_block_t blk[MB_BUS_MAX];
+      if (mb_coalesce_take(b, &req, &blk[b->bus])) {
+        mb_coalesce_exec(b, &blk[b->bus]);
+        continue;
       }
-      if (bo_idx < MB_SLAVE_BACKOFF_MAX && g_mb_async.slave_backoff[bo_idx].backoff_ms > 0) {
-        uint32_t elapsed = millis() - g_mb_async.slave_backoff[bo_idx].last_attempt_ms;
-        if (elapsed < g_mb_async.slave_backoff[bo_idx].backoff_ms) {
-          // Not enough time passed — skip this request, update cache to ERROR
-          uint8_t cache_type = (uint8_t)req.type;
-          if (req.type == MB_REQ_WRITE_COIL) cache_type = (uint8_t)MB_REQ_READ_COIL;
-          if (req.type == MB_REQ_WRITE_HOLDING) cache_type = (uint8_t)MB_REQ_READ_HOLDING;
-          mb_cache_entry_t *entry = mb_cache_find(req.slave_id, req.address, cache_type);
-          if (entry) {
-            portENTER_CRITICAL(&mb_cache_spinlock);
-            entry->status = MB_CACHE_ERROR;
-            entry->last_error = MB_TIMEOUT;
-            portEXIT_CRITICAL(&mb_cache_spinlock);
-          }
-          g_mb_async.total_errors++;
-          g_mb_async.total_timeouts++;
-          continue;  // Skip to next request — no bus delay
-        }
-        g_mb_async.slave_backoff[bo_idx].last_attempt_ms = millis();
+    }
+
+    // Combined writes: block of neighbours as FC15/FC16, otherwise the latest value
+    if (req.combined) {
+      const mb_write_block_t *wb = &wblk[b->bus];
+      if (wb->count > 1) {
+        mb_write_exec(b, wb);
+        continue;
       }
+      req.write_value.int_val = 0;
+      if (req.type == MB_REQ_WRITE_COIL) req.write_value.bool_val = wb->values[0] != 0;
+      else req.write_value.int_val = (int32_t)wb->values[0];
     }
 
     mb_error_code_t err = MB_OK;
@@ -477,40 +1609,30 @@ static void mb_async_task_func(void *pvParameters) {
       }
       case MB_REQ_WRITE_COIL: {
         err = modbus_master_write_coil(req.slave_id, req.address, req.write_value.bool_val);
-        result.bool_val = (err == MB_OK);
+        result.bool_val = req.write_value.bool_val;  // Confirmed value for the read cache (v7.9.8.19)
         break;
       }
       case MB_REQ_WRITE_HOLDING: {
         err = modbus_master_write_holding(req.slave_id, req.address, (uint16_t)req.write_value.int_val);
-        result.bool_val = (err == MB_OK);
+        result.int_val = (int32_t)(uint16_t)req.write_value.int_val;
         break;
       }
       case MB_REQ_READ_HOLDINGS: {
         // FC03 multi-register read — update individual cache entries
         uint8_t cnt = req.count;
-        if (cnt == 0 || cnt > 16) { err = MB_INVALID_ADDRESS; break; }
-        uint16_t regs[16];
+        if (cnt == 0 || cnt > MB_PAYLOAD_REGS) { err = MB_INVALID_ADDRESS; break; }
+        uint16_t regs[MB_PAYLOAD_REGS];
         err = modbus_master_read_holdings(req.slave_id, req.address, cnt, regs);
-        // Copy results to shared multi-reg buffer for MB_GET_REG()
+        // Publish the block for MB_READ_HOLDINGS (v7.9.8.16: was the shared g_mb_multi_reg_buf)
         if (err == MB_OK) {
-          memcpy(g_mb_multi_reg_buf, regs, cnt * sizeof(uint16_t));
+          mb_block_result_publish(req.slave_id, req.address, cnt, regs);
         }
         // Update each individual cache entry
         for (uint8_t i = 0; i < cnt; i++) {
-          mb_cache_entry_t *ce = mb_cache_get_or_create(req.slave_id, req.address + i, (uint8_t)MB_REQ_READ_HOLDING);
-          if (ce) {
-            portENTER_CRITICAL(&mb_cache_spinlock);
-            if (err == MB_OK) {
-              ce->value.int_val = (int32_t)regs[i];
-              ce->status = MB_CACHE_VALID;
-            } else {
-              ce->status = MB_CACHE_ERROR;
-            }
-            ce->last_error = err;
-            ce->last_update_ms = millis();
-            ce->last_fc = (uint8_t)MB_REQ_READ_HOLDINGS;
-            portEXIT_CRITICAL(&mb_cache_spinlock);
-          }
+          st_value_t v;
+          v.int_val = (int32_t)regs[i];
+          mb_cache_update(req.slave_id, req.address + i, (uint8_t)MB_REQ_READ_HOLDING, true, err, v,
+                          (uint8_t)MB_REQ_READ_HOLDINGS);
         }
         result.bool_val = (err == MB_OK);
         break;
@@ -518,38 +1640,27 @@ static void mb_async_task_func(void *pvParameters) {
       case MB_REQ_WRITE_HOLDINGS: {
         // FC16 multi-register write — read values from pool slot
         uint8_t cnt = req.count;
-        if (cnt == 0 || cnt > 16) { err = MB_INVALID_ADDRESS; break; }
-        uint16_t *write_vals = g_mb_multi_write_pool[req.multi_pool_slot];
+        const uint16_t *write_vals = mb_payload_data(req.payload);
+        if (cnt == 0 || cnt > MODBUS_MASTER_MAX_WRITE_REGS || !write_vals) { err = MB_INVALID_ADDRESS; break; }
         err = modbus_master_write_holdings(req.slave_id, req.address, cnt, write_vals);
         // Update cache entries with written values
         for (uint8_t i = 0; i < cnt; i++) {
-          mb_cache_entry_t *ce = mb_cache_get_or_create(req.slave_id, req.address + i, (uint8_t)MB_REQ_READ_HOLDING);
-          if (ce) {
-            portENTER_CRITICAL(&mb_cache_spinlock);
-            if (err == MB_OK) {
-              ce->value.int_val = (int32_t)write_vals[i];
-              ce->status = MB_CACHE_VALID;
-            } else {
-              ce->status = MB_CACHE_ERROR;
-            }
-            ce->last_error = err;
-            ce->last_update_ms = millis();
-            ce->last_fc = (uint8_t)MB_REQ_WRITE_HOLDINGS;
-            portEXIT_CRITICAL(&mb_cache_spinlock);
-          }
+          st_value_t v;
+          v.int_val = (int32_t)write_vals[i];
+          mb_cache_update(req.slave_id, req.address + i, (uint8_t)MB_REQ_READ_HOLDING, true, err, v,
+                          (uint8_t)MB_REQ_WRITE_HOLDINGS);
         }
         result.bool_val = (err == MB_OK);
         break;
       }
     }
+    if (req.type == MB_REQ_WRITE_HOLDINGS) mb_payload_release(req.payload);
+    mb_profile_record_latency(req.slave_id, mb_async_request_fc(req.type), micros() - req.queued_us);
 
     // Apply inter-frame delay (on background task — doesn't block ST Logic)
     // 0=auto: calculate t3.5 from baudrate per Modbus RTU spec
     {
-      extern uint16_t modbus_effective_inter_frame(uint16_t, uint32_t);
-      uint16_t eff_delay = modbus_effective_inter_frame(
-        g_modbus_master_config.inter_frame_delay,
-        g_modbus_master_config.baudrate);
+      uint16_t eff_delay = modbus_master_bus_inter_frame(b->bus);
       if (eff_delay > 0) {
         vTaskDelay(pdMS_TO_TICKS(eff_delay));
       }
@@ -567,41 +1678,30 @@ static void mb_async_task_func(void *pvParameters) {
       if (req.type == MB_REQ_WRITE_COIL) cache_type = (uint8_t)MB_REQ_READ_COIL;
       if (req.type == MB_REQ_WRITE_HOLDING) cache_type = (uint8_t)MB_REQ_READ_HOLDING;
 
-      mb_cache_entry_t *entry = mb_cache_find(req.slave_id, req.address, cache_type);
-      if (!entry && (req.type == MB_REQ_WRITE_COIL || req.type == MB_REQ_WRITE_HOLDING)) {
-        // Write to address we've never read — create entry so UI can show it
-        entry = mb_cache_get_or_create(req.slave_id, req.address, cache_type);
-      }
-      if (entry) {
-        portENTER_CRITICAL(&mb_cache_spinlock);
-        if (err == MB_OK) {
-          entry->value = result;
-          entry->status = MB_CACHE_VALID;
-        } else {
-          entry->status = MB_CACHE_ERROR;
-        }
-        entry->last_error = err;
-        entry->last_update_ms = millis();
-        entry->last_fc = (uint8_t)req.type;  // Track actual operation FC (FC01-FC06)
-        portEXIT_CRITICAL(&mb_cache_spinlock);
-      }
+      // Write to address we've never read — create entry so UI can show it
+      bool create = (req.type == MB_REQ_WRITE_COIL || req.type == MB_REQ_WRITE_HOLDING);
+      // last_fc tracks the actual operation FC (FC01-FC06)
+      mb_cache_update(req.slave_id, req.address, cache_type, create, err, result, (uint8_t)req.type);
     }
 
     skip_cache_update:
     // Adaptive backoff: increase delay on timeout, decrease on success
     if (err == MB_TIMEOUT) {
-      mb_backoff_on_timeout(req.slave_id);
+      mb_backoff_on_timeout(b, req.slave_id);
     } else if (err == MB_OK) {
-      mb_backoff_on_success(req.slave_id);
+      mb_backoff_on_success(b, req.slave_id);
     }
 
     // Stats
     if (err != MB_OK) {
-      g_mb_async.total_errors++;
-      if (err == MB_TIMEOUT) g_mb_async.total_timeouts++;
+      b->total_errors++;
+      if (err == MB_TIMEOUT) b->total_timeouts++;
     }
   }
 
+  // mb_async_bus_stop() waits for this before it deletes the semaphore,
+  // drains the rings or resets the state: nothing of b is touched after it
+  b->task_exited = true;
   vTaskDelete(NULL);
 }
 
@@ -609,91 +1709,214 @@ static void mb_async_task_func(void *pvParameters) {
  * INIT / DEINIT
  * ============================================================================ */
 
-void mb_async_init() {
-  memset(&g_mb_async, 0, sizeof(g_mb_async));
-  g_mb_async.stats_since_ms = millis();
+// Reset one bus state, keeping an already allocated cache shard
+static void mb_async_bus_reset(mb_async_state_t *b, uint8_t bus) {
+  mb_cache_entry_t *entries = b->entries;
+  uint16_t *index = b->cache_index;
+  uint16_t capacity = b->cache_capacity;
+  uint16_t mask = b->index_mask;
+  bool in_psram = b->cache_in_psram;
+
+  memset(b, 0, sizeof(*b));
+  b->bus = bus;
+  b->stats_since_ms = millis();
+  for (uint8_t c = 0; c < MB_PRIO_COUNT; c++) mb_pq_ring_init(&b->pq_ring[c]);
+
+  b->entries = entries;
+  b->cache_index = index;
+  b->cache_capacity = capacity;
+  b->index_mask = mask;
+  b->cache_in_psram = in_psram;
+}
+
+static void mb_cache_clear_bus(mb_async_state_t *b) {
+  portENTER_CRITICAL(&mb_cache_spinlock);
+  b->entry_count = 0;
+  b->lru_head = MB_CACHE_NIL;
+  b->lru_tail = MB_CACHE_NIL;
+  if (b->entries) {
+    memset(b->entries, 0, b->cache_capacity * sizeof(mb_cache_entry_t));
+    memset(b->cache_index, 0xFF, (b->index_mask + 1u) * sizeof(uint16_t));
+  }
+  portEXIT_CRITICAL(&mb_cache_spinlock);
+}
 
-  g_mb_async.pq_mutex = xSemaphoreCreateMutex();
-  g_mb_async.pq_semaphore = xSemaphoreCreateCounting(MB_ASYNC_QUEUE_SIZE, 0);
-  if (!g_mb_async.pq_mutex || !g_mb_async.pq_semaphore) {
+static bool mb_async_bus_start(uint8_t bus) {
+  mb_async_state_t *b = &g_mb_async[bus];
+  mb_async_bus_reset(b, bus);
+  if (b->cache_capacity != g_modbus_master_config.cache_max_entries) {
+    mb_cache_resize_bus(b, g_modbus_master_config.cache_max_entries);
+  } else {
+    mb_cache_clear_bus(b);
+  }
+
+  b->pq_semaphore = xSemaphoreCreateCounting(MB_PRIO_COUNT * MB_ASYNC_QUEUE_SIZE, 0);
+  if (!b->pq_semaphore) {
     Serial.println("[MB_ASYNC] FEJL: Kunne ikke oprette queue sync primitives");
-    return;
+    return false;
   }
 
-  g_mb_async.task_running = true;
+  b->task_running = true;
 
+  char name[12];
+  snprintf(name, sizeof(name), bus == 0 ? "mb_async" : "mb_async%u", bus);
   BaseType_t ret = xTaskCreatePinnedToCore(
     mb_async_task_func,
-    "mb_async",
+    name,
     MB_ASYNC_TASK_STACK,
-    NULL,
+    b,
     MB_ASYNC_TASK_PRIO,
-    &g_mb_async.task_handle,
+    &b->task_handle,
     MB_ASYNC_TASK_CORE
   );
 
   if (ret != pdPASS) {
     Serial.println("[MB_ASYNC] FEJL: Kunne ikke starte background task");
-    g_mb_async.task_running = false;
-    return;
+    b->task_running = false;
+    return false;
   }
 
-  Serial.printf("[MB_ASYNC] Startet: Core %d, stack %d, prio-queue %d, cache max %d\n",
-                MB_ASYNC_TASK_CORE, MB_ASYNC_TASK_STACK,
-                MB_ASYNC_QUEUE_SIZE, MB_CACHE_MAX_ENTRIES);
+  Serial.printf("[MB_ASYNC] Bus %u startet: Core %d, stack %d, prio-rings %dx%d, cache %u (%s)\n",
+                bus, MB_ASYNC_TASK_CORE, MB_ASYNC_TASK_STACK,
+                MB_PRIO_COUNT, MB_ASYNC_QUEUE_SIZE, b->cache_capacity,
+                b->cache_in_psram ? "PSRAM" : "DRAM");
+  return true;
 }
 
-void mb_async_deinit() {
-  g_mb_async.task_running = false;
-  if (g_mb_async.task_handle) {
-    vTaskDelay(pdMS_TO_TICKS(200));  // Let task finish current operation
-    g_mb_async.task_handle = NULL;
+static void mb_async_bus_stop(uint8_t bus) {
+  mb_async_state_t *b = &g_mb_async[bus];
+  b->task_running = false;
+  if (b->task_handle) {
+    // Wait for the worker to leave its loop. A transaction (up to the 5 s bus
+    // timeout) or a coalesce/write fallback runs to its end first; a restart
+    // before that would put a second consumer on the rings.
+    vTaskResume(b->task_handle);  // mb_async_suspend(): it would never get there
+    if (b->pq_semaphore) xSemaphoreGive(b->pq_semaphore);
+    uint32_t t0 = millis();
+    bool logged = false;
+    while (!b->task_exited) {
+      vTaskDelay(pdMS_TO_TICKS(10));
+      if (!logged && millis() - t0 > 1000) {
+        Serial.printf("[MB_ASYNC] Bus %u: venter på at worker afslutter transaktion\n", bus);
+        logged = true;
+      }
+    }
+    b->task_handle = NULL;
   }
-  if (g_mb_async.pq_mutex) {
-    vSemaphoreDelete(g_mb_async.pq_mutex);
-    g_mb_async.pq_mutex = NULL;
+  if (b->pq_semaphore) {
+    vSemaphoreDelete(b->pq_semaphore);
+    b->pq_semaphore = NULL;
   }
-  if (g_mb_async.pq_semaphore) {
-    vSemaphoreDelete(g_mb_async.pq_semaphore);
-    g_mb_async.pq_semaphore = NULL;
+
+  // Task is gone: drain the rings so queued FC16 writes give back their payload slots
+  mb_async_request_t req;
+  for (uint8_t c = 0; c < MB_PRIO_COUNT; c++) {
+    while (mb_pq_pop_class(b, c, &req)) {
+      if (req.type == MB_REQ_WRITE_HOLDINGS) mb_payload_release(req.payload);
+    }
+  }
+}
+
+void mb_async_init() {
+  mb_async_route_load(g_persist_config.mb_bus_routes);
+  mb_async_bus_start(0);
+  for (uint8_t bus = 1; bus < MB_BUS_MAX; bus++) {
+    if (g_persist_config.mb_buses[bus - 1].enabled) mb_async_bus_apply(bus);
+  }
+  mb_async_poll_load(g_persist_config.mb_poll_groups);
+}
+
+bool mb_async_bus_apply(uint8_t bus) {
+  if (bus == 0 || bus >= MB_BUS_MAX) return false;
+
+  if (g_mb_async[bus].task_running) mb_async_bus_stop(bus);
+  modbus_master_bus_stop(bus);
+
+  // Extra buses follow the master: nothing to do while bus 0 is not running
+  if (!g_persist_config.mb_buses[bus - 1].enabled || !g_mb_async[0].task_running) return true;
+
+  if (!modbus_master_bus_start(bus)) return false;
+  if (!mb_async_bus_start(bus)) {
+    mb_async_bus_stop(bus);
+    modbus_master_bus_stop(bus);
+    return false;
+  }
+  mb_async_poll_load(g_persist_config.mb_poll_groups);
+  return true;
+}
+
+void mb_async_deinit() {
+  for (uint8_t bus = MB_BUS_MAX; bus-- > 0;) {
+    mb_async_bus_stop(bus);
+    if (bus > 0) modbus_master_bus_stop(bus);
   }
 }
 
 void mb_async_suspend() {
-  if (g_mb_async.task_handle) {
-    vTaskSuspend(g_mb_async.task_handle);
+  for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+    if (g_mb_async[bus].task_handle) {
+      vTaskSuspend(g_mb_async[bus].task_handle);
+    }
   }
 }
 
 void mb_async_resume() {
-  if (g_mb_async.task_handle) {
-    vTaskResume(g_mb_async.task_handle);
+  for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+    if (g_mb_async[bus].task_handle) {
+      vTaskResume(g_mb_async[bus].task_handle);
+    }
   }
 }
 
 const mb_async_state_t *mb_async_get_state() {
-  return &g_mb_async;
+  return &g_mb_async[0];
+}
+
+const mb_async_state_t *mb_async_get_bus_state(uint8_t bus) {
+  return (bus < MB_BUS_MAX) ? &g_mb_async[bus] : NULL;
 }
 
 void mb_async_reset_cache() {
-  portENTER_CRITICAL(&mb_cache_spinlock);
-  g_mb_async.entry_count = 0;
-  memset(g_mb_async.entries, 0, sizeof(g_mb_async.entries));
-  portEXIT_CRITICAL(&mb_cache_spinlock);
+  for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+    mb_cache_clear_bus(&g_mb_async[bus]);
+  }
+  mb_block_results_clear();
 }
 
 void mb_async_reset_stats() {
   portENTER_CRITICAL(&mb_cache_spinlock);
-  g_mb_async.cache_hits = 0;
-  g_mb_async.cache_misses = 0;
-  g_mb_async.queue_full_count = 0;
-  g_mb_async.priority_drops = 0;
-  g_mb_async.queue_high_watermark = 0;
-  g_mb_async.total_requests = 0;
-  g_mb_async.total_errors = 0;
-  g_mb_async.total_timeouts = 0;
-  g_mb_async.stats_since_ms = millis();
-  memset(g_mb_async.slave_backoff, 0, sizeof(g_mb_async.slave_backoff));
+  for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+    mb_async_state_t *b = &g_mb_async[bus];
+    b->cache_hits = 0;
+    b->cache_misses = 0;
+    b->cache_evictions = 0;
+    b->coalesced_blocks = 0;
+    b->coalesced_reads = 0;
+    b->coalesce_fallbacks = 0;
+    b->coalesce_saved_us = 0;
+    b->write_combined = 0;
+    b->write_skipped = 0;
+    b->write_blocks = 0;
+    b->write_block_members = 0;
+    b->write_fallbacks = 0;
+    b->queue_full_count = 0;
+    b->priority_drops = 0;
+    b->queue_high_watermark = 0;
+    b->queue_contention = 0;
+    b->queue_dedup = 0;
+    b->total_requests = 0;
+    b->total_errors = 0;
+    b->total_timeouts = 0;
+    b->stats_since_ms = millis();
+    memset(b->slave_backoff, 0, sizeof(b->slave_backoff));
+    for (uint8_t i = 0; i < MB_POLL_GROUPS_MAX; i++) {
+      mb_poll_state_t *g = &b->poll[i];
+      g->polls = g->errors = g->missed = 0;
+      g->late_last_ms = g->late_max_ms = g->late_sum_ms = 0;
+      g->interval_avg_ms = 0.0f;
+      g->last_poll_ms = 0;
+    }
+  }
   portEXIT_CRITICAL(&mb_cache_spinlock);
 
   // Also reset modbus_master_config stats
@@ -0,0 +1,181 @@
+/**
+ * @file mb_profile.cpp
+ * @brief Modbus master bus utilisation + transaction latency profiler (FEAT-162)
+ *
+ * Recording happens on the bus worker tasks (one per bus), so the shared
+ * per-slave / per-FC tables are updated under a spinlock. Readers (metrics,
+ * SSE, CLI) read without it — a torn counter only affects one sample.
+ */
+
+#include "mb_profile.h"
+#include <Arduino.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+
+/* ============================================================================
+ * STATE
+ * ============================================================================ */
+
+static mb_profile_bus_t g_mb_profile_bus[MB_BUS_MAX];
+static mb_profile_stats_t g_mb_profile_fc[MB_PROFILE_FCS];
+static mb_profile_slave_t g_mb_profile_slave[MB_PROFILE_SLAVES + 1];  // Last = other
+static portMUX_TYPE mb_profile_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+static const uint32_t mb_profile_bounds_tbl[MB_PROFILE_HIST_COUNT][MB_PROFILE_BUCKETS - 1] = {
+  MB_PROFILE_LATENCY_BOUNDS_US,
+  MB_PROFILE_TURNAROUND_BOUNDS_US,
+  MB_PROFILE_BYTES_BOUNDS
+};
+
+static const uint8_t mb_profile_fc_tbl[MB_PROFILE_FCS] = { 1, 2, 3, 4, 5, 6, 15, 16, 0 };
+
+/* ============================================================================
+ * HELPERS (caller holds mb_profile_spinlock)
+ * ============================================================================ */
+
+static uint8_t mb_profile_fc_index(uint8_t fc) {
+  fc &= 0x7F;  // Exception responses carry FC | 0x80
+  for (uint8_t i = 0; i < MB_PROFILE_FCS - 1; i++) {
+    if (mb_profile_fc_tbl[i] == fc) return i;
+  }
+  return MB_PROFILE_FCS - 1;
+}
+
+static mb_profile_slave_t *mb_profile_slave_entry(uint8_t slave_id) {
+  for (uint8_t i = 0; i < MB_PROFILE_SLAVES; i++) {
+    mb_profile_slave_t *s = &g_mb_profile_slave[i];
+    if (s->slave_id == slave_id) return s;
+    if (s->slave_id == 0) {
+      s->slave_id = slave_id;
+      return s;
+    }
+  }
+  return &g_mb_profile_slave[MB_PROFILE_SLAVES];
+}
+
+static void mb_profile_hist_add(mb_profile_hist_t *h, uint8_t kind, uint32_t value) {
+  const uint32_t *bounds = mb_profile_bounds_tbl[kind];
+  uint8_t b = 0;
+  while (b < MB_PROFILE_BUCKETS - 1 && value > bounds[b]) b++;
+  h->bucket[b]++;
+  h->count++;
+  h->sum += value;
+  if (value > h->max) h->max = value;
+}
+
+static void mb_profile_stats_add(mb_profile_stats_t *st, uint16_t bytes, uint32_t turnaround_us,
+                                 bool answered, bool ok) {
+  st->transactions++;
+  if (!ok) st->errors++;
+  mb_profile_hist_add(&st->hist[MB_PROFILE_WIRE_BYTES], MB_PROFILE_WIRE_BYTES, bytes);
+  if (answered) mb_profile_hist_add(&st->hist[MB_PROFILE_TURNAROUND], MB_PROFILE_TURNAROUND, turnaround_us);
+}
+
+/* ============================================================================
+ * RECORDING
+ * ============================================================================ */
+
+uint32_t mb_profile_wire_us(uint16_t chars, uint32_t baudrate) {
+  if (baudrate == 0) return 0;
+  return (uint32_t)(((uint64_t)chars * MB_PROFILE_BITS_PER_CHAR * 1000000ULL) / baudrate);
+}
+
+void mb_profile_record_transaction(uint8_t bus, uint8_t slave_id, uint8_t fc, uint32_t baudrate,
+                                   uint16_t tx_bytes, uint16_t rx_bytes,
+                                   uint32_t turnaround_us, uint32_t held_us, bool ok) {
+  if (bus >= MB_BUS_MAX) return;
+  uint16_t bytes = tx_bytes + rx_bytes;
+  uint32_t wire_us = mb_profile_wire_us(bytes, baudrate);
+  uint32_t sec = millis() / 1000;
+  bool answered = rx_bytes > 0;
+
+  portENTER_CRITICAL(&mb_profile_spinlock);
+  mb_profile_bus_t *b = &g_mb_profile_bus[bus];
+  uint8_t slot = sec % (MB_PROFILE_WINDOW_S + 1);
+  if (b->sec[slot] != sec) {
+    b->sec[slot] = sec;
+    b->wire_us[slot] = 0;
+    b->held_us[slot] = 0;
+  }
+  b->wire_us[slot] += wire_us;
+  b->held_us[slot] += held_us;
+  b->wire_us_total += wire_us;
+  b->held_us_total += held_us;
+  b->bytes_total += bytes;
+  b->transactions++;
+
+  mb_profile_stats_add(&g_mb_profile_fc[mb_profile_fc_index(fc)], bytes, turnaround_us, answered, ok);
+  mb_profile_slave_t *s = mb_profile_slave_entry(slave_id);
+  s->bus = bus;
+  mb_profile_stats_add(&s->stats, bytes, turnaround_us, answered, ok);
+  portEXIT_CRITICAL(&mb_profile_spinlock);
+}
+
+void mb_profile_record_latency(uint8_t slave_id, uint8_t fc, uint32_t latency_us) {
+  portENTER_CRITICAL(&mb_profile_spinlock);
+  mb_profile_hist_add(&g_mb_profile_fc[mb_profile_fc_index(fc)].hist[MB_PROFILE_LATENCY],
+                      MB_PROFILE_LATENCY, latency_us);
+  mb_profile_hist_add(&mb_profile_slave_entry(slave_id)->stats.hist[MB_PROFILE_LATENCY],
+                      MB_PROFILE_LATENCY, latency_us);
+  portEXIT_CRITICAL(&mb_profile_spinlock);
+}
+
+/* ============================================================================
+ * QUERIES
+ * ============================================================================ */
+
+// Sum of the last MB_PROFILE_WINDOW_S whole seconds (the current second is still filling)
+static float mb_profile_window_percent(uint8_t bus, bool held) {
+  if (bus >= MB_BUS_MAX) return 0.0f;
+  const mb_profile_bus_t *b = &g_mb_profile_bus[bus];
+  uint32_t now = millis() / 1000;
+  uint64_t sum = 0;
+
+  portENTER_CRITICAL(&mb_profile_spinlock);
+  for (uint8_t i = 0; i <= MB_PROFILE_WINDOW_S; i++) {
+    uint32_t age = now - b->sec[i];
+    if (age >= 1 && age <= MB_PROFILE_WINDOW_S) sum += held ? b->held_us[i] : b->wire_us[i];
+  }
+  portEXIT_CRITICAL(&mb_profile_spinlock);
+
+  uint32_t window_s = (now < MB_PROFILE_WINDOW_S) ? now : MB_PROFILE_WINDOW_S;
+  if (window_s == 0) return 0.0f;
+  float pct = (float)sum * 100.0f / ((float)window_s * 1000000.0f);
+  return (pct > 100.0f) ? 100.0f : pct;
+}
+
+float mb_profile_bus_utilisation(uint8_t bus) {
+  return mb_profile_window_percent(bus, false);
+}
+
+float mb_profile_bus_occupancy(uint8_t bus) {
+  return mb_profile_window_percent(bus, true);
+}
+
+const mb_profile_bus_t *mb_profile_get_bus(uint8_t bus) {
+  return (bus < MB_BUS_MAX) ? &g_mb_profile_bus[bus] : NULL;
+}
+
+const mb_profile_stats_t *mb_profile_get_fc(uint8_t index) {
+  return (index < MB_PROFILE_FCS) ? &g_mb_profile_fc[index] : NULL;
+}
+
+uint8_t mb_profile_fc_of_index(uint8_t index) {
+  return (index < MB_PROFILE_FCS) ? mb_profile_fc_tbl[index] : 0;
+}
+
+const mb_profile_slave_t *mb_profile_get_slave(uint8_t index) {
+  return (index <= MB_PROFILE_SLAVES) ? &g_mb_profile_slave[index] : NULL;
+}
+
+const uint32_t *mb_profile_bounds(uint8_t kind) {
+  return (kind < MB_PROFILE_HIST_COUNT) ? mb_profile_bounds_tbl[kind] : NULL;
+}
+
+void mb_profile_reset() {
+  portENTER_CRITICAL(&mb_profile_spinlock);
+  memset(g_mb_profile_bus, 0, sizeof(g_mb_profile_bus));
+  memset(g_mb_profile_fc, 0, sizeof(g_mb_profile_fc));
+  memset(g_mb_profile_slave, 0, sizeof(g_mb_profile_slave));
+  portEXIT_CRITICAL(&mb_profile_spinlock);
+}
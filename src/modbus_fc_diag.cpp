@@ -0,0 +1,171 @@
+/**
+ * @file modbus_fc_diag.cpp
+ * @brief Modbus diagnostics and device identification handlers implementation (LAYER 2)
+ *
+ * Implements FC08: Diagnostics and FC2B/0E (FC43/14): Read Device Identification
+ */
+
+#include "modbus_fc_diag.h"
+#include "modbus_parser.h"
+#include "modbus_serializer.h"
+#include "config_struct.h"
+#include "constants.h"
+#include "debug.h"
+#include <string.h>
+
+/* ============================================================================
+ * DIAGNOSTIC COUNTERS
+ * ============================================================================ */
+
+// Written by the RTU slave task only, read by CLI/FC08 (aligned 32-bit reads are atomic)
+static ModbusDiagCounters diag_counters = {0, 0, 0, 0, 0};
+
+ModbusDiagCounters* modbus_diag_counters(void) {
+  return &diag_counters;
+}
+
+void modbus_diag_clear(void) {
+  memset(&diag_counters, 0, sizeof(diag_counters));
+}
+
+/* ============================================================================
+ * FC08: DIAGNOSTICS
+ * ============================================================================ */
+
+bool modbus_fc08_diagnostics(const ModbusFrame* request_frame, ModbusFrame* response_frame) {
+  if (request_frame == NULL || response_frame == NULL) return false;
+
+  // Parse request
+  ModbusDiagnosticsRequest req;
+  if (!modbus_parse_diagnostics(request_frame, &req)) {
+    modbus_serialize_error_response(response_frame, request_frame->slave_id,
+                                     FC_DIAGNOSTICS, MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+    return false;
+  }
+
+  // Return Query Data: echo any payload unchanged (line test)
+  if (req.sub_function == DIAG_RETURN_QUERY_DATA) {
+    return modbus_serialize_diagnostics_response(response_frame, request_frame->slave_id,
+                                                  req.sub_function, req.data, req.data_length);
+  }
+
+  // Remaining sub-functions take exactly one data word that must be 0x0000
+  bool zero_data = (req.data_length == 2 && req.data[0] == 0 && req.data[1] == 0);
+  uint32_t count;
+
+  switch (req.sub_function) {
+    case DIAG_CLEAR_COUNTERS:
+      if (zero_data) modbus_diag_clear();
+      count = 0;
+      break;
+    case DIAG_BUS_MESSAGE_COUNT:        count = diag_counters.bus_messages;       break;
+    case DIAG_BUS_COMM_ERROR_COUNT:     count = diag_counters.bus_comm_errors;    break;
+    case DIAG_BUS_EXCEPTION_COUNT:      count = diag_counters.bus_exceptions;     break;
+    case DIAG_SERVER_MESSAGE_COUNT:     count = diag_counters.server_messages;    break;
+    case DIAG_SERVER_NO_RESPONSE_COUNT: count = diag_counters.server_no_response; break;
+    default:
+      // Listen-only, restart and the character counters are not implemented
+      modbus_serialize_error_response(response_frame, request_frame->slave_id,
+                                       FC_DIAGNOSTICS, MODBUS_EXCEPTION_ILLEGAL_FUNCTION);
+      return false;
+  }
+
+  if (!zero_data) {
+    modbus_serialize_error_response(response_frame, request_frame->slave_id,
+                                     FC_DIAGNOSTICS, MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+    return false;
+  }
+
+  // Clear echoes the request; counters are 16 bit on the wire (wrap like the spec)
+  uint8_t out[2];
+  out[0] = (uint8_t)((count >> 8) & 0xFF);
+  out[1] = (uint8_t)(count & 0xFF);
+  return modbus_serialize_diagnostics_response(response_frame, request_frame->slave_id,
+                                                req.sub_function, out, 2);
+}
+
+/* ============================================================================
+ * FC2B / MEI 0x0E: READ DEVICE IDENTIFICATION
+ * ============================================================================ */
+
+#define DEVICE_ID_VENDOR_NAME   "Jan Green Larsen"
+#define DEVICE_ID_CONFORMITY    0x82    // Regular identification, stream + individual access
+#define DEVICE_ID_BASIC_COUNT   3       // Objects 0x00-0x02 (mandatory)
+
+#if defined(BOARD_ES32D26)
+#define DEVICE_ID_BOARD         "ES32D26"
+#elif defined(BOARD_WAVESHARE_S3_ETH)
+#define DEVICE_ID_BOARD         "ESP32-S3-ETH"
+#elif defined(BOARD_ESP32_38PIN)
+#define DEVICE_ID_BOARD         "ESP32-WROOM-32 38-pin"
+#elif defined(BOARD_ESP32_30PIN)
+#define DEVICE_ID_BOARD         "ESP32-WROOM-32 30-pin"
+#else
+#define DEVICE_ID_BOARD         "ESP32"
+#endif
+
+bool modbus_fc2b_read_device_identification(const ModbusFrame* request_frame, ModbusFrame* response_frame) {
+  if (request_frame == NULL || response_frame == NULL) return false;
+
+  // Only MEI type 0x0E is served; CANopen general reference (0x0D) is not a function here
+  if (request_frame->length < 5 || request_frame->data[0] != MEI_READ_DEVICE_ID) {
+    modbus_serialize_error_response(response_frame, request_frame->slave_id,
+                                     FC_ENCAPSULATED_INTERFACE, MODBUS_EXCEPTION_ILLEGAL_FUNCTION);
+    return false;
+  }
+
+  // Parse request
+  ModbusDeviceIdRequest req;
+  if (!modbus_parse_device_id(request_frame, &req)) {
+    modbus_serialize_error_response(response_frame, request_frame->slave_id,
+                                     FC_ENCAPSULATED_INTERFACE, MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+    return false;
+  }
+
+  // Object list in ascending id order (0x03 VendorUrl is not provided)
+  const char* app_name = g_persist_config.hostname[0] ? g_persist_config.hostname : DHCP_HOSTNAME;
+  const ModbusDeviceIdObject objects[] = {
+    {0x00, DEVICE_ID_VENDOR_NAME},   // VendorName
+    {0x01, DEVICE_ID_BOARD},         // ProductCode
+    {0x02, PROJECT_VERSION},         // MajorMinorRevision
+    {0x04, PROJECT_NAME},            // ProductName
+    {0x05, DEVICE_ID_BOARD},         // ModelName
+    {0x06, app_name},                // UserApplicationName
+  };
+  const uint8_t total = sizeof(objects) / sizeof(objects[0]);
+
+  // Individual access: exactly one object or exception 02
+  if (req.read_device_id_code == 4) {
+    for (uint8_t i = 0; i < total; i++) {
+      if (objects[i].id == req.object_id) {
+        return modbus_serialize_device_id_response(response_frame, request_frame->slave_id,
+                                                    req.read_device_id_code, DEVICE_ID_CONFORMITY,
+                                                    &objects[i], 1, 0);
+      }
+    }
+    modbus_serialize_error_response(response_frame, request_frame->slave_id,
+                                     FC_ENCAPSULATED_INTERFACE, MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+    return false;
+  }
+
+  // Stream access: basic (code 1) or regular (code 2; extended code 3 has no own objects)
+  const ModbusDeviceIdObject* category = objects;
+  uint8_t count = DEVICE_ID_BASIC_COUNT;
+  if (req.read_device_id_code != 1) {
+    category = &objects[DEVICE_ID_BASIC_COUNT];
+    count = total - DEVICE_ID_BASIC_COUNT;
+  }
+
+  // Continue from the requested object; an unknown id restarts the category
+  uint8_t first = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    if (category[i].id == req.object_id) {
+      first = i;
+      break;
+    }
+  }
+
+  return modbus_serialize_device_id_response(response_frame, request_frame->slave_id,
+                                              req.read_device_id_code, DEVICE_ID_CONFORMITY,
+                                              category, count, first);
+}
@@ -9,6 +9,7 @@
 #include "modbus_fc_dispatch.h"
 #include "modbus_fc_read.h"
 #include "modbus_fc_write.h"
+#include "modbus_fc_diag.h"
 #include "modbus_serializer.h"
 #include "constants.h"
 #include "debug.h"
@@ -49,6 +50,18 @@ bool modbus_dispatch_function_code(const ModbusFrame* request_frame, ModbusFrame
     case FC_WRITE_MULTIPLE_REGS:
       return modbus_fc10_write_multiple_registers(request_frame, response_frame);
 
+    case FC_DIAGNOSTICS:
+      return modbus_fc08_diagnostics(request_frame, response_frame);
+
+    case FC_MASK_WRITE_REG:
+      return modbus_fc16_mask_write_register(request_frame, response_frame);
+
+    case FC_READ_WRITE_MULTIPLE_REGS:
+      return modbus_fc17_read_write_multiple_registers(request_frame, response_frame);
+
+    case FC_ENCAPSULATED_INTERFACE:
+      return modbus_fc2b_read_device_identification(request_frame, response_frame);
+
     default:
       // Unsupported function code
       debug_print("Unsupported function code: 0x");
@@ -14,7 +14,6 @@
 #include "constants.h"
 #include "debug.h"
 #include <string.h>
-#include <Arduino.h>  // BUG-031 FIX: delayMicroseconds for write lock wait
 
 /* ============================================================================
  * HELPER FUNCTION: RESET-ON-READ HANDLING
@@ -197,33 +196,16 @@ bool modbus_fc03_read_holding_registers(const ModbusFrame* request_frame, Modbus
     return false;
   }
 
-  // Validate address range
-  if (req.starting_address + req.quantity > HOLDING_REGS_SIZE) {
+  // Validate address range: flat array or mapped sparse pages (v7.9.8.22)
+  if (registers_holding_span(req.starting_address, req.quantity) != req.quantity) {
     modbus_serialize_error_response(response_frame, request_frame->slave_id,
                                      FC_READ_HOLDING_REGS, MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
     return false;
   }
 
-  // BUG-031 FIX: Wait for any counter write locks before reading
-  // This prevents reading corrupted 64-bit counter values mid-update
-  // Check all 4 counters for write lock (max ~10us wait per counter)
-  for (uint8_t retry = 0; retry < 10; retry++) {
-    uint8_t any_locked = 0;
-    for (uint8_t id = 1; id <= 4; id++) {
-      if (counter_engine_is_write_locked(id)) {
-        any_locked = 1;
-        break;
-      }
-    }
-    if (!any_locked) break;
-    delayMicroseconds(10);  // Short wait, counter update is fast
-  }
-
-  // Read holding registers from storage
-  uint16_t register_data[125];
-  for (uint16_t i = 0; i < req.quantity; i++) {
-    register_data[i] = registers_get_holding_register(req.starting_address + i);
-  }
+  // Seqlocked snapshot straight into the response frame (big-endian): multi-word
+  // counter/ST values are never torn (v7.9.8.20, replaces BUG-031 write-lock spin)
+  registers_snapshot_holding_be(req.starting_address, req.quantity, &response_frame->data[1]);
 
   // Handle reset-on-read for counter compare status bits (v2.3+)
   // This must happen AFTER reading registers but BEFORE sending response
@@ -231,8 +213,8 @@ bool modbus_fc03_read_holding_registers(const ModbusFrame* request_frame, Modbus
   modbus_handle_reset_on_read(req.starting_address, req.quantity);
 
   // Serialize response
-  return modbus_serialize_read_registers_response(response_frame, request_frame->slave_id,
-                                                   FC_READ_HOLDING_REGS, register_data, req.quantity);
+  return modbus_serialize_read_registers_in_place(response_frame, request_frame->slave_id,
+                                                   FC_READ_HOLDING_REGS, req.quantity);
 }
 
 /* ============================================================================
@@ -250,21 +232,18 @@ bool modbus_fc04_read_input_registers(const ModbusFrame* request_frame, ModbusFr
     return false;
   }
 
-  // Validate address range
-  if (req.starting_address + req.quantity > INPUT_REGS_SIZE) {
+  // Validate address range: flat array or mapped sparse pages (v7.9.8.22)
+  if (registers_input_span(req.starting_address, req.quantity) != req.quantity) {
     modbus_serialize_error_response(response_frame, request_frame->slave_id,
                                      FC_READ_INPUT_REGS, MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
     return false;
   }
 
-  // Read input registers from storage
-  uint16_t register_data[125];
-  for (uint16_t i = 0; i < req.quantity; i++) {
-    register_data[i] = registers_get_input_register(req.starting_address + i);
-  }
+  // Seqlocked snapshot straight into the response frame (big-endian, v7.9.8.20)
+  registers_snapshot_input_be(req.starting_address, req.quantity, &response_frame->data[1]);
 
   // Serialize response
-  return modbus_serialize_read_registers_response(response_frame, request_frame->slave_id,
-                                                   FC_READ_INPUT_REGS, register_data, req.quantity);
+  return modbus_serialize_read_registers_in_place(response_frame, request_frame->slave_id,
+                                                   FC_READ_INPUT_REGS, req.quantity);
 }
 
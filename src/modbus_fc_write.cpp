@@ -3,11 +3,13 @@
  * @brief Modbus write function code handlers implementation (LAYER 2)
  *
  * Implements FC05-06, FC0F-10: Write Single/Multiple Coils/Registers
+ * and FC16-17 (FC22/FC23): Mask Write, Read/Write Multiple Registers
  */
 
 #include "modbus_fc_write.h"
 #include "modbus_parser.h"
 #include "modbus_serializer.h"
+#include "modbus_fc_read.h"
 #include "registers.h"
 #include "constants.h"
 #include "debug.h"
@@ -59,8 +61,8 @@ bool modbus_fc06_write_single_register(const ModbusFrame* request_frame, ModbusF
     return false;
   }
 
-  // Validate address range
-  if (req.register_address >= HOLDING_REGS_SIZE) {
+  // Validate address range: flat array or mapped sparse page (v7.9.8.22)
+  if (registers_holding_span(req.register_address, 1) != 1) {
     modbus_serialize_error_response(response_frame, request_frame->slave_id,
                                      FC_WRITE_SINGLE_REG, MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
     return false;
@@ -124,20 +126,94 @@ bool modbus_fc10_write_multiple_registers(const ModbusFrame* request_frame, Modb
     return false;
   }
 
-  // Validate address range
-  if (req.starting_address + req.quantity_of_registers > HOLDING_REGS_SIZE) {
+  // Validate address range: flat array or mapped sparse pages (v7.9.8.22)
+  if (registers_holding_span(req.starting_address, req.quantity_of_registers) != req.quantity_of_registers) {
     modbus_serialize_error_response(response_frame, request_frame->slave_id,
                                      FC_WRITE_MULTIPLE_REGS, MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
     return false;
   }
 
-  // Write register values
-  for (uint16_t i = 0; i < req.quantity_of_registers; i++) {
-    registers_set_holding_register(req.starting_address + i, req.register_values[i]);
+  // Decode register values (big-endian) and store them as one torn-free update,
+  // so a 32/64-bit value written by the master is never read half-updated (v7.9.8.20)
+  uint16_t values[123];
+  const uint8_t* src = req.register_bytes;
+  for (uint16_t i = 0; i < req.quantity_of_registers; i++, src += 2) {
+    values[i] = (uint16_t)((src[0] << 8) | src[1]);
   }
+  registers_set_holding_registers(req.starting_address, values, req.quantity_of_registers);
 
   // Serialize response
   return modbus_serialize_write_multiple_registers_response(response_frame, request_frame->slave_id,
                                                               req.starting_address, req.quantity_of_registers);
 }
 
+/* ============================================================================
+ * FC16 (FC22): MASK WRITE REGISTER (v7.9.8.24)
+ * ============================================================================ */
+
+bool modbus_fc16_mask_write_register(const ModbusFrame* request_frame, ModbusFrame* response_frame) {
+  if (request_frame == NULL || response_frame == NULL) return false;
+
+  // Parse request
+  ModbusMaskWriteRegisterRequest req;
+  if (!modbus_parse_mask_write_register(request_frame, &req)) {
+    modbus_serialize_error_response(response_frame, request_frame->slave_id,
+                                     FC_MASK_WRITE_REG, MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+    return false;
+  }
+
+  // Validate address: flat array or mapped sparse page
+  if (registers_holding_span(req.reference_address, 1) != 1) {
+    modbus_serialize_error_response(response_frame, request_frame->slave_id,
+                                     FC_MASK_WRITE_REG, MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+    return false;
+  }
+
+  // Read-modify-write under the register lock: two masters setting different
+  // bits of the same register can no longer undo each other
+  registers_mask_holding_register(req.reference_address, req.and_mask, req.or_mask);
+
+  // Serialize response (echo back request)
+  return modbus_serialize_mask_write_register_response(response_frame, request_frame->slave_id,
+                                                         req.reference_address, req.and_mask, req.or_mask);
+}
+
+/* ============================================================================
+ * FC17 (FC23): READ/WRITE MULTIPLE REGISTERS (v7.9.8.24)
+ * ============================================================================ */
+
+bool modbus_fc17_read_write_multiple_registers(const ModbusFrame* request_frame, ModbusFrame* response_frame) {
+  if (request_frame == NULL || response_frame == NULL) return false;
+
+  // Parse request
+  ModbusReadWriteMultipleRequest req;
+  if (!modbus_parse_read_write_multiple(request_frame, &req)) {
+    modbus_serialize_error_response(response_frame, request_frame->slave_id,
+                                     FC_READ_WRITE_MULTIPLE_REGS, MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+    return false;
+  }
+
+  // Validate both ranges before anything is written
+  if (registers_holding_span(req.write_starting_address, req.quantity_to_write) != req.quantity_to_write ||
+      registers_holding_span(req.read_starting_address, req.quantity_to_read) != req.quantity_to_read) {
+    modbus_serialize_error_response(response_frame, request_frame->slave_id,
+                                     FC_READ_WRITE_MULTIPLE_REGS, MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+    return false;
+  }
+
+  // Decode write values, then write + read back in one step straight into the response
+  uint16_t values[121];
+  const uint8_t* src = req.write_bytes;
+  for (uint16_t i = 0; i < req.quantity_to_write; i++, src += 2) {
+    values[i] = (uint16_t)((src[0] << 8) | src[1]);
+  }
+  registers_exchange_holding_be(req.write_starting_address, values, req.quantity_to_write,
+                                req.read_starting_address, req.quantity_to_read, &response_frame->data[1]);
+
+  // Same reset-on-read semantics as FC03 for the read part
+  modbus_handle_reset_on_read(req.read_starting_address, req.quantity_to_read);
+
+  // Serialize response (same layout as FC03)
+  return modbus_serialize_read_registers_in_place(response_frame, request_frame->slave_id,
+                                                   FC_READ_WRITE_MULTIPLE_REGS, req.quantity_to_read);
+}
@@ -11,6 +11,7 @@
  */
 
 #include "modbus_frame.h"
+#include "constants.h"
 #include "debug.h"
 #include <string.h>
 
@@ -21,40 +22,42 @@
 /**
  * @brief CRC16 lookup table (pre-computed for performance)
  * Generated using polynomial 0xA001 (reflected 0x8005)
+ * BUG-324 FIX: Table was only valid for the first 16 entries (nibble table
+ * pasted into a byte table) - regenerated, table[1] = 0xC0C1
  */
 static const uint16_t crc16_table[256] = {
-  0x0000, 0xCC01, 0xD801, 0x1400, 0xF001, 0x3C00, 0x2800, 0xE401,
-  0xA001, 0x6C00, 0x7800, 0xB401, 0x5000, 0x9C01, 0x8801, 0x4400,
-  0xC801, 0x0400, 0x1000, 0xDC01, 0x1800, 0xD401, 0xC001, 0x0C00,
-  0x8801, 0x4400, 0x5000, 0x9C01, 0xB000, 0x7C01, 0x6800, 0xA401,
-  0x2800, 0xE401, 0xF001, 0x3C00, 0xD801, 0x1400, 0x0000, 0xCC01,
-  0x6800, 0xA401, 0xB001, 0x7C00, 0x5800, 0x9401, 0x8001, 0x4C00,
-  0xA001, 0x6C00, 0x7800, 0xB401, 0x5000, 0x9C01, 0x8801, 0x4400,
-  0x0800, 0xC401, 0xD001, 0x1C00, 0xF800, 0x3401, 0x2000, 0xEC01,
-  0xD801, 0x1400, 0x0000, 0xCC01, 0x0800, 0xC401, 0xD001, 0x1C00,
-  0x5800, 0x9401, 0x8001, 0x4C00, 0xA001, 0x6C00, 0x7800, 0xB401,
-  0xB001, 0x7C00, 0x6800, 0xA401, 0x6000, 0xAC01, 0xB801, 0x7400,
-  0x1000, 0xDC01, 0xC801, 0x0400, 0xF001, 0x3C00, 0x2800, 0xE401,
-  0xF801, 0x3400, 0x2000, 0xEC01, 0x2800, 0xE401, 0xF001, 0x3C00,
-  0x7800, 0xB401, 0xA001, 0x6C00, 0xA801, 0x6400, 0x7000, 0xBC01,
-  0x5000, 0x9C01, 0x8801, 0x4400, 0xC001, 0x0C00, 0x1800, 0xD401,
-  0x1800, 0xD401, 0xC001, 0x0C00, 0xEC01, 0x2400, 0x3000, 0xFC00,
-  0x6800, 0xA401, 0xB001, 0x7C00, 0x5800, 0x9401, 0x8001, 0x4C00,
-  0x4400, 0x8801, 0x9C01, 0x5000, 0xD401, 0x1800, 0x0C00, 0xC001,
-  0x7000, 0xBC01, 0xA801, 0x6400, 0xA001, 0x6C00, 0x7800, 0xB401,
-  0x0800, 0xC401, 0xD001, 0x1C00, 0xF800, 0x3401, 0x2000, 0xEC01,
-  0x8801, 0x4400, 0x5000, 0x9C01, 0xB000, 0x7C01, 0x6800, 0xA401,
-  0xA001, 0x6C00, 0x7800, 0xB401, 0x5000, 0x9C01, 0x8801, 0x4400,
-  0xD801, 0x1400, 0x0000, 0xCC01, 0x0800, 0xC401, 0xD001, 0x1C00,
-  0x1800, 0xD401, 0xC001, 0x0C00, 0xEC01, 0x2400, 0x3000, 0xFC00,
-  0x2800, 0xE401, 0xF001, 0x3C00, 0xD801, 0x1400, 0x0000, 0xCC01,
-  0xB001, 0x7C00, 0x6800, 0xA401, 0x6000, 0xAC01, 0xB801, 0x7400,
-  0x5000, 0x9C01, 0x8801, 0x4400, 0xC001, 0x0C00, 0x1800, 0xD401,
-  0xF001, 0x3C00, 0x2800, 0xE401, 0x2000, 0xEC01, 0xF801, 0x3400,
-  0x7800, 0xB401, 0xA001, 0x6C00, 0xA801, 0x6400, 0x7000, 0xBC01,
-  0x5800, 0x9401, 0x8001, 0x4C00, 0x0C00, 0xC401, 0xD001, 0x1C00,
-  0xF800, 0x3401, 0x2000, 0xEC01, 0x0800, 0xC401, 0xD001, 0x1C00,
-  0xB801, 0x7400, 0x6000, 0xAC01, 0x6800, 0xA401, 0xB001, 0x7C00
+  0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+  0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+  0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+  0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+  0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+  0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+  0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+  0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+  0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+  0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+  0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+  0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+  0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+  0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+  0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+  0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+  0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+  0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+  0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+  0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+  0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+  0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+  0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+  0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+  0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+  0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+  0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+  0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+  0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+  0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+  0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+  0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040
 };
 
 uint16_t modbus_crc16(const uint8_t* data, uint16_t length) {
@@ -71,45 +74,26 @@ uint16_t modbus_crc16(const uint8_t* data, uint16_t length) {
 }
 
 bool modbus_frame_verify_crc(const ModbusFrame* frame) {
-  if (frame == NULL || frame->length < 3) return false;
+  if (frame == NULL || frame->length < 4 || frame->length > MODBUS_FRAME_MAX) return false;
 
-  // CRC is calculated over slave_id + function_code + data
-  // Data length = total length - 2 (CRC bytes)
-  uint16_t data_len = frame->length - 2;
-
-  // BUG-147 FIX: Validate data_len before calculating data payload size
-  // If data_len < 2, then data_len - 2 would underflow and cause buffer overflow in memcpy
-  if (data_len < 2) return false;
-
-  uint8_t frame_data[254];
-
-  // Copy slave_id + function_code + data (exclude CRC)
-  frame_data[0] = frame->slave_id;
-  frame_data[1] = frame->function_code;
-  memcpy(&frame_data[2], frame->data, data_len - 2);
-
-  uint16_t calculated_crc = modbus_crc16(frame_data, data_len);
+  // CRC is calculated over slave_id + function_code + data, which are
+  // contiguous in ModbusFrame - no staging copy needed (v7.9.8.1)
+  uint16_t calculated_crc = modbus_crc16(modbus_frame_raw_const(frame), frame->length - 2);
 
   return (calculated_crc == frame->crc16);
 }
 
 void modbus_frame_set_crc(ModbusFrame* frame) {
-  if (frame == NULL || frame->length < 3) return;
+  if (frame == NULL || frame->length < 4 || frame->length > MODBUS_FRAME_MAX) return;
 
-  // CRC is calculated over slave_id + function_code + data
+  uint8_t* raw = modbus_frame_raw(frame);
   uint16_t data_len = frame->length - 2;
 
-  // BUG-147 FIX: Validate data_len before calculating data payload size
-  // If data_len < 2, then data_len - 2 would underflow and cause buffer overflow in memcpy
-  if (data_len < 2) return;
-
-  uint8_t frame_data[254];
-
-  frame_data[0] = frame->slave_id;
-  frame_data[1] = frame->function_code;
-  memcpy(&frame_data[2], frame->data, data_len - 2);
+  frame->crc16 = modbus_crc16(raw, data_len);
 
-  frame->crc16 = modbus_crc16(frame_data, data_len);
+  // Append CRC on the wire (little-endian) so TX can send raw bytes directly
+  raw[data_len] = frame->crc16 & 0xFF;
+  raw[data_len + 1] = (frame->crc16 >> 8) & 0xFF;
 }
 
 /* ============================================================================
@@ -7,12 +7,21 @@
 
 #include "modbus_master.h"
 #include "mb_async.h"
+#include "mb_profile.h"
+#include "mb_transport.h"
 #include "uart_driver.h"
 #include "config_struct.h"
 #include <HardwareSerial.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
 #if MODBUS_SINGLE_TRANSCEIVER
 #include "gpio_driver.h"
 #endif
+#if MODBUS_MASTER_HW_RS485
+#include <driver/uart.h>
+#endif
 
 /* ============================================================================
  * GLOBAL CONFIGURATION
@@ -29,6 +38,9 @@ modbus_master_config_t g_modbus_master_config = {
   .cache_ttl_ms = 0,  // 0 = never expire
   .cache_max_entries = MB_CACHE_MAX_ENTRIES_DEFAULT,
   .queue_max_size = MB_ASYNC_QUEUE_SIZE_DEFAULT,
+  .coalesce_enabled = 1,
+  .coalesce_gap = MODBUS_MASTER_DEFAULT_COALESCE_GAP,
+  .write_combine = 1,
   .total_requests = 0,
   .successful_requests = 0,
   .timeout_errors = 0,
@@ -43,6 +55,222 @@ modbus_master_config_t g_modbus_master_config = {
 #if !MODBUS_SINGLE_TRANSCEIVER
 HardwareSerial ModbusSerial(1); // UART1 — dedicated master port (non-ES32D26)
 #endif
+HardwareSerial ModbusSerialBus1(MODBUS_MASTER_BUS1_UART); // Extra master bus (v7.9.8.14)
+
+/* ============================================================================
+ * BUS PORTS (v7.9.8.14)
+ * One port per RS485 bus: bus 0 is the master UART configured through
+ * modbus_master_config_t, bus 1 the spare UART (g_persist_config.mb_buses[0]).
+ * Each bus has its own mb_async worker; send_request picks the port from the
+ * slave routing table. The port lock only matters when a route changes while
+ * the old bus still has a transaction for that slave in flight.
+ *
+ * RX EVENT WAIT (v7.9.8.13)
+ * The UART driver event task gives rx_event_sem when bytes arrive and the line
+ * has been idle for MODBUS_MASTER_RX_IDLE_SYMBOLS char times (or the RX FIFO
+ * fills). The transaction blocks on it instead of spinning on available().
+ *
+ * TRANSPORT (v7.9.8.18)
+ * The transaction does its byte I/O through port->transport. Default is the
+ * UART transport below; modbus_master_set_transport() swaps in another one
+ * (the host pty bus in tests/host) without touching the async worker, cache or profiler.
+ * ============================================================================ */
+
+typedef struct {
+  HardwareSerial *serial;            // NULL = shared uart1_* driver (ES32D26 bus 0)
+  SemaphoreHandle_t rx_event_sem;
+  SemaphoreHandle_t lock;            // One transaction per port at a time
+  uint8_t de_pin;
+  bool active;                       // UART started
+  ModbusMasterWaitStats wait_stats;
+  uint32_t turnaround_us;            // Last transaction: request sent → first response byte (v7.9.8.17)
+  uint32_t held_us;                  // Last transaction: total time on the bus
+  const mb_transport_t *transport;   // Byte I/O (NULL = UART, v7.9.8.18)
+  void *transport_ctx;
+} mb_master_port_t;
+
+static mb_master_port_t ports[MB_BUS_MAX];
+static int core_load_pct = -1;  // -1 = run-time stats not available
+
+// UART driver event task context (not ISR). Plain function per bus, since the
+// driver callback carries no context.
+static void modbus_master_on_rx_event(mb_master_port_t *port) {
+  if (port->rx_event_sem) {
+    xSemaphoreGive(port->rx_event_sem);
+  }
+}
+
+static void modbus_master_on_rx_event_bus0(void) { modbus_master_on_rx_event(&ports[0]); }
+static void modbus_master_on_rx_event_bus1(void) { modbus_master_on_rx_event(&ports[1]); }
+
+static void modbus_master_port_init(mb_master_port_t *port) {
+  if (port->rx_event_sem == NULL) {
+    port->rx_event_sem = xSemaphoreCreateBinary();
+  }
+  if (port->lock == NULL) {
+    port->lock = xSemaphoreCreateMutex();
+  }
+}
+
+static uint32_t modbus_master_serial_config(uint8_t parity, uint8_t stop_bits) {
+  if (parity == 1) { // Even parity
+    return (stop_bits == 2) ? SERIAL_8E2 : SERIAL_8E1;
+  } else if (parity == 2) { // Odd parity
+    return (stop_bits == 2) ? SERIAL_8O2 : SERIAL_8O1;
+  }
+  return (stop_bits == 2) ? SERIAL_8N2 : SERIAL_8N1; // No parity
+}
+
+uint32_t modbus_master_bus_baudrate(uint8_t bus) {
+  if (bus == 0 || bus >= MB_BUS_MAX) return g_modbus_master_config.baudrate;
+  return g_persist_config.mb_buses[bus - 1].baudrate;
+}
+
+static uint16_t modbus_master_bus_timeout(uint8_t bus) {
+  if (bus == 0 || bus >= MB_BUS_MAX) return g_modbus_master_config.timeout_ms;
+  return g_persist_config.mb_buses[bus - 1].timeout_ms;
+}
+
+uint16_t modbus_master_bus_inter_frame(uint8_t bus) {
+  extern uint16_t modbus_effective_inter_frame(uint16_t, uint32_t);
+  uint16_t configured = (bus == 0 || bus >= MB_BUS_MAX)
+    ? g_modbus_master_config.inter_frame_delay
+    : g_persist_config.mb_buses[bus - 1].inter_frame_delay;
+  return modbus_effective_inter_frame(configured, modbus_master_bus_baudrate(bus));
+}
+
+// Transceiver to transmit mode (no-op when the UART drives DE)
+static void modbus_master_de_tx(mb_master_port_t *port) {
+  if (port->wait_stats.hw_rs485) return;
+  digitalWrite(port->de_pin, HIGH);
+  delayMicroseconds(50); // Small delay for transceiver switching
+}
+
+// Transceiver back to receive mode after the last stop bit
+static void modbus_master_de_rx(mb_master_port_t *port, uint32_t baudrate) {
+  if (port->wait_stats.hw_rs485) return;
+  // BUG-316 FIX: Wait long enough for last byte to fully exit the TX shift
+  // register BEFORE releasing DE. HardwareSerial::flush() semantics vary
+  // across Arduino ESP32 core versions — older versions only wait for FIFO
+  // empty, not shift register complete. A fixed 50µs was far too short at
+  // 9600 baud (1 byte = ~1040µs). Calculate one full char-time (11 bits
+  // worst-case with parity/2-stop-bits) plus 100µs margin.
+  uint32_t byte_us = (11UL * 1000000UL) / baudrate;
+  delayMicroseconds(byte_us + 100);
+  digitalWrite(port->de_pin, LOW);
+}
+
+// Start a HardwareSerial port: DE/RE by the UART if it can, RX event wake-up
+static void modbus_master_port_begin(mb_master_port_t *port, uint32_t baudrate, uint32_t config,
+                                     uint8_t rx, uint8_t tx, void (*on_rx)(void)) {
+  HardwareSerial *serial = port->serial;
+  serial->begin(baudrate, config, rx, tx);
+
+  // DE/RE: let the UART assert RTS for exactly the TX window if it can
+  port->wait_stats.hw_rs485 = false;
+#if MODBUS_MASTER_HW_RS485
+  serial->setPins(rx, tx, -1, port->de_pin);
+  port->wait_stats.hw_rs485 = serial->setMode(UART_MODE_RS485_HALF_DUPLEX);
+#endif
+  if (!port->wait_stats.hw_rs485) {
+    pinMode(port->de_pin, OUTPUT);
+    digitalWrite(port->de_pin, LOW); // Receive mode
+  }
+
+  // RX event: every data event (FIFO full or RX timeout) wakes the waiter
+  modbus_master_port_init(port);
+  serial->setRxTimeout(MODBUS_MASTER_RX_IDLE_SYMBOLS);
+  serial->onReceive(on_rx, false);
+
+  // Flush any pending data
+  serial->flush();
+  while (serial->available()) {
+    serial->read();
+  }
+  port->active = true;
+}
+
+// UART transport (ctx = port) — bus 0 on ES32D26 goes through the shared uart1_* driver
+static int modbus_master_port_available(void *ctx) {
+  mb_master_port_t *port = (mb_master_port_t *)ctx;
+  return port->serial ? port->serial->available() : uart1_available();
+}
+
+static int modbus_master_port_read(void *ctx) {
+  mb_master_port_t *port = (mb_master_port_t *)ctx;
+  return port->serial ? port->serial->read() : uart1_read();
+}
+
+static void modbus_master_port_flush_rx(void *ctx) {
+  mb_master_port_t *port = (mb_master_port_t *)ctx;
+  if (!port->serial) {
+    uart1_flush_rx();
+    return;
+  }
+  while (port->serial->available()) {
+    port->serial->read();
+  }
+}
+
+static void modbus_master_port_write(void *ctx, const uint8_t *data, uint8_t len) {
+  mb_master_port_t *port = (mb_master_port_t *)ctx;
+  modbus_master_de_tx(port);
+  if (port->serial) port->serial->write(data, len);
+  else uart1_write_buffer(data, len);
+}
+
+static void modbus_master_port_flush_tx(void *ctx) {
+  mb_master_port_t *port = (mb_master_port_t *)ctx;
+  // Wait for TX complete (blocks on the driver's TX done event)
+  if (port->serial) port->serial->flush();
+  else uart1_flush_tx();
+}
+
+static void modbus_master_port_rx_mode(void *ctx, uint32_t baudrate) {
+  modbus_master_de_rx((mb_master_port_t *)ctx, baudrate);
+}
+
+static const mb_transport_t mb_uart_transport = {
+  "uart",
+  NULL,
+  modbus_master_port_flush_rx,
+  modbus_master_port_write,
+  modbus_master_port_flush_tx,
+  modbus_master_port_rx_mode,
+  modbus_master_port_available,
+  modbus_master_port_read
+};
+
+static bool modbus_master_port_is_uart(const mb_master_port_t *port) {
+  return port->transport == NULL || port->transport == &mb_uart_transport;
+}
+
+// Is response[0..len) a complete RTU frame for its function code?
+static bool modbus_master_frame_complete(const uint8_t *response, uint8_t len) {
+  // Minimum response (slave_id + function + data + CRC)
+  if (len < 5) return false;
+
+  // For exceptions: slave_id + (function | 0x80) + exception_code + CRC (5 bytes)
+  // For normal: depends on function
+  uint8_t function_code = response[1];
+
+  if (function_code & 0x80) {
+    // BUG-149 FIX: Exception response is always exactly 5 bytes
+    // (slave_id + function + exception_code + CRC)
+    return true;
+  }
+  if (function_code == 0x01 || function_code == 0x02 ||
+      function_code == 0x03 || function_code == 0x04) {
+    // Read Coils/Inputs/Registers: slave_id + fc + byte_count + data + CRC
+    return len >= (uint8_t)(3 + response[2] + 2);
+  }
+  if (function_code == 0x05 || function_code == 0x06 || function_code == 0x0F || function_code == 0x10) {
+    // Write Single (FC05/06) / Write Multiple (FC15/16):
+    // slave_id + fc + address(2) + value|count(2) + CRC(2) = 8 bytes
+    return len >= 8;
+  }
+  return false;
+}
 
 /* ============================================================================
  * INITIALIZATION
@@ -63,15 +291,21 @@ void modbus_master_init() {
   g_modbus_master_config.cache_ttl_ms = g_persist_config.modbus_master.cache_ttl_ms;
   g_modbus_master_config.cache_max_entries = g_persist_config.modbus_master.cache_max_entries;
   g_modbus_master_config.queue_max_size = g_persist_config.modbus_master.queue_max_size;
+  g_modbus_master_config.coalesce_enabled = g_persist_config.modbus_master.coalesce_enabled;
+  g_modbus_master_config.coalesce_gap = g_persist_config.modbus_master.coalesce_gap;
+  g_modbus_master_config.write_combine = g_persist_config.modbus_master.write_combine;
   g_modbus_master_config.stats_since_ms = millis();
 
+  ports[0].de_pin = uart_get_master_dir_pin();
 #if MODBUS_SINGLE_TRANSCEIVER
   // ES32D26: shared transceiver — DIR pin already configured by uart_driver
   // Nothing to do here; uart1_init() handles UART setup
+  ports[0].serial = NULL;
 #else
   // Configure DE/RE pin (MAX485 direction control)
-  pinMode(uart_get_master_dir_pin(), OUTPUT);
-  digitalWrite(uart_get_master_dir_pin(), LOW); // Receive mode
+  ports[0].serial = &ModbusSerial;
+  pinMode(ports[0].de_pin, OUTPUT);
+  digitalWrite(ports[0].de_pin, LOW); // Receive mode
 #endif
 
   // Initialize UART if enabled
@@ -101,6 +335,7 @@ void modbus_master_set_enabled(bool enabled) {
   if (enabled) {
     modbus_master_reconfigure();
   } else {
+    ports[0].active = false;
 #if MODBUS_SINGLE_TRANSCEIVER
     uart1_stop();
 #else
@@ -114,37 +349,29 @@ void modbus_master_reconfigure() {
     return;
   }
 
-#if MODBUS_SINGLE_TRANSCEIVER
-  // ES32D26: reuse shared UART via uart_driver
+  mb_master_port_t *port = &ports[0];
+  port->de_pin = uart_get_master_dir_pin();
   // BUG-315 FIX: Build full serial config from master parity/stop bits.
   // Previously uart1_init() hardcoded SERIAL_8N1, silently dropping parity/stop.
-  uint32_t uart_config = SERIAL_8N1;
-  if (g_modbus_master_config.parity == 1) { // Even
-    uart_config = (g_modbus_master_config.stop_bits == 2) ? SERIAL_8E2 : SERIAL_8E1;
-  } else if (g_modbus_master_config.parity == 2) { // Odd
-    uart_config = (g_modbus_master_config.stop_bits == 2) ? SERIAL_8O2 : SERIAL_8O1;
-  } else { // None
-    uart_config = (g_modbus_master_config.stop_bits == 2) ? SERIAL_8N2 : SERIAL_8N1;
-  }
+  uint32_t config = modbus_master_serial_config(g_modbus_master_config.parity,
+                                                g_modbus_master_config.stop_bits);
+
+#if MODBUS_SINGLE_TRANSCEIVER
+  // ES32D26: reuse shared UART via uart_driver
+  // Master owns the shared UART's frame-end event (slave OR master on ES32D26)
+  modbus_master_port_init(port);
+  uart1_set_rx_frame_callback(modbus_master_on_rx_event_bus0, MODBUS_MASTER_RX_IDLE_SYMBOLS);
   uart1_stop();
-  uart1_init_ex(g_modbus_master_config.baudrate, uart_config);
+  uart1_init_ex(g_modbus_master_config.baudrate, config);
   // DIR pin setup
-  pinMode(uart_get_master_dir_pin(), OUTPUT);
-  digitalWrite(uart_get_master_dir_pin(), LOW); // Receive mode
+  port->wait_stats.hw_rs485 = false;
+  pinMode(port->de_pin, OUTPUT);
+  digitalWrite(port->de_pin, LOW); // Receive mode
+  port->active = true;
 #else
   // Stop existing UART
   ModbusSerial.end();
-
-  // Determine parity mode
-  uint32_t config = SERIAL_8N1; // Default: 8 data bits, no parity, 1 stop bit
-
-  if (g_modbus_master_config.parity == 1) { // Even parity
-    config = (g_modbus_master_config.stop_bits == 2) ? SERIAL_8E2 : SERIAL_8E1;
-  } else if (g_modbus_master_config.parity == 2) { // Odd parity
-    config = (g_modbus_master_config.stop_bits == 2) ? SERIAL_8O2 : SERIAL_8O1;
-  } else { // No parity
-    config = (g_modbus_master_config.stop_bits == 2) ? SERIAL_8N2 : SERIAL_8N1;
-  }
+  port->serial = &ModbusSerial;
 
   // Start UART — resolve pins from config (0xFF=board default)
   uint8_t mu = g_persist_config.modbus_master_uart;
@@ -154,19 +381,91 @@ void modbus_master_reconfigure() {
   uint8_t tx = (mu == 2 && g_persist_config.uart2_tx_pin != 0xFF) ? g_persist_config.uart2_tx_pin :
                (mu == 1 && g_persist_config.uart1_tx_pin != 0xFF) ? g_persist_config.uart1_tx_pin :
                MODBUS_MASTER_TX_PIN;
-  ModbusSerial.begin(
-    g_modbus_master_config.baudrate,
-    config,
-    rx,
-    tx
-  );
+  modbus_master_port_begin(port, g_modbus_master_config.baudrate, config, rx, tx,
+                           modbus_master_on_rx_event_bus0);
+#endif
+}
 
-  // Flush any pending data
-  ModbusSerial.flush();
-  while (ModbusSerial.available()) {
-    ModbusSerial.read();
+bool modbus_master_bus_start(uint8_t bus) {
+  if (bus == 0 || bus >= MB_BUS_MAX) return false;
+  modbus_master_bus_stop(bus);
+
+  // Non-UART transport (host pty bus): nothing on the pins
+  if (!modbus_master_port_is_uart(&ports[bus])) {
+    modbus_master_port_init(&ports[bus]);
+    ports[bus].active = true;
+    Serial.printf("[MB_MASTER] Bus %u: %s transport\n", bus, ports[bus].transport->name);
+    return true;
   }
-#endif
+
+  // No board default for the spare UART — all three pins must be configured
+  const uint8_t u = MODBUS_MASTER_BUS1_UART;
+  uint8_t tx = (u == 2) ? g_persist_config.uart2_tx_pin : g_persist_config.uart1_tx_pin;
+  uint8_t rx = (u == 2) ? g_persist_config.uart2_rx_pin : g_persist_config.uart1_rx_pin;
+  uint8_t dir = (u == 2) ? g_persist_config.uart2_dir_pin : g_persist_config.uart1_dir_pin;
+  if (tx == 0xFF || rx == 0xFF || dir == 0xFF) {
+    Serial.printf("[MB_MASTER] Bus %u: UART%u pins ikke konfigureret\n", bus, u);
+    return false;
+  }
+  if (g_persist_config.modbus_slave.enabled && g_persist_config.modbus_slave_uart == u) {
+    Serial.printf("[MB_MASTER] Bus %u: UART%u bruges af Modbus slave\n", bus, u);
+    return false;
+  }
+
+  const ModbusBusConfig *cfg = &g_persist_config.mb_buses[bus - 1];
+  mb_master_port_t *port = &ports[bus];
+  port->serial = &ModbusSerialBus1;
+  port->de_pin = dir;
+  modbus_master_port_begin(port, cfg->baudrate, modbus_master_serial_config(cfg->parity, cfg->stop_bits),
+                           rx, tx, modbus_master_on_rx_event_bus1);
+  Serial.printf("[MB_MASTER] Bus %u: UART%u %lu baud (TX=%u RX=%u DE=%u)\n",
+                bus, u, (unsigned long)cfg->baudrate, tx, rx, dir);
+  return true;
+}
+
+void modbus_master_bus_stop(uint8_t bus) {
+  if (bus == 0 || bus >= MB_BUS_MAX) return;
+  mb_master_port_t *port = &ports[bus];
+  if (!port->active) return;
+  // Wait for a transaction still running on this port
+  if (port->lock) xSemaphoreTake(port->lock, portMAX_DELAY);
+  port->active = false;
+  if (modbus_master_port_is_uart(port)) port->serial->end();
+  if (port->lock) xSemaphoreGive(port->lock);
+}
+
+bool modbus_master_set_transport(uint8_t bus, const mb_transport_t *transport, void *ctx) {
+  if (bus >= MB_BUS_MAX) return false;
+  mb_master_port_t *port = &ports[bus];
+  modbus_master_port_init(port);
+
+  // Swap between transactions. An extra bus is stopped; mb_async_bus_apply() restarts it.
+  xSemaphoreTake(port->lock, portMAX_DELAY);
+  if (bus > 0 && port->active) {
+    port->active = false;
+    if (modbus_master_port_is_uart(port)) port->serial->end();
+  }
+  if (transport == NULL) {
+    transport = &mb_uart_transport;
+    ctx = port;
+  }
+  port->transport = transport;
+  port->transport_ctx = ctx;
+  if (transport->attach) {
+    transport->attach(ctx, bus, bus == 0 ? modbus_master_on_rx_event_bus0 : modbus_master_on_rx_event_bus1);
+  }
+  xSemaphoreGive(port->lock);
+  return true;
+}
+
+const char *modbus_master_transport_name(uint8_t bus) {
+  if (bus >= MB_BUS_MAX || ports[bus].transport == NULL) return mb_uart_transport.name;
+  return ports[bus].transport->name;
+}
+
+bool modbus_master_bus_active(uint8_t bus) {
+  if (bus == 0) return g_modbus_master_config.enabled;
+  return bus < MB_BUS_MAX && ports[bus].active;
 }
 
 void modbus_master_reset_stats() {
@@ -175,6 +474,49 @@ void modbus_master_reset_stats() {
   g_modbus_master_config.timeout_errors = 0;
   g_modbus_master_config.crc_errors = 0;
   g_modbus_master_config.exception_errors = 0;
+  for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+    ModbusMasterWaitStats *ws = &ports[bus].wait_stats;
+    ws->transactions = 0;
+    ws->rx_events = 0;
+    ws->wait_us = 0;
+    ws->busy_us = 0;
+  }
+}
+
+const ModbusMasterWaitStats* modbus_master_get_wait_stats(uint8_t bus) {
+  if (bus >= MB_BUS_MAX) bus = 0;
+  return &ports[bus].wait_stats;
+}
+
+void modbus_master_sample_core_load(void) {
+#if configGENERATE_RUN_TIME_STATS
+  static uint32_t last_ms = 0;
+  static uint32_t last_idle = 0;
+  static uint32_t last_total = 0;
+
+  // ulTaskGetIdleRunTimeCounter() reports the idle task of the calling core
+  if (xPortGetCoreID() != 0) return;
+  uint32_t now = millis();
+  if (last_ms != 0 && now - last_ms < 1000) return;
+
+  uint32_t idle = (uint32_t)ulTaskGetIdleRunTimeCounter();
+  uint32_t total = (uint32_t)portGET_RUN_TIME_COUNTER_VALUE();
+  if (last_ms != 0) {
+    uint32_t d_total = total - last_total;
+    uint32_t d_idle = idle - last_idle;
+    if (d_total > 0) {
+      if (d_idle > d_total) d_idle = d_total;
+      core_load_pct = 100 - (int)((uint64_t)d_idle * 100 / d_total);
+    }
+  }
+  last_ms = now ? now : 1;
+  last_idle = idle;
+  last_total = total;
+#endif
+}
+
+int modbus_master_get_core_load(void) {
+  return core_load_pct;
 }
 
 /* ============================================================================
@@ -202,126 +544,92 @@ uint16_t modbus_master_calc_crc(const uint8_t *buffer, uint8_t len) {
  * REQUEST/RESPONSE HANDLING
  * ============================================================================ */
 
-mb_error_code_t modbus_master_send_request(
+// One transaction on a port. Caller holds port->lock.
+static mb_error_code_t modbus_master_transact(
+  mb_master_port_t *port,
+  uint8_t bus,
   const uint8_t *request,
   uint8_t request_len,
   uint8_t *response,
   uint8_t *response_len,
   uint8_t max_response_len
 ) {
-  if (!g_modbus_master_config.enabled) {
-    return MB_NOT_ENABLED;
+  int64_t t_start = esp_timer_get_time();
+  int64_t t_wait = 0;
+  uint32_t baudrate = modbus_master_bus_baudrate(bus);
+  ModbusMasterWaitStats *ws = &port->wait_stats;
+  const mb_transport_t *tr = port->transport ? port->transport : &mb_uart_transport;
+  void *ctx = port->transport ? port->transport_ctx : port;
+
+  // Flush RX buffer and any stale RX event from the previous transaction
+  tr->flush_rx(ctx);
+  if (port->rx_event_sem) {
+    xSemaphoreTake(port->rx_event_sem, 0);
   }
 
-  // Flush RX buffer
-#if MODBUS_SINGLE_TRANSCEIVER
-  uart1_flush_rx();
-#else
-  while (ModbusSerial.available()) {
-    ModbusSerial.read();
-  }
-#endif
+  // Send request (DE/RE to transmit mode first)
+  tr->write(ctx, request, request_len);
+  int64_t t_flush = esp_timer_get_time();
+  tr->flush_tx(ctx);
+  int64_t t_sent = esp_timer_get_time();
+  t_wait += t_sent - t_flush;
+  int64_t t_first = 0;
 
-  // Set DE/RE to transmit mode
-  digitalWrite(uart_get_master_dir_pin(), HIGH);
-  delayMicroseconds(50); // Small delay for transceiver switching
-
-  // Send request
-#if MODBUS_SINGLE_TRANSCEIVER
-  uart1_write_buffer(request, request_len);
-  uart1_flush_tx();
-#else
-  ModbusSerial.write(request, request_len);
-  ModbusSerial.flush(); // Wait for TX complete
-#endif
-
-  // BUG-316 FIX: Wait long enough for last byte to fully exit the TX shift
-  // register BEFORE releasing DE. HardwareSerial::flush() semantics vary
-  // across Arduino ESP32 core versions — older versions only wait for FIFO
-  // empty, not shift register complete. A fixed 50µs was far too short at
-  // 9600 baud (1 byte = ~1040µs). Calculate one full char-time (11 bits
-  // worst-case with parity/2-stop-bits) plus 100µs margin.
-  uint32_t byte_us = (11UL * 1000000UL) / g_modbus_master_config.baudrate;
-  delayMicroseconds(byte_us + 100);
-  digitalWrite(uart_get_master_dir_pin(), LOW);
+  if (tr->rx_mode) tr->rx_mode(ctx, baudrate);
 
   // Wait for response with timeout
   // Two-phase timeout: full timeout_ms for first byte, then shorter inter-char timeout
   uint32_t start_time = millis();
   uint8_t bytes_received = 0;
   bool timeout = false;
+  bool complete = false;
+  uint32_t timeout_ms = modbus_master_bus_timeout(bus);
   // Inter-character timeout: T3.5 at baudrate (min 2ms, max 20ms)
-  uint32_t interchar_ms = (uint32_t)(38500UL / g_modbus_master_config.baudrate);
+  uint32_t interchar_ms = (uint32_t)(38500UL / baudrate);
   if (interchar_ms < 2) interchar_ms = 2;
   if (interchar_ms > 20) interchar_ms = 20;
 
   while (bytes_received < max_response_len) {
+    // Drain what the UART driver has buffered, stopping at the end of the frame
+    bool got = false;
+    while (!complete && bytes_received < max_response_len && tr->available(ctx)) {
+      int b = tr->read(ctx);
+      if (b < 0) break;
+      if (bytes_received == 0) t_first = esp_timer_get_time();
+      response[bytes_received++] = (uint8_t)b;
+      got = true;
+      complete = modbus_master_frame_complete(response, bytes_received);
+    }
+    if (got) start_time = millis(); // Reset for inter-character timeout
+    if (complete) break;
+
     // Check timeout: use full timeout for first byte, inter-char after that
-    uint32_t active_timeout = (bytes_received == 0) ? g_modbus_master_config.timeout_ms : interchar_ms;
-    if (millis() - start_time > active_timeout) {
+    uint32_t active_timeout = (bytes_received == 0) ? timeout_ms : interchar_ms;
+    uint32_t elapsed = millis() - start_time;
+    if (elapsed > active_timeout) {
       timeout = true;
       break;
     }
 
-    // Check for available data
-#if MODBUS_SINGLE_TRANSCEIVER
-    if (uart1_available()) {
-      int b = uart1_read();
-      if (b >= 0) {
-        response[bytes_received++] = (uint8_t)b;
-        start_time = millis();
-      }
-#else
-    if (ModbusSerial.available()) {
-      response[bytes_received++] = ModbusSerial.read();
-      start_time = millis(); // Reset for inter-character timeout
-#endif
-
-      // Check if we have minimum response (slave_id + function + data + CRC)
-      if (bytes_received >= 5) {
-        // For exceptions: slave_id + (function | 0x80) + exception_code + CRC (5 bytes)
-        // For normal: depends on function
-        uint8_t function_code = response[1];
-
-        if (function_code & 0x80) {
-          // BUG-149 FIX: Exception response is always exactly 5 bytes
-          // (slave_id + function + exception_code + CRC)
-          // We already checked bytes_received >= 5 in outer condition, so break immediately
-          break; // Complete exception response
-        } else {
-          // Normal response - check expected length
-          if (function_code == 0x01 || function_code == 0x02) {
-            // Read Coils/Inputs: slave_id + fc + byte_count + data + CRC
-            if (bytes_received >= 3) {
-              uint8_t byte_count = response[2];
-              if (bytes_received >= (uint8_t)(3 + byte_count + 2)) {
-                break; // Complete response
-              }
-            }
-          } else if (function_code == 0x03 || function_code == 0x04) {
-            // Read Registers: slave_id + fc + byte_count + data + CRC
-            if (bytes_received >= 3) {
-              uint8_t byte_count = response[2];
-              if (bytes_received >= (uint8_t)(3 + byte_count + 2)) {
-                break; // Complete response
-              }
-            }
-          } else if (function_code == 0x05 || function_code == 0x06) {
-            // Write Single: slave_id + fc + address(2) + value(2) + CRC(2) = 8 bytes
-            if (bytes_received >= 8) {
-              break; // Complete response
-            }
-          } else if (function_code == 0x10) {
-            // FC16 Write Multiple: slave_id + fc + address(2) + count(2) + CRC(2) = 8 bytes
-            if (bytes_received >= 8) {
-              break; // Complete response
-            }
-          }
-        }
-      }
+    // Block until the next RX event or the remaining timeout (CPU is free meanwhile)
+    TickType_t ticks = pdMS_TO_TICKS(active_timeout - elapsed + 1);
+    if (ticks == 0) ticks = 1;
+    int64_t t_block = esp_timer_get_time();
+    if (port->rx_event_sem == NULL) {
+      vTaskDelay(1);
+    } else if (xSemaphoreTake(port->rx_event_sem, ticks) == pdTRUE) {
+      ws->rx_events++;
     }
+    t_wait += esp_timer_get_time() - t_block;
   }
 
+  int64_t t_total = esp_timer_get_time() - t_start;
+  ws->transactions++;
+  ws->wait_us += (uint64_t)t_wait;
+  ws->busy_us += (uint64_t)(t_total > t_wait ? t_total - t_wait : 0);
+  port->held_us = (uint32_t)t_total;
+  port->turnaround_us = (t_first > t_sent) ? (uint32_t)(t_first - t_sent) : 0;
+
   *response_len = bytes_received;
 
   // Extract slave_id and address from request for error tracking
@@ -369,6 +677,35 @@ mb_error_code_t modbus_master_send_request(
   return MB_OK;
 }
 
+mb_error_code_t modbus_master_send_request(
+  const uint8_t *request,
+  uint8_t request_len,
+  uint8_t *response,
+  uint8_t *response_len,
+  uint8_t max_response_len
+) {
+  // v7.9.8.14: the slave ID selects the bus
+  uint8_t bus = mb_async_bus_of(request[0]);
+  mb_master_port_t *port = &ports[bus];
+  if (!g_modbus_master_config.enabled || (bus > 0 && !port->active)) {
+    return MB_NOT_ENABLED;
+  }
+
+  if (port->lock && xSemaphoreTake(port->lock, portMAX_DELAY) != pdTRUE) {
+    return MB_NOT_ENABLED;
+  }
+  mb_error_code_t err = MB_NOT_ENABLED;  // Stopped while we waited for the lock
+  if (bus == 0 || port->active) {
+    err = modbus_master_transact(port, bus, request, request_len, response, response_len, max_response_len);
+    // v7.9.8.17: profiler (turnaround, bytes on the wire, bus time)
+    mb_profile_record_transaction(bus, request[0], request[1], modbus_master_bus_baudrate(bus),
+                                  request_len, *response_len, port->turnaround_us, port->held_us,
+                                  err == MB_OK);
+  }
+  if (port->lock) xSemaphoreGive(port->lock);
+  return err;
+}
+
 /* ============================================================================
  * MODBUS FUNCTIONS
  * ============================================================================ */
@@ -548,11 +885,11 @@ mb_error_code_t modbus_master_write_holding(uint8_t slave_id, uint16_t address,
 }
 
 mb_error_code_t modbus_master_read_holdings(uint8_t slave_id, uint16_t address, uint8_t count, uint16_t *results) {
-  if (count == 0 || count > 16) return MB_INVALID_ADDRESS;
+  if (count == 0 || count > MODBUS_MASTER_MAX_READ_REGS) return MB_INVALID_ADDRESS;
 
   uint8_t request[8];
   // Response: slave(1) + FC(1) + byte_count(1) + data(count*2) + CRC(2)
-  uint8_t response[5 + 16 * 2];  // Max 16 registers
+  uint8_t response[5 + MODBUS_MASTER_MAX_READ_REGS * 2];  // v7.9.8.16: full 125-register frame
   uint8_t response_len;
 
   // Build request: FC03 (Read Holding Registers) with count
@@ -587,10 +924,10 @@ mb_error_code_t modbus_master_read_holdings(uint8_t slave_id, uint16_t address,
 }
 
 mb_error_code_t modbus_master_write_holdings(uint8_t slave_id, uint16_t address, uint8_t count, const uint16_t *values) {
-  if (count == 0 || count > 16) return MB_INVALID_ADDRESS;
+  if (count == 0 || count > MODBUS_MASTER_MAX_WRITE_REGS) return MB_INVALID_ADDRESS;
 
   // Request: slave(1) + FC16(1) + addr(2) + count(2) + byte_count(1) + data(count*2) + CRC(2)
-  uint8_t request[9 + 16 * 2];  // Max 16 registers
+  uint8_t request[9 + MODBUS_MASTER_MAX_WRITE_REGS * 2];  // v7.9.8.16: full 123-register frame
   uint8_t response[8];
   uint8_t response_len;
 
@@ -618,3 +955,101 @@ mb_error_code_t modbus_master_write_holdings(uint8_t slave_id, uint16_t address,
   mb_error_code_t err = modbus_master_send_request(request, req_len + 2, response, &response_len, sizeof(response));
   return err;
 }
+
+mb_error_code_t modbus_master_write_coils(uint8_t slave_id, uint16_t address, uint16_t count, const uint8_t *bits) {
+  if (count == 0 || count > MODBUS_MASTER_MAX_WRITE_BITS) return MB_INVALID_ADDRESS;
+
+  // Request: slave(1) + FC15(1) + addr(2) + count(2) + byte_count(1) + data + CRC(2)
+  uint8_t request[9 + (MODBUS_MASTER_MAX_WRITE_BITS + 7) / 8];
+  uint8_t response[8];
+  uint8_t response_len;
+
+  uint8_t byte_count = (uint8_t)((count + 7) / 8);
+
+  // Build request: FC15 (Write Multiple Coils)
+  request[0] = slave_id;
+  request[1] = 0x0F;  // FC15
+  request[2] = (address >> 8) & 0xFF;
+  request[3] = address & 0xFF;
+  request[4] = (count >> 8) & 0xFF;
+  request[5] = count & 0xFF;
+  request[6] = byte_count;
+  memcpy(&request[7], bits, byte_count);
+  uint8_t req_len = 7 + byte_count;
+  uint16_t crc = modbus_master_calc_crc(request, req_len);
+  request[req_len] = crc & 0xFF;
+  request[req_len + 1] = (crc >> 8) & 0xFF;
+
+  g_modbus_master_config.total_requests++;
+
+  mb_error_code_t err = modbus_master_send_request(request, req_len + 2, response, &response_len, sizeof(response));
+  return err;
+}
+
+/* ============================================================================
+ * BLOCK READS (v7.9.8.11 — used by mb_async read coalescing)
+ * ============================================================================ */
+
+static mb_error_code_t modbus_master_read_block(uint8_t slave_id, uint8_t fc, uint16_t address,
+                                                uint16_t count, uint8_t data_bytes,
+                                                uint8_t *response, uint8_t *response_len) {
+  uint8_t request[8];
+
+  request[0] = slave_id;
+  request[1] = fc;
+  request[2] = (address >> 8) & 0xFF;
+  request[3] = address & 0xFF;
+  request[4] = (count >> 8) & 0xFF;
+  request[5] = count & 0xFF;
+  uint16_t crc = modbus_master_calc_crc(request, 6);
+  request[6] = crc & 0xFF;
+  request[7] = (crc >> 8) & 0xFF;
+
+  g_modbus_master_config.total_requests++;
+
+  // Response: slave(1) + FC(1) + byte_count(1) + data + CRC(2) — max 255 bytes
+  mb_error_code_t err = modbus_master_send_request(request, 8, response, response_len, (uint8_t)(5 + data_bytes));
+  if (err != MB_OK) return err;
+
+  if (*response_len >= (uint8_t)(5 + data_bytes) && response[1] == fc && response[2] == data_bytes) {
+    return MB_OK;
+  }
+  return MB_CRC_ERROR;
+}
+
+mb_error_code_t modbus_master_read_registers(uint8_t slave_id, uint8_t fc, uint16_t address, uint16_t count, uint16_t *results) {
+  if (count == 0 || count > MODBUS_MASTER_MAX_READ_REGS) return MB_INVALID_ADDRESS;
+  if (fc != 0x03 && fc != 0x04) return MB_INVALID_ADDRESS;
+
+  uint8_t response[5 + MODBUS_MASTER_MAX_READ_REGS * 2];
+  uint8_t response_len = 0;
+  mb_error_code_t err = modbus_master_read_block(slave_id, fc, address, count, (uint8_t)(count * 2),
+                                                 response, &response_len);
+  if (err != MB_OK) {
+    memset(results, 0, count * sizeof(uint16_t));
+    return err;
+  }
+
+  for (uint16_t i = 0; i < count; i++) {
+    results[i] = (response[3 + i * 2] << 8) | response[4 + i * 2];
+  }
+  return MB_OK;
+}
+
+mb_error_code_t modbus_master_read_bits(uint8_t slave_id, uint8_t fc, uint16_t address, uint16_t count, uint8_t *bits) {
+  if (count == 0 || count > MODBUS_MASTER_MAX_READ_BITS) return MB_INVALID_ADDRESS;
+  if (fc != 0x01 && fc != 0x02) return MB_INVALID_ADDRESS;
+
+  uint8_t data_bytes = (uint8_t)((count + 7) / 8);
+  uint8_t response[5 + (MODBUS_MASTER_MAX_READ_BITS + 7) / 8];
+  uint8_t response_len = 0;
+  mb_error_code_t err = modbus_master_read_block(slave_id, fc, address, count, data_bytes,
+                                                 response, &response_len);
+  if (err != MB_OK) {
+    memset(bits, 0, data_bytes);
+    return err;
+  }
+
+  memcpy(bits, &response[3], data_bytes);
+  return MB_OK;
+}
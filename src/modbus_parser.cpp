@@ -144,8 +144,8 @@ bool modbus_parse_write_multiple_coils(const ModbusFrame* frame, ModbusWriteMult
     return false;
   }
 
-  // Copy coil values
-  memcpy(req->output_values, &frame->data[5], req->byte_count);
+  // Coil values are read straight from the request frame
+  req->output_values = &frame->data[5];
 
   return true;
 }
@@ -183,11 +183,111 @@ bool modbus_parse_write_multiple_registers(const ModbusFrame* frame, ModbusWrite
     return false;
   }
 
-  // Extract register values (big-endian)
-  for (uint16_t i = 0; i < req->quantity_of_registers; i++) {
-    req->register_values[i] = extract_uint16_be(&frame->data[5 + i * 2]);
+  // Register values are decoded by the FC handler straight from the request frame
+  req->register_bytes = &frame->data[5];
+
+  return true;
+}
+
+/* ============================================================================
+ * READ-MODIFY-WRITE PARSING (FC16-17, v7.9.8.24)
+ * ============================================================================ */
+
+bool modbus_parse_mask_write_register(const ModbusFrame* frame, ModbusMaskWriteRegisterRequest* req) {
+  if (frame == NULL || req == NULL) return false;
+
+  // FC22 format: [Reference Address Hi/Lo] [AND Mask Hi/Lo] [OR Mask Hi/Lo]
+  if (frame->length != 10) {  // 1 (ID) + 1 (FC) + 6 (data) + 2 (CRC) = 10
+    debug_println("ERROR: Invalid mask write register length");
+    return false;
+  }
+
+  req->reference_address = extract_uint16_be(&frame->data[0]);
+  req->and_mask = extract_uint16_be(&frame->data[2]);
+  req->or_mask = extract_uint16_be(&frame->data[4]);
+
+  return true;
+}
+
+bool modbus_parse_read_write_multiple(const ModbusFrame* frame, ModbusReadWriteMultipleRequest* req) {
+  if (frame == NULL || req == NULL) return false;
+
+  // FC23 format: [Read Start Hi/Lo] [Read Qty Hi/Lo] [Write Start Hi/Lo] [Write Qty Hi/Lo]
+  //              [Write Byte Count] [Write Values...]
+  if (frame->length < 15) {  // 1 (ID) + 1 (FC) + 9 (header) + 2 (min 1 register) + 2 (CRC) = 15
+    debug_println("ERROR: Invalid read/write multiple length");
+    return false;
+  }
+
+  req->read_starting_address = extract_uint16_be(&frame->data[0]);
+  req->quantity_to_read = extract_uint16_be(&frame->data[2]);
+  req->write_starting_address = extract_uint16_be(&frame->data[4]);
+  req->quantity_to_write = extract_uint16_be(&frame->data[6]);
+  req->write_byte_count = frame->data[8];
+
+  // Validate quantities (max per Modbus spec: read 125, write 121)
+  if (req->quantity_to_read == 0 || req->quantity_to_read > 125 ||
+      req->quantity_to_write == 0 || req->quantity_to_write > 121) {
+    debug_println("ERROR: Invalid quantity in read/write multiple");
+    return false;
+  }
+
+  if (req->write_byte_count != req->quantity_to_write * 2) {
+    debug_println("ERROR: Byte count mismatch in read/write multiple");
+    return false;
+  }
+
+  if (frame->length != 13 + req->write_byte_count) {  // 1 (ID) + 1 (FC) + 9 (header) + byte_count + 2 (CRC)
+    debug_println("ERROR: Frame length mismatch in read/write multiple");
+    return false;
+  }
+
+  req->write_bytes = &frame->data[9];
+
+  return true;
+}
+
+/* ============================================================================
+ * DIAGNOSTICS / IDENTIFICATION PARSING (FC08, FC2B, v7.9.8.24)
+ * ============================================================================ */
+
+bool modbus_parse_diagnostics(const ModbusFrame* frame, ModbusDiagnosticsRequest* req) {
+  if (frame == NULL || req == NULL) return false;
+
+  // FC08 format: [Sub-function Hi/Lo] [Data (N x 2 bytes, N >= 1)]
+  if (frame->length < 8 || (frame->length & 1)) {  // 1 (ID) + 1 (FC) + 2 (sub) + 2N (data) + 2 (CRC)
+    debug_println("ERROR: Invalid diagnostics length");
+    return false;
   }
 
+  req->sub_function = extract_uint16_be(&frame->data[0]);
+  req->data_length = frame->length - 6;
+  req->data = &frame->data[2];
+
   return true;
 }
 
+bool modbus_parse_device_id(const ModbusFrame* frame, ModbusDeviceIdRequest* req) {
+  if (frame == NULL || req == NULL) return false;
+
+  // FC43 format: [MEI Type = 0x0E] [Read Device ID Code] [Object Id]
+  if (frame->length != 7) {  // 1 (ID) + 1 (FC) + 3 (data) + 2 (CRC) = 7
+    debug_println("ERROR: Invalid read device identification length");
+    return false;
+  }
+
+  if (frame->data[0] != MEI_READ_DEVICE_ID) {
+    debug_println("ERROR: Unsupported MEI type");
+    return false;
+  }
+
+  req->read_device_id_code = frame->data[1];
+  req->object_id = frame->data[2];
+
+  if (req->read_device_id_code < 1 || req->read_device_id_code > 4) {
+    debug_println("ERROR: Invalid read device ID code");
+    return false;
+  }
+
+  return true;
+}
@@ -73,6 +73,22 @@ bool modbus_serialize_read_registers_response(ModbusFrame* frame, uint8_t slave_
   return true;
 }
 
+bool modbus_serialize_read_registers_in_place(ModbusFrame* frame, uint8_t slave_id, uint8_t function_code,
+                                               uint16_t register_count) {
+  if (frame == NULL || register_count > 125) return false;
+
+  uint8_t byte_count = register_count * 2;
+
+  frame->slave_id = slave_id;
+  frame->function_code = function_code;
+  frame->data[0] = byte_count;
+  frame->length = 5 + byte_count;
+
+  modbus_frame_set_crc(frame);
+
+  return true;
+}
+
 /* ============================================================================
  * WRITE RESPONSE SERIALIZATION (FC05-06)
  * ============================================================================ */
@@ -159,6 +175,88 @@ bool modbus_serialize_write_multiple_registers_response(ModbusFrame* frame, uint
   return true;
 }
 
+/* ============================================================================
+ * READ-MODIFY-WRITE / DIAGNOSTICS RESPONSE SERIALIZATION (v7.9.8.24)
+ * ============================================================================ */
+
+bool modbus_serialize_mask_write_register_response(ModbusFrame* frame, uint8_t slave_id,
+                                                     uint16_t reference_address, uint16_t and_mask, uint16_t or_mask) {
+  if (frame == NULL) return false;
+
+  // Response format: [Slave ID] [FC] [Reference Address] [AND Mask] [OR Mask] [CRC] (echo of request)
+  frame->slave_id = slave_id;
+  frame->function_code = FC_MASK_WRITE_REG;
+  pack_uint16_be(&frame->data[0], reference_address);
+  pack_uint16_be(&frame->data[2], and_mask);
+  pack_uint16_be(&frame->data[4], or_mask);
+
+  // Total length: 1 (ID) + 1 (FC) + 6 (data) + 2 (CRC) = 10
+  frame->length = 10;
+
+  modbus_frame_set_crc(frame);
+
+  return true;
+}
+
+bool modbus_serialize_diagnostics_response(ModbusFrame* frame, uint8_t slave_id, uint16_t sub_function,
+                                            const uint8_t* data, uint8_t data_length) {
+  if (frame == NULL || (data == NULL && data_length > 0)) return false;
+  if (data_length > MODBUS_FRAME_DATA_MAX - 2) return false;
+
+  // Response format: [Slave ID] [FC] [Sub-function Hi/Lo] [Data...] [CRC]
+  frame->slave_id = slave_id;
+  frame->function_code = FC_DIAGNOSTICS;
+  pack_uint16_be(&frame->data[0], sub_function);
+  if (data_length > 0) memmove(&frame->data[2], data, data_length);  // Echo may alias the request frame
+
+  // Total length: 1 (ID) + 1 (FC) + 2 (sub) + data + 2 (CRC)
+  frame->length = 6 + data_length;
+
+  modbus_frame_set_crc(frame);
+
+  return true;
+}
+
+bool modbus_serialize_device_id_response(ModbusFrame* frame, uint8_t slave_id, uint8_t read_device_id_code,
+                                          uint8_t conformity_level, const ModbusDeviceIdObject* objects,
+                                          uint8_t count, uint8_t first) {
+  if (frame == NULL || (objects == NULL && count > 0) || first > count) return false;
+
+  // Response format: [Slave ID] [FC] [MEI 0x0E] [Read Dev ID Code] [Conformity] [More Follows]
+  //                  [Next Object Id] [Number Of Objects] {[Object Id] [Length] [Value...]} [CRC]
+  frame->slave_id = slave_id;
+  frame->function_code = FC_ENCAPSULATED_INTERFACE;
+  frame->data[0] = MEI_READ_DEVICE_ID;
+  frame->data[1] = read_device_id_code;
+  frame->data[2] = conformity_level;
+  frame->data[3] = 0x00;  // More follows
+  frame->data[4] = 0x00;  // Next object id
+  frame->data[5] = 0;     // Number of objects
+
+  uint16_t pos = 6;
+  for (uint8_t i = first; i < count; i++) {
+    size_t len = objects[i].value ? strlen(objects[i].value) : 0;
+    if (len > 245) len = 245;  // One object must always fit a frame on its own
+    if (pos + 2 + len > MODBUS_FRAME_DATA_MAX) {
+      frame->data[3] = 0xFF;
+      frame->data[4] = objects[i].id;
+      break;
+    }
+    frame->data[pos++] = objects[i].id;
+    frame->data[pos++] = (uint8_t)len;
+    memcpy(&frame->data[pos], objects[i].value, len);
+    pos += len;
+    frame->data[5]++;
+  }
+
+  // Total length: 1 (ID) + 1 (FC) + pos (data) + 2 (CRC)
+  frame->length = 4 + pos;
+
+  modbus_frame_set_crc(frame);
+
+  return true;
+}
+
 /* ============================================================================
  * ERROR RESPONSE SERIALIZATION
  * ============================================================================ */
@@ -3,26 +3,193 @@
  * @brief Modbus server main state machine implementation (LAYER 3)
  *
  * Main orchestration: Idle → RX → Process → TX → Idle
+ *
+ * v7.9.8.2: Runs in its own pinned task instead of loop(). The UART driver
+ * detects frame end in hardware (RX timeout = t3.5) and notifies the task,
+ * so a request is answered as soon as it is complete - independent of
+ * network, CLI and engine work in the main loop.
  */
 
 #include "modbus_server.h"
 #include "modbus_rx.h"
 #include "modbus_tx.h"
 #include "modbus_fc_dispatch.h"
+#include "modbus_fc_diag.h"
 #include "modbus_frame.h"
+#include "uart_driver.h"
+#include "config_struct.h"
 #include "constants.h"
 #include "debug.h"
 #include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <string.h>
 
 /* ============================================================================
  * STATIC STATE
  * ============================================================================ */
 
-static modbus_server_state_t server_state = MODBUS_STATE_IDLE;
+static volatile modbus_server_state_t server_state = MODBUS_STATE_IDLE;
 static uint8_t slave_id = SLAVE_ID;
 static ModbusFrame request_frame;
 static ModbusFrame response_frame;
 
+static TaskHandle_t server_task_handle = NULL;
+static volatile int64_t rx_frame_end_us = 0;   // Set by UART event callback, 0 = consumed
+static volatile uint32_t rx_idle_wait_ms = 4;  // t3.5 of the current line config
+
+static const uint32_t latency_bounds_us[MODBUS_SERVER_LATENCY_BUCKETS - 1] = MODBUS_SERVER_LATENCY_BOUNDS_US;
+static ModbusServerLatencyStats latency_stats;
+
+/* ============================================================================
+ * HELPERS
+ * ============================================================================ */
+
+// UART driver event task: RX line idle >= t3.5 → frame complete
+static void modbus_server_on_rx_frame(void) {
+  rx_frame_end_us = esp_timer_get_time();
+  if (server_task_handle) {
+    xTaskNotifyGive(server_task_handle);
+  }
+}
+
+// Frame-end silence in character times for the UART RX timeout
+static uint8_t modbus_server_idle_symbols(void) {
+  uint32_t baud = g_persist_config.modbus_slave.baudrate;
+  uint16_t manual_ms = g_persist_config.modbus_slave.inter_frame_delay;
+  if (baud == 0) baud = BAUDRATE;
+
+  uint32_t symbols;
+  if (manual_ms > 0) {
+    symbols = ((uint32_t)manual_ms * baud + 10999) / 11000;  // 11 bits/char, round up
+  } else if (baud > 19200) {
+    symbols = (1750UL * baud + 10999999UL) / 11000000UL;    // Spec: fixed 1.75 ms
+  } else {
+    symbols = 4;                                             // ceil(3.5)
+  }
+  if (symbols < 2) symbols = 2;
+  if (symbols > 100) symbols = 100;
+
+  // Same silence as a wait time for the safety wake (11 bits/char, round up)
+  rx_idle_wait_ms = (symbols * 11000UL + baud - 1) / baud;
+  return (uint8_t)symbols;
+}
+
+static void modbus_server_record_latency(uint32_t us) {
+  uint8_t b = 0;
+  while (b < MODBUS_SERVER_LATENCY_BUCKETS - 1 && us > latency_bounds_us[b]) b++;
+  latency_stats.bucket[b]++;
+  latency_stats.count++;
+  latency_stats.sum_us += us;
+  if (us > latency_stats.max_us) latency_stats.max_us = us;
+}
+
+static bool modbus_server_active(void) {
+#if MODBUS_SINGLE_TRANSCEIVER
+  // Single transceiver: UART belongs to the master unless mode == SLAVE
+  return g_persist_config.modbus_mode == MODBUS_MODE_SLAVE;
+#else
+  return true;
+#endif
+}
+
+/* ============================================================================
+ * SLAVE TASK
+ * ============================================================================ */
+
+// frame_end_us: frame-end event time, 0 if the frame was drained without one
+static void modbus_server_handle_frame(int64_t frame_end_us) {
+  server_state = MODBUS_STATE_RX;
+  modbus_rx_state_t rx_state = modbus_rx_read_frame(&request_frame);
+  ModbusDiagCounters *diag = modbus_diag_counters();
+
+  if (rx_state == MODBUS_RX_IDLE) {
+    server_state = MODBUS_STATE_IDLE;
+    return;
+  }
+  if (rx_state == MODBUS_RX_CRC_ERROR) {
+    g_persist_config.modbus_slave.crc_errors++;
+    diag->bus_comm_errors++;
+    server_state = MODBUS_STATE_IDLE;
+    return;
+  }
+  if (rx_state != MODBUS_RX_COMPLETE) {
+    debug_println("Modbus RX error, returning to idle");
+    diag->bus_comm_errors++;
+    server_state = MODBUS_STATE_IDLE;
+    return;
+  }
+
+  // FC08 0x0B counts every valid frame on the line, also those for other slaves
+  diag->bus_messages++;
+
+  // Check if frame is for this slave (or broadcast 0)
+  if (request_frame.slave_id != slave_id && request_frame.slave_id != 0) {
+    server_state = MODBUS_STATE_IDLE;
+    return;
+  }
+
+  g_persist_config.modbus_slave.total_requests++;
+  diag->server_messages++;
+
+  // Process request and generate response
+  server_state = MODBUS_STATE_PROCESS;
+  bool success = modbus_dispatch_function_code(&request_frame, &response_frame);
+  if (success) {
+    g_persist_config.modbus_slave.successful_requests++;
+  } else {
+    g_persist_config.modbus_slave.exception_errors++;
+  }
+
+  // Broadcast requests (slave_id == 0) should NOT generate responses
+  if (request_frame.slave_id == 0) {
+    diag->server_no_response++;
+    server_state = MODBUS_STATE_IDLE;
+    return;
+  }
+  if (!success) diag->bus_exceptions++;
+
+  server_state = MODBUS_STATE_TX;
+  if (frame_end_us > 0) {
+    modbus_server_record_latency((uint32_t)(esp_timer_get_time() - frame_end_us));
+  }
+
+  if (!modbus_tx_send_frame(&response_frame)) {
+    debug_println("TX error");
+  }
+
+  server_state = MODBUS_STATE_IDLE;
+}
+
+static void modbus_server_task(void *arg) {
+  (void)arg;
+
+  for (;;) {
+    uint32_t events = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(MODBUS_SERVER_IDLE_WAKE_MS));
+
+    if (!modbus_server_active()) continue;
+
+    if (events == 0) {
+      // Safety wake: a notification may have been lost while the UART was
+      // re-initialized. Only drain once the line has been quiet for t3.5 -
+      // bytes of a frame still arriving would end up as CRC/short errors.
+      int avail = uart1_available();
+      if (avail <= 0) continue;
+      events = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(rx_idle_wait_ms) + 1);
+      if (events == 0 && uart1_available() != avail) continue;  // Still receiving
+    }
+
+    // Latency only against the timestamp of a fresh frame-end event
+    int64_t frame_end_us = 0;
+    if (events > 0) {
+      frame_end_us = rx_frame_end_us;
+      rx_frame_end_us = 0;
+    }
+    modbus_server_handle_frame(frame_end_us);
+  }
+}
+
 /* ============================================================================
  * MODBUS SERVER FUNCTIONS
  * ============================================================================ */
@@ -30,108 +197,54 @@ static ModbusFrame response_frame;
 void modbus_server_init(uint8_t sid) {
   slave_id = sid;
   server_state = MODBUS_STATE_IDLE;
+  memset(&latency_stats, 0, sizeof(latency_stats));
 
   // Initialize subsystems
   modbus_rx_init();
   modbus_tx_init();
 
+  if (server_task_handle == NULL) {
+    BaseType_t ret = xTaskCreatePinnedToCore(
+      modbus_server_task,
+      "mb_slave",
+      MODBUS_SERVER_TASK_STACK,
+      NULL,
+      MODBUS_SERVER_TASK_PRIO,
+      &server_task_handle,
+      MODBUS_SERVER_TASK_CORE
+    );
+    if (ret != pdPASS) {
+      debug_println("ERROR: Failed to create Modbus slave task");
+      server_task_handle = NULL;
+    }
+  }
+
+  // Frame-end detection in the UART driver (re-applied on every uart1_init)
+  modbus_server_apply_line_config();
+
   debug_print("Modbus server initialized (Slave ID: ");
   debug_print_uint(slave_id);
   debug_println(")");
 }
 
-void modbus_server_loop(void) {
-  switch (server_state) {
-    case MODBUS_STATE_IDLE:
-      // Reset RX state and wait for request
-      modbus_rx_reset();
-      server_state = MODBUS_STATE_RX;
-      break;
-
-    case MODBUS_STATE_RX:
-      // Process RX
-      {
-        modbus_rx_state_t rx_state = modbus_rx_process(&request_frame);
-
-        if (rx_state == MODBUS_RX_COMPLETE) {
-          // Frame received successfully
-          // Check if frame is for this slave (or broadcast 0)
-          if (request_frame.slave_id == slave_id || request_frame.slave_id == 0) {
-            debug_print("Modbus request received: FC=0x");
-            debug_print_uint(request_frame.function_code);
-            debug_newline();
-            server_state = MODBUS_STATE_PROCESS;
-          } else {
-            // Not for this slave - ignore and return to idle
-            debug_print("Modbus request for different slave (ID: ");
-            debug_print_uint(request_frame.slave_id);
-            debug_println("), ignoring");
-            server_state = MODBUS_STATE_IDLE;
-          }
-        } else if (rx_state == MODBUS_RX_ERROR) {
-          // RX error - return to idle
-          debug_println("Modbus RX error, returning to idle");
-          server_state = MODBUS_STATE_IDLE;
-        }
-        // Otherwise stay in RX state
-      }
-      break;
-
-    case MODBUS_STATE_PROCESS:
-      // Process request and generate response
-      {
-        bool success = modbus_dispatch_function_code(&request_frame, &response_frame);
-
-        if (success) {
-          // Broadcast requests (slave_id == 0) should NOT generate responses
-          if (request_frame.slave_id == 0) {
-            debug_println("Broadcast request - no response sent");
-            server_state = MODBUS_STATE_IDLE;
-          } else {
-            debug_println("Processing complete, sending response");
-            server_state = MODBUS_STATE_TX;
-          }
-        } else {
-          // Error occurred - response_frame contains error response
-          // Broadcast requests should NOT send error responses
-          if (request_frame.slave_id == 0) {
-            debug_println("Broadcast request error - no response sent");
-            server_state = MODBUS_STATE_IDLE;
-          } else {
-            debug_println("Processing error, sending error response");
-            server_state = MODBUS_STATE_TX;
-          }
-        }
-      }
-      break;
-
-    case MODBUS_STATE_TX:
-      // Transmit response
-      {
-        bool success = modbus_tx_send_frame(&response_frame);
-
-        if (success) {
-          debug_println("Response transmitted");
-        } else {
-          debug_println("TX error");
-        }
-
-        server_state = MODBUS_STATE_IDLE;
-      }
-      break;
-
-    case MODBUS_STATE_ERROR:
-      // Error state - reset to idle
-      debug_println("Modbus server error, resetting to idle");
-      server_state = MODBUS_STATE_IDLE;
-      break;
-  }
+void modbus_server_apply_line_config(void) {
+  // Single transceiver in master mode: the frame-end event belongs to the master
+  if (server_task_handle == NULL || !modbus_server_active()) return;
+  uart1_set_rx_frame_callback(modbus_server_on_rx_frame, modbus_server_idle_symbols());
 }
 
 modbus_server_state_t modbus_server_get_state(void) {
   return server_state;
 }
 
+const ModbusServerLatencyStats* modbus_server_get_latency_stats(void) {
+  return &latency_stats;
+}
+
+void modbus_server_reset_latency_stats(void) {
+  memset(&latency_stats, 0, sizeof(latency_stats));
+}
+
 void modbus_server_set_slave_id(uint8_t sid) {
   if (sid >= 1 && sid <= 247) {
     slave_id = sid;
@@ -146,4 +259,3 @@ void modbus_server_set_slave_id(uint8_t sid) {
 uint8_t modbus_server_get_slave_id(void) {
   return slave_id;
 }
-
@@ -0,0 +1,493 @@
+/**
+ * @file modbus_tcp_server.cpp
+ * @brief Modbus TCP slave server implementation (FEAT-145, v7.9.8.0)
+ *
+ * Architecture:
+ * - One FreeRTOS task on Core 0 owns the listening socket and all client sockets
+ * - select() multiplexes accept + client RX (no per-client tasks, ~4 KB stack total)
+ * - Each client has a small RX buffer; every complete MBAP ADU in it is handed to
+ *   modbus_dispatch_function_code() in arrival order (pipelined transaction IDs)
+ * - All responses produced from one recv() are sent back with a single send()
+ *
+ * MBAP header (big-endian):
+ *   [TID hi][TID lo][PID hi=0][PID lo=0][LEN hi][LEN lo][UNIT ID]  + PDU (FC + data)
+ *   LEN counts UNIT ID + PDU bytes.
+ *
+ * The RTU handlers work on ModbusFrame, so the PDU is wrapped as
+ * [UNIT ID][FC][data...] with length = LEN + 2 (the CRC slot is never checked
+ * on this path) and the response frame is unwrapped the same way.
+ *
+ * FC08 sub-functions other than Return Query Data are answered with exception
+ * 01 here: the diagnostic counters belong to the RTU line.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <Arduino.h>
+#include <lwip/sockets.h>
+#include <lwip/inet.h>
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "modbus_tcp_server.h"
+#include "modbus_fc_dispatch.h"
+#include "modbus_server.h"
+#include "modbus_frame.h"
+#include "modbus_serializer.h"
+#include "constants.h"
+
+static const char *TAG = "MB_TCP";
+
+/* ============================================================================
+ * INTERNAL STATE
+ * ============================================================================ */
+
+typedef struct {
+  int      fd;                                  // -1 = slot free
+  uint32_t ip_addr;
+  uint16_t port;
+  uint32_t connected_ms;
+  uint32_t last_activity_ms;
+  uint32_t requests;
+  uint16_t rx_len;
+  uint8_t  rx_buf[MODBUS_TCP_RX_BUF_SIZE];
+} MbTcpClient;
+
+static MbTcpClient mbtcp_clients[MODBUS_TCP_MAX_CLIENTS];
+static ModbusTcpStats mbtcp_stats;
+static int mbtcp_listen_fd = -1;
+static uint16_t mbtcp_port = 0;
+static uint8_t mbtcp_max_clients = MODBUS_TCP_DEFAULT_CLIENTS;
+static uint32_t mbtcp_idle_timeout_ms = 0;
+static TaskHandle_t mbtcp_task_handle = NULL;
+static volatile bool mbtcp_stop_requested = false;
+
+// Request/response frames are only touched by the server task
+static ModbusFrame mbtcp_req_frame;
+static ModbusFrame mbtcp_resp_frame;
+static uint8_t mbtcp_tx_buf[MODBUS_TCP_TX_BUF_SIZE];
+
+// Stats are read and reset from the CLI/web tasks while the server task counts
+#define MBTCP_STAT_ADD(field, n) __atomic_add_fetch(&mbtcp_stats.field, (n), __ATOMIC_RELAXED)
+
+/* ============================================================================
+ * HELPERS
+ * ============================================================================ */
+
+static inline uint16_t mbtcp_get_u16(const uint8_t *p) {
+  return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static inline void mbtcp_put_u16(uint8_t *p, uint16_t v) {
+  p[0] = (v >> 8) & 0xFF;
+  p[1] = v & 0xFF;
+}
+
+static void mbtcp_close_client(MbTcpClient *c) {
+  if (c->fd >= 0) {
+    close(c->fd);
+    c->fd = -1;
+    if (mbtcp_stats.active_clients > 0) __atomic_sub_fetch(&mbtcp_stats.active_clients, 1, __ATOMIC_RELAXED);
+  }
+  c->rx_len = 0;
+}
+
+// Non-blocking socket: retry briefly on EAGAIN so a full lwIP send buffer
+// does not drop a response mid-ADU
+static bool mbtcp_send_all(int fd, const uint8_t *data, int len) {
+  int sent = 0;
+  uint8_t retries = 0;
+  while (sent < len) {
+    int n = send(fd, data + sent, len - sent, 0);
+    if (n > 0) {
+      sent += n;
+      retries = 0;
+    } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && retries < 50) {
+      retries++;
+      vTaskDelay(pdMS_TO_TICKS(2));
+    } else {
+      return false;
+    }
+  }
+  MBTCP_STAT_ADD(bytes_tx, (uint32_t)sent);
+  return true;
+}
+
+static bool mbtcp_unit_accepted(uint8_t unit_id) {
+  // 0xFF / 0 = "this device" per Modbus TCP spec; also accept the RTU slave ID
+  // so gateways that forward the RTU address keep working
+  return unit_id == 0xFF || unit_id == 0 || unit_id == modbus_server_get_slave_id();
+}
+
+static bool mbtcp_serial_only(const uint8_t *pdu, uint16_t pdu_len) {
+  // FC08 counters (0x0A-0x0F) count the RTU line only; over TCP they would report
+  // another transport's traffic, so only Return Query Data is served here
+  if (pdu[0] != FC_DIAGNOSTICS || pdu_len < 3) return false;
+  return (uint16_t)((pdu[1] << 8) | pdu[2]) != DIAG_RETURN_QUERY_DATA;
+}
+
+/**
+ * @brief Process one ADU and append the response ADU to out
+ * @param out Room for at least MODBUS_TCP_ADU_MAX bytes
+ * @return bytes appended to out
+ */
+static uint16_t mbtcp_process_adu(const uint8_t *adu, uint16_t mbap_len, uint8_t *out) {
+  uint16_t tid = mbtcp_get_u16(&adu[0]);
+  uint8_t unit_id = adu[6];
+  const uint8_t *pdu = &adu[MODBUS_TCP_MBAP_HEADER_LEN];
+  uint16_t pdu_len = mbap_len - 1;
+
+  // Response PDU: FC + data (worst case 1 + 252)
+  uint16_t resp_pdu_len;
+  const uint8_t *resp_data;
+  uint8_t resp_fc;
+  uint8_t exc_data[1];
+
+  if (!mbtcp_unit_accepted(unit_id)) {
+    MBTCP_STAT_ADD(unit_mismatch, 1);
+    MBTCP_STAT_ADD(exceptions, 1);
+    resp_fc = pdu[0] | 0x80;
+    exc_data[0] = MODBUS_EXCEPTION_GATEWAY_TARGET_FAILED;
+    resp_data = exc_data;
+    resp_pdu_len = 2;
+  } else if (mbtcp_serial_only(pdu, pdu_len)) {
+    MBTCP_STAT_ADD(exceptions, 1);
+    resp_fc = pdu[0] | 0x80;
+    exc_data[0] = MODBUS_EXCEPTION_ILLEGAL_FUNCTION;
+    resp_data = exc_data;
+    resp_pdu_len = 2;
+  } else {
+    // Wrap PDU as RTU-style frame: [UID][FC][data] + 2-byte CRC slot
+    mbtcp_req_frame.slave_id = unit_id;
+    mbtcp_req_frame.function_code = pdu[0];
+    memcpy(mbtcp_req_frame.data, &pdu[1], pdu_len - 1);
+    mbtcp_req_frame.length = pdu_len + 3;
+    mbtcp_req_frame.crc16 = 0;
+
+    mbtcp_resp_frame.length = 0;
+    modbus_dispatch_function_code(&mbtcp_req_frame, &mbtcp_resp_frame);
+
+    if (mbtcp_resp_frame.length < 5) {
+      // Handler produced no frame (should not happen) — report device failure
+      resp_fc = pdu[0] | 0x80;
+      exc_data[0] = MODBUS_EXCEPTION_SLAVE_DEVICE_FAILURE;
+      resp_data = exc_data;
+      resp_pdu_len = 2;
+    } else {
+      resp_fc = mbtcp_resp_frame.function_code;
+      resp_data = mbtcp_resp_frame.data;
+      resp_pdu_len = mbtcp_resp_frame.length - 3;  // strip UID + CRC(2)
+    }
+    if (resp_fc & 0x80) MBTCP_STAT_ADD(exceptions, 1);
+  }
+
+  uint16_t adu_len = MODBUS_TCP_MBAP_HEADER_LEN + resp_pdu_len;
+
+  mbtcp_put_u16(&out[0], tid);
+  mbtcp_put_u16(&out[2], 0);                   // Protocol ID
+  mbtcp_put_u16(&out[4], resp_pdu_len + 1);    // UID + PDU
+  out[6] = unit_id;
+  out[7] = resp_fc;
+  memcpy(&out[8], resp_data, resp_pdu_len - 1);
+
+  return adu_len;
+}
+
+/**
+ * @brief Consume all complete ADUs in client RX buffer
+ * @return false if the client must be dropped
+ */
+static bool mbtcp_service_client(MbTcpClient *c) {
+  uint16_t pos = 0;
+  uint16_t tx_len = 0;
+  uint8_t depth = 0;
+
+  while (c->rx_len - pos >= MODBUS_TCP_MBAP_HEADER_LEN) {
+    const uint8_t *adu = &c->rx_buf[pos];
+    uint16_t pid = mbtcp_get_u16(&adu[2]);
+    uint16_t mbap_len = mbtcp_get_u16(&adu[4]);
+
+    // LEN must cover UID + FC at minimum and fit one PDU
+    if (pid != 0 || mbap_len < 2 || mbap_len > MODBUS_TCP_ADU_MAX - 6) {
+      MBTCP_STAT_ADD(protocol_errors, 1);
+      ESP_LOGW(TAG, "Bad MBAP header (pid=%u len=%u), dropping client", pid, mbap_len);
+      return false;
+    }
+
+    uint16_t adu_total = 6 + mbap_len;
+    if (c->rx_len - pos < adu_total) break;  // Wait for rest of ADU
+
+    // Flush the batch before dispatch if a worst-case response would not fit:
+    // handlers have side effects, so an ADU must be dispatched exactly once
+    if (sizeof(mbtcp_tx_buf) - tx_len < MODBUS_TCP_ADU_MAX) {
+      if (!mbtcp_send_all(c->fd, mbtcp_tx_buf, tx_len)) return false;
+      tx_len = 0;
+    }
+
+    MBTCP_STAT_ADD(requests, 1);
+    tx_len += mbtcp_process_adu(adu, mbap_len, &mbtcp_tx_buf[tx_len]);
+    pos += adu_total;
+    depth++;
+    c->requests++;
+  }
+
+  // Keep partial ADU at buffer start
+  if (pos > 0) {
+    memmove(c->rx_buf, &c->rx_buf[pos], c->rx_len - pos);
+    c->rx_len -= pos;
+  }
+
+  if (depth > mbtcp_stats.max_pipeline_depth) mbtcp_stats.max_pipeline_depth = depth;
+
+  if (tx_len > 0 && !mbtcp_send_all(c->fd, mbtcp_tx_buf, tx_len)) return false;
+  return true;
+}
+
+static void mbtcp_accept(void) {
+  struct sockaddr_in addr;
+  socklen_t addr_len = sizeof(addr);
+  int fd = accept(mbtcp_listen_fd, (struct sockaddr *)&addr, &addr_len);
+  if (fd < 0) return;
+
+  int slot = -1;
+  if (mbtcp_stats.active_clients < mbtcp_max_clients) {
+    for (int i = 0; i < MODBUS_TCP_MAX_CLIENTS; i++) {
+      if (mbtcp_clients[i].fd < 0) { slot = i; break; }
+    }
+  }
+  if (slot < 0) {
+    MBTCP_STAT_ADD(connections_rejected, 1);
+    ESP_LOGW(TAG, "Client limit reached (%u), rejecting connection", mbtcp_max_clients);
+    close(fd);
+    return;
+  }
+
+  int flags = fcntl(fd, F_GETFL, 0);
+  fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+
+  // Responses are small and latency-critical for SCADA polls
+  int nodelay = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+  // TCP keepalive for zombie detection (same values as SSE)
+  int enable = 1, idle = 15, interval = 5, count = 3;
+  setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &enable, sizeof(enable));
+  setsockopt(fd, IPPROTO_TCP, TCP_KEEPIDLE, &idle, sizeof(idle));
+  setsockopt(fd, IPPROTO_TCP, TCP_KEEPINTVL, &interval, sizeof(interval));
+  setsockopt(fd, IPPROTO_TCP, TCP_KEEPCNT, &count, sizeof(count));
+
+  MbTcpClient *c = &mbtcp_clients[slot];
+  c->fd = fd;
+  c->ip_addr = addr.sin_addr.s_addr;
+  c->port = ntohs(addr.sin_port);
+  c->connected_ms = millis();
+  c->last_activity_ms = c->connected_ms;
+  c->requests = 0;
+  c->rx_len = 0;
+
+  MBTCP_STAT_ADD(connections_total, 1);
+  MBTCP_STAT_ADD(active_clients, 1);
+  ESP_LOGI(TAG, "Client connected: %s:%u (slot %d)", inet_ntoa(addr.sin_addr), c->port, slot);
+}
+
+/* ============================================================================
+ * SERVER TASK
+ * ============================================================================ */
+
+static void mbtcp_task(void *arg)
+{
+  ESP_LOGI(TAG, "Modbus TCP task running on port %u", mbtcp_port);
+
+  while (!mbtcp_stop_requested) {
+    fd_set rfds;
+    FD_ZERO(&rfds);
+    FD_SET(mbtcp_listen_fd, &rfds);
+    int max_fd = mbtcp_listen_fd;
+    for (int i = 0; i < MODBUS_TCP_MAX_CLIENTS; i++) {
+      if (mbtcp_clients[i].fd >= 0) {
+        FD_SET(mbtcp_clients[i].fd, &rfds);
+        if (mbtcp_clients[i].fd > max_fd) max_fd = mbtcp_clients[i].fd;
+      }
+    }
+
+    struct timeval tv;
+    tv.tv_sec = 0;
+    tv.tv_usec = MODBUS_TCP_SELECT_TIMEOUT_MS * 1000;
+    int ready = select(max_fd + 1, &rfds, NULL, NULL, &tv);
+    if (ready < 0) {
+      vTaskDelay(pdMS_TO_TICKS(10));
+      continue;
+    }
+
+    uint32_t now = millis();
+
+    if (ready > 0 && FD_ISSET(mbtcp_listen_fd, &rfds)) {
+      mbtcp_accept();
+    }
+
+    for (int i = 0; i < MODBUS_TCP_MAX_CLIENTS; i++) {
+      MbTcpClient *c = &mbtcp_clients[i];
+      if (c->fd < 0) continue;
+
+      if (ready > 0 && FD_ISSET(c->fd, &rfds)) {
+        int n = recv(c->fd, &c->rx_buf[c->rx_len], sizeof(c->rx_buf) - c->rx_len, 0);
+        if (n <= 0) {
+          if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            ESP_LOGI(TAG, "Client disconnected (slot %d, %lu requests)", i, (unsigned long)c->requests);
+            mbtcp_close_client(c);
+          }
+          continue;
+        }
+        c->rx_len += n;
+        c->last_activity_ms = now;
+        MBTCP_STAT_ADD(bytes_rx, (uint32_t)n);
+
+        if (!mbtcp_service_client(c)) {
+          mbtcp_close_client(c);
+          continue;
+        }
+      } else if (mbtcp_idle_timeout_ms > 0 && (now - c->last_activity_ms) > mbtcp_idle_timeout_ms) {
+        ESP_LOGI(TAG, "Client idle timeout (slot %d)", i);
+        mbtcp_close_client(c);
+      }
+    }
+  }
+
+  for (int i = 0; i < MODBUS_TCP_MAX_CLIENTS; i++) {
+    mbtcp_close_client(&mbtcp_clients[i]);
+  }
+  close(mbtcp_listen_fd);
+  mbtcp_listen_fd = -1;
+  mbtcp_task_handle = NULL;
+  ESP_LOGI(TAG, "Modbus TCP server stopped");
+  vTaskDelete(NULL);
+}
+
+/* ============================================================================
+ * START / STOP
+ * ============================================================================ */
+
+int modbus_tcp_server_start(const ModbusTcpConfig *config)
+{
+  if (!config) return -1;
+
+  // Previous stop still draining — give the task one select() period to exit
+  for (int i = 0; i < 5 && mbtcp_stop_requested && mbtcp_task_handle != NULL; i++) {
+    vTaskDelay(pdMS_TO_TICKS(MODBUS_TCP_SELECT_TIMEOUT_MS));
+  }
+
+  if (mbtcp_listen_fd >= 0) {
+    ESP_LOGI(TAG, "Modbus TCP server already running");
+    return 0;
+  }
+
+  mbtcp_port = config->port ? config->port : MODBUS_TCP_DEFAULT_PORT;
+  mbtcp_max_clients = config->max_clients;
+  if (mbtcp_max_clients < 1 || mbtcp_max_clients > MODBUS_TCP_MAX_CLIENTS) {
+    mbtcp_max_clients = MODBUS_TCP_DEFAULT_CLIENTS;
+  }
+  mbtcp_idle_timeout_ms = (uint32_t)config->idle_timeout_s * 1000UL;
+
+  for (int i = 0; i < MODBUS_TCP_MAX_CLIENTS; i++) {
+    mbtcp_clients[i].fd = -1;
+    mbtcp_clients[i].rx_len = 0;
+  }
+  memset(&mbtcp_stats, 0, sizeof(mbtcp_stats));
+
+  mbtcp_listen_fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (mbtcp_listen_fd < 0) {
+    ESP_LOGE(TAG, "Failed to create socket (errno: %d)", errno);
+    return -1;
+  }
+
+  int opt = 1;
+  setsockopt(mbtcp_listen_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+  int flags = fcntl(mbtcp_listen_fd, F_GETFL, 0);
+  fcntl(mbtcp_listen_fd, F_SETFL, flags | O_NONBLOCK);
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(mbtcp_port);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+  if (bind(mbtcp_listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+    ESP_LOGE(TAG, "Failed to bind port %u (errno: %d)", mbtcp_port, errno);
+    close(mbtcp_listen_fd);
+    mbtcp_listen_fd = -1;
+    return -1;
+  }
+
+  if (listen(mbtcp_listen_fd, mbtcp_max_clients) < 0) {
+    ESP_LOGE(TAG, "Failed to listen (errno: %d)", errno);
+    close(mbtcp_listen_fd);
+    mbtcp_listen_fd = -1;
+    return -1;
+  }
+
+  mbtcp_stop_requested = false;
+  BaseType_t ret = xTaskCreatePinnedToCore(
+    mbtcp_task,
+    "mb_tcp",
+    MODBUS_TCP_TASK_STACK,
+    NULL,
+    MODBUS_TCP_TASK_PRIO,
+    &mbtcp_task_handle,
+    MODBUS_TCP_TASK_CORE
+  );
+  if (ret != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create Modbus TCP task");
+    close(mbtcp_listen_fd);
+    mbtcp_listen_fd = -1;
+    return -1;
+  }
+
+  ESP_LOGI(TAG, "Modbus TCP server started on port %u (max %u clients)", mbtcp_port, mbtcp_max_clients);
+  return 0;
+}
+
+void modbus_tcp_server_stop(void)
+{
+  // Task closes its own sockets on next select() timeout
+  mbtcp_stop_requested = true;
+}
+
+bool modbus_tcp_server_is_running(void)
+{
+  return mbtcp_listen_fd >= 0 && mbtcp_task_handle != NULL;
+}
+
+uint16_t modbus_tcp_server_get_port(void)
+{
+  return modbus_tcp_server_is_running() ? mbtcp_port : 0;
+}
+
+const ModbusTcpStats *modbus_tcp_server_get_stats(void)
+{
+  return &mbtcp_stats;
+}
+
+void modbus_tcp_server_reset_stats(void)
+{
+  uint8_t active = mbtcp_stats.active_clients;
+  memset(&mbtcp_stats, 0, sizeof(mbtcp_stats));
+  mbtcp_stats.active_clients = active;
+}
+
+int modbus_tcp_server_get_clients(ModbusTcpClientInfo *out)
+{
+  int count = 0;
+  for (int i = 0; i < MODBUS_TCP_MAX_CLIENTS; i++) {
+    const MbTcpClient *c = &mbtcp_clients[i];
+    out[i].active = (c->fd >= 0);
+    out[i].ip_addr = c->ip_addr;
+    out[i].port = c->port;
+    out[i].connected_ms = c->connected_ms;
+    out[i].requests = c->requests;
+    if (out[i].active) count++;
+  }
+  return count;
+}
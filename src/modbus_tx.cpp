@@ -39,25 +39,13 @@ bool modbus_tx_send_frame(const ModbusFrame* frame) {
   gpio_write(PIN_RS485_DIR, 1);
   delayMicroseconds(10);  // Small delay for RS485 transceiver switching
 
-  // Build raw frame bytes: [slave_id] [FC] [data...] [CRC_LO] [CRC_HI]
-  uint8_t tx_buffer[MODBUS_FRAME_MAX];
-  uint16_t tx_index = 0;
-
-  tx_buffer[tx_index++] = frame->slave_id;
-  tx_buffer[tx_index++] = frame->function_code;
-
-  // Copy data (length includes ID, FC, data, CRC)
-  uint16_t data_len = frame->length - 4;  // Total - ID - FC - CRC(2)
-  for (uint16_t i = 0; i < data_len; i++) {
-    tx_buffer[tx_index++] = frame->data[i];
-  }
-
-  // Append CRC (little-endian: CRC_LO, CRC_HI)
-  tx_buffer[tx_index++] = frame->crc16 & 0xFF;
-  tx_buffer[tx_index++] = (frame->crc16 >> 8) & 0xFF;
+  // Frame is already on-wire layout: [slave_id] [FC] [data...] [CRC_LO] [CRC_HI]
+  // (CRC bytes appended in place by modbus_frame_set_crc, v7.9.8.1)
+  uint16_t tx_len = frame->length;
+  if (tx_len > MODBUS_FRAME_MAX) tx_len = MODBUS_FRAME_MAX;
 
   // Transmit via UART1
-  uart1_write_buffer(tx_buffer, tx_index);
+  uart1_write_buffer(modbus_frame_raw_const(frame), tx_len);
 
   // Wait for TX to complete
   uart1_flush_tx();
@@ -21,6 +21,8 @@
 #include "telnet_server.h"
 #include "http_server.h"
 #include "sse_events.h"
+#include "modbus_tcp_server.h"
+#include "config_struct.h"
 #include "network_config.h"
 #include "constants.h"
 #include "debug.h"
@@ -138,6 +140,16 @@ int network_manager_start_services(const NetworkConfig *config)
     }
   }
 
+  // Start Modbus TCP slave server (v7.9.8.0, FEAT-145)
+  if (g_persist_config.modbus_tcp.enabled) {
+    if (modbus_tcp_server_start(&g_persist_config.modbus_tcp) != 0) {
+      ESP_LOGE(TAG, "Failed to start Modbus TCP server");
+      // Non-fatal — RTU slave keeps running
+    }
+  } else {
+    ESP_LOGI(TAG, "Modbus TCP server disabled by config");
+  }
+
   return 0;
 }
 
@@ -238,6 +250,9 @@ int network_manager_stop(void)
   // Stop HTTP REST API server (v6.0.0+)
   http_server_stop();
 
+  // Stop Modbus TCP server (v7.9.8.0)
+  modbus_tcp_server_stop();
+
   // Stop Telnet server
   if (network_mgr.telnet_server) {
     telnet_server_stop(network_mgr.telnet_server);
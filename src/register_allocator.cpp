@@ -14,6 +14,7 @@
 #include "timer_config.h"
 #include "timer_engine.h"
 #include "gpio_mapping.h"
+#include "registers.h"
 #include "debug.h"
 #include <string.h>
 #include <stdio.h>
@@ -34,9 +35,100 @@
 // Allocate in DRAM (initialized at boot)
 static RegisterOwner allocation_map[ALLOCATOR_SIZE];
 
+// Owner ranges for HR180-65535 (v7.9.8.22 - sparse register pages)
+// Adjacent allocations with the same owner are merged into one range
+// RegisterRange size: 2+2+6 = 10 bytes, 32 ranges = 320 bytes
+static RegisterRange allocation_ranges[ALLOCATOR_RANGE_MAX];
+
+// Returned by register_allocator_get() for free addresses above ALLOCATOR_SIZE
+static RegisterOwner allocation_free_owner;
+
 // Track if allocator is initialized
 static bool allocator_initialized = false;
 
+/* ============================================================================
+ * RANGE HELPERS (addresses >= ALLOCATOR_SIZE)
+ * ============================================================================ */
+
+static RegisterRange* range_find(uint16_t reg_addr) {
+  for (uint8_t i = 0; i < ALLOCATOR_RANGE_MAX; i++) {
+    RegisterRange* r = &allocation_ranges[i];
+    if (r->count > 0 && reg_addr >= r->start && (uint32_t)reg_addr < (uint32_t)r->start + r->count) {
+      return r;
+    }
+  }
+  return NULL;
+}
+
+static bool range_same_owner(const RegisterRange* r, RegisterOwnerType type,
+                             uint8_t subsystem_id, const char* description) {
+  return r->owner.type == type && r->owner.subsystem_id == subsystem_id &&
+         strncmp(r->owner.description, description ? description : "",
+                 sizeof(r->owner.description) - 1) == 0;
+}
+
+static bool range_allocate(uint16_t reg_addr, RegisterOwnerType type,
+                           uint8_t subsystem_id, const char* description) {
+  // Grow an adjacent range owned by the same subsystem
+  for (uint8_t i = 0; i < ALLOCATOR_RANGE_MAX; i++) {
+    RegisterRange* r = &allocation_ranges[i];
+    if (r->count == 0 || !range_same_owner(r, type, subsystem_id, description)) continue;
+    if ((uint32_t)r->start + r->count == reg_addr) {
+      r->count++;
+      return true;
+    }
+    if (reg_addr + 1 == r->start) {
+      r->start = reg_addr;
+      r->count++;
+      return true;
+    }
+  }
+
+  for (uint8_t i = 0; i < ALLOCATOR_RANGE_MAX; i++) {
+    RegisterRange* r = &allocation_ranges[i];
+    if (r->count != 0) continue;
+    r->start = reg_addr;
+    r->count = 1;
+    r->owner.type = type;
+    r->owner.subsystem_id = subsystem_id;
+    strncpy(r->owner.description, description ? description : "", sizeof(r->owner.description) - 1);
+    r->owner.description[sizeof(r->owner.description) - 1] = '\0';
+    return true;
+  }
+
+  debug_println("[ALLOCATOR] ERROR: Range table full");
+  return false;
+}
+
+static void range_free(uint16_t reg_addr) {
+  RegisterRange* r = range_find(reg_addr);
+  if (r == NULL) return;
+
+  uint16_t last = r->start + r->count - 1;
+  if (r->count == 1) {
+    memset(r, 0, sizeof(RegisterRange));
+  } else if (reg_addr == r->start) {
+    r->start++;
+    r->count--;
+  } else if (reg_addr == last) {
+    r->count--;
+  } else {
+    // Split: keep the lower part, move the upper part into a free slot
+    RegisterRange* upper = NULL;
+    for (uint8_t i = 0; i < ALLOCATOR_RANGE_MAX && upper == NULL; i++) {
+      if (allocation_ranges[i].count == 0) upper = &allocation_ranges[i];
+    }
+    if (upper == NULL) {
+      debug_println("[ALLOCATOR] ERROR: Range table full, cannot split range");
+      return;
+    }
+    *upper = *r;
+    upper->start = reg_addr + 1;
+    upper->count = last - reg_addr;
+    r->count = reg_addr - r->start;
+  }
+}
+
 /* ============================================================================
  * PUBLIC API IMPLEMENTATION
  * ============================================================================ */
@@ -48,6 +140,7 @@ void register_allocator_init(void) {
 
   // 1. Mark all registers as free
   memset(allocation_map, 0, sizeof(allocation_map));
+  memset(allocation_ranges, 0, sizeof(allocation_ranges));
 
   // 2. Pre-allocate ST Logic fixed registers (200-293)
   // These are READ-ONLY system registers, always reserved
@@ -118,11 +211,7 @@ void register_allocator_init(void) {
 }
 
 bool register_allocator_check(uint16_t reg_addr, RegisterOwner* owner) {
-  if (reg_addr >= ALLOCATOR_SIZE) {
-    return false;  // Out of bounds
-  }
-
-  RegisterOwner* reg_owner = &allocation_map[reg_addr];
+  const RegisterOwner* reg_owner = register_allocator_get(reg_addr);
 
   if (owner != NULL) {
     *owner = *reg_owner;
@@ -133,23 +222,30 @@ bool register_allocator_check(uint16_t reg_addr, RegisterOwner* owner) {
 
 bool register_allocator_allocate(uint16_t reg_addr, RegisterOwnerType type,
                                  uint8_t subsystem_id, const char* description) {
-  if (reg_addr >= ALLOCATOR_SIZE) {
-    debug_println("[ALLOCATOR] ERROR: Register address out of bounds");
-    return false;
-  }
-
-  RegisterOwner* owner = &allocation_map[reg_addr];
+  const RegisterOwner* current = register_allocator_get(reg_addr);
 
   // Check if already allocated
-  if (owner->type != REG_OWNER_NONE) {
+  if (current->type != REG_OWNER_NONE) {
     debug_print("[ALLOCATOR] ERROR: HR");
     debug_print_uint(reg_addr);
     debug_print(" already allocated to ");
-    debug_print(owner->description);
+    debug_print(current->description);
     debug_println("");
     return false;
   }
 
+  if (reg_addr >= ALLOCATOR_SIZE) {
+    // Back the register with storage before handing it out
+    if (registers_holding_span(reg_addr, 1) != 1 &&
+        !registers_page_map(REG_BANK_HR, reg_addr, 1)) {
+      debug_println("[ALLOCATOR] ERROR: Register page pool exhausted");
+      return false;
+    }
+    return range_allocate(reg_addr, type, subsystem_id, description);
+  }
+
+  RegisterOwner* owner = &allocation_map[reg_addr];
+
   // Allocate
   owner->type = type;
   owner->subsystem_id = subsystem_id;
@@ -166,6 +262,7 @@ bool register_allocator_allocate(uint16_t reg_addr, RegisterOwnerType type,
 
 void register_allocator_free(uint16_t reg_addr) {
   if (reg_addr >= ALLOCATOR_SIZE) {
+    range_free(reg_addr);  // Mapped pages stay mapped (never freed)
     return;
   }
 
@@ -183,13 +280,13 @@ void register_allocator_free(uint16_t reg_addr) {
 }
 
 uint16_t register_allocator_find_free(uint16_t start, uint16_t end) {
-  if (start >= ALLOCATOR_SIZE || end >= ALLOCATOR_SIZE) {
+  if (start > end) {
     return 0xFFFF;  // Invalid range
   }
 
-  for (uint16_t i = start; i <= end; i++) {
-    if (allocation_map[i].type == REG_OWNER_NONE) {
-      return i;
+  for (uint32_t i = start; i <= end && i < 0xFFFF; i++) {
+    if (register_allocator_get((uint16_t)i)->type == REG_OWNER_NONE) {
+      return (uint16_t)i;
     }
   }
 
@@ -198,7 +295,8 @@ uint16_t register_allocator_find_free(uint16_t start, uint16_t end) {
 
 const RegisterOwner* register_allocator_get(uint16_t reg_addr) {
   if (reg_addr >= ALLOCATOR_SIZE) {
-    return NULL;
+    const RegisterRange* r = range_find(reg_addr);
+    return r ? &r->owner : &allocation_free_owner;
   }
 
   return &allocation_map[reg_addr];
@@ -207,17 +305,27 @@ const RegisterOwner* register_allocator_get(uint16_t reg_addr) {
 bool register_allocator_allocate_range(uint16_t start_addr, uint8_t count,
                                        RegisterOwnerType type, uint8_t subsystem_id,
                                        const char* description) {
-  if (start_addr >= ALLOCATOR_SIZE || start_addr + count > ALLOCATOR_SIZE) {
+  if ((uint32_t)start_addr + count > 0x10000) {
     return false;  // Out of bounds
   }
 
   // First check if all registers are free
   for (uint8_t i = 0; i < count; i++) {
-    if (allocation_map[start_addr + i].type != REG_OWNER_NONE) {
+    if (register_allocator_get(start_addr + i)->type != REG_OWNER_NONE) {
       return false;  // Conflict found
     }
   }
 
+  // Map the sparse part in one go so a full pool fails before anything is allocated
+  if ((uint32_t)start_addr + count > HOLDING_REGS_SIZE) {
+    uint16_t sparse = (start_addr < HOLDING_REGS_SIZE) ? HOLDING_REGS_SIZE : start_addr;
+    uint16_t sparse_count = (uint16_t)(start_addr + count - sparse);
+    if (registers_holding_span(sparse, sparse_count) != sparse_count &&
+        !registers_page_map(REG_BANK_HR, sparse, sparse_count)) {
+      return false;
+    }
+  }
+
   // Allocate all
   for (uint8_t i = 0; i < count; i++) {
     register_allocator_allocate(start_addr + i, type, subsystem_id, description);
@@ -227,7 +335,7 @@ bool register_allocator_allocate_range(uint16_t start_addr, uint8_t count,
 }
 
 void register_allocator_free_range(uint16_t start_addr, uint8_t count) {
-  if (start_addr >= ALLOCATOR_SIZE || start_addr + count > ALLOCATOR_SIZE) {
+  if ((uint32_t)start_addr + count > 0x10000) {
     return;
   }
 
@@ -256,6 +364,22 @@ void register_allocator_debug_dump(void) {
     }
   }
 
+  for (uint8_t i = 0; i < ALLOCATOR_RANGE_MAX; i++) {
+    RegisterRange* r = &allocation_ranges[i];
+    if (r->count == 0) continue;
+    debug_print("  HR");
+    debug_print_uint(r->start);
+    debug_print("-");
+    debug_print_uint(r->start + r->count - 1);
+    debug_print(" -> type=");
+    debug_print_uint(r->owner.type);
+    debug_print(", subsys=");
+    debug_print_uint(r->owner.subsystem_id);
+    debug_print(", desc=\"");
+    debug_print(r->owner.description);
+    debug_println("\"");
+  }
+
   debug_print("[ALLOCATOR] Total allocated: ");
   debug_print_uint(allocated_count);
   debug_print(" / ");
@@ -31,7 +31,87 @@ static uint8_t coils[COILS_SIZE] = {0};                     // Packed bits (8 pe
 static uint8_t discrete_inputs[DISCRETE_INPUTS_SIZE] = {0}; // Packed bits (8 per byte)
 
 /* ============================================================================
- * FORWARD DECLARATIONS (handlers called from registers_set_holding_register)
+ * REGISTER CHANGE JOURNAL STORAGE (v7.9.8.21)
+ *
+ * Entry = bank (2 bits) | address (14 bits) | value (16 bits); the slot of a
+ * change is its sequence & (REG_JOURNAL_SIZE - 1). reg_block_seq holds the
+ * head right after the last change in each block (0 = never changed).
+ * ============================================================================ */
+
+static const uint16_t reg_bank_base[4] = {
+  0, HOLDING_REGS_SIZE, HOLDING_REGS_SIZE + INPUT_REGS_SIZE,
+  HOLDING_REGS_SIZE + INPUT_REGS_SIZE + COILS_SIZE * 8
+};
+
+static uint32_t reg_journal[REG_JOURNAL_SIZE];
+static uint32_t reg_journal_head = 0;
+static uint32_t reg_block_seq[REG_JOURNAL_BLOCKS] = {0};
+static uint32_t reg_journal_overruns = 0;
+static portMUX_TYPE reg_journal_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+static void reg_journal_record(reg_bank_t bank, uint16_t addr, uint16_t value) {
+  portENTER_CRITICAL(&reg_journal_spinlock);
+  uint32_t seq = reg_journal_head;
+  reg_journal[seq & (REG_JOURNAL_SIZE - 1)] = ((uint32_t)bank << 30) | ((uint32_t)addr << 16) | value;
+  reg_block_seq[(reg_bank_base[bank] + addr) >> REG_SEQ_REGION_SHIFT] = seq + 1;
+  __atomic_store_n(&reg_journal_head, seq + 1, __ATOMIC_RELEASE);
+  portEXIT_CRITICAL(&reg_journal_spinlock);
+}
+
+/* ============================================================================
+ * SPARSE REGISTER PAGE STORAGE (v7.9.8.22)
+ *
+ * HR/IR above the flat arrays: reg_page_table[bank][addr >> REG_PAGE_SHIFT]
+ * is 0 (unmapped) or pool index + 1. Pages are only ever added, so a slot
+ * read with acquire stays valid without holding a lock.
+ * ============================================================================ */
+
+static const uint16_t reg_flat_size[2] = { HOLDING_REGS_SIZE, INPUT_REGS_SIZE };
+static uint8_t reg_page_table[2][REG_PAGE_COUNT];
+static uint16_t *reg_page_pool[REG_PAGE_POOL_MAX];
+static uint8_t reg_page_used = 0;
+static portMUX_TYPE reg_page_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+// Word behind a sparse address, NULL if its page is not mapped
+static inline uint16_t *reg_page_word(reg_bank_t bank, uint16_t addr) {
+  uint8_t slot = __atomic_load_n(&reg_page_table[bank][addr >> REG_PAGE_SHIFT], __ATOMIC_ACQUIRE);
+  return slot ? &reg_page_pool[slot - 1][addr & (REG_PAGE_WORDS - 1)] : NULL;
+}
+
+/* ============================================================================
+ * HOLDING REGISTER WRITE HOOK INDEX (v7.9.8.23)
+ *
+ * Bit set in reg_hook_bitmap <=> reg_hook_index[addr] != 0, which is the
+ * reg_hook_table slot + 1 of the handler for that address.
+ * ============================================================================ */
+
+static uint32_t reg_hook_bitmap[HOLDING_REGS_SIZE / 32];
+static uint8_t reg_hook_index[HOLDING_REGS_SIZE];
+static reg_write_hook_t reg_hook_table[REG_HOOK_MAX];
+
+// Call the hooks of addr..addr+count-1 (flat), one call per run of equal handler
+static void reg_hook_dispatch(uint16_t addr, const uint16_t *values, uint16_t count) {
+  uint16_t end = addr + count;
+  uint16_t i = addr;
+  while (i < end) {
+    uint32_t bits = reg_hook_bitmap[i >> 5] >> (i & 31);
+    if (bits == 0) {
+      i = (i | 31) + 1;  // Nothing hooked in the rest of this word
+      continue;
+    }
+    i += __builtin_ctz(bits);
+    if (i >= end) break;
+
+    uint8_t slot = reg_hook_index[i];
+    uint16_t run = 1;
+    while (i + run < end && reg_hook_index[i + run] == slot) run++;
+    reg_hook_table[slot - 1](i, values + (i - addr), run);
+    i += run;
+  }
+}
+
+/* ============================================================================
+ * FORWARD DECLARATIONS (handlers installed as holding register write hooks)
  * ============================================================================ */
 
 void registers_process_st_logic_control(uint16_t addr, uint16_t value);
@@ -43,27 +123,25 @@ void registers_process_st_logic_var_input(uint16_t addr, uint16_t value);
  * ============================================================================ */
 
 uint16_t registers_get_holding_register(uint16_t addr) {
-  if (addr >= HOLDING_REGS_SIZE) return 0;
+  if (addr >= HOLDING_REGS_SIZE) {
+    const uint16_t *word = reg_page_word(REG_BANK_HR, addr);
+    return word ? *word : 0;
+  }
   return holding_regs[addr];
 }
 
 void registers_set_holding_register(uint16_t addr, uint16_t value) {
-  if (addr >= HOLDING_REGS_SIZE) return;
-  holding_regs[addr] = value;
-
-  // Process ST Logic control registers
-  if (addr >= ST_LOGIC_CONTROL_REG_BASE && addr < ST_LOGIC_CONTROL_REG_BASE + ST_LOGIC_MAX_PROGRAMS) {
-    registers_process_st_logic_control(addr, value);
+  if (addr >= HOLDING_REGS_SIZE) {
+    uint16_t *word = reg_page_word(REG_BANK_HR, addr);
+    if (word) *word = value;
+    return;
   }
-
-  // Process ST Logic execution interval (v4.1.0) - HR 236-237
-  if (addr == ST_LOGIC_EXEC_INTERVAL_RW_REG || addr == ST_LOGIC_EXEC_INTERVAL_RW_REG + 1) {
-    registers_process_st_logic_interval(addr, value);
+  if (holding_regs[addr] != value) {
+    holding_regs[addr] = value;
+    reg_journal_record(REG_BANK_HR, addr, value);
   }
-
-  // Process ST Logic variable input (v4.2.0) - HR 204-235
-  if (addr >= ST_LOGIC_VAR_INPUT_REG_BASE && addr < ST_LOGIC_VAR_INPUT_REG_BASE + 32) {
-    registers_process_st_logic_var_input(addr, value);
+  if (reg_hook_bitmap[addr >> 5] & (1u << (addr & 31))) {
+    reg_hook_table[reg_hook_index[addr] - 1](addr, &value, 1);
   }
 }
 
@@ -76,13 +154,23 @@ uint16_t* registers_get_holding_regs(void) {
  * ============================================================================ */
 
 uint16_t registers_get_input_register(uint16_t addr) {
-  if (addr >= INPUT_REGS_SIZE) return 0;
+  if (addr >= INPUT_REGS_SIZE) {
+    const uint16_t *word = reg_page_word(REG_BANK_IR, addr);
+    return word ? *word : 0;
+  }
   return input_regs[addr];
 }
 
 void registers_set_input_register(uint16_t addr, uint16_t value) {
-  if (addr >= INPUT_REGS_SIZE) return;
-  input_regs[addr] = value;
+  if (addr >= INPUT_REGS_SIZE) {
+    uint16_t *word = reg_page_word(REG_BANK_IR, addr);
+    if (word) *word = value;
+    return;
+  }
+  if (input_regs[addr] != value) {
+    input_regs[addr] = value;
+    reg_journal_record(REG_BANK_IR, addr, value);
+  }
 }
 
 uint16_t* registers_get_input_regs(void) {
@@ -105,11 +193,15 @@ void registers_set_coil(uint16_t idx, uint8_t value) {
   uint16_t byte_idx = idx / 8;
   uint16_t bit_idx = idx % 8;
 
+  value = value ? 1 : 0;
+  if (((coils[byte_idx] >> bit_idx) & 1) == value) return;  // Unchanged: nothing to store or journal
+
   if (value) {
     coils[byte_idx] |= (1 << bit_idx);  // Set bit
   } else {
     coils[byte_idx] &= ~(1 << bit_idx); // Clear bit
   }
+  reg_journal_record(REG_BANK_COIL, idx, value);  // After the store: a reader that sees the entry reads the new bit
 }
 
 uint8_t* registers_get_coils(void) {
@@ -132,17 +224,525 @@ void registers_set_discrete_input(uint16_t idx, uint8_t value) {
   uint16_t byte_idx = idx / 8;
   uint16_t bit_idx = idx % 8;
 
+  value = value ? 1 : 0;
+  if (((discrete_inputs[byte_idx] >> bit_idx) & 1) == value) return;  // Unchanged: nothing to store or journal
+
   if (value) {
     discrete_inputs[byte_idx] |= (1 << bit_idx);  // Set bit
   } else {
     discrete_inputs[byte_idx] &= ~(1 << bit_idx); // Clear bit
   }
+  reg_journal_record(REG_BANK_DI, idx, value);  // After the store: a reader that sees the entry reads the new bit
 }
 
 uint8_t* registers_get_discrete_inputs(void) {
   return discrete_inputs;
 }
 
+/* ============================================================================
+ * MULTI-WORD WRITES + CONSISTENT SNAPSHOTS (v7.9.8.20)
+ *
+ * One sequence counter per REG_SEQ_REGION_SIZE registers. Block writers are
+ * serialized by reg_seq_spinlock (also keeps them from being preempted while a
+ * counter is odd); readers never take it unless they keep losing the race.
+ * ============================================================================ */
+
+#define REG_SEQ_HR_REGIONS ((HOLDING_REGS_SIZE + REG_SEQ_REGION_SIZE - 1) >> REG_SEQ_REGION_SHIFT)
+#define REG_SEQ_IR_REGIONS ((INPUT_REGS_SIZE + REG_SEQ_REGION_SIZE - 1) >> REG_SEQ_REGION_SHIFT)
+
+static uint32_t hr_seq[REG_SEQ_HR_REGIONS] = {0};
+static uint32_t ir_seq[REG_SEQ_IR_REGIONS] = {0};
+static portMUX_TYPE reg_seq_spinlock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t reg_snapshot_retries = 0;
+static uint32_t reg_snapshot_locked = 0;
+
+// Store count words with reg_seq_spinlock held; caller has clipped count to the bank
+static void reg_seq_store_locked(uint16_t *regs, uint32_t *seq, reg_bank_t bank, uint16_t addr,
+                                 const uint16_t *values, uint16_t count) {
+  uint16_t first = addr >> REG_SEQ_REGION_SHIFT;
+  uint16_t last = (uint16_t)(addr + count - 1) >> REG_SEQ_REGION_SHIFT;
+
+  for (uint16_t r = first; r <= last; r++) {
+    __atomic_store_n(&seq[r], seq[r] + 1, __ATOMIC_RELAXED);  // Odd: write in progress
+  }
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  for (uint16_t i = 0; i < count; i++) {
+    if (regs[addr + i] != values[i]) {
+      regs[addr + i] = values[i];
+      reg_journal_record(bank, addr + i, values[i]);  // Nests inside reg_seq_spinlock, never the reverse
+    }
+  }
+  for (uint16_t r = first; r <= last; r++) {
+    __atomic_store_n(&seq[r], seq[r] + 1, __ATOMIC_RELEASE);  // Even: stable
+  }
+}
+
+static void reg_seq_store(uint16_t *regs, uint32_t *seq, reg_bank_t bank, uint16_t addr,
+                          const uint16_t *values, uint16_t count) {
+  portENTER_CRITICAL(&reg_seq_spinlock);
+  reg_seq_store_locked(regs, seq, bank, addr, values, count);
+  portEXIT_CRITICAL(&reg_seq_spinlock);
+}
+
+static inline void reg_seq_copy(const uint16_t *regs, uint16_t addr, uint16_t count,
+                                uint16_t *dst16, uint8_t *dst_be) {
+  if (dst16) {
+    for (uint16_t i = 0; i < count; i++) dst16[i] = regs[addr + i];
+  } else {
+    for (uint16_t i = 0; i < count; i++, dst_be += 2) {
+      uint16_t value = regs[addr + i];
+      dst_be[0] = (value >> 8) & 0xFF;
+      dst_be[1] = value & 0xFF;
+    }
+  }
+}
+
+// Torn-free copy of regs[addr..addr+count) into dst16 (native) or dst_be (Modbus byte order)
+static void reg_seq_snapshot(const uint16_t *regs, uint16_t size, const uint32_t *seq,
+                             uint16_t addr, uint16_t count, uint16_t *dst16, uint8_t *dst_be) {
+  uint16_t valid = (addr >= size) ? 0 : (count > size - addr ? size - addr : count);
+
+  // Out-of-range tail reads as 0 (callers validate, this only keeps dst defined)
+  for (uint16_t i = valid; i < count; i++) {
+    if (dst16) dst16[i] = 0;
+    else dst_be[i * 2] = dst_be[i * 2 + 1] = 0;
+  }
+  if (valid == 0) return;
+
+  uint16_t first = addr >> REG_SEQ_REGION_SHIFT;
+  uint16_t last = (uint16_t)(addr + valid - 1) >> REG_SEQ_REGION_SHIFT;
+  uint32_t before[REG_SEQ_IR_REGIONS];
+
+  for (uint8_t attempt = 0; attempt < REG_SNAPSHOT_MAX_RETRIES; attempt++) {
+    bool busy = false;
+    for (uint16_t r = first; r <= last; r++) {
+      before[r - first] = __atomic_load_n(&seq[r], __ATOMIC_ACQUIRE);
+      if (before[r - first] & 1) busy = true;
+    }
+    if (!busy) {
+      reg_seq_copy(regs, addr, valid, dst16, dst_be);
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      bool stable = true;
+      for (uint16_t r = first; r <= last && stable; r++) {
+        stable = (__atomic_load_n(&seq[r], __ATOMIC_RELAXED) == before[r - first]);
+      }
+      if (stable) return;
+    }
+    __atomic_add_fetch(&reg_snapshot_retries, 1, __ATOMIC_RELAXED);
+  }
+
+  // A writer kept hitting these regions: copy with block writers held off
+  portENTER_CRITICAL(&reg_seq_spinlock);
+  reg_seq_copy(regs, addr, valid, dst16, dst_be);
+  portEXIT_CRITICAL(&reg_seq_spinlock);
+  __atomic_add_fetch(&reg_snapshot_locked, 1, __ATOMIC_RELAXED);
+}
+
+// Sparse part of a block read, under reg_seq_spinlock so it is torn-free like the
+// flat part. One page-table lookup per page; unmapped words read as 0.
+static void reg_page_copy(reg_bank_t bank, uint32_t addr, uint16_t count,
+                          uint16_t *dst16, uint8_t *dst_be) {
+  while (count > 0) {
+    uint16_t off = addr & (REG_PAGE_WORDS - 1);
+    uint16_t n = REG_PAGE_WORDS - off;
+    if (n > count) n = count;
+    const uint16_t *src = (addr < 0x10000) ? reg_page_word(bank, (uint16_t)addr) : NULL;
+
+    if (dst16) {
+      if (src) memcpy(dst16, src, n * sizeof(uint16_t));
+      else memset(dst16, 0, n * sizeof(uint16_t));
+      dst16 += n;
+    } else {
+      for (uint16_t i = 0; i < n; i++, dst_be += 2) {
+        uint16_t value = src ? src[i] : 0;
+        dst_be[0] = (value >> 8) & 0xFF;
+        dst_be[1] = value & 0xFF;
+      }
+    }
+    addr += n;
+    count -= n;
+  }
+}
+
+// Sparse part of a block write, reg_seq_spinlock held; words in unmapped pages are dropped
+static void reg_page_store_locked(reg_bank_t bank, uint32_t addr, const uint16_t *values, uint16_t count) {
+  while (count > 0 && addr < 0x10000) {
+    uint16_t off = addr & (REG_PAGE_WORDS - 1);
+    uint16_t n = REG_PAGE_WORDS - off;
+    if (n > count) n = count;
+    uint16_t *dst = reg_page_word(bank, (uint16_t)addr);
+    if (dst) memcpy(dst, values, n * sizeof(uint16_t));
+    values += n;
+    addr += n;
+    count -= n;
+  }
+}
+
+static void reg_page_store(reg_bank_t bank, uint32_t addr, const uint16_t *values, uint16_t count) {
+  portENTER_CRITICAL(&reg_seq_spinlock);
+  reg_page_store_locked(bank, addr, values, count);
+  portEXIT_CRITICAL(&reg_seq_spinlock);
+}
+
+// Words of addr..addr+count-1 that fall in the flat array
+static inline uint16_t reg_flat_count(reg_bank_t bank, uint16_t addr, uint16_t count) {
+  uint16_t size = reg_flat_size[bank];
+  if (addr >= size) return 0;
+  return (count > size - addr) ? size - addr : count;
+}
+
+static void reg_bank_snapshot(reg_bank_t bank, uint16_t addr, uint16_t count,
+                              uint16_t *dst16, uint8_t *dst_be) {
+  uint16_t flat = reg_flat_count(bank, addr, count);
+  if (flat > 0) {
+    if (bank == REG_BANK_HR) reg_seq_snapshot(holding_regs, HOLDING_REGS_SIZE, hr_seq, addr, flat, dst16, dst_be);
+    else reg_seq_snapshot(input_regs, INPUT_REGS_SIZE, ir_seq, addr, flat, dst16, dst_be);
+  }
+  if (flat < count) {
+    portENTER_CRITICAL(&reg_seq_spinlock);
+    reg_page_copy(bank, (uint32_t)addr + flat, count - flat,
+                  dst16 ? dst16 + flat : NULL, dst16 ? NULL : dst_be + flat * 2);
+    portEXIT_CRITICAL(&reg_seq_spinlock);
+  }
+}
+
+void registers_set_holding_registers(uint16_t addr, const uint16_t *values, uint16_t count) {
+  if (!values || count == 0) return;
+
+  uint16_t flat = reg_flat_count(REG_BANK_HR, addr, count);
+  if (flat > 0) {
+    reg_seq_store(holding_regs, hr_seq, REG_BANK_HR, addr, values, flat);
+    reg_hook_dispatch(addr, values, flat);
+  }
+  if (flat < count) reg_page_store(REG_BANK_HR, (uint32_t)addr + flat, values + flat, count - flat);
+}
+
+void registers_set_input_registers(uint16_t addr, const uint16_t *values, uint16_t count) {
+  if (!values || count == 0) return;
+
+  uint16_t flat = reg_flat_count(REG_BANK_IR, addr, count);
+  if (flat > 0) reg_seq_store(input_regs, ir_seq, REG_BANK_IR, addr, values, flat);
+  if (flat < count) reg_page_store(REG_BANK_IR, (uint32_t)addr + flat, values + flat, count - flat);
+}
+
+void registers_snapshot_holding(uint16_t addr, uint16_t count, uint16_t *dst) {
+  if (!dst) return;
+  reg_bank_snapshot(REG_BANK_HR, addr, count, dst, NULL);
+}
+
+void registers_snapshot_input(uint16_t addr, uint16_t count, uint16_t *dst) {
+  if (!dst) return;
+  reg_bank_snapshot(REG_BANK_IR, addr, count, dst, NULL);
+}
+
+void registers_snapshot_holding_be(uint16_t addr, uint16_t count, uint8_t *dst) {
+  if (!dst) return;
+  reg_bank_snapshot(REG_BANK_HR, addr, count, NULL, dst);
+}
+
+void registers_snapshot_input_be(uint16_t addr, uint16_t count, uint8_t *dst) {
+  if (!dst) return;
+  reg_bank_snapshot(REG_BANK_IR, addr, count, NULL, dst);
+}
+
+void registers_exchange_holding_be(uint16_t wr_addr, const uint16_t *values, uint16_t wr_count,
+                                   uint16_t rd_addr, uint16_t rd_count, uint8_t *dst_be) {
+  if (!values || !dst_be) return;
+
+  uint16_t wr_flat = reg_flat_count(REG_BANK_HR, wr_addr, wr_count);
+  uint16_t rd_flat = reg_flat_count(REG_BANK_HR, rd_addr, rd_count);
+
+  // Write and read back without another block writer in between
+  portENTER_CRITICAL(&reg_seq_spinlock);
+  if (wr_flat > 0) reg_seq_store_locked(holding_regs, hr_seq, REG_BANK_HR, wr_addr, values, wr_flat);
+  if (wr_flat < wr_count) reg_page_store_locked(REG_BANK_HR, (uint32_t)wr_addr + wr_flat, values + wr_flat, wr_count - wr_flat);
+  if (rd_flat > 0) reg_seq_copy(holding_regs, rd_addr, rd_flat, NULL, dst_be);
+  if (rd_flat < rd_count) reg_page_copy(REG_BANK_HR, (uint32_t)rd_addr + rd_flat, rd_count - rd_flat, NULL, dst_be + rd_flat * 2);
+  portEXIT_CRITICAL(&reg_seq_spinlock);
+
+  if (wr_flat > 0) reg_hook_dispatch(wr_addr, values, wr_flat);
+}
+
+uint16_t registers_mask_holding_register(uint16_t addr, uint16_t and_mask, uint16_t or_mask) {
+  uint16_t value;
+
+  portENTER_CRITICAL(&reg_seq_spinlock);
+  if (addr < HOLDING_REGS_SIZE) {
+    value = (holding_regs[addr] & and_mask) | (or_mask & (uint16_t)~and_mask);
+    reg_seq_store_locked(holding_regs, hr_seq, REG_BANK_HR, addr, &value, 1);
+  } else {
+    uint16_t *word = reg_page_word(REG_BANK_HR, addr);
+    value = word ? (uint16_t)((*word & and_mask) | (or_mask & (uint16_t)~and_mask)) : 0;
+    if (word) *word = value;
+  }
+  portEXIT_CRITICAL(&reg_seq_spinlock);
+
+  if (addr < HOLDING_REGS_SIZE && (reg_hook_bitmap[addr >> 5] & (1u << (addr & 31)))) {
+    reg_hook_table[reg_hook_index[addr] - 1](addr, &value, 1);
+  }
+  return value;
+}
+
+// Two-register value (32-bit) as one update, words in register order
+static void registers_set_input_pair(uint16_t addr, uint16_t first, uint16_t second) {
+  uint16_t words[2] = { first, second };
+  registers_set_input_registers(addr, words, 2);
+}
+
+void registers_snapshot_stats(uint32_t *retries, uint32_t *locked) {
+  if (retries) *retries = __atomic_load_n(&reg_snapshot_retries, __ATOMIC_RELAXED);
+  if (locked) *locked = __atomic_load_n(&reg_snapshot_locked, __ATOMIC_RELAXED);
+}
+
+/* ============================================================================
+ * REGISTER CHANGE JOURNAL (v7.9.8.21)
+ * ============================================================================ */
+
+uint32_t registers_journal_head(void) {
+  return __atomic_load_n(&reg_journal_head, __ATOMIC_ACQUIRE);
+}
+
+void registers_journal_reader_init(reg_journal_reader_t *r) {
+  if (!r) return;
+  memset(r, 0, sizeof(*r));
+  r->cursor = registers_journal_head();
+}
+
+// Fell out of the ring: mark every block changed since the cursor dirty
+static void reg_journal_mark_blocks(reg_journal_reader_t *r) {
+  const uint32_t block_mask = (1UL << REG_SEQ_REGION_SIZE) - 1;
+  for (uint16_t b = 0; b < REG_JOURNAL_BLOCKS; b++) {
+    uint32_t changed = __atomic_load_n(&reg_block_seq[b], __ATOMIC_RELAXED);
+    if (changed != 0 && (int32_t)(changed - r->cursor) > 0) {
+      uint32_t bit = (uint32_t)b << REG_SEQ_REGION_SHIFT;
+      r->dirty[bit / 32] |= block_mask << (bit % 32);
+    }
+  }
+}
+
+uint32_t registers_journal_collect(reg_journal_reader_t *r) {
+  if (!r) return 0;
+  uint32_t head = registers_journal_head();
+  uint32_t consumed = head - r->cursor;
+  if (consumed == 0) return 0;
+
+  while (r->cursor != head) {
+    portENTER_CRITICAL(&reg_journal_spinlock);
+    if (reg_journal_head - r->cursor > REG_JOURNAL_SIZE) {
+      // Entries we still need were overwritten while we were away
+      portEXIT_CRITICAL(&reg_journal_spinlock);
+      reg_journal_mark_blocks(r);
+      r->cursor = head;
+      r->overruns++;
+      __atomic_add_fetch(&reg_journal_overruns, 1, __ATOMIC_RELAXED);
+      break;
+    }
+    // Bounded batch so writers on the other core are never held off for long
+    uint32_t n = head - r->cursor;
+    if (n > 32) n = 32;
+    for (uint32_t i = 0; i < n; i++) {
+      uint32_t e = reg_journal[(r->cursor + i) & (REG_JOURNAL_SIZE - 1)];
+      uint16_t bit = reg_bank_base[e >> 30] + ((e >> 16) & 0x3FFF);
+      r->dirty[bit / 32] |= 1UL << (bit % 32);
+    }
+    portEXIT_CRITICAL(&reg_journal_spinlock);
+    r->cursor += n;
+  }
+  return consumed;
+}
+
+bool registers_journal_next_dirty(reg_journal_reader_t *r, reg_bank_t *bank, uint16_t *addr) {
+  if (!r) return false;
+  for (uint16_t w = 0; w < REG_JOURNAL_WORDS / 32; w++) {
+    if (r->dirty[w] == 0) continue;
+    uint8_t b = (uint8_t)__builtin_ctz(r->dirty[w]);
+    r->dirty[w] &= ~(1UL << b);
+    uint16_t bit = w * 32 + b;
+    uint8_t k = 3;
+    while (bit < reg_bank_base[k]) k--;
+    if (bank) *bank = (reg_bank_t)k;
+    if (addr) *addr = bit - reg_bank_base[k];
+    return true;
+  }
+  return false;
+}
+
+bool registers_journal_changed_since(reg_bank_t bank, uint16_t addr, uint32_t seq) {
+  uint32_t changed = __atomic_load_n(&reg_block_seq[(reg_bank_base[bank] + addr) >> REG_SEQ_REGION_SHIFT],
+                                     __ATOMIC_RELAXED);
+  return changed != 0 && (int32_t)(changed - seq) > 0;
+}
+
+uint16_t registers_journal_value(reg_bank_t bank, uint16_t addr) {
+  switch (bank) {
+    case REG_BANK_HR:   return registers_get_holding_register(addr);
+    case REG_BANK_IR:   return registers_get_input_register(addr);
+    case REG_BANK_COIL: return registers_get_coil(addr);
+    case REG_BANK_DI:   return registers_get_discrete_input(addr);
+  }
+  return 0;
+}
+
+void registers_journal_stats(uint32_t *changes, uint32_t *overruns) {
+  if (changes) *changes = registers_journal_head();
+  if (overruns) *overruns = __atomic_load_n(&reg_journal_overruns, __ATOMIC_RELAXED);
+}
+
+/* ============================================================================
+ * SPARSE REGISTER PAGES (v7.9.8.22)
+ * ============================================================================ */
+
+bool registers_page_map(reg_bank_t bank, uint16_t addr, uint16_t count) {
+  if (bank > REG_BANK_IR || count == 0) return false;
+
+  uint32_t first = addr >> REG_PAGE_SHIFT;
+  uint32_t last = ((uint32_t)addr + count - 1) >> REG_PAGE_SHIFT;
+  if (last >= REG_PAGE_COUNT) last = REG_PAGE_COUNT - 1;
+  uint32_t flat_pages = reg_flat_size[bank] >> REG_PAGE_SHIFT;
+  if (first < flat_pages) first = flat_pages;  // Flat array needs no pages
+
+  for (uint32_t p = first; p <= last; p++) {
+    if (__atomic_load_n(&reg_page_table[bank][p], __ATOMIC_ACQUIRE)) continue;
+
+    // Allocate outside the critical section (heap must not be used with interrupts off)
+    uint16_t *page = (uint16_t *)calloc(REG_PAGE_WORDS, sizeof(uint16_t));
+    if (!page) return false;
+
+    bool placed = false, full = false;
+    portENTER_CRITICAL(&reg_page_spinlock);
+    if (reg_page_table[bank][p] == 0) {
+      if (reg_page_used < REG_PAGE_POOL_MAX) {
+        reg_page_pool[reg_page_used++] = page;
+        __atomic_store_n(&reg_page_table[bank][p], reg_page_used, __ATOMIC_RELEASE);
+        placed = true;
+      } else {
+        full = true;
+      }
+    }
+    portEXIT_CRITICAL(&reg_page_spinlock);
+
+    if (!placed) free(page);  // Pool full, or another task mapped it first
+    if (full) return false;
+  }
+  return true;
+}
+
+static uint16_t reg_page_span(reg_bank_t bank, uint16_t addr, uint16_t count) {
+  uint32_t end = (uint32_t)addr + count;
+  if (end > 0x10000) end = 0x10000;
+
+  uint32_t a = addr;
+  if (a < reg_flat_size[bank]) a = (end < reg_flat_size[bank]) ? end : reg_flat_size[bank];
+  while (a < end && __atomic_load_n(&reg_page_table[bank][a >> REG_PAGE_SHIFT], __ATOMIC_ACQUIRE)) {
+    a = ((a >> REG_PAGE_SHIFT) + 1) << REG_PAGE_SHIFT;  // Whole page present
+  }
+  if (a > end) a = end;
+  return (uint16_t)(a - addr);
+}
+
+uint16_t registers_holding_span(uint16_t addr, uint16_t count) {
+  return reg_page_span(REG_BANK_HR, addr, count);
+}
+
+uint16_t registers_input_span(uint16_t addr, uint16_t count) {
+  return reg_page_span(REG_BANK_IR, addr, count);
+}
+
+uint16_t registers_page_list(reg_bank_t bank, uint16_t *first_addrs, uint16_t max) {
+  if (bank > REG_BANK_IR || !first_addrs) return 0;
+  uint16_t n = 0;
+  for (uint32_t p = 0; p < REG_PAGE_COUNT && n < max; p++) {
+    if (__atomic_load_n(&reg_page_table[bank][p], __ATOMIC_ACQUIRE)) {
+      first_addrs[n++] = (uint16_t)(p << REG_PAGE_SHIFT);
+    }
+  }
+  return n;
+}
+
+uint8_t registers_page_apply_config(void) {
+  uint8_t failed = 0;
+  for (uint8_t i = 0; i < REG_PAGE_DECL_MAX; i++) {
+    const RegPageDecl *decl = &g_persist_config.reg_pages[i];
+    if (decl->count == 0) continue;
+    if (!registers_page_map((reg_bank_t)decl->bank, decl->start, decl->count)) failed++;
+  }
+  return failed;
+}
+
+void registers_page_stats(uint16_t *mapped, uint16_t *max) {
+  if (mapped) *mapped = __atomic_load_n(&reg_page_used, __ATOMIC_RELAXED);
+  if (max) *max = REG_PAGE_POOL_MAX;
+}
+
+/* ============================================================================
+ * HOLDING REGISTER WRITE HOOKS (v7.9.8.23)
+ * ============================================================================ */
+
+static void reg_hook_st_control(uint16_t addr, const uint16_t *values, uint16_t count) {
+  for (uint16_t i = 0; i < count; i++) registers_process_st_logic_control(addr + i, values[i]);
+}
+
+// The handler re-reads both words, so one call covers a write of HR 236-237
+static void reg_hook_st_interval(uint16_t addr, const uint16_t *values, uint16_t count) {
+  registers_process_st_logic_interval(addr, values[count - 1]);
+}
+
+static void reg_hook_st_var_input(uint16_t addr, const uint16_t *values, uint16_t count) {
+  for (uint16_t i = 0; i < count; i++) registers_process_st_logic_var_input(addr + i, values[i]);
+}
+
+void registers_write_hooks_init(void) {
+  memset(reg_hook_bitmap, 0, sizeof(reg_hook_bitmap));
+  memset(reg_hook_index, 0, sizeof(reg_hook_index));
+  memset(reg_hook_table, 0, sizeof(reg_hook_table));
+
+  registers_write_hook_install(ST_LOGIC_CONTROL_REG_BASE, ST_LOGIC_MAX_PROGRAMS, reg_hook_st_control);
+  registers_write_hook_install(ST_LOGIC_VAR_INPUT_REG_BASE, 32, reg_hook_st_var_input);
+  registers_write_hook_install(ST_LOGIC_EXEC_INTERVAL_RW_REG, 2, reg_hook_st_interval);
+}
+
+// Release table slots no address refers to any more
+static void reg_hook_compact(void) {
+  bool used[REG_HOOK_MAX] = {false};
+  for (uint16_t a = 0; a < HOLDING_REGS_SIZE; a++) {
+    if (reg_hook_index[a]) used[reg_hook_index[a] - 1] = true;
+  }
+  for (uint8_t s = 0; s < REG_HOOK_MAX; s++) {
+    if (!used[s]) reg_hook_table[s] = NULL;
+  }
+}
+
+bool registers_write_hook_install(uint16_t addr, uint16_t count, reg_write_hook_t hook) {
+  if (!hook || count == 0 || (uint32_t)addr + count > HOLDING_REGS_SIZE) return false;
+
+  uint8_t slot = 0;
+  for (uint8_t s = 0; s < REG_HOOK_MAX && !slot; s++) {
+    if (reg_hook_table[s] == hook) slot = s + 1;
+  }
+  if (!slot) {
+    reg_hook_compact();
+    for (uint8_t s = 0; s < REG_HOOK_MAX && !slot; s++) {
+      if (reg_hook_table[s] == NULL) slot = s + 1;
+    }
+    if (!slot) return false;
+    reg_hook_table[slot - 1] = hook;
+  }
+
+  for (uint16_t a = addr; a < addr + count; a++) {
+    reg_hook_index[a] = slot;
+    reg_hook_bitmap[a >> 5] |= (1u << (a & 31));
+  }
+  return true;
+}
+
+void registers_write_hook_remove(uint16_t addr, uint16_t count) {
+  for (uint32_t a = addr; a < (uint32_t)addr + count && a < HOLDING_REGS_SIZE; a++) {
+    reg_hook_index[a] = 0;
+    reg_hook_bitmap[a >> 5] &= ~(1u << (a & 31));
+  }
+  reg_hook_compact();
+}
+
 /* ============================================================================
  * UTILITY / INITIALIZATION
  * ============================================================================ */
@@ -357,22 +957,19 @@ void registers_update_st_logic_status(void) {
           // REAL: 2 registers (32-bit float, LSW first per BUG-125)
           uint32_t bits;
           memcpy(&bits, &prog->bytecode.variables[var_idx].real_val, sizeof(float));
-          registers_set_input_register(base_reg,     (uint16_t)(bits & 0xFFFF));        // LSW
-          registers_set_input_register(base_reg + 1, (uint16_t)((bits >> 16) & 0xFFFF)); // MSW
+          registers_set_input_pair(base_reg, (uint16_t)(bits & 0xFFFF), (uint16_t)((bits >> 16) & 0xFFFF));
           export_slot += 2;
 
         } else if (var_type == ST_TYPE_DINT) {
           // DINT: 2 registers (32-bit signed, LSW first per BUG-124)
           int32_t value = prog->bytecode.variables[var_idx].dint_val;
-          registers_set_input_register(base_reg,     (uint16_t)(value & 0xFFFF));        // LSW
-          registers_set_input_register(base_reg + 1, (uint16_t)((value >> 16) & 0xFFFF)); // MSW
+          registers_set_input_pair(base_reg, (uint16_t)(value & 0xFFFF), (uint16_t)((value >> 16) & 0xFFFF));
           export_slot += 2;
 
         } else if (var_type == ST_TYPE_DWORD) {
           // DWORD: 2 registers (32-bit unsigned, LSW first)
           uint32_t value = prog->bytecode.variables[var_idx].dword_val;
-          registers_set_input_register(base_reg,     (uint16_t)(value & 0xFFFF));        // LSW
-          registers_set_input_register(base_reg + 1, (uint16_t)((value >> 16) & 0xFFFF)); // MSW
+          registers_set_input_pair(base_reg, (uint16_t)(value & 0xFFFF), (uint16_t)((value >> 16) & 0xFFFF));
           export_slot += 2;
         }
 
@@ -387,15 +984,13 @@ void registers_update_st_logic_status(void) {
     // PERFORMANCE STATISTICS (v4.1.0) - Input Registers 252-293
     // =========================================================================
 
-    // 252-259: Min Execution Time (µs) - 32-bit, 2 registers per program
+    // 252-259: Min Execution Time (µs) - 32-bit, 2 registers per program (MSW first)
     uint16_t min_reg_offset = ST_LOGIC_MIN_EXEC_TIME_REG_BASE + (prog_id * 2);
-    registers_set_input_register(min_reg_offset,     (uint16_t)(prog->min_execution_us >> 16)); // High word
-    registers_set_input_register(min_reg_offset + 1, (uint16_t)(prog->min_execution_us & 0xFFFF)); // Low word
+    registers_set_input_pair(min_reg_offset, (uint16_t)(prog->min_execution_us >> 16), (uint16_t)(prog->min_execution_us & 0xFFFF));
 
     // 260-267: Max Execution Time (µs) - 32-bit, 2 registers per program
     uint16_t max_reg_offset = ST_LOGIC_MAX_EXEC_TIME_REG_BASE + (prog_id * 2);
-    registers_set_input_register(max_reg_offset,     (uint16_t)(prog->max_execution_us >> 16));
-    registers_set_input_register(max_reg_offset + 1, (uint16_t)(prog->max_execution_us & 0xFFFF));
+    registers_set_input_pair(max_reg_offset, (uint16_t)(prog->max_execution_us >> 16), (uint16_t)(prog->max_execution_us & 0xFFFF));
 
     // 268-275: Avg Execution Time (µs) - Calculated from total_execution_us / execution_count
     uint32_t avg_execution_us = 0;
@@ -403,13 +998,36 @@ void registers_update_st_logic_status(void) {
       avg_execution_us = prog->total_execution_us / prog->execution_count;
     }
     uint16_t avg_reg_offset = ST_LOGIC_AVG_EXEC_TIME_REG_BASE + (prog_id * 2);
-    registers_set_input_register(avg_reg_offset,     (uint16_t)(avg_execution_us >> 16));
-    registers_set_input_register(avg_reg_offset + 1, (uint16_t)(avg_execution_us & 0xFFFF));
+    registers_set_input_pair(avg_reg_offset, (uint16_t)(avg_execution_us >> 16), (uint16_t)(avg_execution_us & 0xFFFF));
 
     // 276-283: Overrun Count - 32-bit, 2 registers per program
     uint16_t overrun_reg_offset = ST_LOGIC_OVERRUN_COUNT_REG_BASE + (prog_id * 2);
-    registers_set_input_register(overrun_reg_offset,     (uint16_t)(prog->overrun_count >> 16));
-    registers_set_input_register(overrun_reg_offset + 1, (uint16_t)(prog->overrun_count & 0xFFFF));
+    registers_set_input_pair(overrun_reg_offset, (uint16_t)(prog->overrun_count >> 16), (uint16_t)(prog->overrun_count & 0xFFFF));
+
+    // =========================================================================
+    // SCAN SCHEDULING (FEAT-154) - Input Registers 294-441
+    // =========================================================================
+
+    // 294-297: Effective scan period (ms)
+    uint32_t period_ms = st_logic_get_period_ms(st_state, prog_id);
+    registers_set_input_register(ST_LOGIC_SCAN_PERIOD_REG_BASE + prog_id,
+                                 (uint16_t)(period_ms > 0xFFFF ? 0xFFFF : period_ms));
+
+    // 298-305: Max start jitter (µs) - 32-bit
+    uint16_t jitter_reg_offset = ST_LOGIC_SCAN_JITTER_MAX_REG_BASE + (prog_id * 2);
+    registers_set_input_pair(jitter_reg_offset, (uint16_t)(prog->scan.jitter_max_us >> 16), (uint16_t)(prog->scan.jitter_max_us & 0xFFFF));
+
+    // 306-313: Skipped scans - 32-bit
+    uint16_t skipped_reg_offset = ST_LOGIC_SCAN_SKIPPED_REG_BASE + (prog_id * 2);
+    registers_set_input_pair(skipped_reg_offset, (uint16_t)(prog->scan.skipped >> 16), (uint16_t)(prog->scan.skipped & 0xFFFF));
+
+    // 314-377 / 378-441: Jitter + overrun histograms (ST_LOGIC_SCAN_BOUNDS_US, last = +Inf)
+    uint16_t jitter_hist = ST_LOGIC_SCAN_JITTER_HIST_REG_BASE + (prog_id * ST_LOGIC_SCAN_BUCKETS * 2);
+    uint16_t overrun_hist = ST_LOGIC_SCAN_OVERRUN_HIST_REG_BASE + (prog_id * ST_LOGIC_SCAN_BUCKETS * 2);
+    for (uint8_t b = 0; b < ST_LOGIC_SCAN_BUCKETS; b++) {
+      registers_set_input_pair(jitter_hist + b * 2, (uint16_t)(prog->scan.jitter_bucket[b] >> 16), (uint16_t)(prog->scan.jitter_bucket[b] & 0xFFFF));
+      registers_set_input_pair(overrun_hist + b * 2, (uint16_t)(prog->scan.overrun_bucket[b] >> 16), (uint16_t)(prog->scan.overrun_bucket[b] & 0xFFFF));
+    }
   }
 
   // =========================================================================
@@ -417,24 +1035,19 @@ void registers_update_st_logic_status(void) {
   // =========================================================================
 
   // 284-285: Global Cycle Min Time (ms)
-  registers_set_input_register(ST_LOGIC_CYCLE_MIN_REG,     (uint16_t)(st_state->cycle_min_ms >> 16));
-  registers_set_input_register(ST_LOGIC_CYCLE_MIN_REG + 1, (uint16_t)(st_state->cycle_min_ms & 0xFFFF));
+  registers_set_input_pair(ST_LOGIC_CYCLE_MIN_REG, (uint16_t)(st_state->cycle_min_ms >> 16), (uint16_t)(st_state->cycle_min_ms & 0xFFFF));
 
   // 286-287: Global Cycle Max Time (ms)
-  registers_set_input_register(ST_LOGIC_CYCLE_MAX_REG,     (uint16_t)(st_state->cycle_max_ms >> 16));
-  registers_set_input_register(ST_LOGIC_CYCLE_MAX_REG + 1, (uint16_t)(st_state->cycle_max_ms & 0xFFFF));
+  registers_set_input_pair(ST_LOGIC_CYCLE_MAX_REG, (uint16_t)(st_state->cycle_max_ms >> 16), (uint16_t)(st_state->cycle_max_ms & 0xFFFF));
 
   // 288-289: Global Cycle Overrun Count
-  registers_set_input_register(ST_LOGIC_CYCLE_OVERRUN_REG,     (uint16_t)(st_state->cycle_overrun_count >> 16));
-  registers_set_input_register(ST_LOGIC_CYCLE_OVERRUN_REG + 1, (uint16_t)(st_state->cycle_overrun_count & 0xFFFF));
+  registers_set_input_pair(ST_LOGIC_CYCLE_OVERRUN_REG, (uint16_t)(st_state->cycle_overrun_count >> 16), (uint16_t)(st_state->cycle_overrun_count & 0xFFFF));
 
   // 290-291: Total Cycles Executed
-  registers_set_input_register(ST_LOGIC_TOTAL_CYCLES_REG,     (uint16_t)(st_state->total_cycles >> 16));
-  registers_set_input_register(ST_LOGIC_TOTAL_CYCLES_REG + 1, (uint16_t)(st_state->total_cycles & 0xFFFF));
+  registers_set_input_pair(ST_LOGIC_TOTAL_CYCLES_REG, (uint16_t)(st_state->total_cycles >> 16), (uint16_t)(st_state->total_cycles & 0xFFFF));
 
   // 292-293: Execution Interval (ms) - Read-only copy
-  registers_set_input_register(ST_LOGIC_EXEC_INTERVAL_RO_REG,     (uint16_t)(st_state->execution_interval_ms >> 16));
-  registers_set_input_register(ST_LOGIC_EXEC_INTERVAL_RO_REG + 1, (uint16_t)(st_state->execution_interval_ms & 0xFFFF));
+  registers_set_input_pair(ST_LOGIC_EXEC_INTERVAL_RO_REG, (uint16_t)(st_state->execution_interval_ms >> 16), (uint16_t)(st_state->execution_interval_ms & 0xFFFF));
 }
 
 /* ============================================================================
@@ -338,6 +338,29 @@ bool registers_persist_group_save_by_id(uint8_t group_id) {
   return registers_persist_group_save(pr->groups[idx].name);
 }
 
+static bool registers_persist_one_changed(const PersistGroup* grp, uint32_t since_seq) {
+  for (uint8_t i = 0; i < grp->reg_count && i < PERSIST_GROUP_MAX_REGS; i++) {
+    uint16_t addr = grp->reg_addresses[i];
+    if (registers_journal_changed_since(REG_BANK_HR, addr, since_seq)) return true;
+    if (grp->reg_values[i] != registers_get_holding_register(addr)) return true;
+  }
+  return false;
+}
+
+bool registers_persist_group_changed_since(uint8_t group_id, uint32_t since_seq) {
+  PersistentRegisterData* pr = &g_persist_config.persist_regs;
+  uint8_t safe_count = get_safe_group_count(pr);  // BUG-140
+
+  if (group_id == 0) {
+    for (uint8_t i = 0; i < safe_count; i++) {
+      if (registers_persist_one_changed(&pr->groups[i], since_seq)) return true;
+    }
+    return false;
+  }
+  if (group_id > safe_count) return true;  // Unknown group: let the save report the error
+  return registers_persist_one_changed(&pr->groups[group_id - 1], since_seq);
+}
+
 bool registers_persist_save_all_groups(void) {
   PersistentRegisterData* pr = &g_persist_config.persist_regs;
   uint8_t safe_count = get_safe_group_count(pr);  // BUG-140
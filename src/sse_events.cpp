@@ -11,7 +11,7 @@
  * - Each client task: parses HTTP, checks auth, streams SSE events
  * - Change detection by polling current values vs last-sent values
  * - Max 3 simultaneous clients (configurable via SSE_MAX_CLIENTS)
- * - Topic-based subscription filtering (counters, timers, registers, system)
+ * - Topic-based subscription filtering (counters, timers, registers, system, modbus)
  * - Configurable register watch lists via query params (hr, ir, coils, di)
  * - TCP keepalive for zombie detection, automatic cleanup
  */
@@ -36,6 +36,7 @@
 #include "build_version.h"
 #include "debug.h"
 #include "rbac.h"
+#include "mb_profile.h"
 
 // External functions from http_server.cpp
 extern void http_server_stat_request(void);
@@ -127,20 +128,19 @@ typedef struct {
   uint8_t  timer_enabled[TIMER_COUNT];
   uint16_t watched_hr[SSE_MAX_WATCH_PER_TYPE];
   uint16_t watched_ir[SSE_MAX_WATCH_PER_TYPE];
-  uint8_t  watched_coils[SSE_MAX_WATCH_PER_TYPE];
-  uint8_t  watched_di[SSE_MAX_WATCH_PER_TYPE];
+  uint16_t watched_coils[SSE_MAX_WATCH_PER_TYPE];
+  uint16_t watched_di[SSE_MAX_WATCH_PER_TYPE];
   SseWatchList watch;
+  reg_journal_reader_t journal;         // Register changes not yet reported (v7.9.8.21)
   uint32_t last_heartbeat_ms;
+  // Modbus master profile (v7.9.8.17): transactions at the last event
+  uint32_t mb_bus_tx[MB_BUS_MAX];
+  uint16_t mb_bus_util[MB_BUS_MAX];     // Utilisation x100 at the last event
+  uint32_t mb_fc_tx[MB_PROFILE_FCS];
+  uint32_t mb_slave_tx[MB_PROFILE_SLAVES + 1];
+  uint32_t last_mb_profile_ms;
 } SseClientState;
 
-// Full-range state for watch_all mode (heap-allocated, ~1.5 KB per client)
-typedef struct {
-  uint16_t hr[HOLDING_REGS_SIZE];     // 256 holding registers
-  uint16_t ir[INPUT_REGS_SIZE];       // 256 input registers
-  uint8_t  coils[256];                // 256 coils
-  uint8_t  di[256];                   // 256 discrete inputs
-} SseWatchAllState;
-
 // Per-client task parameters
 typedef struct {
   int fd;
@@ -241,7 +241,8 @@ static uint8_t sse_parse_query(const char *query, SseWatchList *watch)
     if (strstr(subscribe, "timers"))   topics |= SSE_TOPIC_TIMERS;
     if (strstr(subscribe, "registers")) topics |= SSE_TOPIC_REGISTERS;
     if (strstr(subscribe, "system"))   topics |= SSE_TOPIC_SYSTEM;
-    if (strstr(subscribe, "all"))      { topics = SSE_TOPIC_ALL; is_subscribe_all = true; }
+    if (strstr(subscribe, "modbus"))   topics |= SSE_TOPIC_MODBUS;
+    if (strstr(subscribe, "all"))      { topics |= SSE_TOPIC_ALL; is_subscribe_all = true; }
   }
   if (!topics) { topics = SSE_TOPIC_ALL; is_subscribe_all = true; }
 
@@ -308,6 +309,66 @@ static bool sse_send_event_fd(int fd, const char *event_name, const char *data)
   return sse_sock_send(fd, buf, len);
 }
 
+/* ============================================================================
+ * MODBUS MASTER PROFILE (v7.9.8.17)
+ * ============================================================================ */
+
+static void sse_format_mb_stats(char *buf, size_t len, const char *key, const char *id,
+                                const mb_profile_stats_t *st) {
+  const mb_profile_hist_t *lat = &st->hist[MB_PROFILE_LATENCY];
+  const mb_profile_hist_t *ta = &st->hist[MB_PROFILE_TURNAROUND];
+  const mb_profile_hist_t *wb = &st->hist[MB_PROFILE_WIRE_BYTES];
+  snprintf(buf, len,
+    "{\"%s\":%s,\"transactions\":%lu,\"errors\":%lu,\"latency_avg_us\":%lu,\"latency_max_us\":%lu,"
+    "\"turnaround_avg_us\":%lu,\"turnaround_max_us\":%lu,\"bytes_avg\":%lu}",
+    key, id, (unsigned long)st->transactions, (unsigned long)st->errors,
+    (unsigned long)(lat->count ? lat->sum / lat->count : 0), (unsigned long)lat->max,
+    (unsigned long)(ta->count ? ta->sum / ta->count : 0), (unsigned long)ta->max,
+    (unsigned long)(wb->count ? wb->sum / wb->count : 0));
+}
+
+// Send bus / FC / slave events whose counters moved since the last interval
+static bool sse_send_mb_profile(int fd, SseClientState *state) {
+  char data[256];
+  char id[12];
+
+  for (uint8_t bus = 0; bus < MB_BUS_MAX; bus++) {
+    const mb_profile_bus_t *pb = mb_profile_get_bus(bus);
+    float util = mb_profile_bus_utilisation(bus);
+    uint16_t util_x100 = (uint16_t)(util * 100.0f);
+    if (pb->transactions == state->mb_bus_tx[bus] && util_x100 == state->mb_bus_util[bus]) continue;
+    snprintf(data, sizeof(data),
+      "{\"bus\":%u,\"utilisation\":%.2f,\"occupancy\":%.2f,\"transactions\":%lu,\"bytes\":%llu}",
+      bus, util, mb_profile_bus_occupancy(bus), (unsigned long)pb->transactions,
+      (unsigned long long)pb->bytes_total);
+    if (!sse_send_event_fd(fd, "mb_bus", data)) return false;
+    state->mb_bus_tx[bus] = pb->transactions;
+    state->mb_bus_util[bus] = util_x100;
+  }
+
+  for (uint8_t i = 0; i < MB_PROFILE_FCS; i++) {
+    const mb_profile_stats_t *st = mb_profile_get_fc(i);
+    if (st->transactions == state->mb_fc_tx[i]) continue;
+    uint8_t fc = mb_profile_fc_of_index(i);
+    if (fc) snprintf(id, sizeof(id), "%u", fc);
+    else snprintf(id, sizeof(id), "\"other\"");
+    sse_format_mb_stats(data, sizeof(data), "fc", id, st);
+    if (!sse_send_event_fd(fd, "mb_fc", data)) return false;
+    state->mb_fc_tx[i] = st->transactions;
+  }
+
+  for (uint8_t i = 0; i <= MB_PROFILE_SLAVES; i++) {
+    const mb_profile_slave_t *sl = mb_profile_get_slave(i);
+    if (sl->stats.transactions == state->mb_slave_tx[i]) continue;
+    if (sl->slave_id) snprintf(id, sizeof(id), "%u", sl->slave_id);
+    else snprintf(id, sizeof(id), "\"other\"");
+    sse_format_mb_stats(data, sizeof(data), "slave", id, &sl->stats);
+    if (!sse_send_event_fd(fd, "mb_slave", data)) return false;
+    state->mb_slave_tx[i] = sl->stats.transactions;
+  }
+  return true;
+}
+
 /* ============================================================================
  * SNAPSHOT: Capture current state
  * ============================================================================ */
@@ -344,6 +405,26 @@ static void sse_snapshot_registers(SseClientState *state)
     state->watched_di[i] = registers_get_discrete_input(state->watch.di_addrs[i]);
 }
 
+static const char *const sse_reg_type[4] = { "hr", "ir", "coil", "di" };  // Indexed by reg_bank_t
+
+// Watch-list filter: true if addr is watched and differs from what the client last saw
+static bool sse_watch_changed(SseClientState *state, reg_bank_t bank, uint16_t addr, uint16_t val)
+{
+  const SseWatchList *w = &state->watch;
+  const uint16_t *addrs[4] = { w->hr_addrs, w->ir_addrs, w->coil_addrs, w->di_addrs };
+  const uint8_t counts[4] = { w->hr_count, w->ir_count, w->coil_count, w->di_count };
+  uint16_t *seen[4] = { state->watched_hr, state->watched_ir, state->watched_coils, state->watched_di };
+
+  bool changed = false;
+  for (uint8_t i = 0; i < counts[bank]; i++) {
+    if (addrs[bank][i] == addr && seen[bank][i] != val) {
+      seen[bank][i] = val;
+      changed = true;
+    }
+  }
+  return changed;
+}
+
 /* ============================================================================
  * AUTH: Check Basic Auth credentials from raw HTTP header
  * ============================================================================ */
@@ -510,6 +591,7 @@ static void sse_client_task(void *arg)
     }
     memset(state, 0, sizeof(SseClientState));
     memcpy(&state->watch, &watch, sizeof(SseWatchList));
+    registers_journal_reader_init(&state->journal);
     sse_snapshot_counters(state);
     if (!watch.watch_all) {
       sse_snapshot_registers(state);
@@ -517,28 +599,6 @@ static void sse_client_task(void *arg)
     sse_snapshot_timers(state);
     state->last_heartbeat_ms = millis();
 
-    // Allocate full-range state for watch_all mode (~1.5 KB)
-    SseWatchAllState *all_state = NULL;
-    if (watch.watch_all) {
-      all_state = (SseWatchAllState *)calloc(1, sizeof(SseWatchAllState));
-      if (!all_state) {
-        ESP_LOGE(TAG, "Failed to allocate watch_all state");
-        free(state);
-        goto done;
-      }
-      // Snapshot all registers
-      for (int i = 0; i < HOLDING_REGS_SIZE; i++)
-        all_state->hr[i] = registers_get_holding_register(i);
-      for (int i = 0; i < INPUT_REGS_SIZE; i++)
-        all_state->ir[i] = registers_get_input_register(i);
-      for (int i = 0; i < 256; i++) {
-        all_state->coils[i] = registers_get_coil(i);
-        all_state->di[i] = registers_get_discrete_input(i);
-      }
-      ESP_LOGI(TAG, "watch_all mode: monitoring %d HR + %d IR + 256 coils + 256 DI",
-        HOLDING_REGS_SIZE, INPUT_REGS_SIZE);
-    }
-
     // Main SSE loop
     while (true) {
       vTaskDelay(pdMS_TO_TICKS(sse_cfg_check_interval()));
@@ -546,7 +606,6 @@ static void sse_client_task(void *arg)
       // Check if CLI requested disconnect
       if (reg_slot >= 0 && sse_clients[reg_slot].disconnect_requested) {
         ESP_LOGI(TAG, "SSE client %d disconnect requested via CLI", reg_slot);
-        free(all_state);
         free(state);
         goto done;
       }
@@ -564,7 +623,7 @@ static void sse_client_task(void *arg)
               i + 1, (unsigned long long)val,
               enabled ? "true" : "false",
               (cfg.enabled && cfg.mode_enable != COUNTER_MODE_DISABLED) ? "true" : "false");
-            if (!sse_send_event_fd(fd, "counter", data)) { free(all_state); free(state); goto done; }
+            if (!sse_send_event_fd(fd, "counter", data)) { free(state); goto done; }
             state->counter_values[i] = val;
             state->counter_enabled[i] = enabled;
           }
@@ -591,7 +650,7 @@ static void sse_client_task(void *arg)
                 "{\"id\":%d,\"enabled\":%s,\"mode\":\"%s\",\"output\":%s}",
                 i + 1, cfg.enabled ? "true" : "false", mode_str,
                 output ? "true" : "false");
-              if (!sse_send_event_fd(fd, "timer", data)) { free(all_state); free(state); goto done; }
+              if (!sse_send_event_fd(fd, "timer", data)) { free(state); goto done; }
               state->timer_output[i] = output;
               state->timer_enabled[i] = cfg.enabled;
             }
@@ -599,98 +658,40 @@ static void sse_client_task(void *arg)
         }
       }
 
-      // Register change detection
-      if ((topics & SSE_TOPIC_REGISTERS) && watch.watch_all && all_state) {
-        // watch_all mode: scan ALL addresses
-        char data[64];
-        for (int i = 0; i < HOLDING_REGS_SIZE; i++) {
-          uint16_t val = registers_get_holding_register(i);
-          if (val != all_state->hr[i]) {
-            snprintf(data, sizeof(data), "{\"type\":\"hr\",\"addr\":%d,\"value\":%u}", i, val);
-            if (!sse_send_event_fd(fd, "register", data)) { free(all_state); free(state); goto done; }
-            all_state->hr[i] = val;
-          }
-        }
-        for (int i = 0; i < INPUT_REGS_SIZE; i++) {
-          uint16_t val = registers_get_input_register(i);
-          if (val != all_state->ir[i]) {
-            snprintf(data, sizeof(data), "{\"type\":\"ir\",\"addr\":%d,\"value\":%u}", i, val);
-            if (!sse_send_event_fd(fd, "register", data)) { free(all_state); free(state); goto done; }
-            all_state->ir[i] = val;
-          }
-        }
-        for (int i = 0; i < 256; i++) {
-          uint8_t val = registers_get_coil(i);
-          if (val != all_state->coils[i]) {
-            snprintf(data, sizeof(data), "{\"type\":\"coil\",\"addr\":%d,\"value\":%u}", i, val);
-            if (!sse_send_event_fd(fd, "register", data)) { free(all_state); free(state); goto done; }
-            all_state->coils[i] = val;
-          }
-        }
-        for (int i = 0; i < 256; i++) {
-          uint8_t val = registers_get_discrete_input(i);
-          if (val != all_state->di[i]) {
-            snprintf(data, sizeof(data), "{\"type\":\"di\",\"addr\":%d,\"value\":%u}", i, val);
-            if (!sse_send_event_fd(fd, "register", data)) { free(all_state); free(state); goto done; }
-            all_state->di[i] = val;
-          }
-        }
-      } else if (topics & SSE_TOPIC_REGISTERS) {
-        // Watch-list mode: scan only specified addresses
-        for (int i = 0; i < state->watch.hr_count; i++) {
-          uint16_t addr = state->watch.hr_addrs[i];
-          uint16_t val = registers_get_holding_register(addr);
-          if (val != state->watched_hr[i]) {
-            char data[64];
-            snprintf(data, sizeof(data), "{\"type\":\"hr\",\"addr\":%u,\"value\":%u}", addr, val);
-            if (!sse_send_event_fd(fd, "register", data)) { free(all_state); free(state); goto done; }
-            state->watched_hr[i] = val;
-          }
-        }
-        for (int i = 0; i < state->watch.ir_count; i++) {
-          uint16_t addr = state->watch.ir_addrs[i];
-          uint16_t val = registers_get_input_register(addr);
-          if (val != state->watched_ir[i]) {
-            char data[64];
-            snprintf(data, sizeof(data), "{\"type\":\"ir\",\"addr\":%u,\"value\":%u}", addr, val);
-            if (!sse_send_event_fd(fd, "register", data)) { free(all_state); free(state); goto done; }
-            state->watched_ir[i] = val;
-          }
-        }
-        for (int i = 0; i < state->watch.coil_count; i++) {
-          uint16_t addr = state->watch.coil_addrs[i];
-          uint8_t val = registers_get_coil(addr);
-          if (val != state->watched_coils[i]) {
-            char data[64];
-            snprintf(data, sizeof(data), "{\"type\":\"coil\",\"addr\":%u,\"value\":%u}", addr, val);
-            if (!sse_send_event_fd(fd, "register", data)) { free(all_state); free(state); goto done; }
-            state->watched_coils[i] = val;
-          }
-        }
-        for (int i = 0; i < state->watch.di_count; i++) {
-          uint16_t addr = state->watch.di_addrs[i];
-          uint8_t val = registers_get_discrete_input(addr);
-          if (val != state->watched_di[i]) {
-            char data[64];
-            snprintf(data, sizeof(data), "{\"type\":\"di\",\"addr\":%u,\"value\":%u}", addr, val);
-            if (!sse_send_event_fd(fd, "register", data)) { free(all_state); free(state); goto done; }
-            state->watched_di[i] = val;
-          }
+      // Register change detection (v7.9.8.21): drain the change journal instead of
+      // diffing a shadow copy of all banks. Each changed address is reported once per
+      // tick with its current value; watch-list clients still filter on their shadow
+      if (topics & SSE_TOPIC_REGISTERS) {
+        registers_journal_collect(&state->journal);
+        reg_bank_t bank;
+        uint16_t addr;
+        while (registers_journal_next_dirty(&state->journal, &bank, &addr)) {
+          uint16_t val = registers_journal_value(bank, addr);
+          if (!watch.watch_all && !sse_watch_changed(state, bank, addr, val)) continue;
+          char data[64];
+          snprintf(data, sizeof(data), "{\"type\":\"%s\",\"addr\":%u,\"value\":%u}",
+            sse_reg_type[bank], addr, val);
+          if (!sse_send_event_fd(fd, "register", data)) { free(state); goto done; }
         }
       }
 
-      // Heartbeat keepalive
+      // Modbus master profile (v7.9.8.17)
       uint32_t now = millis();
+      if ((topics & SSE_TOPIC_MODBUS) && now - state->last_mb_profile_ms >= SSE_MODBUS_INTERVAL_MS) {
+        if (!sse_send_mb_profile(fd, state)) { free(state); goto done; }
+        state->last_mb_profile_ms = now;
+      }
+
+      // Heartbeat keepalive
       if (now - state->last_heartbeat_ms >= sse_cfg_heartbeat()) {
         char data[96];
         snprintf(data, sizeof(data),
           "{\"uptime_ms\":%lu,\"heap_free\":%lu,\"sse_clients\":%d}",
           (unsigned long)now, (unsigned long)ESP.getFreeHeap(), (int)sse_active_clients);
-        if (!sse_send_event_fd(fd, "heartbeat", data)) { free(all_state); free(state); goto done; }
+        if (!sse_send_event_fd(fd, "heartbeat", data)) { free(state); goto done; }
         state->last_heartbeat_ms = now;
       }
     }
-    free(all_state);
     free(state);
   }
 
@@ -22,9 +22,6 @@ bool g_mb_success = false;
 uint8_t g_mb_request_count = 0;
 bool g_mb_cache_enabled = true;  // Default: cache dedup active
 
-// Multi-register buffer for MB_SET_REG/MB_GET_REG/MB_READ_HOLDINGS/MB_WRITE_HOLDINGS
-uint16_t g_mb_multi_reg_buf[MB_MULTI_REG_MAX] = {0};
-
 /* ============================================================================
  * HELPER FUNCTION
  * ============================================================================ */
@@ -45,7 +42,7 @@ static bool check_request_limit() {
 
 static bool validate_slave_addr(int32_t slave_id, int32_t address) {
   // Check if async system is initialized
-  if (!mb_async_get_state()->pq_mutex) {
+  if (!mb_async_get_state()->pq_semaphore) {
     g_mb_last_error = MB_NOT_ENABLED;
     g_mb_success = false;
     return false;
@@ -84,29 +81,29 @@ st_value_t st_builtin_mb_read_coil(st_value_t slave_id, st_value_t address) {
   st_value_t result;
   result.bool_val = false;
 
-  if (!check_request_limit()) return result;
+  // v7.9.8.12: addresses refreshed by a poll group are pure cache reads
+  bool polled = mb_async_poll_covers((uint8_t)slave_id.int_val, (uint8_t)MB_REQ_READ_COIL, (uint16_t)address.int_val);
+  if (!polled && !check_request_limit()) return result;
   if (!validate_slave_addr(slave_id.int_val, address.int_val)) return result;
 
   // Cache lookup
-  mb_cache_entry_t *entry = mb_cache_get_or_create(
-    (uint8_t)slave_id.int_val, (uint16_t)address.int_val, (uint8_t)MB_REQ_READ_COIL);
-
-  if (!entry) {
+  mb_cache_entry_t entry;
+  if (!mb_cache_get_or_create(
+      (uint8_t)slave_id.int_val, (uint16_t)address.int_val, (uint8_t)MB_REQ_READ_COIL, &entry)) {
     g_mb_last_error = MB_MAX_REQUESTS_EXCEEDED;
     g_mb_success = false;
     return result;
   }
 
-  // Read cached value (thread-safe)
-  portENTER_CRITICAL(&mb_cache_spinlock);
-  result = entry->value;
-  mb_cache_status_t status = entry->status;
-  g_mb_last_error = entry->last_error;
-  bool expired = cache_entry_expired(entry);
-  portEXIT_CRITICAL(&mb_cache_spinlock);
+  // Copy taken under the cache lock
+  result = entry.value;
+  mb_cache_status_t status = entry.status;
+  g_mb_last_error = entry.last_error;
+  bool expired = cache_entry_expired(&entry);
 
   // Queue background refresh: always if cache disabled/expired, otherwise only if not pending
-  if (!g_mb_cache_enabled || expired || status != MB_CACHE_PENDING) {
+  // (never for polled addresses — the poll group keeps them fresh)
+  if (!polled && (!g_mb_cache_enabled || expired || status != MB_CACHE_PENDING)) {
     mb_async_queue_read(MB_REQ_READ_COIL,
                         (uint8_t)slave_id.int_val,
                         (uint16_t)address.int_val);
@@ -120,26 +117,25 @@ st_value_t st_builtin_mb_read_input(st_value_t slave_id, st_value_t address) {
   st_value_t result;
   result.bool_val = false;
 
-  if (!check_request_limit()) return result;
+  // v7.9.8.12: addresses refreshed by a poll group are pure cache reads
+  bool polled = mb_async_poll_covers((uint8_t)slave_id.int_val, (uint8_t)MB_REQ_READ_INPUT, (uint16_t)address.int_val);
+  if (!polled && !check_request_limit()) return result;
   if (!validate_slave_addr(slave_id.int_val, address.int_val)) return result;
 
-  mb_cache_entry_t *entry = mb_cache_get_or_create(
-    (uint8_t)slave_id.int_val, (uint16_t)address.int_val, (uint8_t)MB_REQ_READ_INPUT);
-
-  if (!entry) {
+  mb_cache_entry_t entry;
+  if (!mb_cache_get_or_create(
+      (uint8_t)slave_id.int_val, (uint16_t)address.int_val, (uint8_t)MB_REQ_READ_INPUT, &entry)) {
     g_mb_last_error = MB_MAX_REQUESTS_EXCEEDED;
     g_mb_success = false;
     return result;
   }
 
-  portENTER_CRITICAL(&mb_cache_spinlock);
-  result = entry->value;
-  mb_cache_status_t status = entry->status;
-  g_mb_last_error = entry->last_error;
-  bool expired = cache_entry_expired(entry);
-  portEXIT_CRITICAL(&mb_cache_spinlock);
+  result = entry.value;
+  mb_cache_status_t status = entry.status;
+  g_mb_last_error = entry.last_error;
+  bool expired = cache_entry_expired(&entry);
 
-  if (!g_mb_cache_enabled || expired || status != MB_CACHE_PENDING) {
+  if (!polled && (!g_mb_cache_enabled || expired || status != MB_CACHE_PENDING)) {
     mb_async_queue_read(MB_REQ_READ_INPUT,
                         (uint8_t)slave_id.int_val,
                         (uint16_t)address.int_val);
@@ -153,26 +149,25 @@ st_value_t st_builtin_mb_read_holding(st_value_t slave_id, st_value_t address) {
   st_value_t result;
   result.int_val = 0;
 
-  if (!check_request_limit()) return result;
+  // v7.9.8.12: addresses refreshed by a poll group are pure cache reads
+  bool polled = mb_async_poll_covers((uint8_t)slave_id.int_val, (uint8_t)MB_REQ_READ_HOLDING, (uint16_t)address.int_val);
+  if (!polled && !check_request_limit()) return result;
   if (!validate_slave_addr(slave_id.int_val, address.int_val)) return result;
 
-  mb_cache_entry_t *entry = mb_cache_get_or_create(
-    (uint8_t)slave_id.int_val, (uint16_t)address.int_val, (uint8_t)MB_REQ_READ_HOLDING);
-
-  if (!entry) {
+  mb_cache_entry_t entry;
+  if (!mb_cache_get_or_create(
+      (uint8_t)slave_id.int_val, (uint16_t)address.int_val, (uint8_t)MB_REQ_READ_HOLDING, &entry)) {
     g_mb_last_error = MB_MAX_REQUESTS_EXCEEDED;
     g_mb_success = false;
     return result;
   }
 
-  portENTER_CRITICAL(&mb_cache_spinlock);
-  result = entry->value;
-  mb_cache_status_t status = entry->status;
-  g_mb_last_error = entry->last_error;
-  bool expired = cache_entry_expired(entry);
-  portEXIT_CRITICAL(&mb_cache_spinlock);
+  result = entry.value;
+  mb_cache_status_t status = entry.status;
+  g_mb_last_error = entry.last_error;
+  bool expired = cache_entry_expired(&entry);
 
-  if (!g_mb_cache_enabled || expired || status != MB_CACHE_PENDING) {
+  if (!polled && (!g_mb_cache_enabled || expired || status != MB_CACHE_PENDING)) {
     mb_async_queue_read(MB_REQ_READ_HOLDING,
                         (uint8_t)slave_id.int_val,
                         (uint16_t)address.int_val);
@@ -186,26 +181,25 @@ st_value_t st_builtin_mb_read_input_reg(st_value_t slave_id, st_value_t address)
   st_value_t result;
   result.int_val = 0;
 
-  if (!check_request_limit()) return result;
+  // v7.9.8.12: addresses refreshed by a poll group are pure cache reads
+  bool polled = mb_async_poll_covers((uint8_t)slave_id.int_val, (uint8_t)MB_REQ_READ_INPUT_REG, (uint16_t)address.int_val);
+  if (!polled && !check_request_limit()) return result;
   if (!validate_slave_addr(slave_id.int_val, address.int_val)) return result;
 
-  mb_cache_entry_t *entry = mb_cache_get_or_create(
-    (uint8_t)slave_id.int_val, (uint16_t)address.int_val, (uint8_t)MB_REQ_READ_INPUT_REG);
-
-  if (!entry) {
+  mb_cache_entry_t entry;
+  if (!mb_cache_get_or_create(
+      (uint8_t)slave_id.int_val, (uint16_t)address.int_val, (uint8_t)MB_REQ_READ_INPUT_REG, &entry)) {
     g_mb_last_error = MB_MAX_REQUESTS_EXCEEDED;
     g_mb_success = false;
     return result;
   }
 
-  portENTER_CRITICAL(&mb_cache_spinlock);
-  result = entry->value;
-  mb_cache_status_t status = entry->status;
-  g_mb_last_error = entry->last_error;
-  bool expired = cache_entry_expired(entry);
-  portEXIT_CRITICAL(&mb_cache_spinlock);
+  result = entry.value;
+  mb_cache_status_t status = entry.status;
+  g_mb_last_error = entry.last_error;
+  bool expired = cache_entry_expired(&entry);
 
-  if (!g_mb_cache_enabled || expired || status != MB_CACHE_PENDING) {
+  if (!polled && (!g_mb_cache_enabled || expired || status != MB_CACHE_PENDING)) {
     mb_async_queue_read(MB_REQ_READ_INPUT_REG,
                         (uint8_t)slave_id.int_val,
                         (uint16_t)address.int_val);
@@ -230,17 +224,8 @@ st_value_t st_builtin_mb_write_coil(st_value_t slave_id, st_value_t address, st_
   bool queued = mb_async_queue_write(MB_REQ_WRITE_COIL,
     (uint8_t)slave_id.int_val, (uint16_t)address.int_val, value);
 
-  // Optimistic cache update
-  if (queued) {
-    mb_cache_entry_t *entry = mb_cache_get_or_create(
-      (uint8_t)slave_id.int_val, (uint16_t)address.int_val, (uint8_t)MB_REQ_READ_COIL);
-    if (entry) {
-      portENTER_CRITICAL(&mb_cache_spinlock);
-      entry->value = value;
-      entry->status = MB_CACHE_PENDING;
-      portEXIT_CRITICAL(&mb_cache_spinlock);
-    }
-  }
+  // Optimistic cache update is done by mb_async_queue_write() — not for a write
+  // skipped as unchanged, which must stay VALID to keep being skipped (v7.9.8.19)
 
   g_mb_success = queued;
   g_mb_last_error = queued ? MB_OK : MB_MAX_REQUESTS_EXCEEDED;
@@ -259,17 +244,8 @@ st_value_t st_builtin_mb_write_holding(st_value_t slave_id, st_value_t address,
   bool queued = mb_async_queue_write(MB_REQ_WRITE_HOLDING,
     (uint8_t)slave_id.int_val, (uint16_t)address.int_val, value);
 
-  // Optimistic cache update
-  if (queued) {
-    mb_cache_entry_t *entry = mb_cache_get_or_create(
-      (uint8_t)slave_id.int_val, (uint16_t)address.int_val, (uint8_t)MB_REQ_READ_HOLDING);
-    if (entry) {
-      portENTER_CRITICAL(&mb_cache_spinlock);
-      entry->value = value;
-      entry->status = MB_CACHE_PENDING;
-      portEXIT_CRITICAL(&mb_cache_spinlock);
-    }
-  }
+  // Optimistic cache update is done by mb_async_queue_write() — not for a write
+  // skipped as unchanged, which must stay VALID to keep being skipped (v7.9.8.19)
 
   g_mb_success = queued;
   g_mb_last_error = queued ? MB_OK : MB_MAX_REQUESTS_EXCEEDED;
@@ -289,7 +265,7 @@ st_value_t st_builtin_mb_read_holdings(st_value_t slave_id, st_value_t address,
   if (!validate_slave_addr(slave_id.int_val, address.int_val)) return result;
 
   int32_t cnt = count.int_val;
-  if (cnt < 1 || cnt > 16) {
+  if (cnt < 1 || cnt > MB_PAYLOAD_REGS) {
     g_mb_last_error = MB_INVALID_ADDRESS;
     g_mb_success = false;
     return result;
@@ -311,28 +287,28 @@ st_value_t st_builtin_mb_read_holdings(st_value_t slave_id, st_value_t address,
   return result;
 }
 
-st_value_t st_builtin_mb_write_holdings(st_value_t slave_id, st_value_t address, st_value_t count) {
+st_value_t st_builtin_mb_write_holdings(st_value_t slave_id, st_value_t address, st_value_t count,
+                                        uint8_t payload) {
   st_value_t result;
   result.bool_val = false;
 
-  if (!check_request_limit()) return result;
-  if (!validate_slave_addr(slave_id.int_val, address.int_val)) return result;
+  bool ok = check_request_limit() && validate_slave_addr(slave_id.int_val, address.int_val);
 
   int32_t cnt = count.int_val;
-  if (cnt < 1 || cnt > 16) {
+  if (ok && (cnt < 1 || cnt > MODBUS_MASTER_MAX_WRITE_REGS ||
+             (int32_t)address.int_val + cnt - 1 > 65535)) {
     g_mb_last_error = MB_INVALID_ADDRESS;
     g_mb_success = false;
-    return result;
+    ok = false;
   }
-
-  if ((int32_t)address.int_val + cnt - 1 > 65535) {
-    g_mb_last_error = MB_INVALID_ADDRESS;
-    g_mb_success = false;
+  if (!ok) {
+    mb_payload_release(payload);
     return result;
   }
 
-  bool queued = mb_async_queue_write_multi(
-    (uint8_t)slave_id.int_val, (uint16_t)address.int_val, (uint8_t)cnt, g_mb_multi_reg_buf);
+  // Hands the payload reference to the request (released by mb_async on failure)
+  bool queued = mb_async_queue_write_payload(
+    (uint8_t)slave_id.int_val, (uint16_t)address.int_val, (uint8_t)cnt, payload);
 
   g_mb_success = queued;
   g_mb_last_error = queued ? MB_OK : MB_MAX_REQUESTS_EXCEEDED;
@@ -7,6 +7,7 @@
 
 #include "st_builtin_persist.h"
 #include "registers_persist.h"
+#include "registers.h"
 #include "config_save.h"
 #include "config_load.h"
 #include "config_struct.h"
@@ -22,6 +23,8 @@ extern PersistConfig g_persist_config;
 
 st_value_t st_builtin_persist_save(st_value_t group_id_arg) {
   static uint32_t last_save_ms = 0;
+  static uint8_t last_group_id = 0xFF;   // 0xFF = nothing saved by SAVE() this boot
+  static uint32_t last_save_seq = 0;     // Journal head just before that snapshot (v7.9.8.21)
   st_value_t result;
   uint8_t group_id = (uint8_t)group_id_arg.int_val;
 
@@ -44,11 +47,22 @@ st_value_t st_builtin_persist_save(st_value_t group_id_arg) {
     return result;
   }
 
+  // Nothing written to the group's registers since our last SAVE: NVS already
+  // holds these values, skip the flash write (register change journal, v7.9.8.21)
+  if (group_id == last_group_id && !registers_persist_group_changed_since(group_id, last_save_seq)) {
+    debug_print("SAVE(");
+    debug_print_uint(group_id);
+    debug_println(") unchanged since last save - NVS write skipped");
+    result.int_val = 0;
+    return result;
+  }
+
   // Step 1: Snapshot group(s) register values
   debug_print("SAVE(");
   debug_print_uint(group_id);
   debug_println("): Snapshotting register groups...");
 
+  uint32_t save_seq = registers_journal_head();
   bool success = registers_persist_group_save_by_id(group_id);
   if (!success) {
     debug_print("SAVE(");
@@ -74,6 +88,8 @@ st_value_t st_builtin_persist_save(st_value_t group_id_arg) {
 
   // Success!
   last_save_ms = now;
+  last_group_id = group_id;
+  last_save_seq = save_seq;
   debug_print("✓ SAVE(");
   debug_print_uint(group_id);
   debug_print(") completed: ");
@@ -767,6 +767,7 @@ st_datatype_t st_builtin_return_type(st_builtin_func_t func_id) {
     case ST_BUILTIN_LOG:
     case ST_BUILTIN_POW:
     case ST_BUILTIN_INT_TO_REAL:
+    case ST_BUILTIN_SCALE:             // BUG-326: SCALE → REAL (was tagged INT)
       return ST_TYPE_REAL;
 
     // Returns BOOL
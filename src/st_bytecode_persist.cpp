@@ -69,8 +69,9 @@ bool st_bytecode_save(uint8_t program_id, const st_bytecode_program_t *bytecode,
   header.exported_var_count = bytecode->exported_var_count;
   header.has_func_registry = (bytecode->func_registry != NULL) ? 1 : 0;
   header.source_crc32 = st_crc32((const uint8_t *)source, source_size);
+  header.unopt_instr_count = bytecode->unoptimized_count;
 
-  // Write header (16 bytes)
+  // Write header (18 bytes)
   if (file.write((uint8_t *)&header, sizeof(header)) != sizeof(header)) {
     file.close();
     SPIFFS.remove(filename);
@@ -237,6 +238,7 @@ bool st_bytecode_load(uint8_t program_id, st_bytecode_program_t *bytecode,
 
   bytecode->instr_count = header.instr_count;
   bytecode->instr_capacity = header.instr_count;
+  bytecode->unoptimized_count = header.unopt_instr_count;
 
   // Read function registry (optional)
   bytecode->func_registry = NULL;
@@ -249,17 +249,23 @@ bool st_compiler_emit_var(st_compiler_t *compiler, st_opcode_t opcode, uint8_t v
   return true;
 }
 
-bool st_compiler_emit_builtin_call(st_compiler_t *compiler, int32_t func_id, uint8_t instance_id) {
+// CALL_BUILTIN or a FEAT-152 superinstruction (same builtin_call operand layout)
+static bool st_compiler_emit_builtin_op(st_compiler_t *compiler, st_opcode_t opcode,
+                                        int32_t func_id, uint8_t instance_id) {
   if (!st_compiler_ensure_space(compiler, 1)) return false;
 
   st_bytecode_instr_t *instr = &compiler->bytecode[compiler->bytecode_ptr++];
-  instr->opcode = ST_OP_CALL_BUILTIN;
+  instr->opcode = opcode;
   instr->arg.builtin_call.func_id_low = (uint8_t)(func_id & 0xFF);  // Only lower byte (max 256 functions)
   instr->arg.builtin_call.instance_id = instance_id;
   instr->arg.builtin_call.padding = 0;  // Explicit zero padding
   return true;
 }
 
+bool st_compiler_emit_builtin_call(st_compiler_t *compiler, int32_t func_id, uint8_t instance_id) {
+  return st_compiler_emit_builtin_op(compiler, ST_OP_CALL_BUILTIN, func_id, instance_id);
+}
+
 /**
  * @brief Emit CALL_USER instruction with function index and FB instance ID
  * @param func_index Function index in registry
@@ -334,7 +340,238 @@ bool st_compiler_compile_expr(st_compiler_t *compiler, st_ast_node_t *node);
 static bool st_compiler_emit_load_symbol(st_compiler_t *compiler, uint8_t var_index);
 static bool st_compiler_emit_store_symbol(st_compiler_t *compiler, uint8_t var_index);
 
+/* ============================================================================
+ * FEAT-149: STATIC TYPE INFERENCE
+ *
+ * Mirrors the VM's runtime type stack: returns the type the VM would push for
+ * an expression, or ST_TYPE_NONE if it can only be known at runtime
+ * (function parameters/locals, user functions, polymorphic builtins, ...).
+ * ============================================================================ */
+
+static st_datatype_t st_compiler_infer_type(st_compiler_t *compiler, st_ast_node_t *node);
+
+// Result type of a numeric promotion (INT → DINT → REAL), NONE for BOOL/DWORD/TIME
+static st_datatype_t st_compiler_promote(st_datatype_t left, st_datatype_t right) {
+  if ((left != ST_TYPE_INT && left != ST_TYPE_DINT && left != ST_TYPE_REAL) ||
+      (right != ST_TYPE_INT && right != ST_TYPE_DINT && right != ST_TYPE_REAL)) {
+    return ST_TYPE_NONE;
+  }
+  if (left == ST_TYPE_REAL || right == ST_TYPE_REAL) return ST_TYPE_REAL;
+  if (left == ST_TYPE_DINT || right == ST_TYPE_DINT) return ST_TYPE_DINT;
+  return ST_TYPE_INT;
+}
+
+static st_datatype_t st_compiler_infer_symbol_type(st_compiler_t *compiler, const char *name) {
+  uint8_t var_index = st_compiler_lookup_symbol(compiler, name);
+  if (var_index == 0xFF) return ST_TYPE_NONE;
+  st_symbol_t *sym = &compiler->symbol_table.symbols[var_index];
+  // Parameters/locals live in the call frame, typed by the caller's value
+  if (sym->is_func_param || sym->is_func_local) return ST_TYPE_NONE;
+  return sym->type;
+}
+
+// Builtins with a fixed numeric return type (polymorphic ones depend on arg types)
+static st_datatype_t st_compiler_infer_call_type(const char *name) {
+  static const char *const real_funcs[] = {
+    "SQRT", "SIN", "COS", "TAN", "EXP", "LN", "LOG", "POW", "INT_TO_REAL", "SCALE"
+  };
+  static const char *const int_funcs[] = {
+    "ROUND", "TRUNC", "FLOOR", "CEIL", "REAL_TO_INT", "BOOL_TO_INT", "DWORD_TO_INT"
+  };
+  for (size_t i = 0; i < sizeof(real_funcs) / sizeof(real_funcs[0]); i++) {
+    if (strcasecmp(name, real_funcs[i]) == 0) return ST_TYPE_REAL;
+  }
+  for (size_t i = 0; i < sizeof(int_funcs) / sizeof(int_funcs[0]); i++) {
+    if (strcasecmp(name, int_funcs[i]) == 0) return ST_TYPE_INT;
+  }
+  if (strcasecmp(name, "CNT_VALUE") == 0 || strcasecmp(name, "CNT_RAW") == 0) return ST_TYPE_DINT;
+  return ST_TYPE_NONE;
+}
+
+static st_datatype_t st_compiler_infer_type(st_compiler_t *compiler, st_ast_node_t *node) {
+  if (!node) return ST_TYPE_NONE;
+
+  switch (node->type) {
+    case ST_AST_LITERAL:
+      switch (node->data.literal.type) {
+        case ST_TYPE_BOOL:  return ST_TYPE_BOOL;
+        case ST_TYPE_INT:   return ST_TYPE_INT;
+        case ST_TYPE_REAL:  return ST_TYPE_REAL;
+        case ST_TYPE_DWORD:
+        case ST_TYPE_DINT:
+        case ST_TYPE_TIME:  return ST_TYPE_DWORD;  // Emitted as PUSH_DWORD
+        default:            return ST_TYPE_NONE;
+      }
+
+    case ST_AST_VARIABLE:
+      return st_compiler_infer_symbol_type(compiler, node->data.variable.var_name);
+
+    case ST_AST_ARRAY_ACCESS:
+      return st_compiler_infer_symbol_type(compiler, node->data.array_access.var_name);
+
+    case ST_AST_BINARY_OP: {
+      st_datatype_t left = st_compiler_infer_type(compiler, node->data.binary_op.left);
+      st_datatype_t right = st_compiler_infer_type(compiler, node->data.binary_op.right);
+      switch (node->data.binary_op.op) {
+        case ST_TOK_PLUS:
+        case ST_TOK_MINUS:
+        case ST_TOK_MUL:
+          return st_compiler_promote(left, right);
+        case ST_TOK_DIV:
+          return (st_compiler_promote(left, right) != ST_TYPE_NONE) ? ST_TYPE_REAL : ST_TYPE_NONE;
+        case ST_TOK_EQ:
+        case ST_TOK_NE:
+        case ST_TOK_LT:
+        case ST_TOK_GT:
+        case ST_TOK_LE:
+        case ST_TOK_GE:
+          return ST_TYPE_BOOL;
+        default:
+          return ST_TYPE_NONE;
+      }
+    }
+
+    case ST_AST_UNARY_OP:
+      if (node->data.unary_op.op == ST_TOK_MINUS &&
+          st_compiler_infer_type(compiler, node->data.unary_op.operand) == ST_TYPE_REAL) {
+        return ST_TYPE_REAL;
+      }
+      return ST_TYPE_NONE;
+
+    case ST_AST_FUNCTION_CALL:
+      // LIMIT(MN, IN, MX) returns the promoted type of its arguments (BUG-121)
+      if (strcasecmp(node->data.function_call.func_name, "LIMIT") == 0 &&
+          node->data.function_call.arg_count == 3) {
+        return st_compiler_promote(
+            st_compiler_promote(st_compiler_infer_type(compiler, node->data.function_call.args[0]),
+                                st_compiler_infer_type(compiler, node->data.function_call.args[1])),
+            st_compiler_infer_type(compiler, node->data.function_call.args[2]));
+      }
+      return st_compiler_infer_call_type(node->data.function_call.func_name);
+
+    default:
+      return ST_TYPE_NONE;
+  }
+}
+
+/**
+ * @brief Emit explicit conversion of top-of-stack from 'from' to 'to'
+ */
+static bool st_compiler_emit_convert(st_compiler_t *compiler, st_datatype_t from, st_datatype_t to) {
+  if (from == to) return true;
+  if (from == ST_TYPE_INT && to == ST_TYPE_DINT) return st_compiler_emit(compiler, ST_OP_CVT_INT_DINT);
+  if (from == ST_TYPE_INT && to == ST_TYPE_REAL) return st_compiler_emit(compiler, ST_OP_CVT_INT_REAL);
+  if (from == ST_TYPE_DINT && to == ST_TYPE_REAL) return st_compiler_emit(compiler, ST_OP_CVT_DINT_REAL);
+  st_compiler_error(compiler, "Unsupported implicit conversion");
+  return false;
+}
+
+/**
+ * @brief Select typed opcode for operator token and operand type
+ * @return Typed opcode, or ST_OP_NOP if the operator has no typed variant
+ */
+static st_opcode_t st_compiler_typed_opcode(st_token_type_t op, st_datatype_t type) {
+  // Opcodes are laid out INT, DINT, REAL per operator
+  int offset = (type == ST_TYPE_INT) ? 0 : (type == ST_TYPE_DINT) ? 1 : 2;
+  switch (op) {
+    case ST_TOK_PLUS:  return (st_opcode_t)(ST_OP_ADD_INT + offset);
+    case ST_TOK_MINUS: return (st_opcode_t)(ST_OP_SUB_INT + offset);
+    case ST_TOK_MUL:   return (st_opcode_t)(ST_OP_MUL_INT + offset);
+    case ST_TOK_DIV:   return ST_OP_DIV_REAL;
+    case ST_TOK_EQ:    return (st_opcode_t)(ST_OP_EQ_INT + offset);
+    case ST_TOK_NE:    return (st_opcode_t)(ST_OP_NE_INT + offset);
+    case ST_TOK_LT:    return (st_opcode_t)(ST_OP_LT_INT + offset);
+    case ST_TOK_GT:    return (st_opcode_t)(ST_OP_GT_INT + offset);
+    case ST_TOK_LE:    return (st_opcode_t)(ST_OP_LE_INT + offset);
+    case ST_TOK_GE:    return (st_opcode_t)(ST_OP_GE_INT + offset);
+    default:           return ST_OP_NOP;
+  }
+}
+
+/**
+ * @brief FEAT-152: Select superinstruction for a builtin call
+ * @param arg_types Output: static type of each argument (LIMIT/SCALE only)
+ * @param conv_type Output: type every argument is converted to (NONE = as compiled)
+ * @return Fused opcode, or ST_OP_CALL_BUILTIN for the generic builtin call
+ */
+static st_opcode_t st_compiler_fused_opcode(st_compiler_t *compiler, st_ast_node_t *node,
+                                            st_builtin_func_t func_id,
+                                            st_datatype_t *arg_types, st_datatype_t *conv_type) {
+  *conv_type = ST_TYPE_NONE;
+#if ST_COMPILER_SUPERINSTRUCTIONS
+  switch (func_id) {
+    // Stateful kernels take the raw argument values, exactly as CALL_BUILTIN
+    case ST_BUILTIN_TON:    return ST_OP_CALL_TON;
+    case ST_BUILTIN_TOF:    return ST_OP_CALL_TOF;
+    case ST_BUILTIN_TP:     return ST_OP_CALL_TP;
+    case ST_BUILTIN_CTU:    return ST_OP_CALL_CTU;
+    case ST_BUILTIN_CTD:    return ST_OP_CALL_CTD;
+    case ST_BUILTIN_R_TRIG: return ST_OP_CALL_R_TRIG;
+    case ST_BUILTIN_F_TRIG: return ST_OP_CALL_F_TRIG;
+
+    // Polymorphic: only when every argument is a known INT/DINT/REAL
+    case ST_BUILTIN_LIMIT:
+    case ST_BUILTIN_SCALE: {
+      st_datatype_t target = ST_TYPE_INT;
+      for (uint8_t i = 0; i < node->data.function_call.arg_count; i++) {
+        arg_types[i] = st_compiler_infer_type(compiler, node->data.function_call.args[i]);
+        target = st_compiler_promote(target, arg_types[i]);
+      }
+      if (target == ST_TYPE_NONE) break;
+      if (func_id == ST_BUILTIN_SCALE) {
+        *conv_type = ST_TYPE_REAL;
+        return ST_OP_SCALE_REAL;
+      }
+      *conv_type = target;
+      return (target == ST_TYPE_INT) ? ST_OP_LIMIT_INT :
+             (target == ST_TYPE_DINT) ? ST_OP_LIMIT_DINT : ST_OP_LIMIT_REAL;
+    }
+
+    default:
+      break;
+  }
+#else
+  (void)compiler; (void)node; (void)func_id; (void)arg_types;
+#endif
+  return ST_OP_CALL_BUILTIN;
+}
+
+/**
+ * @brief Compile binary op with typed opcode if both operand types are known
+ * @return true if handled (check error_count), false to fall back to generic
+ */
+static bool st_compiler_compile_typed_binary_op(st_compiler_t *compiler, st_ast_node_t *node,
+                                                bool *ok) {
+#if ST_COMPILER_TYPED_OPS
+  st_token_type_t op = node->data.binary_op.op;
+  st_datatype_t left = st_compiler_infer_type(compiler, node->data.binary_op.left);
+  st_datatype_t right = st_compiler_infer_type(compiler, node->data.binary_op.right);
+  st_datatype_t target = st_compiler_promote(left, right);
+  if (target == ST_TYPE_NONE) return false;
+  if (op == ST_TOK_DIV) target = ST_TYPE_REAL;  // DIV always computes in REAL
+
+  st_opcode_t opcode = st_compiler_typed_opcode(op, target);
+  if (opcode == ST_OP_NOP) return false;
+
+  *ok = st_compiler_compile_expr(compiler, node->data.binary_op.left) &&
+        st_compiler_emit_convert(compiler, left, target) &&
+        st_compiler_compile_expr(compiler, node->data.binary_op.right) &&
+        st_compiler_emit_convert(compiler, right, target) &&
+        st_compiler_emit(compiler, opcode);
+  return true;
+#else
+  (void)compiler; (void)node; (void)ok;
+  return false;
+#endif
+}
+
 static bool st_compiler_compile_binary_op(st_compiler_t *compiler, st_ast_node_t *node) {
+  // FEAT-149: Typed opcode when operand types are known at compile time
+  bool typed_ok;
+  if (st_compiler_compile_typed_binary_op(compiler, node, &typed_ok)) {
+    return typed_ok;
+  }
+
   // Compile left operand
   if (!st_compiler_compile_expr(compiler, node->data.binary_op.left)) {
     return false;
@@ -588,11 +825,19 @@ bool st_compiler_compile_expr(st_compiler_t *compiler, st_ast_node_t *node) {
         return false;
       }
 
+      // FEAT-152: Superinstruction (fixed arity, arguments converted to its operand type)
+      st_datatype_t arg_types[6];
+      st_datatype_t conv_type;
+      st_opcode_t call_op = st_compiler_fused_opcode(compiler, node, func_id, arg_types, &conv_type);
+
       // Compile arguments (push onto stack)
       for (uint8_t i = 0; i < node->data.function_call.arg_count; i++) {
         if (!st_compiler_compile_expr(compiler, node->data.function_call.args[i])) {
           return false;
         }
+        if (conv_type != ST_TYPE_NONE && !st_compiler_emit_convert(compiler, arg_types[i], conv_type)) {
+          return false;
+        }
       }
 
       // v4.7+: Allocate instance ID for stateful functions
@@ -600,8 +845,10 @@ bool st_compiler_compile_expr(st_compiler_t *compiler, st_ast_node_t *node) {
 
       // Edge detection functions
       if (func_id == ST_BUILTIN_R_TRIG || func_id == ST_BUILTIN_F_TRIG) {
-        if (compiler->edge_instance_count >= 8) {
-          st_compiler_error(compiler, "Too many edge detector instances (max 8)");
+        if (compiler->edge_instance_count >= ST_MAX_EDGE_INSTANCES) {
+          char msg[64];
+          snprintf(msg, sizeof(msg), "Too many edge detector instances (max %d)", ST_MAX_EDGE_INSTANCES);
+          st_compiler_error(compiler, msg);
           return false;
         }
         instance_id = compiler->edge_instance_count++;
@@ -610,8 +857,10 @@ bool st_compiler_compile_expr(st_compiler_t *compiler, st_ast_node_t *node) {
       }
       // Timer functions
       else if (func_id == ST_BUILTIN_TON || func_id == ST_BUILTIN_TOF || func_id == ST_BUILTIN_TP) {
-        if (compiler->timer_instance_count >= 8) {
-          st_compiler_error(compiler, "Too many timer instances (max 8)");
+        if (compiler->timer_instance_count >= ST_MAX_TIMER_INSTANCES) {
+          char msg[64];
+          snprintf(msg, sizeof(msg), "Too many timer instances (max %d)", ST_MAX_TIMER_INSTANCES);
+          st_compiler_error(compiler, msg);
           return false;
         }
         instance_id = compiler->timer_instance_count++;
@@ -620,8 +869,10 @@ bool st_compiler_compile_expr(st_compiler_t *compiler, st_ast_node_t *node) {
       }
       // Counter functions
       else if (func_id == ST_BUILTIN_CTU || func_id == ST_BUILTIN_CTD || func_id == ST_BUILTIN_CTUD) {
-        if (compiler->counter_instance_count >= 8) {
-          st_compiler_error(compiler, "Too many counter instances (max 8)");
+        if (compiler->counter_instance_count >= ST_MAX_COUNTER_INSTANCES) {
+          char msg[64];
+          snprintf(msg, sizeof(msg), "Too many counter instances (max %d)", ST_MAX_COUNTER_INSTANCES);
+          st_compiler_error(compiler, msg);
           return false;
         }
         instance_id = compiler->counter_instance_count++;
@@ -668,8 +919,8 @@ bool st_compiler_compile_expr(st_compiler_t *compiler, st_ast_node_t *node) {
       }
       // Stateless functions (SCALE) use instance_id = 0
 
-      // Emit CALL_BUILTIN instruction with instance ID
-      if (!st_compiler_emit_builtin_call(compiler, (int32_t)func_id, instance_id)) {
+      // Emit CALL_BUILTIN (or superinstruction) with instance ID
+      if (!st_compiler_emit_builtin_op(compiler, call_op, (int32_t)func_id, instance_id)) {
         return false;
       }
 
@@ -692,7 +943,7 @@ bool st_compiler_compile_expr(st_compiler_t *compiler, st_ast_node_t *node) {
           }
 
           if (binding->field_id == 0) {
-            // Q/QU output — already on stack from CALL_BUILTIN
+            // Q/QU output — already on stack from CALL_BUILTIN / CALL_TON etc.
             // DUP to keep it on stack (for possible assignment), then STORE_VAR
             if (!st_compiler_ensure_space(compiler, 2)) return false;
             compiler->bytecode[compiler->bytecode_ptr].opcode = ST_OP_DUP;
@@ -1152,6 +1403,19 @@ static bool st_compiler_compile_for(st_compiler_t *compiler, st_ast_node_t *node
   }
   // Stack: [end_value]
 
+  // FEAT-149: Convert end value once, outside the loop, so the exit test can
+  // use a typed compare (only the loop var is converted per iteration)
+  st_datatype_t var_type = st_compiler_infer_symbol_type(compiler, node->data.for_stmt.var_name);
+  st_datatype_t cmp_type = ST_TYPE_NONE;
+#if ST_COMPILER_TYPED_OPS
+  st_datatype_t end_type = st_compiler_infer_type(compiler, node->data.for_stmt.end);
+  cmp_type = st_compiler_promote(end_type, var_type);
+  if (cmp_type != ST_TYPE_NONE && !st_compiler_emit_convert(compiler, end_type, cmp_type)) {
+    compiler->loop_depth--;
+    return false;
+  }
+#endif
+
   // Loop start address
   uint16_t loop_start = st_compiler_current_addr(compiler);
 
@@ -1170,7 +1434,12 @@ static bool st_compiler_compile_for(st_compiler_t *compiler, st_ast_node_t *node
   // Compare: var > end (exit condition for TO loops)
   // Stack: [end_dup, var]
   // LT pops: right=var, left=end_dup → Result: end_dup < var (which is var > end_dup)
-  if (!st_compiler_emit(compiler, ST_OP_LT)) {
+  if (cmp_type != ST_TYPE_NONE) {
+    if (!st_compiler_emit_convert(compiler, var_type, cmp_type) ||
+        !st_compiler_emit(compiler, st_compiler_typed_opcode(ST_TOK_LT, cmp_type))) {
+      return false;
+    }
+  } else if (!st_compiler_emit(compiler, ST_OP_LT)) {
     return false;
   }
   // Stack: [end_value, (var > end)]
@@ -1779,6 +2048,7 @@ st_bytecode_program_t *st_compiler_compile(st_compiler_t *compiler, st_program_t
   }
   memcpy(bytecode->instructions, compiler->bytecode, count * sizeof(st_bytecode_instr_t));
   bytecode->instr_capacity = count;
+  bytecode->unoptimized_count = 0;  // FEAT-151: Set by st_optimizer_run()
   free(compiler->bytecode);
   compiler->bytecode = NULL;
 
@@ -2007,6 +2277,50 @@ const char *st_opcode_to_string(st_opcode_t opcode) {
     case ST_OP_LOAD_FB_FIELD:   return "LOAD_FB_FIELD";
     case ST_OP_NOP:             return "NOP";
     case ST_OP_HALT:            return "HALT";
+    // FEAT-149: Statically typed opcodes
+    case ST_OP_ADD_INT:         return "ADD_INT";
+    case ST_OP_ADD_DINT:        return "ADD_DINT";
+    case ST_OP_ADD_REAL:        return "ADD_REAL";
+    case ST_OP_SUB_INT:         return "SUB_INT";
+    case ST_OP_SUB_DINT:        return "SUB_DINT";
+    case ST_OP_SUB_REAL:        return "SUB_REAL";
+    case ST_OP_MUL_INT:         return "MUL_INT";
+    case ST_OP_MUL_DINT:        return "MUL_DINT";
+    case ST_OP_MUL_REAL:        return "MUL_REAL";
+    case ST_OP_DIV_REAL:        return "DIV_REAL";
+    case ST_OP_EQ_INT:          return "EQ_INT";
+    case ST_OP_EQ_DINT:         return "EQ_DINT";
+    case ST_OP_EQ_REAL:         return "EQ_REAL";
+    case ST_OP_NE_INT:          return "NE_INT";
+    case ST_OP_NE_DINT:         return "NE_DINT";
+    case ST_OP_NE_REAL:         return "NE_REAL";
+    case ST_OP_LT_INT:          return "LT_INT";
+    case ST_OP_LT_DINT:         return "LT_DINT";
+    case ST_OP_LT_REAL:         return "LT_REAL";
+    case ST_OP_GT_INT:          return "GT_INT";
+    case ST_OP_GT_DINT:         return "GT_DINT";
+    case ST_OP_GT_REAL:         return "GT_REAL";
+    case ST_OP_LE_INT:          return "LE_INT";
+    case ST_OP_LE_DINT:         return "LE_DINT";
+    case ST_OP_LE_REAL:         return "LE_REAL";
+    case ST_OP_GE_INT:          return "GE_INT";
+    case ST_OP_GE_DINT:         return "GE_DINT";
+    case ST_OP_GE_REAL:         return "GE_REAL";
+    case ST_OP_CVT_INT_DINT:    return "CVT_INT_DINT";
+    case ST_OP_CVT_INT_REAL:    return "CVT_INT_REAL";
+    case ST_OP_CVT_DINT_REAL:   return "CVT_DINT_REAL";
+    case ST_OP_INC_VAR:         return "INC_VAR";
+    case ST_OP_CALL_TON:        return "CALL_TON";
+    case ST_OP_CALL_TOF:        return "CALL_TOF";
+    case ST_OP_CALL_TP:         return "CALL_TP";
+    case ST_OP_CALL_CTU:        return "CALL_CTU";
+    case ST_OP_CALL_CTD:        return "CALL_CTD";
+    case ST_OP_CALL_R_TRIG:     return "CALL_R_TRIG";
+    case ST_OP_CALL_F_TRIG:     return "CALL_F_TRIG";
+    case ST_OP_LIMIT_INT:       return "LIMIT_INT";
+    case ST_OP_LIMIT_DINT:      return "LIMIT_DINT";
+    case ST_OP_LIMIT_REAL:      return "LIMIT_REAL";
+    case ST_OP_SCALE_REAL:      return "SCALE_REAL";
     default:                    return "UNKNOWN";
   }
 }
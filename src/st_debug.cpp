@@ -7,6 +7,7 @@
 
 #include "st_debug.h"
 #include "st_logic_config.h"
+#include "st_compiler.h"
 #include "debug.h"
 #include <string.h>
 #include <stdlib.h>
@@ -469,6 +470,21 @@ void st_debug_print_instruction(st_debug_state_t *debug, void *prog_ptr) {
     case ST_OP_CALL_BUILTIN: debug_print("CALL_BUILTIN func="); debug_print_uint(instr->arg.builtin_call.func_id_low); debug_println(""); break;
     case ST_OP_NOP:          debug_println("NOP"); break;
     case ST_OP_HALT:         debug_println("HALT"); break;
-    default:                 debug_print("OPCODE "); debug_print_uint(instr->opcode); debug_println(""); break;
+    case ST_OP_INC_VAR:      debug_print("INC_VAR "); debug_print_uint(instr->arg.var_inc.var_index); debug_printf(" %+d", instr->arg.var_inc.delta); debug_println(""); break;
+    case ST_OP_CALL_TON:
+    case ST_OP_CALL_TOF:
+    case ST_OP_CALL_TP:
+    case ST_OP_CALL_CTU:
+    case ST_OP_CALL_CTD:
+    case ST_OP_CALL_R_TRIG:
+    case ST_OP_CALL_F_TRIG:  debug_print(st_opcode_to_string(instr->opcode)); debug_print(" inst="); debug_print_uint(instr->arg.builtin_call.instance_id); debug_println(""); break;
+    default:
+      // FEAT-149: Typed opcodes carry no argument
+      if (instr->opcode > ST_OP_HALT && instr->opcode < ST_OP_COUNT) {
+        debug_println(st_opcode_to_string(instr->opcode));
+      } else {
+        debug_print("OPCODE "); debug_print_uint(instr->opcode); debug_println("");
+      }
+      break;
   }
 }
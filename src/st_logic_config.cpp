@@ -7,6 +7,7 @@
 #include "st_logic_engine.h"   // st_logic_lock/unlock_variables
 #include "st_parser.h"
 #include "st_compiler.h"
+#include "st_optimizer.h"  // FEAT-151: Bytecode optimizer
 #include "st_debug.h"  // FEAT-008: Reset debug state on delete/compile
 #include "register_allocator.h"
 #include "ir_pool_manager.h"  // v5.1.0 - IR pool management
@@ -43,6 +44,22 @@ st_logic_engine_state_t *st_logic_get_state(void) {
   return &g_logic_state;
 }
 
+// FEAT-151: Run the bytecode optimizer (build option ST_OPTIMIZER_ENABLED)
+static void st_logic_optimize(uint8_t program_id, st_bytecode_program_t *bytecode,
+                              st_line_map_t *line_map) {
+#if ST_OPTIMIZER_ENABLED
+  st_optimizer_stats_t stats;
+  st_optimizer_run(bytecode, line_map, &stats);
+  debug_printf("[OPT] Logic%d: %u -> %u instr (fold=%u inc=%u dead=%u jmp=%u unreach=%u)\n",
+               program_id + 1, stats.instr_before, stats.instr_after, stats.folded,
+               stats.fused, stats.dead_stores, stats.jumps_threaded, stats.unreachable);
+#else
+  (void)program_id;
+  (void)bytecode;
+  (void)line_map;
+#endif
+}
+
 /* ============================================================================
  * INITIALIZATION
  * ============================================================================ */
@@ -51,6 +68,8 @@ void st_logic_init(st_logic_engine_state_t *state) {
   memset(state, 0, sizeof(*state));
   state->enabled = 1;
   state->execution_interval_ms = 10;  // Run every 10ms by default
+  state->parallel = 1;                 // FEAT-153: Overridden by MODULE_FLAG_ST_PARALLEL_DISABLED
+  memset(state->lane, 0xFF, sizeof(state->lane));
 
   // Initialize each program
   for (int i = 0; i < ST_LOGIC_MAX_PROGRAMS; i++) {
@@ -324,6 +343,9 @@ static bool st_logic_compile_monolithic(st_logic_engine_state_t *state, uint8_t
   // FEAT-008: Set program_id in line map for source-level breakpoints
   g_line_map.program_id = program_id;
 
+  // FEAT-151: Peephole/constant-folding pass before the bytecode is cached
+  st_logic_optimize(program_id, &prog->bytecode, g_line_map.valid ? &g_line_map : NULL);
+
   // v5.1.0 - Allocate IR pool for EXPORT variables
   // Free old allocation if recompiling
   if (prog->ir_pool_offset != 65535) {
@@ -708,6 +730,7 @@ bool st_logic_compile_chunked(st_logic_engine_state_t *state, uint8_t program_id
 
     prog->bytecode.instr_count = total_instr;
     prog->bytecode.instr_capacity = total_instr;
+    prog->bytecode.unoptimized_count = 0;
 
     // Copy symbol table to bytecode
     prog->bytecode.var_count = g_compiler->symbol_table.count;
@@ -754,6 +777,9 @@ bool st_logic_compile_chunked(st_logic_engine_state_t *state, uint8_t program_id
     prog->execution_count = 0;
     prog->error_count = 0;
 
+    // FEAT-151: Chunk line maps are not merged, so there is nothing to relocate
+    st_logic_optimize(program_id, &prog->bytecode, NULL);
+
     // IR pool allocation
     if (prog->ir_pool_offset != 65535) {
       ir_pool_free(state, program_id);
@@ -894,6 +920,9 @@ bool st_logic_delete(st_logic_engine_state_t *state, uint8_t program_id) {
   // Invalidate bytecode cache
   st_bytecode_invalidate(program_id);
 
+  // v7.9.8.5: Free the slot's long-lived VM (deferred to the next engine cycle)
+  st_logic_release_vm(program_id);
+
   // Free pool allocations
   st_logic_pool_free(state, program_id);
   ir_pool_free(state, program_id);  // v5.1.0 - Free IR pool
@@ -1011,6 +1040,7 @@ void st_logic_reset_stats(st_logic_engine_state_t *state, uint8_t program_id) {
       prog->overrun_count = 0;
       prog->execution_count = 0;
       prog->error_count = 0;
+      memset(&prog->scan, 0, sizeof(prog->scan));  // FEAT-154
     }
   } else if (program_id < ST_LOGIC_MAX_PROGRAMS) {
     // Reset single program
@@ -1021,9 +1051,34 @@ void st_logic_reset_stats(st_logic_engine_state_t *state, uint8_t program_id) {
     prog->overrun_count = 0;
     prog->execution_count = 0;
     prog->error_count = 0;
+    memset(&prog->scan, 0, sizeof(prog->scan));  // FEAT-154
   }
 }
 
+uint32_t st_logic_get_period_ms(const st_logic_engine_state_t *state, uint8_t program_id) {
+  if (program_id >= ST_LOGIC_MAX_PROGRAMS) return state->execution_interval_ms;
+  uint16_t period = state->programs[program_id].period_ms;
+  return period ? period : state->execution_interval_ms;
+}
+
+bool st_logic_set_schedule(st_logic_engine_state_t *state, uint8_t program_id,
+                           uint16_t period_ms, uint8_t priority, uint8_t policy) {
+  if (program_id >= ST_LOGIC_MAX_PROGRAMS) return false;
+  if (period_ms != 0 && (period_ms < ST_LOGIC_SCAN_MIN_PERIOD_MS || period_ms > ST_LOGIC_SCAN_MAX_PERIOD_MS)) {
+    return false;
+  }
+  if (policy != ST_LOGIC_SCAN_SKIP && policy != ST_LOGIC_SCAN_CATCH_UP) return false;
+
+  st_logic_program_config_t *prog = &state->programs[program_id];
+  if (prog->period_ms != period_ms) {
+    prog->next_due_us = 0;  // Re-anchor the grid on the next scan
+  }
+  prog->period_ms = period_ms;
+  prog->priority = priority;
+  prog->scan_policy = policy;
+  return true;
+}
+
 /**
  * @brief Reset global cycle statistics (v4.1.0)
  * @param state Logic engine state
@@ -1039,6 +1094,11 @@ void st_logic_reset_cycle_stats(st_logic_engine_state_t *state) {
  * PERSISTENCE (SPIFFS STORAGE)
  * ============================================================================ */
 
+// FEAT-154: /logic_N.dat = enabled(1) + size(4) + source + schedule trailer:
+// magic(1) + period_ms(2, LE) + priority(1) + scan_policy(1)
+#define ST_LOGIC_FILE_TRAILER_MAGIC 0xA5
+#define ST_LOGIC_FILE_TRAILER_SIZE  5
+
 /**
  * @brief Save ST Logic programs to SPIFFS (unlimited size)
  * @return true if successful
@@ -1100,6 +1160,14 @@ bool st_logic_save_to_nvs(void) {
     if (source_code && prog->source_size > 0 && prog->source_size <= ST_LOGIC_POOL_SIZE) {
       file.write((uint8_t*)source_code, prog->source_size);
     }
+
+    // FEAT-154: Schedule trailer (older files end after the source)
+    uint8_t trailer[ST_LOGIC_FILE_TRAILER_SIZE] = {
+      ST_LOGIC_FILE_TRAILER_MAGIC,
+      (uint8_t)(prog->period_ms & 0xFF), (uint8_t)(prog->period_ms >> 8),
+      prog->priority, prog->scan_policy
+    };
+    file.write(trailer, sizeof(trailer));
     file.close();
 
     if (dbg->config_save) {
@@ -1197,6 +1265,17 @@ bool st_logic_load_from_nvs(void) {
       // Read source code from file into pool
       file.read((uint8_t*)&state->source_pool[prog->source_offset], prog->source_size);
       prog->compiled = 0;  // Mark as needing recompilation
+
+      // FEAT-154: Optional schedule trailer
+      uint8_t trailer[ST_LOGIC_FILE_TRAILER_SIZE];
+      if (file.available() >= (int)sizeof(trailer) &&
+          file.read(trailer, sizeof(trailer)) == sizeof(trailer) &&
+          trailer[0] == ST_LOGIC_FILE_TRAILER_MAGIC) {
+        if (!st_logic_set_schedule(state, i, (uint16_t)(trailer[1] | (trailer[2] << 8)),
+                                   trailer[3], trailer[4])) {
+          st_logic_set_schedule(state, i, 0, 0, ST_LOGIC_SCAN_SKIP);
+        }
+      }
       file.close();
 
       // Try loading cached bytecode first (avoids 36-94 KB peak heap)
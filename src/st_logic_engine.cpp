@@ -13,11 +13,17 @@
 #include "st_stateful.h"  // BUG-153 FIX: For cycle_time_ms update
 #include "st_builtin_modbus.h"  // BUG-133 FIX: For g_mb_request_count reset
 #include "st_debug.h"  // FEAT-008: Debugger support
+#include "st_logic_parallel.h"  // FEAT-153: Dependency analysis / lanes
 #include "config_struct.h"
 #include "constants.h"
 #include "debug.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <esp_timer.h>
 
 /* ============================================================================
  * BUG-038 FIX: Spinlock for ST variable access synchronization
@@ -42,6 +48,57 @@ static portMUX_TYPE st_var_spinlock = portMUX_INITIALIZER_UNLOCKED;
  * PROGRAM EXECUTION
  * ============================================================================ */
 
+// v7.9.8.5: One long-lived VM per program slot (heap, allocated on first run).
+// Replaces the st_vm_t on the stack + st_vm_init() memset of the whole struct
+// (~2 KB) per program per cycle; st_vm_begin_cycle() only resets pc/sp/flags.
+static st_vm_t *st_program_vm[ST_LOGIC_MAX_PROGRAMS] = {nullptr};
+
+static st_vm_t *st_logic_get_vm(uint8_t program_id) {
+  if (st_program_vm[program_id] == nullptr) {
+    st_vm_t *vm = (st_vm_t*)malloc(sizeof(st_vm_t));
+    if (vm == nullptr) return nullptr;
+    st_vm_init(vm, NULL);
+    st_program_vm[program_id] = vm;
+  }
+  return st_program_vm[program_id];
+}
+
+// Release is requested from the HTTP/CLI tasks while a scan may be running on
+// the loop task or st_worker: only mark the slot, st_logic_reclaim_vms() frees
+// it at the start of the next engine cycle (after the previous worker barrier)
+static volatile bool st_program_vm_release[ST_LOGIC_MAX_PROGRAMS] = {false};
+
+void st_logic_release_vm(uint8_t program_id) {
+  if (program_id >= ST_LOGIC_MAX_PROGRAMS) return;
+  st_program_vm_release[program_id] = true;
+}
+
+static void st_logic_reclaim_vms(void) {
+  for (uint8_t id = 0; id < ST_LOGIC_MAX_PROGRAMS; id++) {
+    if (!st_program_vm_release[id]) continue;
+    st_program_vm_release[id] = false;
+    free(st_program_vm[id]);
+    st_program_vm[id] = nullptr;
+  }
+}
+
+// FEAT-154: Histogram bucket (non-cumulative, last bucket = +Inf)
+static const uint32_t st_scan_bounds_us[ST_LOGIC_SCAN_BUCKETS - 1] = ST_LOGIC_SCAN_BOUNDS_US;
+
+static void st_logic_scan_record(uint32_t *buckets, uint32_t us) {
+  uint8_t b = 0;
+  while (b < ST_LOGIC_SCAN_BUCKETS - 1 && us > st_scan_bounds_us[b]) b++;
+  buckets[b]++;
+}
+
+// New scan: reset execution state and load current variable values (inputs)
+static void st_logic_begin_cycle(st_vm_t *vm, st_logic_program_config_t *prog) {
+  st_vm_begin_cycle(vm, &prog->bytecode);
+  portENTER_CRITICAL(&st_var_spinlock);
+  memcpy(vm->variables, prog->bytecode.variables, vm->var_count * sizeof(st_value_t));
+  portEXIT_CRITICAL(&st_var_spinlock);
+}
+
 bool st_logic_execute_program(st_logic_engine_state_t *state, uint8_t program_id) {
   st_logic_program_config_t *prog = st_logic_get_program(state, program_id);
   if (!prog || !prog->compiled || !prog->enabled) return false;
@@ -54,8 +111,13 @@ bool st_logic_execute_program(st_logic_engine_state_t *state, uint8_t program_id
     return true;  // Not an error, just paused
   }
 
-  // Create VM and initialize with bytecode
-  st_vm_t vm;
+  // v7.9.8.5: Reuse this slot's long-lived VM
+  st_vm_t *vm = st_logic_get_vm(program_id);
+  if (!vm) {
+    prog->error_count++;
+    snprintf(prog->last_error, sizeof(prog->last_error), "VM allocation failed");
+    return false;
+  }
 
   // FEAT-008: Use shared debug VM if this program owns it (preserves PC/stack between steps)
   if (debug->owns_debug_vm && g_shared_debug_vm.valid &&
@@ -63,17 +125,17 @@ bool st_logic_execute_program(st_logic_engine_state_t *state, uint8_t program_id
       g_shared_debug_vm.program_id == program_id &&
       (debug->mode == ST_DEBUG_STEP || debug->mode == ST_DEBUG_RUN)) {
     // Restore VM state from shared debug VM
-    memcpy(&vm, g_shared_debug_vm.vm, sizeof(st_vm_t));
+    memcpy(vm, g_shared_debug_vm.vm, sizeof(st_vm_t));
     // Re-link program pointer (was cleared by memcpy or might be stale)
-    vm.program = &prog->bytecode;
+    vm->program = &prog->bytecode;
 
     // If VM was halted but user wants to continue/step, reset to start new cycle
-    if (vm.halted) {
-      st_vm_init(&vm, &prog->bytecode);
+    if (vm->halted) {
+      st_logic_begin_cycle(vm, prog);
     }
   } else {
-    // Normal initialization
-    st_vm_init(&vm, &prog->bytecode);
+    // Normal scan start
+    st_logic_begin_cycle(vm, prog);
 
     // If starting debug, allocate and claim the shared VM
     if (debug->mode == ST_DEBUG_STEP || debug->mode == ST_DEBUG_RUN) {
@@ -95,75 +157,81 @@ bool st_logic_execute_program(st_logic_engine_state_t *state, uint8_t program_id
   // BUG-153 FIX: Update cycle time in stateful storage before execution
   if (prog->bytecode.stateful) {
     st_stateful_storage_t *stateful = (st_stateful_storage_t*)prog->bytecode.stateful;
-    stateful->cycle_time_ms = state->execution_interval_ms;
+    stateful->cycle_time_ms = st_logic_get_period_ms(state, program_id);  // FEAT-154
   }
 
   // FEAT-003: Set function registry for user-defined function calls
   if (prog->bytecode.func_registry) {
-    vm.func_registry = prog->bytecode.func_registry;
+    vm->func_registry = prog->bytecode.func_registry;
   }
 
   // BUG-007 FIX: Add timing wrapper for execution monitoring (use micros for precision)
   uint32_t start_us = micros();
 
-  // FEAT-008: Debug-aware execution loop
+  // FEAT-008: Debug-aware execution loop (only while a debugger is attached)
   bool success = true;
   uint32_t steps = 0;
   const uint32_t max_steps = 10000;
 
-  while (!vm.halted && !vm.error) {
-    // Max steps check (safety)
-    if (steps >= max_steps) {
-      snprintf(vm.error_msg, sizeof(vm.error_msg), "Max steps exceeded (%u)", max_steps);
-      vm.error = 1;
-      success = false;
-      break;
-    }
+  if (debug->mode == ST_DEBUG_OFF) {
+    // v7.9.8.3: No debugger attached - run the whole cycle with threaded dispatch
+    uint32_t steps_before = vm->step_count;
+    success = st_vm_run_fast(vm, max_steps);
+    steps = vm->step_count - steps_before;
+  } else {
+    // FEAT-008: Per-step loop with breakpoint/step checks
+    while (!vm->halted && !vm->error) {
+      // Max steps check (safety)
+      if (steps >= max_steps) {
+        snprintf(vm->error_msg, sizeof(vm->error_msg), "Max steps exceeded (%u)", max_steps);
+        vm->error = 1;
+        success = false;
+        break;
+      }
 
-    // FEAT-008: Check for breakpoint BEFORE executing instruction
-    if (debug->mode != ST_DEBUG_OFF && st_debug_check_breakpoint(debug, vm.pc)) {
-      // Hit a breakpoint - pause and save snapshot
-      st_debug_save_snapshot(debug, &vm, ST_DEBUG_REASON_BREAKPOINT);
-      debug->hit_breakpoint_pc = vm.pc;
-      debug->breakpoints_hit_count++;
-      debug->mode = ST_DEBUG_PAUSED;
-      break;  // Exit execution loop
-    }
+      // FEAT-008: Check for breakpoint BEFORE executing instruction
+      if (st_debug_check_breakpoint(debug, vm->pc)) {
+        // Hit a breakpoint - pause and save snapshot
+        st_debug_save_snapshot(debug, vm, ST_DEBUG_REASON_BREAKPOINT);
+        debug->hit_breakpoint_pc = vm->pc;
+        debug->breakpoints_hit_count++;
+        debug->mode = ST_DEBUG_PAUSED;
+        break;  // Exit execution loop
+      }
 
-    // Execute one instruction
-    if (!st_vm_step(&vm)) {
-      break;  // Halted or error
-    }
+      // Execute one instruction
+      if (!st_vm_step(vm)) {
+        break;  // Halted or error
+      }
 
-    steps++;
+      steps++;
 
-    // FEAT-008: Only count debugged steps when debugging is active
-    if (debug->mode != ST_DEBUG_OFF) {
       debug->total_steps_debugged++;
-    }
 
-    // FEAT-008: Single-step mode - pause after one instruction
-    if (debug->mode == ST_DEBUG_STEP) {
-      st_debug_save_snapshot(debug, &vm, ST_DEBUG_REASON_STEP);
-      debug->mode = ST_DEBUG_PAUSED;
-      break;  // Exit execution loop
+      // FEAT-008: Single-step mode - pause after one instruction
+      if (debug->mode == ST_DEBUG_STEP) {
+        st_debug_save_snapshot(debug, vm, ST_DEBUG_REASON_STEP);
+        debug->mode = ST_DEBUG_PAUSED;
+        break;  // Exit execution loop
+      }
     }
   }
+  prog->last_instructions = steps;  // v7.9.8.3: For instructions/s in stats
 
   // FEAT-008: Save snapshot on halt or error (if debugging)
   if (debug->mode != ST_DEBUG_OFF && debug->mode != ST_DEBUG_PAUSED) {
-    if (vm.error) {
-      st_debug_save_snapshot(debug, &vm, ST_DEBUG_REASON_ERROR);
+    if (vm->error) {
+      st_debug_save_snapshot(debug, vm, ST_DEBUG_REASON_ERROR);
       debug->mode = ST_DEBUG_PAUSED;
-    } else if (vm.halted) {
-      st_debug_save_snapshot(debug, &vm, ST_DEBUG_REASON_HALT);
+    } else if (vm->halted) {
+      st_debug_save_snapshot(debug, vm, ST_DEBUG_REASON_HALT);
       debug->mode = ST_DEBUG_PAUSED;
     }
   }
 
   // FEAT-008: Save VM state to shared debug VM for next step
   if (debug->mode == ST_DEBUG_PAUSED && debug->owns_debug_vm && g_shared_debug_vm.vm != nullptr) {
-    memcpy(g_shared_debug_vm.vm, &vm, sizeof(st_vm_t));
+    memcpy(g_shared_debug_vm.vm, vm, sizeof(st_vm_t));
     g_shared_debug_vm.valid = true;
     g_shared_debug_vm.program_id = program_id;
   } else if (debug->mode == ST_DEBUG_OFF && debug->owns_debug_vm) {
@@ -173,7 +241,7 @@ bool st_logic_execute_program(st_logic_engine_state_t *state, uint8_t program_id
   }
 
   // Check final state
-  if (vm.error) {
+  if (vm->error) {
     success = false;
   }
 
@@ -203,14 +271,26 @@ bool st_logic_execute_program(st_logic_engine_state_t *state, uint8_t program_id
   }
 
   // Track overruns (execution time > target interval)
-  if (elapsed_ms > state->execution_interval_ms) {
+  if (elapsed_ms > st_logic_get_period_ms(state, program_id)) {
     prog->overrun_count++;
   }
 
+  // FEAT-154: Scan finished after the end of its period
+  if (prog->deadline_us != 0) {
+    int64_t late_us = esp_timer_get_time() - prog->deadline_us;
+    if (late_us > 0) {
+      st_logic_scan_record(prog->scan.overrun_bucket,
+                           late_us > (int64_t)UINT32_MAX ? UINT32_MAX : (uint32_t)late_us);
+      prog->scan.overrun_count++;
+      prog->scan.overrun_sum_us += (uint64_t)late_us;
+    }
+    prog->deadline_us = 0;
+  }
+
   // BUG-106 FIX: Check for errors BEFORE copying variables back
-  if (!success || vm.error) {
+  if (!success || vm->error) {
     prog->error_count++;
-    snprintf(prog->last_error, sizeof(prog->last_error), "%s", vm.error_msg);
+    snprintf(prog->last_error, sizeof(prog->last_error), "%s", vm->error_msg);
     return false;
   }
 
@@ -218,7 +298,7 @@ bool st_logic_execute_program(st_logic_engine_state_t *state, uint8_t program_id
   // BUG-106 FIX: Only copy variables back if execution was successful
   // This prevents division-by-zero or other errors from writing garbage values
   portENTER_CRITICAL(&st_var_spinlock);
-  memcpy(prog->bytecode.variables, vm.variables, vm.var_count * sizeof(st_value_t));
+  memcpy(prog->bytecode.variables, vm->variables, vm->var_count * sizeof(st_value_t));
   portEXIT_CRITICAL(&st_var_spinlock);
 
   // BUG-178 FIX: Write EXPORT variables to IR 220-251 after execution
@@ -228,6 +308,228 @@ bool st_logic_execute_program(st_logic_engine_state_t *state, uint8_t program_id
   return true;
 }
 
+/* ============================================================================
+ * FEAT-153: PARALLEL EXECUTION (worker lane on Core 0)
+ *
+ * The loop task runs lane 0 itself and hands lane 1 to the worker task.
+ * Start = task notification to the worker, barrier = binary semaphore the
+ * loop task takes before returning (i.e. before gpio_mapping_write_after_st_logic).
+ * ============================================================================ */
+
+static TaskHandle_t st_worker_task_handle = NULL;
+static SemaphoreHandle_t st_worker_done = NULL;
+static st_logic_engine_state_t *st_worker_state = NULL;
+static uint8_t st_worker_programs[ST_LOGIC_MAX_PROGRAMS];
+static uint8_t st_worker_program_count = 0;
+static volatile bool st_worker_success = true;
+
+// Dependency sets (static: ~0.9 KB, kept off the loop task stack)
+static st_logic_deps_t st_program_deps[ST_LOGIC_MAX_PROGRAMS];
+
+// st_logic_bytecode_is_global() per slot, rescanned only when the bytecode changes
+static const st_bytecode_instr_t *st_global_scan_instr[ST_LOGIC_MAX_PROGRAMS] = {nullptr};
+static uint16_t st_global_scan_count[ST_LOGIC_MAX_PROGRAMS] = {0};
+static bool st_global_scan_result[ST_LOGIC_MAX_PROGRAMS] = {false};
+
+static void st_logic_worker_task(void *arg) {
+  (void)arg;
+
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    bool ok = true;
+    for (uint8_t i = 0; i < st_worker_program_count; i++) {
+      if (!st_logic_execute_program(st_worker_state, st_worker_programs[i])) {
+        ok = false;  // Continue executing other programs despite error
+      }
+    }
+    st_worker_success = ok;
+
+    xSemaphoreGive(st_worker_done);
+  }
+}
+
+static bool st_logic_worker_start(void) {
+  if (st_worker_task_handle != NULL) return true;
+
+  if (st_worker_done == NULL) {
+    st_worker_done = xSemaphoreCreateBinary();
+    if (st_worker_done == NULL) return false;
+  }
+
+  BaseType_t ret = xTaskCreatePinnedToCore(
+    st_logic_worker_task,
+    "st_worker",
+    ST_LOGIC_WORKER_TASK_STACK,
+    NULL,
+    ST_LOGIC_WORKER_TASK_PRIO,
+    &st_worker_task_handle,
+    ST_LOGIC_WORKER_TASK_CORE
+  );
+  if (ret != pdPASS) {
+    debug_println("ERROR: Failed to create ST Logic worker task (running serial)");
+    st_worker_task_handle = NULL;
+    return false;
+  }
+  return true;
+}
+
+void st_logic_set_parallel(st_logic_engine_state_t *state, bool enabled) {
+  if (!state) return;
+  state->parallel = enabled ? 1 : 0;
+  if (enabled) st_logic_worker_start();
+}
+
+// Dependency analysis + lane assignment for the programs due this cycle
+static void st_logic_plan_cycle(st_logic_engine_state_t *state, bool parallel,
+                                const bool *due, st_logic_schedule_t *sched) {
+  for (uint8_t id = 0; id < ST_LOGIC_MAX_PROGRAMS; id++) {
+    st_logic_program_config_t *prog = &state->programs[id];
+    bool global = false;
+
+    if (!due[id]) {
+      memset(&st_program_deps[id], 0, sizeof(st_program_deps[id]));  // Not scheduled
+      continue;
+    }
+
+    if (prog->enabled && prog->compiled) {
+      if (st_global_scan_instr[id] != prog->bytecode.instructions ||
+          st_global_scan_count[id] != prog->bytecode.instr_count) {
+        st_global_scan_instr[id] = prog->bytecode.instructions;
+        st_global_scan_count[id] = prog->bytecode.instr_count;
+        st_global_scan_result[id] = st_logic_bytecode_is_global(&prog->bytecode);
+      }
+      global = st_global_scan_result[id];
+    }
+
+    st_logic_deps_collect(state, id, g_persist_config.var_maps,
+                          g_persist_config.var_map_count, global, &st_program_deps[id]);
+  }
+
+  st_logic_schedule_build(st_program_deps, ST_LOGIC_MAX_PROGRAMS,
+                          parallel ? ST_LOGIC_LANES : 1, sched);
+}
+
+/* ============================================================================
+ * FEAT-154: FIXED-PERIOD SCAN SCHEDULER
+ *
+ * Every program runs on its own grid of esp_timer due times (next_due +=
+ * period). A one-shot esp_timer armed at the earliest due time notifies the
+ * task calling st_logic_engine_loop(), so st_logic_scan_wait() in loop()
+ * returns at the due time instead of at the next tick.
+ * ============================================================================ */
+
+static esp_timer_handle_t st_scan_timer = NULL;
+static TaskHandle_t st_scan_task = NULL;
+static int64_t st_scan_armed_us = 0;
+
+static void st_logic_scan_timer_cb(void *arg) {
+  (void)arg;
+  if (st_scan_task) xTaskNotifyGive(st_scan_task);
+}
+
+// Arm the wake-up timer at due_us (0 = nothing scheduled)
+static void st_logic_scan_arm(int64_t due_us, int64_t now_us) {
+  if (st_scan_timer == NULL) {
+    esp_timer_create_args_t args = {};
+    args.callback = st_logic_scan_timer_cb;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "st_scan";
+    if (esp_timer_create(&args, &st_scan_timer) != ESP_OK) {
+      st_scan_timer = NULL;
+      return;  // No timer: loop() still polls every tick
+    }
+    st_scan_task = xTaskGetCurrentTaskHandle();
+  }
+
+  if (due_us == st_scan_armed_us) return;
+  esp_timer_stop(st_scan_timer);  // ESP_ERR_INVALID_STATE if not running - harmless
+  st_scan_armed_us = due_us;
+  if (due_us == 0) return;
+
+  int64_t delay_us = due_us - now_us;
+  if (delay_us < 1) delay_us = 1;
+  esp_timer_start_once(st_scan_timer, (uint64_t)delay_us);
+}
+
+void st_logic_scan_wait(uint32_t max_ms) {
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(max_ms));
+}
+
+// Pick the programs due at now_us, record start jitter and advance their grid
+static uint8_t st_logic_scan_select(st_logic_engine_state_t *state, int64_t now_us, bool *due) {
+  uint8_t due_count = 0;
+
+  for (uint8_t id = 0; id < ST_LOGIC_MAX_PROGRAMS; id++) {
+    st_logic_program_config_t *prog = &state->programs[id];
+    due[id] = false;
+
+    if (!prog->enabled || !prog->compiled) {
+      prog->next_due_us = 0;  // Re-anchor when enabled again
+      continue;
+    }
+
+    int64_t period_us = (int64_t)st_logic_get_period_ms(state, id) * 1000;
+    if (period_us <= 0) period_us = 1000;
+
+    if (prog->next_due_us == 0) prog->next_due_us = now_us;
+    if (now_us < prog->next_due_us) continue;
+
+    // Start jitter = how late this scan starts relative to its grid point
+    int64_t jitter = now_us - prog->next_due_us;
+    uint32_t jitter_us = (jitter > (int64_t)UINT32_MAX) ? UINT32_MAX : (uint32_t)jitter;
+    st_logic_scan_record(prog->scan.jitter_bucket, jitter_us);
+    prog->scan.jitter_count++;
+    prog->scan.jitter_sum_us += jitter_us;
+    if (jitter_us > prog->scan.jitter_max_us) prog->scan.jitter_max_us = jitter_us;
+
+    prog->deadline_us = prog->next_due_us + period_us;
+    prog->next_due_us += period_us;
+
+    // Still behind by whole periods?
+    if (now_us >= prog->next_due_us) {
+      uint32_t missed = (uint32_t)((now_us - prog->next_due_us) / period_us) + 1;
+      uint32_t drop = missed;
+      if (prog->scan_policy == ST_LOGIC_SCAN_CATCH_UP) {
+        // Missed scans stay due and run on the next calls, up to the limit
+        drop = (missed > ST_LOGIC_SCAN_MAX_CATCHUP) ? missed - ST_LOGIC_SCAN_MAX_CATCHUP : 0;
+      }
+      prog->next_due_us += (int64_t)drop * period_us;
+      prog->scan.skipped += drop;
+    }
+
+    due[id] = true;
+    due_count++;
+  }
+  return due_count;
+}
+
+// Due programs by priority (highest first), then program id
+static uint8_t st_logic_scan_order(const st_logic_engine_state_t *state, const bool *due,
+                                   uint8_t *order) {
+  uint8_t n = 0;
+  for (uint8_t id = 0; id < ST_LOGIC_MAX_PROGRAMS; id++) {
+    if (!due[id]) continue;
+    uint8_t pos = n++;
+    while (pos > 0 && state->programs[order[pos - 1]].priority < state->programs[id].priority) {
+      order[pos] = order[pos - 1];
+      pos--;
+    }
+    order[pos] = id;
+  }
+  return n;
+}
+
+static void st_logic_scan_rearm(const st_logic_engine_state_t *state, int64_t now_us) {
+  int64_t next = 0;
+  for (uint8_t id = 0; id < ST_LOGIC_MAX_PROGRAMS; id++) {
+    const st_logic_program_config_t *prog = &state->programs[id];
+    if (!prog->enabled || !prog->compiled || prog->next_due_us == 0) continue;
+    if (next == 0 || prog->next_due_us < next) next = prog->next_due_us;
+  }
+  st_logic_scan_arm(next, now_us);
+}
+
 /* ============================================================================
  * MAIN LOGIC ENGINE LOOP
  *
@@ -244,18 +546,26 @@ bool st_logic_execute_program(st_logic_engine_state_t *state, uint8_t program_id
 
 bool st_logic_engine_loop(st_logic_engine_state_t *state,
                            uint16_t *holding_regs, uint16_t *input_regs) {
-  if (!state || !state->enabled) return true;  // Logic mode disabled
+  // No scan is running here: the worker finished at the last cycle's barrier
+  st_logic_reclaim_vms();
 
-  // FIXED RATE SCHEDULER: Check if enough time has elapsed since last execution
-  uint32_t now = millis();
-  uint32_t elapsed = now - state->last_run_time;
+  if (!state || !state->enabled) {
+    if (st_scan_timer) st_logic_scan_arm(0, 0);
+    return true;  // Logic mode disabled
+  }
 
-  if (elapsed < state->execution_interval_ms) {
-    return true;  // Skip this iteration, too early (throttle execution)
+  // FEAT-154: FIXED-PERIOD SCHEDULER - run only the programs whose grid point has passed
+  int64_t now_us = esp_timer_get_time();
+  bool due[ST_LOGIC_MAX_PROGRAMS];
+  uint8_t order[ST_LOGIC_MAX_PROGRAMS];
+  if (st_logic_scan_select(state, now_us, due) == 0) {
+    st_logic_scan_rearm(state, now_us);
+    return true;  // Nothing due yet
   }
+  uint8_t order_count = st_logic_scan_order(state, due, order);
 
   // Update timestamp for next cycle
-  state->last_run_time = now;
+  state->last_run_time = millis();
 
   bool all_success = true;
 
@@ -263,10 +573,31 @@ bool st_logic_engine_loop(st_logic_engine_state_t *state,
   // NOTE: I/O is handled by gpio_mapping_update() in main loop, not here
   uint32_t start_cycle = millis();
 
-  for (int prog_id = 0; prog_id < ST_LOGIC_MAX_PROGRAMS; prog_id++) {
-    st_logic_program_config_t *prog = &state->programs[prog_id];
+  // FEAT-153: Split independent programs over loop task (lane 0) and worker (lane 1)
+  if (state->parallel && !st_logic_worker_start()) {
+    state->parallel = 0;  // No worker task → fall back to serial execution
+  }
+  bool parallel = state->parallel != 0;
+  st_logic_schedule_t sched;
+  st_logic_plan_cycle(state, parallel, due, &sched);
+  memcpy(state->lane, sched.lane, sizeof(state->lane));
+  state->group_count = sched.group_count;
+
+  bool worker_dispatched = false;
+  if (parallel && sched.lane_programs[1] > 0) {
+    st_worker_program_count = 0;
+    for (uint8_t i = 0; i < order_count; i++) {
+      if (sched.lane[order[i]] == 1) st_worker_programs[st_worker_program_count++] = order[i];
+    }
+    st_worker_state = state;
+    st_worker_success = true;
+    xTaskNotifyGive(st_worker_task_handle);
+    worker_dispatched = true;
+  }
 
-    if (!prog->enabled || !prog->compiled) continue;
+  for (uint8_t i = 0; i < order_count; i++) {
+    uint8_t prog_id = order[i];  // FEAT-154: Priority order
+    if (sched.lane[prog_id] != 0) continue;  // FEAT-153: Runs on the worker
 
     // BUG-133 FIX (v2): Reset Modbus request counter PER SLOT, not per cycle.
     // Each program gets its own full quota of max_requests_per_cycle.
@@ -283,6 +614,13 @@ bool st_logic_engine_loop(st_logic_engine_state_t *state,
     }
   }
 
+  // FEAT-153: Barrier - all outputs must be final before gpio_mapping writes them
+  if (worker_dispatched) {
+    xSemaphoreTake(st_worker_done, portMAX_DELAY);
+    if (!st_worker_success) all_success = false;
+    state->parallel_cycles++;
+  }
+
   // Performance monitoring (v4.1.0): Track global cycle statistics
   uint32_t cycle_time = millis() - start_cycle;
   state->total_cycles++;
@@ -300,6 +638,9 @@ bool st_logic_engine_loop(st_logic_engine_state_t *state,
     state->cycle_overrun_count++;
   }
 
+  // FEAT-154: Wake the loop task at the next due time
+  st_logic_scan_rearm(state, esp_timer_get_time());
+
   // Debug: Log total cycle time if debug enabled
   if (state->debug) {
     if (cycle_time > state->execution_interval_ms) {
@@ -480,6 +821,12 @@ void st_logic_print_program(st_logic_engine_state_t *state, uint8_t program_id,
 
   if (prog->compiled) {
     debug_printf("\nCompiled Bytecode: %d instructions\n", prog->bytecode.instr_count);
+    if (prog->bytecode.unoptimized_count > prog->bytecode.instr_count) {
+      debug_printf("  Optimizer: %d -> %d instructions (-%d%%)\n",
+                   prog->bytecode.unoptimized_count, prog->bytecode.instr_count,
+                   (int)((prog->bytecode.unoptimized_count - prog->bytecode.instr_count) * 100 /
+                         prog->bytecode.unoptimized_count));
+    }
   }
 
   if (prog->error_count > 0) {
@@ -0,0 +1,259 @@
+/**
+ * @file st_logic_parallel.cpp
+ * @brief Dependency analysis + lane partitioning for parallel ST execution (FEAT-153)
+ *
+ * Pure functions only - the worker task and barrier live in st_logic_engine.cpp.
+ */
+
+#include "st_logic_parallel.h"
+#include "st_builtins.h"
+#include <string.h>
+
+/* ============================================================================
+ * GLOBAL SIDE EFFECTS
+ * ============================================================================ */
+
+bool st_logic_builtin_is_global(uint16_t func_id) {
+  switch (func_id) {
+    // NVS persistence (shared group table + flash)
+    case ST_BUILTIN_PERSIST_SAVE:
+    case ST_BUILTIN_PERSIST_LOAD:
+    // Modbus master: g_mb_request_count / g_mb_cache_enabled / mb_async queue
+    case ST_BUILTIN_MB_READ_COIL:
+    case ST_BUILTIN_MB_READ_INPUT:
+    case ST_BUILTIN_MB_READ_HOLDING:
+    case ST_BUILTIN_MB_READ_INPUT_REG:
+    case ST_BUILTIN_MB_WRITE_COIL:
+    case ST_BUILTIN_MB_WRITE_HOLDING:
+    case ST_BUILTIN_MB_READ_HOLDINGS:
+    case ST_BUILTIN_MB_WRITE_HOLDINGS:
+    case ST_BUILTIN_MB_SUCCESS:
+    case ST_BUILTIN_MB_BUSY:
+    case ST_BUILTIN_MB_ERROR:
+    case ST_BUILTIN_MB_CACHE:
+    // Counter engine + its control holding registers
+    case ST_BUILTIN_CNT_SETUP:
+    case ST_BUILTIN_CNT_SETUP_ADV:
+    case ST_BUILTIN_CNT_SETUP_CMP:
+    case ST_BUILTIN_CNT_ENABLE:
+    case ST_BUILTIN_CNT_CTRL:
+    case ST_BUILTIN_CNT_VALUE:
+    case ST_BUILTIN_CNT_RAW:
+    case ST_BUILTIN_CNT_FREQ:
+    case ST_BUILTIN_CNT_STATUS:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool st_logic_bytecode_is_global(const st_bytecode_program_t *bytecode) {
+  if (!bytecode || !bytecode->instructions) return false;
+
+  for (uint16_t i = 0; i < bytecode->instr_count; i++) {
+    const st_bytecode_instr_t *instr = &bytecode->instructions[i];
+    // FEAT-152 fused CALL_* opcodes are timers/counters/edges (per-program state)
+    if (instr->opcode == ST_OP_CALL_BUILTIN &&
+        st_logic_builtin_is_global(instr->arg.builtin_call.func_id_low)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* ============================================================================
+ * DEPENDENCY SETS
+ * ============================================================================ */
+
+bool st_logic_deps_add_range(st_logic_deps_t *deps, uint8_t space, uint16_t start, uint16_t count) {
+  if (count == 0) count = 1;
+  uint32_t end = (uint32_t)start + count;
+
+  // Merge with an existing range in the same space if they touch
+  for (uint8_t i = 0; i < deps->range_count; i++) {
+    st_logic_res_range_t *r = &deps->ranges[i];
+    uint32_t r_end = (uint32_t)r->start + r->count;
+    if (r->space == space && start <= r_end && r->start <= end) {
+      uint16_t new_start = (start < r->start) ? start : r->start;
+      uint32_t new_end = (end > r_end) ? end : r_end;
+      r->start = new_start;
+      r->count = (uint16_t)(new_end - new_start);
+      return true;
+    }
+  }
+
+  if (deps->range_count >= ST_LOGIC_DEP_MAX_RANGES) return false;
+
+  st_logic_res_range_t *r = &deps->ranges[deps->range_count++];
+  r->space = space;
+  r->start = start;
+  r->count = count;
+  return true;
+}
+
+void st_logic_deps_collect(const st_logic_engine_state_t *state, uint8_t program_id,
+                           const VariableMapping *maps, uint8_t map_count,
+                           bool bytecode_global, st_logic_deps_t *deps) {
+  memset(deps, 0, sizeof(*deps));
+  if (program_id >= ST_LOGIC_MAX_PROGRAMS) return;
+
+  const st_logic_program_config_t *prog = &state->programs[program_id];
+  if (!prog->enabled || !prog->compiled) return;
+
+  deps->active = 1;
+  deps->cost_us = prog->last_execution_us;
+  deps->global = bytecode_global ? 1 : 0;
+
+  // FEAT-008: Debugger uses the single shared debug VM
+  const st_debug_state_t *debug = &state->debugger[program_id];
+  if (debug->mode != ST_DEBUG_OFF || debug->owns_debug_vm) {
+    deps->global = 1;
+  }
+
+  bool fits = true;
+
+  // Register bindings (gpio_mapping.cpp reads/writes these around execution)
+  for (uint8_t i = 0; i < map_count; i++) {
+    const VariableMapping *map = &maps[i];
+    if (map->source_type != MAPPING_SOURCE_ST_VAR || map->st_program_id != program_id) continue;
+
+    uint16_t words = (map->word_count > 0) ? map->word_count : 1;
+    if (map->is_input) {
+      if (map->input_type == 1) {
+        fits &= st_logic_deps_add_range(deps, ST_LOGIC_RES_DI, map->input_reg, 1);
+      } else if (map->input_type == 2) {
+        fits &= st_logic_deps_add_range(deps, ST_LOGIC_RES_COIL, map->input_reg, 1);
+      } else {
+        fits &= st_logic_deps_add_range(deps, ST_LOGIC_RES_HR, map->input_reg, words);
+      }
+    } else {
+      if (map->output_type == 1) {
+        fits &= st_logic_deps_add_range(deps, ST_LOGIC_RES_COIL, map->coil_reg, 1);
+      } else {
+        fits &= st_logic_deps_add_range(deps, ST_LOGIC_RES_HR, map->coil_reg, words);
+      }
+    }
+  }
+
+  // BUG-178: EXPORT variables are written to IR 220-251 during execution
+  if (prog->ir_pool_offset != 65535 && prog->ir_pool_size > 0) {
+    fits &= st_logic_deps_add_range(deps, ST_LOGIC_RES_IR, 220 + prog->ir_pool_offset,
+                                    prog->ir_pool_size);
+  }
+
+  // Unknown footprint → serialise with everything else on lane 0
+  if (!fits) deps->global = 1;
+}
+
+bool st_logic_deps_conflict(const st_logic_deps_t *a, const st_logic_deps_t *b) {
+  if (a->global && b->global) return true;
+
+  for (uint8_t i = 0; i < a->range_count; i++) {
+    const st_logic_res_range_t *ra = &a->ranges[i];
+    for (uint8_t j = 0; j < b->range_count; j++) {
+      const st_logic_res_range_t *rb = &b->ranges[j];
+      if (ra->space != rb->space) continue;
+      if ((uint32_t)ra->start < (uint32_t)rb->start + rb->count &&
+          (uint32_t)rb->start < (uint32_t)ra->start + ra->count) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/* ============================================================================
+ * PARTITIONING
+ * ============================================================================ */
+
+static uint8_t st_logic_group_find(uint8_t *parent, uint8_t i) {
+  while (parent[i] != i) {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+static void st_logic_group_union(uint8_t *parent, uint8_t a, uint8_t b) {
+  uint8_t ra = st_logic_group_find(parent, a);
+  uint8_t rb = st_logic_group_find(parent, b);
+  if (ra == rb) return;
+  // Lowest program id stays root, so group ids are deterministic
+  if (ra < rb) parent[rb] = ra;
+  else parent[ra] = rb;
+}
+
+void st_logic_schedule_build(const st_logic_deps_t *deps, uint8_t count, uint8_t lanes,
+                             st_logic_schedule_t *out) {
+  memset(out, 0, sizeof(*out));
+  memset(out->lane, ST_LOGIC_LANE_NONE, sizeof(out->lane));
+  memset(out->group, ST_LOGIC_LANE_NONE, sizeof(out->group));
+  if (count > ST_LOGIC_MAX_PROGRAMS) count = ST_LOGIC_MAX_PROGRAMS;
+  if (lanes < 1) lanes = 1;
+  if (lanes > ST_LOGIC_LANES) lanes = ST_LOGIC_LANES;
+
+  uint8_t parent[ST_LOGIC_MAX_PROGRAMS];
+  for (uint8_t i = 0; i < ST_LOGIC_MAX_PROGRAMS; i++) parent[i] = i;
+
+  // 1. Merge conflicting programs
+  for (uint8_t i = 0; i < count; i++) {
+    if (!deps[i].active) continue;
+    for (uint8_t j = i + 1; j < count; j++) {
+      if (!deps[j].active) continue;
+      if (st_logic_deps_conflict(&deps[i], &deps[j])) {
+        st_logic_group_union(parent, i, j);
+      }
+    }
+  }
+
+  // 2. Per-group cost (+1 us per program so empty stats still balance) and pinning
+  uint32_t group_cost[ST_LOGIC_MAX_PROGRAMS] = {0};
+  bool group_global[ST_LOGIC_MAX_PROGRAMS] = {false};
+  bool group_used[ST_LOGIC_MAX_PROGRAMS] = {false};
+
+  for (uint8_t i = 0; i < count; i++) {
+    if (!deps[i].active) continue;
+    uint8_t g = st_logic_group_find(parent, i);
+    out->group[i] = g;
+    group_cost[g] += deps[i].cost_us + 1;
+    if (deps[i].global) group_global[g] = true;
+    if (!group_used[g]) {
+      group_used[g] = true;
+      out->group_count++;
+    }
+  }
+
+  // 3. Global groups → lane 0, then the rest largest-first onto the lightest lane
+  uint8_t group_lane[ST_LOGIC_MAX_PROGRAMS];
+  memset(group_lane, ST_LOGIC_LANE_NONE, sizeof(group_lane));
+
+  for (uint8_t g = 0; g < count; g++) {
+    if (group_used[g] && group_global[g]) {
+      group_lane[g] = 0;
+      out->lane_cost_us[0] += group_cost[g];
+    }
+  }
+
+  for (;;) {
+    // Pick the most expensive unassigned group (lowest id on ties)
+    uint8_t best = ST_LOGIC_LANE_NONE;
+    for (uint8_t g = 0; g < count; g++) {
+      if (!group_used[g] || group_lane[g] != ST_LOGIC_LANE_NONE) continue;
+      if (best == ST_LOGIC_LANE_NONE || group_cost[g] > group_cost[best]) best = g;
+    }
+    if (best == ST_LOGIC_LANE_NONE) break;
+
+    uint8_t lane = 0;
+    for (uint8_t l = 1; l < lanes; l++) {
+      if (out->lane_cost_us[l] < out->lane_cost_us[lane]) lane = l;
+    }
+    group_lane[best] = lane;
+    out->lane_cost_us[lane] += group_cost[best];
+  }
+
+  for (uint8_t i = 0; i < count; i++) {
+    if (!deps[i].active) continue;
+    out->lane[i] = group_lane[out->group[i]];
+    out->lane_programs[out->lane[i]]++;
+  }
+}
@@ -0,0 +1,534 @@
+/**
+ * @file st_optimizer.cpp
+ * @brief Bytecode peephole optimizer implementation (FEAT-151)
+ *
+ * Passes mark dead instructions as NOP; st_opt_compact() then removes them
+ * and relocates every address (jumps, function registry, line map). The
+ * passes repeat until a round removes nothing, so folds that expose new
+ * constants (e.g. (2 + 3) * 4) are picked up in the next round.
+ *
+ * Multi-instruction patterns never span a jump target or function entry:
+ * only the first instruction of a pattern may be entered from elsewhere.
+ */
+
+#include "st_optimizer.h"
+#include "debug.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define ST_OPT_MAX_ROUNDS  8    // Fixpoint iteration limit
+#define ST_OPT_MAX_HOPS    16   // Jump threading chain limit (guards JMP cycles)
+
+// Per-instruction flags
+#define ST_OPT_TARGET      0x01 // Jump target or user function entry
+#define ST_OPT_REACHABLE   0x02 // Reached from PC 0 or a function entry
+
+/* ============================================================================
+ * HELPERS
+ * ============================================================================ */
+
+static bool st_opt_is_jump(st_opcode_t op) {
+  return op == ST_OP_JMP || op == ST_OP_JMP_IF_FALSE || op == ST_OP_JMP_IF_TRUE;
+}
+
+static void st_opt_nop(st_bytecode_instr_t *instr) {
+  memset(instr, 0, sizeof(*instr));
+  instr->opcode = ST_OP_NOP;
+}
+
+static float st_opt_get_real(const st_bytecode_instr_t *instr) {
+  float f;
+  memcpy(&f, &instr->arg.int_arg, sizeof(float));  // Same encoding as the compiler
+  return f;
+}
+
+static void st_opt_set_real(st_bytecode_instr_t *instr, float f) {
+  instr->opcode = ST_OP_PUSH_REAL;
+  instr->arg.int_arg = 0;
+  memcpy(&instr->arg.int_arg, &f, sizeof(float));
+}
+
+static void st_opt_set_int(st_bytecode_instr_t *instr, st_opcode_t op, int32_t value) {
+  instr->opcode = op;
+  instr->arg.int_arg = value;
+}
+
+// Mark jump targets and user function entries
+static void st_opt_mark_targets(const st_bytecode_program_t *bc, uint8_t *flags) {
+  uint16_t n = bc->instr_count;
+  memset(flags, 0, n);
+
+  for (uint16_t i = 0; i < n; i++) {
+    const st_bytecode_instr_t *instr = &bc->instructions[i];
+    if (st_opt_is_jump(instr->opcode) && (uint32_t)instr->arg.int_arg < n) {
+      flags[instr->arg.int_arg] |= ST_OPT_TARGET;
+    }
+  }
+
+  const st_function_registry_t *reg = bc->func_registry;
+  if (reg) {
+    for (uint8_t f = reg->builtin_count; f < reg->builtin_count + reg->user_count; f++) {
+      if (reg->functions[f].bytecode_addr < n) {
+        flags[reg->functions[f].bytecode_addr] |= ST_OPT_TARGET;
+      }
+    }
+  }
+}
+
+// Pattern [i, i + len) is only entered at i
+static bool st_opt_window(const st_bytecode_program_t *bc, const uint8_t *flags,
+                          uint16_t i, uint16_t len) {
+  if ((uint32_t)i + len > bc->instr_count) return false;
+  for (uint16_t k = 1; k < len; k++) {
+    if (flags[i + k] & ST_OPT_TARGET) return false;
+  }
+  return true;
+}
+
+/* ============================================================================
+ * CONSTANT FOLDING
+ * ============================================================================ */
+
+// INT op INT with the VM's 16-bit wrap (generic and FEAT-149 typed opcodes)
+static bool st_opt_fold_int(st_opcode_t op, int16_t a, int16_t b, st_bytecode_instr_t *out) {
+  switch (op) {
+    case ST_OP_ADD: case ST_OP_ADD_INT: st_opt_set_int(out, ST_OP_PUSH_INT, (int16_t)(a + b)); return true;
+    case ST_OP_SUB: case ST_OP_SUB_INT: st_opt_set_int(out, ST_OP_PUSH_INT, (int16_t)(a - b)); return true;
+    case ST_OP_MUL: case ST_OP_MUL_INT: st_opt_set_int(out, ST_OP_PUSH_INT, (int16_t)(a * b)); return true;
+    case ST_OP_EQ:  case ST_OP_EQ_INT:  st_opt_set_int(out, ST_OP_PUSH_BOOL, a == b); return true;
+    case ST_OP_NE:  case ST_OP_NE_INT:  st_opt_set_int(out, ST_OP_PUSH_BOOL, a != b); return true;
+    case ST_OP_LT:  case ST_OP_LT_INT:  st_opt_set_int(out, ST_OP_PUSH_BOOL, a < b); return true;
+    case ST_OP_GT:  case ST_OP_GT_INT:  st_opt_set_int(out, ST_OP_PUSH_BOOL, a > b); return true;
+    case ST_OP_LE:  case ST_OP_LE_INT:  st_opt_set_int(out, ST_OP_PUSH_BOOL, a <= b); return true;
+    case ST_OP_GE:  case ST_OP_GE_INT:  st_opt_set_int(out, ST_OP_PUSH_BOOL, a >= b); return true;
+    default: return false;
+  }
+}
+
+// REAL op REAL; results the VM would reject (NaN/INF, division by zero) are left alone
+static bool st_opt_fold_real(st_opcode_t op, float a, float b, st_bytecode_instr_t *out) {
+  float r;
+  switch (op) {
+    case ST_OP_ADD: case ST_OP_ADD_REAL: r = a + b; break;
+    case ST_OP_SUB: case ST_OP_SUB_REAL: r = a - b; break;
+    case ST_OP_MUL: case ST_OP_MUL_REAL: r = a * b; break;
+    case ST_OP_DIV: case ST_OP_DIV_REAL:
+      if (b == 0.0f) return false;
+      r = a / b;
+      break;
+    case ST_OP_EQ:  case ST_OP_EQ_REAL:  st_opt_set_int(out, ST_OP_PUSH_BOOL, a == b); return true;
+    case ST_OP_NE:  case ST_OP_NE_REAL:  st_opt_set_int(out, ST_OP_PUSH_BOOL, a != b); return true;
+    case ST_OP_LT:  case ST_OP_LT_REAL:  st_opt_set_int(out, ST_OP_PUSH_BOOL, a < b); return true;
+    case ST_OP_GT:  case ST_OP_GT_REAL:  st_opt_set_int(out, ST_OP_PUSH_BOOL, a > b); return true;
+    case ST_OP_LE:  case ST_OP_LE_REAL:  st_opt_set_int(out, ST_OP_PUSH_BOOL, a <= b); return true;
+    case ST_OP_GE:  case ST_OP_GE_REAL:  st_opt_set_int(out, ST_OP_PUSH_BOOL, a >= b); return true;
+    default: return false;
+  }
+  if (isnan(r) || isinf(r)) return false;
+  st_opt_set_real(out, r);
+  return true;
+}
+
+static uint16_t st_opt_fold(st_bytecode_program_t *bc, const uint8_t *flags) {
+  st_bytecode_instr_t *code = bc->instructions;
+  uint16_t n = bc->instr_count;
+  uint16_t folded = 0;
+
+  for (uint16_t i = 0; i + 1 < n; i++) {
+    st_bytecode_instr_t *a = &code[i];
+    st_bytecode_instr_t *b = &code[i + 1];
+    if (!st_opt_window(bc, flags, i, 2)) continue;
+
+    // Unary: PUSH k, NEG / CVT_INT_REAL
+    if (a->opcode == ST_OP_PUSH_INT && b->opcode == ST_OP_NEG &&
+        (int16_t)a->arg.int_arg != INT16_MIN) {  // VM promotes -INT16_MIN to REAL
+      st_opt_set_int(a, ST_OP_PUSH_INT, -(int16_t)a->arg.int_arg);
+      st_opt_nop(b);
+      folded++;
+      continue;
+    }
+    if (a->opcode == ST_OP_PUSH_REAL && b->opcode == ST_OP_NEG) {
+      st_opt_set_real(a, -st_opt_get_real(a));
+      st_opt_nop(b);
+      folded++;
+      continue;
+    }
+    if (a->opcode == ST_OP_PUSH_INT && b->opcode == ST_OP_CVT_INT_REAL) {
+      st_opt_set_real(a, (float)(int16_t)a->arg.int_arg);
+      st_opt_nop(b);
+      folded++;
+      continue;
+    }
+
+    // Constant condition: PUSH_BOOL, JMP_IF_* → JMP or fall through
+    if (a->opcode == ST_OP_PUSH_BOOL &&
+        (b->opcode == ST_OP_JMP_IF_FALSE || b->opcode == ST_OP_JMP_IF_TRUE)) {
+      bool taken = (a->arg.int_arg != 0) == (b->opcode == ST_OP_JMP_IF_TRUE);
+      if (taken) {
+        st_opt_set_int(a, ST_OP_JMP, b->arg.int_arg);
+      } else {
+        st_opt_nop(a);
+      }
+      st_opt_nop(b);
+      folded++;
+      continue;
+    }
+
+    // Binary: PUSH k1, PUSH k2, op
+    if (!st_opt_window(bc, flags, i, 3)) continue;
+    st_bytecode_instr_t *c = &code[i + 2];
+    st_bytecode_instr_t result;
+    bool ok = false;
+
+    if (a->opcode == ST_OP_PUSH_INT && b->opcode == ST_OP_PUSH_INT) {
+      ok = st_opt_fold_int(c->opcode, (int16_t)a->arg.int_arg, (int16_t)b->arg.int_arg, &result);
+    } else if (a->opcode == ST_OP_PUSH_REAL && b->opcode == ST_OP_PUSH_REAL) {
+      ok = st_opt_fold_real(c->opcode, st_opt_get_real(a), st_opt_get_real(b), &result);
+    }
+    if (ok) {
+      *a = result;
+      st_opt_nop(b);
+      st_opt_nop(c);
+      folded++;
+    }
+  }
+  return folded;
+}
+
+/* ============================================================================
+ * DEAD STORES
+ * ============================================================================ */
+
+// Instructions that cannot fail and do not read global variable x
+static bool st_opt_store_transparent(const st_bytecode_instr_t *instr, uint16_t x) {
+  switch (instr->opcode) {
+    case ST_OP_PUSH_BOOL: case ST_OP_PUSH_INT: case ST_OP_PUSH_DWORD: case ST_OP_PUSH_REAL:
+    case ST_OP_DUP: case ST_OP_POP: case ST_OP_NOP:
+    case ST_OP_LOAD_PARAM: case ST_OP_LOAD_LOCAL: case ST_OP_STORE_LOCAL:
+    case ST_OP_ADD_INT: case ST_OP_SUB_INT: case ST_OP_MUL_INT:
+    case ST_OP_ADD_DINT: case ST_OP_SUB_DINT: case ST_OP_MUL_DINT:
+    case ST_OP_EQ_INT: case ST_OP_NE_INT: case ST_OP_LT_INT:
+    case ST_OP_GT_INT: case ST_OP_LE_INT: case ST_OP_GE_INT:
+    case ST_OP_EQ_DINT: case ST_OP_NE_DINT: case ST_OP_LT_DINT:
+    case ST_OP_GT_DINT: case ST_OP_LE_DINT: case ST_OP_GE_DINT:
+    case ST_OP_EQ_REAL: case ST_OP_NE_REAL: case ST_OP_LT_REAL:
+    case ST_OP_GT_REAL: case ST_OP_LE_REAL: case ST_OP_GE_REAL:
+    case ST_OP_CVT_INT_DINT: case ST_OP_CVT_INT_REAL: case ST_OP_CVT_DINT_REAL:
+    case ST_OP_LIMIT_INT: case ST_OP_LIMIT_DINT: case ST_OP_LIMIT_REAL: case ST_OP_SCALE_REAL:
+      return true;
+    case ST_OP_LOAD_VAR:
+    case ST_OP_STORE_VAR:
+      return instr->arg.var_index != x;
+    default:
+      return false;  // Jumps, calls, arrays, ops that may raise a VM error
+  }
+}
+
+static uint16_t st_opt_dead_stores(st_bytecode_program_t *bc, const uint8_t *flags) {
+  st_bytecode_instr_t *code = bc->instructions;
+  uint16_t n = bc->instr_count;
+  uint16_t removed = 0;
+
+  for (uint16_t i = 0; i + 1 < n; i++) {
+    st_bytecode_instr_t *a = &code[i];
+    st_bytecode_instr_t *b = &code[i + 1];
+
+    // x := x
+    if (a->opcode == ST_OP_LOAD_VAR && b->opcode == ST_OP_STORE_VAR &&
+        a->arg.var_index == b->arg.var_index && st_opt_window(bc, flags, i, 2)) {
+      st_opt_nop(a);
+      st_opt_nop(b);
+      removed++;
+      continue;
+    }
+
+    // Value pushed only to be discarded (left behind by an eliminated store)
+    if (b->opcode == ST_OP_POP && st_opt_window(bc, flags, i, 2) &&
+        (a->opcode == ST_OP_PUSH_BOOL || a->opcode == ST_OP_PUSH_INT ||
+         a->opcode == ST_OP_PUSH_DWORD || a->opcode == ST_OP_PUSH_REAL ||
+         a->opcode == ST_OP_LOAD_VAR || a->opcode == ST_OP_DUP)) {
+      st_opt_nop(a);
+      st_opt_nop(b);
+      removed++;
+      continue;
+    }
+
+    // STORE_VAR x overwritten by a later STORE_VAR x in the same basic block
+    if (a->opcode == ST_OP_STORE_VAR) {
+      for (uint16_t j = i + 1; j < n && !(flags[j] & ST_OPT_TARGET); j++) {
+        const st_bytecode_instr_t *next = &code[j];
+        if (next->opcode == ST_OP_STORE_VAR && next->arg.var_index == a->arg.var_index) {
+          st_opt_set_int(a, ST_OP_POP, 0);
+          removed++;
+          break;
+        }
+        if (!st_opt_store_transparent(next, a->arg.var_index)) break;
+      }
+    }
+  }
+  return removed;
+}
+
+/* ============================================================================
+ * INC_VAR FUSION
+ * ============================================================================ */
+
+// LOAD_VAR x, PUSH_INT k, [CVT_INT_DINT], ADD|SUB, STORE_VAR x → INC_VAR x,±k
+static uint16_t st_opt_fuse_inc(st_bytecode_program_t *bc, const uint8_t *flags) {
+  st_bytecode_instr_t *code = bc->instructions;
+  uint16_t n = bc->instr_count;
+  uint16_t fused = 0;
+
+  for (uint16_t i = 0; i + 3 < n; i++) {
+    if (code[i].opcode != ST_OP_LOAD_VAR || code[i + 1].opcode != ST_OP_PUSH_INT) continue;
+
+    uint16_t x = code[i].arg.var_index;
+    if (x >= bc->var_count) continue;
+    st_datatype_t type = bc->var_types[x];
+    if (type != ST_TYPE_INT && type != ST_TYPE_DINT) continue;
+
+    uint16_t k = i + 2;
+    bool cvt = (type == ST_TYPE_DINT && code[k].opcode == ST_OP_CVT_INT_DINT);
+    if (cvt) k++;
+    if (k + 1 >= n) continue;
+
+    st_opcode_t op = code[k].opcode;
+    bool add, sub;
+    if (type == ST_TYPE_INT) {
+      add = (op == ST_OP_ADD || op == ST_OP_ADD_INT);
+      sub = (op == ST_OP_SUB || op == ST_OP_SUB_INT);
+    } else {
+      // DINT var + INT literal: generic op promotes, typed op needs the CVT
+      add = (op == ST_OP_ADD || (cvt && op == ST_OP_ADD_DINT));
+      sub = (op == ST_OP_SUB || (cvt && op == ST_OP_SUB_DINT));
+    }
+    if (!add && !sub) continue;
+    if (code[k + 1].opcode != ST_OP_STORE_VAR || code[k + 1].arg.var_index != x) continue;
+    if (!st_opt_window(bc, flags, i, k + 2 - i)) continue;
+
+    int16_t delta = (int16_t)code[i + 1].arg.int_arg;
+    if (sub) {
+      if (delta == INT16_MIN) continue;
+      delta = -delta;
+    }
+
+    st_bytecode_instr_t *instr = &code[i];
+    instr->opcode = ST_OP_INC_VAR;
+    instr->arg.int_arg = 0;
+    instr->arg.var_inc.var_index = (uint8_t)x;
+    instr->arg.var_inc.delta = delta;
+    for (uint16_t j = i + 1; j <= k + 1; j++) {
+      st_opt_nop(&code[j]);
+    }
+    fused++;
+  }
+  return fused;
+}
+
+/* ============================================================================
+ * JUMP THREADING
+ * ============================================================================ */
+
+static uint16_t st_opt_thread_jumps(st_bytecode_program_t *bc) {
+  st_bytecode_instr_t *code = bc->instructions;
+  uint16_t n = bc->instr_count;
+  uint16_t threaded = 0;
+
+  for (uint16_t i = 0; i < n; i++) {
+    st_bytecode_instr_t *instr = &code[i];
+    if (!st_opt_is_jump(instr->opcode) || (uint32_t)instr->arg.int_arg >= n) continue;
+
+    uint16_t target = (uint16_t)instr->arg.int_arg;
+    for (uint8_t hops = 0; hops < ST_OPT_MAX_HOPS; hops++) {
+      const st_bytecode_instr_t *t = &code[target];
+      if (t->opcode != ST_OP_JMP || (uint32_t)t->arg.int_arg >= n || t->arg.int_arg == target) break;
+      target = (uint16_t)t->arg.int_arg;
+    }
+    if (target != (uint16_t)instr->arg.int_arg) {
+      instr->arg.int_arg = target;
+      threaded++;
+    }
+
+    // JMP to the next instruction
+    if (instr->opcode == ST_OP_JMP && target == i + 1) {
+      st_opt_nop(instr);
+      threaded++;
+    }
+  }
+  return threaded;
+}
+
+/* ============================================================================
+ * UNREACHABLE CODE
+ * ============================================================================ */
+
+// worklist: n entries of scratch space
+static uint16_t st_opt_remove_unreachable(st_bytecode_program_t *bc, uint8_t *flags,
+                                          uint16_t *worklist) {
+  st_bytecode_instr_t *code = bc->instructions;
+  uint16_t n = bc->instr_count;
+  uint16_t top = 0;
+
+  for (uint16_t i = 0; i < n; i++) flags[i] &= ~ST_OPT_REACHABLE;
+
+  flags[0] |= ST_OPT_REACHABLE;
+  worklist[top++] = 0;
+
+  const st_function_registry_t *reg = bc->func_registry;
+  if (reg) {
+    for (uint8_t f = reg->builtin_count; f < reg->builtin_count + reg->user_count; f++) {
+      uint16_t addr = reg->functions[f].bytecode_addr;
+      if (addr < n && !(flags[addr] & ST_OPT_REACHABLE)) {
+        flags[addr] |= ST_OPT_REACHABLE;
+        worklist[top++] = addr;
+      }
+    }
+  }
+
+  while (top > 0) {
+    uint16_t pc = worklist[--top];
+    const st_bytecode_instr_t *instr = &code[pc];
+    uint16_t succ[2];
+    uint8_t succ_count = 0;
+
+    if (instr->opcode != ST_OP_JMP && instr->opcode != ST_OP_HALT && instr->opcode != ST_OP_RETURN) {
+      if (pc + 1 < n) succ[succ_count++] = pc + 1;
+    }
+    if (st_opt_is_jump(instr->opcode) && (uint32_t)instr->arg.int_arg < n) {
+      succ[succ_count++] = (uint16_t)instr->arg.int_arg;
+    }
+    for (uint8_t s = 0; s < succ_count; s++) {
+      if (!(flags[succ[s]] & ST_OPT_REACHABLE)) {
+        flags[succ[s]] |= ST_OPT_REACHABLE;
+        worklist[top++] = succ[s];
+      }
+    }
+  }
+
+  uint16_t removed = 0;
+  for (uint16_t i = 0; i < n; i++) {
+    if (!(flags[i] & ST_OPT_REACHABLE) && code[i].opcode != ST_OP_NOP) {
+      st_opt_nop(&code[i]);
+      removed++;
+    }
+  }
+  return removed;
+}
+
+/* ============================================================================
+ * COMPACTION
+ * ============================================================================ */
+
+// Remove NOPs and relocate addresses. map: n + 1 entries of scratch space
+static uint16_t st_opt_compact(st_bytecode_program_t *bc, st_line_map_t *line_map, uint16_t *map) {
+  st_bytecode_instr_t *code = bc->instructions;
+  uint16_t n = bc->instr_count;
+  uint16_t w = 0;
+
+  // Removed addresses map to the next surviving instruction
+  for (uint16_t i = 0; i < n; i++) {
+    map[i] = w;
+    if (code[i].opcode != ST_OP_NOP) w++;
+  }
+  map[n] = w;
+  if (w == n || w == 0) return 0;
+
+  for (uint16_t i = 0; i < n; i++) {
+    if (st_opt_is_jump(code[i].opcode) && (uint32_t)code[i].arg.int_arg <= n) {
+      code[i].arg.int_arg = map[code[i].arg.int_arg];
+    }
+  }
+
+  w = 0;
+  for (uint16_t i = 0; i < n; i++) {
+    if (code[i].opcode != ST_OP_NOP) code[w++] = code[i];
+  }
+
+  st_function_registry_t *reg = bc->func_registry;
+  if (reg) {
+    for (uint8_t f = reg->builtin_count; f < reg->builtin_count + reg->user_count; f++) {
+      st_function_entry_t *func = &reg->functions[f];
+      uint32_t end = (uint32_t)func->bytecode_addr + func->bytecode_size;
+      if (end > n) continue;
+      func->bytecode_size = map[end] - map[func->bytecode_addr];
+      func->bytecode_addr = map[func->bytecode_addr];
+    }
+  }
+
+  if (line_map) {
+    for (uint16_t l = 0; l < ST_LINE_MAP_MAX; l++) {
+      uint16_t pc = line_map->pc_for_line[l];
+      if (pc == 0xFFFF || pc > n) continue;
+      line_map->pc_for_line[l] = (map[pc] < w) ? map[pc] : 0xFFFF;
+    }
+  }
+
+  bc->instr_count = w;
+  return n - w;
+}
+
+/* ============================================================================
+ * PUBLIC API
+ * ============================================================================ */
+
+bool st_optimizer_run(st_bytecode_program_t *bytecode, st_line_map_t *line_map,
+                      st_optimizer_stats_t *stats) {
+  st_optimizer_stats_t local_stats;
+  if (!stats) stats = &local_stats;
+  memset(stats, 0, sizeof(*stats));
+
+  if (!bytecode || !bytecode->instructions || bytecode->instr_count == 0) return false;
+
+  uint16_t n = bytecode->instr_count;
+  stats->instr_before = n;
+  stats->instr_after = n;
+
+  uint8_t *flags = (uint8_t *)malloc(n);
+  uint16_t *scratch = (uint16_t *)malloc(((size_t)n + 1) * sizeof(uint16_t));
+  if (!flags || !scratch) {
+    free(flags);
+    free(scratch);
+    debug_printf("[OPT] Skipped: no heap for %u instructions\n", n);
+    return false;
+  }
+
+  for (uint8_t round = 0; round < ST_OPT_MAX_ROUNDS; round++) {
+    uint16_t removed = 0;
+
+    st_opt_mark_targets(bytecode, flags);
+    stats->folded += st_opt_fold(bytecode, flags);
+    removed += st_opt_compact(bytecode, line_map, scratch);
+
+    st_opt_mark_targets(bytecode, flags);
+    stats->dead_stores += st_opt_dead_stores(bytecode, flags);
+    removed += st_opt_compact(bytecode, line_map, scratch);
+
+    st_opt_mark_targets(bytecode, flags);
+    stats->fused += st_opt_fuse_inc(bytecode, flags);
+    removed += st_opt_compact(bytecode, line_map, scratch);
+
+    stats->jumps_threaded += st_opt_thread_jumps(bytecode);
+    removed += st_opt_compact(bytecode, line_map, scratch);
+
+    stats->unreachable += st_opt_remove_unreachable(bytecode, flags, scratch);
+    removed += st_opt_compact(bytecode, line_map, scratch);
+
+    if (removed == 0) break;
+  }
+
+  free(flags);
+  free(scratch);
+
+  // Give the removed tail back to the heap
+  if (bytecode->instr_count < n) {
+    st_bytecode_instr_t *shrunk = (st_bytecode_instr_t *)realloc(
+        bytecode->instructions, bytecode->instr_count * sizeof(st_bytecode_instr_t));
+    if (shrunk) bytecode->instructions = shrunk;
+  }
+  bytecode->instr_capacity = bytecode->instr_count;
+  bytecode->unoptimized_count = n;
+
+  stats->instr_after = bytecode->instr_count;
+  return stats->instr_after < stats->instr_before;
+}
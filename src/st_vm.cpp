@@ -8,6 +8,7 @@
 #include "st_vm.h"
 #include "st_builtins.h"
 #include "st_builtin_modbus.h"
+#include "mb_async.h"          // v7.9.8.16: payload slots for MB_*_HOLDINGS
 #include "st_stateful.h"  // For st_stateful_storage_t cast
 #include "st_builtin_edge.h"
 #include "st_builtin_timers.h"
@@ -58,6 +59,29 @@ void st_vm_init(st_vm_t *vm, const st_bytecode_program_t *program) {
   vm->func_registry = NULL;  // Set externally if user functions are used
 }
 
+void st_vm_begin_cycle(st_vm_t *vm, const st_bytecode_program_t *program) {
+  // v7.9.8.5: Long-lived VM - reset only what a scan can observe.
+  // Value/type stacks are not cleared: slots above sp are never read.
+  vm->program = program;
+  vm->pc = 0;
+  vm->sp = 0;
+  vm->halted = 0;
+  vm->error = 0;
+  vm->error_msg[0] = '\0';
+  vm->var_count = program ? program->var_count : 0;
+  vm->call_depth = 0;
+  vm->local_base = 0;
+  vm->func_registry = NULL;  // Set externally if user functions are used
+  vm->step_count = 0;
+  vm->max_stack_depth = 0;
+
+  // Function locals start at zero every scan (same as st_vm_init)
+  if (program && program->func_registry) {
+    memset(vm->local_vars, 0, sizeof(vm->local_vars));
+    memset(vm->local_types, 0, sizeof(vm->local_types));
+  }
+}
+
 void st_vm_reset(st_vm_t *vm) {
   if (!vm->program) return;
 
@@ -869,7 +893,7 @@ static bool st_vm_exec_lt(st_vm_t *vm, st_bytecode_instr_t *instr) {
   } else if (left_type == ST_TYPE_DINT || right_type == ST_TYPE_DINT) {
     // DINT comparison (promote INT to DINT)
     int32_t left_d = (left_type == ST_TYPE_DINT) ? left.dint_val : (int32_t)left.int_val;
-    int32_t right_d = (right_type == ST_TYPE_DINT) ? right.dint_val : (int32_t)right.dint_val;
+    int32_t right_d = (right_type == ST_TYPE_DINT) ? right.dint_val : (int32_t)right.int_val;  // BUG-325
     result.bool_val = (left_d < right_d);
   } else {
     // INT comparison (16-bit)
@@ -965,6 +989,306 @@ static bool st_vm_exec_ge(st_vm_t *vm, st_bytecode_instr_t *instr) {
   return st_vm_push_typed(vm, result, ST_TYPE_BOOL);
 }
 
+/* ============================================================================
+ * FEAT-149: STATICALLY TYPED OPERATIONS
+ *
+ * Emitted by the compiler only when both operand types are known (mixed
+ * operands get an explicit CVT_* first). Operands are read straight off the
+ * value stack: no type_stack reads and no type-combination branches. The
+ * result type is still written so STORE_VAR, builtins and the debugger see
+ * the same type_stack as with the generic opcodes.
+ *
+ * Results, wrap-around and NaN/INF errors are identical to ADD/SUB/MUL/DIV
+ * and EQ..GE for the same operand types.
+ * ============================================================================ */
+
+// Pop right operand; left operand is replaced in place by the result
+#define ST_VM_TYPED_OPERANDS(l, r) \
+  if (vm->sp < 2) { \
+    snprintf(vm->error_msg, sizeof(vm->error_msg), "Stack underflow"); \
+    vm->error = 1; \
+    return false; \
+  } \
+  vm->sp--; \
+  st_value_t *l = &vm->stack[vm->sp - 1]; \
+  const st_value_t r = vm->stack[vm->sp];
+
+#define ST_VM_TYPED_INT_OP(name, op) \
+static bool name(st_vm_t *vm, st_bytecode_instr_t *instr) { \
+  ST_VM_TYPED_OPERANDS(l, r) \
+  l->int_val = (int16_t)(l->int_val op r.int_val); \
+  vm->type_stack[vm->sp - 1] = ST_TYPE_INT; \
+  return true; \
+}
+
+#define ST_VM_TYPED_DINT_OP(name, op) \
+static bool name(st_vm_t *vm, st_bytecode_instr_t *instr) { \
+  ST_VM_TYPED_OPERANDS(l, r) \
+  l->dint_val = l->dint_val op r.dint_val; \
+  vm->type_stack[vm->sp - 1] = ST_TYPE_DINT; \
+  return true; \
+}
+
+#define ST_VM_TYPED_REAL_OP(name, op, opname) \
+static bool name(st_vm_t *vm, st_bytecode_instr_t *instr) { \
+  ST_VM_TYPED_OPERANDS(l, r) \
+  float res = l->real_val op r.real_val; \
+  if (isnan(res) || isinf(res)) { \
+    snprintf(vm->error_msg, sizeof(vm->error_msg), "Arithmetic overflow (NaN/INF in " opname ")"); \
+    return false; \
+  } \
+  l->real_val = res; \
+  vm->type_stack[vm->sp - 1] = ST_TYPE_REAL; \
+  return true; \
+}
+
+#define ST_VM_TYPED_CMP_OP(name, field, op) \
+static bool name(st_vm_t *vm, st_bytecode_instr_t *instr) { \
+  ST_VM_TYPED_OPERANDS(l, r) \
+  l->bool_val = (l->field op r.field); \
+  vm->type_stack[vm->sp - 1] = ST_TYPE_BOOL; \
+  return true; \
+}
+
+ST_VM_TYPED_INT_OP(st_vm_exec_add_int, +)
+ST_VM_TYPED_INT_OP(st_vm_exec_sub_int, -)
+ST_VM_TYPED_INT_OP(st_vm_exec_mul_int, *)
+ST_VM_TYPED_DINT_OP(st_vm_exec_add_dint, +)
+ST_VM_TYPED_DINT_OP(st_vm_exec_sub_dint, -)
+ST_VM_TYPED_DINT_OP(st_vm_exec_mul_dint, *)
+ST_VM_TYPED_REAL_OP(st_vm_exec_add_real, +, "ADD")
+ST_VM_TYPED_REAL_OP(st_vm_exec_sub_real, -, "SUB")
+ST_VM_TYPED_REAL_OP(st_vm_exec_mul_real, *, "MUL")
+
+ST_VM_TYPED_CMP_OP(st_vm_exec_eq_int, int_val, ==)
+ST_VM_TYPED_CMP_OP(st_vm_exec_ne_int, int_val, !=)
+ST_VM_TYPED_CMP_OP(st_vm_exec_lt_int, int_val, <)
+ST_VM_TYPED_CMP_OP(st_vm_exec_gt_int, int_val, >)
+ST_VM_TYPED_CMP_OP(st_vm_exec_le_int, int_val, <=)
+ST_VM_TYPED_CMP_OP(st_vm_exec_ge_int, int_val, >=)
+ST_VM_TYPED_CMP_OP(st_vm_exec_eq_dint, dint_val, ==)
+ST_VM_TYPED_CMP_OP(st_vm_exec_ne_dint, dint_val, !=)
+ST_VM_TYPED_CMP_OP(st_vm_exec_lt_dint, dint_val, <)
+ST_VM_TYPED_CMP_OP(st_vm_exec_gt_dint, dint_val, >)
+ST_VM_TYPED_CMP_OP(st_vm_exec_le_dint, dint_val, <=)
+ST_VM_TYPED_CMP_OP(st_vm_exec_ge_dint, dint_val, >=)
+ST_VM_TYPED_CMP_OP(st_vm_exec_eq_real, real_val, ==)
+ST_VM_TYPED_CMP_OP(st_vm_exec_ne_real, real_val, !=)
+ST_VM_TYPED_CMP_OP(st_vm_exec_lt_real, real_val, <)
+ST_VM_TYPED_CMP_OP(st_vm_exec_gt_real, real_val, >)
+ST_VM_TYPED_CMP_OP(st_vm_exec_le_real, real_val, <=)
+ST_VM_TYPED_CMP_OP(st_vm_exec_ge_real, real_val, >=)
+
+static bool st_vm_exec_div_real(st_vm_t *vm, st_bytecode_instr_t *instr) {
+  ST_VM_TYPED_OPERANDS(l, r)
+  if (r.real_val == 0.0f) {
+    snprintf(vm->error_msg, sizeof(vm->error_msg), "Division by zero");
+    vm->error = 1;
+    return false;
+  }
+  float res = l->real_val / r.real_val;
+  if (isnan(res) || isinf(res)) {
+    snprintf(vm->error_msg, sizeof(vm->error_msg), "Arithmetic overflow (NaN/INF in DIV)");
+    return false;
+  }
+  l->real_val = res;
+  vm->type_stack[vm->sp - 1] = ST_TYPE_REAL;
+  return true;
+}
+
+#undef ST_VM_TYPED_CMP_OP
+#undef ST_VM_TYPED_REAL_OP
+#undef ST_VM_TYPED_DINT_OP
+#undef ST_VM_TYPED_INT_OP
+#undef ST_VM_TYPED_OPERANDS
+
+// Explicit conversions of the top-of-stack value (compiler-inserted)
+static bool st_vm_exec_cvt_int_dint(st_vm_t *vm, st_bytecode_instr_t *instr) {
+  if (vm->sp == 0) {
+    snprintf(vm->error_msg, sizeof(vm->error_msg), "Stack underflow");
+    vm->error = 1;
+    return false;
+  }
+  st_value_t *v = &vm->stack[vm->sp - 1];
+  v->dint_val = (int32_t)v->int_val;
+  vm->type_stack[vm->sp - 1] = ST_TYPE_DINT;
+  return true;
+}
+
+static bool st_vm_exec_cvt_int_real(st_vm_t *vm, st_bytecode_instr_t *instr) {
+  if (vm->sp == 0) {
+    snprintf(vm->error_msg, sizeof(vm->error_msg), "Stack underflow");
+    vm->error = 1;
+    return false;
+  }
+  st_value_t *v = &vm->stack[vm->sp - 1];
+  v->real_val = (float)v->int_val;
+  vm->type_stack[vm->sp - 1] = ST_TYPE_REAL;
+  return true;
+}
+
+static bool st_vm_exec_cvt_dint_real(st_vm_t *vm, st_bytecode_instr_t *instr) {
+  if (vm->sp == 0) {
+    snprintf(vm->error_msg, sizeof(vm->error_msg), "Stack underflow");
+    vm->error = 1;
+    return false;
+  }
+  st_value_t *v = &vm->stack[vm->sp - 1];
+  v->real_val = (float)v->dint_val;
+  vm->type_stack[vm->sp - 1] = ST_TYPE_REAL;
+  return true;
+}
+
+/* ============================================================================
+ * FEAT-151: FUSED VARIABLE INCREMENT
+ *
+ * Emitted by the bytecode optimizer for "x := x + k" / "x := x - k" on INT
+ * and DINT variables (LOAD_VAR, PUSH_INT, ADD, STORE_VAR). Same wrap-around
+ * as ADD; the stack is not touched.
+ * ============================================================================ */
+
+static bool st_vm_exec_inc_var(st_vm_t *vm, st_bytecode_instr_t *instr) {
+  uint8_t idx = instr->arg.var_inc.var_index;
+  st_value_t val = st_vm_get_variable(vm, idx);
+  if (vm->error) return false;
+
+  if (vm->program->var_types[idx] == ST_TYPE_DINT) {
+    val.dint_val = (int32_t)((uint32_t)val.dint_val + (uint32_t)(int32_t)instr->arg.var_inc.delta);
+  } else {
+    val.int_val = (int16_t)(val.int_val + instr->arg.var_inc.delta);
+  }
+  st_vm_set_variable(vm, idx, val);
+  return !vm->error;
+}
+
+/* ============================================================================
+ * FEAT-152: IEC FUNCTION SUPERINSTRUCTIONS
+ *
+ * Emitted by the compiler instead of CALL_BUILTIN for TON/TOF/TP, CTU/CTD,
+ * R_TRIG/F_TRIG, LIMIT and SCALE. Arity and operand types are fixed at
+ * compile time, so the handlers take their arguments straight off the stack
+ * and call the kernel - no arg-count lookup, type-stack decode or func_id
+ * chain. The result replaces the first argument in place. Stateful instances
+ * are bounds-checked with the same errors as CALL_BUILTIN.
+ * ============================================================================ */
+
+// Arguments a[0..n-1] (a[0] deepest); stack keeps one slot for the result
+#define ST_VM_FUSED_ARGS(a, n) \
+  if (vm->sp < (n)) { \
+    snprintf(vm->error_msg, sizeof(vm->error_msg), "Stack underflow"); \
+    vm->error = 1; \
+    return false; \
+  } \
+  vm->sp -= (n) - 1; \
+  st_value_t *a = &vm->stack[vm->sp - 1];
+
+static st_stateful_storage_t *st_vm_fused_stateful(st_vm_t *vm) {
+  st_stateful_storage_t *stateful = (st_stateful_storage_t*)vm->program->stateful;
+  if (!stateful) {
+    snprintf(vm->error_msg, sizeof(vm->error_msg), "No stateful storage allocated");
+  }
+  return stateful;
+}
+
+static st_timer_instance_t *st_vm_fused_timer(st_vm_t *vm, uint8_t instance_id) {
+  st_stateful_storage_t *stateful = st_vm_fused_stateful(vm);
+  if (!stateful) return NULL;
+  if (instance_id >= stateful->timer_count) {
+    snprintf(vm->error_msg, sizeof(vm->error_msg),
+             "Invalid timer instance ID: %d", instance_id);
+    return NULL;
+  }
+  return &stateful->timers[instance_id];
+}
+
+static st_counter_instance_t *st_vm_fused_counter(st_vm_t *vm, uint8_t instance_id) {
+  st_stateful_storage_t *stateful = st_vm_fused_stateful(vm);
+  if (!stateful) return NULL;
+  if (instance_id >= stateful->counter_count) {
+    snprintf(vm->error_msg, sizeof(vm->error_msg),
+             "Invalid counter instance ID: %d", instance_id);
+    return NULL;
+  }
+  return &stateful->counters[instance_id];
+}
+
+static st_edge_instance_t *st_vm_fused_edge(st_vm_t *vm, uint8_t instance_id) {
+  st_stateful_storage_t *stateful = st_vm_fused_stateful(vm);
+  if (!stateful) return NULL;
+  if (instance_id >= stateful->edge_count) {
+    snprintf(vm->error_msg, sizeof(vm->error_msg),
+             "Invalid edge detector instance ID: %d", instance_id);
+    return NULL;
+  }
+  return &stateful->edges[instance_id];
+}
+
+#define ST_VM_FUSED_TIMER(name, kernel) \
+static bool name(st_vm_t *vm, st_bytecode_instr_t *instr) { \
+  ST_VM_FUSED_ARGS(a, 2) \
+  st_timer_instance_t *t = st_vm_fused_timer(vm, instr->arg.builtin_call.instance_id); \
+  if (!t) return false; \
+  a[0] = kernel(a[0], a[1], t); \
+  vm->type_stack[vm->sp - 1] = ST_TYPE_BOOL; \
+  return true; \
+}
+
+#define ST_VM_FUSED_COUNTER(name, kernel) \
+static bool name(st_vm_t *vm, st_bytecode_instr_t *instr) { \
+  ST_VM_FUSED_ARGS(a, 3) \
+  st_counter_instance_t *c = st_vm_fused_counter(vm, instr->arg.builtin_call.instance_id); \
+  if (!c) return false; \
+  a[0] = kernel(a[0], a[1], a[2], c); \
+  vm->type_stack[vm->sp - 1] = ST_TYPE_BOOL; \
+  return true; \
+}
+
+#define ST_VM_FUSED_EDGE(name, kernel) \
+static bool name(st_vm_t *vm, st_bytecode_instr_t *instr) { \
+  ST_VM_FUSED_ARGS(a, 1) \
+  st_edge_instance_t *e = st_vm_fused_edge(vm, instr->arg.builtin_call.instance_id); \
+  if (!e) return false; \
+  a[0] = kernel(a[0], e); \
+  vm->type_stack[vm->sp - 1] = ST_TYPE_BOOL; \
+  return true; \
+}
+
+// LIMIT(MN, IN, MX): operands already converted to the result type; a[0] is MN
+#define ST_VM_FUSED_LIMIT(name, field, type) \
+static bool name(st_vm_t *vm, st_bytecode_instr_t *instr) { \
+  ST_VM_FUSED_ARGS(a, 3) \
+  if (!(a[1].field < a[0].field)) { \
+    a[0] = (a[1].field > a[2].field) ? a[2] : a[1]; \
+  } \
+  vm->type_stack[vm->sp - 1] = type; \
+  return true; \
+}
+
+ST_VM_FUSED_TIMER(st_vm_exec_call_ton, st_builtin_ton)
+ST_VM_FUSED_TIMER(st_vm_exec_call_tof, st_builtin_tof)
+ST_VM_FUSED_TIMER(st_vm_exec_call_tp, st_builtin_tp)
+ST_VM_FUSED_COUNTER(st_vm_exec_call_ctu, st_builtin_ctu)
+ST_VM_FUSED_COUNTER(st_vm_exec_call_ctd, st_builtin_ctd)
+ST_VM_FUSED_EDGE(st_vm_exec_call_r_trig, st_builtin_r_trig)
+ST_VM_FUSED_EDGE(st_vm_exec_call_f_trig, st_builtin_f_trig)
+ST_VM_FUSED_LIMIT(st_vm_exec_limit_int, int_val, ST_TYPE_INT)
+ST_VM_FUSED_LIMIT(st_vm_exec_limit_dint, dint_val, ST_TYPE_DINT)
+ST_VM_FUSED_LIMIT(st_vm_exec_limit_real, real_val, ST_TYPE_REAL)
+
+// SCALE(IN, IN_MIN, IN_MAX, OUT_MIN, OUT_MAX): operands already REAL
+static bool st_vm_exec_scale_real(st_vm_t *vm, st_bytecode_instr_t *instr) {
+  ST_VM_FUSED_ARGS(a, 5)
+  a[0] = st_builtin_scale(a[0], a[1], a[2], a[3], a[4]);
+  vm->type_stack[vm->sp - 1] = ST_TYPE_REAL;
+  return true;
+}
+
+#undef ST_VM_FUSED_LIMIT
+#undef ST_VM_FUSED_EDGE
+#undef ST_VM_FUSED_COUNTER
+#undef ST_VM_FUSED_TIMER
+#undef ST_VM_FUSED_ARGS
+
 /* ============================================================================
  * BITWISE OPERATIONS
  * ============================================================================ */
@@ -1071,8 +1395,9 @@ static bool st_vm_exec_call_builtin(st_vm_t *vm, st_bytecode_instr_t *instr) {
   }
 
   // Call the function (handle 3-arg functions specially)
+  // BUG-327 FIX: CTU/CTD also take 3 args but belong to the stateful branch below
   st_value_t result;
-  if (arg_count == 3) {
+  if (arg_count == 3 && func_id != ST_BUILTIN_CTU && func_id != ST_BUILTIN_CTD) {
     // Special handling for 3-arg functions
     if (func_id == ST_BUILTIN_LIMIT) {
       // BUG-119 FIX: LIMIT is type-polymorphic
@@ -1270,11 +1595,11 @@ static bool st_vm_exec_call_builtin(st_vm_t *vm, st_bytecode_instr_t *instr) {
         addr_int.int_val = arg2.int_val;
       }
 
-      // Count: clamp to 1-16
+      // Count: clamp to one payload slot (v7.9.8.16: was 16)
       if (arg3_type == ST_TYPE_DINT) {
-        count_int.int_val = (arg3.dint_val > 16) ? 16 : arg3.dint_val;
+        count_int.int_val = (arg3.dint_val > MB_PAYLOAD_REGS) ? MB_PAYLOAD_REGS : arg3.dint_val;
       } else if (arg3_type == ST_TYPE_DWORD) {
-        count_int.int_val = (arg3.dword_val > 16) ? 16 : arg3.dword_val;
+        count_int.int_val = (arg3.dword_val > MB_PAYLOAD_REGS) ? MB_PAYLOAD_REGS : arg3.dword_val;
       } else {
         count_int.int_val = arg3.int_val;
       }
@@ -1284,17 +1609,32 @@ static bool st_vm_exec_call_builtin(st_vm_t *vm, st_bytecode_instr_t *instr) {
       uint8_t cnt = (uint8_t)count_int.int_val;
 
       if (func_id == ST_BUILTIN_MB_WRITE_HOLDINGS) {
-        // Gather values from array variable slots → g_mb_multi_reg_buf
-        for (uint8_t i = 0; i < cnt && (arr_base + i) < vm->var_count; i++) {
-          g_mb_multi_reg_buf[i] = (uint16_t)vm->variables[arr_base + i].int_val;
+        // v7.9.8.16: Gather values into a payload slot owned by the request
+        uint8_t payload = mb_payload_alloc();
+        if (payload == MB_PAYLOAD_NONE) {
+          g_mb_last_error = MB_MAX_REQUESTS_EXCEEDED;
+          g_mb_success = false;
+          result.bool_val = false;
+        } else {
+          uint16_t *vals = mb_payload_data(payload);
+          memset(vals, 0, MB_PAYLOAD_REGS * sizeof(uint16_t));
+          for (uint8_t i = 0; i < cnt && (arr_base + i) < vm->var_count; i++) {
+            vals[i] = (uint16_t)vm->variables[arr_base + i].int_val;
+          }
+          result = st_builtin_mb_write_holdings(slave_int, addr_int, count_int, payload);
         }
-        result = st_builtin_mb_write_holdings(slave_int, addr_int, count_int);
       } else {
         // MB_READ_HOLDINGS: queue async read, results will populate array on next cycle
         result = st_builtin_mb_read_holdings(slave_int, addr_int, count_int);
-        // Copy current buffer values to array slots (from previous completed read)
-        for (uint8_t i = 0; i < cnt && (arr_base + i) < vm->var_count; i++) {
-          vm->variables[arr_base + i].int_val = (int16_t)g_mb_multi_reg_buf[i];
+        // v7.9.8.16: Copy the last completed read of this block (pinned while copying)
+        uint8_t slot = mb_async_block_result_pin((uint8_t)slave_int.int_val,
+                                                 (uint16_t)addr_int.int_val, cnt);
+        if (slot != MB_PAYLOAD_NONE) {
+          const uint16_t *vals = mb_payload_data(slot);
+          for (uint8_t i = 0; i < cnt && (arr_base + i) < vm->var_count; i++) {
+            vm->variables[arr_base + i].int_val = (int16_t)vals[i];
+          }
+          mb_payload_release(slot);
         }
       }
     }
@@ -1971,6 +2311,267 @@ static bool st_vm_exec_jmp_if_true(st_vm_t *vm, st_bytecode_instr_t *instr) {
   return true;
 }
 
+/* ============================================================================
+ * FUNCTION CALLS / FB FIELDS
+ * ============================================================================ */
+
+// FEAT-122: Load FB instance field (timer Q/ET, counter Q/QU/QD/CV)
+static bool st_vm_exec_load_fb_field(st_vm_t *vm, st_bytecode_instr_t *instr) {
+  uint8_t fb_type = instr->arg.fb_field.fb_type;
+  uint8_t inst_id = instr->arg.fb_field.instance_id;
+  uint8_t field_id = instr->arg.fb_field.field_id;
+
+  if (!vm->program || !vm->program->stateful) {
+    snprintf(vm->error_msg, sizeof(vm->error_msg), "No stateful storage for LOAD_FB_FIELD");
+    vm->error = 1;
+    return false;
+  }
+
+  st_stateful_storage_t *stateful = (st_stateful_storage_t *)vm->program->stateful;
+  st_value_t val;
+  st_datatype_t val_type = ST_TYPE_BOOL;
+  memset(&val, 0, sizeof(val));
+
+  if (fb_type == 0) {
+    // Timer: field 0=Q, 1=ET
+    if (inst_id >= stateful->timer_count) {
+      snprintf(vm->error_msg, sizeof(vm->error_msg), "Timer instance %d out of range", inst_id);
+      vm->error = 1;
+      return false;
+    }
+    st_timer_instance_t *ti = &stateful->timers[inst_id];
+    if (field_id == 0) {
+      val.bool_val = ti->Q;
+      val_type = ST_TYPE_BOOL;
+    } else if (field_id == 1) {
+      val.dint_val = (int32_t)ti->ET;
+      val_type = ST_TYPE_DINT;  // TIME represented as DINT in VM
+    }
+  } else if (fb_type == 1) {
+    // Counter: field 0=Q/QU, 1=QD, 2=CV
+    if (inst_id >= stateful->counter_count) {
+      snprintf(vm->error_msg, sizeof(vm->error_msg), "Counter instance %d out of range", inst_id);
+      vm->error = 1;
+      return false;
+    }
+    st_counter_instance_t *ci = &stateful->counters[inst_id];
+    if (field_id == 0) {
+      val.bool_val = ci->Q;
+      val_type = ST_TYPE_BOOL;
+    } else if (field_id == 1) {
+      val.bool_val = ci->QD;
+      val_type = ST_TYPE_BOOL;
+    } else if (field_id == 2) {
+      val.dint_val = ci->CV;
+      val_type = ST_TYPE_DINT;
+    }
+  } else {
+    snprintf(vm->error_msg, sizeof(vm->error_msg), "Unknown FB type %d in LOAD_FB_FIELD", fb_type);
+    vm->error = 1;
+    return false;
+  }
+
+  // Push value onto stack
+  if (vm->sp >= 64) {
+    snprintf(vm->error_msg, sizeof(vm->error_msg), "Stack overflow in LOAD_FB_FIELD");
+    vm->error = 1;
+    return false;
+  }
+  vm->stack[vm->sp] = val;
+  vm->type_stack[vm->sp] = val_type;
+  vm->sp++;
+  return true;
+}
+
+// FEAT-003: Call user-defined function (sets PC to function entry)
+static bool st_vm_exec_call_user(st_vm_t *vm, st_bytecode_instr_t *instr) {
+  // Get function index and FB instance ID from instruction
+  uint8_t func_index = instr->arg.user_call.func_index;
+  uint8_t fb_inst_id = instr->arg.user_call.instance_id;
+
+  // Check if function registry is available
+  if (!vm->func_registry) {
+    snprintf(vm->error_msg, sizeof(vm->error_msg), "No function registry available");
+    vm->error = 1;
+    return false;
+  }
+
+  // Check function index bounds
+  if (func_index >= vm->func_registry->builtin_count + vm->func_registry->user_count) {
+    snprintf(vm->error_msg, sizeof(vm->error_msg), "Invalid function index: %d", func_index);
+    vm->error = 1;
+    return false;
+  }
+
+  // Check call depth
+  if (vm->call_depth >= 8) {
+    snprintf(vm->error_msg, sizeof(vm->error_msg), "Call stack overflow (max 8 nested calls)");
+    vm->error = 1;
+    return false;
+  }
+
+  // Get function entry
+  const st_function_entry_t *func = &vm->func_registry->functions[func_index];
+
+  // Push call frame
+  st_call_frame_t *frame = &vm->call_stack[vm->call_depth];
+  frame->return_pc = vm->pc;  // Return to next instruction
+  frame->param_base = vm->sp - func->param_count;  // Parameters are on stack
+  frame->param_count = func->param_count;
+  frame->local_count = 0;  // Will be set by function prologue
+  frame->func_index = func_index;
+  frame->fb_instance_id = fb_inst_id;  // Phase 5: Track FB instance
+
+  // Phase 5: Load FB instance state into local_vars
+  if (fb_inst_id != 0xFF && fb_inst_id < ST_MAX_FB_INSTANCES) {
+    st_fb_instance_t *inst = &((st_function_registry_t *)vm->func_registry)->fb_instances[fb_inst_id];
+    if (inst->initialized) {
+      // Restore persistent local variables from instance storage
+      uint8_t count = inst->local_count;
+      if (count > ST_MAX_FB_LOCALS) count = ST_MAX_FB_LOCALS;
+      for (uint8_t i = 0; i < count; i++) {
+        if (vm->local_base + i < 64) {
+          vm->local_vars[vm->local_base + i] = inst->local_vars[i];
+          vm->local_types[vm->local_base + i] = inst->local_types[i];
+        }
+      }
+    }
+  }
+
+  vm->call_depth++;
+
+  // Jump to function code
+  vm->pc = func->bytecode_addr;
+  return true;
+}
+
+// FEAT-003: Return from function (restores PC to the CALL_USER instruction)
+static bool st_vm_exec_return(st_vm_t *vm, st_bytecode_instr_t *instr) {
+  // Check we're in a function
+  if (vm->call_depth == 0) {
+    snprintf(vm->error_msg, sizeof(vm->error_msg), "RETURN outside of function");
+    vm->error = 1;
+    return false;
+  }
+
+  // Get return value from stack (if any)
+  st_value_t return_value;
+  st_datatype_t return_type = ST_TYPE_NONE;
+  if (vm->sp > 0) {
+    st_vm_pop_typed(vm, &return_value, &return_type);
+  }
+
+  // Pop call frame
+  vm->call_depth--;
+  st_call_frame_t *frame = &vm->call_stack[vm->call_depth];
+
+  // Phase 5: Save FB instance state (persist local variables)
+  if (frame->fb_instance_id != 0xFF && frame->fb_instance_id < ST_MAX_FB_INSTANCES && vm->func_registry) {
+    st_fb_instance_t *inst = &((st_function_registry_t *)vm->func_registry)->fb_instances[frame->fb_instance_id];
+    // Count local variables used by this function (from function entry metadata)
+    const st_function_entry_t *func = &vm->func_registry->functions[frame->func_index];
+    // Store the local variable count based on the function's instance_size field
+    // (we repurpose instance_size to count locals for FBs)
+    uint8_t local_count = func->instance_size;
+    if (local_count > ST_MAX_FB_LOCALS) local_count = ST_MAX_FB_LOCALS;
+    for (uint8_t i = 0; i < local_count; i++) {
+      if (vm->local_base + i < 64) {
+        inst->local_vars[i] = vm->local_vars[vm->local_base + i];
+        inst->local_types[i] = vm->local_types[vm->local_base + i];
+      }
+    }
+    inst->local_count = local_count;
+    inst->func_index = frame->func_index;
+    inst->initialized = 1;
+  }
+
+  // Restore PC
+  vm->pc = frame->return_pc;
+
+  // Pop parameters from stack
+  vm->sp = frame->param_base;
+
+  // Push return value (if any)
+  if (return_type != ST_TYPE_NONE) {
+    st_vm_push_typed(vm, return_value, return_type);
+  }
+
+  return true;
+}
+
+// FEAT-003: Load function parameter from call frame
+static bool st_vm_exec_load_param(st_vm_t *vm, st_bytecode_instr_t *instr) {
+  // Load parameter from call frame
+  if (vm->call_depth == 0) {
+    snprintf(vm->error_msg, sizeof(vm->error_msg), "LOAD_PARAM outside of function");
+    vm->error = 1;
+    return false;
+  }
+
+  uint8_t param_index = (uint8_t)instr->arg.var_index;
+  st_call_frame_t *frame = &vm->call_stack[vm->call_depth - 1];
+
+  if (param_index >= frame->param_count) {
+    snprintf(vm->error_msg, sizeof(vm->error_msg), "Parameter index out of bounds: %d", param_index);
+    vm->error = 1;
+    return false;
+  }
+
+  // Parameters are stored on stack at param_base
+  uint8_t stack_index = frame->param_base + param_index;
+  st_vm_push_typed(vm, vm->stack[stack_index], vm->type_stack[stack_index]);
+  return true;
+}
+
+// FEAT-003: Store to function local variable
+static bool st_vm_exec_store_local(st_vm_t *vm, st_bytecode_instr_t *instr) {
+  // Store to local variable
+  if (vm->call_depth == 0) {
+    snprintf(vm->error_msg, sizeof(vm->error_msg), "STORE_LOCAL outside of function");
+    vm->error = 1;
+    return false;
+  }
+
+  uint8_t local_index = (uint8_t)instr->arg.var_index;
+  if (vm->local_base + local_index >= 64) {
+    snprintf(vm->error_msg, sizeof(vm->error_msg), "Local variable overflow");
+    vm->error = 1;
+    return false;
+  }
+
+  st_value_t value;
+  st_datatype_t type;
+  if (!st_vm_pop_typed(vm, &value, &type)) {
+    return false;
+  }
+
+  vm->local_vars[vm->local_base + local_index] = value;
+  vm->local_types[vm->local_base + local_index] = type;
+  return true;
+}
+
+// FEAT-003: Load function local variable
+static bool st_vm_exec_load_local(st_vm_t *vm, st_bytecode_instr_t *instr) {
+  // Load local variable
+  if (vm->call_depth == 0) {
+    snprintf(vm->error_msg, sizeof(vm->error_msg), "LOAD_LOCAL outside of function");
+    vm->error = 1;
+    return false;
+  }
+
+  uint8_t local_index = (uint8_t)instr->arg.var_index;
+  if (vm->local_base + local_index >= 64) {
+    snprintf(vm->error_msg, sizeof(vm->error_msg), "Local variable overflow");
+    vm->error = 1;
+    return false;
+  }
+
+  st_value_t value = vm->local_vars[vm->local_base + local_index];
+  st_datatype_t type = vm->local_types[vm->local_base + local_index];
+  st_vm_push_typed(vm, value, type);
+  return true;
+}
+
 /* ============================================================================
  * MAIN EXECUTION ENGINE
  * ============================================================================ */
@@ -2028,263 +2629,70 @@ bool st_vm_step(st_vm_t *vm) {
     case ST_OP_LOAD_ARRAY:      result = st_vm_exec_load_array(vm, instr); break;
     case ST_OP_STORE_ARRAY:     result = st_vm_exec_store_array(vm, instr); break;
     // FEAT-122: Load FB instance field (timer Q/ET, counter Q/QU/QD/CV)
-    case ST_OP_LOAD_FB_FIELD: {
-      uint8_t fb_type = instr->arg.fb_field.fb_type;
-      uint8_t inst_id = instr->arg.fb_field.instance_id;
-      uint8_t field_id = instr->arg.fb_field.field_id;
-
-      if (!vm->program || !vm->program->stateful) {
-        snprintf(vm->error_msg, sizeof(vm->error_msg), "No stateful storage for LOAD_FB_FIELD");
-        vm->error = 1;
-        return false;
-      }
-
-      st_stateful_storage_t *stateful = (st_stateful_storage_t *)vm->program->stateful;
-      st_value_t val;
-      st_datatype_t val_type = ST_TYPE_BOOL;
-      memset(&val, 0, sizeof(val));
-
-      if (fb_type == 0) {
-        // Timer: field 0=Q, 1=ET
-        if (inst_id >= stateful->timer_count) {
-          snprintf(vm->error_msg, sizeof(vm->error_msg), "Timer instance %d out of range", inst_id);
-          vm->error = 1;
-          return false;
-        }
-        st_timer_instance_t *ti = &stateful->timers[inst_id];
-        if (field_id == 0) {
-          val.bool_val = ti->Q;
-          val_type = ST_TYPE_BOOL;
-        } else if (field_id == 1) {
-          val.dint_val = (int32_t)ti->ET;
-          val_type = ST_TYPE_DINT;  // TIME represented as DINT in VM
-        }
-      } else if (fb_type == 1) {
-        // Counter: field 0=Q/QU, 1=QD, 2=CV
-        if (inst_id >= stateful->counter_count) {
-          snprintf(vm->error_msg, sizeof(vm->error_msg), "Counter instance %d out of range", inst_id);
-          vm->error = 1;
-          return false;
-        }
-        st_counter_instance_t *ci = &stateful->counters[inst_id];
-        if (field_id == 0) {
-          val.bool_val = ci->Q;
-          val_type = ST_TYPE_BOOL;
-        } else if (field_id == 1) {
-          val.bool_val = ci->QD;
-          val_type = ST_TYPE_BOOL;
-        } else if (field_id == 2) {
-          val.dint_val = ci->CV;
-          val_type = ST_TYPE_DINT;
-        }
-      } else {
-        snprintf(vm->error_msg, sizeof(vm->error_msg), "Unknown FB type %d in LOAD_FB_FIELD", fb_type);
+    case ST_OP_LOAD_FB_FIELD:   result = st_vm_exec_load_fb_field(vm, instr); break;
+    // FEAT-003: User-defined function opcodes
+    case ST_OP_RETURN:          result = st_vm_exec_return(vm, instr); break;
+    case ST_OP_LOAD_PARAM:      result = st_vm_exec_load_param(vm, instr); break;
+    case ST_OP_STORE_LOCAL:     result = st_vm_exec_store_local(vm, instr); break;
+    case ST_OP_LOAD_LOCAL:      result = st_vm_exec_load_local(vm, instr); break;
+    case ST_OP_CALL_USER:
+      if (!st_vm_exec_call_user(vm, instr)) {
         vm->error = 1;
         return false;
       }
+      vm->step_count++;  // Counted like st_vm_run_fast (same step statistics)
+      return true;  // Don't increment PC - we just set it
 
-      // Push value onto stack
-      if (vm->sp >= 64) {
-        snprintf(vm->error_msg, sizeof(vm->error_msg), "Stack overflow in LOAD_FB_FIELD");
-        vm->error = 1;
-        return false;
-      }
-      vm->stack[vm->sp] = val;
-      vm->type_stack[vm->sp] = val_type;
-      vm->sp++;
-      break;
-    }
+    // FEAT-149: Statically typed opcodes
+    case ST_OP_ADD_INT:         result = st_vm_exec_add_int(vm, instr); break;
+    case ST_OP_ADD_DINT:        result = st_vm_exec_add_dint(vm, instr); break;
+    case ST_OP_ADD_REAL:        result = st_vm_exec_add_real(vm, instr); break;
+    case ST_OP_SUB_INT:         result = st_vm_exec_sub_int(vm, instr); break;
+    case ST_OP_SUB_DINT:        result = st_vm_exec_sub_dint(vm, instr); break;
+    case ST_OP_SUB_REAL:        result = st_vm_exec_sub_real(vm, instr); break;
+    case ST_OP_MUL_INT:         result = st_vm_exec_mul_int(vm, instr); break;
+    case ST_OP_MUL_DINT:        result = st_vm_exec_mul_dint(vm, instr); break;
+    case ST_OP_MUL_REAL:        result = st_vm_exec_mul_real(vm, instr); break;
+    case ST_OP_DIV_REAL:        result = st_vm_exec_div_real(vm, instr); break;
+    case ST_OP_EQ_INT:          result = st_vm_exec_eq_int(vm, instr); break;
+    case ST_OP_EQ_DINT:         result = st_vm_exec_eq_dint(vm, instr); break;
+    case ST_OP_EQ_REAL:         result = st_vm_exec_eq_real(vm, instr); break;
+    case ST_OP_NE_INT:          result = st_vm_exec_ne_int(vm, instr); break;
+    case ST_OP_NE_DINT:         result = st_vm_exec_ne_dint(vm, instr); break;
+    case ST_OP_NE_REAL:         result = st_vm_exec_ne_real(vm, instr); break;
+    case ST_OP_LT_INT:          result = st_vm_exec_lt_int(vm, instr); break;
+    case ST_OP_LT_DINT:         result = st_vm_exec_lt_dint(vm, instr); break;
+    case ST_OP_LT_REAL:         result = st_vm_exec_lt_real(vm, instr); break;
+    case ST_OP_GT_INT:          result = st_vm_exec_gt_int(vm, instr); break;
+    case ST_OP_GT_DINT:         result = st_vm_exec_gt_dint(vm, instr); break;
+    case ST_OP_GT_REAL:         result = st_vm_exec_gt_real(vm, instr); break;
+    case ST_OP_LE_INT:          result = st_vm_exec_le_int(vm, instr); break;
+    case ST_OP_LE_DINT:         result = st_vm_exec_le_dint(vm, instr); break;
+    case ST_OP_LE_REAL:         result = st_vm_exec_le_real(vm, instr); break;
+    case ST_OP_GE_INT:          result = st_vm_exec_ge_int(vm, instr); break;
+    case ST_OP_GE_DINT:         result = st_vm_exec_ge_dint(vm, instr); break;
+    case ST_OP_GE_REAL:         result = st_vm_exec_ge_real(vm, instr); break;
+    case ST_OP_CVT_INT_DINT:    result = st_vm_exec_cvt_int_dint(vm, instr); break;
+    case ST_OP_CVT_INT_REAL:    result = st_vm_exec_cvt_int_real(vm, instr); break;
+    case ST_OP_CVT_DINT_REAL:   result = st_vm_exec_cvt_dint_real(vm, instr); break;
+    case ST_OP_INC_VAR:         result = st_vm_exec_inc_var(vm, instr); break;  // FEAT-151
+    case ST_OP_CALL_TON:        result = st_vm_exec_call_ton(vm, instr); break;  // FEAT-152
+    case ST_OP_CALL_TOF:        result = st_vm_exec_call_tof(vm, instr); break;
+    case ST_OP_CALL_TP:         result = st_vm_exec_call_tp(vm, instr); break;
+    case ST_OP_CALL_CTU:        result = st_vm_exec_call_ctu(vm, instr); break;
+    case ST_OP_CALL_CTD:        result = st_vm_exec_call_ctd(vm, instr); break;
+    case ST_OP_CALL_R_TRIG:     result = st_vm_exec_call_r_trig(vm, instr); break;
+    case ST_OP_CALL_F_TRIG:     result = st_vm_exec_call_f_trig(vm, instr); break;
+    case ST_OP_LIMIT_INT:       result = st_vm_exec_limit_int(vm, instr); break;
+    case ST_OP_LIMIT_DINT:      result = st_vm_exec_limit_dint(vm, instr); break;
+    case ST_OP_LIMIT_REAL:      result = st_vm_exec_limit_real(vm, instr); break;
+    case ST_OP_SCALE_REAL:      result = st_vm_exec_scale_real(vm, instr); break;
 
     case ST_OP_NOP:             break;
     case ST_OP_HALT:
       vm->halted = 1;
       return false;
 
-    // FEAT-003: User-defined function opcodes
-    case ST_OP_CALL_USER: {
-      // Get function index and FB instance ID from instruction
-      uint8_t func_index = instr->arg.user_call.func_index;
-      uint8_t fb_inst_id = instr->arg.user_call.instance_id;
-
-      // Check if function registry is available
-      if (!vm->func_registry) {
-        snprintf(vm->error_msg, sizeof(vm->error_msg), "No function registry available");
-        vm->error = 1;
-        return false;
-      }
-
-      // Check function index bounds
-      if (func_index >= vm->func_registry->builtin_count + vm->func_registry->user_count) {
-        snprintf(vm->error_msg, sizeof(vm->error_msg), "Invalid function index: %d", func_index);
-        vm->error = 1;
-        return false;
-      }
-
-      // Check call depth
-      if (vm->call_depth >= 8) {
-        snprintf(vm->error_msg, sizeof(vm->error_msg), "Call stack overflow (max 8 nested calls)");
-        vm->error = 1;
-        return false;
-      }
-
-      // Get function entry
-      const st_function_entry_t *func = &vm->func_registry->functions[func_index];
-
-      // Push call frame
-      st_call_frame_t *frame = &vm->call_stack[vm->call_depth];
-      frame->return_pc = vm->pc;  // Return to next instruction
-      frame->param_base = vm->sp - func->param_count;  // Parameters are on stack
-      frame->param_count = func->param_count;
-      frame->local_count = 0;  // Will be set by function prologue
-      frame->func_index = func_index;
-      frame->fb_instance_id = fb_inst_id;  // Phase 5: Track FB instance
-
-      // Phase 5: Load FB instance state into local_vars
-      if (fb_inst_id != 0xFF && fb_inst_id < ST_MAX_FB_INSTANCES) {
-        st_fb_instance_t *inst = &((st_function_registry_t *)vm->func_registry)->fb_instances[fb_inst_id];
-        if (inst->initialized) {
-          // Restore persistent local variables from instance storage
-          uint8_t count = inst->local_count;
-          if (count > ST_MAX_FB_LOCALS) count = ST_MAX_FB_LOCALS;
-          for (uint8_t i = 0; i < count; i++) {
-            if (vm->local_base + i < 64) {
-              vm->local_vars[vm->local_base + i] = inst->local_vars[i];
-              vm->local_types[vm->local_base + i] = inst->local_types[i];
-            }
-          }
-        }
-      }
-
-      vm->call_depth++;
-
-      // Jump to function code
-      vm->pc = func->bytecode_addr;
-      return true;  // Don't increment PC - we just set it
-    }
-
-    case ST_OP_RETURN: {
-      // Check we're in a function
-      if (vm->call_depth == 0) {
-        snprintf(vm->error_msg, sizeof(vm->error_msg), "RETURN outside of function");
-        vm->error = 1;
-        return false;
-      }
-
-      // Get return value from stack (if any)
-      st_value_t return_value;
-      st_datatype_t return_type = ST_TYPE_NONE;
-      if (vm->sp > 0) {
-        st_vm_pop_typed(vm, &return_value, &return_type);
-      }
-
-      // Pop call frame
-      vm->call_depth--;
-      st_call_frame_t *frame = &vm->call_stack[vm->call_depth];
-
-      // Phase 5: Save FB instance state (persist local variables)
-      if (frame->fb_instance_id != 0xFF && frame->fb_instance_id < ST_MAX_FB_INSTANCES && vm->func_registry) {
-        st_fb_instance_t *inst = &((st_function_registry_t *)vm->func_registry)->fb_instances[frame->fb_instance_id];
-        // Count local variables used by this function (from function entry metadata)
-        const st_function_entry_t *func = &vm->func_registry->functions[frame->func_index];
-        // Store the local variable count based on the function's instance_size field
-        // (we repurpose instance_size to count locals for FBs)
-        uint8_t local_count = func->instance_size;
-        if (local_count > ST_MAX_FB_LOCALS) local_count = ST_MAX_FB_LOCALS;
-        for (uint8_t i = 0; i < local_count; i++) {
-          if (vm->local_base + i < 64) {
-            inst->local_vars[i] = vm->local_vars[vm->local_base + i];
-            inst->local_types[i] = vm->local_types[vm->local_base + i];
-          }
-        }
-        inst->local_count = local_count;
-        inst->func_index = frame->func_index;
-        inst->initialized = 1;
-      }
-
-      // Restore PC
-      vm->pc = frame->return_pc;
-
-      // Pop parameters from stack
-      vm->sp = frame->param_base;
-
-      // Push return value (if any)
-      if (return_type != ST_TYPE_NONE) {
-        st_vm_push_typed(vm, return_value, return_type);
-      }
-
-      break;
-    }
-
-    case ST_OP_LOAD_PARAM: {
-      // Load parameter from call frame
-      if (vm->call_depth == 0) {
-        snprintf(vm->error_msg, sizeof(vm->error_msg), "LOAD_PARAM outside of function");
-        vm->error = 1;
-        return false;
-      }
-
-      uint8_t param_index = (uint8_t)instr->arg.var_index;
-      st_call_frame_t *frame = &vm->call_stack[vm->call_depth - 1];
-
-      if (param_index >= frame->param_count) {
-        snprintf(vm->error_msg, sizeof(vm->error_msg), "Parameter index out of bounds: %d", param_index);
-        vm->error = 1;
-        return false;
-      }
-
-      // Parameters are stored on stack at param_base
-      uint8_t stack_index = frame->param_base + param_index;
-      st_vm_push_typed(vm, vm->stack[stack_index], vm->type_stack[stack_index]);
-      break;
-    }
-
-    case ST_OP_STORE_LOCAL: {
-      // Store to local variable
-      if (vm->call_depth == 0) {
-        snprintf(vm->error_msg, sizeof(vm->error_msg), "STORE_LOCAL outside of function");
-        vm->error = 1;
-        return false;
-      }
-
-      uint8_t local_index = (uint8_t)instr->arg.var_index;
-      if (vm->local_base + local_index >= 64) {
-        snprintf(vm->error_msg, sizeof(vm->error_msg), "Local variable overflow");
-        vm->error = 1;
-        return false;
-      }
-
-      st_value_t value;
-      st_datatype_t type;
-      if (!st_vm_pop_typed(vm, &value, &type)) {
-        return false;
-      }
-
-      vm->local_vars[vm->local_base + local_index] = value;
-      vm->local_types[vm->local_base + local_index] = type;
-      break;
-    }
-
-    case ST_OP_LOAD_LOCAL: {
-      // Load local variable
-      if (vm->call_depth == 0) {
-        snprintf(vm->error_msg, sizeof(vm->error_msg), "LOAD_LOCAL outside of function");
-        vm->error = 1;
-        return false;
-      }
-
-      uint8_t local_index = (uint8_t)instr->arg.var_index;
-      if (vm->local_base + local_index >= 64) {
-        snprintf(vm->error_msg, sizeof(vm->error_msg), "Local variable overflow");
-        vm->error = 1;
-        return false;
-      }
-
-      st_value_t value = vm->local_vars[vm->local_base + local_index];
-      st_datatype_t type = vm->local_types[vm->local_base + local_index];
-      st_vm_push_typed(vm, value, type);
-      break;
-    }
-
     default:
       snprintf(vm->error_msg, sizeof(vm->error_msg), "Unknown opcode: %d", instr->opcode);
       vm->error = 1;
@@ -2327,6 +2735,237 @@ bool st_vm_run(st_vm_t *vm, uint32_t max_steps) {
   return !vm->error;
 }
 
+/* ============================================================================
+ * THREADED FAST PATH (v7.9.8.3)
+ *
+ * Direct-threaded interpreter: every handler ends with its own indirect jump
+ * to the next handler (GCC labels-as-values), so there is no central switch,
+ * no per-instruction call of st_vm_step() and no opcode re-check for PC
+ * advance. The st_vm_exec_* handlers are shared with st_vm_step(), so both
+ * paths stay bit-identical - only the dispatch differs.
+ *
+ * PC lives in a local; it is written back to vm->pc only around handlers
+ * that read or modify it (jumps, CALL_USER, RETURN) and on exit.
+ * ============================================================================ */
+
+#define ST_VM_FETCH() \
+  do { \
+    if (steps >= budget) goto op_budget; \
+    if (pc >= count) goto op_end; \
+    instr = &code[pc]; \
+    if ((uint32_t)instr->opcode >= (uint32_t)ST_OP_COUNT) goto op_unknown; \
+    goto *dispatch[instr->opcode]; \
+  } while (0)
+
+// Instruction completed: count it, advance PC, jump to next handler
+#define ST_VM_NEXT() \
+  do { \
+    steps++; \
+    pc++; \
+    ST_VM_FETCH(); \
+  } while (0)
+
+// Handler that only touches the stack/variables
+#define ST_VM_OP(label, fn) \
+  label: \
+    if (!fn(vm, instr)) goto op_fail; \
+    ST_VM_NEXT();
+
+// Handler that sets vm->pc itself (jumps, calls)
+#define ST_VM_OP_PC(label, fn) \
+  label: \
+    vm->pc = pc; \
+    if (!fn(vm, instr)) goto op_fail; \
+    pc = vm->pc; \
+    steps++; \
+    ST_VM_FETCH();
+
+bool st_vm_run_fast(st_vm_t *vm, uint32_t max_steps) {
+  if (!vm->program || !vm->program->instructions) {
+    snprintf(vm->error_msg, sizeof(vm->error_msg), "No program loaded");
+    vm->error = 1;
+    return false;
+  }
+  if (vm->halted || vm->error) {
+    return !vm->error;
+  }
+
+  // Must match st_opcode_t order (st_types.h)
+  static const void *const dispatch[] = {
+    &&op_push_bool, &&op_push_int, &&op_push_dword, &&op_push_real,
+    &&op_unknown,   // PUSH_VAR (not emitted by compiler)
+    &&op_dup, &&op_pop,
+    &&op_add, &&op_add_checked, &&op_sub, &&op_mul, &&op_div, &&op_mod, &&op_neg,
+    &&op_and, &&op_or, &&op_not, &&op_xor,
+    &&op_shl, &&op_shr,
+    &&op_eq, &&op_ne, &&op_lt, &&op_gt, &&op_le, &&op_ge,
+    &&op_jmp, &&op_jmp_if_false, &&op_jmp_if_true,
+    &&op_store_var, &&op_load_var,
+    &&op_unknown, &&op_unknown, &&op_unknown,  // LOOP_INIT/TEST/NEXT (not emitted by compiler)
+    &&op_call_builtin,
+    &&op_call_user, &&op_return, &&op_load_param, &&op_store_local, &&op_load_local,
+    &&op_load_array, &&op_store_array,
+    &&op_load_fb_field,
+    &&op_nop, &&op_halt,
+    // FEAT-149: Statically typed opcodes
+    &&op_add_int, &&op_add_dint, &&op_add_real,
+    &&op_sub_int, &&op_sub_dint, &&op_sub_real,
+    &&op_mul_int, &&op_mul_dint, &&op_mul_real,
+    &&op_div_real,
+    &&op_eq_int, &&op_eq_dint, &&op_eq_real,
+    &&op_ne_int, &&op_ne_dint, &&op_ne_real,
+    &&op_lt_int, &&op_lt_dint, &&op_lt_real,
+    &&op_gt_int, &&op_gt_dint, &&op_gt_real,
+    &&op_le_int, &&op_le_dint, &&op_le_real,
+    &&op_ge_int, &&op_ge_dint, &&op_ge_real,
+    &&op_cvt_int_dint, &&op_cvt_int_real, &&op_cvt_dint_real,
+    &&op_inc_var,   // FEAT-151: Optimizer-fused increment
+    // FEAT-152: IEC function superinstructions
+    &&op_call_ton, &&op_call_tof, &&op_call_tp,
+    &&op_call_ctu, &&op_call_ctd,
+    &&op_call_r_trig, &&op_call_f_trig,
+    &&op_limit_int, &&op_limit_dint, &&op_limit_real,
+    &&op_scale_real,
+  };
+  static_assert(sizeof(dispatch) / sizeof(dispatch[0]) == (size_t)ST_OP_COUNT,
+                "st_vm_run_fast dispatch table out of sync with st_opcode_t");
+
+  st_bytecode_instr_t *code = const_cast<st_bytecode_instr_t *>(vm->program->instructions);
+  const uint16_t count = vm->program->instr_count;
+  const uint32_t budget = (max_steps > 0) ? max_steps : UINT32_MAX;
+  uint32_t pc = vm->pc;
+  uint32_t steps = 0;
+  st_bytecode_instr_t *instr;
+
+  ST_VM_FETCH();
+
+  ST_VM_OP(op_push_bool, st_vm_exec_push_bool)
+  ST_VM_OP(op_push_int, st_vm_exec_push_int)
+  ST_VM_OP(op_push_dword, st_vm_exec_push_dword)
+  ST_VM_OP(op_push_real, st_vm_exec_push_real)
+  ST_VM_OP(op_load_var, st_vm_exec_load_var)
+  ST_VM_OP(op_store_var, st_vm_exec_store_var)
+  ST_VM_OP(op_dup, st_vm_exec_dup)
+  ST_VM_OP(op_pop, st_vm_exec_pop)
+  ST_VM_OP(op_add, st_vm_exec_add)
+  ST_VM_OP(op_add_checked, st_vm_exec_add_checked)
+  ST_VM_OP(op_sub, st_vm_exec_sub)
+  ST_VM_OP(op_mul, st_vm_exec_mul)
+  ST_VM_OP(op_div, st_vm_exec_div)
+  ST_VM_OP(op_mod, st_vm_exec_mod)
+  ST_VM_OP(op_neg, st_vm_exec_neg)
+  ST_VM_OP(op_and, st_vm_exec_and)
+  ST_VM_OP(op_or, st_vm_exec_or)
+  ST_VM_OP(op_xor, st_vm_exec_xor)
+  ST_VM_OP(op_not, st_vm_exec_not)
+  ST_VM_OP(op_eq, st_vm_exec_eq)
+  ST_VM_OP(op_ne, st_vm_exec_ne)
+  ST_VM_OP(op_lt, st_vm_exec_lt)
+  ST_VM_OP(op_gt, st_vm_exec_gt)
+  ST_VM_OP(op_le, st_vm_exec_le)
+  ST_VM_OP(op_ge, st_vm_exec_ge)
+  ST_VM_OP(op_shl, st_vm_exec_shl)
+  ST_VM_OP(op_shr, st_vm_exec_shr)
+  ST_VM_OP(op_call_builtin, st_vm_exec_call_builtin)
+  ST_VM_OP(op_load_array, st_vm_exec_load_array)
+  ST_VM_OP(op_store_array, st_vm_exec_store_array)
+  ST_VM_OP(op_load_fb_field, st_vm_exec_load_fb_field)
+  ST_VM_OP(op_load_param, st_vm_exec_load_param)
+  ST_VM_OP(op_store_local, st_vm_exec_store_local)
+  ST_VM_OP(op_load_local, st_vm_exec_load_local)
+
+  ST_VM_OP(op_add_int, st_vm_exec_add_int)
+  ST_VM_OP(op_add_dint, st_vm_exec_add_dint)
+  ST_VM_OP(op_add_real, st_vm_exec_add_real)
+  ST_VM_OP(op_sub_int, st_vm_exec_sub_int)
+  ST_VM_OP(op_sub_dint, st_vm_exec_sub_dint)
+  ST_VM_OP(op_sub_real, st_vm_exec_sub_real)
+  ST_VM_OP(op_mul_int, st_vm_exec_mul_int)
+  ST_VM_OP(op_mul_dint, st_vm_exec_mul_dint)
+  ST_VM_OP(op_mul_real, st_vm_exec_mul_real)
+  ST_VM_OP(op_div_real, st_vm_exec_div_real)
+  ST_VM_OP(op_eq_int, st_vm_exec_eq_int)
+  ST_VM_OP(op_eq_dint, st_vm_exec_eq_dint)
+  ST_VM_OP(op_eq_real, st_vm_exec_eq_real)
+  ST_VM_OP(op_ne_int, st_vm_exec_ne_int)
+  ST_VM_OP(op_ne_dint, st_vm_exec_ne_dint)
+  ST_VM_OP(op_ne_real, st_vm_exec_ne_real)
+  ST_VM_OP(op_lt_int, st_vm_exec_lt_int)
+  ST_VM_OP(op_lt_dint, st_vm_exec_lt_dint)
+  ST_VM_OP(op_lt_real, st_vm_exec_lt_real)
+  ST_VM_OP(op_gt_int, st_vm_exec_gt_int)
+  ST_VM_OP(op_gt_dint, st_vm_exec_gt_dint)
+  ST_VM_OP(op_gt_real, st_vm_exec_gt_real)
+  ST_VM_OP(op_le_int, st_vm_exec_le_int)
+  ST_VM_OP(op_le_dint, st_vm_exec_le_dint)
+  ST_VM_OP(op_le_real, st_vm_exec_le_real)
+  ST_VM_OP(op_ge_int, st_vm_exec_ge_int)
+  ST_VM_OP(op_ge_dint, st_vm_exec_ge_dint)
+  ST_VM_OP(op_ge_real, st_vm_exec_ge_real)
+  ST_VM_OP(op_cvt_int_dint, st_vm_exec_cvt_int_dint)
+  ST_VM_OP(op_cvt_int_real, st_vm_exec_cvt_int_real)
+  ST_VM_OP(op_cvt_dint_real, st_vm_exec_cvt_dint_real)
+  ST_VM_OP(op_inc_var, st_vm_exec_inc_var)
+  ST_VM_OP(op_call_ton, st_vm_exec_call_ton)
+  ST_VM_OP(op_call_tof, st_vm_exec_call_tof)
+  ST_VM_OP(op_call_tp, st_vm_exec_call_tp)
+  ST_VM_OP(op_call_ctu, st_vm_exec_call_ctu)
+  ST_VM_OP(op_call_ctd, st_vm_exec_call_ctd)
+  ST_VM_OP(op_call_r_trig, st_vm_exec_call_r_trig)
+  ST_VM_OP(op_call_f_trig, st_vm_exec_call_f_trig)
+  ST_VM_OP(op_limit_int, st_vm_exec_limit_int)
+  ST_VM_OP(op_limit_dint, st_vm_exec_limit_dint)
+  ST_VM_OP(op_limit_real, st_vm_exec_limit_real)
+  ST_VM_OP(op_scale_real, st_vm_exec_scale_real)
+
+  ST_VM_OP_PC(op_jmp, st_vm_exec_jmp)
+  ST_VM_OP_PC(op_jmp_if_false, st_vm_exec_jmp_if_false)
+  ST_VM_OP_PC(op_jmp_if_true, st_vm_exec_jmp_if_true)
+  ST_VM_OP_PC(op_call_user, st_vm_exec_call_user)
+
+  // RETURN restores PC to the CALL_USER instruction; continue after it
+op_return:
+  vm->pc = pc;
+  if (!st_vm_exec_return(vm, instr)) goto op_fail;
+  pc = vm->pc;
+  ST_VM_NEXT();
+
+op_nop:
+  ST_VM_NEXT();
+
+op_halt:
+  vm->halted = 1;
+  goto op_exit;
+
+op_end:
+  // Ran off the end of the bytecode (same as st_vm_step)
+  vm->halted = 1;
+  goto op_exit;
+
+op_budget:
+  snprintf(vm->error_msg, sizeof(vm->error_msg), "Max steps exceeded (%u)", (unsigned int)max_steps);
+  vm->error = 1;
+  goto op_exit;
+
+op_unknown:
+  snprintf(vm->error_msg, sizeof(vm->error_msg), "Unknown opcode: %d", instr->opcode);
+  vm->error = 1;
+  goto op_exit;
+
+op_fail:
+  vm->error = 1;
+
+op_exit:
+  vm->pc = pc;
+  vm->step_count += steps;
+  return !vm->error;
+}
+
+#undef ST_VM_OP_PC
+#undef ST_VM_OP
+#undef ST_VM_NEXT
+#undef ST_VM_FETCH
+
 /* ============================================================================
  * DEBUGGING
  * ============================================================================ */
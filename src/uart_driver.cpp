@@ -36,6 +36,20 @@ static uint8_t modbus_slave_uart_num = 1;  // Track which UART is in use
 static uint8_t active_tx_pin = PIN_UART1_TX;
 static uint8_t active_rx_pin = PIN_UART1_RX;
 
+// RX frame-end event (v7.9.8.2): hardware RX timeout instead of millis() polling
+static uart_rx_frame_cb_t rx_frame_cb = NULL;
+static uint8_t rx_frame_idle_symbols = 4;
+
+static void uart1_apply_rx_frame_callback(void) {
+  if (!modbus_slave_uart_active) return;
+  if (rx_frame_cb) {
+    ModbusSlaveSerial->setRxTimeout(rx_frame_idle_symbols);
+    ModbusSlaveSerial->onReceive(rx_frame_cb, true);  // Only on RX timeout (frame end)
+  } else {
+    ModbusSlaveSerial->onReceive(NULL);
+  }
+}
+
 /* ============================================================================
  * PIN RESOLUTION HELPERS
  * Resolve configured pin or fall back to board default from constants.h
@@ -135,6 +149,7 @@ void uart1_init(uint32_t baudrate) {
   // Remap to configured pins (resolved from config or constants.h defaults)
   ModbusSlaveSerial->begin(baudrate, SERIAL_8N1, active_rx_pin, active_tx_pin);
   modbus_slave_uart_active = true;
+  uart1_apply_rx_frame_callback();
 }
 
 // BUG-315 FIX: Initialize UART1 with explicit serial config so Modbus Master
@@ -142,6 +157,7 @@ void uart1_init(uint32_t baudrate) {
 void uart1_init_ex(uint32_t baudrate, uint32_t config) {
   ModbusSlaveSerial->begin(baudrate, config, active_rx_pin, active_tx_pin);
   modbus_slave_uart_active = true;
+  uart1_apply_rx_frame_callback();
 }
 
 void uart1_stop(void) {
@@ -219,3 +235,19 @@ void uart1_flush_tx(void) {
   // Wait for TX to complete
   ModbusSlaveSerial->flush();
 }
+
+uint16_t uart1_read_buffer(uint8_t* dst, uint16_t max_len) {
+  if (!modbus_slave_uart_active || dst == NULL || max_len == 0) return 0;
+  int avail = ModbusSlaveSerial->available();
+  if (avail <= 0) return 0;
+  if (avail > max_len) avail = max_len;
+  return (uint16_t)ModbusSlaveSerial->read(dst, (size_t)avail);
+}
+
+void uart1_set_rx_frame_callback(uart_rx_frame_cb_t cb, uint8_t idle_symbols) {
+  if (idle_symbols < 1) idle_symbols = 1;
+  if (idle_symbols > 100) idle_symbols = 100;
+  rx_frame_cb = cb;
+  rx_frame_idle_symbols = idle_symbols;
+  uart1_apply_rx_frame_callback();
+}
@@ -870,8 +870,9 @@ function updateDashboard(m){
     const pdrop=g(m,'modbus_master_priority_drops');
     const hitRate=g(m,'modbus_master_cache_hit_rate');
     const cUtil=g(m,'modbus_master_cache_utilization');
+    const cCap=g(m,'modbus_master_cache_capacity');
     if(hits!=null){
-      $('mcEntries').textContent=fmtN(entries)+' / '+MB_CACHE_MAX;
+      $('mcEntries').textContent=fmtN(entries)+' / '+(cCap!=null?fmtN(cCap):MB_CACHE_MAX);
       $('mcHitMiss').textContent=fmtN(hits)+' / '+fmtN(misses);
       const total=hits+misses;
       $('mcHitRate').textContent=hitRate!=null?hitRate+'%':(total>0?(hits/total*100).toFixed(1)+'%':'N/A');
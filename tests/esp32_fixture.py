@@ -0,0 +1,246 @@
+# -*- coding: utf-8 -*-
+"""
+Fælles fixtures for ESP32 device tests (tests/test_*.py)
+
+Samler det der tidligere var kopieret ind i hvert script:
+  - TestResult          — [PASS]/[FAIL] linjer og RESULTAT opsummering
+  - parse_args()        — [ip] [--navn værdi ...]; ip også via env ESP32_IP
+  - run()               — header, Ctrl+C, cleanup i finally, exit code
+  - api() / metrics()   — REST API (Basic auth) og Prometheus /api/metrics
+  - master_read/write() — /api/modbus/master/rw
+  - upload_program()    — upload + kompiler ST program i en logic slot
+  - wait_for()          — poll en betingelse med timeout
+  - connect()/transact()/read_hr()/write_hr() — Modbus TCP (MBAP)
+
+Brug:
+  import esp32_fixture as fx
+
+  def body(t):
+      code, data = fx.api("GET", "/api/modbus/master")
+      t.check("GET /api/modbus/master", code == 200)
+
+  opts = fx.parse_args({"slave": 1})
+  fx.run("Modbus master — eksempel", body, info=f"slave: {opts['slave']}")
+
+Kræver: requests
+"""
+
+import io
+import os
+import socket
+import struct
+import sys
+import time
+
+import requests
+from requests.auth import HTTPBasicAuth
+
+if getattr(sys.stdout, "encoding", "").lower() != "utf-8":
+    sys.stdout = io.TextIOWrapper(sys.stdout.buffer, encoding='utf-8', errors='replace')
+
+# === KONFIGURATION ===
+ESP32_IP = os.environ.get("ESP32_IP", "10.1.1.30")
+BASE_URL = f"http://{ESP32_IP}"
+AUTH = HTTPBasicAuth("api_user", "!23Password")
+TIMEOUT = 10
+MB_PORT = 502
+UNIT_ID = 0xFF    # MBAP unit ID (0xFF = "denne server")
+
+
+def set_target(ip):
+    global ESP32_IP, BASE_URL
+    ESP32_IP = ip
+    BASE_URL = f"http://{ip}"
+
+
+def parse_args(options=None, argv=None):
+    """
+    [ip] [--navn værdi ...] → {navn: værdi}.
+
+    options: {navn: default}; værdien konverteres til defaultens type
+    (int/float/str). Et flag med default False/True tager ingen værdi.
+    """
+    opts = dict(options or {})
+    args = list(sys.argv[1:] if argv is None else argv)
+    for name, default in (options or {}).items():
+        flag = "--" + name.replace("_", "-")
+        if flag not in args:
+            continue
+        i = args.index(flag)
+        if isinstance(default, bool):
+            opts[name] = True
+            del args[i]
+        else:
+            opts[name] = type(default)(args[i + 1])
+            del args[i:i + 2]
+    if args:
+        set_target(args[0])
+    return opts
+
+
+# === TEST FRAMEWORK ===
+
+class TestResult:
+    def __init__(self):
+        self.passed = 0
+        self.failed = 0
+        self.results = []
+
+    def ok(self, name, detail=""):
+        self.passed += 1
+        self.results.append((True, name, detail))
+        print(f"  [PASS] {name}" + (f" — {detail}" if detail else ""))
+
+    def fail(self, name, detail=""):
+        self.failed += 1
+        self.results.append((False, name, detail))
+        print(f"  [FAIL] {name}" + (f" — {detail}" if detail else ""))
+
+    def check(self, name, condition, detail=""):
+        if condition:
+            self.ok(name, detail)
+        else:
+            self.fail(name, detail)
+        return bool(condition)
+
+    def summary(self):
+        total = self.passed + self.failed
+        print(f"\n{'='*60}")
+        print(f"RESULTAT: {self.passed}/{total} tests bestået")
+        if self.failed > 0:
+            print(f"\nFejlede tests:")
+            for ok, name, detail in self.results:
+                if not ok:
+                    print(f"  X {name}: {detail}")
+        print(f"{'='*60}")
+        return self.failed == 0
+
+
+def run(title, body, cleanup=None, info=""):
+    """Kør body(t) med header, Ctrl+C håndtering og cleanup(); exit 0/1."""
+    print("=" * 60)
+    print(f"  {title}")
+    print(f"  ESP32: {ESP32_IP}" + (f"  {info}" if info else ""))
+    print("=" * 60)
+
+    t = TestResult()
+    try:
+        body(t)
+    except KeyboardInterrupt:
+        print("\n[AFBRUDT] Ctrl+C")
+    except (requests.exceptions.RequestException, OSError) as e:
+        t.fail("Forbindelse til ESP32", str(e))
+    finally:
+        if cleanup:
+            try:
+                cleanup()
+            except (requests.exceptions.RequestException, OSError) as e:
+                print(f"  Cleanup fejlede: {e}")
+
+    success = t.summary()
+    sys.exit(0 if success else 1)
+
+
+# === REST API ===
+
+def api(method, path, data=None, timeout=None):
+    """→ (HTTP status, JSON dict/list eller tekst)."""
+    url = f"{BASE_URL}{path}"
+    timeout = timeout or TIMEOUT
+    if method == "GET":
+        r = requests.get(url, auth=AUTH, timeout=timeout)
+    elif method == "DELETE":
+        r = requests.delete(url, auth=AUTH, timeout=timeout)
+    else:
+        r = requests.post(url, json=data, auth=AUTH, timeout=timeout)
+    ct = r.headers.get("content-type", "")
+    return r.status_code, (r.json() if ct.startswith("application/json") else r.text)
+
+
+def metrics():
+    """Prometheus tekst → {"navn" eller "navn{labels}": værdi}."""
+    _, text = api("GET", "/api/metrics")
+    out = {}
+    for line in str(text).splitlines():
+        if line.startswith("#"):
+            continue
+        name, _, value = line.rpartition(" ")
+        try:
+            out[name] = float(value)
+        except ValueError:
+            pass
+    return out
+
+
+def master_read(slave, addr, reg_type="holding"):
+    return api("POST", "/api/modbus/master/rw",
+               {"op": "read", "type": reg_type, "slave": slave, "addr": addr})
+
+
+def master_write(slave, addr, value, reg_type="holding"):
+    return api("POST", "/api/modbus/master/rw",
+               {"op": "write", "type": reg_type, "slave": slave, "addr": addr, "value": value})
+
+
+def upload_program(slot, source):
+    """Upload + kompiler ST program → (compiled, response data)."""
+    code, data = api("POST", f"/api/logic/{slot}/source", {"source": source})
+    compiled = code == 200 and isinstance(data, dict) and data.get("compiled") == True
+    return compiled, data
+
+
+def wait_for(cond, seconds=3.0, interval=0.05):
+    """Poll cond() indtil den er sand eller timeout → sidste værdi."""
+    deadline = time.time() + seconds
+    while True:
+        value = cond()
+        if value or time.time() >= deadline:
+            return value
+        time.sleep(interval)
+
+
+# === MODBUS TCP ===
+
+def connect(port=None):
+    s = socket.create_connection((ESP32_IP, port or MB_PORT), timeout=TIMEOUT)
+    s.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+    return s
+
+
+def recv_exact(s, n):
+    buf = b""
+    while len(buf) < n:
+        chunk = s.recv(n - len(buf))
+        if not chunk:
+            raise ConnectionError("forbindelse lukket")
+        buf += chunk
+    return buf
+
+
+def mbap(tid, pdu, unit=None):
+    return struct.pack(">HHHB", tid, 0, len(pdu) + 1, UNIT_ID if unit is None else unit) + pdu
+
+
+def recv_adu(s):
+    """→ (tid, unit, pdu)."""
+    tid, _, length, unit = struct.unpack(">HHHB", recv_exact(s, 7))
+    return tid, unit, recv_exact(s, length - 1)
+
+
+def transact(s, tid, pdu, unit=None):
+    """Send én request og returnér svar-PDU (FC + data)."""
+    s.sendall(mbap(tid, pdu, unit))
+    return recv_adu(s)[2]
+
+
+def read_hr(s, tid, start, count):
+    pdu = transact(s, tid, struct.pack(">BHH", 0x03, start, count))
+    if pdu[0] != 0x03:
+        raise RuntimeError(f"FC03 exception {pdu.hex()}")
+    return list(struct.unpack(f">{count}H", pdu[2:2 + count * 2]))
+
+
+def write_hr(s, tid, start, values):
+    pdu = transact(s, tid, struct.pack(">BHHB", 0x10, start, len(values), len(values) * 2) +
+                   struct.pack(f">{len(values)}H", *values))
+    return pdu[0] == 0x10
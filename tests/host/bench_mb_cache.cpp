@@ -0,0 +1,259 @@
+/**
+ * @file bench_mb_cache.cpp
+ * @brief Modbus master cache: hashed lookup / LRU cost at 32, 256 and 1024 entries (FEAT-155)
+ *
+ * Builds mb_async.cpp into this test so the static cache internals
+ * (mb_cache_lookup, mb_cache_resize_bus) are reachable without PSRAM:
+ *
+ *   1. Correctness: every key found again after filling, LRU evicts the
+ *      least recently touched entry, index consistent after evictions
+ *   2. Speed: ns/op for lookup hits, get_or_create hits (LRU move to front)
+ *      and get_or_create misses (evict + reinsert) at 32/256/1024 entries.
+ *      The hash index keeps all three flat; the test requires 1024 entries
+ *      to cost at most 4x of 32 entries (a linear scan would be ~32x)
+ *   3. Resize: the old arrays are freed straight away and back-to-back
+ *      resizes never wait; a concurrent reader hammering get_or_create,
+ *      mb_cache_update and find across resizes always gets a copy of its
+ *      own key
+ *
+ * Usage: bench_mb_cache [operations per measurement, default 2000000]
+ */
+
+#include "../../src/mb_async.cpp"
+
+#include "host_time.h"
+#include "host_test.h"
+#include <pthread.h>
+#include <unistd.h>
+
+static const uint16_t sizes[] = {32, 256, 1024};
+#define SIZE_COUNT (sizeof(sizes) / sizeof(sizes[0]))
+
+// Spread keys over slaves, addresses and both read FCs like a real poll list
+static void key_of(uint32_t i, uint8_t *slave, uint16_t *addr, uint8_t *type) {
+  *slave = (uint8_t)(1 + (i % 7));
+  *addr = (uint16_t)(i * 3);
+  *type = (i & 1) ? (uint8_t)MB_REQ_READ_HOLDING : (uint8_t)MB_REQ_READ_INPUT;
+}
+
+static uint32_t xorshift(uint32_t *s) {
+  *s ^= *s << 13;
+  *s ^= *s >> 17;
+  *s ^= *s << 5;
+  return *s;
+}
+
+// Fresh shard of n entries (bypasses the DRAM limit of mb_async_cache_resize)
+static bool shard_reset(uint16_t n) {
+  return mb_cache_resize_bus(&g_mb_async[0], n);
+}
+
+static bool lru_consistent(const mb_async_state_t *b) {
+  uint16_t n = 0;
+  uint16_t prev = MB_CACHE_NIL;
+  for (uint16_t i = b->lru_head; i != MB_CACHE_NIL; i = b->entries[i].lru_next) {
+    if (b->entries[i].lru_prev != prev || ++n > b->entry_count) return false;
+    prev = i;
+  }
+  return n == b->entry_count && prev == b->lru_tail;
+}
+
+/* ============================================================================
+ * TEST 1: CORRECTNESS
+ * ============================================================================ */
+
+static void test_correctness() {
+  host_test_section("Test 1: Opslag, LRU eviction og index");
+  mb_async_state_t *b = &g_mb_async[0];
+
+  for (size_t s = 0; s < SIZE_COUNT; s++) {
+    uint16_t n = sizes[s];
+    CHECK(shard_reset(n));
+    uint32_t evictions = b->cache_evictions;  // Stats survive a resize
+    uint8_t slave, type;
+    uint16_t addr;
+
+    for (uint32_t i = 0; i < n; i++) {
+      key_of(i, &slave, &addr, &type);
+      CHECK(mb_cache_get_or_create(slave, addr, type, NULL));
+      st_value_t v;
+      v.dint_val = (int32_t)i;
+      mb_cache_update(slave, addr, type, false, MB_OK, v, type);
+    }
+    CHECK_EQ(b->entry_count, n);
+    CHECK_EQ(b->cache_evictions - evictions, 0);
+
+    bool all_found = true;
+    for (uint32_t i = 0; i < n; i++) {
+      key_of(i, &slave, &addr, &type);
+      mb_cache_entry_t e;
+      all_found &= mb_cache_find(slave, addr, type, &e) && e.value.dint_val == (int32_t)i &&
+                   mb_cache_key_eq(&e, slave, addr, type);
+    }
+    CHECK(all_found);
+
+    // Touch key 0, then insert one new key: key 1 is now the LRU tail and goes
+    key_of(0, &slave, &addr, &type);
+    mb_cache_get_or_create(slave, addr, type, NULL);
+    key_of(n, &slave, &addr, &type);
+    CHECK(mb_cache_get_or_create(slave, addr, type, NULL));
+    CHECK_EQ(b->cache_evictions - evictions, 1);
+    key_of(0, &slave, &addr, &type);
+    CHECK(mb_cache_find(slave, addr, type, NULL));
+    key_of(1, &slave, &addr, &type);
+    CHECK(!mb_cache_find(slave, addr, type, NULL));
+
+    // Cycle 3n new keys through: index and LRU list must stay in step
+    for (uint32_t i = n + 1; i < 4u * n; i++) {
+      key_of(i, &slave, &addr, &type);
+      mb_cache_get_or_create(slave, addr, type, NULL);
+    }
+    bool tail_found = true;
+    for (uint32_t i = 3u * n; i < 4u * n; i++) {
+      key_of(i, &slave, &addr, &type);
+      tail_found &= mb_cache_find(slave, addr, type, NULL);
+    }
+    CHECK(tail_found);
+    CHECK(lru_consistent(b));
+
+    char name[64];
+    snprintf(name, sizeof(name), "%u entries: opslag, LRU og index konsistente", n);
+    PASS_IF(name, all_found && tail_found && lru_consistent(b));
+  }
+}
+
+/* ============================================================================
+ * TEST 2: SPEED
+ * ============================================================================ */
+
+static double ns_per_op(uint64_t ns, uint32_t ops) {
+  return (double)ns / ops;
+}
+
+static void test_speed(uint32_t ops) {
+  host_test_section("Test 2: ns/op ved 32/256/1024 entries");
+  printf("  %8s %12s %14s %14s\n", "entries", "find hit", "get hit+LRU", "get miss+evict");
+
+  double hit[SIZE_COUNT], miss[SIZE_COUNT];
+  for (size_t s = 0; s < SIZE_COUNT; s++) {
+    uint16_t n = sizes[s];
+    shard_reset(n);
+    uint8_t slave, type;
+    uint16_t addr;
+    for (uint32_t i = 0; i < n; i++) {
+      key_of(i, &slave, &addr, &type);
+      mb_cache_get_or_create(slave, addr, type, NULL);
+    }
+
+    uint32_t rng = 0x12345678u;
+    uint64_t found = 0;
+    uint64_t t0 = host_test_now_ns();
+    for (uint32_t i = 0; i < ops; i++) {
+      key_of(xorshift(&rng) % n, &slave, &addr, &type);
+      found += mb_cache_find(slave, addr, type, NULL);
+    }
+    double find_ns = ns_per_op(host_test_now_ns() - t0, ops);
+    CHECK_EQ(found, ops);
+
+    t0 = host_test_now_ns();
+    for (uint32_t i = 0; i < ops; i++) {
+      key_of(xorshift(&rng) % n, &slave, &addr, &type);
+      host_test_sink(mb_cache_get_or_create(slave, addr, type, NULL));
+    }
+    hit[s] = ns_per_op(host_test_now_ns() - t0, ops);
+
+    // Working set of 2n keys in order: every call misses and evicts the tail
+    uint32_t evictions = g_mb_async[0].cache_evictions;
+    t0 = host_test_now_ns();
+    for (uint32_t i = 0; i < ops; i++) {
+      key_of(n + (i % (2u * n)), &slave, &addr, &type);
+      host_test_sink(mb_cache_get_or_create(slave, addr, type, NULL));
+    }
+    miss[s] = ns_per_op(host_test_now_ns() - t0, ops);
+    CHECK_EQ(g_mb_async[0].cache_evictions - evictions, ops);
+    CHECK(lru_consistent(&g_mb_async[0]));
+
+    printf("  %8u %12.1f %14.1f %14.1f\n", n, find_ns, hit[s], miss[s]);
+  }
+
+  PASS_IF("get_or_create hit ved 1024 <= 4x af 32 entries", hit[SIZE_COUNT - 1] <= 4.0 * hit[0]);
+  PASS_IF("get_or_create miss ved 1024 <= 4x af 32 entries", miss[SIZE_COUNT - 1] <= 4.0 * miss[0]);
+}
+
+/* ============================================================================
+ * TEST 3: RESIZE FREES STRAIGHT AWAY
+ * ============================================================================ */
+
+static volatile bool reader_stop = false;
+static volatile uint32_t reader_bad = 0;
+static volatile uint32_t reader_ops = 0;
+
+// ST/web/worker side: every access goes by key, each one under the cache lock
+static void *reader_main(void *arg) {
+  uint32_t rng = 0xC0FFEEu;
+  while (!reader_stop) {
+    uint8_t slave, type;
+    uint16_t addr;
+    key_of(xorshift(&rng) % 64, &slave, &addr, &type);
+    mb_cache_entry_t e;
+    if (mb_cache_get_or_create(slave, addr, type, &e)) {
+      if (!mb_cache_key_eq(&e, slave, addr, type)) reader_bad++;
+      st_value_t v;
+      v.dint_val = e.value.dint_val + 1;
+      mb_cache_update(slave, addr, type, false, MB_OK, v, type);
+      // Freed or reused arrays would show up as a foreign key in the copy
+      if (mb_cache_find(slave, addr, type, &e) && !mb_cache_key_eq(&e, slave, addr, type)) reader_bad++;
+    }
+    reader_ops++;
+  }
+  return NULL;
+}
+
+static void test_resize() {
+  host_test_section("Test 3: Resize frigiver straks");
+  mb_async_state_t *b = &g_mb_async[0];
+
+  // Back-to-back resizes: nothing to wait for, nothing kept around
+  shard_reset(32);
+  CHECK(mb_cache_get_or_create(1, 100, MB_REQ_READ_HOLDING, NULL));
+  uint64_t t0 = host_test_now_ns();
+  CHECK(mb_cache_resize_bus(b, 256));
+  CHECK(mb_cache_resize_bus(b, 32));
+  CHECK(mb_cache_resize_bus(b, 256));
+  double waited_ms = (host_test_now_ns() - t0) / 1e6;
+  CHECK(!mb_cache_find(1, 100, MB_REQ_READ_HOLDING, NULL));
+  printf("  3 resizes i træk: %.1f ms\n", waited_ms);
+  PASS_IF("Resize i træk venter ikke", waited_ms < 50);
+
+  // Reader thread across many back-to-back resizes
+  pthread_t th;
+  pthread_create(&th, NULL, reader_main, NULL);
+  for (int i = 0; i < 200; i++) {
+    shard_reset(sizes[i % SIZE_COUNT]);
+    usleep(200);
+  }
+  reader_stop = true;
+  pthread_join(th, NULL);
+  printf("  Reader: %u opslag over 200 resizes\n", (unsigned)reader_ops);
+  PASS_IF("Reader ser altid sin egen nøgle på tværs af resizes", reader_bad == 0 && reader_ops > 0);
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================ */
+
+int main(int argc, char **argv) {
+  uint32_t ops = (argc > 1) ? (uint32_t)atol(argv[1]) : 2000000;
+
+  printf("============================================================\n");
+  printf("  Modbus master cache: hash index + LRU (host)\n");
+  printf("============================================================\n");
+
+  host_time_set_manual(true);
+
+  test_correctness();
+  test_speed(ops);
+  test_resize();
+
+  return host_test_summary();
+}
@@ -0,0 +1,270 @@
+/**
+ * @file bench_mb_farm.cpp
+ * @brief Modbus master throughput against a pty slave farm on host (FEAT-163)
+ *
+ * Native build of modbus_master.cpp + mb_async.cpp with bus 0 on the pty
+ * transport (mb_pty_bus.h). The farm answers FC04 for 8 slaves at the bus
+ * baudrate after latency + jitter; poll groups put these loads on the
+ * master:
+ *
+ *   let     4 groups x  8 registers @ 500 ms
+ *   middel  8 groups x 16 registers @ 100 ms
+ *   tung   16 groups x 16 registers @  20 ms   (above bus capacity at 115200)
+ *   fejl    = middel with 5% timeouts, CRC errors and exceptions injected
+ *
+ * Per load it reports target and achieved transactions/s, missed periods,
+ * bus utilisation and cache freshness of every polled register:
+ *   age    millis() - last cache update
+ *   stale  time since the farm held the cached value (a stamp thread writes
+ *          the current time in ms into all polled registers every ms)
+ *
+ * Checks: the light load runs at its target rate with no missed periods and
+ * ages within one period; overload is shed as missed periods, never as wrong
+ * data; injected faults show up as poll errors and polling continues.
+ *
+ * Usage: bench_mb_farm [window seconds, default 2] [baudrate, default 115200]
+ *                      [latency us, default 2000] [jitter us, default 1000]
+ */
+
+#include "mb_async.h"
+#include "mb_profile.h"
+#include "modbus_master.h"
+#include "config_struct.h"
+#include "mb_pty_bus.h"
+#include "host_test.h"
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#define FARM_SLAVES   8
+#define TIMEOUT_MS    100
+
+typedef struct {
+  const char *name;
+  uint8_t groups;
+  uint16_t count;
+  uint32_t period_ms;
+  uint8_t fault_pct;                  // Each of timeout/CRC/exception
+} load_t;
+
+static const load_t loads[] = {
+  {"let", 4, 8, 500, 0},
+  {"middel", 8, 16, 100, 0},
+  {"tung", 16, 16, 20, 0},
+  {"fejl", 8, 16, 100, 5},
+};
+#define LOAD_COUNT (sizeof(loads) / sizeof(loads[0]))
+
+typedef struct {
+  double target_tps;
+  double tps;
+  uint32_t missed;
+  uint32_t errors;
+  float util;
+  uint32_t samples;
+  uint32_t wrong;                     // Cached value that is no recent stamp (wrong register, garbage)
+  double age_avg, stale_avg;
+  uint32_t age_max, stale_max;
+} result_t;
+
+static mb_pty_bus_t *pty;
+
+static void setup(uint32_t baud, uint32_t latency_us, uint32_t jitter_us) {
+  g_persist_config.modbus_master.enabled = 1;
+  g_persist_config.modbus_master.baudrate = baud;
+  g_persist_config.modbus_master.parity = 0;
+  g_persist_config.modbus_master.stop_bits = 1;
+  g_persist_config.modbus_master.timeout_ms = TIMEOUT_MS;
+  g_persist_config.modbus_master.cache_max_entries = 256;
+  g_persist_config.modbus_master.queue_max_size = MB_ASYNC_QUEUE_SIZE;
+  g_persist_config.modbus_master.coalesce_enabled = 0;
+  g_persist_config.modbus_master.write_combine = 1;
+
+  mb_pty_farm_config_t f = {1, FARM_SLAVES, 0, 0, baud, latency_us, jitter_us, 0, 0, 0};
+  pty = mb_pty_bus_open(&f);
+  modbus_master_init();
+  modbus_master_set_transport(0, mb_pty_transport(), pty);
+  mb_async_init();
+}
+
+// Group i: the slaves in turn, own addresses per group (as the device bench)
+static ModbusPollGroup group_def(uint8_t i, const load_t *l) {
+  ModbusPollGroup g;
+  memset(&g, 0, sizeof(g));
+  g.enabled = 1;
+  g.slave_id = (uint8_t)(1 + i % FARM_SLAVES);
+  g.fc = 4;
+  g.start = (uint16_t)((i / FARM_SLAVES) * l->count);
+  g.count = l->count;
+  g.period_ms = l->period_ms;
+  return g;
+}
+
+static void load_groups(const load_t *l) {
+  memset(g_persist_config.mb_poll_groups, 0, sizeof(g_persist_config.mb_poll_groups));
+  for (uint8_t i = 0; l && i < l->groups; i++) g_persist_config.mb_poll_groups[i] = group_def(i, l);
+  mb_async_poll_load(g_persist_config.mb_poll_groups);
+}
+
+static void poll_totals(uint8_t groups, uint32_t *polls, uint32_t *missed, uint32_t *errors) {
+  *polls = *missed = *errors = 0;
+  for (uint8_t i = 0; i < groups; i++) {
+    const mb_poll_state_t *g = mb_async_poll_state(i);
+    *polls += g->polls;
+    *missed += g->missed;
+    *errors += g->errors;
+  }
+}
+
+/* ============================================================================
+ * STAMP THREAD (farm side)
+ * ============================================================================ */
+
+static volatile const load_t *stamp_load = NULL;
+static volatile bool stamp_stop = false;
+
+static void *stamp_main(void *arg) {
+  while (!stamp_stop) {
+    const load_t *l = (const load_t *)stamp_load;
+    uint16_t now = (uint16_t)millis();
+    for (uint8_t i = 0; l && i < l->groups; i++) {
+      ModbusPollGroup g = group_def(i, l);
+      for (uint16_t a = 0; a < g.count; a++) mb_pty_farm_set(pty, g.slave_id, (uint16_t)(g.start + a), now);
+    }
+    usleep(1000);
+  }
+  return NULL;
+}
+
+/* ============================================================================
+ * ONE LOAD
+ * ============================================================================ */
+
+static void cache_freshness(const load_t *l, result_t *r) {
+  uint64_t age_sum = 0, stale_sum = 0;
+  for (uint8_t i = 0; i < l->groups; i++) {
+    ModbusPollGroup g = group_def(i, l);
+    for (uint16_t a = 0; a < g.count; a++) {
+      uint32_t now = millis();
+      mb_cache_entry_t e;
+      if (!mb_cache_find(g.slave_id, (uint16_t)(g.start + a), MB_REQ_READ_INPUT_REG, &e) ||
+          e.status != MB_CACHE_VALID) continue;
+      uint32_t age = now - e.last_update_ms;
+      uint32_t stale = (uint16_t)((uint16_t)now - (uint16_t)e.value.int_val);
+      if (stale > 10000) {
+        r->wrong++;  // Not a stamp from the last 10 s: wrong register or torn value
+        continue;
+      }
+      r->samples++;
+      age_sum += age;
+      stale_sum += stale;
+      if (age > r->age_max) r->age_max = age;
+      if (stale > r->stale_max) r->stale_max = stale;
+    }
+  }
+  if (r->samples) {
+    r->age_avg = (double)age_sum / r->samples;
+    r->stale_avg = (double)stale_sum / r->samples;
+  }
+}
+
+static result_t run_load(const load_t *l, uint32_t window_s) {
+  result_t r;
+  memset(&r, 0, sizeof(r));
+  mb_pty_farm_config_t *fc = mb_pty_farm_config(pty);
+  fc->timeout_pct = fc->crc_error_pct = fc->exception_pct = l->fault_pct;
+
+  mb_async_reset_cache();
+  stamp_load = l;
+  load_groups(l);
+  usleep(500000);  // Settle: first round of every group done
+
+  uint32_t p0, m0, e0, p1, m1, e1;
+  poll_totals(l->groups, &p0, &m0, &e0);
+  uint64_t t0 = host_test_now_ns();
+  usleep(window_s * 1000000);
+  poll_totals(l->groups, &p1, &m1, &e1);
+  double secs = (host_test_now_ns() - t0) / 1e9;
+  cache_freshness(l, &r);
+
+  r.target_tps = l->groups * 1000.0 / l->period_ms;
+  r.tps = (p1 - p0) / secs;
+  r.missed = m1 - m0;
+  r.errors = e1 - e0;
+  r.util = mb_profile_bus_utilisation(0);
+
+  load_groups(NULL);
+  fc->timeout_pct = fc->crc_error_pct = fc->exception_pct = 0;
+  for (int i = 0; i < 200 && mb_async_is_busy(); i++) usleep(1000);
+  return r;
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================ */
+
+int main(int argc, char **argv) {
+  uint32_t window_s = (argc > 1) ? (uint32_t)atol(argv[1]) : 2;
+  uint32_t baud = (argc > 2) ? (uint32_t)atol(argv[2]) : 115200;
+  uint32_t latency_us = (argc > 3) ? (uint32_t)atol(argv[3]) : 2000;
+  uint32_t jitter_us = (argc > 4) ? (uint32_t)atol(argv[4]) : 1000;
+  if (window_s < 1) window_s = 1;
+
+  printf("============================================================\n");
+  printf("  Modbus master benchmark: pty slave farm (host)\n");
+  printf("  %u baud, slave latency %u+0..%u us, vindue %u s\n", baud, latency_us, jitter_us, window_s);
+  printf("============================================================\n");
+
+  setup(baud, latency_us, jitter_us);
+  if (!pty) {
+    printf("  [FAIL] openpty\n");
+    return 1;
+  }
+  pthread_t stamp;
+  pthread_create(&stamp, NULL, stamp_main, NULL);
+
+  result_t res[LOAD_COUNT];
+  for (uint8_t i = 0; i < LOAD_COUNT; i++) {
+    const load_t *l = &loads[i];
+    host_test_section(l->name);
+    printf("  %u groups x %u registre @ %u ms%s\n", l->groups, l->count, l->period_ms,
+           l->fault_pct ? ", 5% timeout/CRC/exception" : "");
+    res[i] = run_load(l, window_s);
+    const result_t *r = &res[i];
+    CHECK(r->tps > 0);
+    CHECK(r->samples > 0);
+    CHECK_EQ(r->wrong, 0);
+    PASS_IF("Polls kører og cachen har kun farmens værdier", r->tps > 0 && r->samples > 0 && r->wrong == 0);
+  }
+  stamp_stop = true;
+  pthread_join(stamp, NULL);
+
+  host_test_section("Resultat");
+  printf("  %-7s %9s %8s %7s %7s %7s %8s %8s %9s %9s\n", "Load", "mål tx/s", "tx/s", "bus %", "missed",
+         "errors", "age avg", "age max", "stale avg", "stale max");
+  for (uint8_t i = 0; i < LOAD_COUNT; i++) {
+    const result_t *r = &res[i];
+    printf("  %-7s %9.1f %8.1f %7.1f %7u %7u %6.0fms %6ums %7.0fms %7ums\n", loads[i].name, r->target_tps,
+           r->tps, r->util, r->missed, r->errors, r->age_avg, r->age_max, r->stale_avg, r->stale_max);
+  }
+
+  const result_t *light = &res[0], *heavy = &res[2], *faults = &res[3];
+  CHECK(light->tps >= light->target_tps * 0.9);
+  CHECK_EQ(light->missed, 0);
+  CHECK(light->age_max <= loads[0].period_ms + 100);
+  PASS_IF("Let belastning: mål-raten nås, ingen missed, age inden for én periode",
+          light->tps >= light->target_tps * 0.9 && light->missed == 0 &&
+          light->age_max <= loads[0].period_ms + 100);
+  CHECK(heavy->tps < heavy->target_tps);
+  CHECK(heavy->missed > 0);
+  PASS_IF("Overlast afvises som missed perioder", heavy->tps < heavy->target_tps && heavy->missed > 0);
+  mb_pty_farm_stats_t st = mb_pty_farm_stats(pty);
+  CHECK(st.injected_timeouts > 0 && st.injected_crc_errors > 0 && st.injected_exceptions > 0);
+  CHECK(faults->errors > 0);
+  CHECK(faults->tps > 0);
+  PASS_IF("Injicerede fejl tælles som poll errors, polling fortsætter", faults->errors > 0 && faults->tps > 0);
+
+  mb_async_deinit();
+  mb_pty_bus_close(pty);
+  return host_test_summary();
+}
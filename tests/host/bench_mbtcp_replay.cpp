@@ -0,0 +1,290 @@
+/**
+ * @file bench_mbtcp_replay.cpp
+ * @brief Replay MBAP traffic against the Modbus TCP server on host (FEAT-145)
+ *
+ * Builds the real modbus_tcp_server.cpp, FC dispatcher, FC handlers, parser,
+ * serializer and register store against the host shims, starts the server on
+ * a loopback port and replays a fixed request mix from one client:
+ *
+ *   1. Correctness: every response echoes its transaction ID, has the
+ *      expected FC, and a write is read back
+ *   2. Batch overflow: more pipelined FC03 x 125 than fit one TX batch →
+ *      every ADU answered once, requests counter == ADUs sent
+ *   3. Throughput: requests/sec at pipeline depth 1 and 8
+ *
+ * Usage: bench_mbtcp_replay [seconds per depth, default 2]
+ * Env:   MBTCP_PORT (default 15020)
+ */
+
+#include "modbus_tcp_server.h"
+#include "registers.h"
+#include "config_struct.h"
+#include "host_test.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+/* ============================================================================
+ * CLIENT
+ * ============================================================================ */
+
+typedef std::vector<uint8_t> bytes_t;
+
+static int client_connect(uint16_t port) {
+  for (int attempt = 0; attempt < 50; attempt++) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in a;
+    memset(&a, 0, sizeof(a));
+    a.sin_family = AF_INET;
+    a.sin_port = htons(port);
+    a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (struct sockaddr *)&a, sizeof(a)) == 0) {
+      int one = 1;
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+      struct timeval tv = {5, 0};
+      setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+      return fd;
+    }
+    close(fd);
+    usleep(20000);  // Server task still binding
+  }
+  return -1;
+}
+
+static bool recv_exact(int fd, uint8_t *buf, size_t n) {
+  size_t got = 0;
+  while (got < n) {
+    ssize_t r = recv(fd, buf + got, n - got, 0);
+    if (r <= 0) return false;
+    got += (size_t)r;
+  }
+  return true;
+}
+
+static void put_u16(bytes_t &b, uint16_t v) {
+  b.push_back((uint8_t)(v >> 8));
+  b.push_back((uint8_t)v);
+}
+
+static bytes_t adu(uint16_t tid, const bytes_t &pdu) {
+  bytes_t b;
+  put_u16(b, tid);
+  put_u16(b, 0);
+  put_u16(b, (uint16_t)(pdu.size() + 1));
+  b.push_back(0xFF);
+  b.insert(b.end(), pdu.begin(), pdu.end());
+  return b;
+}
+
+// Response PDU (FC + data); empty on a broken stream
+static bytes_t recv_adu(int fd, uint16_t *tid) {
+  uint8_t h[7];
+  if (!recv_exact(fd, h, sizeof(h))) return bytes_t();
+  *tid = (uint16_t)((h[0] << 8) | h[1]);
+  uint16_t len = (uint16_t)((h[4] << 8) | h[5]);
+  if (len < 2) return bytes_t();
+  bytes_t pdu(len - 1);
+  if (!recv_exact(fd, pdu.data(), pdu.size())) return bytes_t();
+  return pdu;
+}
+
+static bytes_t pdu_read(uint8_t fc, uint16_t start, uint16_t count) {
+  bytes_t p;
+  p.push_back(fc);
+  put_u16(p, start);
+  put_u16(p, count);
+  return p;
+}
+
+static bytes_t pdu_write_single(uint16_t addr, uint16_t value) {
+  bytes_t p;
+  p.push_back(0x06);
+  put_u16(p, addr);
+  put_u16(p, value);
+  return p;
+}
+
+static bytes_t pdu_write_multiple(uint16_t start, const std::vector<uint16_t> &values) {
+  bytes_t p;
+  p.push_back(0x10);
+  put_u16(p, start);
+  put_u16(p, (uint16_t)values.size());
+  p.push_back((uint8_t)(values.size() * 2));
+  for (uint16_t v : values) put_u16(p, v);
+  return p;
+}
+
+static bytes_t pdu_read_write(uint16_t rd, uint16_t rn, uint16_t wr, const std::vector<uint16_t> &values) {
+  bytes_t p;
+  p.push_back(0x17);
+  put_u16(p, rd);
+  put_u16(p, rn);
+  put_u16(p, wr);
+  put_u16(p, (uint16_t)values.size());
+  p.push_back((uint8_t)(values.size() * 2));
+  for (uint16_t v : values) put_u16(p, v);
+  return p;
+}
+
+/* ============================================================================
+ * TRAFFIC MIX (typical SCADA poll: mostly reads, some writes)
+ * ============================================================================ */
+
+static std::vector<bytes_t> traffic_mix(void) {
+  std::vector<bytes_t> mix;
+  mix.push_back(pdu_read(0x03, 0, 10));
+  mix.push_back(pdu_read(0x04, 0, 20));
+  mix.push_back(pdu_read(0x01, 0, 32));
+  mix.push_back(pdu_read(0x02, 0, 16));
+  mix.push_back(pdu_write_single(30, 0x1234));
+  mix.push_back(pdu_read(0x03, 0, 64));
+  mix.push_back(pdu_write_multiple(40, {1, 2, 3, 4, 5, 6, 7, 8}));
+  mix.push_back(pdu_read_write(40, 8, 50, {9, 8, 7, 6}));
+  return mix;
+}
+
+/* ============================================================================
+ * TESTS
+ * ============================================================================ */
+
+static void test_correctness(int fd) {
+  host_test_section("Test 1: Svar pr. funktionskode");
+  std::vector<bytes_t> mix = traffic_mix();
+
+  bytes_t batch;
+  for (size_t i = 0; i < mix.size(); i++) {
+    bytes_t a = adu((uint16_t)(0x100 + i), mix[i]);
+    batch.insert(batch.end(), a.begin(), a.end());
+  }
+  CHECK(send(fd, batch.data(), batch.size(), 0) == (ssize_t)batch.size());
+
+  bool all_ok = true;
+  for (size_t i = 0; i < mix.size(); i++) {
+    uint16_t tid = 0;
+    bytes_t r = recv_adu(fd, &tid);
+    bool ok = !r.empty() && tid == 0x100 + i && r[0] == mix[i][0];
+    if (!ok) printf("  ADU %zu: tid=0x%04X fc=0x%02X\n", i, tid, r.empty() ? 0 : r[0]);
+    all_ok &= ok;
+  }
+  PASS_IF("Pipelined mix: TID og FC ekko i rækkefølge", all_ok);
+
+  // FC16 then FC23 in the same batch: the FC23 read part sees the FC16 values
+  PASS_IF("FC06 skrivning landet i registrene", registers_get_holding_register(30) == 0x1234);
+  PASS_IF("FC23 skrev HR 50-53", registers_get_holding_register(50) == 9 && registers_get_holding_register(53) == 6);
+}
+
+static void test_batch_overflow(int fd) {
+  host_test_section("Test 2: Flere svar end én TX-batch");
+  const ModbusTcpStats *st = modbus_tcp_server_get_stats();
+  uint32_t before = st->requests;
+
+  // 10 x FC03 125 regs = 10 x 257 byte responses, TX batch = 4 x 260
+  const int n = 10;
+  bytes_t batch;
+  for (int i = 0; i < n; i++) {
+    bytes_t a = adu((uint16_t)(0x200 + i), pdu_read(0x03, 0, 125));
+    batch.insert(batch.end(), a.begin(), a.end());
+  }
+  // The RX buffer holds two maximum ADUs, FC03 requests are 12 bytes: all fit
+  CHECK(send(fd, batch.data(), batch.size(), 0) == (ssize_t)batch.size());
+
+  bool all_ok = true;
+  for (int i = 0; i < n; i++) {
+    uint16_t tid = 0;
+    bytes_t r = recv_adu(fd, &tid);
+    all_ok &= (r.size() == 2 + 250 && tid == 0x200 + i && r[0] == 0x03);
+  }
+  PASS_IF("Alle 10 svar modtaget i rækkefølge", all_ok);
+
+  // Server counts before it sends; the last response is already received here
+  uint32_t counted = st->requests - before;
+  printf("  requests talt: %u (sendt %d)\n", counted, n);
+  PASS_IF("requests tælles én gang pr. ADU", counted == (uint32_t)n);
+}
+
+static double run_throughput(int fd, int depth, double seconds) {
+  std::vector<bytes_t> mix = traffic_mix();
+  uint64_t deadline = host_test_now_ns() + (uint64_t)(seconds * 1e9);
+  uint64_t t0 = host_test_now_ns();
+  uint64_t done = 0;
+  uint16_t tid = 0;
+  bool ok = true;
+
+  while (ok && host_test_now_ns() < deadline) {
+    bytes_t batch;
+    uint16_t first = tid;
+    for (int i = 0; i < depth; i++) {
+      bytes_t a = adu(tid++, mix[(first + i) % mix.size()]);
+      batch.insert(batch.end(), a.begin(), a.end());
+    }
+    if (send(fd, batch.data(), batch.size(), 0) != (ssize_t)batch.size()) break;
+    for (int i = 0; i < depth; i++) {
+      uint16_t rtid = 0;
+      bytes_t r = recv_adu(fd, &rtid);
+      if (r.empty() || rtid != (uint16_t)(first + i) || (r[0] & 0x80)) {
+        ok = false;
+        break;
+      }
+      done++;
+    }
+  }
+  CHECK(ok);
+  double elapsed = (double)(host_test_now_ns() - t0) / 1e9;
+  return done / elapsed;
+}
+
+static void test_throughput(int fd, double seconds) {
+  host_test_section("Test 3: Throughput (loopback, ét klient-socket)");
+  for (int depth : {1, 8}) {
+    double rps = run_throughput(fd, depth, seconds);
+    printf("  Pipeline-dybde %d: %.0f requests/s\n", depth, rps);
+    PASS_IF(depth == 1 ? "Dybde 1 kører" : "Dybde 8 kører", rps > 0);
+  }
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================ */
+
+int main(int argc, char **argv) {
+  double seconds = (argc > 1) ? atof(argv[1]) : 2.0;
+  const char *env_port = getenv("MBTCP_PORT");
+  uint16_t port = env_port ? (uint16_t)atoi(env_port) : 15020;
+  setvbuf(stdout, NULL, _IOLBF, 0);  // Interleave with the server's log lines
+
+  printf("============================================================\n");
+  printf("  Modbus TCP MBAP replay (host, port %u)\n", port);
+  printf("============================================================\n");
+
+  config_struct_create_default();
+  registers_init();
+
+  ModbusTcpConfig cfg;
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.enabled = 1;
+  cfg.port = port;
+  cfg.max_clients = 2;
+  if (modbus_tcp_server_start(&cfg) != 0) {
+    printf("FEJL: kunne ikke starte server på port %u\n", port);
+    return 1;
+  }
+
+  int fd = client_connect(port);
+  if (fd < 0) {
+    printf("FEJL: kunne ikke forbinde\n");
+    return 1;
+  }
+
+  test_correctness(fd);
+  test_batch_overflow(fd);
+  test_throughput(fd, seconds);
+
+  close(fd);
+  modbus_tcp_server_stop();
+  return host_test_summary();
+}
@@ -0,0 +1,300 @@
+/**
+ * @file bench_st_vm.cpp
+ * @brief ST VM threaded fast path vs. st_vm_step loop on host (FEAT-148)
+ *
+ * Compiles the test_st_vm_bench.py programs with the real compiler and
+ * optimizer and runs every program in two copies, one through
+ * st_vm_run_fast (no debugger) and one through the per-instruction
+ * st_vm_step loop (debugger attached):
+ *
+ *   1. Identical results: after every cycle both copies have bit-identical
+ *      variables and executed the same number of instructions
+ *   2. Speed: instructions/s in both modes and the fast/step ratio
+ *      (ESP32 target: 1.4-1.7x; host CPUs predict branches better, so the
+ *      test only requires the fast path to not be slower)
+ *
+ * Timers run on the manual clock (host_time.h), 10 ms per cycle, so TON
+ * outputs switch on the same cycle in both copies.
+ *
+ * Usage: bench_st_vm [cycles per program, default 20000]
+ */
+
+#include "st_host.h"
+#include "registers.h"
+#include "config_struct.h"
+#include "host_time.h"
+#include "host_test.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef struct {
+  const char *name;
+  const char *source;
+} bench_program_t;
+
+// Same programs as tests/test_st_vm_bench.py
+static const bench_program_t programs[] = {
+  {"arith_loop",
+    "PROGRAM bench\n"
+    "VAR\n"
+    "  i : INT;\n"
+    "  s : DINT;\n"
+    "  r : REAL;\n"
+    "END_VAR\n"
+    "BEGIN\n"
+    "  s := 0;\n"
+    "  FOR i := 1 TO 200 DO\n"
+    "    s := s + i * 3 - (i MOD 7);\n"
+    "    r := r + 0.5;\n"
+    "  END_FOR;\n"
+    "END_PROGRAM\n"},
+  {"logic_if",
+    "PROGRAM bench\n"
+    "VAR\n"
+    "  a : BOOL;\n"
+    "  b : BOOL;\n"
+    "  c : INT;\n"
+    "  i : INT;\n"
+    "END_VAR\n"
+    "BEGIN\n"
+    "  FOR i := 0 TO 100 DO\n"
+    "    a := (i MOD 2) = 0;\n"
+    "    b := a XOR (i > 50);\n"
+    "    IF a AND NOT b THEN\n"
+    "      c := c + 1;\n"
+    "    ELSIF b THEN\n"
+    "      c := c - 1;\n"
+    "    ELSE\n"
+    "      c := c + 2;\n"
+    "    END_IF;\n"
+    "  END_FOR;\n"
+    "END_PROGRAM\n"},
+  {"builtins",
+    "PROGRAM bench\n"
+    "VAR\n"
+    "  i : INT;\n"
+    "  x : INT;\n"
+    "  y : REAL;\n"
+    "END_VAR\n"
+    "BEGIN\n"
+    "  FOR i := 0 TO 100 DO\n"
+    "    x := LIMIT(0, i * 2, 150);\n"
+    "    y := ABS(INT_TO_REAL(x) - 75.0);\n"
+    "    x := MAX(x, MIN(i, 40));\n"
+    "  END_FOR;\n"
+    "END_PROGRAM\n"},
+  {"func_call",
+    "PROGRAM bench\n"
+    "VAR\n"
+    "  i : INT;\n"
+    "  s : INT;\n"
+    "END_VAR\n"
+    "\n"
+    "FUNCTION F2 : INT\n"
+    "VAR_INPUT\n"
+    "  a : INT;\n"
+    "  b : INT;\n"
+    "END_VAR\n"
+    "BEGIN\n"
+    "  F2 := a * b + 1;\n"
+    "END_FUNCTION\n"
+    "\n"
+    "BEGIN\n"
+    "  s := 0;\n"
+    "  FOR i := 0 TO 50 DO\n"
+    "    s := F2(i, 2) + s;\n"
+    "  END_FOR;\n"
+    "END_PROGRAM\n"},
+  {"mixed",
+    "PROGRAM bench\n"
+    "VAR\n"
+    "  i : INT;\n"
+    "  d : DINT;\n"
+    "  r : REAL;\n"
+    "  b : BOOL;\n"
+    "  c : INT;\n"
+    "  k : DINT;\n"
+    "END_VAR\n"
+    "BEGIN\n"
+    "  i := 0;\n"
+    "  d := 100000;\n"
+    "  r := 0.0;\n"
+    "  FOR k := 0 TO 20 DO\n"
+    "    i := i + 3;\n"
+    "    d := d + i * 2;\n"
+    "    r := r + d / 7;\n"
+    "    r := r * 1.5 - i;\n"
+    "    b := d < i;\n"
+    "    IF r >= i THEN\n"
+    "      c := c + 1;\n"
+    "    END_IF;\n"
+    "  END_FOR;\n"
+    "END_PROGRAM\n"},
+  {"timers",
+    "PROGRAM bench\n"
+    "VAR\n"
+    "  run : BOOL := TRUE;\n"
+    "  n : INT;\n"
+    "  q1 : BOOL; q2 : BOOL; q3 : BOOL; q4 : BOOL;\n"
+    "  q5 : BOOL; q6 : BOOL; q7 : BOOL; q8 : BOOL;\n"
+    "END_VAR\n"
+    "BEGIN\n"
+    "  TON(IN := run, PT := T#100ms, Q => q1);\n"
+    "  TON(IN := q1, PT := T#100ms, Q => q2);\n"
+    "  TON(IN := q2, PT := T#100ms, Q => q3);\n"
+    "  TON(IN := q3, PT := T#100ms, Q => q4);\n"
+    "  TON(IN := q4, PT := T#100ms, Q => q5);\n"
+    "  TON(IN := q5, PT := T#100ms, Q => q6);\n"
+    "  TON(IN := q6, PT := T#100ms, Q => q7);\n"
+    "  TON(IN := q7, PT := T#100ms, Q => q8);\n"
+    "  IF q8 THEN\n"
+    "    n := n + 1;\n"
+    "  END_IF;\n"
+    "END_PROGRAM\n"},
+  {"timer_ladder",
+    "PROGRAM bench\n"
+    "VAR\n"
+    "  run : BOOL := TRUE;\n"
+    "  a : BOOL;\n"
+    "  b : BOOL;\n"
+    "  n : INT;\n"
+    "  x : INT;\n"
+    "  y : REAL;\n"
+    "END_VAR\n"
+    "BEGIN\n"
+    "  a := TON(run, T#100ms);\n"
+    "  b := TON(a, T#100ms);\n"
+    "  a := TON(b, T#100ms);\n"
+    "  b := TON(a, T#100ms);\n"
+    "  a := TON(b, T#100ms);\n"
+    "  b := TON(a, T#100ms);\n"
+    "  a := TON(b, T#100ms);\n"
+    "  b := TON(a, T#100ms);\n"
+    "  a := TON(b, T#100ms);\n"
+    "  b := TON(a, T#100ms);\n"
+    "  a := TON(b, T#100ms);\n"
+    "  b := TON(a, T#100ms);\n"
+    "  a := TON(b, T#100ms);\n"
+    "  b := TON(a, T#100ms);\n"
+    "  a := TON(b, T#100ms);\n"
+    "  b := TON(a, T#100ms);\n"
+    "  a := TON(b, T#100ms);\n"
+    "  b := TON(a, T#100ms);\n"
+    "  a := TON(b, T#100ms);\n"
+    "  b := TON(a, T#100ms);\n"
+    "  a := TON(b, T#100ms);\n"
+    "  b := TON(a, T#100ms);\n"
+    "  a := TON(b, T#100ms);\n"
+    "  b := TON(a, T#100ms);\n"
+    "  a := TON(b, T#100ms);\n"
+    "  b := TON(a, T#100ms);\n"
+    "  a := TON(b, T#100ms);\n"
+    "  b := TON(a, T#100ms);\n"
+    "  a := TON(b, T#100ms);\n"
+    "  b := TON(a, T#100ms);\n"
+    "  a := TON(b, T#100ms);\n"
+    "  b := TON(a, T#100ms);\n"
+    "  IF b THEN\n"
+    "    n := n + 1;\n"
+    "  END_IF;\n"
+    "  x := LIMIT(0, n, 1000);\n"
+    "  y := SCALE(x, 0, 1000, 0.0, 100.0);\n"
+    "END_PROGRAM\n"},
+};
+
+#define PROGRAM_COUNT (sizeof(programs) / sizeof(programs[0]))
+
+typedef struct {
+  st_bytecode_program_t *bc;
+  st_vm_t vm;
+  uint64_t instructions;
+  uint64_t ns;
+} bench_copy_t;
+
+static bool copy_init(bench_copy_t *c, const char *source) {
+  memset(c, 0, sizeof(*c));
+  c->bc = st_host_compile(source, true, NULL);
+  if (!c->bc) return false;
+  st_vm_init(&c->vm, c->bc);
+  return true;
+}
+
+static bool copy_cycle(bench_copy_t *c, st_host_run_mode_t mode) {
+  uint64_t t0 = host_test_now_ns();
+  bool ok = st_host_cycle(&c->vm, c->bc, mode);
+  c->ns += host_test_now_ns() - t0;
+  c->instructions += c->vm.step_count;  // Reset by st_vm_begin_cycle
+  return ok;
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================ */
+
+int main(int argc, char **argv) {
+  uint32_t cycles = (argc > 1) ? (uint32_t)atol(argv[1]) : 20000;
+
+  printf("============================================================\n");
+  printf("  ST VM: threaded fast path vs. st_vm_step (host)\n");
+  printf("============================================================\n");
+
+  config_struct_create_default();
+  registers_init();
+  host_time_set_manual(true);
+
+  host_test_section("Test 1+2: Identiske resultater og instruktioner/s");
+  printf("  %-13s %6s %10s %10s %7s\n", "program", "instr", "fast Mi/s", "step Mi/s", "ratio");
+
+  double log_ratio_sum = 0;
+  for (size_t p = 0; p < PROGRAM_COUNT; p++) {
+    bench_copy_t fast, step;
+    if (!copy_init(&fast, programs[p].source) || !copy_init(&step, programs[p].source)) {
+      PASS_IF(programs[p].name, false);
+      continue;
+    }
+
+    uint32_t mismatch_cycle = 0;
+    bool errors = false;
+    for (uint32_t c = 1; c <= cycles; c++) {
+      // Alternate the order so cache warmth does not favour one mode
+      bool ok_fast, ok_step;
+      if (c & 1) {
+        ok_fast = copy_cycle(&fast, ST_HOST_RUN_FAST);
+        ok_step = copy_cycle(&step, ST_HOST_RUN_STEP);
+      } else {
+        ok_step = copy_cycle(&step, ST_HOST_RUN_STEP);
+        ok_fast = copy_cycle(&fast, ST_HOST_RUN_FAST);
+      }
+      errors |= !ok_fast || !ok_step;
+      if (!mismatch_cycle &&
+          (memcmp(fast.bc->variables, step.bc->variables, fast.bc->var_count * sizeof(st_value_t)) != 0 ||
+           fast.instructions != step.instructions)) {
+        mismatch_cycle = c;
+      }
+      host_time_advance_us(10000);
+    }
+
+    double fast_mips = fast.instructions * 1e3 / fast.ns;
+    double step_mips = step.instructions * 1e3 / step.ns;
+    double ratio = fast_mips / step_mips;
+    log_ratio_sum += log(ratio);
+    printf("  %-13s %6u %10.1f %10.1f %6.2fx\n", programs[p].name, (unsigned)(fast.instructions / cycles),
+           fast_mips, step_mips, ratio);
+
+    if (mismatch_cycle) printf("  %s: første afvigelse i cyklus %u\n", programs[p].name, mismatch_cycle);
+    CHECK(!errors);
+    CHECK(mismatch_cycle == 0);
+    CHECK(ratio >= 1.0);
+
+    st_host_free(fast.bc);
+    st_host_free(step.bc);
+  }
+
+  double geo = exp(log_ratio_sum / PROGRAM_COUNT);
+  printf("  Geometrisk middel: %.2fx (ESP32 mål 1.4-1.7x)\n", geo);
+  PASS_IF("Fast path og step loop giver identiske variabler i alle cykler", host_test_failed == 0);
+  PASS_IF("Fast path er ikke langsommere end step loop", geo >= 1.0);
+
+  return host_test_summary();
+}
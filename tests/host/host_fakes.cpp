@@ -0,0 +1,137 @@
+/**
+ * @file host_fakes.cpp
+ * @brief Weak stand-ins for the firmware modules the host tests do not build
+ *
+ * Every definition is weak: a test that links the real module (or defines
+ * its own fake) overrides it. Debug output is dropped unless HOST_DEBUG=1.
+ */
+
+#include "debug.h"
+#include "counter_config.h"
+#include "counter_engine.h"
+#include "timer_engine.h"
+#include "st_logic_config.h"
+#include "modbus_server.h"
+#include "uart_driver.h"
+#include "counter_frequency.h"
+#include "config_load.h"
+#include "config_save.h"
+#include "registers_persist.h"
+#include "modbus_master.h"
+#include "mb_async.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define HOST_WEAK __attribute__((weak))
+
+static bool host_debug_enabled(void) {
+  static int enabled = -1;
+  if (enabled < 0) {
+    const char *env = getenv("HOST_DEBUG");
+    enabled = (env && env[0] == '1') ? 1 : 0;
+  }
+  return enabled == 1;
+}
+
+/* ============================================================================
+ * DEBUG (debug.cpp → CLI console)
+ * ============================================================================ */
+
+HOST_WEAK void debug_println(const char *str) { if (host_debug_enabled()) printf("%s\n", str); }
+HOST_WEAK void debug_print(const char *str) { if (host_debug_enabled()) fputs(str, stdout); }
+HOST_WEAK void debug_print_uint(uint32_t value) { if (host_debug_enabled()) printf("%u", value); }
+HOST_WEAK void debug_print_ulong(uint64_t value) { if (host_debug_enabled()) printf("%llu", (unsigned long long)value); }
+HOST_WEAK void debug_print_float(double value) { if (host_debug_enabled()) printf("%.2f", value); }
+HOST_WEAK void debug_newline(void) { if (host_debug_enabled()) putchar('\n'); }
+
+HOST_WEAK void debug_printf(const char *fmt, ...) {
+  if (!host_debug_enabled()) return;
+  va_list ap;
+  va_start(ap, fmt);
+  vprintf(fmt, ap);
+  va_end(ap);
+}
+
+/* ============================================================================
+ * COUNTER / TIMER / ST LOGIC (register side effects in registers.cpp)
+ * ============================================================================ */
+
+HOST_WEAK bool counter_config_get(uint8_t id, CounterConfig *out) { return false; }
+HOST_WEAK bool counter_engine_get_config(uint8_t id, CounterConfig *out) { return false; }
+HOST_WEAK void counter_engine_reset(uint8_t id) {}
+HOST_WEAK bool counter_config_set(uint8_t id, const CounterConfig *cfg) { return false; }
+HOST_WEAK bool counter_engine_configure(uint8_t id, const CounterConfig *cfg) { return false; }
+HOST_WEAK uint64_t counter_engine_get_value(uint8_t id) { return 0; }
+HOST_WEAK uint16_t counter_frequency_get(uint8_t id) { return 0; }
+HOST_WEAK bool timer_engine_get_config(uint8_t id, TimerConfig *out) { return false; }
+
+HOST_WEAK st_logic_engine_state_t *st_logic_get_state(void) { return NULL; }
+HOST_WEAK st_logic_program_config_t *st_logic_get_program(st_logic_engine_state_t *state, uint8_t program_id) { return NULL; }
+HOST_WEAK bool st_logic_set_enabled(st_logic_engine_state_t *state, uint8_t program_id, uint8_t enabled) { return false; }
+HOST_WEAK uint32_t st_logic_get_period_ms(const st_logic_engine_state_t *state, uint8_t program_id) { return 0; }
+HOST_WEAK const char *st_logic_get_source_code(st_logic_engine_state_t *state, uint8_t program_id) { return NULL; }
+
+/* ============================================================================
+ * PERSISTENCE (config_load.cpp, config_save.cpp, registers_persist.cpp)
+ * ============================================================================ */
+
+HOST_WEAK bool config_load_from_nvs(PersistConfig *out) { return false; }
+HOST_WEAK bool config_save_to_nvs(const PersistConfig *cfg) { return false; }
+HOST_WEAK bool registers_persist_is_enabled(void) { return false; }
+HOST_WEAK bool registers_persist_group_save_by_id(uint8_t group_id) { return false; }
+HOST_WEAK bool registers_persist_group_restore_by_id(uint8_t group_id) { return false; }
+HOST_WEAK bool registers_persist_group_changed_since(uint8_t group_id, uint32_t since_seq) { return false; }
+
+/* ============================================================================
+ * MODBUS MASTER ASYNC (mb_async.cpp, modbus_master.cpp → ST builtins)
+ * Tests that link the real master stack override all of these.
+ * ============================================================================ */
+
+HOST_WEAK modbus_master_config_t g_modbus_master_config;
+HOST_WEAK portMUX_TYPE mb_cache_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+HOST_WEAK bool mb_cache_get_or_create(uint8_t slave_id, uint16_t address, uint8_t req_type, mb_cache_entry_t *out) { return false; }
+HOST_WEAK bool mb_async_queue_read(mb_request_type_t type, uint8_t slave_id, uint16_t address) { return false; }
+HOST_WEAK bool mb_async_queue_write(mb_request_type_t type, uint8_t slave_id, uint16_t address, st_value_t value) { return false; }
+HOST_WEAK bool mb_async_queue_read_multi(uint8_t slave_id, uint16_t address, uint8_t count) { return false; }
+HOST_WEAK bool mb_async_queue_write_payload(uint8_t slave_id, uint16_t address, uint8_t count, uint8_t payload) { return false; }
+HOST_WEAK uint8_t mb_payload_alloc() { return MB_PAYLOAD_NONE; }
+HOST_WEAK void mb_payload_release(uint8_t slot) {}
+HOST_WEAK uint16_t *mb_payload_data(uint8_t slot) { return NULL; }
+HOST_WEAK uint8_t mb_async_block_result_pin(uint8_t slave_id, uint16_t address, uint8_t count) { return MB_PAYLOAD_NONE; }
+HOST_WEAK bool mb_async_poll_covers(uint8_t slave_id, uint8_t req_type, uint16_t address) { return false; }
+HOST_WEAK bool mb_async_is_busy() { return false; }
+HOST_WEAK const mb_async_state_t *mb_async_get_state() { return NULL; }
+
+/* ============================================================================
+ * MODBUS SLAVE / UART (modbus_server.cpp, uart_driver.cpp)
+ * ============================================================================ */
+
+HOST_WEAK uint8_t modbus_server_get_slave_id(void) { return 1; }
+
+HOST_WEAK uint16_t uart1_available(void) { return 0; }
+HOST_WEAK int uart1_read(void) { return -1; }
+HOST_WEAK uint16_t uart1_read_buffer(uint8_t *dst, uint16_t max_len) { return 0; }
+HOST_WEAK void uart1_write_buffer(const uint8_t *data, uint16_t length) {}
+HOST_WEAK void uart1_flush_rx(void) {}
+HOST_WEAK void uart1_flush_tx(void) {}
+HOST_WEAK void uart1_stop(void) {}
+HOST_WEAK void uart1_init_ex(uint32_t baudrate, uint32_t config) {}
+HOST_WEAK void uart1_set_rx_frame_callback(uart_rx_frame_cb_t cb, uint8_t idle_symbols) {}
+HOST_WEAK uint8_t uart_get_master_dir_pin(void) { return 0; }
+
+/* ============================================================================
+ * MODBUS MASTER CLI HELPERS (cli_commands_modbus_master.cpp)
+ * ============================================================================ */
+
+// Same rule as the CLI: 0 = auto t3.5 (2 ms above 19200 baud)
+HOST_WEAK uint16_t modbus_calc_t35_ms(uint32_t baudrate) {
+  if (baudrate > 19200) return 2;
+  uint16_t t35 = (uint16_t)((3.5f * 11.0f / (float)baudrate) * 1000.0f + 1.5f);
+  return t35 < 2 ? 2 : t35;
+}
+
+HOST_WEAK uint16_t modbus_effective_inter_frame(uint16_t configured, uint32_t baudrate) {
+  return (configured == 0) ? modbus_calc_t35_ms(baudrate) : configured;
+}
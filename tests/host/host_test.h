@@ -0,0 +1,68 @@
+/**
+ * @file host_test.h
+ * @brief Minimal check/report helpers for the host tests (tests/host)
+ *
+ * Same output format as the Python device tests ([PASS]/[FAIL] lines and a
+ * RESULTAT summary). A failed CHECK logs and continues; the exit code of
+ * host_test_summary() fails the make target.
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+static unsigned host_test_passed = 0;
+static unsigned host_test_failed = 0;
+
+static inline void host_test_section(const char *name) {
+  printf("\n--- %s ---\n", name);
+}
+
+static inline bool host_test_check(bool ok, const char *what, const char *file, int line) {
+  if (ok) {
+    host_test_passed++;
+  } else {
+    host_test_failed++;
+    printf("  [FAIL] %s (%s:%d)\n", what, file, line);
+  }
+  return ok;
+}
+
+// Silent on success: tests run thousands of checks in loops
+#define CHECK(cond) host_test_check((cond), #cond, __FILE__, __LINE__)
+
+#define CHECK_EQ(a, b) do { \
+    long long va_ = (long long)(a), vb_ = (long long)(b); \
+    if (!host_test_check(va_ == vb_, #a " == " #b, __FILE__, __LINE__)) \
+      printf("         %lld != %lld\n", va_, vb_); \
+  } while (0)
+
+// Named pass line for the summary of a test case
+#define PASS_IF(name, cond) do { \
+    if (host_test_check((cond), name, __FILE__, __LINE__)) printf("  [PASS] %s\n", name); \
+  } while (0)
+
+static inline int host_test_summary(void) {
+  unsigned total = host_test_passed + host_test_failed;
+  printf("\n============================================================\n");
+  printf("RESULTAT: %u/%u checks bestået\n", host_test_passed, total);
+  printf("============================================================\n");
+  return host_test_failed == 0 ? 0 : 1;
+}
+
+static inline uint64_t host_test_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Keep the optimizer from dropping benchmark results
+static inline void host_test_sink(uint64_t v) {
+  static volatile uint64_t sink;
+  sink += v;
+}
+
+#endif // HOST_TEST_H
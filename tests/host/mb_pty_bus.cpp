@@ -0,0 +1,381 @@
+/**
+ * @file mb_pty_bus.cpp
+ * @brief Host RS485 bus over a pseudo terminal: master transport + slave farm (FEAT-159)
+ *
+ * Transport calls run on the bus worker under the master's port lock; the
+ * reader thread only appends to rx[] under the mutex and gives the RX event.
+ * The farm thread owns the pty master end and the register maps (registers
+ * are read/written with __atomic so the test may poke them meanwhile).
+ */
+
+#include "mb_pty_bus.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <pty.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MB_PTY_FRAME_MAX  256
+#define MB_PTY_GAP_MS     3       // Idle gap that ends a partial request on the farm side
+
+struct mb_pty_bus {
+  int master_fd;                      // Farm side
+  int slave_fd;                       // Modbus master side (raw tty)
+  char name[64];
+  volatile bool running;
+  pthread_t reader;
+  pthread_t farm;
+
+  // Transport RX buffer (reader thread → worker)
+  pthread_mutex_t rx_lock;
+  uint8_t rx[MB_PTY_FRAME_MAX * 4];
+  uint16_t rx_len;
+  uint16_t rx_pos;
+  void (*volatile on_rx_event)(void);
+
+  mb_pty_farm_config_t cfg;
+  mb_pty_farm_stats_t stats;
+  mb_pty_observer_t volatile observer;
+  void *observer_arg;
+  unsigned int seed;                  // rand_r state for jitter + injection (farm thread)
+  uint16_t regs[MB_PTY_FARM_SLAVES][MB_PTY_FARM_REGS];
+};
+
+static uint16_t mb_pty_crc(const uint8_t *buf, uint16_t len) {
+  uint16_t crc = 0xFFFF;
+  for (uint16_t i = 0; i < len; i++) {
+    crc ^= buf[i];
+    for (uint8_t j = 0; j < 8; j++) crc = (crc & 1) ? (uint16_t)((crc >> 1) ^ 0xA001) : (uint16_t)(crc >> 1);
+  }
+  return crc;
+}
+
+static void mb_pty_sleep_us(uint64_t us) {
+  struct timespec ts = {(time_t)(us / 1000000), (long)(us % 1000000) * 1000};
+  while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {}
+}
+
+static void mb_pty_write_all(int fd, const uint8_t *data, size_t len) {
+  while (len > 0) {
+    ssize_t n = write(fd, data, len);
+    if (n < 0) {
+      if (errno == EINTR || errno == EAGAIN) continue;
+      return;
+    }
+    data += n;
+    len -= (size_t)n;
+  }
+}
+
+/* ============================================================================
+ * TRANSPORT (Modbus master side)
+ * ============================================================================ */
+
+static void *mb_pty_reader_main(void *arg) {
+  mb_pty_bus_t *pb = (mb_pty_bus_t *)arg;
+  while (pb->running) {
+    struct pollfd pfd = {pb->slave_fd, POLLIN, 0};
+    if (poll(&pfd, 1, 20) <= 0) continue;
+    uint8_t buf[MB_PTY_FRAME_MAX];
+    ssize_t n = read(pb->slave_fd, buf, sizeof(buf));
+    if (n <= 0) continue;
+    pthread_mutex_lock(&pb->rx_lock);
+    if (pb->rx_pos == pb->rx_len) pb->rx_pos = pb->rx_len = 0;
+    size_t room = sizeof(pb->rx) - pb->rx_len;
+    if ((size_t)n > room) n = (ssize_t)room;
+    memcpy(&pb->rx[pb->rx_len], buf, (size_t)n);
+    pb->rx_len += (uint16_t)n;
+    pthread_mutex_unlock(&pb->rx_lock);
+    void (*cb)(void) = pb->on_rx_event;
+    if (cb) cb();
+  }
+  return NULL;
+}
+
+static void mb_pty_attach(void *ctx, uint8_t bus, void (*on_rx_event)(void)) {
+  ((mb_pty_bus_t *)ctx)->on_rx_event = on_rx_event;
+}
+
+static void mb_pty_flush_rx(void *ctx) {
+  mb_pty_bus_t *pb = (mb_pty_bus_t *)ctx;
+  pthread_mutex_lock(&pb->rx_lock);
+  pb->rx_pos = pb->rx_len = 0;
+  pthread_mutex_unlock(&pb->rx_lock);
+}
+
+static void mb_pty_write(void *ctx, const uint8_t *data, uint8_t len) {
+  mb_pty_write_all(((mb_pty_bus_t *)ctx)->slave_fd, data, len);
+}
+
+static void mb_pty_flush_tx(void *ctx) {
+  tcdrain(((mb_pty_bus_t *)ctx)->slave_fd);
+}
+
+static int mb_pty_available(void *ctx) {
+  mb_pty_bus_t *pb = (mb_pty_bus_t *)ctx;
+  pthread_mutex_lock(&pb->rx_lock);
+  int n = pb->rx_len - pb->rx_pos;
+  pthread_mutex_unlock(&pb->rx_lock);
+  return n;
+}
+
+static int mb_pty_read(void *ctx) {
+  mb_pty_bus_t *pb = (mb_pty_bus_t *)ctx;
+  pthread_mutex_lock(&pb->rx_lock);
+  int b = (pb->rx_pos < pb->rx_len) ? pb->rx[pb->rx_pos++] : -1;
+  pthread_mutex_unlock(&pb->rx_lock);
+  return b;
+}
+
+static const mb_transport_t mb_pty_transport_ops = {
+  "pty",
+  mb_pty_attach,
+  mb_pty_flush_rx,
+  mb_pty_write,
+  mb_pty_flush_tx,
+  NULL,
+  mb_pty_available,
+  mb_pty_read
+};
+
+const mb_transport_t *mb_pty_transport(void) {
+  return &mb_pty_transport_ops;
+}
+
+/* ============================================================================
+ * SLAVE FARM (pty master side)
+ * ============================================================================ */
+
+static uint16_t *mb_pty_reg(mb_pty_bus_t *pb, uint8_t slave_id, uint16_t addr) {
+  return &pb->regs[slave_id - pb->cfg.first_slave][addr];
+}
+
+// Expected request length from the header (have + 1 = header incomplete, 0 = unknown function)
+static uint16_t mb_pty_request_len(const uint8_t *req, uint16_t have) {
+  if (have < 2) return (uint16_t)(have + 1);
+  uint8_t fc = req[1];
+  if (fc >= 0x01 && fc <= 0x06) return 8;
+  if (fc == 0x0F || fc == 0x10) return have < 7 ? (uint16_t)(have + 1) : (uint16_t)(9 + req[6]);
+  return 0;
+}
+
+// Response frame without CRC for one request, returns its length
+static uint16_t mb_pty_execute(mb_pty_bus_t *pb, const uint8_t *req, uint8_t *resp) {
+  uint8_t slave = req[0];
+  uint8_t fc = req[1];
+  uint16_t addr = (uint16_t)(req[2] << 8 | req[3]);
+  uint16_t qty = (uint16_t)(req[4] << 8 | req[5]);
+  uint16_t n = 0;
+  resp[n++] = slave;
+
+  bool single = (fc == 0x05 || fc == 0x06);
+  uint16_t span = single ? 1 : qty;
+  bool known = (fc >= 0x01 && fc <= 0x06) || fc == 0x0F || fc == 0x10;
+  if (!known || (!single && (qty == 0 || qty > 125 * ((fc <= 0x02 || fc == 0x0F) ? 16 : 1)))) {
+    resp[n++] = (uint8_t)(fc | 0x80);
+    resp[n++] = known ? 0x03 : 0x01;
+    return n;
+  }
+  if ((uint32_t)addr + span > MB_PTY_FARM_REGS) {
+    resp[n++] = (uint8_t)(fc | 0x80);
+    resp[n++] = 0x02;
+    return n;
+  }
+
+  resp[n++] = fc;
+  switch (fc) {
+    case 0x01:
+    case 0x02: {
+      uint8_t bytes = (uint8_t)((qty + 7) / 8);
+      resp[n++] = bytes;
+      memset(&resp[n], 0, bytes);
+      for (uint16_t i = 0; i < qty; i++) {
+        if (__atomic_load_n(mb_pty_reg(pb, slave, addr + i), __ATOMIC_RELAXED) & 1) resp[n + i / 8] |= (uint8_t)(1 << (i % 8));
+      }
+      n += bytes;
+      break;
+    }
+    case 0x03:
+    case 0x04:
+      resp[n++] = (uint8_t)(qty * 2);
+      for (uint16_t i = 0; i < qty; i++) {
+        uint16_t v = __atomic_load_n(mb_pty_reg(pb, slave, addr + i), __ATOMIC_RELAXED);
+        resp[n++] = (uint8_t)(v >> 8);
+        resp[n++] = (uint8_t)v;
+      }
+      break;
+    case 0x05:
+    case 0x06: {
+      uint16_t v = (fc == 0x05) ? (qty == 0xFF00) : qty;
+      __atomic_store_n(mb_pty_reg(pb, slave, addr), v, __ATOMIC_RELAXED);
+      memcpy(&resp[n], &req[2], 4);
+      n += 4;
+      break;
+    }
+    case 0x0F:
+    case 0x10:
+      for (uint16_t i = 0; i < qty; i++) {
+        uint16_t v = (fc == 0x0F) ? (uint16_t)((req[7 + i / 8] >> (i % 8)) & 1)
+                                  : (uint16_t)(req[7 + i * 2] << 8 | req[8 + i * 2]);
+        __atomic_store_n(mb_pty_reg(pb, slave, addr + i), v, __ATOMIC_RELAXED);
+      }
+      memcpy(&resp[n], &req[2], 4);
+      n += 4;
+      break;
+  }
+  return n;
+}
+
+static void mb_pty_serve(mb_pty_bus_t *pb, const uint8_t *req, uint16_t len) {
+  if (mb_pty_crc(req, (uint16_t)(len - 2)) != (uint16_t)(req[len - 2] | req[len - 1] << 8)) {
+    pb->stats.crc_errors++;
+    return;
+  }
+  pb->stats.requests++;
+  mb_pty_observer_t observer = pb->observer;
+  if (observer) observer(pb->observer_arg, req, len);
+  mb_pty_farm_config_t cfg = pb->cfg;
+  uint8_t slave = req[0];
+  if (slave < cfg.first_slave || slave > cfg.last_slave) {
+    pb->stats.foreign++;
+    return;
+  }
+  if (cfg.dead_first && slave >= cfg.dead_first && slave <= cfg.dead_last) {
+    pb->stats.dropped++;
+    return;
+  }
+
+  if (cfg.timeout_pct && (uint32_t)rand_r(&pb->seed) % 100 < cfg.timeout_pct) {
+    pb->stats.injected_timeouts++;
+    return;
+  }
+
+  uint8_t resp[MB_PTY_FRAME_MAX];
+  uint16_t n;
+  if (cfg.exception_pct && (uint32_t)rand_r(&pb->seed) % 100 < cfg.exception_pct) {
+    resp[0] = slave;
+    resp[1] = (uint8_t)(req[1] | 0x80);
+    resp[2] = 0x04;
+    n = 3;
+    pb->stats.injected_exceptions++;
+  } else {
+    n = mb_pty_execute(pb, req, resp);
+  }
+  uint16_t crc = mb_pty_crc(resp, n);
+  if (cfg.crc_error_pct && (uint32_t)rand_r(&pb->seed) % 100 < cfg.crc_error_pct) {
+    crc ^= 0xFFFF;
+    pb->stats.injected_crc_errors++;
+  }
+  resp[n++] = (uint8_t)crc;
+  resp[n++] = (uint8_t)(crc >> 8);
+
+  // Request and response on the wire (11 bits per character) + slave processing
+  uint64_t wire_us = cfg.baudrate ? (uint64_t)(len + n) * 11000000ull / cfg.baudrate : 0;
+  uint32_t jitter_us = cfg.jitter_us ? (uint32_t)rand_r(&pb->seed) % (cfg.jitter_us + 1) : 0;
+  mb_pty_sleep_us(wire_us + cfg.latency_us + jitter_us);
+  mb_pty_write_all(pb->master_fd, resp, n);
+  pb->stats.responses++;
+}
+
+static void *mb_pty_farm_main(void *arg) {
+  mb_pty_bus_t *pb = (mb_pty_bus_t *)arg;
+  uint8_t req[MB_PTY_FRAME_MAX];
+  uint16_t have = 0;
+  while (pb->running) {
+    struct pollfd pfd = {pb->master_fd, POLLIN, 0};
+    if (poll(&pfd, 1, MB_PTY_GAP_MS) <= 0) {
+      have = 0;  // Line idle: a partial request is dropped, like a t3.5 gap on RS485
+      continue;
+    }
+    ssize_t n = read(pb->master_fd, &req[have], sizeof(req) - have);
+    if (n <= 0) continue;
+    have += (uint16_t)n;
+    for (;;) {
+      uint16_t want = mb_pty_request_len(req, have);
+      if (want == 0 || want > sizeof(req)) {
+        have = 0;  // Not a request we can hold: drop it
+        break;
+      }
+      if (have < want) break;
+      mb_pty_serve(pb, req, want);
+      memmove(req, &req[want], have - want);
+      have -= want;
+    }
+  }
+  return NULL;
+}
+
+/* ============================================================================
+ * LIFECYCLE
+ * ============================================================================ */
+
+mb_pty_bus_t *mb_pty_bus_open(const mb_pty_farm_config_t *cfg) {
+  if (cfg->first_slave < 1 || cfg->last_slave < cfg->first_slave ||
+      cfg->last_slave - cfg->first_slave + 1 > MB_PTY_FARM_SLAVES) {
+    return NULL;
+  }
+  mb_pty_bus_t *pb = (mb_pty_bus_t *)calloc(1, sizeof(mb_pty_bus_t));
+  if (!pb) return NULL;
+  if (openpty(&pb->master_fd, &pb->slave_fd, pb->name, NULL, NULL) != 0) {
+    free(pb);
+    return NULL;
+  }
+  struct termios tio;
+  tcgetattr(pb->slave_fd, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(pb->slave_fd, TCSANOW, &tio);
+
+  pb->cfg = *cfg;
+  pb->seed = (unsigned int)pb->master_fd * 2654435761u;
+  for (uint16_t s = 0; s <= cfg->last_slave - cfg->first_slave; s++) {
+    for (uint16_t a = 0; a < MB_PTY_FARM_REGS; a++) {
+      pb->regs[s][a] = (uint16_t)(((cfg->first_slave + s) << 8) ^ a);
+    }
+  }
+  pthread_mutex_init(&pb->rx_lock, NULL);
+  pb->running = true;
+  pthread_create(&pb->reader, NULL, mb_pty_reader_main, pb);
+  pthread_create(&pb->farm, NULL, mb_pty_farm_main, pb);
+  return pb;
+}
+
+void mb_pty_bus_close(mb_pty_bus_t *pb) {
+  if (!pb) return;
+  pb->running = false;
+  pthread_join(pb->reader, NULL);
+  pthread_join(pb->farm, NULL);
+  close(pb->slave_fd);
+  close(pb->master_fd);
+  pthread_mutex_destroy(&pb->rx_lock);
+  free(pb);
+}
+
+const char *mb_pty_bus_name(const mb_pty_bus_t *pb) {
+  return pb->name;
+}
+
+mb_pty_farm_config_t *mb_pty_farm_config(mb_pty_bus_t *pb) {
+  return &pb->cfg;
+}
+
+mb_pty_farm_stats_t mb_pty_farm_stats(const mb_pty_bus_t *pb) {
+  return pb->stats;
+}
+
+void mb_pty_farm_observe(mb_pty_bus_t *pb, mb_pty_observer_t fn, void *arg) {
+  pb->observer_arg = arg;
+  pb->observer = fn;
+}
+
+uint16_t mb_pty_farm_get(const mb_pty_bus_t *pb, uint8_t slave_id, uint16_t addr) {
+  return __atomic_load_n(&pb->regs[slave_id - pb->cfg.first_slave][addr], __ATOMIC_RELAXED);
+}
+
+void mb_pty_farm_set(mb_pty_bus_t *pb, uint8_t slave_id, uint16_t addr, uint16_t value) {
+  __atomic_store_n(&pb->regs[slave_id - pb->cfg.first_slave][addr], value, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,69 @@
+/**
+ * @file mb_pty_bus.h
+ * @brief Host RS485 bus over a pseudo terminal: master transport + slave farm (FEAT-159)
+ *
+ * The pty slave end (/dev/pts/N, raw mode) is the master's "UART": the
+ * mb_transport_t below does its byte I/O there and raises the RX event from
+ * a reader thread, the same way the UART driver event task does. A farm
+ * thread on the pty master end answers RTU requests for a range of slave IDs
+ * (FC01-06, FC15, FC16) after the wire time of request + response at the
+ * configured baudrate plus a processing latency (+ jitter). Slaves in the dead
+ * range see their requests and never answer; the others can be made to drop,
+ * corrupt (bad CRC) or refuse (exception 04) a share of their answers.
+ */
+
+#ifndef MB_PTY_BUS_H
+#define MB_PTY_BUS_H
+
+#include "mb_transport.h"
+#include <stdint.h>
+
+#define MB_PTY_FARM_SLAVES     32     // Slave IDs per farm
+#define MB_PTY_FARM_REGS       1024   // Registers per slave (coils = bit 0 of the register)
+
+typedef struct {
+  uint8_t  first_slave;               // Slave IDs this farm answers for
+  uint8_t  last_slave;
+  uint8_t  dead_first;                // Never answer these (0 = none)
+  uint8_t  dead_last;
+  uint32_t baudrate;                  // Wire time per character (0 = none)
+  uint32_t latency_us;                // Slave processing time before the response
+  uint32_t jitter_us;                 // + uniform 0..jitter_us
+  uint8_t  timeout_pct;               // Injected: no answer
+  uint8_t  crc_error_pct;             // Injected: corrupted CRC
+  uint8_t  exception_pct;             // Injected: exception 04 (slave device failure)
+} mb_pty_farm_config_t;
+
+typedef struct {
+  uint32_t requests;                  // Frames with a valid CRC
+  uint32_t responses;
+  uint32_t foreign;                   // Requests for a slave outside the farm (misrouted)
+  uint32_t dropped;                   // Requests to a dead slave
+  uint32_t crc_errors;
+  uint32_t injected_timeouts;
+  uint32_t injected_crc_errors;
+  uint32_t injected_exceptions;
+} mb_pty_farm_stats_t;
+
+typedef struct mb_pty_bus mb_pty_bus_t;
+
+// Called on the farm thread for every request with a valid CRC (before it is answered)
+typedef void (*mb_pty_observer_t)(void *arg, const uint8_t *frame, uint16_t len);
+
+// Open the pty, start reader + farm threads. Registers start at (slave << 8) ^ addr.
+mb_pty_bus_t *mb_pty_bus_open(const mb_pty_farm_config_t *cfg);
+void mb_pty_bus_close(mb_pty_bus_t *pb);
+
+// Transport for modbus_master_set_transport(bus, mb_pty_transport(), pb)
+const mb_transport_t *mb_pty_transport(void);
+const char *mb_pty_bus_name(const mb_pty_bus_t *pb);
+
+// Live config (timing and dead range are read per request)
+mb_pty_farm_config_t *mb_pty_farm_config(mb_pty_bus_t *pb);
+mb_pty_farm_stats_t mb_pty_farm_stats(const mb_pty_bus_t *pb);
+void mb_pty_farm_observe(mb_pty_bus_t *pb, mb_pty_observer_t fn, void *arg);
+
+uint16_t mb_pty_farm_get(const mb_pty_bus_t *pb, uint8_t slave_id, uint16_t addr);
+void mb_pty_farm_set(mb_pty_bus_t *pb, uint8_t slave_id, uint16_t addr, uint16_t value);
+
+#endif // MB_PTY_BUS_H
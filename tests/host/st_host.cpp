@@ -0,0 +1,87 @@
+/**
+ * @file st_host.cpp
+ * @brief Compile and run ST programs on host (see st_host.h)
+ */
+
+#include "st_host.h"
+#include "st_parser.h"
+#include "st_compiler.h"
+#include "st_stateful.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+// Same per-cycle limit as st_logic_execute_program()
+#define ST_HOST_MAX_STEPS 10000
+
+st_bytecode_program_t *st_host_compile(const char *source, bool optimize, st_optimizer_stats_t *stats) {
+  st_parser_t *parser = (st_parser_t *)malloc(sizeof(st_parser_t));
+  st_parser_init(parser, source);
+  st_program_t *program = st_parser_parse_program(parser);
+  if (!program) {
+    printf("  Parse error: %s\n", parser->error_msg);
+    free(parser);
+    return NULL;
+  }
+  free(parser);
+
+  st_compiler_t *compiler = (st_compiler_t *)malloc(sizeof(st_compiler_t));
+  st_compiler_init(compiler);
+  st_bytecode_program_t *bc = (st_bytecode_program_t *)calloc(1, sizeof(st_bytecode_program_t));
+  if (!st_compiler_compile(compiler, program, bc)) {
+    printf("  Compile error: %s\n", compiler->error_msg);
+    free(compiler);
+    free(bc);
+    st_program_free(program);
+    return NULL;
+  }
+  free(compiler);
+  st_program_free(program);
+
+  if (optimize) {
+    st_optimizer_run(bc, NULL, stats);
+  } else if (stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->instr_before = stats->instr_after = bc->instr_count;
+  }
+  return bc;
+}
+
+void st_host_free(st_bytecode_program_t *bc) {
+  if (!bc) return;
+  free(bc->instructions);
+  free(bc->func_registry);
+  free(bc->stateful);
+  free(bc);
+}
+
+bool st_host_cycle(st_vm_t *vm, st_bytecode_program_t *bc, st_host_run_mode_t mode) {
+  st_vm_begin_cycle(vm, bc);
+  memcpy(vm->variables, bc->variables, vm->var_count * sizeof(st_value_t));
+  if (bc->func_registry) vm->func_registry = bc->func_registry;
+
+  bool ok = true;
+  if (mode == ST_HOST_RUN_FAST) {
+    ok = st_vm_run_fast(vm, ST_HOST_MAX_STEPS);
+  } else {
+    uint32_t steps = 0;
+    while (!vm->halted && !vm->error) {
+      if (steps++ >= ST_HOST_MAX_STEPS) {
+        vm->error = 1;
+        break;
+      }
+      if (!st_vm_step(vm)) break;
+    }
+  }
+
+  memcpy(bc->variables, vm->variables, vm->var_count * sizeof(st_value_t));
+  return ok && !vm->error;
+}
+
+int st_host_var_index(const st_bytecode_program_t *bc, const char *name) {
+  for (uint8_t i = 0; i < bc->var_count; i++) {
+    if (strcasecmp(bc->var_names[i], name) == 0) return i;
+  }
+  return -1;
+}
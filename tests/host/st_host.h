@@ -0,0 +1,48 @@
+/**
+ * @file st_host.h
+ * @brief Compile and run ST programs on host the way the logic engine does
+ *
+ * Compiles with the real lexer/parser/compiler (optionally followed by the
+ * bytecode optimizer) and runs scan cycles like st_logic_execute_program():
+ * load variables into a long-lived VM, run, store variables back.
+ */
+
+#ifndef ST_HOST_H
+#define ST_HOST_H
+
+#include "st_types.h"
+#include "st_vm.h"
+#include "st_optimizer.h"
+
+typedef enum {
+  ST_HOST_RUN_FAST = 0,   // st_vm_run_fast (no debugger attached)
+  ST_HOST_RUN_STEP        // st_vm_step loop (debugger attached)
+} st_host_run_mode_t;
+
+/**
+ * @brief Compile ST source to a heap-allocated program
+ * @param source ST source text
+ * @param optimize Run st_optimizer_run() after compiling
+ * @param stats Output: optimizer statistics (may be NULL)
+ * @return Program (free with st_host_free), NULL on parse/compile error (printed)
+ */
+st_bytecode_program_t *st_host_compile(const char *source, bool optimize, st_optimizer_stats_t *stats);
+
+void st_host_free(st_bytecode_program_t *bc);
+
+/**
+ * @brief Run one scan cycle of a program
+ * @param vm Long-lived VM (st_vm_init once with the same program)
+ * @param bc Program; variables are loaded before and stored after the cycle
+ * @param mode Fast path or per-instruction step loop
+ * @return true if the cycle halted without error
+ */
+bool st_host_cycle(st_vm_t *vm, st_bytecode_program_t *bc, st_host_run_mode_t mode);
+
+/**
+ * @brief Index of a program variable by name (case-insensitive)
+ * @return Variable index, or -1 if not found
+ */
+int st_host_var_index(const st_bytecode_program_t *bc, const char *name);
+
+#endif // ST_HOST_H
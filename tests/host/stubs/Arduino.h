@@ -0,0 +1,39 @@
+/**
+ * @file Arduino.h
+ * @brief Host shim: the Arduino-ESP32 core API used by the firmware sources
+ *
+ * Time comes from CLOCK_MONOTONIC, GPIO calls are no-ops, no PSRAM.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "HardwareSerial.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#define HIGH    1
+#define LOW     0
+#define INPUT   0x01
+#define OUTPUT  0x03
+#define INPUT_PULLUP 0x05
+
+uint32_t millis(void);
+uint32_t micros(void);
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+static inline void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+static inline void digitalWrite(uint8_t pin, uint8_t val) { (void)pin; (void)val; }
+static inline int digitalRead(uint8_t pin) { (void)pin; return LOW; }
+static inline bool psramFound(void) { return false; }
+static inline void yield(void) {}
+
+#endif // HOST_ARDUINO_H
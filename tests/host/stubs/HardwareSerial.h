@@ -0,0 +1,77 @@
+/**
+ * @file HardwareSerial.h
+ * @brief Host shim: Arduino-ESP32 HardwareSerial without a UART behind it
+ *
+ * Serial prints to stdout. Bus UARTs are inert (nothing is received), so the
+ * Modbus master on host runs through an mb_transport_t instead.
+ */
+
+#ifndef HOST_HARDWARESERIAL_H
+#define HOST_HARDWARESERIAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+#define SERIAL_8N1 0x800001c
+#define SERIAL_8N2 0x800003c
+#define SERIAL_8E1 0x800001e
+#define SERIAL_8E2 0x800003e
+#define SERIAL_8O1 0x800001f
+#define SERIAL_8O2 0x800003f
+
+typedef void (*OnReceiveCb)(void);
+
+class HardwareSerial {
+public:
+  explicit HardwareSerial(int uart_nr = 0) : uart_nr_(uart_nr) {}
+
+  void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rx = -1, int8_t tx = -1) {
+    (void)baud; (void)config; (void)rx; (void)tx;
+  }
+  void end() {}
+  operator bool() const { return true; }
+
+  int available() { return 0; }
+  int read() { return -1; }
+  size_t read(uint8_t *buf, size_t len) { (void)buf; (void)len; return 0; }
+  void flush() { fflush(stdout); }
+
+  size_t write(uint8_t c) { return uart_nr_ == 0 ? (size_t)fputc(c, stdout) : 1; }
+  size_t write(const uint8_t *buf, size_t len) {
+    if (uart_nr_ == 0) fwrite(buf, 1, len, stdout);
+    return len;
+  }
+
+  bool setPins(int8_t rx, int8_t tx, int8_t cts = -1, int8_t rts = -1) {
+    (void)rx; (void)tx; (void)cts; (void)rts;
+    return true;
+  }
+  bool setMode(int mode) { (void)mode; return false; }
+  bool setRxTimeout(uint8_t symbols) { (void)symbols; return true; }
+  void onReceive(OnReceiveCb cb, bool only_on_timeout = false) { (void)cb; (void)only_on_timeout; }
+
+  size_t print(const char *s) { return (size_t)fputs(s, stdout); }
+  size_t print(int v) { return (size_t)printf("%d", v); }
+  size_t print(unsigned int v) { return (size_t)printf("%u", v); }
+  size_t print(long v) { return (size_t)printf("%ld", v); }
+  size_t print(unsigned long v) { return (size_t)printf("%lu", v); }
+  size_t println(const char *s = "") { return (size_t)printf("%s\n", s); }
+  size_t println(int v) { return (size_t)printf("%d\n", v); }
+  size_t println(unsigned long v) { return (size_t)printf("%lu\n", v); }
+  size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vprintf(fmt, ap);
+    va_end(ap);
+    return n > 0 ? (size_t)n : 0;
+  }
+
+private:
+  int uart_nr_;
+};
+
+extern HardwareSerial Serial;
+
+#endif // HOST_HARDWARESERIAL_H
@@ -0,0 +1,12 @@
+/**
+ * @file uart.h
+ * @brief Host shim: ESP-IDF UART driver constants used by the master
+ */
+
+#ifndef HOST_DRIVER_UART_H
+#define HOST_DRIVER_UART_H
+
+#define UART_MODE_UART                 0x00
+#define UART_MODE_RS485_HALF_DUPLEX    0x01
+
+#endif // HOST_DRIVER_UART_H
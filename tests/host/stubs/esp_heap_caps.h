@@ -0,0 +1,21 @@
+/**
+ * @file esp_heap_caps.h
+ * @brief Host shim: capability allocator mapped to malloc (no PSRAM)
+ */
+
+#ifndef HOST_ESP_HEAP_CAPS_H
+#define HOST_ESP_HEAP_CAPS_H
+
+#include <stdlib.h>
+
+#define MALLOC_CAP_8BIT     (1 << 2)
+#define MALLOC_CAP_SPIRAM   (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+
+static inline void *heap_caps_malloc(size_t size, unsigned caps) { (void)caps; return malloc(size); }
+static inline void *heap_caps_calloc(size_t n, size_t size, unsigned caps) { (void)caps; return calloc(n, size); }
+static inline void heap_caps_free(void *p) { free(p); }
+static inline size_t heap_caps_get_largest_free_block(unsigned caps) { (void)caps; return 128 * 1024; }
+static inline size_t heap_caps_get_free_size(unsigned caps) { (void)caps; return 256 * 1024; }
+
+#endif // HOST_ESP_HEAP_CAPS_H
@@ -0,0 +1,16 @@
+/**
+ * @file esp_system.h
+ * @brief Host shim: heap statistics report a fixed free heap, no restart
+ */
+
+#ifndef HOST_ESP_SYSTEM_H
+#define HOST_ESP_SYSTEM_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+static inline uint32_t esp_get_free_heap_size(void) { return 256 * 1024; }
+static inline uint32_t esp_get_minimum_free_heap_size(void) { return 256 * 1024; }
+static inline void esp_restart(void) { exit(0); }
+
+#endif // HOST_ESP_SYSTEM_H
@@ -0,0 +1,44 @@
+/**
+ * @file esp_timer.h
+ * @brief Host shim: esp_timer_get_time() from CLOCK_MONOTONIC, one-shot timers
+ *
+ * Every timer gets its own thread that runs the callback (ESP_TIMER_TASK
+ * semantics). Due times use the real clock, not the manual clock.
+ */
+
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef int esp_err_t;
+#ifndef ESP_OK
+#define ESP_OK                  0
+#define ESP_FAIL                -1
+#define ESP_ERR_INVALID_STATE   0x103
+#endif
+
+typedef void (*esp_timer_cb_t)(void *arg);
+
+typedef enum {
+  ESP_TIMER_TASK = 0,
+  ESP_TIMER_ISR
+} esp_timer_dispatch_t;
+
+typedef struct {
+  esp_timer_cb_t callback;
+  void *arg;
+  esp_timer_dispatch_t dispatch_method;
+  const char *name;
+  bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+typedef struct host_esp_timer *esp_timer_handle_t;
+
+int64_t esp_timer_get_time(void);
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out);
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us);
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+
+#endif // HOST_ESP_TIMER_H
@@ -0,0 +1,55 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Host shim: FreeRTOS types and critical sections on pthreads
+ *
+ * One tick = 1 ms. portMUX_TYPE is a recursive mutex, so nested
+ * portENTER_CRITICAL on the same lock behaves like the ESP32 spinlock.
+ * Unlike the ESP32 a "critical section" does not stop preemption; tests
+ * that need that must not rely on it.
+ */
+
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE                  1
+#define pdFALSE                 0
+#define pdPASS                  1
+#define pdFAIL                  0
+#define portMAX_DELAY           0xFFFFFFFFu
+#define portTICK_PERIOD_MS      1
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(ms))
+#define configTICK_RATE_HZ      1000
+#define configGENERATE_RUN_TIME_STATS 0
+
+typedef struct {
+  pthread_mutex_t m;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED { PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP }
+
+static inline void vPortCPUInitializeMutex(portMUX_TYPE *mux) {
+  pthread_mutexattr_t a;
+  pthread_mutexattr_init(&a);
+  pthread_mutexattr_settype(&a, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init(&mux->m, &a);
+  pthread_mutexattr_destroy(&a);
+}
+
+#define portENTER_CRITICAL(mux)     pthread_mutex_lock(&(mux)->m)
+#define portEXIT_CRITICAL(mux)      pthread_mutex_unlock(&(mux)->m)
+#define portENTER_CRITICAL_ISR(mux) pthread_mutex_lock(&(mux)->m)
+#define portEXIT_CRITICAL_ISR(mux)  pthread_mutex_unlock(&(mux)->m)
+#define taskENTER_CRITICAL(mux)     portENTER_CRITICAL(mux)
+#define taskEXIT_CRITICAL(mux)      portEXIT_CRITICAL(mux)
+
+static inline BaseType_t xPortGetCoreID(void) { return 0; }
+
+#endif // HOST_FREERTOS_H
@@ -0,0 +1,13 @@
+/**
+ * @file queue.h
+ * @brief Host shim: FreeRTOS queue types (only the handle is used)
+ */
+
+#ifndef HOST_FREERTOS_QUEUE_H
+#define HOST_FREERTOS_QUEUE_H
+
+#include "FreeRTOS.h"
+
+typedef struct host_queue *QueueHandle_t;
+
+#endif // HOST_FREERTOS_QUEUE_H
@@ -0,0 +1,34 @@
+/**
+ * @file task.h
+ * @brief Host shim: FreeRTOS tasks and task notifications as pthreads
+ *
+ * vTaskSuspend() is cooperative: the task stops at its next blocking call
+ * (vTaskDelay, semaphore take, notify take) until vTaskResume().
+ */
+
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+typedef struct host_task *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                   UBaseType_t prio, TaskHandle_t *handle, BaseType_t core);
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                       UBaseType_t prio, TaskHandle_t *handle);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+void vTaskSuspend(TaskHandle_t task);
+void vTaskResume(TaskHandle_t task);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+TickType_t xTaskGetTickCount(void);
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+
+static inline uint32_t ulTaskGetIdleRunTimeCounter(void) { return 0; }
+#define portGET_RUN_TIME_COUNTER_VALUE() 0
+
+#endif // HOST_FREERTOS_TASK_H
@@ -0,0 +1,357 @@
+/**
+ * @file host_rtos.cpp
+ * @brief Host shim implementation: time, tasks, notifications, semaphores, timers
+ *
+ * Tasks are detached pthreads. Priorities and core pinning are ignored.
+ */
+
+#include "Arduino.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
+
+HardwareSerial Serial(0);
+
+/* ============================================================================
+ * TIME
+ * ============================================================================ */
+
+static int64_t host_now_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static const int64_t host_boot_us = host_now_us();
+
+// Manual clock (host_time.h): -1 = follow CLOCK_MONOTONIC
+static volatile int64_t host_manual_us = -1;
+
+int64_t esp_timer_get_time(void) {
+  int64_t manual = host_manual_us;
+  if (manual >= 0) return manual;
+  return host_now_us() - host_boot_us;
+}
+
+void host_time_set_manual(bool manual) {
+  host_manual_us = manual ? host_now_us() - host_boot_us : -1;
+}
+
+void host_time_advance_us(int64_t us) {
+  if (host_manual_us >= 0) host_manual_us = host_manual_us + us;
+}
+
+uint32_t millis(void) {
+  return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+uint32_t micros(void) {
+  return (uint32_t)esp_timer_get_time();
+}
+
+static void host_sleep_us(int64_t us) {
+  if (us <= 0) {
+    sched_yield();
+    return;
+  }
+  struct timespec ts;
+  ts.tv_sec = us / 1000000;
+  ts.tv_nsec = (us % 1000000) * 1000;
+  while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {}
+}
+
+void delay(uint32_t ms) {
+  host_sleep_us((int64_t)ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us) {
+  host_sleep_us(us);
+}
+
+// Absolute CLOCK_REALTIME deadline for pthread_cond_timedwait
+static struct timespec host_deadline(TickType_t ticks) {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  ts.tv_sec += ticks / 1000;
+  ts.tv_nsec += (long)(ticks % 1000) * 1000000L;
+  if (ts.tv_nsec >= 1000000000L) {
+    ts.tv_sec++;
+    ts.tv_nsec -= 1000000000L;
+  }
+  return ts;
+}
+
+/* ============================================================================
+ * TASKS
+ * ============================================================================ */
+
+struct host_task {
+  pthread_t thread;
+  TaskFunction_t fn;
+  void *arg;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  uint32_t notify;
+  bool suspended;
+};
+
+static thread_local host_task *host_current = NULL;
+
+// Cooperative suspend point (see task.h)
+static void host_task_check_suspend(void) {
+  host_task *t = host_current;
+  if (!t) return;
+  pthread_mutex_lock(&t->lock);
+  while (t->suspended) pthread_cond_wait(&t->cond, &t->lock);
+  pthread_mutex_unlock(&t->lock);
+}
+
+static void *host_task_entry(void *p) {
+  host_task *t = (host_task *)p;
+  host_current = t;
+  host_task_check_suspend();
+  t->fn(t->arg);
+  return NULL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                   UBaseType_t prio, TaskHandle_t *handle, BaseType_t core) {
+  (void)name; (void)stack; (void)prio; (void)core;
+  host_task *t = new host_task();
+  t->fn = fn;
+  t->arg = arg;
+  pthread_mutex_init(&t->lock, NULL);
+  pthread_cond_init(&t->cond, NULL);
+  if (handle) *handle = t;
+  if (pthread_create(&t->thread, NULL, host_task_entry, t) != 0) {
+    if (handle) *handle = NULL;
+    delete t;
+    return pdFAIL;
+  }
+  pthread_detach(t->thread);
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                       UBaseType_t prio, TaskHandle_t *handle) {
+  return xTaskCreatePinnedToCore(fn, name, stack, arg, prio, handle, 0);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+  // Handles are never freed: callers keep them after the task is gone
+  if (task == NULL || task == host_current) pthread_exit(NULL);
+}
+
+void vTaskDelay(TickType_t ticks) {
+  host_task_check_suspend();
+  host_sleep_us((int64_t)ticks * 1000);
+  host_task_check_suspend();
+}
+
+void vTaskSuspend(TaskHandle_t task) {
+  if (task == NULL) task = host_current;
+  if (task == NULL) return;
+  pthread_mutex_lock(&task->lock);
+  task->suspended = true;
+  pthread_mutex_unlock(&task->lock);
+  if (task == host_current) host_task_check_suspend();
+}
+
+void vTaskResume(TaskHandle_t task) {
+  if (task == NULL) return;
+  pthread_mutex_lock(&task->lock);
+  task->suspended = false;
+  pthread_cond_broadcast(&task->cond);
+  pthread_mutex_unlock(&task->lock);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+  return host_current;
+}
+
+TickType_t xTaskGetTickCount(void) {
+  return millis();
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks) {
+  host_task *t = host_current;
+  if (!t) {
+    delay(ticks == portMAX_DELAY ? 1 : ticks);
+    return 0;
+  }
+  host_task_check_suspend();
+  struct timespec dl = host_deadline(ticks);
+  pthread_mutex_lock(&t->lock);
+  while (t->notify == 0 && ticks > 0) {
+    int rc = (ticks == portMAX_DELAY) ? pthread_cond_wait(&t->cond, &t->lock)
+                                      : pthread_cond_timedwait(&t->cond, &t->lock, &dl);
+    if (rc == ETIMEDOUT) break;
+  }
+  uint32_t v = t->notify;
+  if (v > 0) t->notify = clear_on_exit ? 0 : v - 1;
+  pthread_mutex_unlock(&t->lock);
+  return v;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  if (!task) return pdFAIL;
+  pthread_mutex_lock(&task->lock);
+  task->notify++;
+  pthread_cond_broadcast(&task->cond);
+  pthread_mutex_unlock(&task->lock);
+  return pdPASS;
+}
+
+/* ============================================================================
+ * SEMAPHORES
+ * ============================================================================ */
+
+struct host_sem {
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  UBaseType_t count;
+  UBaseType_t max;
+};
+
+static SemaphoreHandle_t host_sem_create(UBaseType_t max, UBaseType_t initial) {
+  host_sem *s = new host_sem();
+  pthread_mutex_init(&s->lock, NULL);
+  pthread_cond_init(&s->cond, NULL);
+  s->count = initial;
+  s->max = max;
+  return s;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+  return host_sem_create(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial) {
+  return host_sem_create(max, initial);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+  return host_sem_create(1, 1);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks) {
+  if (!sem) return pdFALSE;
+  host_task_check_suspend();
+  struct timespec dl = host_deadline(ticks);
+  pthread_mutex_lock(&sem->lock);
+  while (sem->count == 0 && ticks > 0) {
+    int rc = (ticks == portMAX_DELAY) ? pthread_cond_wait(&sem->cond, &sem->lock)
+                                      : pthread_cond_timedwait(&sem->cond, &sem->lock, &dl);
+    if (rc == ETIMEDOUT) break;
+  }
+  BaseType_t ok = pdFALSE;
+  if (sem->count > 0) {
+    sem->count--;
+    ok = pdTRUE;
+  }
+  pthread_mutex_unlock(&sem->lock);
+  return ok;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+  if (!sem) return pdFALSE;
+  pthread_mutex_lock(&sem->lock);
+  BaseType_t ok = pdFALSE;
+  if (sem->count < sem->max) {
+    sem->count++;
+    ok = pdTRUE;
+    pthread_cond_signal(&sem->cond);
+  }
+  pthread_mutex_unlock(&sem->lock);
+  return ok;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t *woken) {
+  if (woken) *woken = pdFALSE;
+  return xSemaphoreGive(sem);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem) {
+  // Kept alive: a task may still be inside take/give when the owner deletes it
+  (void)sem;
+}
+
+/* ============================================================================
+ * ESP_TIMER (one-shot)
+ * ============================================================================ */
+
+struct host_esp_timer {
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  esp_timer_cb_t callback;
+  void *arg;
+  bool armed;
+  struct timespec due;   // CLOCK_REALTIME, for pthread_cond_timedwait
+};
+
+static void *host_esp_timer_entry(void *p) {
+  host_esp_timer *t = (host_esp_timer *)p;
+  pthread_mutex_lock(&t->lock);
+  for (;;) {
+    while (!t->armed) pthread_cond_wait(&t->cond, &t->lock);
+    int rc = pthread_cond_timedwait(&t->cond, &t->lock, &t->due);
+    if (rc == ETIMEDOUT && t->armed) {
+      t->armed = false;
+      pthread_mutex_unlock(&t->lock);
+      t->callback(t->arg);
+      pthread_mutex_lock(&t->lock);
+    }
+  }
+  return NULL;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out) {
+  if (!args || !args->callback || !out) return ESP_FAIL;
+  host_esp_timer *t = new host_esp_timer();
+  pthread_mutex_init(&t->lock, NULL);
+  pthread_cond_init(&t->cond, NULL);
+  t->callback = args->callback;
+  t->arg = args->arg;
+  if (pthread_create(&t->thread, NULL, host_esp_timer_entry, t) != 0) {
+    delete t;
+    return ESP_FAIL;
+  }
+  pthread_detach(t->thread);
+  *out = t;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t t, uint64_t timeout_us) {
+  if (!t) return ESP_FAIL;
+  pthread_mutex_lock(&t->lock);
+  if (t->armed) {
+    pthread_mutex_unlock(&t->lock);
+    return ESP_ERR_INVALID_STATE;
+  }
+  clock_gettime(CLOCK_REALTIME, &t->due);
+  t->due.tv_sec += (time_t)(timeout_us / 1000000);
+  t->due.tv_nsec += (long)(timeout_us % 1000000) * 1000L;
+  if (t->due.tv_nsec >= 1000000000L) {
+    t->due.tv_sec++;
+    t->due.tv_nsec -= 1000000000L;
+  }
+  t->armed = true;
+  pthread_cond_broadcast(&t->cond);
+  pthread_mutex_unlock(&t->lock);
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t t) {
+  if (!t) return ESP_FAIL;
+  pthread_mutex_lock(&t->lock);
+  bool was_armed = t->armed;
+  t->armed = false;
+  pthread_cond_broadcast(&t->cond);
+  pthread_mutex_unlock(&t->lock);
+  return was_armed ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
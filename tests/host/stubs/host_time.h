@@ -0,0 +1,18 @@
+/**
+ * @file host_time.h
+ * @brief Host shim extension: manual clock for deterministic timer tests
+ *
+ * In manual mode millis()/micros()/esp_timer_get_time() only move when the
+ * test calls host_time_advance_us() (xTaskGetTickCount too). vTaskDelay and
+ * semaphore/notify timeouts keep using the real clock.
+ */
+
+#ifndef HOST_TIME_H
+#define HOST_TIME_H
+
+#include <stdint.h>
+
+void host_time_set_manual(bool manual);
+void host_time_advance_us(int64_t us);
+
+#endif // HOST_TIME_H
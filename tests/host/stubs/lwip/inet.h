@@ -0,0 +1,11 @@
+/**
+ * @file inet.h
+ * @brief Host shim: lwIP address helpers are the POSIX ones
+ */
+
+#ifndef HOST_LWIP_INET_H
+#define HOST_LWIP_INET_H
+
+#include <arpa/inet.h>
+
+#endif // HOST_LWIP_INET_H
@@ -0,0 +1,17 @@
+/**
+ * @file sockets.h
+ * @brief Host shim: lwIP BSD sockets are the POSIX ones
+ */
+
+#ifndef HOST_LWIP_SOCKETS_H
+#define HOST_LWIP_SOCKETS_H
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#endif // HOST_LWIP_SOCKETS_H
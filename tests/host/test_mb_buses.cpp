@@ -0,0 +1,319 @@
+/**
+ * @file test_mb_buses.cpp
+ * @brief Two Modbus master buses running concurrently over pseudo terminals (FEAT-159)
+ *
+ * Builds modbus_master.cpp + mb_async.cpp with bus 0 and bus 1 on their own
+ * pty (mb_pty_bus.h): each has a slave farm on the other end, slaves 1-8 on
+ * bus 0 and slaves 100-120 routed to bus 1. Requests go through the real
+ * async path (mb_async_queue_read/write → bus worker → transaction):
+ *
+ *   1. Routing: reads and a write reach the farm of their own bus only,
+ *      cached values equal the farm registers, each port counts its own
+ *      transactions
+ *   2. Concurrency: a batch of reads on both buses at once takes about as
+ *      long as the slower bus alone, not the sum
+ *   3. Dead slave: while bus 1 sits in response timeouts for slaves that
+ *      never answer, a batch on bus 0 runs at its normal speed; bus 1 reports
+ *      the timeouts and serves its live slaves afterwards
+ *   4. Restart: mb_async_bus_apply() on bus 1 while its worker sits in a long
+ *      inter-frame gap returns only after that worker has exited; the new
+ *      worker is the only consumer and serves the queue
+ *
+ * Usage: test_mb_buses [reads per batch, default 16]
+ */
+
+#include "mb_async.h"
+#include "modbus_master.h"
+#include "config_struct.h"
+#include "mb_pty_bus.h"
+#include "host_test.h"
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#define BUS0_FIRST   1
+#define BUS0_LAST    8
+#define BUS1_FIRST   100
+#define BUS1_LAST    120
+#define BUS1_DEAD    110     // Slaves 110-117 never answer (test 3)
+#define TIMEOUT_MS   100
+
+static mb_pty_bus_t *pty[MB_BUS_MAX];
+
+static void setup() {
+  g_persist_config.modbus_master.enabled = 1;
+  g_persist_config.modbus_master.baudrate = 115200;
+  g_persist_config.modbus_master.parity = 0;
+  g_persist_config.modbus_master.stop_bits = 1;
+  g_persist_config.modbus_master.timeout_ms = TIMEOUT_MS;
+  g_persist_config.modbus_master.cache_max_entries = 256;
+  g_persist_config.modbus_master.queue_max_size = MB_ASYNC_QUEUE_SIZE;
+  g_persist_config.modbus_master.coalesce_enabled = 0;  // One transaction per read
+  g_persist_config.modbus_master.write_combine = 1;
+
+  ModbusBusConfig *bus1 = &g_persist_config.mb_buses[0];
+  bus1->enabled = 1;
+  bus1->parity = 0;
+  bus1->stop_bits = 1;
+  bus1->baudrate = 115200;
+  bus1->timeout_ms = TIMEOUT_MS;
+  bus1->inter_frame_delay = 0;
+  memset(g_persist_config.mb_bus_routes, 0, sizeof(g_persist_config.mb_bus_routes));
+  g_persist_config.mb_bus_routes[0].first_slave = BUS1_FIRST;
+  g_persist_config.mb_bus_routes[0].last_slave = BUS1_LAST;
+  g_persist_config.mb_bus_routes[0].bus = 1;
+
+  // 115200 baud on the wire + 2 ms slave processing per transaction
+  mb_pty_farm_config_t f0 = {BUS0_FIRST, BUS0_LAST, 0, 0, 115200, 2000};
+  mb_pty_farm_config_t f1 = {BUS1_FIRST, BUS1_LAST, BUS1_DEAD, BUS1_DEAD + 7, 115200, 2000};
+  pty[0] = mb_pty_bus_open(&f0);
+  pty[1] = mb_pty_bus_open(&f1);
+
+  modbus_master_init();
+  modbus_master_set_transport(0, mb_pty_transport(), pty[0]);
+  modbus_master_set_transport(1, mb_pty_transport(), pty[1]);
+  mb_async_init();
+}
+
+static uint8_t entry_status(uint8_t slave, uint16_t addr, uint8_t type, int32_t *value, int32_t *err) {
+  mb_cache_entry_t e;
+  if (!mb_cache_find(slave, addr, type, &e)) return MB_CACHE_EMPTY;
+  if (value) *value = e.value.int_val;
+  if (err) *err = e.last_error;
+  return e.status;
+}
+
+/* ============================================================================
+ * BATCH: one FC03 per (slave, address), wait until every entry settled
+ * ============================================================================ */
+
+typedef struct {
+  uint8_t bus;
+  uint8_t first_slave;
+  uint8_t slaves;
+  uint16_t base;            // Addresses base, base + 10, ... (no coalescing across reads)
+  uint16_t reads;
+  double ms;                // Result: queue → last entry settled
+  uint16_t valid;           // Entries VALID with the farm's value
+} batch_t;
+
+static void *batch_main(void *arg) {
+  batch_t *bt = (batch_t *)arg;
+  uint64_t t0 = host_test_now_ns();
+  for (uint16_t i = 0; i < bt->reads; i++) {
+    uint8_t slave = (uint8_t)(bt->first_slave + i % bt->slaves);
+    while (!mb_async_queue_read(MB_REQ_READ_HOLDING, slave, (uint16_t)(bt->base + i * 10))) usleep(100);
+  }
+  uint16_t settled = 0;
+  while (settled < bt->reads && host_test_now_ns() - t0 < 5000000000ull) {
+    settled = 0;
+    for (uint16_t i = 0; i < bt->reads; i++) {
+      uint8_t slave = (uint8_t)(bt->first_slave + i % bt->slaves);
+      uint8_t st = entry_status(slave, (uint16_t)(bt->base + i * 10), MB_REQ_READ_HOLDING, NULL, NULL);
+      settled += (st == MB_CACHE_VALID || st == MB_CACHE_ERROR);
+    }
+    if (settled < bt->reads) usleep(200);
+  }
+  bt->ms = (host_test_now_ns() - t0) / 1e6;
+
+  bt->valid = 0;
+  for (uint16_t i = 0; i < bt->reads; i++) {
+    uint8_t slave = (uint8_t)(bt->first_slave + i % bt->slaves);
+    uint16_t addr = (uint16_t)(bt->base + i * 10);
+    int32_t v = 0;
+    if (entry_status(slave, addr, MB_REQ_READ_HOLDING, &v, NULL) == MB_CACHE_VALID &&
+        (uint16_t)v == mb_pty_farm_get(pty[bt->bus], slave, addr)) {
+      bt->valid++;
+    }
+  }
+  return NULL;
+}
+
+static batch_t batch(uint8_t bus, uint16_t base, uint16_t reads) {
+  batch_t bt;
+  memset(&bt, 0, sizeof(bt));
+  bt.bus = bus;
+  bt.first_slave = bus == 0 ? BUS0_FIRST : BUS1_FIRST;
+  bt.slaves = 4;
+  bt.base = base;
+  bt.reads = reads;
+  return bt;
+}
+
+/* ============================================================================
+ * TEST 1: ROUTING
+ * ============================================================================ */
+
+static void test_routing(uint16_t reads) {
+  host_test_section("Test 1: Routing til egen bus");
+  CHECK_EQ(mb_async_bus_of(BUS0_FIRST), 0);
+  CHECK_EQ(mb_async_bus_of(BUS1_FIRST), 1);
+  CHECK(modbus_master_bus_active(1));
+  CHECK(strcmp(modbus_master_transport_name(1), "pty") == 0);
+  printf("  Bus 0: %s, bus 1: %s\n", mb_pty_bus_name(pty[0]), mb_pty_bus_name(pty[1]));
+
+  uint32_t tx0 = modbus_master_get_wait_stats(0)->transactions;
+  uint32_t tx1 = modbus_master_get_wait_stats(1)->transactions;
+  batch_t b0 = batch(0, 0, reads);
+  batch_t b1 = batch(1, 0, reads);
+  batch_main(&b0);
+  batch_main(&b1);
+  CHECK_EQ(b0.valid, reads);
+  CHECK_EQ(b1.valid, reads);
+  PASS_IF("Reads på begge busser giver farmens værdier", b0.valid == reads && b1.valid == reads);
+
+  // FC06 to a bus 1 slave lands in the bus 1 farm
+  st_value_t v;
+  v.int_val = 0x5A5A;
+  CHECK(mb_async_queue_write(MB_REQ_WRITE_HOLDING, BUS1_FIRST + 1, 5, v));
+  // The farm stores the value before it answers: wait for the transaction to finish too
+  for (int i = 0; i < 500 && modbus_master_get_wait_stats(1)->transactions - tx1 < (uint32_t)reads + 1; i++) usleep(1000);
+  CHECK_EQ(mb_pty_farm_get(pty[1], BUS1_FIRST + 1, 5), 0x5A5A);
+
+  mb_pty_farm_stats_t s0 = mb_pty_farm_stats(pty[0]);
+  mb_pty_farm_stats_t s1 = mb_pty_farm_stats(pty[1]);
+  CHECK_EQ(s0.foreign, 0);
+  CHECK_EQ(s1.foreign, 0);
+  CHECK_EQ(s0.crc_errors + s1.crc_errors, 0);
+  CHECK_EQ(modbus_master_get_wait_stats(0)->transactions - tx0, reads);
+  CHECK_EQ(modbus_master_get_wait_stats(1)->transactions - tx1, reads + 1);
+  PASS_IF("Ingen requests på forkert bus, hver port tæller sine transaktioner",
+          s0.foreign == 0 && s1.foreign == 0 && mb_pty_farm_get(pty[1], BUS1_FIRST + 1, 5) == 0x5A5A);
+}
+
+/* ============================================================================
+ * TEST 2: CONCURRENCY
+ * ============================================================================ */
+
+static void test_concurrency(uint16_t reads) {
+  host_test_section("Test 2: Begge busser samtidig");
+  batch_t b0 = batch(0, 1, reads);
+  batch_t b1 = batch(1, 1, reads);
+  batch_main(&b0);
+  batch_main(&b1);
+  double alone = b0.ms > b1.ms ? b0.ms : b1.ms;
+
+  batch_t c0 = batch(0, 2, reads);
+  batch_t c1 = batch(1, 2, reads);
+  pthread_t t0, t1;
+  pthread_create(&t0, NULL, batch_main, &c0);
+  pthread_create(&t1, NULL, batch_main, &c1);
+  pthread_join(t0, NULL);
+  pthread_join(t1, NULL);
+  double both = c0.ms > c1.ms ? c0.ms : c1.ms;
+
+  printf("  %u reads: bus 0 alene %.1f ms, bus 1 alene %.1f ms, samtidig %.1f ms (sum %.1f ms)\n",
+         reads, b0.ms, b1.ms, both, b0.ms + b1.ms);
+  CHECK_EQ(c0.valid, reads);
+  CHECK_EQ(c1.valid, reads);
+  PASS_IF("Samtidige batches tager højst 1.5x den langsomste bus alene",
+          c0.valid == reads && c1.valid == reads && both <= 1.5 * alone);
+}
+
+/* ============================================================================
+ * TEST 3: DEAD SLAVE ON BUS 1
+ * ============================================================================ */
+
+static void test_dead_slave(uint16_t reads) {
+  host_test_section("Test 3: Død slave på bus 1");
+  batch_t ref = batch(0, 3, reads);
+  batch_main(&ref);
+
+  // Eight slaves that never answer: bus 1 spends 8 x TIMEOUT_MS in timeouts
+  uint32_t timeouts0 = g_mb_async[0].total_timeouts;
+  uint32_t timeouts1 = g_mb_async[1].total_timeouts;
+  for (uint8_t s = 0; s < 8; s++) CHECK(mb_async_queue_read(MB_REQ_READ_HOLDING, BUS1_DEAD + s, 0));
+  usleep(10000);  // Bus 1 is inside the first timeout
+
+  batch_t b0 = batch(0, 4, reads);
+  batch_main(&b0);
+  printf("  Bus 0: %.1f ms uden / %.1f ms med bus 1 i timeout\n", ref.ms, b0.ms);
+  CHECK_EQ(b0.valid, reads);
+  PASS_IF("Bus 0 holder hastigheden mens bus 1 venter på en død slave",
+          b0.valid == reads && b0.ms <= 1.5 * ref.ms + 10);
+
+  // Bus 1 reports the timeouts, bus 0 none, and bus 1 still serves live slaves
+  bool dead_done = false;
+  for (int i = 0; i < 300 && !dead_done; i++) {
+    dead_done = true;
+    for (uint8_t s = 0; s < 8; s++) {
+      dead_done &= entry_status(BUS1_DEAD + s, 0, MB_REQ_READ_HOLDING, NULL, NULL) == MB_CACHE_ERROR;
+    }
+    if (!dead_done) usleep(10000);
+  }
+  int32_t err = 0;
+  entry_status(BUS1_DEAD, 0, MB_REQ_READ_HOLDING, NULL, &err);
+  CHECK(dead_done);
+  CHECK_EQ(err, MB_TIMEOUT);
+  CHECK_EQ(g_mb_async[1].total_timeouts - timeouts1, 8);
+  CHECK_EQ(g_mb_async[0].total_timeouts - timeouts0, 0);
+  CHECK_EQ(mb_pty_farm_stats(pty[1]).dropped, 8);
+
+  batch_t b1 = batch(1, 5, reads);
+  batch_main(&b1);
+  CHECK_EQ(b1.valid, reads);
+  PASS_IF("Timeouts tælles kun på bus 1, levende slaves svarer bagefter",
+          dead_done && g_mb_async[0].total_timeouts == timeouts0 && b1.valid == reads);
+}
+
+/* ============================================================================
+ * TEST 4: RESTART WHILE THE WORKER IS IN A TRANSACTION
+ * ============================================================================ */
+
+#define RESTART_GAP_MS  600   // Inter-frame delay: the worker sleeps after the port lock is released
+
+static void test_restart(uint16_t reads) {
+  host_test_section("Test 4: Genstart af bus 1 midt i en transaktion");
+  // A long inter-frame gap keeps the worker busy with the port lock already
+  // released, so only the worker itself can tell when it is done
+  g_persist_config.mb_buses[0].inter_frame_delay = RESTART_GAP_MS;
+  uint32_t before = g_mb_async[1].total_requests;
+  CHECK(mb_async_queue_read(MB_REQ_READ_HOLDING, BUS1_FIRST, 20));
+  while (g_mb_async[1].total_requests == before) usleep(1000);
+  usleep(50000);  // Transaction done, worker inside the gap
+
+  uint64_t t0 = host_test_now_ns();
+  bool applied = mb_async_bus_apply(1);
+  double stop_ms = (host_test_now_ns() - t0) / 1e6;
+  printf("  mb_async_bus_apply(1): %.0f ms (inter-frame %u ms)\n", stop_ms, RESTART_GAP_MS);
+  CHECK(applied);
+  PASS_IF("Genstart venter til den gamle worker har forladt sin løkke",
+          applied && stop_ms >= RESTART_GAP_MS - 150);
+
+  g_persist_config.mb_buses[0].inter_frame_delay = 0;
+  batch_t b1 = batch(1, 6, reads);
+  batch_main(&b1);
+  CHECK_EQ(b1.valid, reads);
+  CHECK_EQ(g_mb_async[1].total_requests, reads);
+  PASS_IF("Ny worker alene om køen: alle reads besvaret, ingen tabt eller dobbelt",
+          b1.valid == reads && g_mb_async[1].total_requests == reads);
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================ */
+
+int main(int argc, char **argv) {
+  uint16_t reads = (argc > 1) ? (uint16_t)atoi(argv[1]) : 16;
+  if (reads < 1 || reads > MB_ASYNC_QUEUE_SIZE) reads = 16;
+
+  printf("============================================================\n");
+  printf("  Modbus master: to busser over pty (host)\n");
+  printf("============================================================\n");
+
+  setup();
+  if (!pty[0] || !pty[1]) {
+    printf("  [FAIL] openpty\n");
+    return 1;
+  }
+
+  test_routing(reads);
+  test_concurrency(reads);
+  test_dead_slave(reads);
+  test_restart(reads);
+
+  mb_async_deinit();
+  mb_pty_bus_close(pty[0]);
+  mb_pty_bus_close(pty[1]);
+  return host_test_summary();
+}
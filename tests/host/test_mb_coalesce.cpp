@@ -0,0 +1,241 @@
+/**
+ * @file test_mb_coalesce.cpp
+ * @brief Read coalescing: block selection and queue take-out on host (FEAT-156)
+ *
+ * Builds mb_async.cpp into this test so the worker-side statics
+ * (mb_pq_insert/dequeue, mb_coalesce_take) are reachable:
+ *
+ *   1. mb_coalesce_select: hand-picked cases — contiguous runs, gap
+ *      bridging, the 125-register / 2000-bit span limit, duplicates, a seed
+ *      outside the candidates and growth toward the closer neighbour
+ *   2. mb_coalesce_select against its contract on random candidate sets:
+ *      the block holds the seed, starts and ends on candidates, respects
+ *      max_span and max_gap, and cannot grow by one more neighbour
+ *   3. mb_coalesce_take on the real priority rings: members of the block
+ *      leave the queue, other slaves/FCs and out-of-block addresses stay in
+ *      FIFO order, pq_count returns to 0
+ *
+ * Usage: test_mb_coalesce [random sets, default 200000]
+ */
+
+#include "../../src/mb_async.cpp"
+
+#include "host_test.h"
+
+typedef struct {
+  const char *name;
+  uint16_t addrs[12];
+  uint8_t n;
+  uint16_t seed;
+  uint16_t max_span;
+  uint16_t max_gap;
+  uint16_t start;
+  uint16_t count;
+} select_case_t;
+
+static const select_case_t select_cases[] = {
+  {"8 sammenhængende, seed i midten",   {100, 101, 102, 103, 104, 105, 106, 107}, 8, 103, 125, 0, 100, 8},
+  {"Hul på 1 lukkes med gap 1",         {100, 102, 105}, 3, 100, 125, 1, 100, 3},
+  {"Hul på 2 lukkes med gap 2",         {100, 102, 105}, 3, 100, 125, 2, 100, 6},
+  {"Gap 0: kun sammenhængende",         {10, 11, 13, 14}, 4, 14, 125, 0, 13, 2},
+  {"Dubletter af seed og naboer",       {50, 50, 51, 51, 51, 52}, 6, 51, 125, 0, 50, 3},
+  {"Seed ikke blandt kandidater",       {1, 2, 3}, 3, 9, 125, 4, 9, 1},
+  {"Enkelt kandidat",                   {4000}, 1, 4000, 125, 8, 4000, 1},
+  {"Vokser mod nærmeste nabo først",    {90, 100, 103}, 3, 100, 11, 10, 100, 4},
+  {"Span-grænse stopper ved 125",       {0, 60, 120, 124, 125, 130}, 6, 60, 125, 60, 0, 125},
+  {"Bits: 2000 span, gap 16 pr. reg",   {0, 16, 1999, 2000}, 4, 16, 2000, 16 * 16, 0, 17},
+  {"Bits: span 2000 inkl. sidste bit",  {0, 1000, 1999}, 3, 0, 2000, 1000, 0, 2000},
+  {"Øverste adresse 65535",             {65533, 65534, 65535}, 3, 65535, 125, 0, 65533, 3},
+};
+
+#define SELECT_CASE_COUNT (sizeof(select_cases) / sizeof(select_cases[0]))
+
+static uint32_t xorshift(uint32_t *s) {
+  *s ^= *s << 13;
+  *s ^= *s >> 17;
+  *s ^= *s << 5;
+  return *s;
+}
+
+/* ============================================================================
+ * TEST 1: HAND-PICKED CASES
+ * ============================================================================ */
+
+static void test_select_cases() {
+  host_test_section("Test 1: mb_coalesce_select kendte tilfælde");
+  for (size_t i = 0; i < SELECT_CASE_COUNT; i++) {
+    const select_case_t *c = &select_cases[i];
+    uint16_t start = 0xBEEF;
+    uint16_t count = mb_coalesce_select(c->addrs, c->n, c->seed, c->max_span, c->max_gap, &start);
+    bool ok = start == c->start && count == c->count;
+    if (!ok) printf("  %s: start=%u count=%u (forventet %u/%u)\n", c->name, start, count, c->start, c->count);
+    PASS_IF(c->name, ok);
+  }
+}
+
+/* ============================================================================
+ * TEST 2: CONTRACT ON RANDOM SETS
+ * ============================================================================ */
+
+// Checks one result against the documented contract; returns the violated rule or NULL
+static const char *select_violation(const uint16_t *a, uint8_t n, uint16_t seed, uint16_t span, uint16_t gap,
+                                    uint16_t start, uint16_t count) {
+  uint32_t end = (uint32_t)start + count - 1;
+  if (count == 0 || start > seed || end < seed) return "seed uden for blokken";
+  if (count > span && count != 1) return "blok bredere end max_span";
+
+  bool has_start = false, has_end = false;
+  int32_t prev_in = -1, below = -1, above = -1;
+  for (uint8_t i = 0; i < n; i++) {
+    if (a[i] == start) has_start = true;
+    if (a[i] == end) has_end = true;
+    if (a[i] < start) below = a[i];
+    if (a[i] > end && above < 0) above = a[i];
+    if (a[i] >= start && a[i] <= end) {
+      if (prev_in >= 0 && a[i] != prev_in && (uint32_t)(a[i] - prev_in - 1) > gap) return "hul større end max_gap";
+      prev_in = a[i];
+    }
+  }
+  if (!has_start || !has_end) return "blokkant er ikke en kandidat";
+  if (below >= 0 && (uint32_t)(start - below - 1) <= gap && end - below + 1 <= span) return "kunne vokse nedad";
+  if (above >= 0 && (uint32_t)(above - end - 1) <= gap && above - start + 1 <= span) return "kunne vokse opad";
+  return NULL;
+}
+
+static void test_select_random(uint32_t sets) {
+  host_test_section("Test 2: mb_coalesce_select kontrakt på tilfældige sæt");
+  uint32_t rng = 0x2545F491u;
+  uint32_t bad = 0, merged = 0;
+  for (uint32_t s = 0; s < sets; s++) {
+    bool bits = (s & 3) == 0;
+    uint16_t span = bits ? MODBUS_MASTER_MAX_READ_BITS : MODBUS_MASTER_MAX_READ_REGS;
+    uint16_t gap = (uint16_t)(xorshift(&rng) % (MB_COALESCE_MAX_GAP + 1));
+    if (bits) gap *= 16;
+    uint16_t base = (uint16_t)(xorshift(&rng) % 65536);
+    uint16_t spread = bits ? 6000 : 400;
+
+    uint16_t a[MB_COALESCE_MAX_MEMBERS];
+    uint8_t n = (uint8_t)(1 + xorshift(&rng) % MB_COALESCE_MAX_MEMBERS);
+    for (uint8_t i = 0; i < n; i++) {
+      uint32_t v = base + xorshift(&rng) % spread;
+      a[i] = (uint16_t)(v > 65535 ? 65535 : v);
+    }
+    uint16_t seed = a[xorshift(&rng) % n];
+    mb_coalesce_sort(a, n);
+
+    uint16_t start;
+    uint16_t count = mb_coalesce_select(a, n, seed, span, gap, &start);
+    const char *why = select_violation(a, n, seed, span, gap, start, count);
+    if (why && bad++ < 5) printf("  sæt %u: %s (seed=%u start=%u count=%u)\n", s, why, seed, start, count);
+    if (count > 1) merged++;
+  }
+  printf("  %u sæt, %u gav en blok > 1\n", sets, merged);
+  CHECK(merged > sets / 4);
+  PASS_IF("Alle blokke overholder seed/span/gap/maksimal-kontrakten", bad == 0);
+}
+
+/* ============================================================================
+ * TEST 3: TAKE-OUT FROM THE PRIORITY RINGS
+ * ============================================================================ */
+
+static mb_async_state_t *bus0_reset() {
+  mb_async_state_t *b = &g_mb_async[0];
+  for (uint8_t c = 0; c < MB_PRIO_COUNT; c++) mb_pq_ring_init(&b->pq_ring[c]);
+  b->pq_count = 0;
+  b->pq_evict = 0;
+  if (!b->pq_semaphore) b->pq_semaphore = xSemaphoreCreateCounting(MB_PRIO_COUNT * MB_ASYNC_QUEUE_SIZE, 0);
+  return b;
+}
+
+static void enqueue(mb_async_state_t *b, uint8_t type, uint8_t slave, uint16_t addr, uint8_t prio) {
+  mb_async_request_t req;
+  memset(&req, 0, sizeof(req));
+  req.type = (mb_request_type_t)type;
+  req.slave_id = slave;
+  req.address = addr;
+  req.priority = prio;
+  CHECK(mb_pq_insert(b, &req));
+}
+
+static void test_take() {
+  host_test_section("Test 3: mb_coalesce_take på prioritets-ringene");
+  g_modbus_master_config.coalesce_enabled = 1;
+  g_modbus_master_config.coalesce_gap = 2;
+  g_modbus_master_config.queue_max_size = MB_ASYNC_QUEUE_SIZE;
+
+  mb_async_state_t *b = bus0_reset();
+  enqueue(b, MB_REQ_READ_HOLDING, 1, 103, MB_PRIO_READ_FRESH);      // Seed
+  enqueue(b, MB_REQ_READ_HOLDING, 1, 100, MB_PRIO_READ_FRESH);
+  enqueue(b, MB_REQ_READ_HOLDING, 2, 101, MB_PRIO_READ_FRESH);      // Other slave
+  enqueue(b, MB_REQ_READ_INPUT_REG, 1, 102, MB_PRIO_READ_FRESH);    // Other FC
+  enqueue(b, MB_REQ_READ_HOLDING, 1, 106, MB_PRIO_READ_REFRESH);    // Gap 2 → bridged
+  enqueue(b, MB_REQ_READ_HOLDING, 1, 110, MB_PRIO_READ_REFRESH);    // Gap 3 → stays
+  enqueue(b, MB_REQ_READ_HOLDING, 1, 100, MB_PRIO_READ_REFRESH);    // Duplicate member
+  CHECK_EQ(b->pq_count, 7);
+
+  mb_async_request_t seed;
+  CHECK(mb_pq_dequeue(b, &seed));
+  CHECK_EQ(seed.address, 103);
+
+  mb_coalesce_block_t blk;
+  bool merged = mb_coalesce_take(b, &seed, &blk);
+  CHECK(merged);
+  CHECK_EQ(blk.start, 100);
+  CHECK_EQ(blk.count, 7);
+  CHECK_EQ(blk.member_count, 4);
+  const uint16_t members[] = {100, 100, 103, 106};
+  bool members_ok = blk.member_count == 4;
+  for (uint8_t i = 0; members_ok && i < 4; i++) members_ok = blk.members[i] == members[i];
+  PASS_IF("Blok 100..106 med 4 medlemmer (dublet med)", merged && blk.start == 100 && blk.count == 7 && members_ok);
+
+  // What is left must come out in priority + FIFO order, taken slots skipped
+  const uint16_t left_addr[] = {101, 102, 110};
+  const uint8_t left_slave[] = {2, 1, 1};
+  bool left_ok = true;
+  mb_async_request_t r;
+  for (uint8_t i = 0; i < 3; i++) {
+    left_ok &= mb_pq_dequeue(b, &r) && r.address == left_addr[i] && r.slave_id == left_slave[i];
+  }
+  left_ok &= !mb_pq_dequeue(b, &r);
+  CHECK_EQ(b->pq_count, 0);
+  CHECK_EQ(b->pq_ring[MB_PRIO_READ_FRESH].count + b->pq_ring[MB_PRIO_READ_REFRESH].count, 0);
+  PASS_IF("Resten dequeues i rækkefølge, pq_count går til 0", left_ok && b->pq_count == 0);
+
+  // Writes are never merged, and a lone read is not a block
+  b = bus0_reset();
+  enqueue(b, MB_REQ_WRITE_HOLDING, 1, 101, MB_PRIO_WRITE);
+  enqueue(b, MB_REQ_READ_HOLDING, 1, 100, MB_PRIO_READ_FRESH);
+  CHECK(mb_pq_dequeue(b, &seed));
+  CHECK(!mb_coalesce_take(b, &seed, &blk));
+  CHECK(mb_pq_dequeue(b, &seed));
+  CHECK(!mb_coalesce_take(b, &seed, &blk));
+  CHECK_EQ(b->pq_count, 0);
+
+  // Disabled: nothing is taken even with a perfect neighbour
+  g_modbus_master_config.coalesce_enabled = 0;
+  b = bus0_reset();
+  enqueue(b, MB_REQ_READ_COIL, 1, 0, MB_PRIO_READ_FRESH);
+  enqueue(b, MB_REQ_READ_COIL, 1, 1, MB_PRIO_READ_FRESH);
+  CHECK(mb_pq_dequeue(b, &seed));
+  bool off_ok = !mb_coalesce_take(b, &seed, &blk) && b->pq_count == 1;
+  g_modbus_master_config.coalesce_enabled = 1;
+  PASS_IF("Skrivninger, enlige reads og coalesce off giver ingen blok", off_ok && host_test_failed == 0);
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================ */
+
+int main(int argc, char **argv) {
+  uint32_t sets = (argc > 1) ? (uint32_t)atol(argv[1]) : 200000;
+
+  printf("============================================================\n");
+  printf("  Modbus master read coalescing (host)\n");
+  printf("============================================================\n");
+
+  test_select_cases();
+  test_select_random(sets);
+  test_take();
+
+  return host_test_summary();
+}
@@ -0,0 +1,290 @@
+/**
+ * @file test_mb_payload_slots.cpp
+ * @brief Ref-counted payload slots under an FC16 write flood on host (FEAT-161)
+ *
+ * Builds modbus_master.cpp + mb_async.cpp with bus 0 on a pty slave farm
+ * (mb_pty_bus.h) and floods the MB_PAYLOAD_SLOTS pool from several threads:
+ *
+ *   1. Single thread: all slots allocated → next alloc fails and counts,
+ *      retain/release keep a slot until the last reference is gone
+ *   2. Write flood: writer threads queue FC16 writes whose values are a
+ *      function of (writer, sequence), so a slot reused while its write is
+ *      still queued shows up as a mixed frame. Block reads of a
+ *      fixed slave keep results in the same pool (stored before the writers
+ *      start; a drained pool cannot publish new ones) and an "ST" thread
+ *      pins results and checks they do not change while pinned. The farm
+ *      checks every FC16 frame on the wire: all writes arrive once, in
+ *      order per writer, none corrupt; the pool ran dry at least once
+ *   3. Afterwards only stored block results hold slots, and clearing the
+ *      cache returns the pool to 0
+ *
+ * Usage: test_mb_payload_slots [writes per writer, default 500] [writers, default 3]
+ */
+
+#include "mb_async.h"
+#include "modbus_master.h"
+#include "config_struct.h"
+#include "mb_pty_bus.h"
+#include "host_test.h"
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#define WRITERS_MAX   8
+#define READ_SLAVE    8       // Block reads only: its registers never change
+#define READ_COUNT    20
+#define READ_BLOCKS   10      // More distinct blocks than MB_BLOCK_RESULTS_MAX
+
+static mb_pty_bus_t *pty;
+
+static void setup() {
+  g_persist_config.modbus_master.enabled = 1;
+  g_persist_config.modbus_master.baudrate = 115200;
+  g_persist_config.modbus_master.parity = 0;
+  g_persist_config.modbus_master.stop_bits = 1;
+  g_persist_config.modbus_master.timeout_ms = 100;
+  g_persist_config.modbus_master.cache_max_entries = 256;
+  g_persist_config.modbus_master.queue_max_size = MB_ASYNC_QUEUE_SIZE;
+  g_persist_config.modbus_master.coalesce_enabled = 0;
+  g_persist_config.modbus_master.write_combine = 1;
+
+  // No wire time, 300 us per transaction: the worker stays behind the writers
+  mb_pty_farm_config_t f = {1, READ_SLAVE, 0, 0, 0, 300};
+  pty = mb_pty_bus_open(&f);
+  modbus_master_init();
+  modbus_master_set_transport(0, mb_pty_transport(), pty);
+  mb_async_init();
+}
+
+// Register i of write seq from writer w (values[0] carries the tag)
+static uint16_t write_tag(uint8_t w, uint32_t seq) {
+  return (uint16_t)((w << 13) | (seq & 0x1FFF));
+}
+
+static uint16_t write_value(uint16_t tag, uint16_t i) {
+  return i == 0 ? tag : (uint16_t)(tag * 31u + i * 0x9E37u);
+}
+
+/* ============================================================================
+ * TEST 1: SINGLE THREAD
+ * ============================================================================ */
+
+static void test_single() {
+  host_test_section("Test 1: Alloc, retain og release");
+  uint8_t slots[MB_PAYLOAD_SLOTS];
+  uint32_t failures = mb_payload_alloc_failures();
+  bool distinct = true;
+  for (uint8_t i = 0; i < MB_PAYLOAD_SLOTS; i++) {
+    slots[i] = mb_payload_alloc();
+    CHECK(slots[i] < MB_PAYLOAD_SLOTS);
+    for (uint8_t j = 0; j < i; j++) distinct &= slots[i] != slots[j];
+  }
+  CHECK(distinct);
+  CHECK_EQ(mb_payload_in_use(), MB_PAYLOAD_SLOTS);
+  CHECK_EQ(mb_payload_alloc(), MB_PAYLOAD_NONE);
+  CHECK_EQ(mb_payload_alloc_failures() - failures, 1);
+  PASS_IF("12 forskellige slots, den 13. alloc fejler og tælles",
+          distinct && mb_payload_in_use() == MB_PAYLOAD_SLOTS);
+
+  // Two references: the slot stays taken after the first release
+  mb_payload_retain(slots[0]);
+  mb_payload_release(slots[0]);
+  CHECK_EQ(mb_payload_alloc(), MB_PAYLOAD_NONE);
+  mb_payload_release(slots[0]);
+  CHECK_EQ(mb_payload_alloc(), slots[0]);
+  for (uint8_t i = 0; i < MB_PAYLOAD_SLOTS; i++) mb_payload_release(slots[i]);
+  CHECK_EQ(mb_payload_in_use(), 0);
+  PASS_IF("Slot frigives først ved sidste release", mb_payload_in_use() == 0);
+}
+
+/* ============================================================================
+ * TEST 2: WRITE FLOOD
+ * ============================================================================ */
+
+typedef struct {
+  uint8_t id;
+  uint32_t n;
+  uint32_t rejected;          // Pool or queue full → retried
+} writer_t;
+
+// Farm side: every FC16 frame on the wire
+static struct {
+  uint32_t frames[WRITERS_MAX];
+  uint32_t next_seq[WRITERS_MAX];
+  uint32_t out_of_order;
+  uint32_t corrupt;
+} wire;
+
+static void on_frame(void *arg, const uint8_t *f, uint16_t len) {
+  if (f[1] != 0x10) return;
+  uint8_t w = (uint8_t)(f[0] - 1);
+  uint16_t qty = (uint16_t)(f[4] << 8 | f[5]);
+  if (w >= WRITERS_MAX || f[6] != qty * 2 || len != 9 + f[6]) {
+    wire.corrupt++;
+    return;
+  }
+  uint16_t tag = (uint16_t)(f[7] << 8 | f[8]);
+  bool ok = (tag >> 13) == w;
+  for (uint16_t i = 0; i < qty && ok; i++) {
+    ok = (uint16_t)(f[7 + i * 2] << 8 | f[8 + i * 2]) == write_value(tag, i);
+  }
+  if (!ok) {
+    wire.corrupt++;
+    return;
+  }
+  if ((tag & 0x1FFF) != (wire.next_seq[w] & 0x1FFF)) wire.out_of_order++;
+  wire.next_seq[w] = (tag & 0x1FFFu) + 1;
+  wire.frames[w]++;
+}
+
+static void *writer_main(void *arg) {
+  writer_t *wr = (writer_t *)arg;
+  uint16_t values[MODBUS_MASTER_MAX_WRITE_REGS];
+  for (uint32_t seq = 0; seq < wr->n; seq++) {
+    uint16_t tag = write_tag(wr->id, seq);
+    uint8_t count = (uint8_t)(2 + (seq * 37) % (MODBUS_MASTER_MAX_WRITE_REGS - 1));
+    for (uint16_t i = 0; i < count; i++) values[i] = write_value(tag, i);
+    uint16_t addr = (uint16_t)((seq % 8) * 125);
+    while (!mb_async_queue_write_multi((uint8_t)(wr->id + 1), addr, count, values)) {
+      wr->rejected++;
+      usleep(50);
+    }
+  }
+  return NULL;
+}
+
+static volatile bool readers_stop = false;
+static volatile uint32_t pins = 0;
+static volatile uint32_t pin_corrupt = 0;
+
+static void *block_reader_main(void *arg) {
+  for (uint32_t i = 0; !readers_stop; i++) {
+    mb_async_queue_read_multi(READ_SLAVE, (uint16_t)((i % READ_BLOCKS) * 50), READ_COUNT);
+    usleep(200);
+  }
+  return NULL;
+}
+
+// ST side: pin a stored result, read it twice around a pause, release
+static void *pinner_main(void *arg) {
+  for (uint32_t i = 0; !readers_stop; i++) {
+    uint16_t base = (uint16_t)((i % READ_BLOCKS) * 50);
+    uint8_t slot = mb_async_block_result_pin(READ_SLAVE, base, READ_COUNT);
+    if (slot == MB_PAYLOAD_NONE) {
+      usleep(100);
+      continue;
+    }
+    const uint16_t *data = mb_payload_data(slot);
+    bool ok = true;
+    for (int pass = 0; pass < 2; pass++) {
+      for (uint16_t r = 0; r < READ_COUNT; r++) ok &= data[r] == (uint16_t)((READ_SLAVE << 8) ^ (base + r));
+      if (pass == 0) usleep(300);
+    }
+    mb_payload_release(slot);
+    pins++;
+    if (!ok) pin_corrupt++;
+  }
+  return NULL;
+}
+
+static void test_flood(uint32_t per_writer, uint8_t writers) {
+  host_test_section("Test 2: FC16 flood mod payload-puljen");
+  memset(&wire, 0, sizeof(wire));
+  mb_pty_farm_observe(pty, on_frame, NULL);
+  uint32_t failures = mb_payload_alloc_failures();
+
+  pthread_t reader, pinner, th[WRITERS_MAX];
+  writer_t wr[WRITERS_MAX];
+  pthread_create(&reader, NULL, block_reader_main, NULL);
+  pthread_create(&pinner, NULL, pinner_main, NULL);
+  // Block results first: once writers hold the pool, new reads cannot publish
+  for (int i = 0; i < 2000 && pins < 20; i++) usleep(1000);
+  uint32_t pins_before = pins;
+  uint64_t t0 = host_test_now_ns();
+  for (uint8_t w = 0; w < writers; w++) {
+    wr[w] = {w, per_writer, 0};
+    pthread_create(&th[w], NULL, writer_main, &wr[w]);
+  }
+  uint32_t rejected = 0;
+  for (uint8_t w = 0; w < writers; w++) {
+    pthread_join(th[w], NULL);
+    rejected += wr[w].rejected;
+  }
+
+  // Last writes still on their way to the farm
+  uint32_t total = per_writer * writers, frames = 0;
+  for (int i = 0; i < 5000 && frames < total; i++) {
+    frames = 0;
+    for (uint8_t w = 0; w < writers; w++) frames += wire.frames[w];
+    if (frames < total) usleep(1000);
+  }
+  double secs = (host_test_now_ns() - t0) / 1e9;
+  readers_stop = true;
+  pthread_join(reader, NULL);
+  pthread_join(pinner, NULL);
+  mb_pty_farm_observe(pty, NULL, NULL);
+
+  bool per_writer_ok = true;
+  for (uint8_t w = 0; w < writers; w++) per_writer_ok &= wire.frames[w] == per_writer;
+  uint32_t failed = mb_payload_alloc_failures() - failures;
+  printf("  %u writers x %u FC16 på %.2f s: %u frames, afvist/gentaget %u, alloc failures %u\n",
+         writers, per_writer, secs, frames, rejected, failed);
+  uint32_t pins_flood = pins - pins_before;
+  printf("  ST pins under flood: %u, korrupte %u\n", pins_flood, pin_corrupt);
+  CHECK_EQ(frames, total);
+  CHECK(per_writer_ok);
+  CHECK_EQ(wire.corrupt, 0);
+  CHECK_EQ(wire.out_of_order, 0);
+  CHECK(failed > 0);
+  PASS_IF("Alle FC16 frames ankommer én gang, i rækkefølge og uden blandet indhold",
+          frames == total && per_writer_ok && wire.corrupt == 0 && wire.out_of_order == 0);
+  CHECK(pins_flood > 0);
+  CHECK_EQ(pin_corrupt, 0);
+  PASS_IF("Pinnede read-resultater ændres ikke under flood", pins_flood > 0 && pin_corrupt == 0);
+}
+
+/* ============================================================================
+ * TEST 3: POOL AFTERWARDS
+ * ============================================================================ */
+
+static void test_drained() {
+  host_test_section("Test 3: Puljen efter flood");
+  for (int i = 0; i < 2000 && mb_async_is_busy(); i++) usleep(1000);
+  usleep(20000);  // Last transaction finishes after the queue is empty
+  uint8_t in_use = mb_payload_in_use();
+  printf("  Slots i brug med tom kø: %u (gemte block results)\n", in_use);
+  CHECK(!mb_async_is_busy());
+  CHECK(in_use <= MB_BLOCK_RESULTS_MAX);
+  mb_async_reset_cache();
+  CHECK_EQ(mb_payload_in_use(), 0);
+  PASS_IF("Kun block results holder slots, reset_cache frigiver resten",
+          in_use <= MB_BLOCK_RESULTS_MAX && mb_payload_in_use() == 0);
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================ */
+
+int main(int argc, char **argv) {
+  uint32_t per_writer = (argc > 1) ? (uint32_t)atol(argv[1]) : 500;
+  uint8_t writers = (argc > 2) ? (uint8_t)atoi(argv[2]) : 3;
+  if (writers < 1 || writers > WRITERS_MAX - 1) writers = 3;
+
+  printf("============================================================\n");
+  printf("  Modbus master payload slots: FC16 flood (host)\n");
+  printf("============================================================\n");
+
+  test_single();
+
+  setup();
+  if (!pty) {
+    printf("  [FAIL] openpty\n");
+    return 1;
+  }
+  test_flood(per_writer, writers);
+  test_drained();
+
+  mb_async_deinit();
+  mb_pty_bus_close(pty);
+  return host_test_summary();
+}
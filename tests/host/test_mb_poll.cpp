@@ -0,0 +1,237 @@
+/**
+ * @file test_mb_poll.cpp
+ * @brief Poll group scheduling: mb_poll_pick / mb_poll_advance on host (FEAT-157)
+ *
+ * Both functions are pure (the task calls them under mb_cache_spinlock), so
+ * the test drives them with a simulated clock instead of the worker task:
+ *
+ *   1. mb_poll_pick: priority before deadline, disabled groups skipped,
+ *      wait_ms capped to the nearest future deadline, millis() wrap-around
+ *   2. mb_poll_advance: deadlines stay on the period grid after a late
+ *      start, missed periods are dropped and counted, MIN period clamp, wrap
+ *   3. Scheduler simulation: a bus that spends cost_ms per block read.
+ *      A running block read is never preempted, so the top-priority group
+ *      is at most the longest other block read late. Below 100% load every
+ *      group keeps its rate with no missed periods. Overloaded (and every
+ *      block read shorter than the top group's period), the top group still
+ *      keeps its rate while the lowest group drops periods instead of
+ *      bursting. Both run once more starting just below the 32-bit millis()
+ *      wrap.
+ *
+ * Usage: test_mb_poll [simulated seconds, default 600]
+ */
+
+#include "mb_async.h"
+#include "host_test.h"
+#include <string.h>
+
+static mb_poll_state_t make_group(uint8_t priority, uint32_t period_ms, uint32_t next_due_ms) {
+  mb_poll_state_t g;
+  memset(&g, 0, sizeof(g));
+  g.cfg.enabled = 1;
+  g.cfg.slave_id = 1;
+  g.cfg.fc = MB_REQ_READ_HOLDING;
+  g.cfg.count = 10;
+  g.cfg.priority = priority;
+  g.cfg.period_ms = period_ms;
+  g.next_due_ms = next_due_ms;
+  return g;
+}
+
+/* ============================================================================
+ * TEST 1: PICK
+ * ============================================================================ */
+
+static void test_pick() {
+  host_test_section("Test 1: mb_poll_pick");
+  mb_poll_state_t g[4] = {
+    make_group(0, 100, 1000),
+    make_group(5, 100, 1050),
+    make_group(5, 100, 1020),
+    make_group(9, 100, 1300),
+  };
+  uint32_t wait = 100;
+
+  // Nothing due: -1 and wait capped to the nearest deadline
+  CHECK_EQ(mb_poll_pick(g, 4, 990, &wait), -1);
+  CHECK_EQ(wait, 10);
+  wait = 5;
+  CHECK_EQ(mb_poll_pick(g, 4, 990, &wait), -1);
+  CHECK_EQ(wait, 5);  // Never raised
+
+  // Only group 0 due
+  wait = 100;
+  CHECK_EQ(mb_poll_pick(g, 4, 1000, &wait), 0);
+  // Groups 0, 1, 2 due: priority 5 beats 0, then the earlier deadline (group 2)
+  CHECK_EQ(mb_poll_pick(g, 4, 1100, &wait), 2);
+  // Group 3 (priority 9) due as well
+  CHECK_EQ(mb_poll_pick(g, 4, 1300, &wait), 3);
+  bool order_ok = mb_poll_pick(g, 4, 1100, &wait) == 2 && mb_poll_pick(g, 4, 1300, &wait) == 3;
+  PASS_IF("Højeste prioritet først, derefter tidligste deadline", order_ok);
+
+  // Disabled groups never win and do not cap wait
+  g[3].cfg.enabled = 0;
+  g[2].cfg.enabled = 0;
+  wait = 100;
+  CHECK_EQ(mb_poll_pick(g, 4, 1100, &wait), 1);
+  for (int i = 0; i < 4; i++) g[i].cfg.enabled = 0;
+  wait = 100;
+  CHECK_EQ(mb_poll_pick(g, 4, 1100, &wait), -1);
+  CHECK_EQ(wait, 100);
+
+  // Wrap: deadline 0x00000010 is 0x20 ms after now = 0xFFFFFFF0
+  mb_poll_state_t w[2] = {
+    make_group(0, 100, 0x00000010u),
+    make_group(0, 100, 0xFFFFFFE0u),
+  };
+  wait = 100;
+  CHECK_EQ(mb_poll_pick(w, 2, 0xFFFFFFF0u, &wait), 1);
+  w[1].cfg.enabled = 0;
+  wait = 100;
+  CHECK_EQ(mb_poll_pick(w, 2, 0xFFFFFFF0u, &wait), -1);
+  CHECK_EQ(wait, 0x20);
+  CHECK_EQ(mb_poll_pick(w, 2, 0x00000010u, &wait), 0);
+  PASS_IF("Disabled grupper ignoreres, wait_ms og millis() wrap korrekt", host_test_failed == 0);
+}
+
+/* ============================================================================
+ * TEST 2: ADVANCE
+ * ============================================================================ */
+
+static void test_advance() {
+  host_test_section("Test 2: mb_poll_advance");
+  mb_poll_state_t g = make_group(0, 100, 1000);
+
+  // Started 30 ms late: next deadline stays on the grid (1100, not 1130)
+  mb_poll_advance(&g, 1030);
+  CHECK_EQ(g.next_due_ms, 1100);
+  CHECK_EQ(g.missed, 0);
+  // Started 99 ms late: still one period, no drop
+  mb_poll_advance(&g, 1199);
+  CHECK_EQ(g.next_due_ms, 1200);
+  CHECK_EQ(g.missed, 0);
+  PASS_IF("Deadlines følger perioden uden drift", g.next_due_ms == 1200 && g.missed == 0);
+
+  // Started 350 ms late (deadline 1200, now 1550): 1300/1400/1500 dropped, next 1600
+  mb_poll_advance(&g, 1550);
+  CHECK_EQ(g.next_due_ms, 1600);
+  CHECK_EQ(g.missed, 3);
+  // Exactly on the next deadline counts as behind: skip to the one after
+  mb_poll_advance(&g, 1700);
+  CHECK_EQ(g.next_due_ms, 1800);
+  CHECK_EQ(g.missed, 4);
+  PASS_IF("Mistede perioder springes over og tælles", g.next_due_ms == 1800 && g.missed == 4);
+
+  // Period below the minimum is clamped
+  mb_poll_state_t c = make_group(0, 1, 0);
+  mb_poll_advance(&c, 0);
+  CHECK_EQ(c.next_due_ms, MB_POLL_MIN_PERIOD_MS);
+
+  // Wrap: deadline 0xFFFFFFC0 + 100 wraps to 0x24
+  mb_poll_state_t w = make_group(0, 100, 0xFFFFFFC0u);
+  mb_poll_advance(&w, 0xFFFFFFD0u);
+  CHECK_EQ(w.next_due_ms, 0x24u);
+  CHECK_EQ(w.missed, 0);
+  mb_poll_advance(&w, 0x24u + 250);
+  CHECK_EQ(w.next_due_ms, 0x24u + 300);
+  CHECK_EQ(w.missed, 2);
+  PASS_IF("MIN periode clamp og wrap omkring 2^32", host_test_failed == 0);
+}
+
+/* ============================================================================
+ * TEST 3: SCHEDULER SIMULATION
+ * ============================================================================ */
+
+typedef struct {
+  uint8_t priority;
+  uint32_t period_ms;
+  uint32_t cost_ms;       // Bus time of one block read
+} sim_group_t;
+
+typedef struct {
+  uint32_t polls[4];
+  uint32_t missed[4];
+  uint32_t late_max[4];
+} sim_result_t;
+
+// Same loop shape as mb_async_task_func: pick one due group, run it, else sleep until the next deadline
+static sim_result_t simulate(const sim_group_t *cfg, uint8_t n, uint32_t start_ms, uint32_t duration_ms) {
+  mb_poll_state_t g[4];
+  for (uint8_t i = 0; i < n; i++) g[i] = make_group(cfg[i].priority, cfg[i].period_ms, start_ms);
+
+  sim_result_t r;
+  memset(&r, 0, sizeof(r));
+  uint32_t now = start_ms;
+  while (now - start_ms < duration_ms) {
+    uint32_t wait = 100;
+    int8_t due = mb_poll_pick(g, n, now, &wait);
+    if (due < 0) {
+      now += wait;
+      continue;
+    }
+    uint32_t late = now - g[due].next_due_ms;
+    if (late > r.late_max[due]) r.late_max[due] = late;
+    mb_poll_advance(&g[due], now);
+    r.polls[due]++;
+    now += cfg[due].cost_ms;
+  }
+  for (uint8_t i = 0; i < n; i++) r.missed[i] = g[i].missed;
+  return r;
+}
+
+static void test_simulation(uint32_t seconds) {
+  host_test_section("Test 3: Scheduler simulation");
+  const uint32_t duration = seconds * 1000;
+  const uint32_t starts[] = {0, 0xFFFFFFFFu - duration / 2};
+
+  // 40% bus load: 8/50 + 12/100 + 20/250 + 40/1000 = 0.16 + 0.12 + 0.08 + 0.04
+  const sim_group_t light[4] = {{9, 50, 8}, {5, 100, 12}, {5, 250, 20}, {0, 1000, 40}};
+  // 110% bus load: 30/100 + 40/100 + 60/250 + 80/500 = 0.30 + 0.40 + 0.24 + 0.16
+  const sim_group_t heavy[4] = {{9, 100, 30}, {5, 100, 40}, {3, 250, 60}, {0, 500, 80}};
+
+  for (size_t s = 0; s < sizeof(starts) / sizeof(starts[0]); s++) {
+    sim_result_t r = simulate(light, 4, starts[s], duration);
+    bool rates_ok = true, missed_ok = true;
+    printf("  Let last (start 0x%08X):\n", starts[s]);
+    for (uint8_t i = 0; i < 4; i++) {
+      uint32_t expected = duration / light[i].period_ms;
+      printf("    gruppe %u (prio %u, %4u ms): %6u polls (forventet %u), missed %u, max forsinkelse %u ms\n",
+             i, light[i].priority, light[i].period_ms, r.polls[i], expected, r.missed[i], r.late_max[i]);
+      rates_ok &= r.polls[i] + 1 >= expected && r.polls[i] <= expected + 1;
+      missed_ok &= r.missed[i] == 0;
+    }
+    PASS_IF("Let last: alle grupper holder raten uden mistede perioder", rates_ok && missed_ok);
+    PASS_IF("Let last: prio 9 aldrig senere end den længste anden block read", r.late_max[0] <= light[3].cost_ms);
+
+    r = simulate(heavy, 4, starts[s], duration);
+    printf("  Overlast (start 0x%08X):\n", starts[s]);
+    for (uint8_t i = 0; i < 4; i++) {
+      printf("    gruppe %u (prio %u, %4u ms): %6u polls (forventet %u), missed %u, max forsinkelse %u ms\n",
+             i, heavy[i].priority, heavy[i].period_ms, r.polls[i], duration / heavy[i].period_ms,
+             r.missed[i], r.late_max[i]);
+    }
+    uint32_t expected0 = duration / heavy[0].period_ms;
+    PASS_IF("Overlast: prio 9 holder raten", r.polls[0] + 1 >= expected0 && r.missed[0] == 0);
+    PASS_IF("Overlast: prio 9 aldrig senere end den længste anden block read", r.late_max[0] <= heavy[3].cost_ms);
+    PASS_IF("Overlast: laveste prioritet dropper perioder i stedet for burst",
+            r.missed[3] > 0 && r.polls[3] <= duration / heavy[3].period_ms);
+  }
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================ */
+
+int main(int argc, char **argv) {
+  uint32_t seconds = (argc > 1) ? (uint32_t)atol(argv[1]) : 600;
+
+  printf("============================================================\n");
+  printf("  Modbus master poll groups: pick/advance (host)\n");
+  printf("============================================================\n");
+
+  test_pick();
+  test_advance();
+  test_simulation(seconds);
+
+  return host_test_summary();
+}
@@ -0,0 +1,272 @@
+/**
+ * @file test_mb_queue_rings.cpp
+ * @brief Lock-free MPSC priority rings: pthread stress on host (FEAT-160)
+ *
+ * Builds mb_async.cpp into this test so the ring statics (mb_pq_ring_push/pop,
+ * mb_pq_insert/dequeue) are reachable. Producers are real threads hammering
+ * one bus while a consumer thread plays the bus worker:
+ *
+ *   1. Single thread: ring full at MB_ASYNC_QUEUE_SIZE, FIFO pop, head/tail
+ *      positions wrapping past 2^32
+ *   2. mb_pq_ring_push from N producers into one ring (retry when full) with
+ *      one popping consumer, positions starting just below the 2^32 wrap:
+ *      every request popped exactly once, each producer's requests in order
+ *   3. mb_pq_insert / mb_pq_dequeue from N producers over all three classes
+ *      at a runtime queue limit below the ring size, so priority eviction
+ *      runs: no duplicates, accepted == popped + priority drops, pq_count,
+ *      pq_evict and every ring count back at 0
+ *
+ * Usage: test_mb_queue_rings [requests per producer, default 200000] [producers, default 4]
+ */
+
+#include "../../src/mb_async.cpp"
+
+#include "host_test.h"
+#include <pthread.h>
+#include <sched.h>
+#include <vector>
+
+#define PRODUCERS_MAX 16
+
+static mb_async_state_t *bus0_reset() {
+  mb_async_state_t *b = &g_mb_async[0];
+  for (uint8_t c = 0; c < MB_PRIO_COUNT; c++) mb_pq_ring_init(&b->pq_ring[c]);
+  b->pq_count = 0;
+  b->pq_evict = 0;
+  b->queue_contention = 0;
+  b->queue_full_count = 0;
+  b->priority_drops = 0;
+  if (!b->pq_semaphore) b->pq_semaphore = xSemaphoreCreateCounting(MB_PRIO_COUNT * MB_ASYNC_QUEUE_SIZE, 0);
+  return b;
+}
+
+// Empty ring whose positions start at pos (seq[] as if pos requests had passed)
+static void ring_start_at(mb_pq_ring_t *r, uint32_t pos) {
+  mb_pq_ring_init(r);
+  r->head = pos;
+  r->tail = pos;
+  for (uint32_t i = 0; i < MB_ASYNC_QUEUE_SIZE; i++) r->seq[(pos + i) & MB_PQ_MASK] = pos + i;
+}
+
+// Request n of producer p: slave = p + 1, sequence number in write_value
+static mb_async_request_t make_req(uint8_t p, uint32_t n, uint8_t prio) {
+  mb_async_request_t req;
+  memset(&req, 0, sizeof(req));
+  req.type = MB_REQ_READ_HOLDING;
+  req.slave_id = (uint8_t)(p + 1);
+  req.address = (uint16_t)n;
+  req.write_value.dint_val = (int32_t)n;
+  req.priority = prio;
+  return req;
+}
+
+/* ============================================================================
+ * TEST 1: SINGLE THREAD
+ * ============================================================================ */
+
+static void test_single() {
+  host_test_section("Test 1: Fuld ring, FIFO og wrap af positioner");
+  mb_async_state_t *b = bus0_reset();
+  mb_pq_ring_t *r = &b->pq_ring[MB_PRIO_READ_FRESH];
+  ring_start_at(r, 0xFFFFFFF0u);
+
+  bool fifo_ok = true;
+  for (uint32_t lap = 0; lap < 4; lap++) {
+    for (uint32_t i = 0; i < MB_ASYNC_QUEUE_SIZE; i++) {
+      mb_async_request_t req = make_req(0, lap * MB_ASYNC_QUEUE_SIZE + i, MB_PRIO_READ_FRESH);
+      CHECK(mb_pq_ring_push(b, r, &req));
+    }
+    mb_async_request_t extra = make_req(0, 0xFFFF, MB_PRIO_READ_FRESH);
+    CHECK(!mb_pq_ring_push(b, r, &extra));
+    CHECK_EQ(r->count, MB_ASYNC_QUEUE_SIZE);
+    for (uint32_t i = 0; i < MB_ASYNC_QUEUE_SIZE; i++) {
+      mb_async_request_t out;
+      fifo_ok &= mb_pq_ring_pop(r, &out) && out.write_value.dint_val == (int32_t)(lap * MB_ASYNC_QUEUE_SIZE + i);
+    }
+    mb_async_request_t out;
+    CHECK(!mb_pq_ring_pop(r, &out));
+  }
+  CHECK(fifo_ok);
+  CHECK_EQ(r->count, 0);
+  CHECK_EQ(r->head, 0xFFFFFFF0u + 4 * MB_ASYNC_QUEUE_SIZE);
+  PASS_IF("Fuld ved MB_ASYNC_QUEUE_SIZE, FIFO over 4 omgange forbi 2^32", fifo_ok && r->count == 0);
+}
+
+/* ============================================================================
+ * TEST 2: RING PUSH FROM N PRODUCERS
+ * ============================================================================ */
+
+typedef struct {
+  mb_async_state_t *b;
+  mb_pq_ring_t *r;
+  uint8_t id;
+  uint32_t n;
+  uint32_t full_retries;
+} ring_producer_t;
+
+static void *ring_producer_main(void *arg) {
+  ring_producer_t *p = (ring_producer_t *)arg;
+  for (uint32_t i = 0; i < p->n; i++) {
+    mb_async_request_t req = make_req(p->id, i, MB_PRIO_READ_FRESH);
+    while (!mb_pq_ring_push(p->b, p->r, &req)) {
+      p->full_retries++;
+      sched_yield();
+    }
+  }
+  return NULL;
+}
+
+static void test_ring_stress(uint32_t per_producer, uint8_t producers) {
+  host_test_section("Test 2: mb_pq_ring_push fra flere tråde");
+  mb_async_state_t *b = bus0_reset();
+  mb_pq_ring_t *r = &b->pq_ring[MB_PRIO_READ_FRESH];
+  ring_start_at(r, 0u - per_producer);  // Crosses 2^32 halfway through
+
+  ring_producer_t prod[PRODUCERS_MAX];
+  pthread_t th[PRODUCERS_MAX];
+  for (uint8_t p = 0; p < producers; p++) {
+    prod[p] = {b, r, p, per_producer, 0};
+    pthread_create(&th[p], NULL, ring_producer_main, &prod[p]);
+  }
+
+  // Consumer: expected next sequence per producer (in order, so no loss/dup)
+  std::vector<uint32_t> next(producers, 0);
+  uint64_t popped = 0, out_of_order = 0, foreign = 0;
+  uint64_t total = (uint64_t)per_producer * producers;
+  uint64_t t0 = host_test_now_ns();
+  while (popped < total && host_test_now_ns() - t0 < 60000000000ull) {
+    mb_async_request_t out;
+    if (!mb_pq_ring_pop(r, &out)) {
+      sched_yield();
+      continue;
+    }
+    popped++;
+    uint8_t p = (uint8_t)(out.slave_id - 1);
+    if (p >= producers) {
+      foreign++;
+      continue;
+    }
+    if ((uint32_t)out.write_value.dint_val != next[p] || out.address != (uint16_t)next[p]) out_of_order++;
+    next[p] = (uint32_t)out.write_value.dint_val + 1;
+  }
+  double secs = (host_test_now_ns() - t0) / 1e9;
+  uint32_t retries = 0;
+  for (uint8_t p = 0; p < producers; p++) {
+    pthread_join(th[p], NULL);
+    retries += prod[p].full_retries;
+  }
+
+  bool all_seen = popped == total;
+  for (uint8_t p = 0; p < producers; p++) all_seen &= next[p] == per_producer;
+  mb_async_request_t extra;
+  CHECK(!mb_pq_ring_pop(r, &extra));
+  CHECK_EQ(r->count, 0);
+  CHECK_EQ(foreign, 0);
+  CHECK_EQ(out_of_order, 0);
+  CHECK(all_seen);
+  printf("  %u producers x %u: %.2f M push/pop/s, contention %u, ring fuld %u gange\n",
+         producers, per_producer, popped / secs / 1e6, b->queue_contention, retries);
+  PASS_IF("Hver request poppet præcis én gang, i rækkefølge pr. producer",
+          all_seen && out_of_order == 0 && foreign == 0 && r->count == 0);
+}
+
+/* ============================================================================
+ * TEST 3: INSERT/DEQUEUE WITH PRIORITY EVICTION
+ * ============================================================================ */
+
+typedef struct {
+  mb_async_state_t *b;
+  uint8_t id;
+  uint32_t n;
+  uint32_t accepted;
+  uint32_t rejected;
+} insert_producer_t;
+
+static void *insert_producer_main(void *arg) {
+  insert_producer_t *p = (insert_producer_t *)arg;
+  for (uint32_t i = 0; i < p->n; i++) {
+    mb_async_request_t req = make_req(p->id, i, (uint8_t)(p->id % MB_PRIO_COUNT));
+    if (mb_pq_insert(p->b, &req)) {
+      p->accepted++;
+    } else {
+      p->rejected++;
+      sched_yield();
+    }
+  }
+  return NULL;
+}
+
+static void test_insert_stress(uint32_t per_producer, uint8_t producers) {
+  host_test_section("Test 3: mb_pq_insert/dequeue med prioritets-eviction");
+  g_modbus_master_config.queue_max_size = MB_ASYNC_QUEUE_SIZE / 2;
+  mb_async_state_t *b = bus0_reset();
+
+  insert_producer_t prod[PRODUCERS_MAX];
+  pthread_t th[PRODUCERS_MAX];
+  for (uint8_t p = 0; p < producers; p++) {
+    prod[p] = {b, p, per_producer, 0, 0};
+    pthread_create(&th[p], NULL, insert_producer_main, &prod[p]);
+  }
+
+  // Consumer as the bus worker: sequence numbers per producer only ever grow
+  // (a producer feeds one class; evicted requests leave gaps, never repeats)
+  std::vector<int64_t> last(producers, -1);
+  uint64_t popped = 0, repeats = 0;
+  bool done = false;
+  while (!done) {
+    done = true;
+    for (uint8_t p = 0; p < producers; p++) done &= prod[p].accepted + prod[p].rejected == per_producer;
+    mb_async_request_t out;
+    while (mb_pq_dequeue(b, &out)) {
+      popped++;
+      uint8_t p = (uint8_t)(out.slave_id - 1);
+      if (p >= producers || out.write_value.dint_val <= last[p]) repeats++;
+      else last[p] = out.write_value.dint_val;
+    }
+    if (!done) xSemaphoreTake(b->pq_semaphore, 1);
+  }
+  uint64_t accepted = 0, rejected = 0;
+  for (uint8_t p = 0; p < producers; p++) {
+    pthread_join(th[p], NULL);
+    accepted += prod[p].accepted;
+    rejected += prod[p].rejected;
+  }
+  mb_async_request_t out;
+  while (mb_pq_dequeue(b, &out)) popped++;
+
+  uint32_t ring_counts = 0;
+  for (uint8_t c = 0; c < MB_PRIO_COUNT; c++) ring_counts += b->pq_ring[c].count;
+  printf("  %u producers x %u: accepteret %llu, afvist %llu, poppet %llu, eviction drops %u\n",
+         producers, per_producer, (unsigned long long)accepted, (unsigned long long)rejected,
+         (unsigned long long)popped, b->priority_drops);
+  CHECK_EQ(repeats, 0);
+  CHECK_EQ(accepted, popped + b->priority_drops);
+  CHECK_EQ(rejected, b->queue_full_count);
+  CHECK_EQ(b->pq_count, 0);
+  CHECK_EQ(b->pq_evict, 0);
+  CHECK_EQ(ring_counts, 0);
+  CHECK(b->priority_drops > 0);
+  PASS_IF("Ingen dubletter, accepteret == poppet + eviction drops, tællere tilbage på 0",
+          repeats == 0 && accepted == popped + b->priority_drops && b->pq_count == 0 && ring_counts == 0);
+  g_modbus_master_config.queue_max_size = MB_ASYNC_QUEUE_SIZE;
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================ */
+
+int main(int argc, char **argv) {
+  uint32_t per_producer = (argc > 1) ? (uint32_t)atol(argv[1]) : 200000;
+  uint8_t producers = (argc > 2) ? (uint8_t)atoi(argv[2]) : 4;
+  if (producers < 1 || producers > PRODUCERS_MAX) producers = 4;
+
+  printf("============================================================\n");
+  printf("  Modbus master kø: lock-free MPSC ringe (host)\n");
+  printf("============================================================\n");
+
+  test_single();
+  test_ring_stress(per_producer, producers);
+  test_insert_stress(per_producer, producers);
+
+  return host_test_summary();
+}
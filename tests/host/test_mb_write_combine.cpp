@@ -0,0 +1,289 @@
+/**
+ * @file test_mb_write_combine.cpp
+ * @brief Write combining: pending-write table and mb_write_take on host (FEAT-164)
+ *
+ * Builds mb_async.cpp into this test so the worker-side statics
+ * (mb_pq_dequeue, mb_write_take) are reachable. Writes go in through
+ * mb_async_queue_write exactly as from ST; the test plays the bus worker:
+ *
+ *   1. Last value wins: repeated writes to one address queue one request,
+ *      mb_write_take sends the newest value and frees the entry
+ *   2. Contiguous runs: the seed takes every pending neighbour of the same
+ *      slave and type into one block (never across a gap), requests whose
+ *      entry already went out are dropped, coil values are sent as 0/1
+ *   3. write_combine off queues every write; dedup skips a value the cache
+ *      holds as confirmed unless the slave is in the write-always set
+ *   4. Random write streams against the contract: every written key is sent
+ *      exactly once with its last value, blocks are contiguous runs of
+ *      pending addresses holding the seed, the table ends empty
+ *
+ * Usage: test_mb_write_combine [random rounds, default 20000]
+ */
+
+#include "../../src/mb_async.cpp"
+
+#include "host_test.h"
+#include <map>
+
+extern bool g_mb_cache_enabled;
+
+static mb_async_state_t *bus0_reset() {
+  mb_async_state_t *b = &g_mb_async[0];
+  for (uint8_t c = 0; c < MB_PRIO_COUNT; c++) mb_pq_ring_init(&b->pq_ring[c]);
+  b->pq_count = 0;
+  b->pq_evict = 0;
+  b->write_combined = 0;
+  b->write_skipped = 0;
+  memset(b->write_pending, 0, sizeof(b->write_pending));
+  if (!b->pq_semaphore) b->pq_semaphore = xSemaphoreCreateCounting(MB_PRIO_COUNT * MB_ASYNC_QUEUE_SIZE, 0);
+  return b;
+}
+
+static bool write_hr(uint8_t slave, uint16_t addr, uint16_t value) {
+  st_value_t v;
+  v.int_val = value;
+  return mb_async_queue_write(MB_REQ_WRITE_HOLDING, slave, addr, v);
+}
+
+static bool write_coil(uint8_t slave, uint16_t addr, bool on) {
+  st_value_t v;
+  v.int_val = on ? 0x5A01 : 0;  // Garbage above bool_val must not reach the wire
+  v.bool_val = on;
+  return mb_async_queue_write(MB_REQ_WRITE_COIL, slave, addr, v);
+}
+
+// Worker step: dequeue one request and take its pending write (false = dropped)
+static bool worker_take(mb_async_state_t *b, mb_async_request_t *req, mb_write_block_t *blk) {
+  if (!mb_pq_dequeue(b, req)) return false;
+  return req->combined && mb_write_take(b, req, blk);
+}
+
+static uint8_t pending_count(const mb_async_state_t *b) {
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < MB_WRITE_PENDING_MAX; i++) n += b->write_pending[i].slave_id != 0;
+  return n;
+}
+
+/* ============================================================================
+ * TEST 1: LAST VALUE WINS
+ * ============================================================================ */
+
+static void test_last_value() {
+  host_test_section("Test 1: Sidste værdi vinder");
+  mb_async_state_t *b = bus0_reset();
+  CHECK(write_hr(1, 100, 1));
+  CHECK(write_hr(1, 100, 2));
+  CHECK(write_hr(1, 100, 3));
+  CHECK_EQ(b->pq_count, 1);
+  CHECK_EQ(b->write_combined, 2);
+
+  mb_async_request_t req;
+  mb_write_block_t blk;
+  bool taken = worker_take(b, &req, &blk);
+  CHECK(taken);
+  CHECK(req.combined);
+  CHECK_EQ(blk.slave_id, 1);
+  CHECK_EQ(blk.start, 100);
+  CHECK_EQ(blk.count, 1);
+  CHECK_EQ(blk.values[0], 3);
+  CHECK_EQ(pending_count(b), 0);
+  PASS_IF("3 writes til samme adresse → én request med værdien 3",
+          taken && b->pq_count == 0 && blk.count == 1 && blk.values[0] == 3);
+
+  // A new write after the take claims a fresh entry and its own request
+  CHECK(write_hr(1, 100, 4));
+  CHECK_EQ(b->pq_count, 1);
+  taken = worker_take(b, &req, &blk);
+  PASS_IF("Write efter take køes igen", taken && blk.values[0] == 4 && pending_count(b) == 0);
+}
+
+/* ============================================================================
+ * TEST 2: CONTIGUOUS RUNS
+ * ============================================================================ */
+
+static void test_runs() {
+  host_test_section("Test 2: Sammenhængende writes → FC16/FC15 blok");
+  mb_async_state_t *b = bus0_reset();
+  CHECK(write_hr(1, 11, 111));        // Seed in the middle of the run
+  CHECK(write_hr(1, 10, 110));
+  CHECK(write_hr(1, 12, 112));
+  CHECK(write_hr(1, 14, 114));        // Gap at 13: separate transaction
+  CHECK(write_hr(2, 13, 213));        // Other slave
+  CHECK(write_coil(1, 13, true));     // Other type
+  CHECK(write_coil(1, 12, false));
+  CHECK(write_hr(1, 10, 120));        // Last value wins inside the block too
+  CHECK_EQ(b->pq_count, 7);
+
+  mb_async_request_t req;
+  mb_write_block_t blk;
+  bool taken = worker_take(b, &req, &blk);
+  CHECK(taken);
+  CHECK_EQ(req.address, 11);
+  CHECK_EQ(blk.start, 10);
+  CHECK_EQ(blk.count, 3);
+  bool values_ok = blk.count == 3 && blk.values[0] == 120 && blk.values[1] == 111 && blk.values[2] == 112;
+  CHECK(values_ok);
+  PASS_IF("Seed 11 tager 10..12 med nyeste værdier", taken && blk.start == 10 && values_ok);
+
+  // 10 and 12 went out with the block: their requests are dropped
+  CHECK(!worker_take(b, &req, &blk));
+  CHECK_EQ(req.address, 10);
+  CHECK(!worker_take(b, &req, &blk));
+  CHECK_EQ(req.address, 12);
+
+  bool rest_ok = worker_take(b, &req, &blk) && blk.slave_id == 1 && blk.start == 14 && blk.count == 1;
+  rest_ok &= worker_take(b, &req, &blk) && blk.slave_id == 2 && blk.start == 13 && blk.count == 1;
+  rest_ok &= worker_take(b, &req, &blk) && blk.req_type == MB_REQ_WRITE_COIL && blk.start == 12 &&
+             blk.count == 2 && blk.values[0] == 0 && blk.values[1] == 1;
+  rest_ok &= !worker_take(b, &req, &blk) && req.address == 12;
+  CHECK(rest_ok);
+  CHECK_EQ(b->pq_count, 0);
+  CHECK_EQ(pending_count(b), 0);
+  PASS_IF("Hul, anden slave og coils holdes adskilt; coil værdier sendes som 0/1",
+          rest_ok && b->pq_count == 0 && pending_count(b) == 0);
+}
+
+/* ============================================================================
+ * TEST 3: COMBINE OFF AND DEDUP
+ * ============================================================================ */
+
+static void test_off_and_dedup() {
+  host_test_section("Test 3: write_combine off og dedup");
+  mb_async_state_t *b = bus0_reset();
+  g_modbus_master_config.write_combine = 0;
+  CHECK(write_hr(1, 50, 1));
+  CHECK(write_hr(1, 50, 2));
+  CHECK(write_hr(1, 51, 3));
+  CHECK_EQ(b->pq_count, 3);
+  CHECK_EQ(pending_count(b), 0);
+  mb_async_request_t req;
+  bool plain = true;
+  uint16_t expect[] = {1, 2, 3};
+  for (uint8_t i = 0; i < 3; i++) {
+    plain &= mb_pq_dequeue(b, &req) && !req.combined && req.write_value.int_val == expect[i];
+  }
+  g_modbus_master_config.write_combine = 1;
+  PASS_IF("Off: hver write sin egen request med sin egen værdi", plain && b->pq_count == 0);
+
+  // Confirmed value in the cache: an equal write is skipped
+  b = bus0_reset();
+  g_mb_cache_enabled = true;
+  st_value_t seven;
+  seven.int_val = 7;
+  mb_cache_update(1, 60, MB_REQ_READ_HOLDING, true, MB_OK, seven, MB_REQ_READ_HOLDING);
+  CHECK(mb_cache_find(1, 60, MB_REQ_READ_HOLDING, NULL));
+  CHECK(write_hr(1, 60, 7));
+  CHECK_EQ(b->write_skipped, 1);
+  CHECK_EQ(b->pq_count, 0);
+  bool skip_ok = b->write_skipped == 1 && b->pq_count == 0;
+
+  // Write-always slave: sent anyway
+  mb_cache_update(1, 60, MB_REQ_READ_HOLDING, true, MB_OK, seven, MB_REQ_READ_HOLDING);
+  mb_async_write_always_set(1, 1, true);
+  CHECK(write_hr(1, 60, 7));
+  CHECK_EQ(b->pq_count, 1);
+  bool always_ok = b->pq_count == 1 && b->write_skipped == 1;
+  mb_async_write_always_set(1, 1, false);
+  PASS_IF("Bekræftet værdi springes over, write-always sender alligevel", skip_ok && always_ok);
+}
+
+/* ============================================================================
+ * TEST 4: RANDOM STREAMS AGAINST THE CONTRACT
+ * ============================================================================ */
+
+static uint32_t xorshift(uint32_t *s) {
+  *s ^= *s << 13;
+  *s ^= *s >> 17;
+  *s ^= *s << 5;
+  return *s;
+}
+
+static void test_random(uint32_t rounds) {
+  host_test_section("Test 4: Tilfældige write-strømme mod kontrakten");
+  g_mb_cache_enabled = false;  // No dedup: every write must reach the wire
+  uint32_t seed = 0xC0FFEE;
+  uint32_t bad_value = 0, lost = 0, duplicate = 0, bad_block = 0, blocks = 0, members = 0;
+
+  for (uint32_t round = 0; round < rounds; round++) {
+    mb_async_state_t *b = bus0_reset();
+    std::map<uint32_t, uint16_t> expected;   // key (type, slave, addr) → last value
+    uint32_t writes = 4 + xorshift(&seed) % 60;
+    for (uint32_t w = 0; w < writes && expected.size() < MB_WRITE_PENDING_MAX - 2; w++) {
+      uint8_t type = (xorshift(&seed) & 3) ? MB_REQ_WRITE_HOLDING : MB_REQ_WRITE_COIL;
+      uint8_t slave = (uint8_t)(1 + xorshift(&seed) % 2);
+      uint16_t addr = (uint16_t)(xorshift(&seed) % 40);
+      uint16_t value = (uint16_t)xorshift(&seed);
+      if (type == MB_REQ_WRITE_COIL) value &= 1;
+      bool ok = (type == MB_REQ_WRITE_COIL) ? write_coil(slave, addr, value != 0) : write_hr(slave, addr, value);
+      if (ok) expected[(uint32_t)type << 24 | (uint32_t)slave << 16 | addr] = value;
+    }
+
+    std::map<uint32_t, uint16_t> sent;
+    mb_async_request_t req;
+    mb_write_block_t blk;
+    while (b->pq_count > 0) {
+      // Pending addresses of the seed's slave/type before the take (for the run check)
+      if (!mb_pq_dequeue(b, &req)) break;
+      bool pending_at[MB_WRITE_PENDING_MAX + 40] = {false};
+      for (uint8_t i = 0; i < MB_WRITE_PENDING_MAX; i++) {
+        const mb_write_pending_t *p = &b->write_pending[i];
+        if (p->slave_id == req.slave_id && p->req_type == (uint8_t)req.type) pending_at[p->address] = true;
+      }
+      if (!req.combined || !mb_write_take(b, &req, &blk)) continue;
+      blocks++;
+      members += blk.count;
+      bool run_ok = blk.count >= 1 && blk.count <= MB_WRITE_PENDING_MAX && req.address >= blk.start &&
+                    req.address < blk.start + blk.count;
+      for (uint16_t i = 0; run_ok && i < blk.count; i++) run_ok = pending_at[blk.start + i];
+      if (blk.start > 0 && pending_at[blk.start - 1] && blk.count < MB_WRITE_PENDING_MAX) run_ok = false;
+      if (pending_at[blk.start + blk.count] && blk.count < MB_WRITE_PENDING_MAX) run_ok = false;
+      if (!run_ok) bad_block++;
+      for (uint16_t i = 0; i < blk.count; i++) {
+        uint32_t key = (uint32_t)blk.req_type << 24 | (uint32_t)blk.slave_id << 16 | (uint16_t)(blk.start + i);
+        if (sent.count(key)) duplicate++;
+        sent[key] = blk.values[i];
+      }
+    }
+    for (const auto &kv : expected) {
+      auto it = sent.find(kv.first);
+      if (it == sent.end()) lost++;
+      else if (it->second != kv.second) bad_value++;
+    }
+    if (sent.size() > expected.size()) bad_value++;  // Sent an address nobody wrote
+    if (pending_count(b) != 0 || b->pq_count != 0) lost++;
+  }
+
+  printf("  %u runder: %u transaktioner for %u writes (%.2f pr. transaktion)\n", rounds, blocks, members,
+         blocks ? (double)members / blocks : 0.0);
+  CHECK_EQ(lost, 0);
+  CHECK_EQ(duplicate, 0);
+  CHECK_EQ(bad_value, 0);
+  CHECK_EQ(bad_block, 0);
+  CHECK(members > blocks);
+  PASS_IF("Hver adresse sendt én gang med sidste værdi, blokke er hele sammenhængende løb",
+          lost == 0 && duplicate == 0 && bad_value == 0 && bad_block == 0);
+  g_mb_cache_enabled = true;
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================ */
+
+int main(int argc, char **argv) {
+  uint32_t rounds = (argc > 1) ? (uint32_t)atol(argv[1]) : 20000;
+
+  printf("============================================================\n");
+  printf("  Modbus master write combining (host)\n");
+  printf("============================================================\n");
+
+  g_modbus_master_config.write_combine = 1;
+  g_modbus_master_config.queue_max_size = MB_ASYNC_QUEUE_SIZE;
+  mb_cache_resize_bus(&g_mb_async[0], 256);
+
+  test_last_value();
+  test_runs();
+  test_off_and_dedup();
+  test_random(rounds);
+
+  return host_test_summary();
+}
@@ -0,0 +1,281 @@
+/**
+ * @file test_modbus_crc.cpp
+ * @brief CRC16 table and zero-copy RTU frame path on host (FEAT-146, BUG-324)
+ *
+ *   1. CRC table: every entry matches a bitwise 0xA001 reference
+ *      (table[1] == 0xC0C1 - BUG-324 had a nibble table pasted in)
+ *   2. Known vectors: "123456789" = 0x4B37, FC03 request 01 03 00 00 00 0A C5 CD
+ *   3. In-place CRC: set_crc/verify_crc on the wire bytes at max frame length
+ *   4. RX path: modbus_rx_read_frame drains a max-length FC16 frame straight
+ *      into ModbusFrame, rejects a flipped bit, and the dispatched response
+ *      carries a valid CRC
+ *   5. Benchmark: ns/frame for RX + CRC + dispatch + response CRC with
+ *      FC03 x 125 and FC16 x 123 (both maximum length)
+ *
+ * Usage: test_modbus_crc [frames per benchmark, default 200000]
+ */
+
+#include "modbus_frame.h"
+#include "modbus_rx.h"
+#include "modbus_fc_dispatch.h"
+#include "registers.h"
+#include "config_struct.h"
+#include "uart_driver.h"
+#include "host_test.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+ * REFERENCE CRC (bitwise, no table)
+ * ============================================================================ */
+
+static uint16_t crc16_bitwise(const uint8_t *data, size_t len) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (int b = 0; b < 8; b++) crc = (crc & 1) ? (uint16_t)((crc >> 1) ^ 0xA001) : (uint16_t)(crc >> 1);
+  }
+  return crc;
+}
+
+/* ============================================================================
+ * FAKE UART1 RX (overrides the weak host_fakes.cpp versions)
+ * ============================================================================ */
+
+static const uint8_t *uart_rx_data = NULL;
+static uint16_t uart_rx_len = 0;
+
+static void uart_rx_load(const uint8_t *data, uint16_t len) {
+  uart_rx_data = data;
+  uart_rx_len = len;
+}
+
+uint16_t uart1_available(void) { return uart_rx_len; }
+
+uint16_t uart1_read_buffer(uint8_t *dst, uint16_t max_len) {
+  uint16_t n = uart_rx_len < max_len ? uart_rx_len : max_len;
+  memcpy(dst, uart_rx_data, n);
+  uart_rx_data += n;
+  uart_rx_len -= n;
+  return n;
+}
+
+/* ============================================================================
+ * FRAME BUILDERS (wire bytes incl. CRC)
+ * ============================================================================ */
+
+static uint16_t wire_append_crc(uint8_t *buf, uint16_t len) {
+  uint16_t crc = crc16_bitwise(buf, len);
+  buf[len] = (uint8_t)(crc & 0xFF);
+  buf[len + 1] = (uint8_t)(crc >> 8);
+  return (uint16_t)(len + 2);
+}
+
+static uint16_t wire_fc03(uint8_t *buf, uint16_t start, uint16_t count) {
+  uint8_t req[] = {1, 0x03, (uint8_t)(start >> 8), (uint8_t)start, (uint8_t)(count >> 8), (uint8_t)count};
+  memcpy(buf, req, sizeof(req));
+  return wire_append_crc(buf, sizeof(req));
+}
+
+static uint16_t wire_fc16(uint8_t *buf, uint16_t start, uint16_t count, uint16_t seed) {
+  uint16_t n = 0;
+  buf[n++] = 1;
+  buf[n++] = 0x10;
+  buf[n++] = (uint8_t)(start >> 8);
+  buf[n++] = (uint8_t)start;
+  buf[n++] = (uint8_t)(count >> 8);
+  buf[n++] = (uint8_t)count;
+  buf[n++] = (uint8_t)(count * 2);
+  for (uint16_t i = 0; i < count; i++) {
+    uint16_t v = (uint16_t)(seed + i * 7);
+    buf[n++] = (uint8_t)(v >> 8);
+    buf[n++] = (uint8_t)v;
+  }
+  return wire_append_crc(buf, n);
+}
+
+static bool response_crc_ok(const ModbusFrame *rsp) {
+  if (rsp->length < 4 || rsp->length > MODBUS_FRAME_MAX) return false;
+  const uint8_t *raw = modbus_frame_raw_const(rsp);
+  uint16_t crc = crc16_bitwise(raw, rsp->length - 2);
+  return raw[rsp->length - 2] == (crc & 0xFF) && raw[rsp->length - 1] == (crc >> 8);
+}
+
+/* ============================================================================
+ * TESTS
+ * ============================================================================ */
+
+static void test_table(void) {
+  host_test_section("Test 1: CRC tabel (BUG-324)");
+
+  // crc16 of the single byte (0xFF ^ i) = 0x00FF ^ table[i]
+  uint16_t table[256];
+  bool all_ok = true;
+  for (int i = 0; i < 256; i++) {
+    uint8_t b = (uint8_t)(0xFF ^ i);
+    table[i] = (uint16_t)(modbus_crc16(&b, 1) ^ 0x00FF);
+    uint16_t ref = crc16_bitwise(&b, 1) ^ 0x00FF;
+    if (table[i] != ref) {
+      if (all_ok) printf("  Første afvigelse: table[%d] = 0x%04X, forventet 0x%04X\n", i, table[i], ref);
+      all_ok = false;
+    }
+  }
+  PASS_IF("table[1] == 0xC0C1", table[1] == 0xC0C1);
+  PASS_IF("table[0xFF] == 0x4040", table[0xFF] == 0x4040);
+  PASS_IF("Alle 256 entries matcher bitwise 0xA001", all_ok);
+}
+
+static void test_vectors(void) {
+  host_test_section("Test 2: Kendte vektorer");
+
+  const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  PASS_IF("CRC-16/MODBUS check \"123456789\" = 0x4B37", modbus_crc16(check, sizeof(check)) == 0x4B37);
+
+  const uint8_t fc03[] = {0x01, 0x03, 0x00, 0x00, 0x00, 0x0A};
+  uint16_t crc = modbus_crc16(fc03, sizeof(fc03));
+  PASS_IF("01 03 00 00 00 0A → C5 CD på wire", (crc & 0xFF) == 0xC5 && (crc >> 8) == 0xCD);
+
+  const uint8_t fc06[] = {0x11, 0x06, 0x00, 0x01, 0x00, 0x03};
+  crc = modbus_crc16(fc06, sizeof(fc06));
+  PASS_IF("11 06 00 01 00 03 → 9A 9B på wire", (crc & 0xFF) == 0x9A && (crc >> 8) == 0x9B);
+
+  // Random buffers up to a max frame: table == bitwise
+  srand(1234);
+  uint8_t buf[MODBUS_FRAME_MAX];
+  bool all_ok = true;
+  for (int n = 0; n < 2000; n++) {
+    uint16_t len = (uint16_t)(1 + rand() % MODBUS_FRAME_MAX);
+    for (uint16_t i = 0; i < len; i++) buf[i] = (uint8_t)rand();
+    all_ok &= modbus_crc16(buf, len) == crc16_bitwise(buf, len);
+  }
+  PASS_IF("2000 tilfældige buffere (1-256 byte) matcher reference", all_ok);
+  PASS_IF("NULL/0 længde giver 0", modbus_crc16(NULL, 4) == 0 && modbus_crc16(buf, 0) == 0);
+}
+
+static void test_in_place(void) {
+  host_test_section("Test 3: CRC in place i ModbusFrame");
+
+  ModbusFrame f;
+  memset(&f, 0xEE, sizeof(f));
+  f.slave_id = 7;
+  f.function_code = 0x03;
+  for (int i = 0; i < MODBUS_FRAME_DATA_MAX; i++) f.data[i] = (uint8_t)(i * 13);
+  f.length = MODBUS_FRAME_MAX;  // 256: CRC lands in data[252..253]
+  modbus_frame_set_crc(&f);
+
+  uint16_t ref = crc16_bitwise(modbus_frame_raw(&f), MODBUS_FRAME_MAX - 2);
+  PASS_IF("crc16 felt == reference (max længde)", f.crc16 == ref);
+  PASS_IF("CRC_LO/CRC_HI skrevet bag payload", f.data[MODBUS_FRAME_DATA_MAX] == (ref & 0xFF) &&
+                                               f.data[MODBUS_FRAME_DATA_MAX + 1] == (ref >> 8));
+  PASS_IF("verify_crc accepterer egen CRC", modbus_frame_verify_crc(&f));
+
+  f.data[100] ^= 0x01;
+  PASS_IF("verify_crc afviser én flippet bit", !modbus_frame_verify_crc(&f));
+  f.data[100] ^= 0x01;
+
+  f.length = MODBUS_FRAME_MAX + 1;
+  PASS_IF("verify_crc afviser længde > 256", !modbus_frame_verify_crc(&f));
+  f.length = 3;
+  PASS_IF("verify_crc afviser længde < 4", !modbus_frame_verify_crc(&f));
+}
+
+static void test_rx_path(void) {
+  host_test_section("Test 4: RX → dispatch → response (zero-copy)");
+
+  uint8_t wire[MODBUS_FRAME_MAX];
+  uint16_t len = wire_fc16(wire, 0, 123, 0x1000);
+  CHECK_EQ(len, 255);
+
+  ModbusFrame req, rsp;
+  memset(&req, 0, sizeof(req));
+  uart_rx_load(wire, len);
+  modbus_rx_state_t st = modbus_rx_read_frame(&req);
+  PASS_IF("FC16 x 123 (255 byte) modtaget som COMPLETE", st == MODBUS_RX_COMPLETE && req.length == 255);
+  PASS_IF("Bytes ligger direkte i ModbusFrame", memcmp(modbus_frame_raw(&req), wire, len) == 0);
+
+  memset(&rsp, 0, sizeof(rsp));
+  bool ok = modbus_dispatch_function_code(&req, &rsp);
+  PASS_IF("FC16 dispatch OK med gyldig response CRC", ok && rsp.function_code == 0x10 && response_crc_ok(&rsp));
+  PASS_IF("HR 0 og HR 122 skrevet", registers_get_holding_register(0) == 0x1000 &&
+                                    registers_get_holding_register(122) == (uint16_t)(0x1000 + 122 * 7));
+
+  len = wire_fc03(wire, 0, 125);
+  uart_rx_load(wire, len);
+  st = modbus_rx_read_frame(&req);
+  memset(&rsp, 0, sizeof(rsp));
+  ok = st == MODBUS_RX_COMPLETE && modbus_dispatch_function_code(&req, &rsp);
+  PASS_IF("FC03 x 125 → 255 byte response med gyldig CRC",
+          ok && rsp.length == 255 && rsp.data[0] == 250 && response_crc_ok(&rsp));
+  PASS_IF("Response læser de skrevne værdier", rsp.data[1] == 0x10 && rsp.data[2] == 0x00);
+
+  len = wire_fc16(wire, 0, 123, 0x2000);
+  wire[60] ^= 0x40;
+  uart_rx_load(wire, len);
+  st = modbus_rx_read_frame(&req);
+  PASS_IF("Flippet bit i payload → CRC_ERROR", st == MODBUS_RX_CRC_ERROR);
+  PASS_IF("Afvist frame skrev intet", registers_get_holding_register(0) == 0x1000);
+}
+
+typedef uint16_t (*wire_builder_t)(uint8_t *buf);
+
+static uint16_t build_fc03_max(uint8_t *buf) { return wire_fc03(buf, 0, 125); }
+static uint16_t build_fc16_max(uint8_t *buf) { return wire_fc16(buf, 0, 123, 0x3000); }
+
+static void bench_frame(const char *name, wire_builder_t build, uint32_t frames) {
+  uint8_t wire[MODBUS_FRAME_MAX];
+  uint16_t len = build(wire);
+  ModbusFrame req, rsp;
+  uint32_t failures = 0;
+
+  uint64_t t0 = host_test_now_ns();
+  for (uint32_t i = 0; i < frames; i++) {
+    uart_rx_load(wire, len);
+    if (modbus_rx_read_frame(&req) != MODBUS_RX_COMPLETE || !modbus_dispatch_function_code(&req, &rsp)) {
+      failures++;
+    }
+    host_test_sink(rsp.crc16);
+  }
+  uint64_t ns = host_test_now_ns() - t0;
+  printf("  %-22s req %3u B, rsp %3u B: %6.0f ns/frame\n", name, len, rsp.length, (double)ns / frames);
+  CHECK_EQ(failures, 0);
+}
+
+static void bench_crc(uint32_t frames) {
+  uint8_t buf[MODBUS_FRAME_MAX - 2];
+  for (size_t i = 0; i < sizeof(buf); i++) buf[i] = (uint8_t)(i * 31);
+  uint64_t t0 = host_test_now_ns();
+  for (uint32_t i = 0; i < frames; i++) {
+    buf[0] = (uint8_t)i;
+    host_test_sink(modbus_crc16(buf, sizeof(buf)));
+  }
+  uint64_t ns = host_test_now_ns() - t0;
+  printf("  %-22s %u B: %6.0f ns/frame (%.2f ns/byte)\n", "modbus_crc16", (unsigned)sizeof(buf),
+         (double)ns / frames, (double)ns / frames / sizeof(buf));
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================ */
+
+int main(int argc, char **argv) {
+  uint32_t frames = (argc > 1) ? (uint32_t)atol(argv[1]) : 200000;
+
+  printf("============================================================\n");
+  printf("  Modbus RTU CRC16 + zero-copy frame path (host)\n");
+  printf("============================================================\n");
+
+  config_struct_create_default();
+  registers_init();
+
+  test_table();
+  test_vectors();
+  test_in_place();
+  test_rx_path();
+
+  host_test_section("Test 5: Benchmark (maks. frame længde)");
+  bench_crc(frames);
+  bench_frame("FC03 x 125 (read)", build_fc03_max, frames);
+  bench_frame("FC16 x 123 (write)", build_fc16_max, frames);
+
+  return host_test_summary();
+}
@@ -0,0 +1,485 @@
+/**
+ * @file test_modbus_fc_ext.cpp
+ * @brief FC22, FC23, FC2B/0E and FC08 through parser, handlers and serializer on host (FEAT-169)
+ *
+ * Links the real Modbus slave stack and Modbus TCP server; requests go in as
+ * ModbusFrame with CRC through modbus_dispatch_function_code:
+ *
+ *   1. FC22: (current AND and) OR (or AND NOT and), echo response, length and
+ *      address exceptions; two threads setting their own bits of one register
+ *      never undo each other (read-modify-write under the register lock)
+ *   2. FC23: the write happens before the read (overlapping ranges return the
+ *      new values), FC03 response layout, nothing is written when either
+ *      range is invalid; a FC16 writer never lands between FC23's write and
+ *      its read-back
+ *   3. FC2B/0E: basic/regular/extended streams, a known object id continues
+ *      the stream, an unknown one restarts the category, individual access;
+ *      with objects too large for one frame the more-follows chain delivers
+ *      every object exactly once, in order, in frames of at most 256 bytes
+ *   4. FC08: echo, counters and clear on the RTU path; over Modbus TCP only
+ *      Return Query Data is served, counter sub-functions → exception 01 and
+ *      leave the RTU counters alone
+ *
+ * Usage: test_modbus_fc_ext [thread iterations, default 20000]
+ * Env:   MBTCP_PORT (default 15021)
+ */
+
+#include "modbus_fc_dispatch.h"
+#include "modbus_fc_diag.h"
+#include "modbus_serializer.h"
+#include "modbus_frame.h"
+#include "modbus_tcp_server.h"
+#include "registers.h"
+#include "config_struct.h"
+#include "constants.h"
+#include "host_test.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+typedef std::vector<uint8_t> bytes_t;
+
+static void put_u16(bytes_t &b, uint16_t v) {
+  b.push_back((uint8_t)(v >> 8));
+  b.push_back((uint8_t)v);
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+  return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+// PDU (FC + data) from slave 1 through the dispatcher
+static bool request(const bytes_t &pdu, ModbusFrame *rsp) {
+  ModbusFrame req;
+  memset(&req, 0, sizeof(req));
+  req.slave_id = 1;
+  req.function_code = pdu[0];
+  memcpy(req.data, pdu.data() + 1, pdu.size() - 1);
+  req.length = (uint16_t)(pdu.size() + 3);
+  modbus_frame_set_crc(&req);
+  memset(rsp, 0, sizeof(*rsp));
+  return modbus_dispatch_function_code(&req, rsp);
+}
+
+// Exception code of a response, 0 if none
+static uint8_t exception_of(const ModbusFrame *rsp) {
+  return (rsp->function_code & 0x80) ? rsp->data[0] : 0;
+}
+
+static bytes_t pdu_mask(uint16_t addr, uint16_t and_mask, uint16_t or_mask) {
+  bytes_t p = {FC_MASK_WRITE_REG};
+  put_u16(p, addr);
+  put_u16(p, and_mask);
+  put_u16(p, or_mask);
+  return p;
+}
+
+static bytes_t pdu_rw(uint16_t rd, uint16_t rd_count, uint16_t wr, const std::vector<uint16_t> &values) {
+  bytes_t p = {FC_READ_WRITE_MULTIPLE_REGS};
+  put_u16(p, rd);
+  put_u16(p, rd_count);
+  put_u16(p, wr);
+  put_u16(p, (uint16_t)values.size());
+  p.push_back((uint8_t)(values.size() * 2));
+  for (uint16_t v : values) put_u16(p, v);
+  return p;
+}
+
+static bytes_t pdu_write_multiple(uint16_t start, const std::vector<uint16_t> &values) {
+  bytes_t p = {FC_WRITE_MULTIPLE_REGS};
+  put_u16(p, start);
+  put_u16(p, (uint16_t)values.size());
+  p.push_back((uint8_t)(values.size() * 2));
+  for (uint16_t v : values) put_u16(p, v);
+  return p;
+}
+
+static bytes_t pdu_device_id(uint8_t code, uint8_t object) {
+  return bytes_t{FC_ENCAPSULATED_INTERFACE, MEI_READ_DEVICE_ID, code, object};
+}
+
+static bytes_t pdu_diag(uint16_t sub, uint16_t data) {
+  bytes_t p = {FC_DIAGNOSTICS};
+  put_u16(p, sub);
+  put_u16(p, data);
+  return p;
+}
+
+/* ============================================================================
+ * TEST 1: FC22 MASK WRITE REGISTER
+ * ============================================================================ */
+
+#define MASK_REG  60
+
+typedef struct {
+  uint8_t bit;
+  uint32_t iterations;
+  uint32_t lost;
+} mask_worker_t;
+
+static void *mask_worker(void *arg) {
+  mask_worker_t *w = (mask_worker_t *)arg;
+  uint16_t bit = (uint16_t)(1u << w->bit);
+  ModbusFrame rsp;
+  for (uint32_t i = 0; i < w->iterations; i++) {
+    bool on = i & 1;
+    request(pdu_mask(MASK_REG, (uint16_t)~bit, on ? bit : 0), &rsp);
+    // Only this thread touches this bit: anything else is a lost update
+    if (((registers_get_holding_register(MASK_REG) & bit) != 0) != on) w->lost++;
+  }
+  return NULL;
+}
+
+static void test_fc22(uint32_t iterations) {
+  host_test_section("Test 1: FC22 Mask Write Register");
+  ModbusFrame rsp;
+  registers_set_holding_register(MASK_REG, 0x1234);
+  bytes_t p = pdu_mask(MASK_REG, 0xF0F2, 0x0025);
+  bool ok = request(p, &rsp);
+  // (0x1234 & 0xF0F2) | (0x0025 & ~0xF0F2) = 0x1030 | 0x0005
+  bool value = registers_get_holding_register(MASK_REG) == 0x1035;
+  bool echo = ok && rsp.function_code == FC_MASK_WRITE_REG && rsp.length == 10 &&
+              memcmp(rsp.data, p.data() + 1, 6) == 0 && modbus_frame_verify_crc(&rsp);
+  CHECK(value);
+  CHECK(echo);
+  PASS_IF("Ny værdi = (aktuel AND and) OR (or AND NOT and), svaret ekko'er requesten", value && echo);
+
+  bytes_t short_pdu(p.begin(), p.end() - 2);
+  request(short_pdu, &rsp);
+  uint8_t ex_len = exception_of(&rsp);
+  request(pdu_mask(40000, 0, 0), &rsp);
+  uint8_t ex_addr = exception_of(&rsp);
+  CHECK_EQ(ex_len, MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+  CHECK_EQ(ex_addr, MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+  PASS_IF("Forkert længde → 03, umappet adresse → 02", ex_len == 3 && ex_addr == 2);
+
+  registers_set_holding_register(MASK_REG, 0);
+  mask_worker_t w[4];
+  pthread_t th[4];
+  for (uint8_t k = 0; k < 4; k++) {
+    w[k] = {(uint8_t)(k * 5), iterations, 0};
+    pthread_create(&th[k], NULL, mask_worker, &w[k]);
+  }
+  uint32_t lost = 0;
+  for (uint8_t k = 0; k < 4; k++) {
+    pthread_join(th[k], NULL);
+    lost += w[k].lost;
+  }
+  // The last iteration (iterations - 1) leaves each bit set iff iterations is even
+  uint16_t expect = 0;
+  for (uint8_t k = 0; k < 4; k++) expect |= ((iterations - 1) & 1) ? (uint16_t)(1u << w[k].bit) : 0;
+  printf("  4 tråde x %u FC22 på HR %u: %u tabte opdateringer\n", iterations, MASK_REG, lost);
+  CHECK_EQ(lost, 0);
+  CHECK_EQ(registers_get_holding_register(MASK_REG), expect);
+  PASS_IF("Samtidige FC22 på samme register mister ingen bits", lost == 0 &&
+          registers_get_holding_register(MASK_REG) == expect);
+}
+
+/* ============================================================================
+ * TEST 2: FC23 READ/WRITE MULTIPLE REGISTERS
+ * ============================================================================ */
+
+#define XCHG_REG  40
+
+static volatile bool xchg_stop = false;
+
+static void *fc16_writer(void *arg) {
+  ModbusFrame rsp;
+  for (uint16_t v = 0; !xchg_stop; v++) request(pdu_write_multiple(XCHG_REG, {0xF000, v}), &rsp);
+  return NULL;
+}
+
+static void test_fc23(uint32_t iterations) {
+  host_test_section("Test 2: FC23 Read/Write Multiple Registers");
+  ModbusFrame rsp;
+  for (uint16_t a = 0; a < 20; a++) registers_set_holding_register(100 + a, (uint16_t)(0x100 + a));
+
+  // Write 105..107, read 100..109: the read sees the new values
+  bool ok = request(pdu_rw(100, 10, 105, {0xAAAA, 0xBBBB, 0xCCCC}), &rsp);
+  bool layout = ok && rsp.function_code == FC_READ_WRITE_MULTIPLE_REGS && rsp.data[0] == 20 &&
+                rsp.length == 2 + 1 + 20 + 2 && modbus_frame_verify_crc(&rsp);
+  bool order = layout;
+  for (uint16_t i = 0; order && i < 10; i++) {
+    uint16_t want = (i >= 5 && i < 8) ? (uint16_t)(0xAAAA + (i - 5) * 0x1111) : (uint16_t)(0x100 + i);
+    order = get_u16(&rsp.data[1 + i * 2]) == want;
+  }
+
+  // Disjoint: read part unaffected, write part stored
+  ok = request(pdu_rw(110, 2, 115, {0x1515}), &rsp);
+  bool disjoint = ok && get_u16(&rsp.data[1]) == 0x10A && registers_get_holding_register(115) == 0x1515;
+  CHECK(layout);
+  CHECK(order);
+  CHECK(disjoint);
+  PASS_IF("Write før read: overlappende område læser de nye værdier, FC03-layout", layout && order && disjoint);
+
+  // Invalid read range: exception 02 and nothing written
+  request(pdu_rw(40000, 1, 116, {0xDEAD}), &rsp);
+  uint8_t ex_rd = exception_of(&rsp);
+  bool untouched = registers_get_holding_register(116) == 0x110;
+  bytes_t bad = pdu_rw(100, 1, 117, {1, 2});
+  bad[9] = 3;  // Byte count != 2 x quantity
+  request(bad, &rsp);
+  uint8_t ex_bc = exception_of(&rsp);
+  request(pdu_rw(100, 1, 117, {}), &rsp);  // Write quantity 0
+  uint8_t ex_qty = exception_of(&rsp);
+  request(pdu_rw(100, 126, 117, {1}), &rsp);  // Read quantity > 125
+  uint8_t ex_rd_qty = exception_of(&rsp);
+  CHECK_EQ(ex_rd, 2);
+  CHECK(untouched);
+  CHECK_EQ(ex_bc, 3);
+  CHECK_EQ(ex_qty, 3);
+  CHECK_EQ(ex_rd_qty, 3);
+  PASS_IF("Ugyldigt read-område → 02 uden write, forkert byte count / antal → 03",
+          ex_rd == 2 && untouched && ex_bc == 3 && ex_qty == 3 && ex_rd_qty == 3);
+
+  // FC23 writes (v, ~v) to 40..41 and reads 40..41 back while FC16 writes (0xF000, n)
+  pthread_t writer;
+  xchg_stop = false;
+  pthread_create(&writer, NULL, fc16_writer, NULL);
+  uint32_t torn = 0, errors = 0;
+  for (uint32_t i = 0; i < iterations; i++) {
+    uint16_t v = (uint16_t)i;
+    if (!request(pdu_rw(XCHG_REG, 2, XCHG_REG, {v, (uint16_t)~v}), &rsp)) {
+      errors++;
+      continue;
+    }
+    if (get_u16(&rsp.data[1]) != v || get_u16(&rsp.data[3]) != (uint16_t)~v) torn++;
+  }
+  xchg_stop = true;
+  pthread_join(writer, NULL);
+  printf("  %u FC23 mod samtidig FC16 writer: %u læste ikke egen write\n", iterations, torn);
+  CHECK_EQ(errors, 0);
+  CHECK_EQ(torn, 0);
+  PASS_IF("FC23 read-back = egen write (én lås om write + read)", errors == 0 && torn == 0);
+}
+
+/* ============================================================================
+ * TEST 3: FC2B / MEI 0x0E READ DEVICE IDENTIFICATION
+ * ============================================================================ */
+
+// Object ids of a stream response, "" if not a valid stream response
+static std::string stream_ids(const ModbusFrame *rsp, uint8_t *more, uint8_t *next) {
+  std::string ids;
+  if (rsp->function_code != FC_ENCAPSULATED_INTERFACE || !modbus_frame_verify_crc(rsp)) return ids;
+  *more = rsp->data[3];
+  *next = rsp->data[4];
+  uint16_t pos = 6;
+  for (uint8_t i = 0; i < rsp->data[5]; i++) {
+    ids += (char)('0' + rsp->data[pos]);
+    pos += 2 + rsp->data[pos + 1];
+  }
+  return ids;
+}
+
+static void test_fc2b() {
+  host_test_section("Test 3: FC2B/0E Read Device Identification");
+  ModbusFrame rsp;
+  uint8_t more = 0, next = 0;
+  strcpy(g_persist_config.hostname, "plant-a");
+
+  request(pdu_device_id(1, 0), &rsp);
+  std::string basic = stream_ids(&rsp, &more, &next);
+  bool basic_ok = basic == "012" && more == 0 && rsp.data[2] == 0x82;
+  request(pdu_device_id(2, 0), &rsp);
+  std::string regular = stream_ids(&rsp, &more, &next);
+  request(pdu_device_id(3, 0), &rsp);
+  std::string extended = stream_ids(&rsp, &more, &next);
+  CHECK(basic_ok);
+  CHECK(regular == "456");
+  CHECK(extended == "456");
+  PASS_IF("Basic 0-2, regular 4-6, extended = regular", basic_ok && regular == "456" && extended == "456");
+
+  request(pdu_device_id(1, 2), &rsp);
+  std::string resume = stream_ids(&rsp, &more, &next);
+  request(pdu_device_id(2, 1), &rsp);  // 0x01 is not a regular object: restart
+  std::string restart = stream_ids(&rsp, &more, &next);
+  request(pdu_device_id(2, 0x80), &rsp);
+  std::string restart_high = stream_ids(&rsp, &more, &next);
+  CHECK(resume == "2");
+  CHECK(restart == "456");
+  CHECK(restart_high == "456");
+  PASS_IF("Kendt objekt fortsætter streamen, ukendt starter kategorien forfra",
+          resume == "2" && restart == "456" && restart_high == "456");
+
+  request(pdu_device_id(4, 6), &rsp);
+  bool single = rsp.function_code == FC_ENCAPSULATED_INTERFACE && rsp.data[5] == 1 && rsp.data[6] == 6 &&
+                rsp.data[7] == 7 && memcmp(&rsp.data[8], "plant-a", 7) == 0;
+  request(pdu_device_id(4, 3), &rsp);
+  uint8_t ex_obj = exception_of(&rsp);
+  request(pdu_device_id(5, 0), &rsp);
+  uint8_t ex_code = exception_of(&rsp);
+  request(bytes_t{FC_ENCAPSULATED_INTERFACE, 0x0D, 1, 0}, &rsp);
+  uint8_t ex_mei = exception_of(&rsp);
+  CHECK(single);
+  CHECK_EQ(ex_obj, 2);
+  CHECK_EQ(ex_code, 3);
+  CHECK_EQ(ex_mei, 1);
+  PASS_IF("Individuel adgang, ukendt objekt → 02, kode 5 → 03, MEI 0x0D → 01",
+          single && ex_obj == 2 && ex_code == 3 && ex_mei == 1);
+
+  // Objects too large for one frame: follow the more-follows chain like a client
+  static char big[3][200];
+  for (uint8_t i = 0; i < 3; i++) {
+    memset(big[i], 'a' + i, sizeof(big[i]) - 1);
+    big[i][sizeof(big[i]) - 1] = 0;
+  }
+  const ModbusDeviceIdObject objects[] = {{0, big[0]}, {1, "x"}, {2, big[1]}, {3, big[2]}, {4, "y"}};
+  const uint8_t count = sizeof(objects) / sizeof(objects[0]);
+  std::string chain;
+  uint8_t first = 0, frames = 0;
+  bool frames_ok = true;
+  do {
+    if (!modbus_serialize_device_id_response(&rsp, 1, 1, 0x82, objects, count, first)) break;
+    frames++;
+    frames_ok &= rsp.length <= MODBUS_FRAME_MAX && rsp.data[5] > 0;
+    chain += stream_ids(&rsp, &more, &next);
+    // Client restarts at next object id; the server maps it back to its index
+    first = count;
+    for (uint8_t i = 0; i < count; i++) {
+      if (objects[i].id == next) first = i;
+    }
+  } while (more == 0xFF && frames < 10);
+  printf("  5 objekter (3 x 199 byte): %u frames, objekter %s\n", frames, chain.c_str());
+  CHECK(chain == "01234");
+  CHECK(frames == 3);
+  CHECK(frames_ok);
+  PASS_IF("More-follows kæde: hvert objekt præcis én gang, i rækkefølge, frames <= 256 byte",
+          chain == "01234" && frames == 3 && frames_ok);
+}
+
+/* ============================================================================
+ * TEST 4: FC08 DIAGNOSTICS (RTU PATH AND MODBUS TCP)
+ * ============================================================================ */
+
+static int client_connect(uint16_t port) {
+  for (int attempt = 0; attempt < 50; attempt++) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in a;
+    memset(&a, 0, sizeof(a));
+    a.sin_family = AF_INET;
+    a.sin_port = htons(port);
+    a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (struct sockaddr *)&a, sizeof(a)) == 0) {
+      int one = 1;
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+      struct timeval tv = {5, 0};
+      setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+      return fd;
+    }
+    close(fd);
+    usleep(20000);  // Server task still binding
+  }
+  return -1;
+}
+
+static bool recv_exact(int fd, uint8_t *buf, size_t n) {
+  size_t got = 0;
+  while (got < n) {
+    ssize_t r = recv(fd, buf + got, n - got, 0);
+    if (r <= 0) return false;
+    got += (size_t)r;
+  }
+  return true;
+}
+
+// One MBAP transaction → response PDU (FC + data), empty on a broken stream
+static bytes_t tcp_transact(int fd, uint16_t tid, const bytes_t &pdu) {
+  bytes_t b;
+  put_u16(b, tid);
+  put_u16(b, 0);
+  put_u16(b, (uint16_t)(pdu.size() + 1));
+  b.push_back(0xFF);
+  b.insert(b.end(), pdu.begin(), pdu.end());
+  if (send(fd, b.data(), b.size(), 0) != (ssize_t)b.size()) return bytes_t();
+  uint8_t h[7];
+  if (!recv_exact(fd, h, sizeof(h)) || get_u16(h) != tid) return bytes_t();
+  bytes_t out(get_u16(&h[4]) - 1);
+  if (!recv_exact(fd, out.data(), out.size())) return bytes_t();
+  return out;
+}
+
+static void test_fc08(uint16_t port) {
+  host_test_section("Test 4: FC08 Diagnostics (RTU og Modbus TCP)");
+  ModbusFrame rsp;
+  ModbusDiagCounters *c = modbus_diag_counters();
+  c->bus_messages = 0x12345;
+  c->bus_comm_errors = 7;
+
+  bytes_t echo = {FC_DIAGNOSTICS, 0, 0, 0xBE, 0xEF, 1, 2};
+  bool rtu_echo = request(echo, &rsp) && rsp.length == 10 && memcmp(rsp.data, echo.data() + 1, 6) == 0;
+  bool rtu_count = request(pdu_diag(DIAG_BUS_MESSAGE_COUNT, 0), &rsp) && get_u16(&rsp.data[2]) == 0x2345;
+  request(pdu_diag(DIAG_BUS_COMM_ERROR_COUNT, 1), &rsp);
+  uint8_t ex_data = exception_of(&rsp);
+  request(pdu_diag(0x0001, 0), &rsp);  // Restart communications: not implemented
+  uint8_t ex_sub = exception_of(&rsp);
+  CHECK(rtu_echo && rtu_count);
+  CHECK_EQ(ex_data, 3);
+  CHECK_EQ(ex_sub, 1);
+  PASS_IF("RTU: echo, tæller (16 bit), data != 0 → 03, ukendt sub-function → 01",
+          rtu_echo && rtu_count && ex_data == 3 && ex_sub == 1);
+
+  ModbusTcpConfig cfg;
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.enabled = 1;
+  cfg.port = port;
+  cfg.max_clients = 1;
+  int fd = (modbus_tcp_server_start(&cfg) == 0) ? client_connect(port) : -1;
+  CHECK(fd >= 0);
+  if (fd < 0) return;
+
+  bytes_t r = tcp_transact(fd, 1, echo);
+  bool tcp_echo = r == echo;
+  uint8_t rejected = 0;
+  for (uint16_t sub = DIAG_CLEAR_COUNTERS; sub <= DIAG_SERVER_NO_RESPONSE_COUNT; sub++) {
+    r = tcp_transact(fd, (uint16_t)(10 + sub), pdu_diag(sub, 0));
+    if (r.size() == 2 && r[0] == (FC_DIAGNOSTICS | 0x80) && r[1] == MODBUS_EXCEPTION_ILLEGAL_FUNCTION) rejected++;
+  }
+  bool counters_kept = c->bus_messages == 0x12345 && c->bus_comm_errors == 7;
+  r = tcp_transact(fd, 30, {FC_READ_HOLDING_REGS, 0, 0, 0, 1});  // Connection still serves other FCs
+  bool alive = r.size() == 4 && r[0] == FC_READ_HOLDING_REGS;
+  close(fd);
+  modbus_tcp_server_stop();
+
+  CHECK(tcp_echo);
+  CHECK_EQ(rejected, 6);
+  CHECK(counters_kept);
+  CHECK(alive);
+  PASS_IF("TCP: echo virker, 0x0A-0x0F → exception 01, RTU-tællerne urørt",
+          tcp_echo && rejected == 6 && counters_kept && alive);
+
+  bool cleared = request(pdu_diag(DIAG_CLEAR_COUNTERS, 0), &rsp) && c->bus_messages == 0 && c->bus_comm_errors == 0;
+  CHECK(cleared);
+  PASS_IF("RTU: 0x0A nulstiller tællerne", cleared);
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================ */
+
+int main(int argc, char **argv) {
+  uint32_t iterations = (argc > 1) ? (uint32_t)atol(argv[1]) : 20000;
+  const char *env_port = getenv("MBTCP_PORT");
+  uint16_t port = env_port ? (uint16_t)atoi(env_port) : 15021;
+  setvbuf(stdout, NULL, _IOLBF, 0);  // Interleave with the server's log lines
+
+  printf("============================================================\n");
+  printf("  Modbus FC22/FC23/FC2B/FC08 (host)\n");
+  printf("============================================================\n");
+
+  config_struct_create_default();
+  registers_init();
+
+  test_fc22(iterations);
+  test_fc23(iterations);
+  test_fc2b();
+  test_fc08(port);
+
+  return host_test_summary();
+}
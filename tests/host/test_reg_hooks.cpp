@@ -0,0 +1,295 @@
+/**
+ * @file test_reg_hooks.cpp
+ * @brief Holding register write-hook index on host (FEAT-168)
+ *
+ * Links the real register store and Modbus slave stack:
+ *
+ *   1. Table slots: the built-in hooks take 3 of REG_HOOK_MAX, installing the
+ *      same handler again reuses its slot, a full table refuses a new
+ *      handler until a removal frees one; ranges outside the flat array fail
+ *   2. Random install/remove sequences against a per-address model: every
+ *      block write calls exactly the hooks of its range, one call per run of
+ *      equal handler, with the written values, after all words are stored;
+ *      plain addresses call nothing
+ *   3. Through the dispatcher: FC16 over hooked runs calls each run once per
+ *      request, FC06/FC22 call one word with the stored value, FC23 calls
+ *      the written run once
+ *   4. Cost of plain writes: ns/word for FC16-sized block writes without
+ *      hooks vs. single-word setters (info)
+ *
+ * Usage: test_reg_hooks [random rounds, default 5000]
+ */
+
+#include "registers.h"
+#include "modbus_fc_dispatch.h"
+#include "modbus_frame.h"
+#include "host_test.h"
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+typedef struct {
+  uint8_t hook;
+  uint16_t addr;
+  std::vector<uint16_t> values;
+  bool stored;                        // Every word of the run was already in the store
+} hook_call_t;
+
+static std::vector<hook_call_t> calls;
+
+template <uint8_t N>
+static void hook(uint16_t addr, const uint16_t *values, uint16_t count) {
+  hook_call_t c = {N, addr, std::vector<uint16_t>(values, values + count), true};
+  for (uint16_t i = 0; i < count; i++) c.stored &= registers_get_holding_register(addr + i) == values[i];
+  calls.push_back(c);
+}
+
+#define HOOKS 9
+static const reg_write_hook_t hooks[HOOKS] = {hook<0>, hook<1>, hook<2>, hook<3>, hook<4>,
+                                              hook<5>, hook<6>, hook<7>, hook<8>};
+
+static bool request(const uint8_t *pdu, uint16_t len, ModbusFrame *rsp) {
+  ModbusFrame req;
+  memset(&req, 0, sizeof(req));
+  req.slave_id = 1;
+  req.function_code = pdu[0];
+  memcpy(req.data, pdu + 1, len - 1);
+  req.length = len + 3;
+  modbus_frame_set_crc(&req);
+  return modbus_dispatch_function_code(&req, rsp);
+}
+
+static void put16(uint8_t *p, uint16_t v) {
+  p[0] = v >> 8;
+  p[1] = v & 0xFF;
+}
+
+/* ============================================================================
+ * TEST 1: TABLE SLOTS
+ * ============================================================================ */
+
+static void test_slots() {
+  host_test_section("Test 1: Handler-tabel");
+  registers_write_hooks_init();
+  bool ok = true;
+  for (uint8_t h = 0; h < REG_HOOK_MAX - 3; h++) ok &= registers_write_hook_install(10 + h * 4, 2, hooks[h]);
+  bool reuse = registers_write_hook_install(60, 3, hooks[0]);  // Same handler: no new slot
+  bool full = !registers_write_hook_install(70, 1, hooks[REG_HOOK_MAX - 3]);
+  CHECK(ok && reuse && full);
+  PASS_IF("3 indbyggede + 5 egne, samme handler genbruger slot, 9. handler afvises", ok && reuse && full);
+
+  registers_write_hook_remove(14, 2);  // Last range of hooks[1]: slot freed
+  bool freed = registers_write_hook_install(70, 1, hooks[REG_HOOK_MAX - 3]);
+  registers_write_hook_remove(10, 2);  // hooks[0] still has 60..62: slot kept
+  bool kept = !registers_write_hook_install(80, 1, hooks[REG_HOOK_MAX - 2]);
+  CHECK(freed && kept);
+  PASS_IF("Remove frigør slot når handleren ikke har flere adresser", freed && kept);
+
+  bool range = !registers_write_hook_install(HOLDING_REGS_SIZE - 1, 2, hooks[0]) &&
+               !registers_write_hook_install(1000, 1, hooks[0]) && !registers_write_hook_install(5, 0, hooks[0]) &&
+               !registers_write_hook_install(5, 1, NULL);
+  CHECK(range);
+  PASS_IF("Områder uden for det flade array, count 0 og NULL afvises", range);
+}
+
+/* ============================================================================
+ * TEST 2: RANDOM INSTALL/REMOVE AGAINST A MODEL
+ * ============================================================================ */
+
+static uint32_t xorshift(uint32_t *s) {
+  *s ^= *s << 13;
+  *s ^= *s >> 17;
+  *s ^= *s << 5;
+  return *s;
+}
+
+static int8_t model[HOLDING_REGS_SIZE];  // Hook number per address, -1 = none
+static bool model_table[HOOKS];          // Handlers holding a table slot
+
+// Slots of handlers no address refers to are released when a slot is needed or on remove
+static void model_compact() {
+  memset(model_table, 0, sizeof(model_table));
+  for (uint16_t a = 0; a < HOLDING_REGS_SIZE; a++)
+    if (model[a] >= 0) model_table[model[a]] = true;
+}
+
+static bool model_install(uint16_t addr, uint16_t count, uint8_t h) {
+  if (!model_table[h]) {
+    model_compact();
+    uint8_t used = 0;
+    for (uint8_t k = 0; k < HOOKS; k++) used += model_table[k];
+    if (used >= REG_HOOK_MAX) return false;
+    model_table[h] = true;
+  }
+  for (uint16_t a = addr; a < addr + count; a++) model[a] = (int8_t)h;
+  return true;
+}
+
+static void test_random(uint32_t rounds) {
+  host_test_section("Test 2: Tilfældige install/remove mod model");
+  registers_write_hook_remove(0, HOLDING_REGS_SIZE);
+  memset(model, -1, sizeof(model));
+  model_compact();
+  uint32_t seed = 0xFEED, bad_install = 0, bad_calls = 0, not_stored = 0, writes = 0, total_calls = 0;
+
+  for (uint32_t round = 0; round < rounds; round++) {
+    uint16_t addr = (uint16_t)(xorshift(&seed) % HOLDING_REGS_SIZE);
+    uint16_t count = (uint16_t)(1 + xorshift(&seed) % 12);
+    if (addr + count > HOLDING_REGS_SIZE) count = HOLDING_REGS_SIZE - addr;
+    uint32_t op = xorshift(&seed) % 4;
+
+    if (op == 0) {
+      registers_write_hook_remove(addr, count);
+      for (uint16_t a = addr; a < addr + count; a++) model[a] = -1;
+      model_compact();
+    } else if (op == 1) {
+      uint8_t h = (uint8_t)(xorshift(&seed) % HOOKS);
+      if (registers_write_hook_install(addr, count, hooks[h]) != model_install(addr, count, h)) bad_install++;
+    }
+
+    // Block write of a random range; each word gets a fresh value
+    uint16_t waddr = (uint16_t)(xorshift(&seed) % HOLDING_REGS_SIZE);
+    uint16_t wcount = (uint16_t)(1 + xorshift(&seed) % 40);
+    if (waddr + wcount > HOLDING_REGS_SIZE) wcount = HOLDING_REGS_SIZE - waddr;
+    uint16_t values[40];
+    for (uint16_t i = 0; i < wcount; i++) values[i] = (uint16_t)xorshift(&seed);
+    calls.clear();
+    if (wcount == 1 && (xorshift(&seed) & 1)) registers_set_holding_register(waddr, values[0]);
+    else registers_set_holding_registers(waddr, values, wcount);
+    writes++;
+
+    // Expected: one call per run of equal hook in the model
+    std::vector<hook_call_t> want;
+    for (uint16_t i = 0; i < wcount;) {
+      int8_t h = model[waddr + i];
+      uint16_t run = 1;
+      while (i + run < wcount && model[waddr + i + run] == h) run++;
+      if (h >= 0) {
+        want.push_back({(uint8_t)h, (uint16_t)(waddr + i), std::vector<uint16_t>(values + i, values + i + run), true});
+      }
+      i += run;
+    }
+    bool same = want.size() == calls.size();
+    for (size_t k = 0; same && k < want.size(); k++) {
+      same = want[k].hook == calls[k].hook && want[k].addr == calls[k].addr && want[k].values == calls[k].values;
+    }
+    for (const hook_call_t &c : calls) not_stored += !c.stored;
+    if (!same) {
+      if (bad_calls < 3) {
+        printf("  runde %u: HR %u x %u: %zu kald, forventet %zu\n", round, waddr, wcount, calls.size(), want.size());
+      }
+      bad_calls++;
+    }
+    total_calls += calls.size();
+  }
+
+  printf("  %u runder, %u writes, %u hook-kald\n", rounds, writes, total_calls);
+  CHECK_EQ(bad_install, 0);
+  CHECK_EQ(bad_calls, 0);
+  CHECK_EQ(not_stored, 0);
+  CHECK(total_calls > 0);
+  PASS_IF("Præcis ét kald pr. løb af samme handler, med de skrevne værdier, efter lagring",
+          bad_install == 0 && bad_calls == 0 && not_stored == 0 && total_calls > 0);
+  registers_write_hook_remove(0, HOLDING_REGS_SIZE);
+}
+
+/* ============================================================================
+ * TEST 3: THROUGH THE DISPATCHER
+ * ============================================================================ */
+
+static void test_fc() {
+  host_test_section("Test 3: FC16/FC06/FC22/FC23 gennem dispatcheren");
+  registers_write_hook_install(20, 4, hooks[1]);
+  registers_write_hook_install(24, 4, hooks[2]);
+  registers_write_hook_install(90, 10, hooks[1]);
+  ModbusFrame rsp;
+
+  // FC16 HR 0..122: runs 20-23 (1), 24-27 (2), 90-99 (1)
+  uint8_t pdu[6 + 2 * 123] = {0x10, 0, 0, 0, 123, 246};
+  for (uint16_t i = 0; i < 123; i++) put16(&pdu[6 + i * 2], (uint16_t)(1000 + i));
+  calls.clear();
+  bool ok = request(pdu, sizeof(pdu), &rsp) && rsp.function_code == 0x10;
+  bool fc16 = ok && calls.size() == 3 && calls[0].hook == 1 && calls[0].addr == 20 && calls[0].values.size() == 4 &&
+              calls[1].hook == 2 && calls[1].addr == 24 && calls[2].hook == 1 && calls[2].addr == 90 &&
+              calls[2].values.size() == 10 && calls[2].values[0] == 1090 && calls[0].stored && calls[2].stored;
+  CHECK(fc16);
+  PASS_IF("FC16 x 123: 3 kald (ét pr. løb), ikke 123", fc16);
+
+  uint8_t fc06[5] = {0x06, 0, 25, 0xAB, 0xCD};
+  calls.clear();
+  ok = request(fc06, sizeof(fc06), &rsp);
+  bool single = ok && calls.size() == 1 && calls[0].hook == 2 && calls[0].addr == 25 && calls[0].values[0] == 0xABCD;
+  uint8_t fc06_plain[5] = {0x06, 0, 50, 0, 1};
+  calls.clear();
+  request(fc06_plain, sizeof(fc06_plain), &rsp);
+  single &= calls.empty();
+  CHECK(single);
+  PASS_IF("FC06: hooket adresse ét kald, almindelig adresse ingen", single);
+
+  // FC22 on HR 21 (= 1021): and 0x00FF, or 0x1200 → 0x1221
+  uint8_t fc22[7] = {0x16, 0, 21, 0x00, 0xFF, 0x12, 0x00};
+  calls.clear();
+  ok = request(fc22, sizeof(fc22), &rsp);
+  bool mask = ok && calls.size() == 1 && calls[0].addr == 21 && calls[0].values[0] == ((1021 & 0x00FF) | 0x1200) &&
+              calls[0].stored;
+  CHECK(mask);
+  PASS_IF("FC22: ét kald med den maskerede værdi", mask);
+
+  // FC23: write HR 22..25 (runs 22-23 hook 1, 24-25 hook 2), read HR 0..1
+  uint8_t fc23[10 + 8] = {0x17, 0, 0, 0, 2, 0, 22, 0, 4, 8};
+  for (uint16_t i = 0; i < 4; i++) put16(&fc23[10 + i * 2], (uint16_t)(0x2300 + i));
+  calls.clear();
+  ok = request(fc23, sizeof(fc23), &rsp) && rsp.function_code == 0x17;
+  bool xchg = ok && calls.size() == 2 && calls[0].addr == 22 && calls[0].values.size() == 2 && calls[1].addr == 24 &&
+              calls[1].values[1] == 0x2303 && calls[0].stored && calls[1].stored;
+  CHECK(xchg);
+  PASS_IF("FC23: ét kald pr. løb i write-delen", xchg);
+  registers_write_hook_remove(0, HOLDING_REGS_SIZE);
+}
+
+/* ============================================================================
+ * TEST 4: PLAIN WRITE COST
+ * ============================================================================ */
+
+static void bench_plain() {
+  host_test_section("Test 4: Almindelige writes (info)");
+  uint16_t values[123];
+  for (uint16_t i = 0; i < 123; i++) values[i] = i;
+  const uint32_t iterations = 20000;
+
+  uint64_t t0 = host_test_now_ns();
+  for (uint32_t n = 0; n < iterations; n++) {
+    values[0] = (uint16_t)n;
+    registers_set_holding_registers(0, values, 123);
+  }
+  uint64_t t1 = host_test_now_ns();
+  for (uint32_t n = 0; n < iterations; n++) {
+    values[0] = (uint16_t)n;
+    for (uint16_t i = 0; i < 123; i++) registers_set_holding_register(i, values[i]);
+  }
+  uint64_t t2 = host_test_now_ns();
+  printf("  Blok-write 123 ord: %.1f ns/ord, enkelt-ord setter: %.1f ns/ord\n",
+         (double)(t1 - t0) / iterations / 123, (double)(t2 - t1) / iterations / 123);
+  CHECK(calls.empty());
+  PASS_IF("Ingen hook-kald uden installerede hooks", calls.empty());
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================ */
+
+int main(int argc, char **argv) {
+  uint32_t rounds = (argc > 1) ? (uint32_t)atol(argv[1]) : 5000;
+
+  printf("============================================================\n");
+  printf("  Holding register write hooks (host)\n");
+  printf("============================================================\n");
+
+  test_slots();
+  test_random(rounds);
+  test_fc();
+  calls.clear();
+  bench_plain();
+
+  return host_test_summary();
+}
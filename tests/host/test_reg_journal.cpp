@@ -0,0 +1,319 @@
+/**
+ * @file test_reg_journal.cpp
+ * @brief Register change journal: dirty bitmaps and ring overrun on host (FEAT-166)
+ *
+ * Builds registers.cpp into this test so the ring and block sequences
+ * (reg_journal, reg_block_seq, reg_bank_base) are reachable:
+ *
+ *   1. Changes in all four banks come out of next_dirty in bank order with
+ *      their current value; unchanged writes are not journaled; repeated
+ *      changes of one address give one dirty bit
+ *   2. A reader exactly REG_JOURNAL_SIZE behind still gets exact bits; one
+ *      more change makes collect fall back to block marks: every changed
+ *      address is dirty, only blocks changed since the cursor are marked,
+ *      the overrun is counted per reader and globally
+ *   3. changed_since works per block and never misses a change
+ *   4. Random change streams, readers collecting at random intervals: the
+ *      dirty set always covers every changed address, and equals it exactly
+ *      when the reader did not overrun
+ *   5. A writer thread changes all banks while a consumer thread collects and
+ *      reads values: after a final collect the consumer's copy equals the
+ *      store (a change is never lost, even between journal and store)
+ *
+ * Usage: test_reg_journal [random rounds, default 2000] [seconds, default 1]
+ */
+
+#include "../../src/registers.cpp"
+
+#include "host_test.h"
+#include <pthread.h>
+#include <unistd.h>
+
+static const uint16_t bank_size[4] = {HOLDING_REGS_SIZE, INPUT_REGS_SIZE, COILS_SIZE * 8, DISCRETE_INPUTS_SIZE * 8};
+
+static void set_value(reg_bank_t bank, uint16_t addr, uint16_t value) {
+  switch (bank) {
+    case REG_BANK_HR:   registers_set_holding_register(addr, value); break;
+    case REG_BANK_IR:   registers_set_input_register(addr, value); break;
+    case REG_BANK_COIL: registers_set_coil(addr, (uint8_t)(value & 1)); break;
+    case REG_BANK_DI:   registers_set_discrete_input(addr, (uint8_t)(value & 1)); break;
+  }
+}
+
+// Change the value for sure (so it is journaled)
+static void change(reg_bank_t bank, uint16_t addr) {
+  uint16_t v = registers_journal_value(bank, addr);
+  set_value(bank, addr, (bank >= REG_BANK_COIL) ? !v : (uint16_t)(v + 1));
+}
+
+static bool is_dirty(const reg_journal_reader_t *r, reg_bank_t bank, uint16_t addr) {
+  uint16_t bit = reg_bank_base[bank] + addr;
+  return (r->dirty[bit / 32] >> (bit % 32)) & 1;
+}
+
+static uint32_t dirty_count(const reg_journal_reader_t *r) {
+  uint32_t n = 0;
+  for (uint16_t w = 0; w < REG_JOURNAL_WORDS / 32; w++) n += __builtin_popcount(r->dirty[w]);
+  return n;
+}
+
+static uint32_t xorshift(uint32_t *s) {
+  *s ^= *s << 13;
+  *s ^= *s >> 17;
+  *s ^= *s << 5;
+  return *s;
+}
+
+static reg_journal_reader_t reader;
+
+/* ============================================================================
+ * TEST 1: BANKS, ORDER AND DEDUP
+ * ============================================================================ */
+
+static void test_banks() {
+  host_test_section("Test 1: Alle banker, rækkefølge og dedup");
+  registers_journal_reader_init(&reader);
+  uint32_t head0 = registers_journal_head();
+
+  registers_set_discrete_input(3, 1);
+  registers_set_coil(7, 1);
+  registers_set_input_register(300, 0xBEEF);
+  for (uint16_t v = 1; v <= 10; v++) registers_set_holding_register(5, v);
+  registers_set_coil(7, 1);                   // Unchanged
+  registers_set_holding_register(5, 10);      // Unchanged
+  CHECK_EQ(registers_journal_head() - head0, 13);
+
+  uint32_t consumed = registers_journal_collect(&reader);
+  CHECK_EQ(consumed, 13);
+  CHECK_EQ(dirty_count(&reader), 4);
+
+  static const struct { reg_bank_t bank; uint16_t addr; uint16_t value; } want[] = {
+    {REG_BANK_HR, 5, 10}, {REG_BANK_IR, 300, 0xBEEF}, {REG_BANK_COIL, 7, 1}, {REG_BANK_DI, 3, 1},
+  };
+  bool order_ok = true;
+  reg_bank_t bank;
+  uint16_t addr;
+  for (uint8_t i = 0; i < 4; i++) {
+    order_ok &= registers_journal_next_dirty(&reader, &bank, &addr);
+    order_ok &= bank == want[i].bank && addr == want[i].addr;
+    order_ok &= registers_journal_value(bank, addr) == want[i].value;
+  }
+  order_ok &= !registers_journal_next_dirty(&reader, &bank, &addr);
+  CHECK(order_ok);
+  CHECK_EQ(registers_journal_collect(&reader), 0);
+  PASS_IF("4 adresser dirty i bank-rækkefølge med aktuel værdi, uændrede writes ikke journalført",
+          consumed == 13 && order_ok);
+}
+
+/* ============================================================================
+ * TEST 2: RING OVERRUN
+ * ============================================================================ */
+
+static void test_overrun() {
+  host_test_section("Test 2: Ring overrun → block marks");
+
+  // Exactly one ring behind: every entry is still there
+  registers_journal_reader_init(&reader);
+  for (uint16_t i = 0; i < REG_JOURNAL_SIZE; i++) change(REG_BANK_IR, (uint16_t)(i % 64));
+  uint32_t overruns0;
+  registers_journal_stats(NULL, &overruns0);
+  registers_journal_collect(&reader);
+  bool exact = reader.overruns == 0 && dirty_count(&reader) == 64;
+  for (uint16_t a = 0; a < 64; a++) exact &= is_dirty(&reader, REG_BANK_IR, a);
+  CHECK(exact);
+  PASS_IF("REG_JOURNAL_SIZE bagud: præcise dirty bits, ingen overrun", exact);
+
+  // Block 2 of HR changes before the cursor: must not be marked by the fallback
+  change(REG_BANK_HR, 2 * REG_SEQ_REGION_SIZE + 3);
+  registers_journal_reader_init(&reader);
+  static const struct { reg_bank_t bank; uint16_t addr; } touched[] = {
+    {REG_BANK_HR, 0}, {REG_BANK_HR, HOLDING_REGS_SIZE - 1}, {REG_BANK_IR, 100},
+    {REG_BANK_COIL, 17}, {REG_BANK_DI, DISCRETE_INPUTS_SIZE * 8 - 1},
+  };
+  for (uint8_t t = 0; t < 5; t++) change(touched[t].bank, touched[t].addr);
+  for (uint16_t i = 0; i < REG_JOURNAL_SIZE; i++) change(REG_BANK_IR, (uint16_t)(400 + i % 16));
+  registers_journal_collect(&reader);
+
+  uint32_t overruns1;
+  registers_journal_stats(NULL, &overruns1);
+  CHECK_EQ(reader.overruns, 1);
+  CHECK_EQ(overruns1 - overruns0, 1);
+  bool covered = true;
+  for (uint8_t t = 0; t < 5; t++) covered &= is_dirty(&reader, touched[t].bank, touched[t].addr);
+  for (uint16_t i = 0; i < 16; i++) covered &= is_dirty(&reader, REG_BANK_IR, (uint16_t)(400 + i));
+  CHECK(covered);
+  // 5 touched blocks + the IR 400 block, whole blocks each
+  CHECK_EQ(dirty_count(&reader), 6 * REG_SEQ_REGION_SIZE);
+  CHECK(!is_dirty(&reader, REG_BANK_HR, 2 * REG_SEQ_REGION_SIZE + 3));
+  PASS_IF("Overrun: alle ændrede adresser dirty, kun blokke ændret efter cursor",
+          reader.overruns == 1 && covered && dirty_count(&reader) == 6 * REG_SEQ_REGION_SIZE &&
+          !is_dirty(&reader, REG_BANK_HR, 2 * REG_SEQ_REGION_SIZE + 3));
+
+  // The reader is back in the ring afterwards
+  change(REG_BANK_HR, 40);
+  memset(reader.dirty, 0, sizeof(reader.dirty));
+  registers_journal_collect(&reader);
+  CHECK_EQ(dirty_count(&reader), 1);
+  CHECK_EQ(reader.overruns, 1);
+  PASS_IF("Efter overrun: præcise bits igen", dirty_count(&reader) == 1 && reader.overruns == 1);
+}
+
+/* ============================================================================
+ * TEST 3: changed_since
+ * ============================================================================ */
+
+static void test_changed_since() {
+  host_test_section("Test 3: registers_journal_changed_since");
+  uint32_t seq = registers_journal_head();
+  bool before = registers_journal_changed_since(REG_BANK_COIL, 100, seq);
+  change(REG_BANK_COIL, 100);
+  bool self = registers_journal_changed_since(REG_BANK_COIL, 100, seq);
+  bool neighbour = registers_journal_changed_since(REG_BANK_COIL, 100 ^ 1, seq);  // Same block
+  bool other = registers_journal_changed_since(REG_BANK_COIL, 100 + REG_SEQ_REGION_SIZE, seq);
+  bool later = registers_journal_changed_since(REG_BANK_COIL, 100, registers_journal_head());
+  CHECK(!before && self && neighbour && !other && !later);
+  PASS_IF("Ændring ses i egen blok, ikke i andre blokke eller efter seq",
+          !before && self && neighbour && !other && !later);
+}
+
+/* ============================================================================
+ * TEST 4: RANDOM STREAMS
+ * ============================================================================ */
+
+#define RANDOM_READERS 3
+
+static void test_random(uint32_t rounds) {
+  host_test_section("Test 4: Tilfældige ændringer, readers med tilfældige intervaller");
+  static reg_journal_reader_t readers[RANDOM_READERS];
+  static bool changed[RANDOM_READERS][REG_JOURNAL_WORDS];
+  bool overrun_since_drain[RANDOM_READERS] = {false};
+  uint32_t seed = 0xBADC0DE;
+  uint32_t missed = 0, extra_exact = 0, drains = 0, overrun_drains = 0;
+
+  for (uint8_t k = 0; k < RANDOM_READERS; k++) registers_journal_reader_init(&readers[k]);
+  memset(changed, 0, sizeof(changed));
+
+  for (uint32_t round = 0; round < rounds; round++) {
+    uint32_t writes = xorshift(&seed) % (REG_JOURNAL_SIZE / 2);
+    for (uint32_t w = 0; w < writes; w++) {
+      reg_bank_t bank = (reg_bank_t)(xorshift(&seed) & 3);
+      uint16_t addr = (uint16_t)(xorshift(&seed) % bank_size[bank]);
+      change(bank, addr);
+      for (uint8_t k = 0; k < RANDOM_READERS; k++) changed[k][reg_bank_base[bank] + addr] = true;
+    }
+    for (uint8_t k = 0; k < RANDOM_READERS; k++) {
+      reg_journal_reader_t *r = &readers[k];
+      if (xorshift(&seed) % (k + 1) != 0) continue;  // Reader k collects every ~(k+1) rounds
+      uint32_t ov = r->overruns;
+      registers_journal_collect(r);
+      overrun_since_drain[k] |= r->overruns != ov;
+      if (xorshift(&seed) & 1) continue;             // Sometimes collect twice before draining
+
+      drains++;
+      if (overrun_since_drain[k]) overrun_drains++;
+      for (uint16_t bit = 0; bit < REG_JOURNAL_WORDS; bit++) {
+        bool dirty = (r->dirty[bit / 32] >> (bit % 32)) & 1;
+        if (changed[k][bit] && !dirty) missed++;
+        if (!changed[k][bit] && dirty && !overrun_since_drain[k]) extra_exact++;
+      }
+      reg_bank_t bank;
+      uint16_t addr;
+      while (registers_journal_next_dirty(r, &bank, &addr)) {
+      }
+      memset(changed[k], 0, sizeof(changed[k]));
+      overrun_since_drain[k] = false;
+    }
+  }
+
+  printf("  %u runder: %u drains, %u med overrun\n", rounds, drains, overrun_drains);
+  CHECK_EQ(missed, 0);
+  CHECK_EQ(extra_exact, 0);
+  CHECK(overrun_drains > 0 && overrun_drains < drains);
+  PASS_IF("Dirty-sættet dækker altid alle ændringer, præcist uden overrun",
+          missed == 0 && extra_exact == 0 && overrun_drains > 0);
+}
+
+/* ============================================================================
+ * TEST 5: CONCURRENT WRITER AND CONSUMER
+ * ============================================================================ */
+
+static volatile bool stop = false;
+
+static void *writer_main(void *arg) {
+  uint32_t seed = 0x5EED;
+  while (!stop) {
+    reg_bank_t bank = (reg_bank_t)(xorshift(&seed) & 3);
+    uint16_t addr = (uint16_t)(xorshift(&seed) % 64);
+    set_value(bank, addr, (uint16_t)xorshift(&seed));
+  }
+  return NULL;
+}
+
+static uint16_t mirror[4][64];
+static uint32_t consumer_updates = 0;
+
+static void consume(reg_journal_reader_t *r) {
+  registers_journal_collect(r);
+  reg_bank_t bank;
+  uint16_t addr;
+  while (registers_journal_next_dirty(r, &bank, &addr)) {
+    if (addr < 64) mirror[bank][addr] = registers_journal_value(bank, addr);
+    consumer_updates++;
+  }
+}
+
+static void *consumer_main(void *arg) {
+  reg_journal_reader_t *r = (reg_journal_reader_t *)arg;
+  while (!stop) {
+    consume(r);
+    usleep(100);
+  }
+  return NULL;
+}
+
+static void test_concurrent(uint32_t seconds) {
+  host_test_section("Test 5: Writer og consumer samtidig");
+  for (uint8_t b = 0; b < 4; b++)
+    for (uint16_t a = 0; a < 64; a++) mirror[b][a] = registers_journal_value((reg_bank_t)b, a);
+  registers_journal_reader_init(&reader);
+
+  pthread_t writer, consumer;
+  pthread_create(&writer, NULL, writer_main, NULL);
+  pthread_create(&consumer, NULL, consumer_main, &reader);
+  sleep(seconds);
+  stop = true;
+  pthread_join(writer, NULL);
+  pthread_join(consumer, NULL);
+  consume(&reader);
+
+  uint32_t diff = 0;
+  for (uint8_t b = 0; b < 4; b++)
+    for (uint16_t a = 0; a < 64; a++) diff += mirror[b][a] != registers_journal_value((reg_bank_t)b, a);
+  uint32_t changes;
+  registers_journal_stats(&changes, NULL);
+  printf("  %u opdateringer læst, %u overruns, %u ændringer i alt\n", consumer_updates, reader.overruns, changes);
+  CHECK(consumer_updates > 0);
+  CHECK_EQ(diff, 0);
+  PASS_IF("Consumerens kopi = registrene efter sidste collect", consumer_updates > 0 && diff == 0);
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================ */
+
+int main(int argc, char **argv) {
+  uint32_t rounds = (argc > 1) ? (uint32_t)atol(argv[1]) : 2000;
+  uint32_t seconds = (argc > 2) ? (uint32_t)atol(argv[2]) : 1;
+
+  printf("============================================================\n");
+  printf("  Register change journal (host)\n");
+  printf("============================================================\n");
+
+  test_banks();
+  test_overrun();
+  test_changed_since();
+  test_random(rounds);
+  test_concurrent(seconds);
+
+  return host_test_summary();
+}
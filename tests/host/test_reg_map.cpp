@@ -0,0 +1,303 @@
+/**
+ * @file test_reg_map.cpp
+ * @brief Sparse register pages: span, storage and FC front ends on host (FEAT-167)
+ *
+ * Links the real register store and Modbus slave stack:
+ *
+ *   1. Flat arrays need no pages: spans stop at the end of HR/IR unless the
+ *      next page is mapped; mapping inside the flat array maps nothing
+ *   2. Mapped pages: span runs across adjacent pages, stops at a gap, is
+ *      clamped at 65535 (no wrap); block writes/snapshots across flat →
+ *      sparse and page → page boundaries; unmapped words read 0, writes dropped
+ *   3. FC03/FC04/FC06/FC16 on mapped addresses; unmapped or crossing out of
+ *      a mapped range → exception 02
+ *   4. registers_*_span against a word-by-word model (page list) for random
+ *      and boundary-biased ranges in both banks
+ *   5. Config declarations and pool exhaustion: map fails, pages mapped so
+ *      far stay, remapping a mapped page costs nothing
+ *
+ * Usage: test_reg_map [random queries, default 200000]
+ */
+
+#include "registers.h"
+#include "config_struct.h"
+#include "modbus_fc_dispatch.h"
+#include "modbus_frame.h"
+#include "host_test.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Dispatch one request PDU from slave 1 → response
+static bool request(const uint8_t *pdu, uint16_t len, ModbusFrame *rsp) {
+  ModbusFrame req;
+  memset(&req, 0, sizeof(req));
+  req.slave_id = 1;
+  req.function_code = pdu[0];
+  memcpy(req.data, pdu + 1, len - 1);
+  req.length = len + 3;
+  modbus_frame_set_crc(&req);
+  memset(rsp, 0, sizeof(*rsp));
+  return modbus_dispatch_function_code(&req, rsp);
+}
+
+static bool read_regs(uint8_t fc, uint16_t addr, uint16_t count, uint16_t *out, uint8_t *exception) {
+  uint8_t pdu[5] = {fc, (uint8_t)(addr >> 8), (uint8_t)addr, (uint8_t)(count >> 8), (uint8_t)count};
+  ModbusFrame rsp;
+  bool ok = request(pdu, sizeof(pdu), &rsp) && rsp.function_code == fc && rsp.data[0] == count * 2;
+  if (exception) *exception = (rsp.function_code & 0x80) ? rsp.data[0] : 0;
+  for (uint16_t i = 0; ok && i < count; i++) out[i] = (uint16_t)(rsp.data[1 + i * 2] << 8 | rsp.data[2 + i * 2]);
+  return ok;
+}
+
+static bool write_regs(uint16_t addr, uint16_t count, const uint16_t *values, uint8_t *exception) {
+  uint8_t pdu[6 + 2 * 123] = {0x10, (uint8_t)(addr >> 8), (uint8_t)addr, 0, (uint8_t)count, (uint8_t)(count * 2)};
+  for (uint16_t i = 0; i < count; i++) {
+    pdu[6 + i * 2] = values[i] >> 8;
+    pdu[7 + i * 2] = values[i] & 0xFF;
+  }
+  ModbusFrame rsp;
+  bool ok = request(pdu, 6 + count * 2, &rsp) && rsp.function_code == 0x10;
+  if (exception) *exception = (rsp.function_code & 0x80) ? rsp.data[0] : 0;
+  return ok;
+}
+
+static uint16_t mapped_pages() {
+  uint16_t mapped;
+  registers_page_stats(&mapped, NULL);
+  return mapped;
+}
+
+/* ============================================================================
+ * TEST 1: FLAT ARRAYS
+ * ============================================================================ */
+
+static void test_flat() {
+  host_test_section("Test 1: Flade arrays");
+  CHECK_EQ(registers_holding_span(0, HOLDING_REGS_SIZE), HOLDING_REGS_SIZE);
+  CHECK_EQ(registers_holding_span(HOLDING_REGS_SIZE - 6, 10), 6);
+  CHECK_EQ(registers_holding_span(HOLDING_REGS_SIZE, 1), 0);
+  CHECK_EQ(registers_input_span(INPUT_REGS_SIZE - 2, 4), 2);
+  CHECK_EQ(registers_input_span(300, 10), 10);
+  CHECK_EQ(registers_holding_span(10, 0), 0);
+  CHECK(registers_page_map(REG_BANK_HR, 0, HOLDING_REGS_SIZE));
+  CHECK(registers_page_map(REG_BANK_IR, 100, INPUT_REGS_SIZE - 100));
+  CHECK(!registers_page_map(REG_BANK_COIL, 1000, 10));
+  CHECK_EQ(mapped_pages(), 0);
+  PASS_IF("Span stopper ved arrayets ende, flade adresser bruger ingen sider", mapped_pages() == 0);
+}
+
+/* ============================================================================
+ * TEST 2: MAPPED PAGES
+ * ============================================================================ */
+
+static void test_pages() {
+  host_test_section("Test 2: Mappede sider");
+  CHECK(registers_page_map(REG_BANK_HR, 1000, 100));                 // Pages 960, 1024, 1088
+  CHECK(registers_page_map(REG_BANK_HR, HOLDING_REGS_SIZE, 1));      // Page 256, adjacent to the flat array
+  CHECK(registers_page_map(REG_BANK_HR, 0xFFFF - 20, 21));           // Last page
+  CHECK(registers_page_map(REG_BANK_IR, 3000, 64));                  // Pages 2944, 3008
+  CHECK_EQ(mapped_pages(), 7);
+
+  uint16_t first[8];
+  uint16_t n = registers_page_list(REG_BANK_HR, first, 8);
+  bool list_ok = n == 5 && first[0] == 256 && first[1] == 960 && first[2] == 1024 && first[3] == 1088 &&
+                 first[4] == 0xFFC0;
+  CHECK(list_ok);
+  PASS_IF("5 HR sider + 2 IR sider, listet stigende", mapped_pages() == 7 && list_ok);
+
+  bool span_ok = registers_holding_span(1000, 100) == 100 && registers_holding_span(960, 192) == 192 &&
+                 registers_holding_span(1000, 200) == 1152 - 1000 && registers_holding_span(959, 2) == 0 &&
+                 registers_holding_span(HOLDING_REGS_SIZE - 6, 30) == 30 &&
+                 registers_holding_span(HOLDING_REGS_SIZE - 6, 100) == 320 - (HOLDING_REGS_SIZE - 6) &&
+                 registers_holding_span(0xFFF0, 100) == 16 && registers_holding_span(0xFFFF, 1) == 1 &&
+                 registers_input_span(2944, 200) == 128;
+  CHECK(span_ok);
+  PASS_IF("Span over nabosider, stop ved hul, klippet ved 65535", span_ok);
+
+  // Block write flat → page 256, and page 960 → 1024
+  uint16_t w[40], r[40];
+  for (uint16_t i = 0; i < 40; i++) w[i] = (uint16_t)(0xA000 + i);
+  registers_set_holding_registers(HOLDING_REGS_SIZE - 20, w, 40);
+  registers_snapshot_holding(HOLDING_REGS_SIZE - 20, 40, r);
+  bool across_flat = memcmp(w, r, sizeof(w)) == 0 && registers_get_holding_register(HOLDING_REGS_SIZE + 19) == w[39];
+  registers_set_holding_registers(1004, w, 40);
+  uint8_t be[80];
+  registers_snapshot_holding_be(1004, 40, be);
+  bool across_page = true;
+  for (uint16_t i = 0; i < 40; i++) across_page &= (uint16_t)(be[i * 2] << 8 | be[i * 2 + 1]) == w[i];
+  CHECK(across_flat);
+  CHECK(across_page);
+  PASS_IF("Blok-write/snapshot over flad → side og side → side", across_flat && across_page);
+
+  // Unmapped: reads 0, writes dropped, mapped neighbours untouched
+  registers_set_holding_register(5000, 77);
+  registers_set_holding_registers(1144, w, 16);      // 1144..1151 mapped, 1152..1159 not
+  registers_snapshot_holding(1144, 16, r);
+  bool unmapped_ok = registers_get_holding_register(5000) == 0 && memcmp(r, w, 8 * sizeof(uint16_t)) == 0;
+  for (uint16_t i = 8; i < 16; i++) unmapped_ok &= r[i] == 0;
+  CHECK(unmapped_ok);
+  PASS_IF("Umappede ord læses som 0, writes tabes", unmapped_ok);
+
+  registers_set_input_register(3010, 0x3010);
+  CHECK_EQ(registers_get_input_register(3010), 0x3010);
+}
+
+/* ============================================================================
+ * TEST 3: FC FRONT ENDS
+ * ============================================================================ */
+
+static void test_fc() {
+  host_test_section("Test 3: FC03/FC04/FC06/FC16 på sparse adresser");
+  uint16_t w[100], r[100];
+  uint8_t ex = 0;
+  for (uint16_t i = 0; i < 100; i++) w[i] = (uint16_t)(i * 7 + 1);
+  bool ok = write_regs(1000, 100, w, &ex) && read_regs(0x03, 1000, 100, r, &ex) && memcmp(w, r, sizeof(w)) == 0;
+  CHECK(ok);
+  PASS_IF("FC16 + FC03 100 ord over sidegrænsen 1024", ok);
+
+  uint8_t fc06[5] = {0x06, 0x03, 0xE8, 0x12, 0x34};  // HR 1000 = 0x1234
+  ModbusFrame rsp;
+  ok = request(fc06, sizeof(fc06), &rsp) && registers_get_holding_register(1000) == 0x1234;
+  registers_set_input_register(3020, 0xCAFE);
+  ok &= read_regs(0x04, 3020, 1, r, &ex) && r[0] == 0xCAFE;
+  CHECK(ok);
+  PASS_IF("FC06 og FC04 på mappede adresser", ok);
+
+  uint8_t ex03 = 0, ex16 = 0, ex06 = 0, ex_cross = 0;
+  read_regs(0x03, 40000, 1, r, &ex03);
+  write_regs(40000, 1, w, &ex16);
+  uint8_t fc06_unmapped[5] = {0x06, 0x9C, 0x40, 0, 1};  // HR 40000
+  request(fc06_unmapped, sizeof(fc06_unmapped), &rsp);
+  ex06 = (rsp.function_code == 0x86) ? rsp.data[0] : 0;
+  read_regs(0x03, 1144, 10, r, &ex_cross);            // Runs out of page 1088
+  CHECK_EQ(ex03, 2);
+  CHECK_EQ(ex16, 2);
+  CHECK_EQ(ex06, 2);
+  CHECK_EQ(ex_cross, 2);
+  PASS_IF("Umappet eller krydser ud af mappet område → exception 02",
+          ex03 == 2 && ex16 == 2 && ex06 == 2 && ex_cross == 2);
+}
+
+/* ============================================================================
+ * TEST 4: SPAN AGAINST A WORD MODEL
+ * ============================================================================ */
+
+static uint32_t xorshift(uint32_t *s) {
+  *s ^= *s << 13;
+  *s ^= *s >> 17;
+  *s ^= *s << 5;
+  return *s;
+}
+
+static bool present[2][0x10000];
+
+static void build_model() {
+  static const uint16_t flat[2] = {HOLDING_REGS_SIZE, INPUT_REGS_SIZE};
+  for (uint8_t b = 0; b < 2; b++) {
+    memset(present[b], 0, sizeof(present[b]));
+    for (uint32_t a = 0; a < flat[b]; a++) present[b][a] = true;
+    uint16_t first[REG_PAGE_POOL_MAX];
+    uint16_t n = registers_page_list((reg_bank_t)b, first, REG_PAGE_POOL_MAX);
+    for (uint16_t p = 0; p < n; p++)
+      for (uint32_t a = first[p]; a < (uint32_t)first[p] + REG_PAGE_WORDS; a++) present[b][a] = true;
+  }
+}
+
+static void test_span_model(uint32_t queries) {
+  host_test_section("Test 4: Span mod ord-model");
+  // A few more pages with gaps between them
+  static const uint16_t extra[] = {2048, 2112, 2240, 30000, 65472 - 64};
+  for (uint8_t i = 0; i < sizeof(extra) / sizeof(extra[0]); i++) registers_page_map(REG_BANK_IR, extra[i], 1);
+  build_model();
+
+  uint32_t seed = 0x1234567, bad = 0;
+  uint16_t page_starts[2][REG_PAGE_POOL_MAX + 2];
+  uint16_t starts[2];
+  for (uint8_t b = 0; b < 2; b++) {
+    starts[b] = registers_page_list((reg_bank_t)b, page_starts[b], REG_PAGE_POOL_MAX);
+    page_starts[b][starts[b]++] = (b == 0) ? HOLDING_REGS_SIZE : INPUT_REGS_SIZE;
+  }
+  for (uint32_t q = 0; q < queries; q++) {
+    uint8_t b = q & 1;
+    uint16_t addr;
+    switch (xorshift(&seed) % 3) {
+      case 0: addr = (uint16_t)xorshift(&seed); break;
+      case 1: {  // Near a page edge or the end of the flat array
+        uint16_t s = page_starts[b][xorshift(&seed) % starts[b]];
+        addr = (uint16_t)(s + (int16_t)(xorshift(&seed) % 9) - 4 + ((xorshift(&seed) & 1) ? REG_PAGE_WORDS : 0));
+        break;
+      }
+      default: addr = (uint16_t)(0xFFFF - xorshift(&seed) % 200); break;
+    }
+    uint16_t count = (uint16_t)(xorshift(&seed) % 300);
+    uint16_t want = 0;
+    while (want < count && (uint32_t)addr + want <= 0xFFFF && present[b][addr + want]) want++;
+    uint16_t got = b ? registers_input_span(addr, count) : registers_holding_span(addr, count);
+    if (got != want) {
+      if (bad < 5) printf("  bank %u addr %u count %u: span %u, model %u\n", b, addr, count, got, want);
+      bad++;
+    }
+  }
+  printf("  %u forespørgsler, %u sider mappet\n", queries, mapped_pages());
+  CHECK_EQ(bad, 0);
+  PASS_IF("registers_*_span = sammenhængende tilstedeværende ord", bad == 0);
+}
+
+/* ============================================================================
+ * TEST 5: CONFIG AND POOL EXHAUSTION
+ * ============================================================================ */
+
+static void test_pool() {
+  host_test_section("Test 5: Config-erklæringer og fuld pool");
+  memset(g_persist_config.reg_pages, 0, sizeof(g_persist_config.reg_pages));
+  g_persist_config.reg_pages[0] = {0, 4000, 10};
+  g_persist_config.reg_pages[1] = {1, 4000, 130};  // 3 pages
+  uint16_t before = mapped_pages();
+  uint8_t failed = registers_page_apply_config();
+  CHECK_EQ(failed, 0);
+  CHECK_EQ(mapped_pages() - before, 4);
+  CHECK_EQ(registers_holding_span(3968, 64), 64);
+  CHECK_EQ(registers_input_span(3968, 192), 192);
+
+  // Remap: no new pages
+  failed = registers_page_apply_config();
+  CHECK_EQ(failed, 0);
+  CHECK_EQ(mapped_pages() - before, 4);
+  PASS_IF("Config-erklæringer mappes, gentagelse koster ingen sider", failed == 0 && mapped_pages() - before == 4);
+
+  // Exhaust the pool from 8192 upwards
+  uint16_t max;
+  registers_page_stats(NULL, &max);
+  uint16_t free_pages = max - mapped_pages();
+  bool ok = registers_page_map(REG_BANK_HR, 8192, (uint16_t)(free_pages * REG_PAGE_WORDS));
+  bool full = !registers_page_map(REG_BANK_HR, 20000, 1);
+  bool kept = registers_holding_span(8192, (uint16_t)(free_pages * REG_PAGE_WORDS)) == free_pages * REG_PAGE_WORDS &&
+              registers_holding_span(1000, 100) == 100;
+  g_persist_config.reg_pages[2] = {0, 21000, 1};
+  failed = registers_page_apply_config();
+  CHECK(ok && full && kept);
+  CHECK_EQ(mapped_pages(), max);
+  CHECK_EQ(failed, 1);
+  PASS_IF("Fuld pool: map fejler, mappede sider bevares, config tæller fejlen",
+          ok && full && kept && mapped_pages() == max && failed == 1);
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================ */
+
+int main(int argc, char **argv) {
+  uint32_t queries = (argc > 1) ? (uint32_t)atol(argv[1]) : 200000;
+
+  printf("============================================================\n");
+  printf("  Sparse register pages (host)\n");
+  printf("============================================================\n");
+
+  test_flat();
+  test_pages();
+  test_fc();
+  test_span_model(queries);
+  test_pool();
+
+  return host_test_summary();
+}
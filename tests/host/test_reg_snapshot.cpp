@@ -0,0 +1,295 @@
+/**
+ * @file test_reg_snapshot.cpp
+ * @brief Seqlock register snapshots: torn-read torture test on host (FEAT-165)
+ *
+ * Builds registers.cpp into this test so the region counters (hr_seq,
+ * ir_seq) and the writer lock are reachable:
+ *
+ *   1. Single thread: snapshot == stored words in native and Modbus byte
+ *      order, out-of-range tail reads 0, no retries without writers
+ *   2. A region counter left odd (writer "in progress") makes the snapshot
+ *      retry REG_SNAPSHOT_MAX_RETRIES times and then copy under the writer
+ *      lock instead of spinning forever
+ *   3. Torture: writer threads store multi-word values that straddle region
+ *      boundaries (4-word HR block, IR pairs, FC23 exchange, FC22 masks and
+ *      single-word setters on the same regions), so every block write nests
+ *      the journal spinlock inside the seqlock writer lock, while a journal
+ *      reader collects concurrently. Reader threads snapshot whole ranges and
+ *      check every multi-word value is whole. Also: no deadlock (bounded
+ *      join), and the journal marked every written address dirty. The same
+ *      check without the seqlock (plain copy) is printed for comparison
+ *
+ * Usage: test_reg_snapshot [seconds, default 2] [readers, default 3]
+ */
+
+#include "../../src/registers.cpp"
+
+#include "host_test.h"
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#define READERS_MAX  8
+
+// Multi-word values under test (all inside the flat arrays)
+#define HR_QUAD      (REG_SEQ_REGION_SIZE - 2)       // HR 14..17: regions 0 and 1
+#define HR_XCHG      (3 * REG_SEQ_REGION_SIZE - 1)   // HR 47..48 via FC23 exchange: regions 2 and 3
+#define HR_MASK      (3 * REG_SEQ_REGION_SIZE + 4)   // HR 52: FC22 mask, shares region 3
+#define HR_SINGLE    (REG_SEQ_REGION_SIZE + 5)       // HR 21: single-word setter in region 1
+#define IR_PAIR_A    (2 * REG_SEQ_REGION_SIZE - 1)   // IR 31..32: regions 1 and 2
+#define IR_PAIR_B    200                             // IR 200..201: one region
+#define HR_SPAN      64
+#define IR_SPAN      (IR_PAIR_B + 2)
+
+/* ============================================================================
+ * TEST 1: SINGLE THREAD
+ * ============================================================================ */
+
+static void test_single() {
+  host_test_section("Test 1: Snapshot uden samtidige writers");
+  uint16_t words[6] = {0x1111, 0x2222, 0x3333, 0x4444, 0x5555, 0x6666};
+  registers_set_holding_registers(HR_QUAD, words, 6);
+  uint32_t retries0, locked0;
+  registers_snapshot_stats(&retries0, &locked0);
+
+  uint16_t native[6];
+  uint8_t be[12];
+  registers_snapshot_holding(HR_QUAD, 6, native);
+  registers_snapshot_holding_be(HR_QUAD, 6, be);
+  bool same = memcmp(native, words, sizeof(words)) == 0;
+  for (uint8_t i = 0; i < 6; i++) same &= be[i * 2] == (words[i] >> 8) && be[i * 2 + 1] == (words[i] & 0xFF);
+  CHECK(same);
+
+  // Last two words past the flat array: read as 0
+  uint16_t tail[4] = {0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF};
+  registers_snapshot_holding(HOLDING_REGS_SIZE - 2, 4, tail);
+  bool tail_ok = tail[0] == holding_regs[HOLDING_REGS_SIZE - 2] && tail[1] == holding_regs[HOLDING_REGS_SIZE - 1] &&
+                 tail[2] == 0 && tail[3] == 0;
+  CHECK(tail_ok);
+
+  uint32_t retries1, locked1;
+  registers_snapshot_stats(&retries1, &locked1);
+  CHECK_EQ(retries1 - retries0, 0);
+  CHECK_EQ(locked1 - locked0, 0);
+  PASS_IF("Native + big-endian kopi, hale efter arrayet = 0, ingen retries",
+          same && tail_ok && retries1 == retries0 && locked1 == locked0);
+}
+
+/* ============================================================================
+ * TEST 2: WRITER STUCK MID-WRITE
+ * ============================================================================ */
+
+static void test_fallback() {
+  host_test_section("Test 2: Ulige tæller → begrænset retry + låst kopi");
+  uint32_t retries0, locked0;
+  registers_snapshot_stats(&retries0, &locked0);
+
+  uint32_t saved = hr_seq[1];
+  hr_seq[1] = saved | 1;  // Region 1 looks like a block write is in progress
+  uint16_t out[4];
+  registers_snapshot_holding(HR_QUAD, 4, out);
+  hr_seq[1] = saved;
+
+  uint32_t retries1, locked1;
+  registers_snapshot_stats(&retries1, &locked1);
+  CHECK_EQ(retries1 - retries0, REG_SNAPSHOT_MAX_RETRIES);
+  CHECK_EQ(locked1 - locked0, 1);
+  CHECK_EQ(out[0], holding_regs[HR_QUAD]);
+  PASS_IF("16 forsøg, derefter kopi under writer-låsen",
+          retries1 - retries0 == REG_SNAPSHOT_MAX_RETRIES && locked1 - locked0 == 1);
+
+  // A snapshot of region 0 alone does not care about region 1
+  registers_snapshot_stats(&retries0, &locked0);
+  hr_seq[1] = saved | 1;
+  registers_snapshot_holding(0, REG_SEQ_REGION_SIZE, out);
+  hr_seq[1] = saved;
+  registers_snapshot_stats(&retries1, &locked1);
+  CHECK_EQ(retries1 - retries0, 0);
+  PASS_IF("Snapshot af region 0 alene påvirkes ikke", retries1 == retries0 && locked1 == locked0);
+}
+
+/* ============================================================================
+ * TEST 3: WRITER/READER TORTURE
+ * ============================================================================ */
+
+static volatile bool stop = false;
+
+static void *writer_quad_main(void *arg) {
+  for (uint16_t v = 0; !stop; v++) {
+    uint16_t w[4] = {v, v, v, v};
+    registers_set_holding_registers(HR_QUAD, w, 4);
+  }
+  return NULL;
+}
+
+static void *writer_ir_main(void *arg) {
+  for (uint16_t v = 0; !stop; v++) {
+    uint16_t a[2] = {v, (uint16_t)~v};
+    uint16_t b[2] = {(uint16_t)(v * 3), (uint16_t)~(v * 3)};
+    registers_set_input_registers(IR_PAIR_A, a, 2);
+    registers_set_input_registers(IR_PAIR_B, b, 2);
+  }
+  return NULL;
+}
+
+static volatile uint32_t xchg_bad = 0;
+
+// FC23 exchange, FC22 mask and single-word setters on the regions the others use
+static void *writer_misc_main(void *arg) {
+  for (uint16_t v = 0; !stop; v++) {
+    uint16_t w[2] = {v, (uint16_t)~v};
+    uint8_t back[4];
+    registers_exchange_holding_be(HR_XCHG, w, 2, HR_XCHG, 2, back);
+    if ((uint16_t)(back[0] << 8 | back[1]) != w[0] || (uint16_t)(back[2] << 8 | back[3]) != w[1]) xchg_bad++;
+    registers_mask_holding_register(HR_MASK, 0xFF00, (uint16_t)(v & 0xFF));
+    registers_set_holding_register(HR_SINGLE, v);
+  }
+  return NULL;
+}
+
+static reg_journal_reader_t journal;
+static volatile uint32_t journal_collects = 0;
+
+static void *journal_main(void *arg) {
+  while (!stop) {
+    if (registers_journal_collect(&journal)) journal_collects++;
+    usleep(200);
+  }
+  return NULL;
+}
+
+typedef struct {
+  uint32_t reads;
+  uint32_t torn;
+} reader_t;
+
+static bool hr_whole(const uint16_t *hr) {
+  const uint16_t *q = &hr[HR_QUAD];
+  return q[0] == q[1] && q[1] == q[2] && q[2] == q[3] && hr[HR_XCHG + 1] == (uint16_t)~hr[HR_XCHG];
+}
+
+static void *reader_main(void *arg) {
+  reader_t *rd = (reader_t *)arg;
+  uint16_t hr[HR_SPAN];
+  uint8_t ir[IR_SPAN * 2];
+  while (!stop) {
+    registers_snapshot_holding(0, HR_SPAN, hr);
+    registers_snapshot_input_be(0, IR_SPAN, ir);
+    bool ok = hr_whole(hr);
+    static const uint16_t pairs[2] = {IR_PAIR_A, IR_PAIR_B};
+    for (uint16_t base : pairs) {
+      uint16_t lo = (uint16_t)(ir[base * 2] << 8 | ir[base * 2 + 1]);
+      uint16_t hi = (uint16_t)(ir[base * 2 + 2] << 8 | ir[base * 2 + 3]);
+      ok &= hi == (uint16_t)~lo;
+    }
+    rd->reads++;
+    if (!ok) rd->torn++;
+  }
+  return NULL;
+}
+
+// Control: the same check on a plain copy of the array (what FC03 did before)
+static void *plain_reader_main(void *arg) {
+  reader_t *rd = (reader_t *)arg;
+  uint16_t hr[HR_SPAN];
+  while (!stop) {
+    for (uint16_t i = 0; i < HR_SPAN; i++) hr[i] = __atomic_load_n(&holding_regs[i], __ATOMIC_RELAXED);
+    rd->reads++;
+    if (!hr_whole(hr)) rd->torn++;
+  }
+  return NULL;
+}
+
+static bool join_by(pthread_t th, const struct timespec *deadline) {
+  return pthread_timedjoin_np(th, NULL, deadline) == 0;
+}
+
+static void test_torture(uint32_t seconds, uint8_t readers) {
+  host_test_section("Test 3: Writers og readers samtidig");
+  uint16_t init[2] = {0, 0xFFFF};
+  registers_set_holding_registers(HR_XCHG, init, 2);
+  registers_set_input_registers(IR_PAIR_A, init, 2);
+  registers_set_input_registers(IR_PAIR_B, init, 2);
+  registers_journal_reader_init(&journal);
+  uint32_t retries0, locked0;
+  registers_snapshot_stats(&retries0, &locked0);
+
+  pthread_t writers[3], journal_th, plain_th, reader_th[READERS_MAX];
+  reader_t rd[READERS_MAX], plain = {0, 0};
+  pthread_create(&writers[0], NULL, writer_quad_main, NULL);
+  pthread_create(&writers[1], NULL, writer_ir_main, NULL);
+  pthread_create(&writers[2], NULL, writer_misc_main, NULL);
+  pthread_create(&journal_th, NULL, journal_main, NULL);
+  pthread_create(&plain_th, NULL, plain_reader_main, &plain);
+  for (uint8_t i = 0; i < readers; i++) {
+    rd[i] = {0, 0};
+    pthread_create(&reader_th[i], NULL, reader_main, &rd[i]);
+  }
+  sleep(seconds);
+  stop = true;
+
+  // A lock-order bug shows up as threads that never return
+  struct timespec deadline;
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_sec += 10;
+  bool joined = true;
+  for (uint8_t i = 0; i < 3; i++) joined &= join_by(writers[i], &deadline);
+  joined &= join_by(journal_th, &deadline) && join_by(plain_th, &deadline);
+  uint32_t reads = 0, torn = 0;
+  for (uint8_t i = 0; i < readers; i++) {
+    joined &= join_by(reader_th[i], &deadline);
+    reads += rd[i].reads;
+    torn += rd[i].torn;
+  }
+  CHECK(joined);
+  PASS_IF("Alle tråde slutter (ingen deadlock mellem seqlock og journal lås)", joined);
+  if (!joined) return;
+
+  uint32_t retries1, locked1;
+  registers_snapshot_stats(&retries1, &locked1);
+  printf("  %u readers, %u s: %u snapshots, revne %u, retries %u, låst kopi %u\n", readers, seconds, reads,
+         torn, retries1 - retries0, locked1 - locked0);
+  printf("  Kontrol uden seqlock: %u kopier, revne %u\n", plain.reads, plain.torn);
+  CHECK(reads > 0);
+  CHECK_EQ(torn, 0);
+  CHECK_EQ(xchg_bad, 0);
+  PASS_IF("Ingen revne 32/64-bit værdier i snapshots", reads > 0 && torn == 0);
+  PASS_IF("FC23 exchange læser præcis det skrevne tilbage", xchg_bad == 0);
+
+  // Every address the writers changed is dirty in the concurrent journal reader
+  registers_journal_collect(&journal);
+  static bool hr_dirty[HOLDING_REGS_SIZE], ir_dirty[INPUT_REGS_SIZE];
+  reg_bank_t bank;
+  uint16_t addr;
+  while (registers_journal_next_dirty(&journal, &bank, &addr)) {
+    if (bank == REG_BANK_HR && addr < HOLDING_REGS_SIZE) hr_dirty[addr] = true;
+    if (bank == REG_BANK_IR && addr < INPUT_REGS_SIZE) ir_dirty[addr] = true;
+  }
+  bool dirty_ok = hr_dirty[HR_XCHG] && hr_dirty[HR_XCHG + 1] && hr_dirty[HR_MASK] && hr_dirty[HR_SINGLE];
+  for (uint8_t i = 0; i < 4; i++) dirty_ok &= hr_dirty[HR_QUAD + i];
+  for (uint8_t i = 0; i < 2; i++) dirty_ok &= ir_dirty[IR_PAIR_A + i] && ir_dirty[IR_PAIR_B + i];
+  printf("  Journal: %u collects, %u overruns\n", journal_collects, journal.overruns);
+  CHECK(journal_collects > 0);
+  CHECK(dirty_ok);
+  PASS_IF("Journal-læser samtidig med writers: alle skrevne adresser dirty", journal_collects > 0 && dirty_ok);
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================ */
+
+int main(int argc, char **argv) {
+  uint32_t seconds = (argc > 1) ? (uint32_t)atol(argv[1]) : 2;
+  uint8_t readers = (argc > 2) ? (uint8_t)atoi(argv[2]) : 3;
+  if (readers < 1 || readers > READERS_MAX) readers = 3;
+
+  printf("============================================================\n");
+  printf("  Register snapshots: seqlock torture (host)\n");
+  printf("============================================================\n");
+
+  test_single();
+  test_fallback();
+  test_torture(seconds, readers);
+
+  return host_test_summary();
+}
@@ -0,0 +1,573 @@
+/**
+ * @file test_st_optimizer.cpp
+ * @brief Bytecode optimizer: same results with and without it (FEAT-151)
+ *
+ * Every program is compiled twice with the real compiler, once as compiled
+ * and once through st_optimizer_run(), and both copies run the same number
+ * of scan cycles. After every cycle the variables must be identical.
+ *
+ *   1. Constant folding: INT results wrap to 16 bit like ADD_INT/MUL_INT
+ *   2. NEG of INT16_MIN is not folded (the VM promotes it to REAL)
+ *   3. Dead stores: only removed inside a basic block, never across a jump
+ *      target or past a read of the variable
+ *   4. INC_VAR fusion for INT and DINT (incl. DINT var + INT literal), with
+ *      16/32-bit wrap over many cycles
+ *   5. A jump target in the middle of a fold/fusion pattern blocks it
+ *      (hand-built bytecode, the compiler never emits this shape)
+ *   6. st_opt_compact relocation: jumps, user function entries and the
+ *      source line map point at the same code after compaction
+ */
+
+#include "st_host.h"
+#include "st_compiler.h"
+#include "registers.h"
+#include "config_struct.h"
+#include "host_test.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define CYCLES 40
+
+/* ============================================================================
+ * HELPERS
+ * ============================================================================ */
+
+typedef struct {
+  st_bytecode_program_t *plain;
+  st_bytecode_program_t *opt;
+  st_optimizer_stats_t stats;
+} opt_pair_t;
+
+static bool is_jump(st_opcode_t op) {
+  return op == ST_OP_JMP || op == ST_OP_JMP_IF_FALSE || op == ST_OP_JMP_IF_TRUE;
+}
+
+static uint16_t count_opcode(const st_bytecode_program_t *bc, st_opcode_t op) {
+  uint16_t n = 0;
+  for (uint16_t i = 0; i < bc->instr_count; i++) {
+    if (bc->instructions[i].opcode == op) n++;
+  }
+  return n;
+}
+
+// Addresses stay inside the program after compaction
+static bool addresses_valid(const st_bytecode_program_t *bc) {
+  for (uint16_t i = 0; i < bc->instr_count; i++) {
+    const st_bytecode_instr_t *instr = &bc->instructions[i];
+    if (is_jump(instr->opcode) && (uint32_t)instr->arg.int_arg >= bc->instr_count) return false;
+  }
+  const st_function_registry_t *reg = bc->func_registry;
+  if (reg) {
+    for (uint8_t f = reg->builtin_count; f < reg->builtin_count + reg->user_count; f++) {
+      if ((uint32_t)reg->functions[f].bytecode_addr + reg->functions[f].bytecode_size > bc->instr_count) {
+        return false;
+      }
+    }
+  }
+  return bc->instr_count > 0 && bc->instructions[bc->instr_count - 1].opcode == ST_OP_HALT;
+}
+
+static bool pair_compile(opt_pair_t *p, const char *source) {
+  memset(p, 0, sizeof(*p));
+  p->plain = st_host_compile(source, false, NULL);
+  p->opt = st_host_compile(source, true, &p->stats);
+  return p->plain && p->opt;
+}
+
+static void pair_free(opt_pair_t *p) {
+  st_host_free(p->plain);
+  st_host_free(p->opt);
+}
+
+/**
+ * Run both copies for `cycles` scan cycles
+ * @return Cycle of the first mismatch (variables or error state), 0 if none
+ */
+// Compare by declared type: a BOOL store only writes bool_val, the rest of
+// the slot is whatever the stack held before (differs once code is folded)
+static bool vars_equal(const st_bytecode_program_t *a, const st_bytecode_program_t *b) {
+  for (uint8_t v = 0; v < a->var_count; v++) {
+    const st_value_t *x = &a->variables[v];
+    const st_value_t *y = &b->variables[v];
+    switch (a->var_types[v]) {
+      case ST_TYPE_BOOL: if (x->bool_val != y->bool_val) return false; break;
+      case ST_TYPE_INT:  if (x->int_val != y->int_val) return false; break;
+      default:           if (x->dint_val != y->dint_val) return false; break;  // DINT/DWORD/REAL bits
+    }
+  }
+  return true;
+}
+
+static uint32_t pair_run(opt_pair_t *p, uint32_t cycles) {
+  st_vm_t vm_plain, vm_opt;
+  st_vm_init(&vm_plain, p->plain);
+  st_vm_init(&vm_opt, p->opt);
+
+  for (uint32_t c = 1; c <= cycles; c++) {
+    bool ok_plain = st_host_cycle(&vm_plain, p->plain, ST_HOST_RUN_FAST);
+    bool ok_opt = st_host_cycle(&vm_opt, p->opt, ST_HOST_RUN_FAST);
+    if (ok_plain != ok_opt || !vars_equal(p->plain, p->opt)) {
+      for (uint8_t v = 0; v < p->plain->var_count; v++) {
+        printf("  cyklus %u: %-8s uopt=0x%08X opt=0x%08X\n", c, p->plain->var_names[v],
+               (unsigned)p->plain->variables[v].dint_val, (unsigned)p->opt->variables[v].dint_val);
+      }
+      return c;
+    }
+  }
+  return 0;
+}
+
+static st_value_t var_value(const st_bytecode_program_t *bc, const char *name) {
+  int idx = st_host_var_index(bc, name);
+  st_value_t v;
+  memset(&v, 0, sizeof(v));
+  if (idx >= 0) v = bc->variables[idx];
+  return v;
+}
+
+static void print_stats(const opt_pair_t *p) {
+  printf("  instr %u -> %u (folded %u, fused %u, dead stores %u, jumps %u, unreachable %u)\n",
+         p->stats.instr_before, p->stats.instr_after, p->stats.folded, p->stats.fused,
+         p->stats.dead_stores, p->stats.jumps_threaded, p->stats.unreachable);
+}
+
+// Hand-built program: instructions are copied to the heap like compiler output
+static st_bytecode_program_t *build_program(const st_bytecode_instr_t *code, uint16_t n,
+                                            const st_datatype_t *types, uint8_t var_count) {
+  st_bytecode_program_t *bc = (st_bytecode_program_t *)calloc(1, sizeof(st_bytecode_program_t));
+  bc->instructions = (st_bytecode_instr_t *)malloc(n * sizeof(st_bytecode_instr_t));
+  memcpy(bc->instructions, code, n * sizeof(st_bytecode_instr_t));
+  bc->instr_count = n;
+  bc->instr_capacity = n;
+  bc->var_count = var_count;
+  for (uint8_t v = 0; v < var_count; v++) {
+    bc->var_types[v] = types[v];
+    snprintf(bc->var_names[v], sizeof(bc->var_names[v]), "v%u", v);
+  }
+  return bc;
+}
+
+static st_bytecode_instr_t op(st_opcode_t opcode, int32_t arg) {
+  st_bytecode_instr_t instr;
+  memset(&instr, 0, sizeof(instr));
+  instr.opcode = opcode;
+  instr.arg.int_arg = arg;
+  return instr;
+}
+
+static st_bytecode_instr_t op_var(st_opcode_t opcode, uint16_t var_index) {
+  st_bytecode_instr_t instr = op(opcode, 0);
+  instr.arg.var_index = var_index;
+  return instr;
+}
+
+// 1-based source line of the first line containing `text`
+static uint16_t source_line(const char *source, const char *text) {
+  const char *at = strstr(source, text);
+  if (!at) return 0;
+  uint16_t line = 1;
+  for (const char *s = source; s < at; s++) {
+    if (*s == '\n') line++;
+  }
+  return line;
+}
+
+/* ============================================================================
+ * TEST 1-2: CONSTANT FOLDING
+ * ============================================================================ */
+
+static const char *fold_source =
+    "PROGRAM t\n"
+    "VAR\n"
+    "  x : INT;\n"
+    "  y : INT;\n"
+    "  z : INT;\n"
+    "  w : INT;\n"
+    "  r : REAL;\n"
+    "  q : REAL;\n"
+    "  b : BOOL;\n"
+    "END_VAR\n"
+    "BEGIN\n"
+    "  x := 32767 + 1;\n"
+    "  y := -32767 - 2;\n"
+    "  z := 200 * 200;\n"
+    "  w := (2 + 3) * 4 - 100 / 7;\n"
+    "  r := -(-32767 - 1);\n"
+    "  q := 1.5 * 4.0 - 0.25;\n"
+    "  b := 3 < 4;\n"
+    "  IF 1 > 2 THEN\n"
+    "    x := 0;\n"
+    "  END_IF;\n"
+    "END_PROGRAM\n";
+
+static void test_folding(void) {
+  host_test_section("Test 1: Konstant-foldning med 16-bit wrap");
+  opt_pair_t p;
+  if (!pair_compile(&p, fold_source)) {
+    PASS_IF("Kompilering", false);
+    return;
+  }
+  print_stats(&p);
+  uint32_t bad = pair_run(&p, 3);
+  PASS_IF("Identiske variabler med/uden optimizer", bad == 0);
+  PASS_IF("Udtryk foldet", p.stats.folded >= 6);
+  CHECK_EQ(var_value(p.opt, "x").int_val, -32768);
+  CHECK_EQ(var_value(p.opt, "y").int_val, 32767);
+  CHECK_EQ(var_value(p.opt, "z").int_val, (int16_t)40000);
+  CHECK(var_value(p.opt, "q").real_val == 5.75f);
+  CHECK(addresses_valid(p.opt));
+
+  host_test_section("Test 2: NEG af INT16_MIN foldes ikke");
+  // -32767 - 1 folds to PUSH_INT -32768; the NEG after it must stay (VM → REAL 32768.0)
+  bool neg_kept = false;
+  for (uint16_t i = 0; i + 1 < p.opt->instr_count; i++) {
+    if (p.opt->instructions[i].opcode == ST_OP_PUSH_INT &&
+        (int16_t)p.opt->instructions[i].arg.int_arg == INT16_MIN &&
+        p.opt->instructions[i + 1].opcode == ST_OP_NEG) {
+      neg_kept = true;
+    }
+  }
+  PASS_IF("PUSH_INT -32768, NEG bevaret", neg_kept);
+  PASS_IF("r = 32768.0 med/uden optimizer",
+          var_value(p.opt, "r").real_val == 32768.0f && var_value(p.plain, "r").real_val == 32768.0f);
+  pair_free(&p);
+}
+
+/* ============================================================================
+ * TEST 3: DEAD STORES
+ * ============================================================================ */
+
+static const char *dead_store_source =
+    "PROGRAM t\n"
+    "VAR\n"
+    "  c : BOOL;\n"
+    "  k : INT;\n"
+    "  x : INT;\n"
+    "  y : INT;\n"
+    "  z : INT;\n"
+    "  w : INT;\n"
+    "  t : INT;\n"
+    "  i : INT;\n"
+    "END_VAR\n"
+    "BEGIN\n"
+    "  c := NOT c;\n"
+    "  w := 1;\n"
+    "  w := w;\n"
+    "  w := 2;\n"
+    "  x := 1;\n"
+    "  IF c THEN\n"
+    "    y := y + x;\n"
+    "  END_IF;\n"
+    "  x := 2;\n"
+    "  k := 0;\n"
+    "  WHILE k < 3 DO\n"
+    "    z := z + x;\n"
+    "    x := k;\n"
+    "    k := k + 1;\n"
+    "  END_WHILE;\n"
+    "  t := 5;\n"
+    "  FOR i := 1 TO 3 DO\n"
+    "    t := t * 2 + i;\n"
+    "    t := t - 1;\n"
+    "  END_FOR;\n"
+    "END_PROGRAM\n";
+
+static void test_dead_stores(void) {
+  host_test_section("Test 3: Dead stores på tværs af jump targets");
+  opt_pair_t p;
+  if (!pair_compile(&p, dead_store_source)) {
+    PASS_IF("Kompilering", false);
+    return;
+  }
+  print_stats(&p);
+  uint32_t bad = pair_run(&p, CYCLES);
+  PASS_IF("Identiske variabler over 40 cykler", bad == 0);
+  PASS_IF("w := 1 / w := w fjernet", p.stats.dead_stores >= 2);
+  // x := 1 is read in the IF branch, x := 2 in the loop: both stores stay
+  CHECK_EQ(var_value(p.opt, "y").int_val, CYCLES / 2);
+  CHECK_EQ(var_value(p.opt, "z").int_val, CYCLES * (2 + 0 + 1));
+  CHECK(addresses_valid(p.opt));
+  pair_free(&p);
+}
+
+/* ============================================================================
+ * TEST 4: INC_VAR FUSION
+ * ============================================================================ */
+
+static const char *inc_source =
+    "PROGRAM t\n"
+    "VAR\n"
+    "  n : INT := 32750;\n"
+    "  m : INT;\n"
+    "  d : DINT := 2147483630;\n"
+    "  e : DINT;\n"
+    "  f : DINT;\n"
+    "  g : INT;\n"
+    "  init : BOOL;\n"
+    "END_VAR\n"
+    "BEGIN\n"
+    "  IF NOT init THEN\n"
+    "    m := -32750;\n"
+    "    e := -d;\n"
+    "    init := TRUE;\n"
+    "  END_IF;\n"
+    "  n := n + 1;\n"
+    "  m := m - 1;\n"
+    "  d := d + 1;\n"
+    "  e := e - 1;\n"
+    "  f := f + 1000;\n"
+    "  f := f - 32767;\n"
+    "  g := g + 300;\n"
+    "END_PROGRAM\n";
+
+static void test_inc_var(void) {
+  host_test_section("Test 4: INC_VAR for INT og DINT (DINT var + INT literal)");
+  opt_pair_t p;
+  if (!pair_compile(&p, inc_source)) {
+    PASS_IF("Kompilering", false);
+    return;
+  }
+  print_stats(&p);
+  uint32_t bad = pair_run(&p, CYCLES);
+  PASS_IF("Identiske variabler over 40 cykler (wrap undervejs)", bad == 0);
+  PASS_IF("7 tildelinger fusioneret til INC_VAR", p.stats.fused == 7 && count_opcode(p.opt, ST_OP_INC_VAR) == 7);
+  PASS_IF("DINT + INT literal: ingen CVT_INT_DINT tilbage", count_opcode(p.opt, ST_OP_CVT_INT_DINT) == 0);
+  CHECK_EQ(var_value(p.opt, "n").int_val, (int16_t)(32750 + CYCLES));
+  CHECK_EQ(var_value(p.opt, "m").int_val, (int16_t)(-32750 - CYCLES));
+  CHECK_EQ(var_value(p.opt, "d").dint_val, (int32_t)(2147483630u + CYCLES));
+  CHECK_EQ(var_value(p.opt, "e").dint_val, (int32_t)((uint32_t)-2147483630 - CYCLES));
+  CHECK_EQ(var_value(p.opt, "f").dint_val, CYCLES * (1000 - 32767));
+  CHECK_EQ(var_value(p.opt, "g").int_val, (int16_t)(CYCLES * 300));
+  pair_free(&p);
+}
+
+/* ============================================================================
+ * TEST 5: JUMP TARGET INSIDE A PATTERN
+ * ============================================================================ */
+
+// Run a hand-built program as compiled and optimized with v0 = FALSE/TRUE
+static bool run_hand_built(const st_bytecode_instr_t *code, uint16_t n, const st_datatype_t *types,
+                           uint8_t var_count, const st_value_t *init, st_optimizer_stats_t *stats) {
+  bool same = true;
+  for (int c = 0; c < 2; c++) {
+    st_bytecode_program_t *plain = build_program(code, n, types, var_count);
+    st_bytecode_program_t *opt = build_program(code, n, types, var_count);
+    memcpy(plain->variables, init, var_count * sizeof(st_value_t));
+    memcpy(opt->variables, init, var_count * sizeof(st_value_t));
+    plain->variables[0].bool_val = opt->variables[0].bool_val = (c == 1);
+    st_optimizer_run(opt, NULL, stats);
+
+    st_vm_t vm_plain, vm_opt;
+    st_vm_init(&vm_plain, plain);
+    st_vm_init(&vm_opt, opt);
+    same &= st_host_cycle(&vm_plain, plain, ST_HOST_RUN_FAST);
+    same &= st_host_cycle(&vm_opt, opt, ST_HOST_RUN_FAST);
+    same &= vars_equal(plain, opt);
+    st_host_free(plain);
+    st_host_free(opt);
+  }
+  return same;
+}
+
+static void test_mid_pattern_target(void) {
+  host_test_section("Test 5: Jump target midt i et mønster");
+  const st_datatype_t types[] = {ST_TYPE_BOOL, ST_TYPE_INT, ST_TYPE_INT};
+  st_value_t init[3];
+  memset(init, 0, sizeof(init));
+  init[1].int_val = 10;   // x
+  init[2].int_val = 100;  // y
+  st_optimizer_stats_t stats;
+
+  // c ? x := y + 1 : x := x + 1 — the TRUE path enters at PUSH_INT 1
+  const st_bytecode_instr_t inc_code[] = {
+    op_var(ST_OP_LOAD_VAR, 0),      // 0
+    op(ST_OP_JMP_IF_FALSE, 4),      // 1
+    op_var(ST_OP_LOAD_VAR, 2),      // 2  y
+    op(ST_OP_JMP, 5),               // 3
+    op_var(ST_OP_LOAD_VAR, 1),      // 4  x  ← fusion pattern start
+    op(ST_OP_PUSH_INT, 1),          // 5     ← jump target
+    op(ST_OP_ADD_INT, 0),           // 6
+    op_var(ST_OP_STORE_VAR, 1),     // 7
+    op(ST_OP_HALT, 0),              // 8
+  };
+  bool same = run_hand_built(inc_code, 9, types, 3, init, &stats);
+  PASS_IF("INC_VAR: ingen fusion over target, samme resultat", same && stats.fused == 0);
+
+  // c ? x := y + 3 : x := 2 + 3 — the TRUE path enters at PUSH_INT 3
+  const st_bytecode_instr_t fold_code[] = {
+    op_var(ST_OP_LOAD_VAR, 0),      // 0
+    op(ST_OP_JMP_IF_FALSE, 4),      // 1
+    op_var(ST_OP_LOAD_VAR, 2),      // 2  y
+    op(ST_OP_JMP, 5),               // 3
+    op(ST_OP_PUSH_INT, 2),          // 4  ← fold pattern start
+    op(ST_OP_PUSH_INT, 3),          // 5  ← jump target
+    op(ST_OP_ADD_INT, 0),           // 6
+    op_var(ST_OP_STORE_VAR, 1),     // 7
+    op(ST_OP_HALT, 0),              // 8
+  };
+  same = run_hand_built(fold_code, 9, types, 3, init, &stats);
+  PASS_IF("Foldning: ingen fold over target, samme resultat", same && stats.folded == 0);
+
+  // x := 1 then a loop head at the second store: x := 1 is not dead
+  const st_bytecode_instr_t store_code[] = {
+    op(ST_OP_PUSH_INT, 1),          // 0
+    op_var(ST_OP_STORE_VAR, 1),     // 1
+    op_var(ST_OP_LOAD_VAR, 0),      // 2
+    op(ST_OP_JMP_IF_TRUE, 7),       // 3
+    op_var(ST_OP_LOAD_VAR, 1),      // 4  reads x := 1
+    op_var(ST_OP_STORE_VAR, 2),     // 5
+    op(ST_OP_HALT, 0),              // 6
+    op(ST_OP_PUSH_INT, 7),          // 7  ← jump target
+    op_var(ST_OP_STORE_VAR, 1),     // 8
+    op(ST_OP_JMP, 4),               // 9
+  };
+  same = run_hand_built(store_code, 10, types, 3, init, &stats);
+  PASS_IF("Dead store: ingen eliminering over jump, samme resultat", same && stats.dead_stores == 0);
+}
+
+/* ============================================================================
+ * TEST 6: COMPACTION / RELOCATION
+ * ============================================================================ */
+
+static const char *compact_source =
+    "PROGRAM t\n"
+    "VAR\n"
+    "  i : INT;\n"
+    "  s : INT;\n"
+    "  x : INT;\n"
+    "  r : REAL;\n"
+    "END_VAR\n"
+    "\n"
+    "FUNCTION F2 : INT\n"
+    "VAR_INPUT\n"
+    "  a : INT;\n"
+    "  b : INT;\n"
+    "END_VAR\n"
+    "BEGIN\n"
+    "  F2 := a * (2 + 3) + b;\n"
+    "END_FUNCTION\n"
+    "\n"
+    "BEGIN\n"
+    "  x := x;\n"
+    "  r := INT_TO_REAL(7 * 3);\n"
+    "  s := 0;\n"
+    "  FOR i := 0 TO 5 DO\n"
+    "    IF i > 2 THEN\n"
+    "      s := F2(i, 2) + s;\n"
+    "    ELSE\n"
+    "      s := s - 1;\n"
+    "    END_IF;\n"
+    "  END_FOR;\n"
+    "END_PROGRAM\n";
+
+// Instruction at `pc` in `bc`, or a HALT sentinel when out of range
+static st_bytecode_instr_t instr_at(const st_bytecode_program_t *bc, uint16_t pc) {
+  return pc < bc->instr_count ? bc->instructions[pc] : op(ST_OP_HALT, -1);
+}
+
+static void test_compact(void) {
+  host_test_section("Test 6: st_opt_compact flytter jumps, funktioner og line map");
+  opt_pair_t p;
+  if (!pair_compile(&p, compact_source)) {
+    PASS_IF("Kompilering", false);
+    return;
+  }
+  st_host_free(p.opt);
+
+  // Compile again without optimizing, then optimize with the compiler's line map
+  p.opt = st_host_compile(compact_source, false, NULL);
+  st_line_map_t before = g_line_map;
+  st_line_map_t after = g_line_map;
+  CHECK(before.valid);
+  st_optimizer_run(p.opt, &after, &p.stats);
+  print_stats(&p);
+
+  uint32_t bad = pair_run(&p, CYCLES);
+  PASS_IF("Identiske variabler med funktion og løkke", bad == 0);
+  PASS_IF("Adresser inden for programmet", addresses_valid(p.opt));
+
+  // Function: entry and size follow the fold of (2 + 3) inside it
+  const st_function_entry_t *fp = &p.plain->func_registry->functions[p.plain->func_registry->builtin_count];
+  const st_function_entry_t *fo = &p.opt->func_registry->functions[p.opt->func_registry->builtin_count];
+  printf("  F2: addr %u size %u -> addr %u size %u\n",
+         fp->bytecode_addr, fp->bytecode_size, fo->bytecode_addr, fo->bytecode_size);
+  CHECK_EQ(fo->bytecode_size, fp->bytecode_size - 2);
+  CHECK(instr_at(p.opt, fo->bytecode_addr).opcode == instr_at(p.plain, fp->bytecode_addr).opcode);
+  PASS_IF("Funktionens sidste instruktion er RETURN",
+          instr_at(p.opt, fo->bytecode_addr + fo->bytecode_size - 1).opcode == ST_OP_RETURN);
+
+  // Line map: removed line → next surviving instruction, kept lines → same instruction
+  uint16_t l_self = source_line(compact_source, "x := x;");
+  uint16_t l_fold = source_line(compact_source, "r := INT_TO_REAL");
+  uint16_t l_keep[] = {
+    source_line(compact_source, "F2 := a"),
+    source_line(compact_source, "s := 0;"),
+    source_line(compact_source, "IF i > 2"),
+    source_line(compact_source, "s := F2"),
+  };
+  uint16_t l_fused = source_line(compact_source, "s := s - 1");
+  PASS_IF("Fjernet linje (x := x) peger på næste linjes kode",
+          after.pc_for_line[l_self] == after.pc_for_line[l_fold] &&
+          instr_at(p.opt, after.pc_for_line[l_fold]).opcode == ST_OP_PUSH_INT &&
+          instr_at(p.opt, after.pc_for_line[l_fold]).arg.int_arg == 21);
+  bool lines_ok = true;
+  for (uint16_t l : l_keep) {
+    st_bytecode_instr_t a = instr_at(p.plain, before.pc_for_line[l]);
+    st_bytecode_instr_t b = instr_at(p.opt, after.pc_for_line[l]);
+    bool same = before.pc_for_line[l] != 0xFFFF && after.pc_for_line[l] < p.opt->instr_count &&
+                a.opcode == b.opcode && (is_jump(a.opcode) || a.arg.int_arg == b.arg.int_arg);
+    if (!same) printf("  linje %u: pc %u -> %u\n", l, before.pc_for_line[l], after.pc_for_line[l]);
+    lines_ok &= same;
+  }
+  PASS_IF("Bevarede linjer peger på samme instruktion", lines_ok);
+  PASS_IF("Fusioneret linje (s := s - 1) peger på INC_VAR",
+          instr_at(p.opt, after.pc_for_line[l_fused]).opcode == ST_OP_INC_VAR);
+
+  // Jumps: nothing is threaded here, so the k-th jump of each program pair up
+  // and must land on the same instruction (the relocated copy of the target)
+  bool jumps_ok = p.stats.jumps_threaded == 0 && p.stats.unreachable == 0;
+  uint16_t jo = 0, jumps = 0;
+  for (uint16_t jp = 0; jumps_ok && jp < p.plain->instr_count; jp++) {
+    const st_bytecode_instr_t *a = &p.plain->instructions[jp];
+    if (!is_jump(a->opcode)) continue;
+    while (jo < p.opt->instr_count && !is_jump(p.opt->instructions[jo].opcode)) jo++;
+    if (jo >= p.opt->instr_count) {
+      jumps_ok = false;
+      break;
+    }
+    const st_bytecode_instr_t *b = &p.opt->instructions[jo++];
+    st_bytecode_instr_t ta = instr_at(p.plain, (uint16_t)a->arg.int_arg);
+    st_bytecode_instr_t tb = instr_at(p.opt, (uint16_t)b->arg.int_arg);
+    // A target that was folded or fused differs; the rest must match exactly
+    bool same = a->opcode == b->opcode &&
+                (ta.opcode != tb.opcode ? tb.opcode == ST_OP_INC_VAR || tb.opcode == ST_OP_PUSH_INT
+                                        : is_jump(ta.opcode) || ta.arg.int_arg == tb.arg.int_arg);
+    if (!same) printf("  jump %u -> %d / %u -> %d\n", jp, a->arg.int_arg, jo - 1, b->arg.int_arg);
+    jumps_ok &= same;
+    jumps++;
+  }
+  printf("  %u jumps sammenlignet\n", jumps);
+  PASS_IF("Jumps lander på det flyttede mål", jumps_ok && jumps > 0);
+  pair_free(&p);
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================ */
+
+int main(void) {
+  printf("============================================================\n");
+  printf("  ST bytecode optimizer: med/uden optimizer (host)\n");
+  printf("============================================================\n");
+
+  config_struct_create_default();
+  registers_init();
+
+  test_folding();
+  test_dead_stores();
+  test_inc_var();
+  test_mid_pattern_target();
+  test_compact();
+
+  return host_test_summary();
+}
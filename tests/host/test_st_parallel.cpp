@@ -0,0 +1,468 @@
+/**
+ * @file test_st_parallel.cpp
+ * @brief Lane grouping and worker barrier for parallel ST execution (FEAT-153)
+ *
+ * Links the real st_logic_parallel.cpp and st_logic_engine.cpp (worker task,
+ * barrier) with programs compiled by the real compiler:
+ *
+ *   1. st_logic_schedule_build: union-find merges programs that share a
+ *      register (also transitively), global groups are pinned to lane 0,
+ *      the rest are balanced on cost, one lane = everything on lane 0
+ *   2. st_logic_deps_collect: var_maps/EXPORT ranges, debugger attached or
+ *      owning the debug VM → global, range table overflow → global
+ *   3. st_logic_bytecode_is_global: MB_* / CNT_* / SAVE pin a program,
+ *      TON/LIMIT superinstructions do not
+ *   4. Engine: the four test_st_parallel.py programs give the same outputs
+ *      serial and parallel, and every worker program has finished when
+ *      st_logic_engine_loop() returns (barrier)
+ *   5. st_logic_release_vm() (program delete over HTTP/CLI) in the middle of a
+ *      scan, with the freed heap reused at once: the VM is only freed at the
+ *      next cycle, the scan finishes with its own variables
+ */
+
+#include "st_logic_parallel.h"
+#include "st_logic_engine.h"
+#include "st_host.h"
+#include "st_builtins.h"
+#include "st_vm.h"
+#include "registers.h"
+#include "config_struct.h"
+#include "constants.h"
+#include "host_time.h"
+#include "host_test.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Engine state lives in st_logic_config.cpp on target; the test owns it here
+static st_logic_engine_state_t engine;
+
+st_logic_program_config_t *st_logic_get_program(st_logic_engine_state_t *state, uint8_t program_id) {
+  if (!state || program_id >= ST_LOGIC_MAX_PROGRAMS) return NULL;
+  return &state->programs[program_id];
+}
+
+st_logic_engine_state_t *st_logic_get_state(void) {
+  return &engine;
+}
+
+uint32_t st_logic_get_period_ms(const st_logic_engine_state_t *state, uint8_t program_id) {
+  return 10;
+}
+
+void ir_pool_write_exports(st_logic_program_config_t *prog) {}
+
+/* ============================================================================
+ * HELPERS
+ * ============================================================================ */
+
+static void deps_active(st_logic_deps_t *d, uint32_t cost_us, bool global) {
+  memset(d, 0, sizeof(*d));
+  d->active = 1;
+  d->cost_us = cost_us;
+  d->global = global ? 1 : 0;
+}
+
+static void map_hr(VariableMapping *m, uint8_t program_id, uint8_t var_index, bool input, uint16_t reg) {
+  memset(m, 0, sizeof(*m));
+  m->source_type = MAPPING_SOURCE_ST_VAR;
+  m->st_program_id = program_id;
+  m->st_var_index = var_index;
+  m->is_input = input ? 1 : 0;
+  m->input_reg = input ? reg : 65535;
+  m->coil_reg = input ? 65535 : reg;
+  m->word_count = 1;
+}
+
+static bool compiled_is_global(const char *source) {
+  st_bytecode_program_t *bc = st_host_compile(source, true, NULL);
+  if (!bc) return false;
+  bool global = st_logic_bytecode_is_global(bc);
+  st_host_free(bc);
+  return global;
+}
+
+/* ============================================================================
+ * TEST 1: PARTITIONING
+ * ============================================================================ */
+
+static void test_schedule(void) {
+  host_test_section("Test 1: st_logic_schedule_build (union-find, lanes)");
+  st_logic_deps_t deps[ST_LOGIC_MAX_PROGRAMS];
+  st_logic_schedule_t s;
+
+  // Four independent programs: four groups, two per lane
+  for (uint8_t i = 0; i < 4; i++) {
+    deps_active(&deps[i], 100, false);
+    st_logic_deps_add_range(&deps[i], ST_LOGIC_RES_HR, 100 + i * 10, 1);
+  }
+  st_logic_schedule_build(deps, 4, ST_LOGIC_LANES, &s);
+  PASS_IF("Uafhængige programmer: 4 grupper, 2+2 på hver lane",
+          s.group_count == 4 && s.lane_programs[0] == 2 && s.lane_programs[1] == 2);
+
+  // 0 and 2 share HR 105 → one group (id = lowest program id), same lane
+  st_logic_deps_add_range(&deps[2], ST_LOGIC_RES_HR, 105, 1);
+  st_logic_deps_add_range(&deps[0], ST_LOGIC_RES_HR, 105, 1);
+  st_logic_schedule_build(deps, 4, ST_LOGIC_LANES, &s);
+  PASS_IF("Delt register: samme gruppe og lane",
+          s.group_count == 3 && s.group[0] == 0 && s.group[2] == 0 && s.lane[0] == s.lane[2]);
+
+  // Chain 1-3 via coil 7 and 3-0 via HR 130: union-find joins all four
+  st_logic_deps_add_range(&deps[1], ST_LOGIC_RES_COIL, 7, 1);
+  st_logic_deps_add_range(&deps[3], ST_LOGIC_RES_COIL, 7, 1);
+  st_logic_deps_add_range(&deps[0], ST_LOGIC_RES_HR, 130, 1);
+  st_logic_schedule_build(deps, 4, ST_LOGIC_LANES, &s);
+  PASS_IF("Transitiv deling (1-3-0-2): én gruppe",
+          s.group_count == 1 && s.group[1] == 0 && s.group[3] == 0 && s.lane_programs[s.lane[0]] == 4);
+
+  // Same address in a different space is not a conflict
+  for (uint8_t i = 0; i < 4; i++) deps_active(&deps[i], 100, false);
+  st_logic_deps_add_range(&deps[0], ST_LOGIC_RES_HR, 50, 1);
+  st_logic_deps_add_range(&deps[1], ST_LOGIC_RES_COIL, 50, 1);
+  st_logic_deps_add_range(&deps[2], ST_LOGIC_RES_IR, 50, 1);
+  st_logic_deps_add_range(&deps[3], ST_LOGIC_RES_DI, 50, 1);
+  st_logic_schedule_build(deps, 4, ST_LOGIC_LANES, &s);
+  PASS_IF("Samme adresse i forskellige rum: ingen konflikt", s.group_count == 4);
+
+  // Global programs share one group on lane 0 even without common registers
+  deps[1].global = 1;
+  deps[3].global = 1;
+  st_logic_schedule_build(deps, 4, ST_LOGIC_LANES, &s);
+  PASS_IF("Globale programmer: samme gruppe, lane 0",
+          s.group[1] == 1 && s.group[3] == 1 && s.lane[1] == 0 && s.lane[3] == 0 && s.group_count == 3);
+  // Lane 0 carries the global group (2 x 101 us) → both free groups go to lane 1
+  PASS_IF("Frie grupper balanceret væk fra lane 0", s.lane[0] == 1 && s.lane[2] == 1);
+
+  // A cheap global program does not drag an expensive independent one along
+  for (uint8_t i = 0; i < 4; i++) deps_active(&deps[i], 10, false);
+  deps[0].global = 1;
+  deps[1].cost_us = 5000;
+  st_logic_schedule_build(deps, 4, ST_LOGIC_LANES, &s);
+  PASS_IF("Dyreste frie gruppe på den letteste lane", s.lane[0] == 0 && s.lane[1] == 1);
+
+  // One lane, inactive slots
+  deps[2].active = 0;
+  st_logic_schedule_build(deps, 4, 1, &s);
+  PASS_IF("1 lane: alt på lane 0, inaktiv = NONE",
+          s.lane[0] == 0 && s.lane[1] == 0 && s.lane[3] == 0 && s.lane[2] == ST_LOGIC_LANE_NONE &&
+          s.group[2] == ST_LOGIC_LANE_NONE && s.lane_programs[0] == 3 && s.lane_programs[1] == 0);
+}
+
+/* ============================================================================
+ * TEST 2: DEPENDENCY SETS
+ * ============================================================================ */
+
+static void test_deps(void) {
+  host_test_section("Test 2: st_logic_deps_collect / add_range");
+  st_logic_deps_t d;
+
+  // Adjacent/overlapping ranges merge, a gap does not
+  memset(&d, 0, sizeof(d));
+  st_logic_deps_add_range(&d, ST_LOGIC_RES_HR, 10, 2);
+  st_logic_deps_add_range(&d, ST_LOGIC_RES_HR, 12, 2);
+  st_logic_deps_add_range(&d, ST_LOGIC_RES_HR, 8, 3);
+  st_logic_deps_add_range(&d, ST_LOGIC_RES_HR, 20, 1);
+  PASS_IF("Ranges flettes (8-13) + separat (20)",
+          d.range_count == 2 && d.ranges[0].start == 8 && d.ranges[0].count == 6);
+
+  static st_logic_engine_state_t state;
+  memset(&state, 0, sizeof(state));
+  for (uint8_t i = 0; i < 2; i++) {
+    state.programs[i].enabled = 1;
+    state.programs[i].compiled = 1;
+    state.programs[i].ir_pool_offset = 65535;
+  }
+  VariableMapping maps[40];
+  map_hr(&maps[0], 0, 0, true, 100);
+  map_hr(&maps[1], 0, 1, false, 200);
+  map_hr(&maps[2], 1, 0, true, 200);  // Reads program 0's output
+  map_hr(&maps[3], 1, 1, false, 201);
+
+  st_logic_deps_t a, b;
+  st_logic_deps_collect(&state, 0, maps, 4, false, &a);
+  st_logic_deps_collect(&state, 1, maps, 4, false, &b);
+  PASS_IF("Bindings: Logic2 input = Logic1 output → konflikt",
+          a.active && !a.global && a.range_count == 2 && st_logic_deps_conflict(&a, &b));
+
+  // EXPORT variables: IR 220 + offset
+  map_hr(&maps[2], 1, 0, true, 101);
+  state.programs[0].ir_pool_offset = 0;
+  state.programs[0].ir_pool_size = 4;
+  state.programs[1].ir_pool_offset = 2;
+  state.programs[1].ir_pool_size = 2;
+  st_logic_deps_collect(&state, 0, maps, 4, false, &a);
+  st_logic_deps_collect(&state, 1, maps, 4, false, &b);
+  PASS_IF("Overlappende EXPORT (IR 220-223 / 222-223) → konflikt", st_logic_deps_conflict(&a, &b));
+  state.programs[1].ir_pool_offset = 4;
+  st_logic_deps_collect(&state, 1, maps, 4, false, &b);
+  PASS_IF("Tilstødende EXPORT → ingen konflikt", !st_logic_deps_conflict(&a, &b));
+
+  // Debugger attached or still owning the shared debug VM → global
+  state.debugger[1].mode = ST_DEBUG_RUN;
+  st_logic_deps_collect(&state, 1, maps, 4, false, &b);
+  CHECK(b.global);
+  state.debugger[1].mode = ST_DEBUG_OFF;
+  state.debugger[1].owns_debug_vm = true;
+  st_logic_deps_collect(&state, 1, maps, 4, false, &a);
+  PASS_IF("Debugger (mode/owns_debug_vm) → global", b.global && a.global);
+  state.debugger[1].owns_debug_vm = false;
+
+  st_logic_deps_collect(&state, 0, maps, 4, true, &a);
+  PASS_IF("Global bytecode → global", a.global);
+
+  // More disjoint ranges than the table holds: unknown footprint → global
+  for (uint8_t i = 0; i < 40; i++) map_hr(&maps[i], 0, i % 32, (i & 1) != 0, (uint16_t)(1000 + i * 3));
+  st_logic_deps_collect(&state, 0, maps, 40, false, &a);
+  PASS_IF("Range-tabel fuld → global", a.global && a.range_count == ST_LOGIC_DEP_MAX_RANGES);
+
+  state.programs[0].enabled = 0;
+  st_logic_deps_collect(&state, 0, maps, 4, false, &a);
+  PASS_IF("Deaktiveret program → inaktiv", !a.active && a.range_count == 0);
+}
+
+/* ============================================================================
+ * TEST 3: GLOBAL BUILTINS
+ * ============================================================================ */
+
+static void test_global_builtins(void) {
+  host_test_section("Test 3: Globale builtins i bytecode");
+  PASS_IF("MB_BUSY() → global", compiled_is_global(
+      "PROGRAM p\nVAR\n  b : BOOL;\nEND_VAR\nBEGIN\n  b := MB_BUSY();\nEND_PROGRAM\n"));
+  PASS_IF("CNT_VALUE() → global", compiled_is_global(
+      "PROGRAM p\nVAR\n  d : DINT;\nEND_VAR\nBEGIN\n  d := CNT_VALUE(1);\nEND_PROGRAM\n"));
+  PASS_IF("SAVE() → global", compiled_is_global(
+      "PROGRAM p\nVAR\n  b : BOOL;\nEND_VAR\nBEGIN\n  b := SAVE(1);\nEND_PROGRAM\n"));
+  PASS_IF("TON/LIMIT/ABS → ikke global", !compiled_is_global(
+      "PROGRAM p\nVAR\n  run : BOOL;\n  q : BOOL;\n  x : INT;\nEND_VAR\nBEGIN\n"
+      "  q := TON(run, T#100ms);\n  x := ABS(LIMIT(0, x + 1, 100));\nEND_PROGRAM\n"));
+
+  // Modbus master builtins sit in two blocks of the enum, around the timers
+  bool all = true;
+  for (uint16_t id = ST_BUILTIN_MB_READ_COIL; id <= ST_BUILTIN_MB_WRITE_HOLDING; id++) {
+    all &= st_logic_builtin_is_global(id);
+  }
+  for (uint16_t id = ST_BUILTIN_MB_READ_HOLDINGS; id <= ST_BUILTIN_CNT_STATUS; id++) {
+    all &= st_logic_builtin_is_global(id);
+  }
+  PASS_IF("Alle MB_* / CNT_* builtins er globale", all);
+  PASS_IF("TON/CTU er ikke globale",
+          !st_logic_builtin_is_global(ST_BUILTIN_TON) && !st_logic_builtin_is_global(ST_BUILTIN_CTU));
+  PASS_IF("ABS/LIMIT er ikke globale",
+          !st_logic_builtin_is_global(ST_BUILTIN_ABS) && !st_logic_builtin_is_global(ST_BUILTIN_LIMIT));
+}
+
+/* ============================================================================
+ * TEST 4: ENGINE (serial vs. parallel, barrier)
+ * ============================================================================ */
+
+// Same programs and bindings as tests/test_st_parallel.py
+typedef struct {
+  const char *source;
+  const char *in_var;
+  uint16_t in_reg;
+  const char *out_var;
+  uint16_t out_reg;
+} parallel_program_t;
+
+static const parallel_program_t programs[] = {
+  {"PROGRAM p1\nVAR\n  a : INT;\n  y : INT;\n  i : INT;\nEND_VAR\nBEGIN\n"
+   "  y := 0;\n  FOR i := 1 TO 20 DO\n    y := (y * 3 + a + i) MOD 10007;\n  END_FOR;\nEND_PROGRAM\n",
+   "a", 100, "y", 200},
+  {"PROGRAM p2\nVAR\n  b : INT;\n  y : INT;\nEND_VAR\nBEGIN\n"
+   "  y := LIMIT(0, b * 2 - 50, 20000);\nEND_PROGRAM\n",
+   "b", 101, "y", 201},
+  {"PROGRAM p3\nVAR\n  c : INT;\n  y : INT;\nEND_VAR\nBEGIN\n"
+   "  y := c MOD 97 + 1;\nEND_PROGRAM\n",
+   "c", 200, "y", 202},
+  {"PROGRAM p4\nVAR\n  d : INT;\n  y : INT;\n  busy : BOOL;\nEND_VAR\nBEGIN\n"
+   "  busy := MB_BUSY();\n  y := d + 1;\nEND_PROGRAM\n",
+   "d", 103, "y", 203},
+};
+
+#define PROGRAM_COUNT (sizeof(programs) / sizeof(programs[0]))
+
+static const uint16_t inputs[][3] = {{0, 0, 0}, {7, 300, 12}, {1234, 55, 999}, {32000, 1, 4}};
+
+static bool engine_load(void) {
+  memset(&engine, 0, sizeof(engine));
+  engine.enabled = 1;
+  engine.execution_interval_ms = 10;
+  g_persist_config.var_map_count = 0;
+
+  for (uint8_t id = 0; id < PROGRAM_COUNT; id++) {
+    st_logic_program_config_t *prog = &engine.programs[id];
+    st_bytecode_program_t *bc = st_host_compile(programs[id].source, true, NULL);
+    if (!bc) return false;
+    prog->bytecode = *bc;  // Takes over instructions/registry/stateful
+    free(bc);
+    snprintf(prog->name, sizeof(prog->name), "Logic%u", id + 1);
+    prog->enabled = 1;
+    prog->compiled = 1;
+    prog->ir_pool_offset = 65535;
+
+    VariableMapping *maps = g_persist_config.var_maps;
+    map_hr(&maps[g_persist_config.var_map_count++], id,
+           (uint8_t)st_host_var_index(&prog->bytecode, programs[id].in_var), true, programs[id].in_reg);
+    map_hr(&maps[g_persist_config.var_map_count++], id,
+           (uint8_t)st_host_var_index(&prog->bytecode, programs[id].out_var), false, programs[id].out_reg);
+  }
+  return true;
+}
+
+// gpio_mapping.cpp around the engine: inputs before, outputs after
+static void engine_io(bool inputs_phase) {
+  for (uint8_t i = 0; i < g_persist_config.var_map_count; i++) {
+    const VariableMapping *m = &g_persist_config.var_maps[i];
+    if ((m->is_input != 0) != inputs_phase) continue;
+    st_value_t *var = &engine.programs[m->st_program_id].bytecode.variables[m->st_var_index];
+    if (inputs_phase) {
+      var->int_val = (int16_t)registers_get_holding_register(m->input_reg);
+    } else {
+      registers_set_holding_register(m->coil_reg, (uint16_t)var->int_val);
+    }
+  }
+}
+
+// One scan: all programs are due every 10 ms on the manual clock
+static bool engine_scan(void) {
+  host_time_advance_us(10000);
+  engine_io(true);
+  bool ok = st_logic_engine_loop(&engine, NULL, NULL);
+  engine_io(false);
+  return ok;
+}
+
+static void run_inputs(uint16_t out[][4], bool *barrier_ok) {
+  for (size_t n = 0; n < sizeof(inputs) / sizeof(inputs[0]); n++) {
+    registers_set_holding_register(100, inputs[n][0]);
+    registers_set_holding_register(101, inputs[n][1]);
+    registers_set_holding_register(103, inputs[n][2]);
+    for (int c = 0; c < 5; c++) {  // Logic3 sees Logic1's output one scan later
+      uint16_t before = engine.programs[0].execution_count;
+      engine_scan();
+      // Barrier: every program (on either lane) has run exactly once more
+      for (uint8_t id = 0; id < PROGRAM_COUNT; id++) {
+        if (engine.programs[id].execution_count != (uint16_t)(before + 1)) *barrier_ok = false;
+      }
+    }
+    for (uint8_t i = 0; i < 4; i++) out[n][i] = registers_get_holding_register(200 + i);
+  }
+}
+
+static void test_engine(void) {
+  host_test_section("Test 4: Engine serial vs. parallel + barrier");
+  if (!engine_load()) {
+    PASS_IF("Kompilering", false);
+    return;
+  }
+
+  uint16_t serial[4][4], parallel[4][4];
+  bool barrier_ok = true;
+
+  st_logic_set_parallel(&engine, false);
+  run_inputs(serial, &barrier_ok);
+  bool all_lane0 = true;
+  for (uint8_t id = 0; id < PROGRAM_COUNT; id++) all_lane0 &= (engine.lane[id] == 0);
+  PASS_IF("parallel:off — alle programmer på lane 0", all_lane0 && engine.parallel_cycles == 0);
+
+  st_logic_set_parallel(&engine, true);
+  run_inputs(parallel, &barrier_ok);
+  printf("  lanes: %u %u %u %u, grupper %u, parallel_cycles %u\n", engine.lane[0], engine.lane[1],
+         engine.lane[2], engine.lane[3], engine.group_count, engine.parallel_cycles);
+  PASS_IF("3 uafhængige grupper", engine.group_count == 3);
+  PASS_IF("Logic1+3 (delt HR 200) på samme lane", engine.lane[0] == engine.lane[2]);
+  PASS_IF("Logic4 (MB_BUSY) låst til lane 0", engine.lane[3] == 0);
+  PASS_IF("Worker lane i brug", engine.parallel_cycles > 0 &&
+          (engine.lane[0] == 1 || engine.lane[1] == 1));
+
+  bool same = memcmp(serial, parallel, sizeof(serial)) == 0;
+  for (size_t n = 0; n < 4; n++) {
+    printf("  input %5u %5u %5u: serial %5u %5u %5u %5u  parallel %5u %5u %5u %5u\n",
+           inputs[n][0], inputs[n][1], inputs[n][2], serial[n][0], serial[n][1], serial[n][2],
+           serial[n][3], parallel[n][0], parallel[n][1], parallel[n][2], parallel[n][3]);
+  }
+  PASS_IF("Output registre identiske serial/parallel", same);
+
+  // Many short scans: a missing barrier shows up as a worker program lagging
+  for (int c = 0; c < 5000; c++) {
+    uint16_t before = engine.programs[0].execution_count;
+    engine_scan();
+    for (uint8_t id = 0; id < PROGRAM_COUNT; id++) {
+      if (engine.programs[id].execution_count != (uint16_t)(before + 1)) barrier_ok = false;
+    }
+  }
+  PASS_IF("Barrier: alle programmer færdige når engine_loop returnerer (5000+ scans)", barrier_ok);
+
+  uint16_t errors = 0;
+  for (uint8_t id = 0; id < PROGRAM_COUNT; id++) errors += engine.programs[id].error_count;
+  PASS_IF("Ingen VM fejl", errors == 0);
+}
+
+/* ============================================================================
+ * TEST 5: VM RELEASE DURING A SCAN
+ * ============================================================================ */
+
+// Logic4 calls MB_BUSY() mid-scan. When armed, this stands in for a program
+// delete on the HTTP/CLI task at that moment: release the slot's VM, and let
+// the heap hand the memory straight to someone else who fills it.
+static volatile bool release_in_scan = false;
+static void *reused[64];
+static uint8_t reused_count = 0;
+
+bool mb_async_is_busy() {
+  if (release_in_scan && reused_count < 64) {
+    st_logic_release_vm(3);
+    void *p = malloc(sizeof(st_vm_t));
+    memset(p, 0xA5, sizeof(st_vm_t));
+    reused[reused_count++] = p;
+  }
+  return false;
+}
+
+static void test_release(void) {
+  host_test_section("Test 5: VM frigivelse midt i en scan");
+  st_logic_set_parallel(&engine, true);
+  engine_scan();  // Inputs unchanged since test 4: outputs are steady
+  uint16_t expect = registers_get_holding_register(203);
+  uint16_t errors_before = engine.programs[3].error_count;
+
+  uint32_t wrong = 0;
+  release_in_scan = true;
+  for (int c = 0; c < 32; c++) {
+    engine_scan();
+    wrong += registers_get_holding_register(203) != expect;
+  }
+  release_in_scan = false;
+  engine_scan();
+  wrong += registers_get_holding_register(203) != expect;
+  for (uint8_t i = 0; i < reused_count; i++) free(reused[i]);
+
+  uint16_t errors = engine.programs[3].error_count - errors_before;
+  printf("  33 scans, %u releases midt i Logic4: %u forkerte outputs, %u VM fejl\n",
+         reused_count, wrong, errors);
+  CHECK_EQ(wrong, 0);
+  CHECK_EQ(errors, 0);
+  PASS_IF("VM frigives først ved næste cyklus: scannen kører færdig på sin egen VM",
+          wrong == 0 && errors == 0);
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================ */
+
+int main(void) {
+  printf("============================================================\n");
+  printf("  ST parallel: lane grupper og worker barrier (host)\n");
+  printf("============================================================\n");
+
+  config_struct_create_default();
+  registers_init();
+  host_time_set_manual(true);
+
+  test_schedule();
+  test_deps();
+  test_global_builtins();
+  test_engine();
+  test_release();
+
+  return host_test_summary();
+}
@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Test: Flere RS485 busser i Modbus master (v7.9.8.14, FEAT-159)
+
+Kontrollerer bus/route konfigurationen via /api/modbus/master/bus:
+
+  GET viser bus 0 + bus 1, max_buses / max_routes og routes
+  Ugyldig bus config og ugyldig route afvises med 400
+  Route til bus 1 vises i GET og bliver slettet igen
+  Reads til en slave routet til en stoppet bus fejler hurtigt (ingen UART)
+  modbus_master_bus_* metrics med label bus="N" findes for alle busser
+
+Bus 1 slås ikke til (kræver uart pins) — testen ændrer kun routes og
+gendanner den oprindelige bus/route konfiguration til sidst.
+
+Kræver Modbus master aktiveret.
+
+Brug:
+  python test_mb_buses.py [ip] [--slave N]
+
+Host-variant uden ESP32 (to busser samtidig over pty, død slave): tests/host/test_mb_buses
+
+Kræver: requests, esp32_fixture.py
+"""
+
+import time
+
+import esp32_fixture as fx
+from esp32_fixture import api, metrics
+
+SLAVE_ID = 1
+ROUTE_ID = 8
+ROUTE_SLAVE = 200
+BASE_ADDR = 4500
+
+
+# === HJÆLPEFUNKTIONER ===
+
+def buses():
+    _, data = api("GET", "/api/modbus/master/bus")
+    return data if isinstance(data, dict) else {}
+
+
+# === MAIN ===
+
+def main():
+    global SLAVE_ID
+    SLAVE_ID = fx.parse_args({"slave": SLAVE_ID})["slave"]
+    state = {}
+
+    def body(t):
+        data = buses()
+        max_buses = data.get("max_buses", 0)
+        bus_list = data.get("buses", [])
+        bus1 = next((b for b in bus_list if b.get("bus") == 1), None)
+        t.check("GET viser max_buses/max_routes", max_buses >= 2 and data.get("max_routes", 0) >= 1,
+                f"max_buses={max_buses} max_routes={data.get('max_routes')}")
+        t.check("GET viser bus 0 og bus 1", len(bus_list) == max_buses and bus1 is not None,
+                f"{len(bus_list)} busser")
+        if bus1 is None:
+            return
+        state["route"] = next((r for r in data.get("routes", []) if r.get("id") == ROUTE_ID), None)
+
+        print("\n--- Validering ---")
+        code, _ = api("POST", "/api/modbus/master/bus", {"bus": 1, "baudrate": 1234})
+        t.check("baudrate=1234 afvises", code == 400, f"HTTP {code}")
+        code, _ = api("POST", "/api/modbus/master/bus", {"bus": 1, "stop_bits": 3})
+        t.check("stop_bits=3 afvises", code == 400, f"HTTP {code}")
+        code, _ = api("POST", "/api/modbus/master/bus", {"bus": max_buses, "enabled": True})
+        t.check(f"bus={max_buses} afvises", code == 400, f"HTTP {code}")
+        code, _ = api("POST", "/api/modbus/master/bus",
+                      {"route": ROUTE_ID, "first_slave": 30, "last_slave": 20, "bus": 1})
+        t.check("Route med last < first afvises", code == 400, f"HTTP {code}")
+        code, _ = api("POST", "/api/modbus/master/bus",
+                      {"route": ROUTE_ID, "first_slave": 20, "last_slave": 30, "bus": max_buses})
+        t.check("Route til ukendt bus afvises", code == 400, f"HTTP {code}")
+
+        print("\n--- Route til bus 1 ---")
+        code, _ = api("POST", "/api/modbus/master/bus",
+                         {"route": ROUTE_ID, "first_slave": ROUTE_SLAVE,
+                          "last_slave": ROUTE_SLAVE + 5, "bus": 1})
+        t.check("Opret route", code == 200, f"HTTP {code}")
+        r = next((r for r in buses().get("routes", []) if r.get("id") == ROUTE_ID), None)
+        t.check("Route vises i GET",
+                r is not None and r.get("first_slave") == ROUTE_SLAVE and r.get("bus") == 1,
+                f"{r}")
+
+        if not bus1.get("running"):
+            start = time.time()
+            code, _ = fx.master_read(ROUTE_SLAVE, BASE_ADDR)
+            elapsed = time.time() - start
+            t.check("Read til stoppet bus blokerer ikke", elapsed < 2.0, f"{elapsed:.2f} s, HTTP {code}")
+
+        print("\n--- Metrics ---")
+        m = metrics()
+        for name in ("modbus_master_bus_up", "modbus_master_bus_queue_depth",
+                     "modbus_master_bus_requests_total", "modbus_master_bus_cache_entries"):
+            found = [k for k in m if k.startswith(name + "{")]
+            t.check(f"{name} for alle busser", len(found) == max_buses, f"{len(found)} linjer")
+        up0 = m.get('modbus_master_bus_up{bus="0"}')
+        t.check("Bus 0 kører", up0 == 1, f"up={up0}")
+
+        print("\n--- Slet route ---")
+        code, _ = api("POST", "/api/modbus/master/bus", {"route": ROUTE_ID, "delete": True})
+        t.check("Slet route", code == 200, f"HTTP {code}")
+        r = next((r for r in buses().get("routes", []) if r.get("id") == ROUTE_ID), None)
+        t.check("Route væk fra GET", r is None, f"{r}")
+
+    def cleanup():
+        if "route" not in state:
+            return
+        original = state["route"]
+        if original:
+            api("POST", "/api/modbus/master/bus",
+                {"route": ROUTE_ID, "first_slave": original["first_slave"],
+                 "last_slave": original["last_slave"], "bus": original["bus"]})
+        else:
+            api("POST", "/api/modbus/master/bus", {"route": ROUTE_ID, "delete": True})
+
+    fx.run("Modbus master — flere RS485 busser", body, cleanup, info=f"slave: {SLAVE_ID}")
+
+
+if __name__ == "__main__":
+    main()
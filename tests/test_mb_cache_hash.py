@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Test: Hash-indekseret Modbus master cache (v7.9.8.10, FEAT-155)
+
+Sætter cache-størrelsen via POST /api/modbus/master {"cache_max_entries": N},
+fylder cachen med reads via /api/modbus/master/rw til flere adresser end
+der er plads til, og kontrollerer via /api/metrics:
+
+  modbus_master_cache_capacity         == N
+  modbus_master_cache_entries          <= N (og == N når fyldt)
+  modbus_master_cache_evictions_total  tæller op når cachen er fuld
+
+Slaven behøver ikke svare — entries oprettes ved kø-indsættelse
+(PENDING → ERROR ved timeout).
+
+En resize mindre end MB_CACHE_RETIRE_GRACE_MS (1 s) efter den forrige
+venter resten af perioden, før de gamle arrays frigives.
+
+Kræver Modbus master aktiveret. Gendanner den oprindelige cache-størrelse.
+
+Brug:
+  python test_mb_cache_hash.py [ip] [--slave N]
+
+Host-variant uden ESP32 (ns/op ved 32/256/1024, resize grace): tests/host/bench_mb_cache
+
+Kræver: requests, esp32_fixture.py
+"""
+
+import time
+
+import esp32_fixture as fx
+from esp32_fixture import api, metrics
+
+SLAVE_ID = 1
+BASE_ADDR = 4000
+SIZES = [32, 256]
+
+
+# === MAIN ===
+
+def main():
+    opts = fx.parse_args({"slave": SLAVE_ID})
+    slave = opts["slave"]
+    original = {}
+
+    def body(t):
+        _, data = api("GET", "/api/modbus/master")
+        cfg = data.get("config", {}) if isinstance(data, dict) else {}
+        original["size"] = cfg.get("cache_max_entries", 32)
+        limit = cfg.get("cache_limit", 256)
+        t.check("GET viser cache_max_entries + cache_limit",
+                "cache_max_entries" in cfg and "cache_limit" in cfg, f"limit={limit}")
+
+        print("\n--- Ugyldig størrelse ---")
+        code, _ = api("POST", "/api/modbus/master", {"cache_max_entries": limit + 1})
+        t.check(f"cache_max_entries={limit + 1} afvises", code == 400, f"HTTP {code}")
+
+        for size in SIZES + ([1024] if limit >= 1024 else []):
+            print(f"\n--- cache_max_entries={size} ---")
+            code, _ = api("POST", "/api/modbus/master", {"cache_max_entries": size})
+            t.check(f"Sæt størrelse {size}", code == 200, f"HTTP {code}")
+            m = metrics()
+            t.check("Kapacitet", m.get("modbus_master_cache_capacity") == size,
+                    f"capacity={m.get('modbus_master_cache_capacity')}")
+            t.check("Cache tømt ved resize", m.get("modbus_master_cache_entries", -1) == 0,
+                    f"entries={m.get('modbus_master_cache_entries')}")
+
+            evict_before = m.get("modbus_master_cache_evictions_total", 0)
+            for i in range(size + 16):
+                fx.master_read(slave, BASE_ADDR + i)
+            time.sleep(0.5)
+            m = metrics()
+            entries = m.get("modbus_master_cache_entries", -1)
+            t.check("Cache fyldt til kapacitet", entries == size, f"entries={entries}")
+            evictions = m.get("modbus_master_cache_evictions_total", 0) - evict_before
+            t.check("LRU evictions ved overløb", evictions > 0, f"+{evictions:.0f}")
+
+    def cleanup():
+        if "size" in original:
+            api("POST", "/api/modbus/master", {"cache_max_entries": original["size"]})
+
+    fx.run("Modbus master cache — hash indeks + LRU", body, cleanup, info=f"slave: {slave}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Test: Read coalescing i async Modbus master (v7.9.8.11, FEAT-156)
+
+Slår coalescing til via POST /api/modbus/master {"coalesce": true, "coalesce_gap": N},
+sender en burst af single-reads til nabo-adresser via /api/modbus/master/rw og
+kontrollerer via /api/metrics:
+
+  modbus_master_coalesced_blocks_total        tæller op
+  modbus_master_coalesced_reads_total         > blocks (flere reads pr. block)
+  modbus_master_bus_time_saved_seconds_total  > 0
+
+Med coalescing slået fra må tællerne ikke ændre sig. Ugyldig gap (33) afvises.
+
+Kræver Modbus master aktiveret og en slave der svarer på holding registre
+BASE_ADDR..BASE_ADDR+COUNT. Gendanner den oprindelige konfiguration.
+
+Brug:
+  python test_mb_coalesce.py [ip] [--slave N]
+
+Host-variant uden ESP32 (blokvalg og kø-udtag): tests/host/test_mb_coalesce
+
+Kræver: requests, esp32_fixture.py
+"""
+
+import time
+
+import esp32_fixture as fx
+from esp32_fixture import api, metrics
+
+SLAVE_ID = 1
+BASE_ADDR = 4200
+COUNT = 12
+
+
+# === HJÆLPEFUNKTIONER ===
+
+def burst(offset):
+    """Send COUNT reads (hver anden adresse) hurtigt efter hinanden."""
+    for i in range(COUNT):
+        fx.master_read(SLAVE_ID, BASE_ADDR + offset + i * 2)
+    time.sleep(1.0)
+
+
+def counters():
+    m = metrics()
+    return (m.get("modbus_master_coalesced_blocks_total", 0),
+            m.get("modbus_master_coalesced_reads_total", 0),
+            m.get("modbus_master_bus_time_saved_seconds_total", 0))
+
+
+# === MAIN ===
+
+def main():
+    global SLAVE_ID
+    SLAVE_ID = fx.parse_args({"slave": SLAVE_ID})["slave"]
+    original = {}
+
+    def body(t):
+        _, data = api("GET", "/api/modbus/master")
+        cfg = data.get("config", {}) if isinstance(data, dict) else {}
+        original["coalesce"] = cfg.get("coalesce", True)
+        original["coalesce_gap"] = cfg.get("coalesce_gap", 4)
+        t.check("GET viser coalesce + coalesce_gap", "coalesce" in cfg and "coalesce_gap" in cfg)
+
+        print("\n--- Ugyldig gap ---")
+        code, _ = api("POST", "/api/modbus/master", {"coalesce_gap": 33})
+        t.check("coalesce_gap=33 afvises", code == 400, f"HTTP {code}")
+
+        print("\n--- coalesce:off ---")
+        code, _ = api("POST", "/api/modbus/master", {"coalesce": False})
+        t.check("Slå coalescing fra", code == 200, f"HTTP {code}")
+        before = counters()
+        burst(0)
+        after = counters()
+        t.check("Ingen blocks uden coalescing", after[0] == before[0], f"{before[0]} → {after[0]}")
+
+        print("\n--- coalesce:on gap=2 ---")
+        code, _ = api("POST", "/api/modbus/master", {"coalesce": True, "coalesce_gap": 2})
+        t.check("Slå coalescing til", code == 200, f"HTTP {code}")
+        before = counters()
+        burst(100)
+        after = counters()
+        blocks = after[0] - before[0]
+        reads = after[1] - before[1]
+        t.check("Block reads udført", blocks > 0, f"+{blocks:.0f}")
+        t.check("Flere reads pr. block", reads > blocks, f"reads={reads:.0f} blocks={blocks:.0f}")
+        t.check("Bus-tid sparet", after[2] > before[2], f"+{(after[2] - before[2]) * 1000:.1f} ms")
+
+    def cleanup():
+        if original:
+            api("POST", "/api/modbus/master", original)
+
+    fx.run("Modbus master — read coalescing", body, cleanup, info=f"slave: {SLAVE_ID}")
+
+
+if __name__ == "__main__":
+    main()
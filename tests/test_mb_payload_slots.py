@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Test: Ref-talte payload slots for multi-register reads/writes (v7.9.8.16, FEAT-161)
+
+Uploader et ST program som hver cyklus skriver to forskellige blokke med
+MB_WRITE_HOLDINGS og læser to forskellige blokke med MB_READ_HOLDINGS, og
+kontrollerer via /api/metrics:
+
+  modbus_master_payload_slots_total            == 12
+  modbus_master_payload_slots_in_use           <= 12 under last
+  modbus_master_payload_alloc_failures_total   findes (tæller kun ved fuld pulje)
+  Efter programmet er stoppet og køen tømt:
+  modbus_master_payload_slots_in_use           <= 8 (kun gemte read-resultater)
+
+Slaven behøver ikke svare — writes frigiver deres slot også ved timeout.
+
+OBS: Overskriver logic slot 1. Kræver Modbus master aktiveret.
+
+Brug:
+  python test_mb_payload_slots.py [ip] [--slave N]
+
+Host-variant uden ESP32 (FC16 flood fra flere tråde, frames kontrolleret på wire): tests/host/test_mb_payload_slots
+
+Kræver: requests, esp32_fixture.py
+"""
+
+import time
+
+import esp32_fixture as fx
+from esp32_fixture import api, metrics
+
+# === KONFIGURATION ===
+SLAVE_ID = 1
+SLOT = 1
+PAYLOAD_SLOTS = 12
+BLOCK_RESULTS_MAX = 8
+
+SOURCE = """PROGRAM payload
+VAR
+  wa : ARRAY[0..9] OF INT;
+  wb : ARRAY[0..9] OF INT;
+  i : INT;
+END_VAR
+BEGIN
+  FOR i := 0 TO 9 DO
+    wa[i] := 1000 + i;
+    wb[i] := 2000 + i;
+  END_FOR;
+  MB_WRITE_HOLDINGS({slave}, 300, 10) := wa;
+  MB_WRITE_HOLDINGS({slave}, 400, 10) := wb;
+  wa := MB_READ_HOLDINGS({slave}, 300, 10);
+  wb := MB_READ_HOLDINGS({slave}, 400, 10);
+END_PROGRAM
+"""
+
+
+# === MAIN ===
+
+def main():
+    global SLAVE_ID
+    SLAVE_ID = fx.parse_args({"slave": SLAVE_ID})["slave"]
+
+    def body(t):
+        m = metrics()
+        for name in ("modbus_master_payload_slots_in_use", "modbus_master_payload_slots_total",
+                     "modbus_master_payload_alloc_failures_total"):
+            t.check(f"{name} findes", name in m)
+        t.check("Pulje på 12 slots", m.get("modbus_master_payload_slots_total") == PAYLOAD_SLOTS,
+                f"total={m.get('modbus_master_payload_slots_total')}")
+
+        print("\n--- Upload ---")
+        api("POST", f"/api/logic/{SLOT}/disable")
+        compiled, data = fx.upload_program(SLOT, SOURCE.replace("{slave}", str(SLAVE_ID)))
+        t.check("Kompilering", compiled, f"{data}" if not compiled else "")
+        api("POST", f"/api/logic/{SLOT}/enable")
+
+        print("\n--- Under last ---")
+        samples = []
+        deadline = time.time() + 5
+        while time.time() < deadline:
+            samples.append(metrics().get("modbus_master_payload_slots_in_use", -1))
+            time.sleep(0.2)
+        t.check("in_use i [0, 12]", all(0 <= s <= PAYLOAD_SLOTS for s in samples), f"{samples[:10]}")
+        t.check("Slots i brug under last", max(samples) > 0, f"max={max(samples):.0f}")
+
+        print("\n--- Stoppet ---")
+        api("POST", f"/api/logic/{SLOT}/disable")
+        fx.wait_for(lambda: metrics().get("modbus_master_queue_depth", 1) == 0, seconds=30, interval=0.5)
+        time.sleep(1)
+        in_use = metrics().get("modbus_master_payload_slots_in_use", -1)
+        t.check("Writes har frigivet deres slots", 0 <= in_use <= BLOCK_RESULTS_MAX, f"in_use={in_use:.0f}")
+
+    def cleanup():
+        api("POST", f"/api/logic/{SLOT}/disable")
+
+    fx.run("Modbus master — payload slots for MB_*_HOLDINGS", body, cleanup, info=f"slave: {SLAVE_ID}")
+
+
+if __name__ == "__main__":
+    main()
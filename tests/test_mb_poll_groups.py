@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Test: Poll groups i Modbus master (v7.9.8.12, FEAT-157)
+
+Opretter to poll groups via POST /api/modbus/master/poll og kontrollerer
+via GET /api/modbus/master/poll:
+
+  Group A  HR BASE_ADDR..+COUNT  period 200 ms  priority 5
+  Group B  HR BASE_ADDR+50..     period 1000 ms priority 0
+
+  - polls tæller op i takt med perioden (opnået rate tæt på target_hz)
+  - lateness felter findes og er ikke-negative
+  - ugyldige groups (fc 5, count 126, period 5) afvises med 400
+  - disable stopper polling, delete fjerner gruppen
+
+Kræver Modbus master aktiveret og en slave der svarer på holding registre.
+Sletter group A_ID/B_ID bagefter.
+
+Brug:
+  python test_mb_poll_groups.py [ip] [--slave N]
+
+Host-variant uden ESP32 (pick/advance og scheduler simulation): tests/host/test_mb_poll
+
+Kræver: requests, esp32_fixture.py
+"""
+
+import time
+
+import esp32_fixture as fx
+from esp32_fixture import api
+
+SLAVE_ID = 1
+BASE_ADDR = 4300
+COUNT = 10
+A_ID = 15
+B_ID = 16
+RUN_S = 5.0
+
+
+# === HJÆLPEFUNKTIONER ===
+
+def group(gid):
+    _, data = api("GET", "/api/modbus/master/poll")
+    for g in (data.get("groups", []) if isinstance(data, dict) else []):
+        if g.get("id") == gid:
+            return g
+    return None
+
+
+# === MAIN ===
+
+def main():
+    global SLAVE_ID
+    SLAVE_ID = fx.parse_args({"slave": SLAVE_ID})["slave"]
+
+    def body(t):
+        print("\n--- Ugyldige groups ---")
+        for bad in ({"fc": 5}, {"count": 126}, {"period_ms": 5}, {"slave": 0}):
+            req = {"id": A_ID, "slave": SLAVE_ID, "fc": 3, "start": BASE_ADDR,
+                    "count": COUNT, "period_ms": 200}
+            req.update(bad)
+            code, _ = api("POST", "/api/modbus/master/poll", req)
+            t.check(f"Afvis {bad}", code == 400, f"HTTP {code}")
+
+        print("\n--- Opret groups ---")
+        code, _ = api("POST", "/api/modbus/master/poll",
+                      {"id": A_ID, "slave": SLAVE_ID, "fc": 3, "start": BASE_ADDR,
+                       "count": COUNT, "period_ms": 200, "priority": 5})
+        t.check("Group A oprettet", code == 200, f"HTTP {code}")
+        code, _ = api("POST", "/api/modbus/master/poll",
+                      {"id": B_ID, "slave": SLAVE_ID, "fc": 3, "start": BASE_ADDR + 50,
+                       "count": COUNT, "period_ms": 1000})
+        t.check("Group B oprettet", code == 200, f"HTTP {code}")
+
+        a0, b0 = group(A_ID), group(B_ID)
+        t.check("GET viser begge groups", a0 is not None and b0 is not None)
+        time.sleep(RUN_S)
+        a1, b1 = group(A_ID), group(B_ID)
+        da = a1["stats"]["polls"] - a0["stats"]["polls"]
+        db = b1["stats"]["polls"] - b0["stats"]["polls"]
+        exp_a, exp_b = RUN_S / 0.2, RUN_S / 1.0
+        t.check("Group A rate", 0.7 * exp_a <= da <= 1.3 * exp_a + 1, f"{da} polls (forventet ~{exp_a:.0f})")
+        t.check("Group B rate", 0.6 * exp_b <= db <= 1.4 * exp_b + 1, f"{db} polls (forventet ~{exp_b:.0f})")
+        st = a1["stats"]
+        t.check("Opnået rate rapporteret", abs(st["rate_hz"] - st["target_hz"]) < 0.3 * st["target_hz"],
+                f"rate={st['rate_hz']:.2f} target={st['target_hz']:.2f}")
+        t.check("Lateness felter", all(st[k] >= 0 for k in ("late_last_ms", "late_avg_ms", "late_max_ms")),
+                f"avg={st['late_avg_ms']} max={st['late_max_ms']} ms")
+
+        print("\n--- Cache fyldt af poll ---")
+        code, data = fx.master_read(SLAVE_ID, BASE_ADDR + 3)
+        t.check("Polled adresse i cache", isinstance(data, dict) and data.get("source") == "cache", str(data))
+
+        print("\n--- Disable / delete ---")
+        api("POST", "/api/modbus/master/poll", {"id": A_ID, "enabled": False})
+        p0 = group(A_ID)["stats"]["polls"]
+        time.sleep(1.0)
+        p1 = group(A_ID)["stats"]["polls"]
+        t.check("Disabled group poller ikke", p1 == p0, f"{p0} → {p1}")
+        code, _ = api("POST", "/api/modbus/master/poll", {"id": A_ID, "delete": True})
+        t.check("Delete", code == 200 and group(A_ID) is None, f"HTTP {code}")
+
+    def cleanup():
+        api("POST", "/api/modbus/master/poll", {"id": A_ID, "delete": True})
+        api("POST", "/api/modbus/master/poll", {"id": B_ID, "delete": True})
+
+    fx.run("Modbus master — poll groups", body, cleanup, info=f"slave: {SLAVE_ID}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Test: Profiler for Modbus master bus-udnyttelse og latency (v7.9.8.17, FEAT-162)
+
+Laver en række FC03 reads via /api/modbus/master/rw til forskellige adresser
+(så de ikke deduplikeres) og kontrollerer via /api/metrics:
+
+  modbus_master_bus_utilisation_percent{bus="0"}   findes og ligger i 0..100
+  modbus_master_bus_occupancy_percent{bus="0"}     >= utilisation
+  modbus_master_bus_bytes_total{bus="0"}           tæller op
+  modbus_master_fc_wire_bytes_count{fc="3"}        tæller op
+  modbus_master_fc_latency_seconds_count{fc="3"}   tæller op
+  modbus_master_fc_latency_seconds_bucket{fc="3",le="+Inf"} == _count
+
+Til sidst åbnes /api/events?subscribe=modbus og der ventes på et mb_bus event.
+
+Slaven behøver ikke svare — timeouts registreres også (uden turnaround).
+
+Kræver Modbus master aktiveret.
+
+Brug:
+  python test_mb_profile.py [ip] [--slave N]
+
+Kræver: requests, esp32_fixture.py
+"""
+
+import time
+
+import requests
+
+import esp32_fixture as fx
+from esp32_fixture import metrics
+
+# === KONFIGURATION ===
+SSE_PORT = 81
+
+SLAVE_ID = 1
+BASE_ADDR = 4200
+READS = 20
+
+
+# === HJÆLPEFUNKTIONER ===
+
+def wait_sse_event(name, timeout_s=5):
+    """Åbn SSE stream med subscribe=modbus og vent på et event med givet navn."""
+    url = f"http://{fx.ESP32_IP}:{SSE_PORT}/api/events?subscribe=modbus"
+    deadline = time.time() + timeout_s
+    try:
+        with requests.get(url, auth=fx.AUTH, stream=True, timeout=timeout_s) as r:
+            for line in r.iter_lines(decode_unicode=True):
+                if line and line.startswith("event:") and line.split(":", 1)[1].strip() == name:
+                    return True
+                if time.time() > deadline:
+                    break
+    except requests.RequestException:
+        pass
+    return False
+
+
+# === MAIN ===
+
+def main():
+    global SLAVE_ID
+    SLAVE_ID = fx.parse_args({"slave": SLAVE_ID})["slave"]
+    util_key = 'modbus_master_bus_utilisation_percent{bus="0"}'
+    occ_key = 'modbus_master_bus_occupancy_percent{bus="0"}'
+    bytes_key = 'modbus_master_bus_bytes_total{bus="0"}'
+    wb_key = 'modbus_master_fc_wire_bytes_count{fc="3"}'
+    lat_key = 'modbus_master_fc_latency_seconds_count{fc="3"}'
+    inf_key = 'modbus_master_fc_latency_seconds_bucket{fc="3",le="+Inf"}'
+
+    def body(t):
+        print("\n--- Før ---")
+        m = metrics()
+        t.check("Bus utilisation gauge findes", util_key in m, f"{m.get(util_key)}")
+        t.check("Bus occupancy gauge findes", occ_key in m, f"{m.get(occ_key)}")
+        bytes_before = m.get(bytes_key, 0)
+        wb_before = m.get(wb_key, 0)
+        lat_before = m.get(lat_key, 0)
+
+        print(f"\n--- {READS} FC03 reads ---")
+        for i in range(READS):
+            fx.master_read(SLAVE_ID, BASE_ADDR + i)
+        time.sleep(2.5)  # Kø tømt (timeouts) + mindst ét helt sekund i vinduet
+
+        m = metrics()
+        util = m.get(util_key, -1)
+        occ = m.get(occ_key, -1)
+        t.check("Utilisation i 0..100", 0 <= util <= 100, f"{util:.2f}%")
+        t.check("Occupancy >= utilisation", occ >= util, f"occ={occ:.2f}% util={util:.2f}%")
+        t.check("Bytes på bus 0 tæller op", m.get(bytes_key, 0) > bytes_before,
+                f"+{m.get(bytes_key, 0) - bytes_before:.0f}")
+        t.check("FC03 wire_bytes histogram tæller op", m.get(wb_key, 0) > wb_before,
+                f"+{m.get(wb_key, 0) - wb_before:.0f}")
+        t.check("FC03 latency histogram tæller op", m.get(lat_key, 0) > lat_before,
+                f"+{m.get(lat_key, 0) - lat_before:.0f}")
+        t.check("+Inf bucket == _count", m.get(inf_key) == m.get(lat_key),
+                f"inf={m.get(inf_key)} count={m.get(lat_key)}")
+
+        print("\n--- SSE subscribe=modbus ---")
+        fx.master_read(SLAVE_ID, BASE_ADDR)
+        t.check("mb_bus event modtaget", wait_sse_event("mb_bus"))
+
+    fx.run("Modbus master profiler — latency + bus-udnyttelse", body, info=f"slave: {SLAVE_ID}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Test: Lock-free prioritetsringe i async Modbus master (v7.9.8.15, FEAT-160)
+
+Fylder køen fra flere tråde samtidig via /api/modbus/master/rw og
+kontrollerer via /api/metrics:
+
+  modbus_master_queue_dedup_total       tæller op når samme adresse læses
+                                         igen mens den første read er i kø
+  modbus_master_queue_class_depth{...}  summen af klasserne == queue_depth
+  modbus_master_queue_depth             falder til 0 når køen er tømt
+  modbus_master_queue_contention_total  findes (kan være 0 med lav last)
+  modbus_master_bus_queue_drops_total   == queue_full + priority_drops (bus 0)
+
+Slaven behøver ikke svare — requests køes og ender som timeout.
+
+Kræver Modbus master aktiveret.
+
+Brug:
+  python test_mb_queue_rings.py [ip] [--slave N]
+
+Host-variant uden ESP32 (pthread stress af push/pop, ingen tab eller dubletter): tests/host/test_mb_queue_rings
+
+Kræver: requests, esp32_fixture.py
+"""
+
+import threading
+
+import esp32_fixture as fx
+from esp32_fixture import metrics
+
+SLAVE_ID = 1
+BASE_ADDR = 5000
+THREADS = 4
+READS_PER_THREAD = 24
+
+
+# === HJÆLPEFUNKTIONER ===
+
+def read(addr):
+    return fx.master_read(SLAVE_ID, addr)
+
+
+def class_depth(m):
+    return sum(v for k, v in m.items() if k.startswith("modbus_master_queue_class_depth{"))
+
+
+# === MAIN ===
+
+def main():
+    global SLAVE_ID
+    SLAVE_ID = fx.parse_args({"slave": SLAVE_ID})["slave"]
+
+    def body(t):
+        m = metrics()
+        for name in ("modbus_master_queue_contention_total", "modbus_master_queue_dedup_total",
+                     "modbus_master_queue_depth"):
+            t.check(f"{name} findes", name in m)
+        classes = [k for k in m if k.startswith("modbus_master_queue_class_depth{")]
+        t.check("class_depth for 3 klasser", len(classes) == 3, f"{classes}")
+
+        print("\n--- Dedup ---")
+        dedup_before = m.get("modbus_master_queue_dedup_total", 0)
+        for _ in range(3):
+            read(BASE_ADDR)
+        dedup = metrics().get("modbus_master_queue_dedup_total", 0) - dedup_before
+        t.check("Gentaget read af samme adresse køes én gang", dedup >= 1, f"+{dedup:.0f}")
+
+        print(f"\n--- {THREADS} samtidige producers ---")
+        errors = []
+
+        def worker(n):
+            try:
+                for i in range(READS_PER_THREAD):
+                    read(BASE_ADDR + 100 + n * READS_PER_THREAD + i)
+            except Exception as e:
+                errors.append(str(e))
+
+        threads = [threading.Thread(target=worker, args=(n,)) for n in range(THREADS)]
+        for th in threads:
+            th.start()
+        samples = []
+        while any(th.is_alive() for th in threads):
+            mm = metrics()
+            samples.append((mm.get("modbus_master_queue_depth", 0), class_depth(mm)))
+        for th in threads:
+            th.join()
+        t.check("Ingen HTTP fejl", not errors, f"{errors[:2]}")
+        t.check("Metrics samplet under last", len(samples) > 0, f"{len(samples)} samples")
+        t.check("Klasse-dybder <= queue_depth (+ in-flight reservation)",
+                all(c <= d + THREADS for d, c in samples), f"{samples[:5]}")
+
+        print("\n--- Kø tømt ---")
+        fx.wait_for(lambda: metrics().get("modbus_master_queue_depth", 1) == 0, seconds=30, interval=0.5)
+        m = metrics()
+        t.check("queue_depth == 0", m.get("modbus_master_queue_depth") == 0,
+                f"depth={m.get('modbus_master_queue_depth')}")
+        t.check("class_depth == 0", class_depth(m) == 0, f"sum={class_depth(m)}")
+        drops = m.get('modbus_master_bus_queue_drops_total{bus="0"}')
+        expected = m.get("modbus_master_queue_full_count", 0) + m.get("modbus_master_priority_drops", 0)
+        t.check("bus_queue_drops == queue_full + priority_drops", drops == expected,
+                f"{drops} vs {expected}")
+
+    fx.run("Modbus master kø — lock-free prioritetsringe", body, info=f"slave: {SLAVE_ID}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Test: Event-drevet response wait i Modbus master (v7.9.8.13, FEAT-158)
+
+Sender en række reads via /api/modbus/master/rw til forskellige adresser
+(ingen cache hits) og sammenligner /api/metrics før og efter:
+
+  modbus_master_wait_ms_total   tæller op (transaktionen blokerer på RX event)
+  modbus_master_busy_ms_total   << wait (CPU'en er fri mens slaven svarer)
+  modbus_master_rx_events_total tæller op hvis slaven svarer
+  modbus_master_hw_rs485        rapporteres (0/1)
+  esp32_core0_load_percent      0-100 hvis run-time stats er slået til
+
+Virker også uden slave: ved timeout blokerer transaktionen hele timeout_ms,
+hvilket er det tydeligste bevis på at der ikke busy-polles.
+
+Kræver Modbus master aktiveret.
+
+Brug:
+  python test_mb_rx_wait.py [ip] [--slave N]
+
+Kræver: requests, esp32_fixture.py
+"""
+
+import time
+
+import esp32_fixture as fx
+from esp32_fixture import api, metrics
+
+SLAVE_ID = 1
+BASE_ADDR = 6000
+READS = 20
+
+
+# === MAIN ===
+
+def main():
+    global SLAVE_ID
+    SLAVE_ID = fx.parse_args({"slave": SLAVE_ID})["slave"]
+
+    def body(t):
+        _, data = api("GET", "/api/modbus/master")
+        cfg = data.get("config", {}) if isinstance(data, dict) else {}
+        stats = data.get("stats", {}) if isinstance(data, dict) else {}
+        t.check("Master aktiveret", cfg.get("enabled") == True)
+        t.check("GET viser stats.rx_wait", "rx_wait" in stats, str(stats.get("rx_wait")))
+
+        before = metrics()
+        t.check("modbus_master_hw_rs485 rapporteres", "modbus_master_hw_rs485" in before,
+                f"hw_rs485={before.get('modbus_master_hw_rs485')}")
+
+        print(f"\n--- {READS} reads ---")
+        for i in range(READS):
+            fx.master_read(SLAVE_ID, BASE_ADDR + i)
+        timeout_s = cfg.get("timeout_ms", 500) / 1000.0
+        time.sleep(min(READS * timeout_s + 1.0, 15.0))
+        after = metrics()
+
+        d_wait = after.get("modbus_master_wait_ms_total", 0) - before.get("modbus_master_wait_ms_total", 0)
+        d_busy = after.get("modbus_master_busy_ms_total", 0) - before.get("modbus_master_busy_ms_total", 0)
+        d_ok = after.get("modbus_master_success_total", 0) - before.get("modbus_master_success_total", 0)
+        d_events = after.get("modbus_master_rx_events_total", 0) - before.get("modbus_master_rx_events_total", 0)
+
+        t.check("Wait tid tæller op", d_wait > 0, f"+{d_wait:.0f} ms")
+        t.check("Busy tid under wait tid", d_busy < d_wait, f"busy={d_busy:.0f} ms wait={d_wait:.0f} ms")
+        if d_ok > 0:
+            t.check("RX events ved svar", d_events >= d_ok, f"events=+{d_events:.0f} svar=+{d_ok:.0f}")
+        else:
+            print("  [INFO] Ingen svar fra slave — RX event check sprunget over")
+
+        load = after.get("esp32_core0_load_percent")
+        if load is None:
+            print("  [INFO] esp32_core0_load_percent mangler (run-time stats ikke compiled ind)")
+        else:
+            t.check("Core 0 load 0-100", 0 <= load <= 100, f"{load:.0f}%")
+
+    fx.run("Modbus master — event-drevet response wait", body, info=f"slave: {SLAVE_ID}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Test: Write combining og last-value-wins i async Modbus master (v7.9.8.19, FEAT-164)
+
+Skriver via POST /api/modbus/master/rw og kontrollerer via /api/metrics:
+
+  modbus_master_writes_skipped_total        uændret værdi → ingen transaktion
+  modbus_master_writes_combined_total       gentagne writes mens en venter
+  modbus_master_write_blocks_total          nabo-writes sendt som én FC16
+  modbus_master_write_block_members_total   > blocks
+
+Derudover:
+  - Cachen viser den skrevne værdi efter en bekræftet write (ikke 1)
+  - write_always for slaven slår skip af uændrede writes fra
+  - Ugyldig write_always (slave 300) afvises
+
+Kræver Modbus master aktiveret og en slave der accepterer FC06/FC16 på holding
+registre BASE_ADDR..BASE_ADDR+COUNT. Gendanner den oprindelige konfiguration.
+
+Brug:
+  python test_mb_write_combine.py [ip] [--slave N]
+
+Host-variant uden ESP32 (pending-write tabel og mb_write_take, tilfældige write-strømme): tests/host/test_mb_write_combine
+
+Kræver: requests, esp32_fixture.py
+"""
+
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+import esp32_fixture as fx
+from esp32_fixture import api, metrics
+
+# === KONFIGURATION ===
+SLAVE_ID = 1
+BASE_ADDR = 4300
+COUNT = 8
+BURST = 24
+
+
+# === HJÆLPEFUNKTIONER ===
+
+def counters():
+    m = metrics()
+    return {k: m.get(f"modbus_master_{k}_total", 0)
+            for k in ("writes_skipped", "writes_combined", "write_blocks", "write_block_members")}
+
+
+def write(addr, value):
+    return fx.master_write(SLAVE_ID, addr, value)
+
+
+def read(addr):
+    _, data = fx.master_read(SLAVE_ID, addr)
+    return data if isinstance(data, dict) else {}
+
+
+def parallel_writes(jobs):
+    """Send writes samtidigt, så flere ligger i kø før workeren når til dem."""
+    with ThreadPoolExecutor(max_workers=8) as pool:
+        list(pool.map(lambda j: write(*j), jobs))
+    time.sleep(1.5)
+
+
+# === MAIN ===
+
+def main():
+    global SLAVE_ID
+    SLAVE_ID = fx.parse_args({"slave": SLAVE_ID})["slave"]
+    state = {}
+
+    def body(t):
+        _, data = api("GET", "/api/modbus/master")
+        cfg = data.get("config", {}) if isinstance(data, dict) else {}
+        state["orig"] = {"write_combine": cfg.get("write_combine", True),
+                         "write_always": cfg.get("write_always", [])}
+        t.check("GET viser write_combine + write_always", "write_combine" in cfg and "write_always" in cfg)
+
+        print("\n--- Ugyldig write_always ---")
+        code, _ = api("POST", "/api/modbus/master", {"write_always": [300]})
+        t.check("write_always=[300] afvises", code == 400, f"HTTP {code}")
+
+        code, _ = api("POST", "/api/modbus/master", {"write_combine": True, "write_always": []})
+        t.check("Slå write combining til", code == 200, f"HTTP {code}")
+
+        print("\n--- Cache efter write ---")
+        write(BASE_ADDR, 1234)
+        time.sleep(1.0)
+        r = read(BASE_ADDR)
+        t.check("Cache viser skrevet værdi", r.get("value") == 1234, f"{r}")
+
+        print("\n--- Uændret værdi ---")
+        before = counters()
+        for _ in range(5):
+            write(BASE_ADDR, 1234)
+        time.sleep(0.5)
+        after = counters()
+        skipped = after["writes_skipped"] - before["writes_skipped"]
+        t.check("Uændrede writes sprunget over", skipped >= 5, f"+{skipped:.0f}")
+
+        print("\n--- write_always ---")
+        api("POST", "/api/modbus/master", {"write_always": [SLAVE_ID]})
+        before = counters()
+        for _ in range(3):
+            write(BASE_ADDR, 1234)
+        time.sleep(1.0)
+        after = counters()
+        t.check("write_always sender uændrede writes",
+                after["writes_skipped"] == before["writes_skipped"],
+                f"skipped {before['writes_skipped']:.0f} → {after['writes_skipped']:.0f}")
+        api("POST", "/api/modbus/master", {"write_always": []})
+
+        print("\n--- Sidste værdi vinder ---")
+        before = counters()
+        parallel_writes([(BASE_ADDR + 1, v) for v in range(1, BURST + 1)])
+        after = counters()
+        combined = after["writes_combined"] - before["writes_combined"]
+        t.check("Gentagne writes kombineret", combined > 0, f"+{combined:.0f} af {BURST}")
+        time.sleep(0.5)
+        r = read(BASE_ADDR + 1)
+        t.check("Sidste værdi står i cachen", r.get("value") == BURST, f"{r}")
+
+        print("\n--- Nabo-writes som FC16 ---")
+        before = counters()
+        parallel_writes([(BASE_ADDR + 10 + i, 500 + i) for i in range(COUNT)] * 2)
+        after = counters()
+        blocks = after["write_blocks"] - before["write_blocks"]
+        members = after["write_block_members"] - before["write_block_members"]
+        t.check("Block writes udført", blocks > 0, f"+{blocks:.0f}")
+        t.check("Flere writes pr. block", members > blocks, f"writes={members:.0f} blocks={blocks:.0f}")
+
+    def cleanup():
+        if "orig" in state:
+            api("POST", "/api/modbus/master", state["orig"])
+
+    fx.run("Modbus master — write combining", body, cleanup, info=f"slave: {SLAVE_ID}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Test: FC23, FC22, FC43/14 og FC08 (v7.9.8.24, FEAT-169)
+
+Hardware setup:
+  - ESP32 @ 10.1.1.30, Modbus TCP på port 502 (set modbus-tcp enabled on)
+
+Testplan:
+  1. FC23 skriver HR 10-19 og læser HR 5-24 i samme request → svaret
+     indeholder allerede de nye værdier
+  2. FC22 på HR 0: (v AND and) OR (or AND NOT and) matcher lokal beregning
+  3. FC43/14 basic stream (kode 1) → objekt 0-2, version = firmware
+  4. FC43/14 regular stream (kode 2) → objekt 4-6
+  5. FC43/14 individual (kode 4) objekt 2 → kun ét objekt; objekt 0x42 → exception 02
+  6. FC08 0x0000 echo; tællerne 0x000A-0x000F føres af RTU slave og
+     afvises over TCP med exception 01
+  7. Fejlbehæftede frames → exception 03 (forkert længde/byte count), ukendt
+     FC08 sub-function → exception 01
+
+Brug:
+  python test_modbus_fc_ext.py [ip]
+
+Host-variant uden ESP32 (FC22/FC23 under samtidig last, FC43 stream-restart og more follows, FC08 RTU/TCP): tests/host/test_modbus_fc_ext
+
+Kræver: requests, esp32_fixture.py
+"""
+
+import struct
+
+import esp32_fixture as fx
+from esp32_fixture import read_hr, transact, write_hr
+
+# === KONFIGURATION ===
+SCRATCH_START = 0   # HR 0-99: under counter-standardområdet (100+)
+SCRATCH_COUNT = 30
+
+
+# === HJÆLPEFUNKTIONER ===
+
+def exception_code(pdu, fc):
+    return pdu[1] if len(pdu) >= 2 and pdu[0] == (fc | 0x80) else None
+
+
+def device_id(s, tid, code, object_id):
+    pdu = transact(s, tid, struct.pack(">BBBB", 0x2B, 0x0E, code, object_id))
+    if pdu[0] != 0x2B:
+        return pdu, None
+    mei, rcode, conformity, more, next_id, num = pdu[1:7]
+    objects = {}
+    pos = 7
+    for _ in range(num):
+        oid, olen = pdu[pos], pdu[pos + 1]
+        objects[oid] = pdu[pos + 2:pos + 2 + olen].decode("ascii", errors="replace")
+        pos += 2 + olen
+    return pdu, {"mei": mei, "code": rcode, "conformity": conformity, "more": more,
+                 "next": next_id, "objects": objects}
+
+
+def diag(s, tid, sub, data=b"\x00\x00"):
+    return transact(s, tid, struct.pack(">BH", 0x08, sub) + data)
+
+
+# === TESTS ===
+
+def test_fc23(t, s):
+    print("\n--- Test 1: FC23 Read/Write Multiple Registers ---")
+    values = [0xA500 + i for i in range(10)]
+    pdu = transact(s, 1, struct.pack(">BHHHHB", 0x17, 5, 20, 10, 10, 20) +
+                   struct.pack(">10H", *values))
+    t.check("FC23 svar uden exception", pdu[0] == 0x17, pdu[:3].hex())
+    if pdu[0] != 0x17:
+        return
+    t.check("Byte count = 40", pdu[1] == 40, str(pdu[1]))
+    regs = list(struct.unpack(">20H", pdu[2:42]))
+    t.check("Læst del indeholder nye værdier (write før read)", regs[5:15] == values)
+    t.check("FC03 bekræfter skrivningen", read_hr(s, 2, 10, 10) == values)
+
+
+def test_fc22(t, s):
+    print("\n--- Test 2: FC22 Mask Write Register ---")
+    write_hr(s, 10, 0, [0x1234])
+    and_mask, or_mask = 0xF0F2, 0x0025
+    pdu = transact(s, 11, struct.pack(">BHHH", 0x16, 0, and_mask, or_mask))
+    t.check("FC22 ekko af request", pdu == struct.pack(">BHHH", 0x16, 0, and_mask, or_mask), pdu.hex())
+    expected = (0x1234 & and_mask) | (or_mask & ~and_mask & 0xFFFF)
+    got = read_hr(s, 12, 0, 1)[0]
+    t.check("Resultat = (v AND and) OR (or AND NOT and)", got == expected,
+            f"0x{got:04X} (forventet 0x{expected:04X})")
+
+
+def test_fc43(t, s):
+    print("\n--- Test 3-5: FC43/14 Read Device Identification ---")
+    _, basic = device_id(s, 20, 1, 0)
+    t.check("Basic stream svar", basic is not None)
+    if basic:
+        t.check("Objekt 0-2 til stede", sorted(basic["objects"]) == [0, 1, 2], str(sorted(basic["objects"])))
+        t.check("Conformity 0x82", basic["conformity"] == 0x82, f"0x{basic['conformity']:02X}")
+        t.check("Ingen more follows", basic["more"] == 0)
+        print(f"    Vendor={basic['objects'].get(0)!r} Product={basic['objects'].get(1)!r} "
+              f"Rev={basic['objects'].get(2)!r}")
+
+    _, regular = device_id(s, 21, 2, 0)
+    t.check("Regular stream svar", regular is not None)
+    if regular:
+        t.check("Objekt 4-6 til stede", sorted(regular["objects"]) == [4, 5, 6], str(sorted(regular["objects"])))
+
+    _, single = device_id(s, 22, 4, 2)
+    t.check("Individual objekt 2", single is not None and list(single["objects"]) == [2])
+
+    pdu, _ = device_id(s, 23, 4, 0x42)
+    t.check("Ukendt objekt → exception 02", exception_code(pdu, 0x2B) == 0x02, pdu.hex())
+
+
+def test_fc08(t, s):
+    print("\n--- Test 6: FC08 Diagnostics ---")
+    pdu = diag(s, 30, 0x0000, b"\xBE\xEF\x12\x34")
+    t.check("0x0000 echo", pdu == b"\x08\x00\x00\xBE\xEF\x12\x34", pdu.hex())
+
+    # Tællerne gælder RTU-linjen; over TCP ville de vise en anden transports trafik
+    for sub, name in ((0x0A, "clear"), (0x0B, "bus messages"), (0x0C, "bus comm errors"),
+                      (0x0D, "bus exceptions"), (0x0E, "server messages"), (0x0F, "server no response")):
+        pdu = diag(s, 32 + sub, sub)
+        t.check(f"0x{sub:04X} {name} over TCP → exception 01", exception_code(pdu, 0x08) == 0x01, pdu.hex())
+
+
+def test_malformed(t, s):
+    print("\n--- Test 7: Fejlbehæftede frames ---")
+    pdu = transact(s, 50, struct.pack(">BHH", 0x16, 0, 0xFFFF))  # mangler or_mask
+    t.check("FC22 kort frame → exception 03", exception_code(pdu, 0x16) == 0x03, pdu.hex())
+
+    pdu = transact(s, 51, struct.pack(">BHHHHB", 0x17, 0, 1, 0, 2, 2) + b"\x00\x01")
+    t.check("FC23 forkert byte count → exception 03", exception_code(pdu, 0x17) == 0x03, pdu.hex())
+
+    pdu = transact(s, 52, struct.pack(">BBBB", 0x2B, 0x0E, 0x07, 0))
+    t.check("FC43 ugyldig read code → exception 03", exception_code(pdu, 0x2B) == 0x03, pdu.hex())
+
+    pdu = diag(s, 54, 0x0001)
+    t.check("FC08 restart (ikke understøttet) → exception 01", exception_code(pdu, 0x08) == 0x01, pdu.hex())
+
+
+# === MAIN ===
+
+def main():
+    fx.parse_args()
+
+    def body(t):
+        with fx.connect() as s:
+            saved = read_hr(s, 0, SCRATCH_START, SCRATCH_COUNT)
+            try:
+                test_fc23(t, s)
+                test_fc22(t, s)
+                test_fc43(t, s)
+                test_fc08(t, s)
+                test_malformed(t, s)
+            finally:
+                write_hr(s, 99, SCRATCH_START, saved)
+
+    fx.run("FC23 / FC22 / FC43 / FC08", body, info=f"Modbus TCP :{fx.MB_PORT}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Benchmark: Modbus RTU slave latency ved max frame-længde (v7.9.8.1)
+
+Måler round-trip for FC03 (125 registre) og FC16 (123 registre) mod ESP32
+slave på UART0/RS-485 og trækker den teoretiske wire-tid fra, så resten er
+slave-side overhead (RX timeout + parse + CRC + dispatch + TX).
+
+Kør før og efter en firmware-ændring og sammenlign "overhead" kolonnen.
+
+Hardware setup:
+  - USB/RS-485 adapter til ESP32 Modbus slave
+  - set modbus-slave enabled on, slave-id 1
+
+Brug:
+  python test_modbus_rtu_latency.py [--port COM5] [--baud 115200] [--count N]
+
+Host-variant uden ESP32 (RTU RX-sti, ns/frame FC03/FC16): tests/host/test_modbus_crc
+
+Kræver: pyserial, requests, esp32_fixture.py
+"""
+
+import struct
+import time
+
+import serial
+
+import esp32_fixture as fx
+
+# === KONFIGURATION ===
+SERIAL_PORT = "COM5"
+BAUDRATE = 115200
+SLAVE_ID = 1
+COUNT = 200
+TIMEOUT = 2.0
+
+# Holding registre til FC16 (scratch)
+WRITE_BASE = 0
+
+
+# === HJÆLPEFUNKTIONER ===
+
+def crc16(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+    return crc
+
+
+def frame(pdu):
+    body = bytes([SLAVE_ID]) + pdu
+    return body + struct.pack("<H", crc16(body))
+
+
+def wire_time_s(nbytes, baud):
+    # 1 start + 8 data + 1 stop (8N1)
+    return nbytes * 10 / baud
+
+
+def transact(ser, req, resp_len):
+    ser.reset_input_buffer()
+    t0 = time.perf_counter()
+    ser.write(req)
+    resp = ser.read(resp_len)
+    t1 = time.perf_counter()
+    if len(resp) != resp_len:
+        raise IOError(f"kort svar: {len(resp)}/{resp_len} bytes")
+    if crc16(resp[:-2]) != struct.unpack("<H", resp[-2:])[0]:
+        raise IOError("CRC fejl i svar")
+    return t1 - t0
+
+
+def bench(t, ser, name, req, resp_len, count, baud):
+    samples = []
+    try:
+        for _ in range(count):
+            samples.append(transact(ser, req, resp_len))
+    except IOError as e:
+        t.fail(name, f"{len(samples)}/{count} svar: {e}")
+        return
+    samples.sort()
+    wire = wire_time_s(len(req) + resp_len, baud)
+    p50 = samples[len(samples) // 2]
+    p99 = samples[min(len(samples) - 1, int(len(samples) * 0.99))]
+    t.ok(name, f"wire {wire*1e3:.2f} ms  p50 {p50*1e3:.2f} ms  p99 {p99*1e3:.2f} ms  "
+               f"overhead p50 {(p50 - wire)*1e3:.2f} ms")
+
+
+# === MAIN ===
+
+def main():
+    opts = fx.parse_args({"port": SERIAL_PORT, "baud": BAUDRATE, "count": COUNT})
+    port, baud, count = opts["port"], opts["baud"], opts["count"]
+
+    def body(t):
+        with serial.Serial(port, baud, timeout=TIMEOUT) as ser:
+            # FC03: 125 registre → svar 3 + 250 + 2 bytes
+            fc03 = frame(struct.pack(">BHH", 0x03, 0, 125))
+            bench(t, ser, "FC03 read 125 regs", fc03, 5 + 250, count, baud)
+
+            # FC16: 123 registre → svar 8 bytes
+            values = b"".join(struct.pack(">H", i) for i in range(123))
+            fc16 = frame(struct.pack(">BHHB", 0x10, WRITE_BASE, 123, 246) + values)
+            bench(t, ser, "FC16 write 123 regs", fc16, 8, count, baud)
+
+    fx.run("Modbus RTU slave latency — max frame længde", body,
+           info=f"{port} @ {baud} baud, slave {SLAVE_ID}, {count} requests")
+
+
+if __name__ == "__main__":
+    main()
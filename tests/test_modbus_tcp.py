@@ -0,0 +1,205 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Test: Modbus TCP slave server (FEAT-145, v7.9.8.0)
+
+Hardware setup:
+  - ESP32 @ 10.1.1.30, Modbus TCP på port 502 (set modbus-tcp enabled on)
+  - Ingen eksterne slaves nødvendige — serveren bruger samme register-map som RTU
+
+Testplan:
+  1. Forbindelse til port 502
+  2. FC03 single read — transaction ID ekko, MBAP længde
+  3. FC06 write + FC03 read-back (scratch register)
+  4. Pipelining: N requests i én send(), alle svar i rækkefølge
+  5. Fremmed unit ID → exception 0x0B
+  6. Ukendt function code → exception 0x01
+  7. Ugyldig protocol ID → server lukker forbindelsen
+  8. Benchmark: requests/s ved pipeline-dybde 1 og 8
+  9. (Valgfrit) Replay af capture-fil: én ADU pr. linje i hex
+
+Brug:
+  python test_modbus_tcp.py [ip] [--capture fil.txt] [--count N]
+
+Host-variant uden ESP32 (MBAP replay, TX-batch overflow, requests/s): tests/host/bench_mbtcp_replay
+
+Kræver: requests, esp32_fixture.py
+"""
+
+import socket
+import struct
+import time
+
+import esp32_fixture as fx
+from esp32_fixture import connect, mbap, recv_adu
+
+# === KONFIGURATION ===
+# Holding register til write/read-back test (scratch)
+SCRATCH_REG = 80
+
+BENCH_COUNT = 500
+
+# === HJÆLPEFUNKTIONER ===
+
+def build_adu(tid, unit, pdu, pid):
+    """MBAP header med vilkårligt protocol ID (fx.mbap sender altid 0)."""
+    return struct.pack(">HHHB", tid, pid, len(pdu) + 1, unit) + pdu
+
+
+def pdu_read_holding(addr, qty):
+    return struct.pack(">BHH", 0x03, addr, qty)
+
+
+def pdu_write_single(addr, value):
+    return struct.pack(">BHH", 0x06, addr, value)
+
+
+# === TESTS ===
+
+def test_connection(t):
+    print("\n--- Test 1: Forbindelse ---")
+    try:
+        s = connect()
+        s.close()
+        t.ok("TCP connect", f"{fx.ESP32_IP}:{fx.MB_PORT}")
+        return True
+    except OSError as e:
+        t.fail("TCP connect", str(e))
+        return False
+
+
+def test_single_read(t):
+    print("\n--- Test 2: FC03 single read ---")
+    with connect() as s:
+        s.sendall(mbap(0x1234, pdu_read_holding(0, 4)))
+        hdr = fx.recv_exact(s, 7)
+        tid, pid, length, unit = struct.unpack(">HHHB", hdr)
+        pdu = fx.recv_exact(s, length - 1)
+        t.check("TID ekko", tid == 0x1234, f"tid=0x{tid:04X}")
+        t.check("Protocol ID = 0", pid == 0, f"pid={pid}")
+        t.check("Unit ID ekko", unit == fx.UNIT_ID, f"unit={unit}")
+        t.check("FC03 svar", pdu[0] == 0x03 and pdu[1] == 8 and len(pdu) == 10,
+                f"pdu={pdu.hex()}")
+
+
+def test_write_readback(t):
+    print("\n--- Test 3: FC06 write + FC03 read-back ---")
+    value = int(time.time()) & 0xFFFF
+    with connect() as s:
+        pdu = fx.transact(s, 1, pdu_write_single(SCRATCH_REG, value))
+        t.check("FC06 ekko", pdu == pdu_write_single(SCRATCH_REG, value), f"pdu={pdu.hex()}")
+        pdu = fx.transact(s, 2, pdu_read_holding(SCRATCH_REG, 1))
+        got = struct.unpack(">H", pdu[2:4])[0] if len(pdu) >= 4 else None
+        t.check("Read-back værdi", got == value, f"skrev {value}, læste {got}")
+
+
+def test_pipelining(t, depth=16):
+    print(f"\n--- Test 4: Pipelining ({depth} requests i én send) ---")
+    with connect() as s:
+        batch = b"".join(mbap(100 + i, pdu_read_holding(i, 1)) for i in range(depth))
+        s.sendall(batch)
+        tids = [recv_adu(s)[0] for _ in range(depth)]
+        expected = [100 + i for i in range(depth)]
+        t.check("Alle svar modtaget i rækkefølge", tids == expected, f"tids={tids}")
+
+
+def test_foreign_unit(t):
+    print("\n--- Test 5: Fremmed unit ID ---")
+    with connect() as s:
+        s.sendall(mbap(7, pdu_read_holding(0, 1), unit=200))
+        tid, _, pdu = recv_adu(s)
+        t.check("Exception 0x0B", pdu == bytes([0x83, 0x0B]), f"pdu={pdu.hex()}")
+        t.check("TID ekko ved exception", tid == 7)
+
+
+def test_illegal_function(t):
+    print("\n--- Test 6: Ukendt function code ---")
+    with connect() as s:
+        pdu = fx.transact(s, 8, bytes([0x41, 0x00]))
+        t.check("Exception 0x01", pdu == bytes([0xC1, 0x01]), f"pdu={pdu.hex()}")
+
+
+def test_bad_protocol_id(t):
+    print("\n--- Test 7: Ugyldig protocol ID ---")
+    with connect() as s:
+        s.sendall(build_adu(9, fx.UNIT_ID, pdu_read_holding(0, 1), 0x1234))
+        try:
+            data = s.recv(64)
+            t.check("Forbindelse lukket", data == b"", f"modtog {data.hex()}")
+        except (ConnectionResetError, socket.timeout) as e:
+            t.check("Forbindelse lukket", isinstance(e, ConnectionResetError), str(e))
+
+
+def bench(depth, count):
+    """Kør count FC03 requests med op til depth udestående. Returnerer req/s."""
+    with connect() as s:
+        sent = 0
+        received = 0
+        start = time.perf_counter()
+        while received < count:
+            burst = []
+            while sent < count and sent - received < depth:
+                burst.append(mbap(sent & 0xFFFF, pdu_read_holding(0, 10)))
+                sent += 1
+            if burst:
+                s.sendall(b"".join(burst))
+            tid, _, _ = recv_adu(s)
+            if tid != (received & 0xFFFF):
+                raise AssertionError(f"TID {tid} != forventet {received}")
+            received += 1
+        elapsed = time.perf_counter() - start
+    return count / elapsed
+
+
+def test_benchmark(t, count):
+    print(f"\n--- Test 8: Benchmark ({count} requests) ---")
+    for depth in (1, 8):
+        try:
+            rate = bench(depth, count)
+            t.ok(f"Pipeline-dybde {depth}", f"{rate:.0f} req/s")
+        except (OSError, AssertionError) as e:
+            t.fail(f"Pipeline-dybde {depth}", str(e))
+
+
+def test_replay(t, path):
+    print(f"\n--- Test 9: Replay af {path} ---")
+    adus = []
+    with open(path) as f:
+        for line in f:
+            line = line.strip().replace(" ", "")
+            if line and not line.startswith("#"):
+                adus.append(bytes.fromhex(line))
+    ok = 0
+    with connect() as s:
+        for adu in adus:
+            s.sendall(adu)
+            tid, _, _ = recv_adu(s)
+            if tid == struct.unpack(">H", adu[0:2])[0]:
+                ok += 1
+    t.check("Replay TID ekko", ok == len(adus), f"{ok}/{len(adus)} ADUs")
+
+
+# === MAIN ===
+
+def main():
+    opts = fx.parse_args({"capture": "", "count": BENCH_COUNT})
+
+    def body(t):
+        if not test_connection(t):
+            print("\n[FATAL] Kan ikke forbinde til Modbus TCP — er 'set modbus-tcp enabled on' sat?")
+            return
+        test_single_read(t)
+        test_write_readback(t)
+        test_pipelining(t)
+        test_foreign_unit(t)
+        test_illegal_function(t)
+        test_bad_protocol_id(t)
+        test_benchmark(t, opts["count"])
+        if opts["capture"]:
+            test_replay(t, opts["capture"])
+
+    fx.run("Modbus TCP Server — Integration Test", body, info=f"Modbus TCP :{fx.MB_PORT}  unit: {fx.UNIT_ID}")
+
+
+if __name__ == "__main__":
+    main()
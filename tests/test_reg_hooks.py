@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Test: Holding register write hooks via adresse-dispatch tabel (v7.9.8.23, FEAT-168)
+
+Hardware setup:
+  - ESP32 @ 10.1.1.30, Modbus TCP på port 502 (set modbus-tcp enabled on)
+
+Testplan:
+  1. FC16 på 100 almindelige registre (HR 0-99, ingen hooks) — værdier
+     læses uændret tilbage (ingen side-effekter)
+  2. FC16 HR 236-237 med ugyldigt interval → hook nulstiller til gyldigt interval
+  3. FC16 HR 236-237 med gyldigt interval (50 ms) → accepteres, oprindeligt gendannes
+  4. FC06 HR 200 med bit 2 (reset error) → hook kvitterer og rydder bit 2
+  5. FC16 over 196-239 (control + var input + interval i én request) → svar OK
+     og interval urørt
+
+Brug:
+  python test_reg_hooks.py [ip]
+
+Host-variant uden ESP32 (handler-tabel, tilfældige install/remove mod model, FC16/06/22/23): tests/host/test_reg_hooks
+
+Kræver: requests, esp32_fixture.py
+"""
+
+import struct
+import time
+
+import esp32_fixture as fx
+from esp32_fixture import read_hr, write_hr
+
+# === KONFIGURATION ===
+PLAIN_START = 0
+PLAIN_COUNT = 100  # HR 0-99: under counter-standardområdet (100+)
+ST_CONTROL_REG = 200
+ST_INTERVAL_REG = 236
+VALID_INTERVALS = (10, 20, 25, 50, 75, 100)
+
+
+# === HJÆLPEFUNKTIONER ===
+
+def read_interval(s, tid):
+    hi, lo = read_hr(s, tid, ST_INTERVAL_REG, 2)
+    return (hi << 16) | lo
+
+
+# === TESTS ===
+
+def test_plain(t, s):
+    print("\n--- Test 1: FC16 uden hooks ---")
+    saved = read_hr(s, 1, PLAIN_START, PLAIN_COUNT)
+    base = int(time.time()) & 0x3FFF
+    values = [(base + i) & 0xFFFF for i in range(PLAIN_COUNT)]
+    t.check("FC16 100 words accepteret", write_hr(s, 2, PLAIN_START, values))
+    t.check("Værdier læst uændret tilbage", read_hr(s, 3, PLAIN_START, PLAIN_COUNT) == values)
+    write_hr(s, 4, PLAIN_START, saved)
+
+
+def test_interval(t, s):
+    print("\n--- Test 2+3: Execution interval hook (HR 236-237) ---")
+    original = read_interval(s, 10)
+    t.check("Nuværende interval gyldigt", original in VALID_INTERVALS, f"{original} ms")
+
+    write_hr(s, 11, ST_INTERVAL_REG, [0, 33])
+    after = read_interval(s, 12)
+    t.check("Ugyldigt interval (33) afvist og nulstillet", after == original, f"{after} ms")
+
+    target = 50 if original != 50 else 75
+    write_hr(s, 13, ST_INTERVAL_REG, [0, target])
+    after = read_interval(s, 14)
+    t.check(f"Gyldigt interval ({target}) accepteret", after == target, f"{after} ms")
+
+    write_hr(s, 15, ST_INTERVAL_REG, [original >> 16, original & 0xFFFF])
+    t.check("Oprindeligt interval gendannet", read_interval(s, 16) == original)
+    return original
+
+
+def test_control(t, s):
+    print("\n--- Test 4: ST control hook (HR 200, bit 2) ---")
+    ctrl = read_hr(s, 20, ST_CONTROL_REG, 1)[0]
+    pdu = fx.transact(s, 21, struct.pack(">BHH", 0x06, ST_CONTROL_REG, ctrl | 0x0004))
+    t.check("FC06 accepteret", pdu[0] == 0x06, pdu[:3].hex())
+    after = read_hr(s, 22, ST_CONTROL_REG, 1)[0]
+    t.check("Bit 2 kvitteret (ryddet)", (after & 0x0004) == 0, f"0x{after:04X}")
+    t.check("Øvrige bits bevaret", (after & ~0x0004) == (ctrl & ~0x0004), f"0x{ctrl:04X} -> 0x{after:04X}")
+
+
+def test_mixed(t, s, interval):
+    print("\n--- Test 5: FC16 over flere hook-områder ---")
+    start, count = 196, 44
+    current = read_hr(s, 30, start, count)
+    # Skriv nuværende værdier tilbage (control uden bit 2) → hooks kører, intet ændres
+    current[ST_CONTROL_REG - start:ST_CONTROL_REG - start + 4] = \
+        [v & ~0x0004 for v in current[ST_CONTROL_REG - start:ST_CONTROL_REG - start + 4]]
+    t.check("FC16 196-239 accepteret", write_hr(s, 31, start, current))
+    t.check("Interval urørt", read_interval(s, 32) == interval)
+
+
+# === MAIN ===
+
+def main():
+    fx.parse_args()
+
+    def body(t):
+        with fx.connect() as s:
+            test_plain(t, s)
+            interval = test_interval(t, s)
+            test_control(t, s)
+            test_mixed(t, s, interval)
+
+    fx.run("Holding register write hooks", body, info=f"Modbus TCP :{fx.MB_PORT}")
+
+
+if __name__ == "__main__":
+    main()
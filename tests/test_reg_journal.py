@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Test: Register change journal for SSE watch_all (v7.9.8.21, FEAT-166)
+
+Hardware setup:
+  - ESP32 @ 10.1.1.30, Modbus TCP på port 502 (set modbus-tcp enabled on)
+  - SSE på port 1800 (max 3 klienter)
+
+Testplan:
+  1. /api/metrics har register_journal_changes_total + register_journal_overruns_total
+  2. SSE subscribe=all: FC16 skriver N forskellige værdier til SCRATCH_REG..+1 —
+     sidste værdi for begge adresser skal nå frem som "register" event (type hr)
+  3. Gentagen skrivning af SAMME værdi må ikke øge register_journal_changes_total
+     (kun reelle ændringer journaliseres) og må ikke give SSE events
+  4. Burst: flere skrivninger end journalens 512 slots mellem to SSE ticks —
+     klienten skal stadig ende med den sidste værdi (overrun → blok-dirty)
+
+Brug:
+  python test_reg_journal.py [ip]
+
+Host-variant uden ESP32 (overrun → blok-dirty, tilfældige readers, writer/consumer tråde): tests/host/test_reg_journal
+
+Kræver: requests, esp32_fixture.py
+"""
+
+import json
+import threading
+import time
+
+import requests
+
+import esp32_fixture as fx
+from esp32_fixture import metrics
+
+# === KONFIGURATION ===
+SSE_PORT = 1800
+
+# Holding registre til test (scratch, 2 stk.)
+SCRATCH_REG = 80
+JOURNAL_SIZE = 512
+
+
+# === SSE ===
+
+class SseListener:
+    """Samler "register" events fra subscribe=all i baggrundstråd."""
+
+    def __init__(self):
+        self.events = []
+        self.lock = threading.Lock()
+        self.connected = threading.Event()
+        self.stop = threading.Event()
+        self.thread = threading.Thread(target=self._run, daemon=True)
+
+    def __enter__(self):
+        self.thread.start()
+        self.connected.wait(fx.TIMEOUT)
+        return self
+
+    def __exit__(self, *exc):
+        self.stop.set()
+
+    def _run(self):
+        url = f"http://{fx.ESP32_IP}:{SSE_PORT}/api/events"
+        with requests.get(url, params={"subscribe": "all"}, auth=fx.AUTH,
+                          stream=True, timeout=(fx.TIMEOUT, None)) as r:
+            event = None
+            for line in r.iter_lines(decode_unicode=True):
+                if self.stop.is_set():
+                    break
+                if line.startswith("event:"):
+                    event = line[6:].strip()
+                elif line.startswith("data:"):
+                    if event == "connected":
+                        self.connected.set()
+                    elif event == "register":
+                        with self.lock:
+                            self.events.append(json.loads(line[5:]))
+
+    def hr_events(self, addr):
+        with self.lock:
+            return [e["value"] for e in self.events if e.get("type") == "hr" and e.get("addr") == addr]
+
+    def clear(self):
+        with self.lock:
+            self.events.clear()
+
+
+# === HJÆLPEFUNKTIONER ===
+
+def write_pair(s, tid, lo, hi):
+    if not fx.write_hr(s, tid, SCRATCH_REG, [lo, hi]):
+        raise RuntimeError("FC16 exception")
+
+
+def test_metrics(t):
+    print("\n--- Test 1: Metrics ---")
+    m = metrics()
+    t.check("register_journal_changes_total findes", "register_journal_changes_total" in m)
+    t.check("register_journal_overruns_total findes", "register_journal_overruns_total" in m)
+
+
+def test_change_events(t, sse, s):
+    print("\n--- Test 2: Ændringer når frem som SSE events ---")
+    base = int(time.time()) & 0x7FFF
+    for i in range(10):
+        write_pair(s, i + 1, base + i, base + i + 1000)
+        time.sleep(0.02)
+    last_lo, last_hi = base + 9, base + 1009
+    ok = fx.wait_for(lambda: sse.hr_events(SCRATCH_REG)[-1:] == [last_lo] and
+                  sse.hr_events(SCRATCH_REG + 1)[-1:] == [last_hi])
+    t.check("Sidste værdier modtaget", ok,
+            f"hr{SCRATCH_REG}={sse.hr_events(SCRATCH_REG)[-1:]} hr{SCRATCH_REG + 1}={sse.hr_events(SCRATCH_REG + 1)[-1:]}")
+    return last_lo, last_hi
+
+
+def test_unchanged(t, sse, s, lo, hi):
+    print("\n--- Test 3: Samme værdi journaliseres ikke ---")
+    time.sleep(0.5)
+    sse.clear()
+    # Holding registre på SCRATCH_REG er stille; andre banker (IR status) må gerne tælle
+    for i in range(50):
+        write_pair(s, 100 + i, lo, hi)
+    time.sleep(1.0)
+    t.check("Ingen SSE events for uændrede skrivninger",
+            not sse.hr_events(SCRATCH_REG) and not sse.hr_events(SCRATCH_REG + 1),
+            f"events={sse.hr_events(SCRATCH_REG) + sse.hr_events(SCRATCH_REG + 1)}")
+
+
+def test_burst(t, sse, s):
+    print(f"\n--- Test 4: Burst > {JOURNAL_SIZE} ændringer ---")
+    before = metrics()
+    sse.clear()
+    n = JOURNAL_SIZE  # 2 ændringer pr. FC16 → 2x ringen
+    for i in range(n):
+        write_pair(s, 200 + (i & 0xFF), i, i ^ 0x5555)
+    last_lo, last_hi = n - 1, (n - 1) ^ 0x5555
+    ok = fx.wait_for(lambda: sse.hr_events(SCRATCH_REG)[-1:] == [last_lo] and
+                  sse.hr_events(SCRATCH_REG + 1)[-1:] == [last_hi])
+    t.check("Sidste værdier modtaget efter burst", ok,
+            f"hr{SCRATCH_REG}={sse.hr_events(SCRATCH_REG)[-1:]} hr{SCRATCH_REG + 1}={sse.hr_events(SCRATCH_REG + 1)[-1:]}")
+    after = metrics()
+    changes = after.get("register_journal_changes_total", 0) - before.get("register_journal_changes_total", 0)
+    overruns = after.get("register_journal_overruns_total", 0) - before.get("register_journal_overruns_total", 0)
+    t.check("Ændringer talt", changes >= 2 * n, f"changes +{changes:.0f}")
+    print(f"  [INFO] overruns +{overruns:.0f} (afhænger af SSE tick vs. Modbus hastighed)")
+
+
+# === MAIN ===
+
+def main():
+    fx.parse_args()
+
+    def body(t):
+        test_metrics(t)
+        with SseListener() as sse, fx.connect() as s:
+            t.check("SSE forbundet", sse.connected.is_set())
+            lo, hi = test_change_events(t, sse, s)
+            test_unchanged(t, sse, s, lo, hi)
+            test_burst(t, sse, s)
+
+    fx.run("Register change journal (SSE watch_all)", body, info=f"Modbus TCP :{fx.MB_PORT}, SSE :{SSE_PORT}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Test: Sparse register-sider over de flade HR/IR arrays (v7.9.8.22, FEAT-167)
+
+Hardware setup:
+  - ESP32 @ 10.1.1.30, Modbus TCP på port 502 (set modbus-tcp enabled on)
+
+Testplan:
+  1. "set reg-map hr 1000 100" via /api/cli → /api/registers/map viser siderne
+     960 og 1024, og /api/metrics har register_pages_mapped/_max
+  2. FC16 skriver 100 words over sidegrænsen 1024, FC03 læser dem igen
+  3. FC06 + GET /api/registers/hr/{addr} på mappet adresse
+  4. Umappede adresser: FC03/FC06 → exception 02, FC03 der krydser ud af
+     mappet område → exception 02, HTTP → 400
+  5. FC04 på IR i det flade område over 256 (256-511) virker fortsat
+
+Brug:
+  python test_reg_map.py [ip]
+
+Bemærk: Mappede sider frigives først ved reboot; testen sletter sin
+reg-map erklæring igen men kører "save" ikke.
+
+Host-variant uden ESP32 (span mod ord-model, FC front ends, fuld pool): tests/host/test_reg_map
+
+Kræver: requests, esp32_fixture.py
+"""
+
+import struct
+import time
+
+import esp32_fixture as fx
+from esp32_fixture import api, metrics
+
+# === KONFIGURATION ===
+MAP_START = 1000
+MAP_COUNT = 100
+PAGE_WORDS = 64
+UNMAPPED_REG = 40000
+
+
+# === HJÆLPEFUNKTIONER ===
+
+def cli(command):
+    code, data = api("POST", "/api/cli", {"command": command})
+    return data.get("output", "") if code == 200 and isinstance(data, dict) else ""
+
+
+def read_hr(s, tid, start, count):
+    return fx.transact(s, tid, struct.pack(">BHH", 0x03, start, count))
+
+
+def find_slot(output):
+    """Find slot-nummer for vores erklæring i "show reg-map" output."""
+    for line in output.splitlines():
+        parts = line.split()
+        if len(parts) >= 3 and parts[0].startswith("#") and parts[1] == "HR" and \
+                parts[2] == f"{MAP_START}-{MAP_START + MAP_COUNT - 1}":
+            return int(parts[0][1:])
+    return None
+
+
+def test_declare(t):
+    print("\n--- Test 1: Erklær side-område ---")
+    out = cli(f"set reg-map hr {MAP_START} {MAP_COUNT}")
+    t.check("set reg-map accepteret", "ERROR" not in out.upper(), out.strip()[:80])
+
+    code, d = api("GET", "/api/registers/map")
+    t.check("GET /api/registers/map → 200", code == 200, f"status={code}")
+    if code != 200 or not isinstance(d, dict):
+        return
+    t.check("page_words = 64", d.get("page_words") == PAGE_WORDS, f"page_words={d.get('page_words')}")
+    first = MAP_START // PAGE_WORDS * PAGE_WORDS
+    last = (MAP_START + MAP_COUNT - 1) // PAGE_WORDS * PAGE_WORDS
+    pages = d.get("pages_hr", [])
+    t.check(f"Sider {first} og {last} mappet", first in pages and last in pages, f"pages_hr={pages}")
+    t.check("Erklæring gemt i config",
+            any(x.get("bank") == "hr" and x.get("start") == MAP_START and x.get("count") == MAP_COUNT
+                for x in d.get("declared", [])), f"declared={d.get('declared')}")
+
+    m = metrics()
+    t.check("register_pages_mapped findes", "register_pages_mapped" in m)
+    t.check("register_pages_max findes", "register_pages_max" in m)
+    t.check("pages_mapped <= pages_max",
+            m.get("register_pages_mapped", 0) <= m.get("register_pages_max", 0),
+            f"{m.get('register_pages_mapped')}/{m.get('register_pages_max')}")
+
+
+def test_block_roundtrip(t, s):
+    print("\n--- Test 2: FC16/FC03 over sidegrænse ---")
+    base = int(time.time()) & 0x3FFF
+    values = [(base + i) & 0xFFFF for i in range(MAP_COUNT)]
+    # FC16 max 123 words pr. request
+    pdu = fx.transact(s, 1, struct.pack(">BHHB", 0x10, MAP_START, MAP_COUNT, MAP_COUNT * 2) +
+                   struct.pack(f">{MAP_COUNT}H", *values))
+    t.check("FC16 100 words accepteret", pdu[0] == 0x10, pdu[:3].hex())
+
+    pdu = read_hr(s, 2, MAP_START, MAP_COUNT)
+    ok = pdu[0] == 0x03 and pdu[1] == MAP_COUNT * 2
+    got = list(struct.unpack(f">{MAP_COUNT}H", pdu[2:2 + MAP_COUNT * 2])) if ok else []
+    t.check("FC03 læser samme værdier", got == values,
+            f"første afvigelse ved {next((i for i, (a, b) in enumerate(zip(got, values)) if a != b), '-')}")
+
+
+def test_single(t, s):
+    print("\n--- Test 3: FC06 + REST enkelt-register ---")
+    addr = MAP_START + 50
+    pdu = fx.transact(s, 3, struct.pack(">BHH", 0x06, addr, 0xBEEF))
+    t.check("FC06 accepteret", pdu[0] == 0x06, pdu[:3].hex())
+    code, d = api("GET", f"/api/registers/hr/{addr}")
+    t.check(f"GET /api/registers/hr/{addr} = 0xBEEF",
+            code == 200 and isinstance(d, dict) and d.get("value") == 0xBEEF, str(d)[:80])
+
+
+def test_unmapped(t, s):
+    print("\n--- Test 4: Umappede adresser ---")
+    pdu = read_hr(s, 4, UNMAPPED_REG, 1)
+    t.check("FC03 umappet → exception 02", pdu[:2] == bytes([0x83, 0x02]), pdu.hex())
+    pdu = fx.transact(s, 5, struct.pack(">BHH", 0x06, UNMAPPED_REG, 1))
+    t.check("FC06 umappet → exception 02", pdu[:2] == bytes([0x86, 0x02]), pdu.hex())
+    # Sidste mappede side (1088) slutter ved 1151; 1144+16 krydser ud i umappet område
+    end = ((MAP_START + MAP_COUNT - 1) // PAGE_WORDS + 1) * PAGE_WORDS
+    pdu = read_hr(s, 6, end - 8, 16)
+    t.check("FC03 ud over mappet område → exception 02", pdu[:2] == bytes([0x83, 0x02]), pdu.hex())
+    code, _ = api("GET", f"/api/registers/hr/{UNMAPPED_REG}")
+    t.check("HTTP umappet → 400", code == 400, f"status={code}")
+
+
+def test_flat_ir(t, s):
+    print("\n--- Test 5: Flad IR over 256 ---")
+    pdu = fx.transact(s, 7, struct.pack(">BHH", 0x04, 300, 10))
+    t.check("FC04 IR 300-309 virker", pdu[0] == 0x04 and pdu[1] == 20, pdu[:3].hex())
+
+
+def cleanup():
+    slot = find_slot(cli("show reg-map"))
+    if slot is not None:
+        cli(f"set reg-map {slot} delete")
+
+
+# === MAIN ===
+
+def main():
+    fx.parse_args()
+
+    def body(t):
+        test_declare(t)
+        with fx.connect() as s:
+            test_block_roundtrip(t, s)
+            test_single(t, s)
+            test_unmapped(t, s)
+            test_flat_ir(t, s)
+
+    fx.run("Sparse register-sider (set reg-map)", body, cleanup, info=f"Modbus TCP :{fx.MB_PORT}")
+
+
+if __name__ == "__main__":
+    main()
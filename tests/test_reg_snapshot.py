@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Test: Seqlock-baserede multi-register snapshots (v7.9.8.20, FEAT-165)
+
+Hardware setup:
+  - ESP32 @ 10.1.1.30, Modbus TCP på port 502 (set modbus-tcp enabled on)
+  - Ingen eksterne slaves nødvendige
+
+Testplan:
+  1. /api/metrics har register_snapshot_retries_total + register_snapshot_locked_total
+  2. Writer-tråd skriver (v, v) til SCRATCH_REG..+1 med FC16, reader-tråde læser
+     samme par med FC03 (TCP) og GET /api/registers/hr — begge ord skal altid være ens
+  3. IR 290-291 (ST total cycles, 32-bit MSW først) læst med FC04 må aldrig gå baglæns
+     (en revet læsning ved 16-bit overløb ville give et spring)
+
+Brug:
+  python test_reg_snapshot.py [ip] [--seconds N]
+
+Host-variant uden ESP32 (writer/reader/journal tråde mod registers.cpp): tests/host/test_reg_snapshot
+
+Kræver: requests, esp32_fixture.py
+"""
+
+import struct
+import threading
+import time
+
+import esp32_fixture as fx
+from esp32_fixture import api, metrics
+
+# === KONFIGURATION ===
+# Holding registre til write/read race (scratch, 2 stk.)
+SCRATCH_REG = 80
+TOTAL_CYCLES_REG = 290
+DURATION_S = 10
+
+
+# === HJÆLPEFUNKTIONER ===
+
+def read_regs(s, tid, fc, addr, qty):
+    pdu = fx.transact(s, tid, struct.pack(">BHH", fc, addr, qty))
+    if pdu[0] != fc:
+        raise RuntimeError(f"exception {pdu.hex()}")
+    return struct.unpack(f">{qty}H", pdu[2:2 + qty * 2])
+
+
+def test_metrics(t):
+    print("\n--- Test 1: Metrics ---")
+    m = metrics()
+    t.check("register_snapshot_retries_total findes", "register_snapshot_retries_total" in m)
+    t.check("register_snapshot_locked_total findes", "register_snapshot_locked_total" in m)
+
+
+def test_pair_race(t):
+    print(f"\n--- Test 2: FC16 writer vs FC03/REST readers ({DURATION_S} s) ---")
+    stop = threading.Event()
+    stats = {"writes": 0, "tcp_reads": 0, "rest_reads": 0, "torn": 0, "errors": 0}
+    lock = threading.Lock()
+
+    def writer():
+        with fx.connect() as s:
+            v, tid = 0, 0
+            while not stop.is_set():
+                v = (v + 1) & 0xFFFF
+                tid = (tid + 1) & 0xFFFF
+                fx.write_hr(s, tid, SCRATCH_REG, [v, v])
+                stats["writes"] += 1
+
+    def tcp_reader():
+        with fx.connect() as s:
+            tid = 0
+            while not stop.is_set():
+                tid = (tid + 1) & 0xFFFF
+                lo, hi = read_regs(s, tid, 0x03, SCRATCH_REG, 2)
+                with lock:
+                    stats["tcp_reads"] += 1
+                    if lo != hi:
+                        stats["torn"] += 1
+
+    def rest_reader():
+        while not stop.is_set():
+            _, data = api("GET", f"/api/registers/hr?start={SCRATCH_REG}&count=2")
+            regs = [e["value"] for e in data.get("registers", [])] if isinstance(data, dict) else []
+            with lock:
+                stats["rest_reads"] += 1
+                if len(regs) == 2 and regs[0] != regs[1]:
+                    stats["torn"] += 1
+
+    def guard(fn):
+        def run():
+            try:
+                fn()
+            except Exception as e:
+                with lock:
+                    stats["errors"] += 1
+                print(f"  [INFO] {fn.__name__}: {e}")
+        return run
+
+    threads = [threading.Thread(target=guard(f)) for f in (writer, tcp_reader, tcp_reader, rest_reader)]
+    for th in threads:
+        th.start()
+    time.sleep(DURATION_S)
+    stop.set()
+    for th in threads:
+        th.join()
+
+    t.check("Ingen fejl i tråde", stats["errors"] == 0, f"errors={stats['errors']}")
+    t.check("Writer kørte", stats["writes"] > 0, f"writes={stats['writes']}")
+    t.check("Readers kørte", stats["tcp_reads"] > 0 and stats["rest_reads"] > 0,
+            f"tcp={stats['tcp_reads']} rest={stats['rest_reads']}")
+    t.check("Ingen revne par", stats["torn"] == 0, f"torn={stats['torn']}")
+
+
+def test_monotonic(t):
+    print(f"\n--- Test 3: IR {TOTAL_CYCLES_REG}-{TOTAL_CYCLES_REG + 1} monotont ---")
+    prev, backwards, reads = None, 0, 0
+    deadline = time.time() + DURATION_S / 2
+    with fx.connect() as s:
+        tid = 0
+        while time.time() < deadline:
+            tid = (tid + 1) & 0xFFFF
+            msw, lsw = read_regs(s, tid, 0x04, TOTAL_CYCLES_REG, 2)
+            value = (msw << 16) | lsw
+            if prev is not None and value < prev:
+                backwards += 1
+            prev = value
+            reads += 1
+    if prev == 0:
+        print("  [INFO] ST engine kører ikke — total cycles er 0")
+    t.check("Total cycles aldrig baglæns", backwards == 0, f"reads={reads} backwards={backwards}")
+
+
+# === MAIN ===
+
+def main():
+    global DURATION_S
+    DURATION_S = fx.parse_args({"seconds": DURATION_S})["seconds"]
+
+    def body(t):
+        test_metrics(t)
+        before = metrics()
+        test_pair_race(t)
+        test_monotonic(t)
+        after = metrics()
+        retries = after.get("register_snapshot_retries_total", 0) - before.get("register_snapshot_retries_total", 0)
+        locked = after.get("register_snapshot_locked_total", 0) - before.get("register_snapshot_locked_total", 0)
+        print(f"  [INFO] snapshot retries +{retries:.0f}, locked +{locked:.0f}")
+
+    fx.run("Register snapshots (seqlock)", body, info=f"Modbus TCP :{fx.MB_PORT}")
+
+
+if __name__ == "__main__":
+    main()
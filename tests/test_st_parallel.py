@@ -0,0 +1,182 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Test: Parallel ST eksekvering på begge kerner (v7.9.8.8, FEAT-153)
+
+Uploader 4 programmer med bindings til holding registre og sammenligner
+output registrene med parallel eksekvering slået fra og til:
+
+  Logic1  in=HR 100  out=HR 200      (uafhængig)
+  Logic2  in=HR 101  out=HR 201      (uafhængig)
+  Logic3  in=HR 200  out=HR 202      (læser Logic1's output → samme gruppe som Logic1)
+  Logic4  in=HR 103  out=HR 203 + MB_BUSY()  (global builtin → låst til loop task)
+
+Forventet:
+  parallel:off  — alle programmer på lane 0 (loop task)
+  parallel:on   — Logic1+3 på samme lane, Logic4 på lane 0, groups == 3,
+                  parallel_cycles tæller op
+  Output registrene er identiske i begge modes for samme input.
+
+Lane/grupper læses fra GET /api/logic ("parallel", "groups", programs[].lane).
+
+OBS: Overskriver logic slot 1-4 og HR 100-103 / 200-203.
+
+Brug:
+  python test_st_parallel.py [ip]
+
+Host-variant uden ESP32 (grupper, globale builtins, barrier): tests/host/test_st_parallel
+
+Kræver: requests, esp32_fixture.py
+"""
+
+import time
+
+import esp32_fixture as fx
+from esp32_fixture import api
+
+# Input sæt der skrives til HR 100/101/103
+INPUTS = [(0, 0, 0), (7, 300, 12), (1234, 55, 999), (32000, 1, 4)]
+
+# === PROGRAMMER ===
+
+PROGRAMS = [
+    # (slot, source, [(variable, binding, direction)])
+    (1, """PROGRAM p1
+VAR
+  a : INT;
+  y : INT;
+  i : INT;
+END_VAR
+BEGIN
+  y := 0;
+  FOR i := 1 TO 20 DO
+    y := (y * 3 + a + i) MOD 10007;
+  END_FOR;
+END_PROGRAM
+""", [("a", "reg:100", "input"), ("y", "reg:200", "output")]),
+    (2, """PROGRAM p2
+VAR
+  b : INT;
+  y : INT;
+END_VAR
+BEGIN
+  y := LIMIT(0, b * 2 - 50, 20000);
+END_PROGRAM
+""", [("b", "reg:101", "input"), ("y", "reg:201", "output")]),
+    (3, """PROGRAM p3
+VAR
+  c : INT;
+  y : INT;
+END_VAR
+BEGIN
+  y := c MOD 97 + 1;
+END_PROGRAM
+""", [("c", "reg:200", "input"), ("y", "reg:202", "output")]),
+    (4, """PROGRAM p4
+VAR
+  d : INT;
+  y : INT;
+  busy : BOOL;
+END_VAR
+BEGIN
+  busy := MB_BUSY();
+  y := d + 1;
+END_PROGRAM
+""", [("d", "reg:103", "input"), ("y", "reg:203", "output")]),
+]
+
+
+# === HJÆLPEFUNKTIONER ===
+
+def write_hr(addr, value):
+    api("POST", f"/api/registers/hr/{addr}", {"value": value})
+
+
+def read_hr(addr):
+    _, data = api("GET", f"/api/registers/hr/{addr}")
+    return data.get("value") if isinstance(data, dict) else None
+
+
+def engine():
+    _, data = api("GET", "/api/logic")
+    return data
+
+
+def lanes(data):
+    return {p["id"]: p.get("lane") for p in data.get("programs", [])}
+
+
+def settle(data):
+    """Vent nogle cykler (Logic3 læser Logic1's output én cyklus senere)."""
+    time.sleep(max(0.2, data.get("execution_interval_ms", 10) / 1000.0 * 20))
+
+
+def run_inputs():
+    outputs = []
+    for a, b, d in INPUTS:
+        write_hr(100, a)
+        write_hr(101, b)
+        write_hr(103, d)
+        settle(engine())
+        outputs.append(tuple(read_hr(200 + i) for i in range(4)))
+    return outputs
+
+
+# === MAIN ===
+
+def main():
+    fx.parse_args()
+    original = {}
+
+    def body(t):
+        original["parallel"] = engine().get("parallel", True)
+
+        print("\n--- Upload + bind ---")
+        for slot, source, binds in PROGRAMS:
+            api("POST", f"/api/logic/{slot}/disable")
+            compiled, _ = fx.upload_program(slot, source)
+            t.check(f"Logic{slot} kompilering", compiled)
+            for var, binding, direction in binds:
+                code, _ = api("POST", f"/api/logic/{slot}/bind",
+                              {"variable": var, "binding": binding, "direction": direction})
+                t.check(f"Logic{slot} bind {var} → {binding}", code == 200)
+            api("POST", f"/api/logic/{slot}/enable")
+
+        print("\n--- parallel:off ---")
+        code, data = api("POST", "/api/logic/settings", {"parallel": False})
+        t.check("Slå parallel fra", code == 200 and data.get("parallel") == False)
+        serial = run_inputs()
+        e = engine()
+        l = lanes(e)
+        t.check("Alle programmer på loop task", all(l.get(i) == 0 for i in range(1, 5)), f"lanes={l}")
+
+        print("\n--- parallel:on ---")
+        code, data = api("POST", "/api/logic/settings", {"parallel": True})
+        t.check("Slå parallel til", code == 200 and data.get("parallel") == True)
+        before = engine().get("parallel_cycles", 0)
+        parallel = run_inputs()
+        e = engine()
+        l = lanes(e)
+        t.check("Engine rapporterer parallel", e.get("parallel") == True)
+        t.check("3 uafhængige grupper", e.get("groups") == 3, f"groups={e.get('groups')}")
+        t.check("Logic1+3 (delt HR 200) på samme lane", l.get(1) == l.get(3), f"lanes={l}")
+        t.check("Logic4 (MB_BUSY) låst til loop task", l.get(4) == 0, f"lanes={l}")
+        t.check("Worker lane i brug", 1 in l.values(), f"lanes={l}")
+        t.check("parallel_cycles tæller op", e.get("parallel_cycles", 0) > before,
+                f"{before} → {e.get('parallel_cycles')}")
+
+        print("\n--- Sammenligning ---")
+        for inp, s, p in zip(INPUTS, serial, parallel):
+            t.check(f"Input {inp}", s == p, f"serial={s} parallel={p}")
+
+    def cleanup():
+        if "parallel" in original:
+            api("POST", "/api/logic/settings", {"parallel": original["parallel"]})
+        for slot, _, _ in PROGRAMS:
+            api("POST", f"/api/logic/{slot}/disable")
+
+    fx.run("ST parallel eksekvering — serial vs. begge kerner", body, cleanup)
+
+
+if __name__ == "__main__":
+    main()
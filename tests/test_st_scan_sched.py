@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Test: Deterministisk scan scheduler med jitter statistik (v7.9.8.9, FEAT-154)
+
+Uploader 2 små programmer og giver dem hver sin periode:
+
+  Logic1  period:5    priority:10  policy:skip
+  Logic2  period:100  priority:0   policy:catchup
+
+Forventet:
+  - Antal eksekveringer over et måle-vindue matcher perioden (±15%)
+  - /api/logic/{id}/stats "scan" objekt: scans > 0, histogram summer == scans,
+    jitter_max_us rapporteret, policy/priority som sat
+  - /api/metrics indeholder st_logic_scan_jitter_seconds histogram
+  - Ugyldig periode/policy afvises med 400
+
+OBS: Overskriver logic slot 1-2.
+
+Brug:
+  python test_st_scan_sched.py [ip]
+
+Kræver: requests, esp32_fixture.py
+"""
+
+import time
+
+import esp32_fixture as fx
+from esp32_fixture import api
+
+WINDOW_S = 3.0      # Måle-vindue
+TOLERANCE = 0.15    # Tilladt afvigelse på eksekveringsrate
+
+PROGRAM = """PROGRAM scan{n}
+VAR
+  c : DINT;
+END_VAR
+BEGIN
+  c := c + 1;
+END_PROGRAM
+"""
+
+SCHEDULES = [
+    # (slot, period_ms, priority, policy)
+    (1, 5, 10, "skip"),
+    (2, 100, 0, "catchup"),
+]
+
+
+# === HJÆLPEFUNKTIONER ===
+
+def stats(slot):
+    _, data = api("GET", f"/api/logic/{slot}/stats")
+    return data if isinstance(data, dict) else {}
+
+
+# === MAIN ===
+
+def main():
+    fx.parse_args()
+
+    def body(t):
+        print("\n--- Upload + schedule ---")
+        for slot, period, prio, policy in SCHEDULES:
+            api("POST", f"/api/logic/{slot}/disable")
+            compiled, _ = fx.upload_program(slot, PROGRAM.format(n=slot))
+            t.check(f"Logic{slot} kompilering", compiled)
+            code, data = api("POST", f"/api/logic/{slot}/schedule",
+                             {"period_ms": period, "priority": prio, "policy": policy})
+            t.check(f"Logic{slot} schedule {period}ms/{prio}/{policy}",
+                    code == 200 and data.get("effective_period_ms") == period, f"{data}")
+            api("POST", f"/api/logic/{slot}/enable")
+
+        print("\n--- Validering ---")
+        code, _ = api("POST", "/api/logic/1/schedule", {"period_ms": 70000})
+        t.check("period_ms 70000 afvist", code == 400, f"HTTP {code}")
+        code, _ = api("POST", "/api/logic/1/schedule", {"policy": "later"})
+        t.check("policy 'later' afvist", code == 400, f"HTTP {code}")
+
+        print("\n--- Eksekveringsrate ---")
+        time.sleep(0.5)  # Lad grid'et falde på plads
+        before = {slot: stats(slot).get("execution_count", 0) for slot, _, _, _ in SCHEDULES}
+        t0 = time.time()
+        time.sleep(WINDOW_S)
+        after = {slot: stats(slot).get("execution_count", 0) for slot, _, _, _ in SCHEDULES}
+        elapsed = time.time() - t0
+
+        for slot, period, _, _ in SCHEDULES:
+            runs = (after[slot] - before[slot]) & 0xFFFF  # execution_count er uint16
+            expected = elapsed * 1000.0 / period
+            dev = abs(runs - expected) / expected
+            t.check(f"Logic{slot} ~{expected:.0f} scans på {elapsed:.2f}s", dev <= TOLERANCE,
+                    f"{runs} scans ({dev*100:.1f}% afvigelse)")
+
+        print("\n--- Jitter statistik ---")
+        for slot, period, prio, policy in SCHEDULES:
+            scan = stats(slot).get("scan", {})
+            hist_sum = sum(scan.get("jitter_hist", []))
+            t.check(f"Logic{slot} scans > 0", scan.get("scans", 0) > 0, f"scans={scan.get('scans')}")
+            t.check(f"Logic{slot} jitter histogram sum == scans", hist_sum == scan.get("scans"),
+                    f"sum={hist_sum}")
+            t.check(f"Logic{slot} priority/policy", scan.get("priority") == prio and scan.get("policy") == policy,
+                    f"{scan.get('priority')}/{scan.get('policy')}")
+            print(f"    jitter avg={scan.get('jitter_avg_us')}us max={scan.get('jitter_max_us')}us "
+                  f"skipped={scan.get('skipped')} hist={scan.get('jitter_hist')}")
+
+        code, text = api("GET", "/api/metrics")
+        t.check("Prometheus st_logic_scan_jitter_seconds",
+                code == 200 and 'st_logic_scan_jitter_seconds_bucket{slot="1"' in str(text))
+
+    def cleanup():
+        for slot, _, _, _ in SCHEDULES:
+            api("POST", f"/api/logic/{slot}/schedule", {"period_ms": 0, "priority": 0, "policy": "skip"})
+            api("POST", f"/api/logic/{slot}/disable")
+
+    fx.run("ST scan scheduler — periode, prioritet og jitter", body, cleanup)
+
+
+if __name__ == "__main__":
+    main()
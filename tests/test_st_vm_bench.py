@@ -0,0 +1,336 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Benchmark: ST VM instruktioner/s — threaded fast path vs. debug step-loop (v7.9.8.3)
+
+Uploader et sæt repræsentative ST programmer til én logic slot og måler
+instruktioner/s i begge eksekveringsmodes:
+
+  fast   — ingen debugger (st_vm_run_fast, computed-goto dispatch)
+  debug  — debugger aktiv (per-step loop med breakpoint/step checks)
+
+Tal fra /api/logic/{id}/stats: last_instructions / last_execution_us.
+I debug-mode kører hver 'continue' præcis én cyklus (VM pauser ved HALT),
+så scriptet sender continue og læser stats én cyklus ad gangen.
+
+Cycles/instr (v7.9.8.4, FEAT-149) = CPU_MHZ / Minstr/s. Før/efter statisk
+typede opcodes: byg firmware med -DST_COMPILER_TYPED_OPS=0 (generiske
+opcodes med runtime type-stack) og =1 (default), kør scriptet mod begge
+og sammenlign "fast cyc/op" og "fast us/cyklus" kolonnerne. Typede
+programmer har lidt flere instruktioner (CVT_*), så us/cyklus er det
+retvisende tal for hele programmet.
+
+Optimizer (v7.9.8.6, FEAT-151): kompileringslinjen viser instruktioner
+før -> efter bytecode optimizer. A/B: byg med -DST_OPTIMIZER_ENABLED=0.
+
+Superinstruktioner (v7.9.8.7, FEAT-152): TON/CTU/R_TRIG/LIMIT/SCALE kaldes
+via dedikerede opcodes. A/B: byg med -DST_COMPILER_SUPERINSTRUCTIONS=0 og
+sammenlign "fast us/cyklus" for timer_ladder (32 TON instanser i kæde).
+
+Programmer:
+  1. arith_loop  — FOR loop med INT/DINT/REAL aritmetik
+  2. logic_if    — BOOL logik, sammenligninger, IF/ELSIF
+  3. builtins    — LIMIT/MIN/MAX/ABS/type-konvertering
+  4. func_call   — bruger-FUNCTION kaldt i loop (CALL_USER/RETURN)
+  5. timers      — 8 kædede TON instanser (Q => output binding)
+  6. mixed       — blandet INT/DINT/REAL aritmetik og sammenligninger (CVT_*)
+  7. timer_ladder — 32 kædede TON kald (a/b skiftevis) + LIMIT/SCALE
+
+Brug:
+  python test_st_vm_bench.py [ip] [--slot N] [--samples N]
+
+Host-variant uden ESP32 (identiske resultater fast/step): tests/host/bench_st_vm
+
+Kræver: requests, esp32_fixture.py
+"""
+
+import time
+
+import esp32_fixture as fx
+from esp32_fixture import api
+
+# CPU clock til cycles/instr (ESP32 default 240 MHz)
+CPU_MHZ = 240
+
+# Logic slot til benchmark (slot 4 for ikke at forstyrre eksisterende)
+LOGIC_SLOT = 4
+SAMPLES = 20
+
+# === PROGRAMMER ===
+
+PROGRAMS = [
+    ("arith_loop", """PROGRAM bench
+VAR
+  i : INT;
+  s : DINT;
+  r : REAL;
+END_VAR
+BEGIN
+  s := 0;
+  FOR i := 1 TO 200 DO
+    s := s + i * 3 - (i MOD 7);
+    r := r + 0.5;
+  END_FOR;
+END_PROGRAM
+"""),
+    ("logic_if", """PROGRAM bench
+VAR
+  a : BOOL;
+  b : BOOL;
+  c : INT;
+  i : INT;
+END_VAR
+BEGIN
+  FOR i := 0 TO 100 DO
+    a := (i MOD 2) = 0;
+    b := a XOR (i > 50);
+    IF a AND NOT b THEN
+      c := c + 1;
+    ELSIF b THEN
+      c := c - 1;
+    ELSE
+      c := c + 2;
+    END_IF;
+  END_FOR;
+END_PROGRAM
+"""),
+    ("builtins", """PROGRAM bench
+VAR
+  i : INT;
+  x : INT;
+  y : REAL;
+END_VAR
+BEGIN
+  FOR i := 0 TO 100 DO
+    x := LIMIT(0, i * 2, 150);
+    y := ABS(INT_TO_REAL(x) - 75.0);
+    x := MAX(x, MIN(i, 40));
+  END_FOR;
+END_PROGRAM
+"""),
+    ("func_call", """PROGRAM bench
+VAR
+  i : INT;
+  s : INT;
+END_VAR
+
+FUNCTION F2 : INT
+VAR_INPUT
+  a : INT;
+  b : INT;
+END_VAR
+BEGIN
+  F2 := a * b + 1;
+END_FUNCTION
+
+BEGIN
+  s := 0;
+  FOR i := 0 TO 50 DO
+    s := F2(i, 2) + s;
+  END_FOR;
+END_PROGRAM
+"""),
+    ("mixed", """PROGRAM bench
+VAR
+  i : INT;
+  d : DINT;
+  r : REAL;
+  b : BOOL;
+  c : INT;
+  k : DINT;
+END_VAR
+BEGIN
+  i := 0;
+  d := 100000;
+  r := 0.0;
+  FOR k := 0 TO 20 DO
+    i := i + 3;
+    d := d + i * 2;
+    r := r + d / 7;
+    r := r * 1.5 - i;
+    b := d < i;
+    IF r >= i THEN
+      c := c + 1;
+    END_IF;
+  END_FOR;
+END_PROGRAM
+"""),
+    ("timers", """PROGRAM bench
+VAR
+  run : BOOL := TRUE;
+  n : INT;
+  q1 : BOOL; q2 : BOOL; q3 : BOOL; q4 : BOOL;
+  q5 : BOOL; q6 : BOOL; q7 : BOOL; q8 : BOOL;
+END_VAR
+BEGIN
+  TON(IN := run, PT := T#100ms, Q => q1);
+  TON(IN := q1, PT := T#100ms, Q => q2);
+  TON(IN := q2, PT := T#100ms, Q => q3);
+  TON(IN := q3, PT := T#100ms, Q => q4);
+  TON(IN := q4, PT := T#100ms, Q => q5);
+  TON(IN := q5, PT := T#100ms, Q => q6);
+  TON(IN := q6, PT := T#100ms, Q => q7);
+  TON(IN := q7, PT := T#100ms, Q => q8);
+  IF q8 THEN
+    n := n + 1;
+  END_IF;
+END_PROGRAM
+"""),
+    ("timer_ladder", """PROGRAM bench
+VAR
+  run : BOOL := TRUE;
+  a : BOOL;
+  b : BOOL;
+  n : INT;
+  x : INT;
+  y : REAL;
+END_VAR
+BEGIN
+  a := TON(run, T#100ms);
+  b := TON(a, T#100ms);
+  a := TON(b, T#100ms);
+  b := TON(a, T#100ms);
+  a := TON(b, T#100ms);
+  b := TON(a, T#100ms);
+  a := TON(b, T#100ms);
+  b := TON(a, T#100ms);
+  a := TON(b, T#100ms);
+  b := TON(a, T#100ms);
+  a := TON(b, T#100ms);
+  b := TON(a, T#100ms);
+  a := TON(b, T#100ms);
+  b := TON(a, T#100ms);
+  a := TON(b, T#100ms);
+  b := TON(a, T#100ms);
+  a := TON(b, T#100ms);
+  b := TON(a, T#100ms);
+  a := TON(b, T#100ms);
+  b := TON(a, T#100ms);
+  a := TON(b, T#100ms);
+  b := TON(a, T#100ms);
+  a := TON(b, T#100ms);
+  b := TON(a, T#100ms);
+  a := TON(b, T#100ms);
+  b := TON(a, T#100ms);
+  a := TON(b, T#100ms);
+  b := TON(a, T#100ms);
+  a := TON(b, T#100ms);
+  b := TON(a, T#100ms);
+  a := TON(b, T#100ms);
+  b := TON(a, T#100ms);
+  IF b THEN
+    n := n + 1;
+  END_IF;
+  x := LIMIT(0, n, 1000);
+  y := SCALE(x, 0, 1000, 0.0, 100.0);
+END_PROGRAM
+"""),
+]
+
+# === HJÆLPEFUNKTIONER ===
+
+def get_stats(slot):
+    _, data = api("GET", f"/api/logic/{slot}/stats")
+    return data
+
+
+def interval_s():
+    _, data = api("GET", "/api/logic")
+    return max(0.01, data.get("execution_interval_ms", 10) / 1000.0)
+
+
+def rate(samples):
+    """Median instruktioner/s over (instr, us) samples."""
+    rates = sorted(i / (us * 1e-6) for i, us in samples if us > 0 and i > 0)
+    return rates[len(rates) // 2] if rates else 0.0
+
+
+def median_us(samples):
+    """Median eksekveringstid pr. cyklus i µs."""
+    times = sorted(us for i, us in samples if us > 0 and i > 0)
+    return times[len(times) // 2] if times else 0
+
+
+def cycles_per_instr(instr_per_s):
+    return CPU_MHZ * 1e6 / instr_per_s if instr_per_s > 0 else 0.0
+
+
+def sample_fast(slot, count, wait):
+    """Debugger slået fra: én sample pr. ny cyklus."""
+    samples = []
+    last = get_stats(slot).get("execution_count", 0)
+    deadline = time.time() + count * wait * 20 + 5
+    while len(samples) < count and time.time() < deadline:
+        time.sleep(wait)
+        s = get_stats(slot)
+        if s.get("execution_count", 0) != last:
+            last = s.get("execution_count", 0)
+            samples.append((s.get("last_instructions", 0), s.get("last_execution_us", 0)))
+    return samples
+
+
+def sample_debug(slot, count, wait):
+    """Debugger aktiv (RUN): continue → én cyklus → pause ved HALT."""
+    samples = []
+    for _ in range(count):
+        before = get_stats(slot).get("execution_count", 0)
+        api("POST", f"/api/logic/{slot}/debug/continue")
+        for _ in range(50):
+            time.sleep(wait)
+            s = get_stats(slot)
+            if s.get("execution_count", 0) != before:
+                samples.append((s.get("last_instructions", 0), s.get("last_execution_us", 0)))
+                break
+    api("POST", f"/api/logic/{slot}/debug/stop")
+    return samples
+
+
+# === MAIN ===
+
+def main():
+    opts = fx.parse_args({"slot": LOGIC_SLOT, "samples": SAMPLES})
+    slot, samples = opts["slot"], opts["samples"]
+    rows = []
+
+    def body(t):
+        wait = interval_s()
+        for name, source in PROGRAMS:
+            print(f"\n--- {name} ---")
+            api("POST", f"/api/logic/{slot}/disable")
+            api("POST", f"/api/logic/{slot}/debug/stop")
+            compiled, data = fx.upload_program(slot, source)
+            instr = "?"
+            if isinstance(data, dict):
+                instr = f"{data.get('instr_count')}"
+                if data.get("instr_unoptimized"):
+                    instr = f"{data.get('instr_unoptimized')} -> {instr}"
+            t.check(f"{name} kompilering", compiled, f"instr={instr}")
+            if not compiled:
+                continue
+            api("POST", f"/api/logic/{slot}/enable")
+
+            fast_samples = sample_fast(slot, samples, wait)
+            fast = rate(fast_samples)
+            debug = rate(sample_debug(slot, samples, wait))
+            t.check(f"{name} fast path målt", fast > 0,
+                    f"{fast / 1e6:.2f} Minstr/s, {cycles_per_instr(fast):.0f} cyc/op")
+            t.check(f"{name} debug loop målt", debug > 0, f"{debug / 1e6:.2f} Minstr/s")
+            rows.append((name, fast, debug, median_us(fast_samples)))
+
+    def cleanup():
+        api("POST", f"/api/logic/{slot}/debug/stop")
+        api("POST", f"/api/logic/{slot}/disable")
+        if rows:
+            print(f"\n{'program':<12} {'fast Minstr/s':>14} {'fast cyc/op':>12} {'fast us/cyklus':>15} "
+                  f"{'debug Minstr/s':>15} {'speedup':>8}")
+            for name, fast, debug, us in rows:
+                speedup = fast / debug if debug > 0 else 0.0
+                print(f"{name:<12} {fast / 1e6:>14.2f} {cycles_per_instr(fast):>12.0f} {us:>15} "
+                      f"{debug / 1e6:>15.2f} {speedup:>7.2f}x")
+
+    fx.run("ST VM benchmark — fast path vs. debug step-loop", body, cleanup,
+           info=f"slot: {slot}  samples: {samples}")
+
+
+if __name__ == "__main__":
+    main()